@@ -74,6 +74,10 @@
  *   buffer would be placed
  * - "position"  G_TYPE_UINT   current position in the input buffer in samples
  * - "size"  G_TYPE_UINT   size of the input buffer in samples
+ *
+ * When #GstAggregator:batch-size is set, up to that many output buffers are
+ * produced per aggregate call as long as all sink pads have input queued.
+ * The #GstAggregator::samples-selected signal is emitted for each of them.
  */
 
 
@@ -2210,7 +2214,7 @@ sync_pad_values (GstElement * aagg, GstPad * pad, gpointer user_data)
 }
 
 static GstFlowReturn
-gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
+gst_audio_aggregator_aggregate_one (GstAggregator * agg, gboolean timeout)
 {
   /* Calculate the current output offset/timestamp and offset_end/timestamp_end.
    * Allocate a silence buffer for this and store it.
@@ -2656,6 +2660,59 @@ not_negotiated:
   }
 }
 
+/* TRUE if all sink pads that are not EOS have a buffer queued, so that the
+ * next output buffer can be produced without waiting */
+static gboolean
+gst_audio_aggregator_have_input (GstAggregator * agg)
+{
+  gboolean ret = TRUE;
+  GList *l;
+
+  GST_OBJECT_LOCK (agg);
+  for (l = GST_ELEMENT (agg)->sinkpads; l; l = l->next) {
+    GstAggregatorPad *aggpad = l->data;
+
+    if (gst_aggregator_pad_is_inactive (aggpad)
+        || gst_aggregator_pad_is_eos (aggpad))
+      continue;
+
+    if (!gst_aggregator_pad_has_buffer (aggpad)) {
+      ret = FALSE;
+      break;
+    }
+  }
+  GST_OBJECT_UNLOCK (agg);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
+{
+  GstFlowReturn ret;
+  guint limit, n;
+
+  ret = gst_audio_aggregator_aggregate_one (agg, timeout);
+
+  /* Produce more output buffers right away while enough input is queued, up
+   * to the limit of the base class */
+  limit = gst_aggregator_get_batch_limit (agg);
+  for (n = 1; n < limit && ret == GST_FLOW_OK; n++) {
+    /* renegotiation and serialized events are handled by the base class */
+    if (gst_pad_needs_reconfigure (agg->srcpad)
+        || !gst_audio_aggregator_have_input (agg))
+      break;
+
+    GST_LOG_OBJECT (agg, "Producing output buffer %u of a batch of %u",
+        n + 1, limit);
+    ret = gst_audio_aggregator_aggregate_one (agg, FALSE);
+    if (ret == GST_AGGREGATOR_FLOW_NEED_DATA)
+      ret = GST_FLOW_OK;
+  }
+
+  return ret;
+}
+
 /**
  * gst_audio_aggregator_has_current_output_buffer:
  * @self: A #GstAudioAggregator
@@ -813,8 +813,7 @@ static void
            max threads. */
         g_assert (vagg->priv->task_pool);
         guint n_threads =
-            gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL
-            (vagg->priv->task_pool));
+            gst_video_parallel_get_max_threads (vagg->priv->task_pool);
         gst_structure_set (conv_config, GST_VIDEO_CONVERTER_OPT_THREADS,
             G_TYPE_UINT, n_threads, NULL);
       }
@@ -3061,12 +3060,7 @@ gst_video_aggregator_finalize (GObject * o)
   g_mutex_clear (&vagg->priv->lock);
   g_ptr_array_unref (vagg->priv->supported_formats);
 
-  if (vagg->priv->task_pool) {
-    /* Only cleanup the pool if we created it (not from context) */
-    if (!vagg->priv->task_pool_from_context)
-      gst_task_pool_cleanup (vagg->priv->task_pool);
-    gst_clear_object (&vagg->priv->task_pool);
-  }
+  gst_clear_object (&vagg->priv->task_pool);
 
   G_OBJECT_CLASS (gst_video_aggregator_parent_class)->finalize (o);
 }
@@ -3139,14 +3133,13 @@ gst_video_aggregator_setup_task_pool (GstVideoAggregator * vagg)
 
   GST_OBJECT_LOCK (vagg);
   if (!vagg->priv->task_pool) {
-    /* Create default task pool if none provided */
-    vagg->priv->task_pool = gst_shared_task_pool_new ();
-    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (vagg->
-            priv->task_pool), g_get_num_processors ());
-    gst_task_pool_prepare (vagg->priv->task_pool, NULL);
+    /* Use the process-wide pool for parallel video processing if none
+     * provided, so that many aggregators don't each start one thread per
+     * CPU core */
+    vagg->priv->task_pool = gst_video_parallel_get_default_pool ();
     vagg->priv->task_pool_from_context = FALSE;
-    GST_DEBUG_OBJECT (vagg, "Created default task pool with %d threads",
-        g_get_num_processors ());
+    GST_DEBUG_OBJECT (vagg, "Using default task pool with %u threads",
+        gst_video_parallel_get_max_threads (vagg->priv->task_pool));
   }
 
   pool = gst_object_ref (vagg->priv->task_pool);
@@ -3168,8 +3161,6 @@ gst_video_aggregator_set_context (GstElement * element, GstContext * context)
         " from %spersistent context", pool,
         gst_context_is_persistent (context) ? "" : "non-");
     GST_OBJECT_LOCK (vagg);
-    if (vagg->priv->task_pool && !vagg->priv->task_pool_from_context)
-      gst_task_pool_cleanup (vagg->priv->task_pool);
     gst_clear_object (&vagg->priv->task_pool);
     vagg->priv->task_pool = pool;
     vagg->priv->task_pool_from_context = TRUE;
@@ -134,6 +134,10 @@ gboolean __gst_video_rawvideo_convert (GstVideoCodecState * state, GstFormat src
                                        gint64 src_value, GstFormat * dest_format,
                                        gint64 * dest_value);
 
+/* Scaler utility functions */
+G_GNUC_INTERNAL
+GstVideoScaler *__gst_video_scaler_copy (GstVideoScaler * scale);
+
 G_END_DECLS
 
 #endif
@@ -0,0 +1,54 @@
+/* GStreamer
+ *
+ * video-converter-fused-neon.c: NEON fused conversion and scaling
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "video-converter-fused-private.h"
+
+#include <arm_neon.h>
+
+/* 8 bytes per iteration, widened to 16 bit and accumulated in 32 bit */
+void
+gst_video_fused_blend_lines_neon (guint8 * dest, const guint8 ** src,
+    const gint16 * taps, guint n_taps, guint start, guint end)
+{
+  const int32x4_t round = vdupq_n_s32 (GST_VIDEO_FUSED_TAP_ONE / 2);
+  guint i, k;
+
+  for (i = start; i + 8 <= end; i += 8) {
+    int32x4_t lo = round, hi = round;
+    int16x8_t p;
+
+    for (k = 0; k < n_taps; k++) {
+      int16x8_t a = vreinterpretq_s16_u16 (vmovl_u8 (vld1_u8 (src[k] + i)));
+
+      lo = vmlal_n_s16 (lo, vget_low_s16 (a), taps[k]);
+      hi = vmlal_n_s16 (hi, vget_high_s16 (a), taps[k]);
+    }
+
+    p = vcombine_s16 (vqshrn_n_s32 (lo, GST_VIDEO_FUSED_TAP_SHIFT),
+        vqshrn_n_s32 (hi, GST_VIDEO_FUSED_TAP_SHIFT));
+    vst1_u8 (dest + i, vqmovun_s16 (p));
+  }
+
+  gst_video_fused_blend_lines_c (dest, src, taps, n_taps, i, end);
+}
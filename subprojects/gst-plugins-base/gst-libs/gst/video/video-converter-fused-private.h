@@ -0,0 +1,110 @@
+/* GStreamer
+ *
+ * video-converter-fused-private.h: fused conversion and scaling kernels
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_CONVERTER_FUSED_PRIVATE_H__
+#define __GST_VIDEO_CONVERTER_FUSED_PRIVATE_H__
+
+#include <gst/gst.h>
+#include <gst/video/video-prelude.h>
+
+G_BEGIN_DECLS
+
+/* taps are fixed point numbers with this many fractional bits */
+#define GST_VIDEO_FUSED_TAP_SHIFT 12
+#define GST_VIDEO_FUSED_TAP_ONE   (1 << GST_VIDEO_FUSED_TAP_SHIFT)
+#define GST_VIDEO_FUSED_MAX_TAPS  16
+
+/* Filter for one direction of one component. For horizontal filters,
+ * @offset is the byte offset of the first input sample of each output and
+ * the following samples are @pstride bytes apart. For vertical filters it is
+ * the index of the first input line. The taps are stored tap major, tap k of
+ * output i is taps[k * out_size + i]. */
+typedef struct
+{
+  guint out_size;
+  guint n_taps;
+  guint pstride;
+  guint32 *offset;
+  gint16 *taps;
+  /* horizontal: the outputs before this one never read more than 4 bytes
+   * past their last input sample without leaving the input */
+  guint safe_size;
+} GstVideoFusedFilter;
+
+typedef void (*GstVideoFusedBlendFunc) (guint8 * dest, const guint8 ** src,
+    const gint16 * taps, guint n_taps, guint start, guint end);
+typedef void (*GstVideoFusedResampleFunc) (guint8 * dest, const guint8 * src,
+    const GstVideoFusedFilter * filter, guint start, guint end);
+
+typedef struct
+{
+  const gchar *name;
+  GstVideoFusedBlendFunc blend_lines;
+  GstVideoFusedResampleFunc resample;
+} GstVideoFusedImpl;
+
+/* Weighted sum of the bytes start to end of @n_taps input lines */
+G_GNUC_INTERNAL
+void gst_video_fused_blend_lines     (guint8 * dest, const guint8 ** src,
+                                      const gint16 * taps, guint n_taps,
+                                      guint start, guint end);
+
+/* Horizontal filtering of the outputs start to end into consecutive bytes */
+G_GNUC_INTERNAL
+void gst_video_fused_resample        (guint8 * dest, const guint8 * src,
+                                      const GstVideoFusedFilter * filter,
+                                      guint start, guint end);
+
+/* implementations, selected at runtime */
+G_GNUC_INTERNAL
+void gst_video_fused_blend_lines_c   (guint8 * dest, const guint8 ** src,
+                                      const gint16 * taps, guint n_taps,
+                                      guint start, guint end);
+
+G_GNUC_INTERNAL
+void gst_video_fused_resample_c      (guint8 * dest, const guint8 * src,
+                                      const GstVideoFusedFilter * filter,
+                                      guint start, guint end);
+
+G_GNUC_INTERNAL
+void gst_video_fused_blend_lines_avx2 (guint8 * dest, const guint8 ** src,
+                                      const gint16 * taps, guint n_taps,
+                                      guint start, guint end);
+
+G_GNUC_INTERNAL
+void gst_video_fused_resample_avx2   (guint8 * dest, const guint8 * src,
+                                      const GstVideoFusedFilter * filter,
+                                      guint start, guint end);
+
+G_GNUC_INTERNAL
+void gst_video_fused_blend_lines_neon (guint8 * dest, const guint8 ** src,
+                                      const gint16 * taps, guint n_taps,
+                                      guint start, guint end);
+
+G_GNUC_INTERNAL
+const GstVideoFusedImpl * gst_video_fused_get_implementations (guint * n_impls);
+
+/* only exported for the unit tests, implemented in video-converter.c */
+GST_VIDEO_API
+gboolean gst_video_converter_uses_fused_scale (struct _GstVideoConverter * convert);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_CONVERTER_FUSED_PRIVATE_H__ */
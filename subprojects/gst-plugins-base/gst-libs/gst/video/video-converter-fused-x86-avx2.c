@@ -0,0 +1,119 @@
+/* GStreamer
+ *
+ * video-converter-fused-x86-avx2.c: AVX2 fused conversion and scaling
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "video-converter-fused-private.h"
+
+#include <immintrin.h>
+
+static inline __m256i
+load_u8_epi16 (const guint8 * p)
+{
+  return _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) p));
+}
+
+/* 16 bytes per iteration. Two lines are multiplied and added at once with
+ * madd on their interleaved 16 bit values, the unpack and pack steps both
+ * work per 128 bit lane so the order of the results is preserved. */
+void
+gst_video_fused_blend_lines_avx2 (guint8 * dest, const guint8 ** src,
+    const gint16 * taps, guint n_taps, guint start, guint end)
+{
+  const __m256i round = _mm256_set1_epi32 (GST_VIDEO_FUSED_TAP_ONE / 2);
+  const __m256i zero = _mm256_setzero_si256 ();
+  guint i, k;
+
+  for (i = start; i + 16 <= end; i += 16) {
+    __m256i lo = round, hi = round, t, a, b, p;
+
+    for (k = 0; k + 1 < n_taps; k += 2) {
+      a = load_u8_epi16 (src[k] + i);
+      b = load_u8_epi16 (src[k + 1] + i);
+      t = _mm256_set1_epi32 ((guint16) taps[k] |
+          ((guint32) (guint16) taps[k + 1] << 16));
+
+      lo = _mm256_add_epi32 (lo,
+          _mm256_madd_epi16 (_mm256_unpacklo_epi16 (a, b), t));
+      hi = _mm256_add_epi32 (hi,
+          _mm256_madd_epi16 (_mm256_unpackhi_epi16 (a, b), t));
+    }
+    if (k < n_taps) {
+      a = load_u8_epi16 (src[k] + i);
+      t = _mm256_set1_epi32 ((guint16) taps[k]);
+
+      lo = _mm256_add_epi32 (lo,
+          _mm256_madd_epi16 (_mm256_unpacklo_epi16 (a, zero), t));
+      hi = _mm256_add_epi32 (hi,
+          _mm256_madd_epi16 (_mm256_unpackhi_epi16 (a, zero), t));
+    }
+
+    lo = _mm256_srai_epi32 (lo, GST_VIDEO_FUSED_TAP_SHIFT);
+    hi = _mm256_srai_epi32 (hi, GST_VIDEO_FUSED_TAP_SHIFT);
+    p = _mm256_packs_epi32 (lo, hi);
+    p = _mm256_packus_epi16 (p, p);
+    p = _mm256_permute4x64_epi64 (p, 0x08);
+
+    _mm_storeu_si128 ((__m128i *) (dest + i), _mm256_castsi256_si128 (p));
+  }
+
+  gst_video_fused_blend_lines_c (dest, src, taps, n_taps, i, end);
+}
+
+/* 8 outputs per iteration, the input samples are gathered as 32 bit words
+ * of which only the low byte is used */
+void
+gst_video_fused_resample_avx2 (guint8 * dest, const guint8 * src,
+    const GstVideoFusedFilter * filter, guint start, guint end)
+{
+  const __m256i round = _mm256_set1_epi32 (GST_VIDEO_FUSED_TAP_ONE / 2);
+  const __m256i mask = _mm256_set1_epi32 (0xff);
+  const __m256i order = _mm256_setr_epi32 (0, 4, 0, 0, 0, 0, 0, 0);
+  const __m256i pstride = _mm256_set1_epi32 (filter->pstride);
+  guint i, k, n_taps = filter->n_taps, safe_end;
+
+  safe_end = MIN (end, filter->safe_size);
+
+  for (i = start; i + 8 <= safe_end; i += 8) {
+    __m256i idx, acc = round, v, t;
+
+    idx = _mm256_loadu_si256 ((const __m256i *) (filter->offset + i));
+    for (k = 0; k < n_taps; k++) {
+      v = _mm256_i32gather_epi32 ((const int *) src, idx, 1);
+      v = _mm256_and_si256 (v, mask);
+      t = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i *)
+              (filter->taps + k * filter->out_size + i)));
+
+      acc = _mm256_add_epi32 (acc, _mm256_mullo_epi32 (v, t));
+      idx = _mm256_add_epi32 (idx, pstride);
+    }
+
+    acc = _mm256_srai_epi32 (acc, GST_VIDEO_FUSED_TAP_SHIFT);
+    acc = _mm256_packs_epi32 (acc, acc);
+    acc = _mm256_packus_epi16 (acc, acc);
+    acc = _mm256_permutevar8x32_epi32 (acc, order);
+
+    _mm_storel_epi64 ((__m128i *) (dest + i), _mm256_castsi256_si128 (acc));
+  }
+
+  gst_video_fused_resample_c (dest, src, filter, i, end);
+}
@@ -0,0 +1,154 @@
+/* GStreamer
+ *
+ * video-converter-fused.c: fused conversion and scaling kernels
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "video-converter-fused-private.h"
+
+/* in order of preference, the first one the CPU supports is used */
+static const GstVideoFusedImpl implementations[] = {
+#ifdef HAVE_AVX2
+  {"avx2", gst_video_fused_blend_lines_avx2, gst_video_fused_resample_avx2},
+#endif
+#ifdef HAVE_NEON
+  {"neon", gst_video_fused_blend_lines_neon, gst_video_fused_resample_c},
+#endif
+  {"c", gst_video_fused_blend_lines_c, gst_video_fused_resample_c},
+};
+
+static GstVideoFusedBlendFunc blend_lines = gst_video_fused_blend_lines_c;
+static GstVideoFusedResampleFunc resample = gst_video_fused_resample_c;
+
+static gboolean
+gst_video_fused_impl_supported (const GstVideoFusedImpl * impl)
+{
+#ifdef HAVE_AVX2
+  if (impl->blend_lines == gst_video_fused_blend_lines_avx2)
+    return gst_cpuid_supports_x86_avx2 ();
+#endif
+#ifdef HAVE_NEON
+  if (impl->blend_lines == gst_video_fused_blend_lines_neon)
+    return gst_cpuid_supports_arm_neon64 ();
+#endif
+  return TRUE;
+}
+
+static void
+gst_video_fused_init (void)
+{
+  static gsize init = 0;
+
+  if (g_once_init_enter (&init)) {
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (implementations); i++) {
+      if (gst_video_fused_impl_supported (&implementations[i]))
+        break;
+    }
+
+    blend_lines = implementations[i].blend_lines;
+    resample = implementations[i].resample;
+    GST_CAT_INFO (GST_CAT_PERFORMANCE, "fused convert and scale with %s",
+        implementations[i].name);
+
+    g_once_init_leave (&init, 1);
+  }
+}
+
+/* Returns the implementations that were compiled in and that the CPU
+ * supports, in order of preference. Used by the unit tests. */
+const GstVideoFusedImpl *
+gst_video_fused_get_implementations (guint * n_impls)
+{
+  static GstVideoFusedImpl supported[G_N_ELEMENTS (implementations)];
+  static gsize init = 0;
+  static guint n_supported = 0;
+
+  if (g_once_init_enter (&init)) {
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (implementations); i++) {
+      if (gst_video_fused_impl_supported (&implementations[i]))
+        supported[n_supported++] = implementations[i];
+    }
+
+    g_once_init_leave (&init, 1);
+  }
+
+  *n_impls = n_supported;
+
+  return supported;
+}
+
+void
+gst_video_fused_blend_lines_c (guint8 * dest, const guint8 ** src,
+    const gint16 * taps, guint n_taps, guint start, guint end)
+{
+  guint i, k;
+
+  for (i = start; i < end; i++) {
+    gint sum = GST_VIDEO_FUSED_TAP_ONE / 2;
+
+    for (k = 0; k < n_taps; k++)
+      sum += src[k][i] * taps[k];
+
+    sum >>= GST_VIDEO_FUSED_TAP_SHIFT;
+    dest[i] = CLAMP (sum, 0, 255);
+  }
+}
+
+void
+gst_video_fused_resample_c (guint8 * dest, const guint8 * src,
+    const GstVideoFusedFilter * filter, guint start, guint end)
+{
+  guint i, k, n_taps = filter->n_taps, pstride = filter->pstride;
+
+  for (i = start; i < end; i++) {
+    const guint8 *s = src + filter->offset[i];
+    const gint16 *t = filter->taps + i;
+    gint sum = GST_VIDEO_FUSED_TAP_ONE / 2;
+
+    for (k = 0; k < n_taps; k++)
+      sum += s[k * pstride] * t[k * filter->out_size];
+
+    sum >>= GST_VIDEO_FUSED_TAP_SHIFT;
+    dest[i] = CLAMP (sum, 0, 255);
+  }
+}
+
+void
+gst_video_fused_blend_lines (guint8 * dest, const guint8 ** src,
+    const gint16 * taps, guint n_taps, guint start, guint end)
+{
+  gst_video_fused_init ();
+
+  blend_lines (dest, src, taps, n_taps, start, end);
+}
+
+void
+gst_video_fused_resample (guint8 * dest, const guint8 * src,
+    const GstVideoFusedFilter * filter, guint start, guint end)
+{
+  gst_video_fused_init ();
+
+  resample (dest, src, filter, start, end);
+}
@@ -30,6 +30,8 @@
 #endif
 
 #include "video-converter.h"
+#include "video-converter-fused-private.h"
+#include "video-parallel.h"
 
 #include <glib.h>
 #include <string.h>
@@ -117,175 +119,6 @@ ensure_debug_category (void)
 #define ensure_debug_category() /* NOOP */
 #endif /* GST_DISABLE_GST_DEBUG */
 
-typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
-
-typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
-typedef struct _GstParallelizedWorkItem GstParallelizedWorkItem;
-
-struct _GstParallelizedWorkItem
-{
-  GstParallelizedTaskRunner *self;
-  GstParallelizedTaskFunc func;
-  gpointer user_data;
-};
-
-struct _GstParallelizedTaskRunner
-{
-  GstTaskPool *pool;
-  gboolean own_pool;
-  guint n_threads;
-
-  GstVecDeque *tasks;
-  GstVecDeque *work_items;
-
-  GMutex lock;
-
-  gboolean async_tasks;
-};
-
-static void
-gst_parallelized_task_thread_func (gpointer data)
-{
-  GstParallelizedTaskRunner *runner = data;
-  GstParallelizedWorkItem *work_item;
-
-  g_mutex_lock (&runner->lock);
-  work_item = gst_vec_deque_pop_head (runner->work_items);
-  g_mutex_unlock (&runner->lock);
-
-  g_assert (work_item != NULL);
-  g_assert (work_item->func != NULL);
-
-
-  work_item->func (work_item->user_data);
-  if (runner->async_tasks)
-    g_free (work_item);
-}
-
-static void
-gst_parallelized_task_runner_join (GstParallelizedTaskRunner * self)
-{
-  gboolean joined = FALSE;
-
-  while (!joined) {
-    g_mutex_lock (&self->lock);
-    if (!(joined = gst_vec_deque_is_empty (self->tasks))) {
-      gpointer task = gst_vec_deque_pop_head (self->tasks);
-      g_mutex_unlock (&self->lock);
-      gst_task_pool_join (self->pool, task);
-    } else {
-      g_mutex_unlock (&self->lock);
-    }
-  }
-}
-
-static void
-gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
-{
-  gst_parallelized_task_runner_join (self);
-
-  gst_vec_deque_free (self->work_items);
-  gst_vec_deque_free (self->tasks);
-  if (self->own_pool)
-    gst_task_pool_cleanup (self->pool);
-  gst_object_unref (self->pool);
-  g_mutex_clear (&self->lock);
-  g_free (self);
-}
-
-static GstParallelizedTaskRunner *
-gst_parallelized_task_runner_new (guint n_threads, GstTaskPool * pool,
-    gboolean async_tasks)
-{
-  GstParallelizedTaskRunner *self;
-
-  if (n_threads == 0)
-    n_threads = g_get_num_processors ();
-
-  self = g_new0 (GstParallelizedTaskRunner, 1);
-
-  if (pool) {
-    self->pool = g_object_ref (pool);
-    self->own_pool = FALSE;
-
-    /* No reason to split up the work between more threads than the
-     * pool can spawn */
-    if (GST_IS_SHARED_TASK_POOL (pool))
-      n_threads =
-          MIN (n_threads,
-          gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool)));
-  } else {
-    self->pool = gst_shared_task_pool_new ();
-    self->own_pool = TRUE;
-    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (self->pool),
-        n_threads);
-    gst_task_pool_prepare (self->pool, NULL);
-  }
-
-  self->tasks = gst_vec_deque_new (n_threads);
-  self->work_items = gst_vec_deque_new (n_threads);
-
-  self->n_threads = n_threads;
-
-  g_mutex_init (&self->lock);
-
-  /* Set when scheduling a job */
-  self->async_tasks = async_tasks;
-
-  return self;
-}
-
-static void
-gst_parallelized_task_runner_finish (GstParallelizedTaskRunner * self)
-{
-  gst_parallelized_task_runner_join (self);
-}
-
-static void
-gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
-    GstParallelizedTaskFunc func, gpointer * task_data)
-{
-  guint n_threads = self->n_threads;
-
-  if (n_threads > 1 || self->async_tasks) {
-    guint i = 0;
-    g_mutex_lock (&self->lock);
-    if (!self->async_tasks) {
-      /* if not async, perform one of the functions in the current thread */
-      i = 1;
-    }
-    for (; i < n_threads; i++) {
-      gpointer task;
-      GstParallelizedWorkItem *work_item;
-
-      if (!self->async_tasks)
-        work_item = g_newa (GstParallelizedWorkItem, 1);
-      else
-        work_item = g_new0 (GstParallelizedWorkItem, 1);
-
-      work_item->self = self;
-      work_item->func = func;
-      work_item->user_data = task_data[i];
-      gst_vec_deque_push_tail (self->work_items, work_item);
-
-      task =
-          gst_task_pool_push (self->pool, gst_parallelized_task_thread_func,
-          self, NULL);
-
-      /* The return value of push() is unfortunately nullable, and we can't deal with that */
-      g_assert (task != NULL);
-      gst_vec_deque_push_tail (self->tasks, task);
-    }
-    g_mutex_unlock (&self->lock);
-  }
-
-  if (!self->async_tasks) {
-    func (task_data[0]);
-
-    gst_parallelized_task_runner_finish (self);
-  }
-}
-
 typedef struct _GstLineCache GstLineCache;
 
 #define SCALE    (8)
@@ -339,6 +172,41 @@ typedef struct
 typedef void (*FastConvertFunc) (GstVideoConverter * convert,
     const GstVideoFrame * src, GstVideoFrame * dest, gint plane);
 
+/* one component of the fused convert and scale fastpath */
+typedef struct
+{
+  gint splane, dplane;
+  /* byte offset and first line of the used part of the input lines */
+  gint sx, sy;
+  guint span;
+  /* byte offset of the first output sample and first output line */
+  gint dx, dy;
+  gint dpstride;
+  gint h_sub;
+  GstVideoFusedFilter h, v;
+} FusedComponent;
+
+/* The tables that a converter computes from its formats, sizes, colorimetry
+ * and options and never changes afterwards. Converters with the same
+ * configuration share one plan, so that making them again does not compute
+ * the resampler taps and gamma tables again. */
+typedef struct
+{
+  gint refcount;
+  gchar *key;
+
+  GMutex lock;
+  /* PlanScaler, copied for every scaler a converter needs */
+  GPtrArray *scalers;
+  gpointer gamma_dec_table;
+  gpointer gamma_enc_table;
+  /* filters of the fused fastpath */
+  gboolean fused_done;
+  gboolean fused_ok;
+  GstVideoFusedFilter fused_h[3];
+  GstVideoFusedFilter fused_v[3];
+} ConverterPlan;
+
 struct _GstVideoConverter
 {
   gint flags;
@@ -366,8 +234,10 @@ struct _GstVideoConverter
   gint current_bits;
 
   GstStructure *config;
+  ConverterPlan *plan;
 
-  GstParallelizedTaskRunner *conversion_runner;
+  GstVideoParallelRunner *conversion_runner;
+  guint n_threads;
 
   guint16 **tmpline;
 
@@ -477,6 +347,12 @@ struct _GstVideoConverter
   } fv_scaler[4];
   FastConvertFunc fconvert[4];
 
+  /* fused convert and scale fastpath */
+  FusedComponent fused[3];
+  gboolean fused_share_lines;
+  guint fused_span;
+  guint8 **fused_lines;
+
   /* for parallel async running */
   gpointer tasks[4];
   gpointer tasks_p[4];
@@ -848,6 +724,158 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
 #define CHECK_CHROMA_DOWNSAMPLE(c) (GET_OPT_CHROMA_MODE(c) == GST_VIDEO_CHROMA_MODE_DOWNSAMPLE_ONLY)
 #define CHECK_CHROMA_NONE(c) (GET_OPT_CHROMA_MODE(c) == GST_VIDEO_CHROMA_MODE_NONE)
 
+/* number of plans kept around after their last converter is freed */
+#define MAX_UNUSED_PLANS 8
+
+typedef struct
+{
+  GstVideoResamplerMethod method;
+  GstVideoScalerFlags flags;
+  guint n_taps, in_size, out_size;
+  GstVideoScaler *scaler;
+} PlanScaler;
+
+G_LOCK_DEFINE_STATIC (plans);
+static GHashTable *plans;
+/* plans without converters, most recently used first */
+static GQueue unused_plans = G_QUEUE_INIT;
+
+static void
+plan_scaler_free (PlanScaler * ps)
+{
+  gst_video_scaler_free (ps->scaler);
+  g_free (ps);
+}
+
+static void
+converter_plan_free (ConverterPlan * plan)
+{
+  guint i;
+
+  GST_DEBUG ("free plan %p", plan);
+
+  g_ptr_array_unref (plan->scalers);
+  g_free (plan->gamma_dec_table);
+  g_free (plan->gamma_enc_table);
+  for (i = 0; i < 3; i++) {
+    g_free (plan->fused_h[i].offset);
+    g_free (plan->fused_h[i].taps);
+    g_free (plan->fused_v[i].offset);
+    g_free (plan->fused_v[i].taps);
+  }
+  g_mutex_clear (&plan->lock);
+  g_free (plan->key);
+  g_free (plan);
+}
+
+static void
+plan_key_append_info (GString * key, const GstVideoInfo * info)
+{
+  g_string_append_printf (key, "%s %dx%d %d %d %x %d:%d:%d:%d %x;",
+      gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (info)),
+      GST_VIDEO_INFO_WIDTH (info), GST_VIDEO_INFO_HEIGHT (info),
+      GST_VIDEO_INFO_INTERLACE_MODE (info), GST_VIDEO_INFO_FIELD_ORDER (info),
+      GST_VIDEO_INFO_FLAGS (info), info->colorimetry.range,
+      info->colorimetry.matrix, info->colorimetry.transfer,
+      info->colorimetry.primaries, info->chroma_site);
+}
+
+/* get the plan for the configuration of @convert from the cache, or a new
+ * empty one that is filled in while setting up @convert */
+static ConverterPlan *
+converter_plan_get (GstVideoConverter * convert)
+{
+  ConverterPlan *plan;
+  GString *key;
+  gchar *config;
+
+  key = g_string_new (NULL);
+  plan_key_append_info (key, &convert->in_info);
+  plan_key_append_info (key, &convert->out_info);
+  config = gst_structure_to_string (convert->config);
+  g_string_append (key, config);
+  g_free (config);
+
+  G_LOCK (plans);
+  if (plans == NULL)
+    plans = g_hash_table_new (g_str_hash, g_str_equal);
+
+  plan = g_hash_table_lookup (plans, key->str);
+  if (plan) {
+    if (plan->refcount++ == 0)
+      g_queue_remove (&unused_plans, plan);
+    g_string_free (key, TRUE);
+    GST_DEBUG ("reuse plan %p, refcount %d", plan, plan->refcount);
+  } else {
+    plan = g_new0 (ConverterPlan, 1);
+    plan->refcount = 1;
+    plan->key = g_string_free (key, FALSE);
+    g_mutex_init (&plan->lock);
+    plan->scalers =
+        g_ptr_array_new_with_free_func ((GDestroyNotify) plan_scaler_free);
+    g_hash_table_insert (plans, plan->key, plan);
+    GST_DEBUG ("new plan %p for %s", plan, plan->key);
+  }
+  G_UNLOCK (plans);
+
+  return plan;
+}
+
+static void
+converter_plan_unref (ConverterPlan * plan)
+{
+  G_LOCK (plans);
+  if (--plan->refcount == 0) {
+    g_queue_push_head (&unused_plans, plan);
+    if (unused_plans.length > MAX_UNUSED_PLANS) {
+      ConverterPlan *old = g_queue_pop_tail (&unused_plans);
+
+      g_hash_table_remove (plans, old->key);
+      converter_plan_free (old);
+    }
+  }
+  G_UNLOCK (plans);
+}
+
+/* like gst_video_scaler_new() but the coefficients are computed only once
+ * per plan, all other scalers with the same parameters are copies */
+static GstVideoScaler *
+converter_scaler_new (GstVideoConverter * convert,
+    GstVideoResamplerMethod method, GstVideoScalerFlags flags, guint n_taps,
+    guint in_size, guint out_size, GstStructure * options)
+{
+  ConverterPlan *plan = convert->plan;
+  PlanScaler *ps = NULL;
+  GstVideoScaler *scaler;
+  guint i;
+
+  g_mutex_lock (&plan->lock);
+  for (i = 0; i < plan->scalers->len; i++) {
+    PlanScaler *tmp = g_ptr_array_index (plan->scalers, i);
+
+    if (tmp->method == method && tmp->flags == flags && tmp->n_taps == n_taps
+        && tmp->in_size == in_size && tmp->out_size == out_size) {
+      ps = tmp;
+      break;
+    }
+  }
+  if (ps == NULL) {
+    ps = g_new (PlanScaler, 1);
+    ps->method = method;
+    ps->flags = flags;
+    ps->n_taps = n_taps;
+    ps->in_size = in_size;
+    ps->out_size = out_size;
+    ps->scaler = gst_video_scaler_new (method, flags, n_taps, in_size,
+        out_size, options);
+    g_ptr_array_add (plan->scalers, ps);
+  }
+  scaler = __gst_video_scaler_copy (ps->scaler);
+  g_mutex_unlock (&plan->lock);
+
+  return scaler;
+}
+
 static GstLineCache *
 chain_unpack_line (GstVideoConverter * convert, gint idx)
 {
@@ -1496,6 +1524,7 @@ gamma_convert_u16_u16 (GammaData * data, gpointer dest, gpointer src)
 static void
 setup_gamma_decode (GstVideoConverter * convert)
 {
+  ConverterPlan *plan = convert->plan;
   GstVideoTransferFunction func;
   guint16 *t;
   gint i;
@@ -1505,23 +1534,34 @@ setup_gamma_decode (GstVideoConverter * convert)
   convert->gamma_dec.width = convert->current_width;
   if (convert->gamma_dec.gamma_table) {
     GST_LOG ("gamma decode already set up");
-  } else if (convert->current_bits == 8) {
-    GST_LOG ("gamma decode 8->16: %d", func);
-    convert->gamma_dec.gamma_func = gamma_convert_u8_u16;
-    t = convert->gamma_dec.gamma_table = g_malloc (sizeof (guint16) * 256);
-
-    for (i = 0; i < 256; i++)
-      t[i] =
-          rint (gst_video_transfer_function_decode (func, i / 255.0) * 65535.0);
   } else {
-    GST_LOG ("gamma decode 16->16: %d", func);
-    convert->gamma_dec.gamma_func = gamma_convert_u16_u16;
-    t = convert->gamma_dec.gamma_table = g_malloc (sizeof (guint16) * 65536);
+    g_mutex_lock (&plan->lock);
+    if (plan->gamma_dec_table) {
+      GST_LOG ("gamma decode table from plan");
+    } else if (convert->current_bits == 8) {
+      GST_LOG ("gamma decode 8->16: %d", func);
+      t = plan->gamma_dec_table = g_malloc (sizeof (guint16) * 256);
+
+      for (i = 0; i < 256; i++)
+        t[i] =
+            rint (gst_video_transfer_function_decode (func,
+                i / 255.0) * 65535.0);
+    } else {
+      GST_LOG ("gamma decode 16->16: %d", func);
+      t = plan->gamma_dec_table = g_malloc (sizeof (guint16) * 65536);
 
-    for (i = 0; i < 65536; i++)
-      t[i] =
-          rint (gst_video_transfer_function_decode (func,
-              i / 65535.0) * 65535.0);
+      for (i = 0; i < 65536; i++)
+        t[i] =
+            rint (gst_video_transfer_function_decode (func,
+                i / 65535.0) * 65535.0);
+    }
+    convert->gamma_dec.gamma_table = plan->gamma_dec_table;
+    g_mutex_unlock (&plan->lock);
+
+    if (convert->current_bits == 8)
+      convert->gamma_dec.gamma_func = gamma_convert_u8_u16;
+    else
+      convert->gamma_dec.gamma_func = gamma_convert_u16_u16;
   }
   convert->current_bits = 16;
   convert->current_pstride = 8;
@@ -1531,6 +1571,7 @@ setup_gamma_decode (GstVideoConverter * convert)
 static void
 setup_gamma_encode (GstVideoConverter * convert, gint target_bits)
 {
+  ConverterPlan *plan = convert->plan;
   GstVideoTransferFunction func;
   gint i;
 
@@ -1539,27 +1580,38 @@ setup_gamma_encode (GstVideoConverter * convert, gint target_bits)
   convert->gamma_enc.width = convert->current_width;
   if (convert->gamma_enc.gamma_table) {
     GST_LOG ("gamma encode already set up");
-  } else if (target_bits == 8) {
-    guint8 *t;
-
-    GST_LOG ("gamma encode 16->8: %d", func);
-    convert->gamma_enc.gamma_func = gamma_convert_u16_u8;
-    t = convert->gamma_enc.gamma_table = g_malloc (sizeof (guint8) * 65536);
-
-    for (i = 0; i < 65536; i++)
-      t[i] =
-          rint (gst_video_transfer_function_encode (func, i / 65535.0) * 255.0);
   } else {
-    guint16 *t;
+    g_mutex_lock (&plan->lock);
+    if (plan->gamma_enc_table) {
+      GST_LOG ("gamma encode table from plan");
+    } else if (target_bits == 8) {
+      guint8 *t;
+
+      GST_LOG ("gamma encode 16->8: %d", func);
+      t = plan->gamma_enc_table = g_malloc (sizeof (guint8) * 65536);
+
+      for (i = 0; i < 65536; i++)
+        t[i] =
+            rint (gst_video_transfer_function_encode (func,
+                i / 65535.0) * 255.0);
+    } else {
+      guint16 *t;
 
-    GST_LOG ("gamma encode 16->16: %d", func);
-    convert->gamma_enc.gamma_func = gamma_convert_u16_u16;
-    t = convert->gamma_enc.gamma_table = g_malloc (sizeof (guint16) * 65536);
+      GST_LOG ("gamma encode 16->16: %d", func);
+      t = plan->gamma_enc_table = g_malloc (sizeof (guint16) * 65536);
+
+      for (i = 0; i < 65536; i++)
+        t[i] =
+            rint (gst_video_transfer_function_encode (func,
+                i / 65535.0) * 65535.0);
+    }
+    convert->gamma_enc.gamma_table = plan->gamma_enc_table;
+    g_mutex_unlock (&plan->lock);
 
-    for (i = 0; i < 65536; i++)
-      t[i] =
-          rint (gst_video_transfer_function_encode (func,
-              i / 65535.0) * 65535.0);
+    if (target_bits == 8)
+      convert->gamma_enc.gamma_func = gamma_convert_u16_u8;
+    else
+      convert->gamma_enc.gamma_func = gamma_convert_u16_u16;
   }
 }
 
@@ -1617,7 +1669,7 @@ chain_hscale (GstVideoConverter * convert, GstLineCache * prev, gint idx)
   taps = GET_OPT_RESAMPLER_TAPS (convert);
 
   convert->h_scaler[idx] =
-      gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, taps,
+      converter_scaler_new (convert, method, GST_VIDEO_SCALER_FLAG_NONE, taps,
       convert->in_width, convert->out_width, convert->config);
 
   gst_video_scaler_get_coeff (convert->h_scaler[idx], 0, NULL, &taps);
@@ -1652,14 +1704,15 @@ chain_vscale (GstVideoConverter * convert, GstLineCache * prev, gint idx)
       && (GST_VIDEO_INFO_INTERLACE_MODE (&convert->in_info) !=
           GST_VIDEO_INTERLACE_MODE_ALTERNATE)) {
     convert->v_scaler_i[idx] =
-        gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_INTERLACED, taps,
-        convert->in_height, convert->out_height, convert->config);
+        converter_scaler_new (convert, method,
+        GST_VIDEO_SCALER_FLAG_INTERLACED, taps, convert->in_height,
+        convert->out_height, convert->config);
 
     gst_video_scaler_get_coeff (convert->v_scaler_i[idx], 0, NULL, &taps_i);
     backlog = taps_i;
   }
   convert->v_scaler_p[idx] =
-      gst_video_scaler_new (method, 0, taps, convert->in_height,
+      converter_scaler_new (convert, method, 0, taps, convert->in_height,
       convert->out_height, convert->config);
   convert->v_scale_width = convert->current_width;
   convert->v_scale_format = convert->current_format;
@@ -2125,7 +2178,7 @@ setup_allocators (GstVideoConverter * convert)
   width = MAX (convert->in_maxwidth, convert->out_maxwidth);
   width += convert->out_x;
 
-  for (i = 0; i < convert->conversion_runner->n_threads; i++) {
+  for (i = 0; i < convert->n_threads; i++) {
     /* start with using dest lines if we can directly write into it */
     if (convert->identity_pack) {
       alloc_line = get_dest_line;
@@ -2413,6 +2466,10 @@ gst_video_converter_init_from_config (GstVideoConverter * convert)
  * If @config is not provided, and a @pool is provided, the number of threads for
  * the converter will be set to the maximum number of threads in the pool.
  *
+ * Converters with the same formats, sizes, colorimetry and @config share the
+ * resampler and gamma tables they compute, so making a converter again for a
+ * configuration that is still in use, or was recently, is cheap.
+ *
  * Returns (nullable): a #GstVideoConverter or %NULL if conversion is not possible.
  *
  * Since: 1.20
@@ -2452,9 +2509,8 @@ gst_video_converter_new_with_pool (const GstVideoInfo * in_info,
   } else {
     /* No config provided. If a pool is available, use its thread count */
     gst_video_converter_init_from_config (convert);
-    if (pool && GST_IS_SHARED_TASK_POOL (pool)) {
-      n_threads =
-          gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool));
+    if (pool && gst_video_parallel_get_max_threads (pool) > 0) {
+      n_threads = gst_video_parallel_get_max_threads (pool);
       GST_LOG ("setting n-threads from max threads %d from provided pool",
           n_threads);
       gst_structure_set (convert->config,
@@ -2473,7 +2529,11 @@ gst_video_converter_new_with_pool (const GstVideoInfo * in_info,
 
   async_tasks = GET_OPT_ASYNC_TASKS (convert);
   convert->conversion_runner =
-      gst_parallelized_task_runner_new (n_threads, pool, async_tasks);
+      gst_video_parallel_runner_new (n_threads, pool, async_tasks);
+  n_threads = convert->n_threads =
+      gst_video_parallel_runner_get_n_threads (convert->conversion_runner);
+
+  convert->plan = converter_plan_get (convert);
 
   if (video_converter_lookup_fastpath (convert))
     goto done;
@@ -2605,7 +2665,7 @@ gst_video_converter_free (GstVideoConverter * convert)
 
   g_return_if_fail (convert != NULL);
 
-  for (i = 0; i < convert->conversion_runner->n_threads; i++) {
+  for (i = 0; i < convert->n_threads; i++) {
     if (convert->upsample_p && convert->upsample_p[i])
       gst_video_chroma_resample_free (convert->upsample_p[i]);
     if (convert->upsample_i && convert->upsample_i[i])
@@ -2663,11 +2723,8 @@ gst_video_converter_free (GstVideoConverter * convert)
   g_free (convert->dither_lines);
   g_free (convert->dither);
 
-  g_free (convert->gamma_dec.gamma_table);
-  g_free (convert->gamma_enc.gamma_table);
-
   if (convert->tmpline) {
-    for (i = 0; i < convert->conversion_runner->n_threads; i++)
+    for (i = 0; i < convert->n_threads; i++)
       g_free (convert->tmpline[i]);
     g_free (convert->tmpline);
   }
@@ -2678,7 +2735,7 @@ gst_video_converter_free (GstVideoConverter * convert)
     gst_structure_free (convert->config);
 
   for (i = 0; i < 4; i++) {
-    for (j = 0; j < convert->conversion_runner->n_threads; j++) {
+    for (j = 0; j < convert->n_threads; j++) {
       if (convert->fv_scaler[i].scaler)
         gst_video_scaler_free (convert->fv_scaler[i].scaler[j]);
       if (convert->fh_scaler[i].scaler)
@@ -2688,8 +2745,17 @@ gst_video_converter_free (GstVideoConverter * convert)
     g_free (convert->fh_scaler[i].scaler);
   }
 
+  if (convert->fused_lines) {
+    for (i = 0; i < convert->n_threads; i++)
+      g_free (convert->fused_lines[i]);
+    g_free (convert->fused_lines);
+  }
+
   if (convert->conversion_runner)
-    gst_parallelized_task_runner_free (convert->conversion_runner);
+    gst_video_parallel_runner_free (convert->conversion_runner);
+
+  if (convert->plan)
+    converter_plan_unref (convert->plan);
 
   clear_matrix_data (&convert->to_RGB_matrix);
   clear_matrix_data (&convert->convert_matrix);
@@ -2828,9 +2894,10 @@ gst_video_converter_frame_finish (GstVideoConverter * convert)
 {
   g_return_if_fail (convert);
   g_return_if_fail (convert->conversion_runner);
-  g_return_if_fail (convert->conversion_runner->async_tasks);
+  g_return_if_fail (gst_video_parallel_runner_is_async
+      (convert->conversion_runner));
 
-  gst_parallelized_task_runner_finish (convert->conversion_runner);
+  gst_video_parallel_runner_finish (convert->conversion_runner);
 }
 
 static void
@@ -3337,7 +3404,7 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
       PACK_FRAME (dest, convert->borderline, i, out_maxwidth);
   }
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (ConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3362,8 +3429,8 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_generic_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_generic_task, (gpointer) tasks_p);
 
   if (convert->borderline) {
     for (i = out_y + out_height; i < out_maxheight; i++)
@@ -3448,7 +3515,7 @@ convert_I420_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3470,8 +3537,8 @@ convert_I420_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_YUY2_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_YUY2_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3525,7 +3592,7 @@ convert_I420_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3547,8 +3614,8 @@ convert_I420_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_UYVY_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_UYVY_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3604,7 +3671,7 @@ convert_I420_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     h2 = GST_ROUND_DOWN_2 (height);
 
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3627,8 +3694,8 @@ convert_I420_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_AYUV_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_AYUV_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3759,7 +3826,7 @@ convert_I420_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3781,8 +3848,8 @@ convert_I420_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_v210_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_v210_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3916,7 +3983,7 @@ convert_I420_10_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3938,8 +4005,8 @@ convert_I420_10_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_10_v210_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_10_v210_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3993,7 +4060,7 @@ convert_YUY2_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4015,8 +4082,8 @@ convert_YUY2_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_I420_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_YUY2_I420_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -4157,7 +4224,7 @@ convert_v210_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4179,8 +4246,8 @@ convert_v210_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_I420_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_v210_I420_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -4326,7 +4393,7 @@ convert_v210_I420_10 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4348,8 +4415,8 @@ convert_v210_I420_10 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_I420_10_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_v210_I420_10_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -4398,7 +4465,7 @@ convert_YUY2_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4421,8 +4488,8 @@ convert_YUY2_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_AYUV_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_YUY2_AYUV_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4505,7 +4572,7 @@ convert_YUY2_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4527,8 +4594,8 @@ convert_YUY2_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_v210_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_YUY2_v210_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4564,7 +4631,7 @@ convert_YUY2_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4590,8 +4657,8 @@ convert_YUY2_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_Y42B_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_YUY2_Y42B_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4629,7 +4696,7 @@ convert_YUY2_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4655,8 +4722,8 @@ convert_YUY2_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_Y444_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_YUY2_Y444_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4753,7 +4820,7 @@ convert_v210_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4779,8 +4846,8 @@ convert_v210_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_Y42B_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_v210_Y42B_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4877,7 +4944,7 @@ convert_v210_I422_10 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4903,8 +4970,8 @@ convert_v210_I422_10 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_I422_10_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_v210_I422_10_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4952,7 +5019,7 @@ convert_UYVY_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4974,8 +5041,8 @@ convert_UYVY_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_I420_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_I420_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -5012,7 +5079,7 @@ convert_UYVY_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5035,8 +5102,8 @@ convert_UYVY_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_AYUV_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_AYUV_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5119,7 +5186,7 @@ convert_UYVY_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5141,8 +5208,8 @@ convert_UYVY_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_v210_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_v210_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5172,7 +5239,7 @@ convert_UYVY_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5194,8 +5261,8 @@ convert_UYVY_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_YUY2_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_YUY2_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5285,7 +5352,7 @@ convert_v210_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5307,8 +5374,8 @@ convert_v210_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_UYVY_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_v210_UYVY_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5398,7 +5465,7 @@ convert_v210_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5420,8 +5487,8 @@ convert_v210_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_YUY2_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_v210_YUY2_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5457,7 +5524,7 @@ convert_UYVY_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5483,8 +5550,8 @@ convert_UYVY_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_Y42B_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_Y42B_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5522,7 +5589,7 @@ convert_UYVY_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5548,8 +5615,8 @@ convert_UYVY_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_Y444_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_Y444_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5578,7 +5645,7 @@ convert_UYVY_GRAY8 (GstVideoConverter * convert, const GstVideoFrame * src,
   s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
   d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5600,8 +5667,8 @@ convert_UYVY_GRAY8 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_GRAY8_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_GRAY8_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5647,7 +5714,7 @@ convert_AYUV_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
 
   /* only for even width/height */
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5675,8 +5742,8 @@ convert_AYUV_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_I420_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_I420_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5707,7 +5774,7 @@ convert_AYUV_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5729,8 +5796,8 @@ convert_AYUV_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_YUY2_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_YUY2_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5761,7 +5828,7 @@ convert_AYUV_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5783,8 +5850,8 @@ convert_AYUV_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_UYVY_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_UYVY_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5821,7 +5888,7 @@ convert_AYUV_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv += convert->out_x >> 1;
 
   /* only works for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5847,8 +5914,8 @@ convert_AYUV_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_Y42B_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_Y42B_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5884,7 +5951,7 @@ convert_AYUV_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5910,8 +5977,8 @@ convert_AYUV_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_Y444_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_Y444_task, (gpointer) tasks_p);
   convert_fill_border (convert, dest);
 }
 
@@ -5947,7 +6014,7 @@ convert_Y42B_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5973,8 +6040,8 @@ convert_Y42B_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y42B_YUY2_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y42B_YUY2_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6011,7 +6078,7 @@ convert_Y42B_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6037,8 +6104,8 @@ convert_Y42B_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y42B_UYVY_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y42B_UYVY_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6078,7 +6145,7 @@ convert_Y42B_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d += convert->out_x * 4;
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6105,8 +6172,8 @@ convert_Y42B_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y42B_AYUV_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y42B_AYUV_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6196,7 +6263,7 @@ convert_Y42B_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   sv = FRAME_GET_V_LINE (src, convert->in_y);
   sv += convert->in_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6222,8 +6289,8 @@ convert_Y42B_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y42B_v210_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y42B_v210_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6313,7 +6380,7 @@ convert_I422_10_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   sv = FRAME_GET_V_LINE (src, convert->in_y);
   sv += convert->in_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6339,8 +6406,8 @@ convert_I422_10_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I422_10_v210_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I422_10_v210_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6377,7 +6444,7 @@ convert_Y444_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6403,8 +6470,8 @@ convert_Y444_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y444_YUY2_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y444_YUY2_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6441,7 +6508,7 @@ convert_Y444_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6467,8 +6534,8 @@ convert_Y444_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y444_UYVY_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y444_UYVY_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6507,7 +6574,7 @@ convert_Y444_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += convert->out_x * 4;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6534,8 +6601,8 @@ convert_Y444_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y444_AYUV_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y444_AYUV_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6568,7 +6635,7 @@ convert_AYUV_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6591,8 +6658,8 @@ convert_AYUV_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_ARGB_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_ARGB_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6625,7 +6692,7 @@ convert_AYUV_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6648,8 +6715,8 @@ convert_AYUV_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_BGRA_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_BGRA_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6682,7 +6749,7 @@ convert_AYUV_ABGR (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6705,8 +6772,8 @@ convert_AYUV_ABGR (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_ABGR_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_ABGR_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6739,7 +6806,7 @@ convert_AYUV_RGBA (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6762,8 +6829,8 @@ convert_AYUV_RGBA (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_RGBA_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_RGBA_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6805,7 +6872,7 @@ convert_I420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6831,8 +6898,8 @@ convert_I420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_BGRA_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_BGRA_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6874,7 +6941,7 @@ convert_I420_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6900,8 +6967,8 @@ convert_I420_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_ARGB_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_ARGB_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6953,7 +7020,7 @@ convert_I420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6980,8 +7047,8 @@ convert_I420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_pack_ARGB_task,
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_pack_ARGB_task,
       (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
@@ -7037,7 +7104,7 @@ convert_A420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -7064,8 +7131,8 @@ convert_A420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_A420_pack_ARGB_task,
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_A420_pack_ARGB_task,
       (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
@@ -7110,7 +7177,7 @@ convert_A420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -7136,8 +7203,8 @@ convert_A420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_A420_BGRA_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_A420_BGRA_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -7320,7 +7387,7 @@ convert_plane_fill (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7340,8 +7407,8 @@ convert_plane_fill (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_fill_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_fill_task, (gpointer) tasks_p);
 }
 
 static void
@@ -7368,7 +7435,7 @@ convert_plane_h_double (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7390,8 +7457,8 @@ convert_plane_h_double (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_h_double_task,
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_h_double_task,
       (gpointer) tasks_p);
 }
 
@@ -7419,7 +7486,7 @@ convert_plane_h_halve (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7441,8 +7508,8 @@ convert_plane_h_halve (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_h_halve_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_h_halve_task, (gpointer) tasks_p);
 }
 
 static void
@@ -7472,7 +7539,7 @@ convert_plane_v_double (GstVideoConverter * convert,
   d2 += convert->fout_x[plane];
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7496,8 +7563,8 @@ convert_plane_v_double (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_v_double_task,
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_v_double_task,
       (gpointer) tasks_p);
 }
 
@@ -7531,7 +7598,7 @@ convert_plane_v_halve (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7553,8 +7620,8 @@ convert_plane_v_halve (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_v_halve_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_v_halve_task, (gpointer) tasks_p);
 }
 
 static void
@@ -7586,7 +7653,7 @@ convert_plane_hv_double (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7610,8 +7677,8 @@ convert_plane_hv_double (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_hv_double_task,
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_hv_double_task,
       (gpointer) tasks_p);
 }
 
@@ -7644,7 +7711,7 @@ convert_plane_hv_halve (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7666,8 +7733,8 @@ convert_plane_hv_halve (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_hv_halve_task,
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_hv_halve_task,
       (gpointer) tasks_p);
 }
 
@@ -7718,7 +7785,7 @@ convert_plane_hv (GstVideoConverter * convert,
   sstride = FRAME_GET_PLANE_STRIDE (src, splane);
   dstride = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7749,8 +7816,8 @@ convert_plane_hv (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_hv_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_hv_task, (gpointer) tasks_p);
 }
 
 static void
@@ -7964,7 +8031,7 @@ setup_scale (GstVideoConverter * convert)
   const GstVideoFormatInfo *in_finfo, *out_finfo;
   GstVideoFormat in_format, out_format;
   gboolean interlaced;
-  guint n_threads = convert->conversion_runner->n_threads;
+  guint n_threads = convert->n_threads;
 
   in_info = &convert->in_info;
   out_info = &convert->out_info;
@@ -8024,12 +8091,14 @@ setup_scale (GstVideoConverter * convert)
         convert->fh_scaler[0].scaler = g_new (GstVideoScaler *, n_threads);
         for (j = 0; j < n_threads; j++) {
           y_scaler =
-              gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, taps,
+              converter_scaler_new (convert, method,
+              GST_VIDEO_SCALER_FLAG_NONE, taps,
               GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, GST_VIDEO_COMP_Y,
                   in_width), GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (out_finfo,
                   GST_VIDEO_COMP_Y, out_width), convert->config);
           uv_scaler =
-              gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE,
+              converter_scaler_new (convert, method,
+              GST_VIDEO_SCALER_FLAG_NONE,
               gst_video_scaler_get_max_taps (y_scaler),
               GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, GST_VIDEO_COMP_U,
                   in_width), GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (out_finfo,
@@ -8055,8 +8124,9 @@ setup_scale (GstVideoConverter * convert)
         convert->fh_scaler[0].scaler = g_new (GstVideoScaler *, n_threads);
         for (j = 0; j < n_threads; j++) {
           convert->fh_scaler[0].scaler[j] =
-              gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, taps,
-              in_width, out_width, convert->config);
+              converter_scaler_new (convert, method,
+              GST_VIDEO_SCALER_FLAG_NONE, taps, in_width, out_width,
+              convert->config);
         }
       } else {
         convert->fh_scaler[0].scaler = NULL;
@@ -8072,7 +8142,7 @@ setup_scale (GstVideoConverter * convert)
 
       for (j = 0; j < n_threads; j++) {
         convert->fv_scaler[0].scaler[j] =
-            gst_video_scaler_new (method,
+            converter_scaler_new (convert, method,
             interlaced ?
             GST_VIDEO_SCALER_FLAG_INTERLACED : GST_VIDEO_SCALER_FLAG_NONE, taps,
             in_height, out_height, convert->config);
@@ -8220,8 +8290,8 @@ setup_scale (GstVideoConverter * convert)
 
         for (j = 0; j < n_threads; j++) {
           convert->fh_scaler[i].scaler[j] =
-              gst_video_scaler_new (resample_method, GST_VIDEO_SCALER_FLAG_NONE,
-              taps, iw, ow, config);
+              converter_scaler_new (convert, resample_method,
+              GST_VIDEO_SCALER_FLAG_NONE, taps, iw, ow, config);
         }
       } else {
         convert->fh_scaler[i].scaler = NULL;
@@ -8232,7 +8302,7 @@ setup_scale (GstVideoConverter * convert)
 
         for (j = 0; j < n_threads; j++) {
           convert->fv_scaler[i].scaler[j] =
-              gst_video_scaler_new (resample_method,
+              converter_scaler_new (convert, resample_method,
               interlaced ?
               GST_VIDEO_SCALER_FLAG_INTERLACED : GST_VIDEO_SCALER_FLAG_NONE,
               taps, ih, oh, config);
@@ -8308,20 +8378,20 @@ convert_RGBA_F16_F32 (GstVideoConverter * convert,
   guint8 *s, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  GstParallelizedTaskFunc task_func;
+  GstVideoParallelFunc task_func;
   gint n_threads, lines_per_thread, i;
 
   task_func = GST_VIDEO_INFO_FORMAT (&convert->in_info) ==
       GST_VIDEO_FORMAT_RGBA_F16LE ?
-      (GstParallelizedTaskFunc) convert_RGBA_F16LE_F32_task :
-      (GstParallelizedTaskFunc) convert_RGBA_F16BE_F32_task;
+      (GstVideoParallelFunc) convert_RGBA_F16LE_F32_task :
+      (GstVideoParallelFunc) convert_RGBA_F16BE_F32_task;
 
   s = FRAME_GET_LINE (src, convert->in_y);
   s += convert->in_x * 8;
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += convert->out_x * 16;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -8339,7 +8409,7 @@ convert_RGBA_F16_F32 (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner, task_func,
+  gst_video_parallel_runner_run (convert->conversion_runner, task_func,
       (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
@@ -8354,20 +8424,20 @@ convert_RGBA_F32_F16 (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  GstParallelizedTaskFunc task_func;
+  GstVideoParallelFunc task_func;
   gint n_threads, lines_per_thread, i;
 
   task_func = GST_VIDEO_INFO_FORMAT (&convert->in_info) ==
       GST_VIDEO_FORMAT_RGBA_F32LE ?
-      (GstParallelizedTaskFunc) convert_RGBA_F32LE_F16_task :
-      (GstParallelizedTaskFunc) convert_RGBA_F32BE_F16_task;
+      (GstVideoParallelFunc) convert_RGBA_F32LE_F16_task :
+      (GstVideoParallelFunc) convert_RGBA_F32BE_F16_task;
 
   s = FRAME_GET_LINE (src, convert->in_y);
   s += convert->in_x * 16;
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += convert->out_x * 8;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -8385,12 +8455,291 @@ convert_RGBA_F32_F16 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner, task_func,
+  gst_video_parallel_runner_run (convert->conversion_runner, task_func,
       (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
 
+/* Fused convert and scale between 8 bit YUV formats: every output line of a
+ * component is made in one pass over the input, by filtering the used part
+ * of the input lines vertically into a temporary line (or using the input
+ * line directly when there is nothing to filter) and then filtering that
+ * horizontally straight into the output. */
+typedef struct
+{
+  GstVideoConverter *convert;
+  const GstVideoFrame *src;
+  GstVideoFrame *dest;
+  gint y_start, y_end;
+  guint8 *lines;
+} FFusedScaleTask;
+
+static const guint8 *
+fused_scale_get_line (FusedComponent * fc, const GstVideoFrame * src,
+    guint8 * tmp, guint line)
+{
+  const guint8 *lines[GST_VIDEO_FUSED_MAX_TAPS];
+  gint16 taps[GST_VIDEO_FUSED_MAX_TAPS];
+  guint k, n_taps = 0, first = fc->v.offset[line];
+
+  for (k = 0; k < fc->v.n_taps; k++) {
+    gint16 tap = fc->v.taps[k * fc->v.out_size + line];
+
+    if (tap == 0)
+      continue;
+
+    lines[n_taps] = (guint8 *) FRAME_GET_PLANE_LINE (src, fc->splane,
+        fc->sy + first + k) + fc->sx;
+    taps[n_taps++] = tap;
+  }
+
+  if (n_taps == 1 && taps[0] == GST_VIDEO_FUSED_TAP_ONE)
+    return lines[0];
+
+  gst_video_fused_blend_lines (tmp, lines, taps, n_taps, 0, fc->span);
+
+  return tmp;
+}
+
+static void
+fused_scale_put_line (FusedComponent * fc, GstVideoFrame * dest,
+    const guint8 * s, guint8 * tmp, guint line)
+{
+  guint8 *d;
+  guint i;
+
+  d = (guint8 *) FRAME_GET_PLANE_LINE (dest, fc->dplane, fc->dy + line) +
+      fc->dx;
+
+  if (fc->dpstride == 1) {
+    gst_video_fused_resample (d, s, &fc->h, 0, fc->h.out_size);
+  } else {
+    gst_video_fused_resample (tmp, s, &fc->h, 0, fc->h.out_size);
+    for (i = 0; i < fc->h.out_size; i++)
+      d[i * fc->dpstride] = tmp[i];
+  }
+}
+
+static void
+convert_fused_scale_task (FFusedScaleTask * task)
+{
+  GstVideoConverter *convert = task->convert;
+  FusedComponent *fy = &convert->fused[0];
+  FusedComponent *fu = &convert->fused[1];
+  FusedComponent *fv = &convert->fused[2];
+  guint8 *vline = task->lines;
+  guint8 *hline = task->lines + convert->fused_span;
+  const guint8 *s;
+  gint y, start, end;
+
+  for (y = task->y_start; y < task->y_end; y++) {
+    s = fused_scale_get_line (fy, task->src, vline, y);
+    fused_scale_put_line (fy, task->dest, s, hline, y);
+  }
+
+  start = GST_VIDEO_SUB_SCALE (fu->h_sub, task->y_start);
+  end = GST_VIDEO_SUB_SCALE (fu->h_sub, task->y_end);
+
+  for (y = start; y < end; y++) {
+    s = fused_scale_get_line (fu, task->src, vline, y);
+    fused_scale_put_line (fu, task->dest, s, hline, y);
+    /* packed and semi-planar input has U and V on the same lines */
+    if (!convert->fused_share_lines)
+      s = fused_scale_get_line (fv, task->src, vline, y);
+    fused_scale_put_line (fv, task->dest, s, hline, y);
+  }
+}
+
+static void
+convert_fused_scale (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  gint height = convert->out_height;
+  FFusedScaleTask *tasks;
+  FFusedScaleTask **tasks_p;
+  gint n_threads, lines_per_thread, i;
+
+  n_threads = convert->n_threads;
+  tasks = convert->tasks[0] =
+      g_renew (FFusedScaleTask, convert->tasks[0], n_threads);
+  tasks_p = convert->tasks_p[0] =
+      g_renew (FFusedScaleTask *, convert->tasks_p[0], n_threads);
+  /* even so that no chroma line is made by two threads */
+  lines_per_thread = GST_ROUND_UP_2 ((height + n_threads - 1) / n_threads);
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].convert = convert;
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+    tasks[i].lines = convert->fused_lines[i];
+    tasks[i].y_start = MIN (i * lines_per_thread, height);
+    tasks[i].y_end = MIN ((i + 1) * lines_per_thread, height);
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_fused_scale_task, (gpointer) tasks_p);
+
+  convert_fill_border (convert, dest);
+}
+
+gboolean
+gst_video_converter_uses_fused_scale (GstVideoConverter * convert)
+{
+  g_return_val_if_fail (convert != NULL, FALSE);
+
+  return convert->convert == convert_fused_scale;
+}
+
+/* converts the taps of a scaler to fixed point, @offset gets the byte offset
+ * of the first input sample of each output, @pstride bytes apart */
+static gboolean
+setup_fused_filter (GstVideoFusedFilter * filter, gint method, guint taps,
+    guint in_size, guint out_size, guint pstride, guint poffset,
+    GstStructure * config)
+{
+  GstVideoScaler *scaler;
+  guint i, k, n_taps;
+  gboolean res = FALSE;
+
+  scaler = gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, taps,
+      in_size, out_size, config);
+  n_taps = gst_video_scaler_get_max_taps (scaler);
+  if (n_taps > GST_VIDEO_FUSED_MAX_TAPS || n_taps > in_size) {
+    GST_LOG ("%u taps from %u inputs not supported", n_taps, in_size);
+    goto done;
+  }
+
+  filter->out_size = out_size;
+  filter->n_taps = n_taps;
+  filter->pstride = pstride;
+  filter->offset = g_new (guint32, out_size);
+  filter->taps = g_new (gint16, n_taps * out_size);
+  filter->safe_size = 0;
+
+  for (i = 0; i < out_size; i++) {
+    const gdouble *coeff;
+    guint in_offset, max = 0;
+    gint16 *t = filter->taps + i;
+    gint sum = 0;
+
+    coeff = gst_video_scaler_get_coeff (scaler, i, &in_offset, NULL);
+    if (in_offset + n_taps > in_size)
+      goto done;
+
+    for (k = 0; k < n_taps; k++) {
+      t[k * out_size] = lrint (coeff[k] * GST_VIDEO_FUSED_TAP_ONE);
+      sum += t[k * out_size];
+      if (t[k * out_size] > t[max * out_size])
+        max = k;
+    }
+    /* make the taps add up to one so that flat areas stay exactly flat */
+    t[max * out_size] += GST_VIDEO_FUSED_TAP_ONE - sum;
+
+    filter->offset[i] = in_offset * pstride + poffset;
+    if (filter->offset[i] + (n_taps - 1) * pstride + 4 <= in_size * pstride)
+      filter->safe_size = i + 1;
+  }
+  res = TRUE;
+
+done:
+  gst_video_scaler_free (scaler);
+
+  return res;
+}
+
+static gboolean
+setup_fused_scale (GstVideoConverter * convert)
+{
+  ConverterPlan *plan = convert->plan;
+  const GstVideoFormatInfo *in_finfo, *out_finfo;
+  gint method, cr_method;
+  guint i, taps, max_width = 0;
+  gboolean build, res;
+
+  in_finfo = convert->in_info.finfo;
+  out_finfo = convert->out_info.finfo;
+
+  if (convert->in_width == 0 || convert->in_height == 0 ||
+      convert->out_width == 0 || convert->out_height == 0)
+    return FALSE;
+
+  method = GET_OPT_RESAMPLER_METHOD (convert);
+  if (method == GST_VIDEO_RESAMPLER_METHOD_NEAREST)
+    cr_method = method;
+  else
+    cr_method = GET_OPT_CHROMA_RESAMPLER_METHOD (convert);
+  taps = GET_OPT_RESAMPLER_TAPS (convert);
+
+  /* the filters are made by the first converter of the plan */
+  g_mutex_lock (&plan->lock);
+  build = !plan->fused_done;
+  if (build)
+    plan->fused_ok = TRUE;
+
+  for (i = 0; i < 3; i++) {
+    FusedComponent *fc = &convert->fused[i];
+    gint iw, ih, ow, oh, pstride;
+
+    iw = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, i, convert->in_width);
+    ih = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (in_finfo, i, convert->in_height);
+    ow = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (out_finfo, i, convert->out_width);
+    oh = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (out_finfo, i,
+        convert->out_height);
+    pstride = GST_VIDEO_FORMAT_INFO_PSTRIDE (in_finfo, i);
+
+    fc->splane = GST_VIDEO_FORMAT_INFO_PLANE (in_finfo, i);
+    fc->sx = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, i,
+        convert->in_x) * pstride;
+    fc->sy = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (in_finfo, i, convert->in_y);
+    fc->span = iw * pstride;
+
+    fc->dplane = GST_VIDEO_FORMAT_INFO_PLANE (out_finfo, i);
+    fc->dpstride = GST_VIDEO_FORMAT_INFO_PSTRIDE (out_finfo, i);
+    fc->dx = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (out_finfo, i,
+        convert->out_x) * fc->dpstride;
+    fc->dx += GST_VIDEO_FORMAT_INFO_POFFSET (out_finfo, i);
+    fc->dy = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (out_finfo, i,
+        convert->out_y);
+    fc->h_sub = GST_VIDEO_FORMAT_INFO_H_SUB (out_finfo, i);
+
+    if (build && plan->fused_ok) {
+      plan->fused_ok =
+          setup_fused_filter (&plan->fused_h[i], i == 0 ? method : cr_method,
+          taps, iw, ow, pstride, GST_VIDEO_FORMAT_INFO_POFFSET (in_finfo, i),
+          convert->config)
+          && setup_fused_filter (&plan->fused_v[i],
+          i == 0 ? method : cr_method, taps, ih, oh, 1, 0, convert->config);
+    }
+    fc->h = plan->fused_h[i];
+    fc->v = plan->fused_v[i];
+
+    GST_LOG ("component %u: %dx%d -> %dx%d, %u x %u taps", i, iw, ih, ow, oh,
+        fc->h.n_taps, fc->v.n_taps);
+
+    convert->fused_span = MAX (convert->fused_span, fc->span);
+    max_width = MAX (max_width, ow);
+  }
+  plan->fused_done = TRUE;
+  res = plan->fused_ok;
+  g_mutex_unlock (&plan->lock);
+
+  if (!res)
+    return FALSE;
+
+  convert->fused_share_lines =
+      convert->fused[1].splane == convert->fused[2].splane;
+
+  convert->fused_lines = g_new (guint8 *, convert->n_threads);
+  for (i = 0; i < convert->n_threads; i++)
+    convert->fused_lines[i] = g_malloc (convert->fused_span + max_width);
+
+  GST_DEBUG ("using fused convert and scale");
+
+  return TRUE;
+}
+
 /* Fast paths */
 
 typedef struct
@@ -8902,6 +9251,31 @@ static const VideoTransform transforms[] = {
       TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
   {GST_VIDEO_FORMAT_GRAY16_BE, GST_VIDEO_FORMAT_GRAY16_BE, TRUE, FALSE, FALSE,
       TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
+
+  /* fused convert and scale, for the sizes and crops the entries above
+   * don't handle */
+  {GST_VIDEO_FORMAT_YUY2, GST_VIDEO_FORMAT_I420, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_fused_scale},
+  {GST_VIDEO_FORMAT_YUY2, GST_VIDEO_FORMAT_NV12, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_fused_scale},
+  {GST_VIDEO_FORMAT_UYVY, GST_VIDEO_FORMAT_I420, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_fused_scale},
+  {GST_VIDEO_FORMAT_UYVY, GST_VIDEO_FORMAT_NV12, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_fused_scale},
+  {GST_VIDEO_FORMAT_YVYU, GST_VIDEO_FORMAT_I420, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_fused_scale},
+  {GST_VIDEO_FORMAT_YVYU, GST_VIDEO_FORMAT_NV12, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_fused_scale},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_fused_scale},
+  {GST_VIDEO_FORMAT_NV21, GST_VIDEO_FORMAT_I420, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_fused_scale},
+  {GST_VIDEO_FORMAT_NV21, GST_VIDEO_FORMAT_NV12, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_fused_scale},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_fused_scale},
+  {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV12, FALSE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_fused_scale},
 };
 
 static gboolean
@@ -9002,14 +9376,17 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
         video_converter_compute_matrix (convert);
       convert->convert = transforms[i].convert;
 
-      convert->tmpline =
-          g_new (guint16 *, convert->conversion_runner->n_threads);
-      for (j = 0; j < convert->conversion_runner->n_threads; j++)
+      convert->tmpline = g_new (guint16 *, convert->n_threads);
+      for (j = 0; j < convert->n_threads; j++)
         convert->tmpline[j] = g_malloc0 (sizeof (guint16) * (width + 8) * 4);
 
-      if (!transforms[i].keeps_size)
+      if (transforms[i].convert == convert_fused_scale) {
+        if (!setup_fused_scale (convert))
+          return FALSE;
+      } else if (!transforms[i].keeps_size) {
         if (!setup_scale (convert))
           return FALSE;
+      }
       if (border)
         setup_borderline (convert);
       return TRUE;
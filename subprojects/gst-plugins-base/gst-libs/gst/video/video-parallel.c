@@ -0,0 +1,712 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if defined(HAVE_PTHREAD_SETAFFINITY_NP) || defined(HAVE_SCHED_GETCPU)
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+#include <pthread.h>
+#endif
+
+#include "video-parallel.h"
+
+/**
+ * SECTION:videoparallel
+ * @title: GstVideoParallelRunner
+ * @short_description: Running video processing in parallel slices
+ *
+ * #GstVideoParallelRunner splits an operation, usually the processing of a
+ * frame, into one slice per thread and runs the slices on a #GstTaskPool.
+ * It is used by #GstVideoConverter and by elements that blend or filter
+ * frames in parallel.
+ *
+ * Slices are not bound to a thread: every job pushed to the pool, and the
+ * thread that runs the operation, takes the next slice that was not started
+ * yet until none is left. Slow slices thus don't hold back the others, and
+ * a runner keeps making progress when the pool is busy with other work.
+ *
+ * Runners that are created without a pool share a process-wide
+ * #GstWorkStealingTaskPool, see gst_video_parallel_get_default_pool(), so
+ * that many converters or compositors in one process don't each start one
+ * thread per CPU core. On systems with several NUMA nodes there is one such
+ * pool per node, its threads are bound to the CPUs of the node and a runner
+ * uses the pool of the node it was created on, so that the slices run close
+ * to the memory of the frames.
+ *
+ * Since: 1.30
+ */
+
+#ifndef GST_DISABLE_GST_DEBUG
+#define GST_CAT_DEFAULT ensure_debug_category()
+static GstDebugCategory *
+ensure_debug_category (void)
+{
+  static gsize cat_gonce = 0;
+
+  if (g_once_init_enter (&cat_gonce)) {
+    gsize cat_done;
+
+    cat_done = (gsize) _gst_debug_category_new ("video-parallel", 0,
+        "video-parallel object");
+
+    g_once_init_leave (&cat_gonce, cat_done);
+  }
+
+  return (GstDebugCategory *) cat_gonce;
+}
+#else
+#define ensure_debug_category() /* NOOP */
+#endif /* GST_DISABLE_GST_DEBUG */
+
+typedef struct
+{
+  /* the pool shared by all runners on the node, created on first use */
+  GstTaskPool *pool;
+  guint n_cpus;
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+  cpu_set_t cpus;
+#endif
+} ParallelNode;
+
+typedef struct
+{
+  guint n_nodes;
+  ParallelNode *nodes;
+
+  /* node index of each CPU, -1 for CPUs we may not run on */
+  guint n_cpus;
+  gint *cpu_node;
+} ParallelTopology;
+
+struct _GstVideoParallelRunner
+{
+  /* one for the owner and one for every job pushed to the pool */
+  gint refcount;
+
+  GstTaskPool *pool;
+  /* node of the default pool that is used, or -1 */
+  gint node;
+  guint n_threads;
+  gboolean async_tasks;
+
+  GMutex lock;
+  GCond cond;
+
+  /* current run */
+  GstVideoParallelFunc func;
+  gpointer *task_data;
+  guint n_slices;
+  guint next_slice;
+  guint n_done;
+  GstClockTime run_total;
+  GstClockTime run_max;
+
+  /* statistics over all runs */
+  guint64 n_runs;
+  guint64 n_slices_total;
+  GstClockTime total_time;
+  GstClockTime critical_time;
+  gdouble imbalance_sum;
+};
+
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+/* node the pool worker running on this thread is bound to, plus one */
+static GPrivate bound_node;
+
+static gboolean
+parse_cpulist (const gchar * list, cpu_set_t * set)
+{
+  gchar **ranges;
+  guint i;
+  gboolean ret = TRUE;
+
+  CPU_ZERO (set);
+
+  ranges = g_strsplit (list, ",", -1);
+  for (i = 0; ranges[i] && ret; i++) {
+    gchar *end;
+    guint64 first, last;
+
+    if (*g_strstrip (ranges[i]) == '\0')
+      continue;
+
+    first = last = g_ascii_strtoull (ranges[i], &end, 10);
+    if (*end == '-')
+      last = g_ascii_strtoull (end + 1, &end, 10);
+
+    if (*end != '\0' || last < first || last >= CPU_SETSIZE) {
+      ret = FALSE;
+      break;
+    }
+
+    for (; first <= last; first++)
+      CPU_SET (first, set);
+  }
+  g_strfreev (ranges);
+
+  return ret;
+}
+
+/* Reads the CPUs of every NUMA node the process may run on */
+static GArray *
+read_numa_nodes (void)
+{
+  GArray *nodes;
+  cpu_set_t allowed;
+  GDir *dir;
+  const gchar *name;
+  guint64 max_id = 0;
+  guint64 id;
+
+  dir = g_dir_open ("/sys/devices/system/node", 0, NULL);
+  if (dir == NULL)
+    return NULL;
+
+  if (sched_getaffinity (0, sizeof (allowed), &allowed) != 0) {
+    g_dir_close (dir);
+    return NULL;
+  }
+
+  while ((name = g_dir_read_name (dir))) {
+    if (g_str_has_prefix (name, "node")
+        && g_ascii_string_to_unsigned (name + 4, 10, 0, 1023, &id, NULL))
+      max_id = MAX (max_id, id + 1);
+  }
+  g_dir_close (dir);
+
+  nodes = g_array_new (FALSE, TRUE, sizeof (ParallelNode));
+
+  for (id = 0; id < max_id; id++) {
+    ParallelNode node = { NULL, };
+    gchar *path, *contents;
+
+    path = g_strdup_printf ("/sys/devices/system/node/node%" G_GUINT64_FORMAT
+        "/cpulist", id);
+    if (!g_file_get_contents (path, &contents, NULL, NULL)) {
+      g_free (path);
+      continue;
+    }
+    g_free (path);
+
+    if (parse_cpulist (contents, &node.cpus)) {
+      CPU_AND (&node.cpus, &node.cpus, &allowed);
+      node.n_cpus = CPU_COUNT (&node.cpus);
+      if (node.n_cpus > 0)
+        g_array_append_val (nodes, node);
+    }
+    g_free (contents);
+  }
+
+  if (nodes->len == 0) {
+    g_array_free (nodes, TRUE);
+    return NULL;
+  }
+
+  return nodes;
+}
+#endif
+
+static ParallelTopology *
+get_topology (void)
+{
+  static ParallelTopology *topology = NULL;
+
+  if (g_once_init_enter (&topology)) {
+    ParallelTopology *t = g_new0 (ParallelTopology, 1);
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+    GArray *nodes = read_numa_nodes ();
+
+    if (nodes && nodes->len > 1) {
+      guint cpu, i;
+
+      t->n_nodes = nodes->len;
+      t->nodes = (ParallelNode *) g_array_free (nodes, FALSE);
+
+      t->n_cpus = CPU_SETSIZE;
+      t->cpu_node = g_new (gint, t->n_cpus);
+      for (cpu = 0; cpu < t->n_cpus; cpu++) {
+        t->cpu_node[cpu] = -1;
+        for (i = 0; i < t->n_nodes; i++) {
+          if (CPU_ISSET (cpu, &t->nodes[i].cpus))
+            t->cpu_node[cpu] = i;
+        }
+      }
+    } else if (nodes) {
+      g_array_free (nodes, TRUE);
+    }
+#endif
+
+    /* without NUMA information all CPUs are one node and threads are not
+     * bound */
+    if (t->n_nodes == 0) {
+      t->n_nodes = 1;
+      t->nodes = g_new0 (ParallelNode, 1);
+      t->nodes[0].n_cpus = g_get_num_processors ();
+    }
+
+    GST_INFO ("found %u nodes", t->n_nodes);
+
+    g_once_init_leave (&topology, t);
+  }
+
+  return topology;
+}
+
+static GstTaskPool *
+get_node_pool (ParallelTopology * topology, gint node)
+{
+  static GMutex lock;
+  GstTaskPool *pool;
+
+  g_mutex_lock (&lock);
+  if (!topology->nodes[node].pool) {
+    pool = gst_work_stealing_task_pool_new (topology->nodes[node].n_cpus);
+    GST_OBJECT_FLAG_SET (pool, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+    gst_task_pool_prepare (pool, NULL);
+    GST_INFO ("created default pool for node %d with %u threads", node,
+        topology->nodes[node].n_cpus);
+    topology->nodes[node].pool = pool;
+  }
+  pool = gst_object_ref (topology->nodes[node].pool);
+  g_mutex_unlock (&lock);
+
+  return pool;
+}
+
+static gint
+get_current_node (ParallelTopology * topology)
+{
+#ifdef HAVE_SCHED_GETCPU
+  if (topology->n_nodes > 1) {
+    gint cpu = sched_getcpu ();
+
+    if (cpu >= 0 && (guint) cpu < topology->n_cpus
+        && topology->cpu_node[cpu] >= 0)
+      return topology->cpu_node[cpu];
+  }
+#endif
+
+  return 0;
+}
+
+/**
+ * gst_video_parallel_get_default_pool:
+ *
+ * Get the process-wide task pool that #GstVideoParallelRunner uses when no
+ * pool is given. On systems with several NUMA nodes, this is the pool of the
+ * node the calling thread currently runs on.
+ *
+ * The pool is prepared and must not be cleaned up.
+ *
+ * Returns: (transfer full): the default #GstTaskPool for parallel video
+ *     processing
+ *
+ * Since: 1.30
+ */
+GstTaskPool *
+gst_video_parallel_get_default_pool (void)
+{
+  ParallelTopology *topology = get_topology ();
+
+  return get_node_pool (topology, get_current_node (topology));
+}
+
+/**
+ * gst_video_parallel_get_max_threads:
+ * @pool: (nullable): a #GstTaskPool
+ *
+ * Get the number of threads that can run jobs of @pool at the same time, or
+ * of the default pool if @pool is %NULL.
+ *
+ * Returns: the number of threads of @pool, or 0 if it is not known
+ *
+ * Since: 1.30
+ */
+guint
+gst_video_parallel_get_max_threads (GstTaskPool * pool)
+{
+  if (pool == NULL) {
+    ParallelTopology *topology = get_topology ();
+
+    return topology->nodes[get_current_node (topology)].n_cpus;
+  }
+
+  g_return_val_if_fail (GST_IS_TASK_POOL (pool), 0);
+
+  if (GST_IS_SHARED_TASK_POOL (pool))
+    return gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool));
+  if (GST_IS_WORK_STEALING_TASK_POOL (pool))
+    return
+        gst_work_stealing_task_pool_get_n_workers (GST_WORK_STEALING_TASK_POOL
+        (pool));
+
+  return 0;
+}
+
+static void
+gst_video_parallel_runner_unref (GstVideoParallelRunner * self)
+{
+  if (!g_atomic_int_dec_and_test (&self->refcount))
+    return;
+
+  gst_clear_object (&self->pool);
+  g_cond_clear (&self->cond);
+  g_mutex_clear (&self->lock);
+  g_free (self);
+}
+
+/* called with the lock */
+static void
+gst_video_parallel_runner_run_done (GstVideoParallelRunner * self)
+{
+  GstClockTime mean = self->run_total / self->n_slices;
+
+  self->n_runs++;
+  self->n_slices_total += self->n_slices;
+  self->total_time += self->run_total;
+  self->critical_time += self->run_max;
+  self->imbalance_sum += mean > 0 ? (gdouble) self->run_max / mean : 1.0;
+
+  GST_TRACE ("run of %u slices done, mean %" GST_TIME_FORMAT ", max %"
+      GST_TIME_FORMAT, self->n_slices, GST_TIME_ARGS (mean),
+      GST_TIME_ARGS (self->run_max));
+
+  g_cond_broadcast (&self->cond);
+}
+
+/* Runs the slices of the current run that no other thread started yet */
+static void
+gst_video_parallel_runner_run_slices (GstVideoParallelRunner * self)
+{
+  g_mutex_lock (&self->lock);
+  while (self->next_slice < self->n_slices) {
+    GstVideoParallelFunc func = self->func;
+    gpointer data = self->task_data[self->next_slice++];
+    GstClockTime start, duration;
+
+    g_mutex_unlock (&self->lock);
+    start = gst_util_get_timestamp ();
+    func (data);
+    duration = gst_util_get_timestamp () - start;
+    g_mutex_lock (&self->lock);
+
+    self->run_total += duration;
+    self->run_max = MAX (self->run_max, duration);
+    if (++self->n_done == self->n_slices)
+      gst_video_parallel_runner_run_done (self);
+  }
+  g_mutex_unlock (&self->lock);
+}
+
+static void
+gst_video_parallel_runner_job (gpointer data)
+{
+  GstVideoParallelRunner *self = data;
+
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+  if (self->node >= 0
+      && GPOINTER_TO_INT (g_private_get (&bound_node)) != self->node + 1) {
+    ParallelTopology *topology = get_topology ();
+
+    /* the workers of a default pool only ever run jobs of that node, so
+     * they are bound once */
+    if (topology->n_nodes > 1) {
+      pthread_setaffinity_np (pthread_self (), sizeof (cpu_set_t),
+          &topology->nodes[self->node].cpus);
+      GST_DEBUG ("bound worker to node %d", self->node);
+    }
+    g_private_set (&bound_node, GINT_TO_POINTER (self->node + 1));
+  }
+#endif
+
+  gst_video_parallel_runner_run_slices (self);
+  gst_video_parallel_runner_unref (self);
+}
+
+/**
+ * gst_video_parallel_runner_new:
+ * @n_threads: the number of slices of every run, or 0 for one per CPU core
+ * @pool: (nullable): the #GstTaskPool to run the slices on, or %NULL to use
+ *     the default pool
+ * @async_tasks: whether gst_video_parallel_runner_run() returns before the
+ *     slices are done
+ *
+ * Create a new runner that splits every run into @n_threads slices. If
+ * @pool is %NULL, the process-wide pool of the NUMA node of the calling
+ * thread is used, see gst_video_parallel_get_default_pool().
+ *
+ * With @async_tasks, all slices run on the pool and
+ * gst_video_parallel_runner_finish() must be called to wait for them.
+ * Otherwise the calling thread takes part in every run and
+ * gst_video_parallel_runner_run() returns once all slices are done.
+ *
+ * Returns: (transfer full): a new #GstVideoParallelRunner, free with
+ *     gst_video_parallel_runner_free()
+ *
+ * Since: 1.30
+ */
+GstVideoParallelRunner *
+gst_video_parallel_runner_new (guint n_threads, GstTaskPool * pool,
+    gboolean async_tasks)
+{
+  GstVideoParallelRunner *self;
+  guint max_threads;
+
+  g_return_val_if_fail (pool == NULL || GST_IS_TASK_POOL (pool), NULL);
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  self = g_new0 (GstVideoParallelRunner, 1);
+  self->refcount = 1;
+
+  /* No reason to split up the work between more threads than the
+   * pool can run at once */
+  max_threads = gst_video_parallel_get_max_threads (pool);
+  if (max_threads > 0)
+    n_threads = MIN (n_threads, max_threads);
+
+  if (pool) {
+    self->pool = gst_object_ref (pool);
+    self->node = -1;
+  } else if (n_threads > 1 || async_tasks) {
+    ParallelTopology *topology = get_topology ();
+
+    self->node = get_current_node (topology);
+    self->pool = get_node_pool (topology, self->node);
+  } else {
+    /* everything runs on the calling thread */
+    self->node = -1;
+  }
+
+  self->n_threads = n_threads;
+  self->async_tasks = async_tasks;
+
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond);
+
+  GST_DEBUG ("created runner %p with %u threads on pool %" GST_PTR_FORMAT,
+      self, n_threads, self->pool);
+
+  return self;
+}
+
+/**
+ * gst_video_parallel_runner_free:
+ * @runner: a #GstVideoParallelRunner
+ *
+ * Wait for the current run of @runner and free it.
+ *
+ * Since: 1.30
+ */
+void
+gst_video_parallel_runner_free (GstVideoParallelRunner * runner)
+{
+  g_return_if_fail (runner != NULL);
+
+  gst_video_parallel_runner_finish (runner);
+
+  if (runner->n_runs > 0) {
+    GST_DEBUG ("runner %p: %" G_GUINT64_FORMAT " runs, mean imbalance %.3f",
+        runner, runner->n_runs, runner->imbalance_sum / runner->n_runs);
+  }
+
+  /* jobs that were pushed but found no slice left still hold a reference */
+  gst_video_parallel_runner_unref (runner);
+}
+
+/**
+ * gst_video_parallel_runner_get_n_threads:
+ * @runner: a #GstVideoParallelRunner
+ *
+ * Returns: the number of slices every run of @runner is split into
+ *
+ * Since: 1.30
+ */
+guint
+gst_video_parallel_runner_get_n_threads (GstVideoParallelRunner * runner)
+{
+  g_return_val_if_fail (runner != NULL, 0);
+
+  return runner->n_threads;
+}
+
+/**
+ * gst_video_parallel_runner_is_async:
+ * @runner: a #GstVideoParallelRunner
+ *
+ * Returns: %TRUE if @runner was created with async tasks
+ *
+ * Since: 1.30
+ */
+gboolean
+gst_video_parallel_runner_is_async (GstVideoParallelRunner * runner)
+{
+  g_return_val_if_fail (runner != NULL, FALSE);
+
+  return runner->async_tasks;
+}
+
+/**
+ * gst_video_parallel_runner_run:
+ * @runner: a #GstVideoParallelRunner
+ * @func: (scope call): the function that processes one slice
+ * @task_data: (array): the data for each of the
+ *     gst_video_parallel_runner_get_n_threads() slices
+ *
+ * Call @func for every element of @task_data in parallel. A previous run
+ * that is still in progress is waited for first.
+ *
+ * For a synchronous @runner this returns once all slices are done. For an
+ * asynchronous one, @task_data must stay valid until
+ * gst_video_parallel_runner_finish() returns.
+ *
+ * Since: 1.30
+ */
+void
+gst_video_parallel_runner_run (GstVideoParallelRunner * runner,
+    GstVideoParallelFunc func, gpointer * task_data)
+{
+  guint i, n_jobs;
+
+  g_return_if_fail (runner != NULL);
+  g_return_if_fail (func != NULL);
+  g_return_if_fail (task_data != NULL);
+
+  gst_video_parallel_runner_finish (runner);
+
+  if (runner->n_threads == 1 && !runner->async_tasks) {
+    GstClockTime start = gst_util_get_timestamp ();
+
+    func (task_data[0]);
+
+    g_mutex_lock (&runner->lock);
+    runner->n_slices = runner->n_done = runner->next_slice = 1;
+    runner->run_total = runner->run_max = gst_util_get_timestamp () - start;
+    gst_video_parallel_runner_run_done (runner);
+    g_mutex_unlock (&runner->lock);
+    return;
+  }
+
+  g_mutex_lock (&runner->lock);
+  runner->func = func;
+  runner->task_data = task_data;
+  runner->n_slices = runner->n_threads;
+  runner->next_slice = 0;
+  runner->n_done = 0;
+  runner->run_total = 0;
+  runner->run_max = 0;
+  g_mutex_unlock (&runner->lock);
+
+  /* if not async, one of the slices is run by the current thread */
+  n_jobs = runner->async_tasks ? runner->n_threads : runner->n_threads - 1;
+  for (i = 0; i < n_jobs; i++) {
+    GError *err = NULL;
+    gpointer handle;
+
+    g_atomic_int_inc (&runner->refcount);
+    handle = gst_task_pool_push (runner->pool, gst_video_parallel_runner_job,
+        runner, &err);
+    if (err) {
+      /* the remaining slices are run by the waiting thread */
+      GST_WARNING ("failed to push job: %s", err->message);
+      g_clear_error (&err);
+      g_atomic_int_add (&runner->refcount, -1);
+      break;
+    }
+    gst_task_pool_dispose_handle (runner->pool, handle);
+  }
+
+  if (!runner->async_tasks)
+    gst_video_parallel_runner_finish (runner);
+}
+
+/**
+ * gst_video_parallel_runner_finish:
+ * @runner: a #GstVideoParallelRunner
+ *
+ * Wait until all slices of the current run of @runner are done. Slices that
+ * did not start yet are run by the calling thread.
+ *
+ * Since: 1.30
+ */
+void
+gst_video_parallel_runner_finish (GstVideoParallelRunner * runner)
+{
+  g_return_if_fail (runner != NULL);
+
+  gst_video_parallel_runner_run_slices (runner);
+
+  g_mutex_lock (&runner->lock);
+  if (runner->n_done < runner->n_slices) {
+    g_mutex_unlock (&runner->lock);
+
+    /* let the pool start another worker if we are running on one */
+    gst_task_pool_blocking_begin ();
+    g_mutex_lock (&runner->lock);
+    while (runner->n_done < runner->n_slices)
+      g_cond_wait (&runner->cond, &runner->lock);
+    g_mutex_unlock (&runner->lock);
+    gst_task_pool_blocking_end ();
+  } else {
+    g_mutex_unlock (&runner->lock);
+  }
+}
+
+/**
+ * gst_video_parallel_runner_get_stats:
+ * @runner: a #GstVideoParallelRunner
+ *
+ * Get statistics about the runs of @runner. The returned structure contains
+ * the number of runs and slices as #guint64 "runs" and "slices", the mean
+ * duration of a slice and the mean duration of the slowest slice of a run
+ * in nanoseconds as #guint64 "mean-slice-time" and "mean-critical-time",
+ * and the mean ratio between the two as #gdouble "imbalance". An imbalance
+ * of 1.0 means that the work was split evenly.
+ *
+ * Returns: (transfer full): a new #GstStructure
+ *
+ * Since: 1.30
+ */
+GstStructure *
+gst_video_parallel_runner_get_stats (GstVideoParallelRunner * runner)
+{
+  GstStructure *s;
+
+  g_return_val_if_fail (runner != NULL, NULL);
+
+  g_mutex_lock (&runner->lock);
+  s = gst_structure_new_static_str ("GstVideoParallelRunnerStats",
+      "runs", G_TYPE_UINT64, runner->n_runs,
+      "slices", G_TYPE_UINT64, runner->n_slices_total,
+      "mean-slice-time", G_TYPE_UINT64, runner->n_slices_total > 0 ?
+      runner->total_time / runner->n_slices_total : (guint64) 0,
+      "mean-critical-time", G_TYPE_UINT64, runner->n_runs > 0 ?
+      runner->critical_time / runner->n_runs : (guint64) 0,
+      "imbalance", G_TYPE_DOUBLE, runner->n_runs > 0 ?
+      runner->imbalance_sum / runner->n_runs : 1.0, NULL);
+  g_mutex_unlock (&runner->lock);
+
+  return s;
+}
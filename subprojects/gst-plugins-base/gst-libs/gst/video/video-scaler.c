@@ -43,6 +43,7 @@
 
 #include "video-orc.h"
 #include "video-scaler.h"
+#include "gstvideoutilsprivate.h"
 
 #ifndef GST_DISABLE_GST_DEBUG
 #define GST_CAT_DEFAULT ensure_debug_category()
@@ -282,6 +283,35 @@ gst_video_scaler_free (GstVideoScaler * scale)
   g_free (scale);
 }
 
+/* Makes a new scaler with the same coefficients as @scale without computing
+ * them again. The integer coefficients and temporary lines are not copied,
+ * they are made again by the new scaler when it is first used. */
+GstVideoScaler *
+__gst_video_scaler_copy (GstVideoScaler * scale)
+{
+  GstVideoScaler *copy;
+  GstVideoResampler *r;
+
+  g_return_val_if_fail (scale != NULL, NULL);
+
+  copy = g_new0 (GstVideoScaler, 1);
+  copy->method = scale->method;
+  copy->flags = scale->flags;
+  copy->merged = scale->merged;
+  copy->in_y_offset = scale->in_y_offset;
+  copy->out_y_offset = scale->out_y_offset;
+  copy->inc = scale->inc;
+
+  r = &copy->resampler;
+  *r = scale->resampler;
+  r->offset = g_memdup2 (r->offset, sizeof (guint32) * r->out_size);
+  r->phase = g_memdup2 (r->phase, sizeof (guint32) * r->out_size);
+  r->n_taps = g_memdup2 (r->n_taps, sizeof (guint32) * r->out_size);
+  r->taps = g_memdup2 (r->taps, sizeof (gdouble) * r->max_taps * r->n_phases);
+
+  return copy;
+}
+
 /**
  * gst_video_scaler_get_max_taps:
  * @scale: a #GstVideoScaler
@@ -36,6 +36,7 @@ typedef struct _GstVideoRectangle GstVideoRectangle;
 #include <gst/video/video-converter.h>
 #include <gst/video/video-scaler.h>
 #include <gst/video/video-multiview.h>
+#include <gst/video/video-parallel.h>
 #include <gst/video/video-info-dma.h>
 
 G_BEGIN_DECLS
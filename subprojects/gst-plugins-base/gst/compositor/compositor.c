@@ -662,6 +662,16 @@ gst_compositor_pad_create_conversion_info (GstVideoAggregatorConvertPad * pad,
   }
 }
 
+static void
+gst_compositor_pad_finalize (GObject * object)
+{
+  GstCompositorPad *pad = GST_COMPOSITOR_PAD (object);
+
+  gst_clear_buffer (&pad->damage_buffer);
+
+  G_OBJECT_CLASS (gst_compositor_pad_parent_class)->finalize (object);
+}
+
 static void
 gst_compositor_pad_class_init (GstCompositorPadClass * klass)
 {
@@ -673,6 +683,7 @@ gst_compositor_pad_class_init (GstCompositorPadClass * klass)
 
   gobject_class->set_property = gst_compositor_pad_set_property;
   gobject_class->get_property = gst_compositor_pad_get_property;
+  gobject_class->finalize = gst_compositor_pad_finalize;
 
   g_object_class_install_property (gobject_class, PROP_PAD_XPOS,
       g_param_spec_int ("xpos", "X Position", "X Position of the picture",
@@ -735,6 +746,7 @@ gst_compositor_pad_init (GstCompositorPad * compo_pad)
   compo_pad->width = DEFAULT_PAD_WIDTH;
   compo_pad->height = DEFAULT_PAD_HEIGHT;
   compo_pad->sizing_policy = DEFAULT_PAD_SIZING_POLICY;
+  compo_pad->damage_index = G_MAXUINT;
 }
 
 
@@ -742,6 +754,12 @@ gst_compositor_pad_init (GstCompositorPad * compo_pad)
 #define DEFAULT_BACKGROUND COMPOSITOR_BACKGROUND_CHECKER
 #define DEFAULT_ZERO_SIZE_IS_UNSCALED TRUE
 #define DEFAULT_MAX_THREADS 0
+#define DEFAULT_DAMAGE_TRACKING FALSE
+#define DEFAULT_TILE_THRESHOLD 8
+
+/* Output bytes composited at once in tiled mode, small enough to stay in the
+ * cache together with the input lines */
+#define TILE_SIZE (128 * 1024)
 
 enum
 {
@@ -750,8 +768,28 @@ enum
   PROP_ZERO_SIZE_IS_UNSCALED,
   PROP_MAX_THREADS,
   PROP_IGNORE_INACTIVE_PADS,
+  PROP_DAMAGE_TRACKING,
+  PROP_STATS,
+  PROP_TILE_THRESHOLD,
 };
 
+static GstStructure *
+gst_compositor_create_stats (GstCompositor * self)
+{
+  GstStructure *s;
+
+  GST_OBJECT_LOCK (self);
+  s = gst_structure_new ("application/x-compositor-stats",
+      "frames", G_TYPE_UINT64, self->stats_frames,
+      "full-frames", G_TYPE_UINT64, self->stats_full_frames,
+      "tiled-frames", G_TYPE_UINT64, self->stats_tiled_frames,
+      "blended-pixels", G_TYPE_UINT64, self->stats_blended_pixels,
+      "skipped-pixels", G_TYPE_UINT64, self->stats_skipped_pixels, NULL);
+  GST_OBJECT_UNLOCK (self);
+
+  return s;
+}
+
 static void
 gst_compositor_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec)
@@ -772,6 +810,15 @@ gst_compositor_get_property (GObject * object,
       g_value_set_boolean (value,
           gst_aggregator_get_ignore_inactive_pads (GST_AGGREGATOR (object)));
       break;
+    case PROP_DAMAGE_TRACKING:
+      g_value_set_boolean (value, self->damage_tracking);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_compositor_create_stats (self));
+      break;
+    case PROP_TILE_THRESHOLD:
+      g_value_set_uint (value, self->tile_threshold);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -786,7 +833,10 @@ gst_compositor_set_property (GObject * object,
 
   switch (prop_id) {
     case PROP_BACKGROUND:
+      GST_OBJECT_LOCK (self);
       self->background = g_value_get_enum (value);
+      self->damage_reset = TRUE;
+      GST_OBJECT_UNLOCK (self);
       break;
     case PROP_ZERO_SIZE_IS_UNSCALED:
       self->zero_size_is_unscaled = g_value_get_boolean (value);
@@ -798,6 +848,17 @@ gst_compositor_set_property (GObject * object,
       gst_aggregator_set_ignore_inactive_pads (GST_AGGREGATOR (object),
           g_value_get_boolean (value));
       break;
+    case PROP_DAMAGE_TRACKING:
+      GST_OBJECT_LOCK (self);
+      self->damage_tracking = g_value_get_boolean (value);
+      self->damage_reset = TRUE;
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_TILE_THRESHOLD:
+      GST_OBJECT_LOCK (self);
+      self->tile_threshold = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1303,148 +1364,6 @@ _fixate_caps (GstAggregator * agg, GstCaps * caps)
   return ret;
 }
 
-static void
-gst_parallelized_task_thread_func (gpointer data)
-{
-  GstParallelizedTaskRunner *runner = data;
-  gint idx;
-
-  g_mutex_lock (&runner->lock);
-  idx = runner->n_todo--;
-  g_assert (runner->n_todo >= -1);
-  g_mutex_unlock (&runner->lock);
-
-  g_assert (runner->func != NULL);
-
-  runner->func (runner->task_data[idx]);
-}
-
-static void
-gst_parallelized_task_runner_join (GstParallelizedTaskRunner * self)
-{
-  gboolean joined = FALSE;
-
-  while (!joined) {
-    g_mutex_lock (&self->lock);
-    if (!(joined = gst_vec_deque_is_empty (self->tasks))) {
-      gpointer task = gst_vec_deque_pop_head (self->tasks);
-      g_mutex_unlock (&self->lock);
-      gst_task_pool_join (self->pool, task);
-    } else {
-      g_mutex_unlock (&self->lock);
-    }
-  }
-}
-
-static void
-gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
-{
-  gst_parallelized_task_runner_join (self);
-
-  gst_vec_deque_free (self->tasks);
-  if (self->own_pool)
-    gst_task_pool_cleanup (self->pool);
-  gst_object_unref (self->pool);
-  g_mutex_clear (&self->lock);
-  g_free (self);
-}
-
-static GstParallelizedTaskRunner *
-gst_parallelized_task_runner_new (guint n_threads, GstTaskPool * pool,
-    gboolean async_tasks)
-{
-  GstParallelizedTaskRunner *self;
-
-  if (n_threads == 0)
-    n_threads = g_get_num_processors ();
-
-  self = g_new0 (GstParallelizedTaskRunner, 1);
-
-  if (pool) {
-    self->pool = g_object_ref (pool);
-    self->own_pool = FALSE;
-
-    /* No reason to split up the work between more threads than the
-     * pool can spawn */
-    if (GST_IS_SHARED_TASK_POOL (pool))
-      n_threads =
-          MIN (n_threads,
-          gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool)));
-  } else {
-    self->pool = gst_shared_task_pool_new ();
-    self->own_pool = TRUE;
-    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (self->pool),
-        n_threads);
-    gst_task_pool_prepare (self->pool, NULL);
-  }
-
-  self->tasks = gst_vec_deque_new (n_threads);
-
-  self->n_threads = n_threads;
-
-  self->n_todo = -1;
-  g_mutex_init (&self->lock);
-
-  /* Set when scheduling a job */
-  self->func = NULL;
-  self->task_data = NULL;
-  self->async_tasks = async_tasks;
-
-  return self;
-}
-
-static void
-gst_parallelized_task_runner_finish (GstParallelizedTaskRunner * self)
-{
-  g_return_if_fail (self->func != NULL);
-
-  gst_parallelized_task_runner_join (self);
-
-  self->func = NULL;
-  self->task_data = NULL;
-}
-
-static void
-gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
-    GstParallelizedTaskFunc func, gpointer * task_data)
-{
-  guint n_threads = self->n_threads;
-
-  self->func = func;
-  self->task_data = task_data;
-
-  if (n_threads > 1 || self->async_tasks) {
-    guint i = 0;
-    g_mutex_lock (&self->lock);
-    self->n_todo = self->n_threads - 1;
-    if (!self->async_tasks) {
-      /* if not async, perform one of the functions in the current thread */
-      self->n_todo--;
-      i = 1;
-    }
-    for (; i < n_threads; i++) {
-      gpointer task =
-          gst_task_pool_push (self->pool, gst_parallelized_task_thread_func,
-          self, NULL);
-
-      /* The return value of push() is nullable but NULL is only returned
-       * with the shared task pool when gst_task_pool_prepare() has not been
-       * called and would thus be a programming error that we should hard-fail
-       * on.
-       */
-      g_assert (task != NULL);
-      gst_vec_deque_push_tail (self->tasks, task);
-    }
-    g_mutex_unlock (&self->lock);
-  }
-
-  if (!self->async_tasks) {
-    self->func (self->task_data[self->n_threads - 1]);
-
-    gst_parallelized_task_runner_finish (self);
-  }
-}
-
 static gboolean
 _negotiated_caps (GstAggregator * agg, GstCaps * caps)
 {
@@ -1468,6 +1387,13 @@ _negotiated_caps (GstAggregator * agg, GstCaps * caps)
   }
 
   GST_OBJECT_LOCK (vagg);
+  /* the last output can't be reused after renegotiation */
+  gst_clear_buffer (&compositor->damage_frame);
+  g_free (compositor->damage_lines);
+  compositor->damage_n_lines = GST_VIDEO_INFO_HEIGHT (&v_info);
+  compositor->damage_lines = g_malloc0 (compositor->damage_n_lines);
+  compositor->damage_reset = TRUE;
+
   for (iter = GST_ELEMENT (vagg)->sinkpads; iter; iter = g_list_next (iter)) {
     GstVideoAggregatorPad *pad = (GstVideoAggregatorPad *) iter->data;
 
@@ -1514,14 +1440,15 @@ _negotiated_caps (GstAggregator * agg, GstCaps * caps)
 
   /* XXX: implement better thread count change */
   if (compositor->blend_runner
-      && compositor->blend_runner->n_threads != n_threads) {
-    gst_parallelized_task_runner_free (compositor->blend_runner);
+      && gst_video_parallel_runner_get_n_threads (compositor->blend_runner) !=
+      n_threads) {
+    gst_video_parallel_runner_free (compositor->blend_runner);
     compositor->blend_runner = NULL;
   }
   if (!compositor->blend_runner) {
     GstTaskPool *pool = gst_video_aggregator_get_execution_task_pool (vagg);
     compositor->blend_runner =
-        gst_parallelized_task_runner_new (n_threads, pool, FALSE);
+        gst_video_parallel_runner_new (n_threads, pool, FALSE);
     gst_clear_object (&pool);
   }
 
@@ -1548,10 +1475,18 @@ static gboolean
 gst_composior_stop (GstAggregator * agg)
 {
   GstCompositor *self = GST_COMPOSITOR (agg);
+  GList *l;
 
   gst_clear_buffer (&self->intermediate_frame);
   g_clear_pointer (&self->intermediate_convert, gst_video_converter_free);
 
+  GST_OBJECT_LOCK (self);
+  gst_clear_buffer (&self->damage_frame);
+  self->damage_reset = TRUE;
+  for (l = GST_ELEMENT (self)->sinkpads; l; l = l->next)
+    gst_clear_buffer (&GST_COMPOSITOR_PAD (l->data)->damage_buffer);
+  GST_OBJECT_UNLOCK (self);
+
   return GST_AGGREGATOR_CLASS (parent_class)->stop (agg);
 }
 
@@ -1611,10 +1546,59 @@ struct CompositeTask
   guint dst_line_start;
   guint dst_line_end;
   gboolean draw_background;
+  /* frame of the first pad, copied instead of blended */
+  GstVideoFrame *copy_frame;
   guint n_pads;
   struct CompositePadInfo *pads_info;
+  /* lines that need compositing, NULL if all do. The other lines are kept */
+  const guint8 *dirty_lines;
+  /* if @n_tiles is not 0, the output is composited in tiles of @tile_height
+   * lines that are taken in turn by all tasks instead of the lines from
+   * @dst_line_start to @dst_line_end */
+  guint tile_height;
+  guint n_tiles;
+  gint *next_tile;
 };
 
+/* Copy the lines @y_start to @y_end of all planes. @y_start must be a
+ * multiple of the vertical subsampling */
+static void
+copy_lines (GstVideoFrame * dest, const GstVideoFrame * src, guint y_start,
+    guint y_end)
+{
+  const GstVideoFormatInfo *info = dest->info.finfo;
+  guint i, plane;
+
+  for (plane = 0; plane < GST_VIDEO_FRAME_N_PLANES (dest); plane++) {
+    gint comp[GST_VIDEO_MAX_COMPONENTS];
+    guint8 *d;
+    const guint8 *s;
+    gint d_stride, s_stride;
+    gsize rowsize;
+    guint yoffset, height;
+
+    gst_video_format_info_component (info, plane, comp);
+    rowsize = GST_VIDEO_FRAME_COMP_WIDTH (dest, comp[0])
+        * GST_VIDEO_FRAME_COMP_PSTRIDE (dest, comp[0]);
+    yoffset = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (info, comp[0], y_start);
+    height = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (info, comp[0], y_end)
+        - yoffset;
+
+    d_stride = GST_VIDEO_FRAME_PLANE_STRIDE (dest, plane);
+    s_stride = GST_VIDEO_FRAME_PLANE_STRIDE (src, plane);
+    d = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (dest, plane)
+        + yoffset * d_stride;
+    s = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA (src, plane)
+        + yoffset * s_stride;
+
+    for (i = 0; i < height; i++) {
+      memcpy (d, s, rowsize);
+      d += d_stride;
+      s += s_stride;
+    }
+  }
+}
+
 static void
 _draw_background (GstCompositor * comp, GstVideoFrame * outframe,
     guint y_start, guint y_end, BlendFunction * composite)
@@ -1675,27 +1659,184 @@ _draw_background (GstCompositor * comp, GstVideoFrame * outframe,
 }
 
 static void
-blend_pads (struct CompositeTask *comp)
+blend_lines (struct CompositeTask *comp, guint y_start, guint y_end)
 {
   BlendFunction composite;
   guint i;
 
   composite = comp->compositor->blend;
 
-  if (comp->draw_background) {
-    _draw_background (comp->compositor, comp->out_frame, comp->dst_line_start,
-        comp->dst_line_end, &composite);
+  if (comp->copy_frame) {
+    copy_lines (comp->out_frame, comp->copy_frame, y_start, y_end);
+  } else if (comp->draw_background) {
+    _draw_background (comp->compositor, comp->out_frame, y_start, y_end,
+        &composite);
   }
 
   for (i = 0; i < comp->n_pads; i++) {
-    composite (comp->pads_info[i].prepared_frame,
-        comp->pads_info[i].pad->xpos + comp->pads_info[i].pad->x_offset,
-        comp->pads_info[i].pad->ypos + comp->pads_info[i].pad->y_offset,
-        comp->pads_info[i].pad->alpha, comp->out_frame, comp->dst_line_start,
-        comp->dst_line_end, comp->pads_info[i].blend_mode);
+    GstVideoFrame *frame = comp->pads_info[i].prepared_frame;
+    GstCompositorPad *pad = comp->pads_info[i].pad;
+    gint ypos = pad->ypos + pad->y_offset;
+
+    /* skip pads that don't overlap these lines */
+    if (ypos >= (gint) y_end
+        || ypos + GST_VIDEO_FRAME_HEIGHT (frame) <= (gint) y_start)
+      continue;
+
+    composite (frame, pad->xpos + pad->x_offset, ypos, pad->alpha,
+        comp->out_frame, y_start, y_end, comp->pads_info[i].blend_mode);
+  }
+}
+
+static void
+composite_lines (struct CompositeTask *comp, guint y_start, guint y_end)
+{
+  guint y, end;
+
+  if (!comp->dirty_lines) {
+    if (y_start < y_end)
+      blend_lines (comp, y_start, y_end);
+    return;
+  }
+
+  /* composite the dirty runs of lines, reuse the others */
+  for (y = y_start; y < y_end; y = end) {
+    guint8 dirty = comp->dirty_lines[y];
+
+    for (end = y + 1; end < y_end; end++) {
+      if (comp->dirty_lines[end] != dirty)
+        break;
+    }
+
+    if (dirty)
+      blend_lines (comp, y, end);
   }
 }
 
+static void
+blend_pads (struct CompositeTask *comp)
+{
+  guint tile, out_height;
+
+  if (comp->n_tiles == 0) {
+    composite_lines (comp, comp->dst_line_start, comp->dst_line_end);
+    return;
+  }
+
+  /* All pads are blended into one tile while it is in the cache. Tiles are
+   * taken one by one so that threads with tiles that overlap fewer pads
+   * take more of them */
+  out_height = GST_VIDEO_FRAME_HEIGHT (comp->out_frame);
+  while ((tile = g_atomic_int_add (comp->next_tile, 1)) < comp->n_tiles) {
+    guint y_start = tile * comp->tile_height;
+
+    composite_lines (comp, y_start,
+        MIN (y_start + comp->tile_height, out_height));
+  }
+}
+
+/* Number of lines of @frame that fit into TILE_SIZE bytes, a multiple of
+ * @align */
+static guint
+get_tile_height (const GstVideoFrame * frame, guint align)
+{
+  const GstVideoFormatInfo *info = frame->info.finfo;
+  gsize line_size = 0;
+  guint plane, height;
+
+  for (plane = 0; plane < GST_VIDEO_FRAME_N_PLANES (frame); plane++) {
+    gint comp[GST_VIDEO_MAX_COMPONENTS];
+
+    gst_video_format_info_component (info, plane, comp);
+    line_size += ABS (GST_VIDEO_FRAME_PLANE_STRIDE (frame, plane))
+        >> GST_VIDEO_FORMAT_INFO_H_SUB (info, comp[0]);
+  }
+
+  height = TILE_SIZE / MAX (line_size, 1);
+
+  return MAX (GST_ROUND_DOWN_N (height, align), align);
+}
+
+/* Whether @a and @b have the same content because they are the same buffer or
+ * wrap the same memory, as when a source repeats its last frame */
+static gboolean
+buffers_equal (GstBuffer * a, GstBuffer * b)
+{
+  guint i, n;
+
+  if (a == b)
+    return TRUE;
+  if (a == NULL || b == NULL)
+    return FALSE;
+
+  n = gst_buffer_n_memory (a);
+  if (n == 0 || n != gst_buffer_n_memory (b))
+    return FALSE;
+
+  for (i = 0; i < n; i++) {
+    if (gst_buffer_peek_memory (a, i) != gst_buffer_peek_memory (b, i))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+static void
+damage_rectangle (GstCompositor * self, const GstVideoRectangle * rect,
+    guint align)
+{
+  guint start, end;
+
+  if (rect->w <= 0 || rect->h <= 0)
+    return;
+
+  start = GST_ROUND_DOWN_N ((guint) rect->y, align);
+  end = MIN (GST_ROUND_UP_N ((guint) (rect->y + rect->h), align),
+      self->damage_n_lines);
+  memset (self->damage_lines + start, 1, end - start);
+}
+
+/* Compares what is composited for @pad now with the last output, marks the
+ * lines that changed and returns FALSE if the pads were added, removed or
+ * reordered. Call this with the lock taken */
+static gboolean
+update_pad_damage (GstCompositor * self, GstVideoAggregatorPad * pad,
+    GstVideoFrame * prepared_frame, guint index, guint align)
+{
+  GstVideoAggregator *vagg = GST_VIDEO_AGGREGATOR (self);
+  GstCompositorPad *cpad = GST_COMPOSITOR_PAD (pad);
+  GstBuffer *buffer = NULL;
+  GstVideoRectangle rect = { 0, };
+  gboolean same_order;
+
+  if (prepared_frame) {
+    buffer = gst_video_aggregator_pad_get_current_buffer (pad);
+    rect = clamp_rectangle (cpad->xpos + cpad->x_offset,
+        cpad->ypos + cpad->y_offset, GST_VIDEO_FRAME_WIDTH (prepared_frame),
+        GST_VIDEO_FRAME_HEIGHT (prepared_frame),
+        GST_VIDEO_INFO_WIDTH (&vagg->info),
+        GST_VIDEO_INFO_HEIGHT (&vagg->info));
+  }
+
+  if (!buffers_equal (cpad->damage_buffer, buffer)
+      || rect.x != cpad->damage_rect.x || rect.y != cpad->damage_rect.y
+      || rect.w != cpad->damage_rect.w || rect.h != cpad->damage_rect.h
+      || cpad->alpha != cpad->damage_alpha || cpad->op != cpad->damage_op) {
+    damage_rectangle (self, &cpad->damage_rect, align);
+    damage_rectangle (self, &rect, align);
+  }
+
+  same_order = cpad->damage_index == index;
+
+  gst_buffer_replace (&cpad->damage_buffer, buffer);
+  cpad->damage_rect = rect;
+  cpad->damage_alpha = cpad->alpha;
+  cpad->damage_op = cpad->op;
+  cpad->damage_index = index;
+
+  return same_order;
+}
+
 static void
 copy_metas (GstCompositor * compositor, GstCompositorPad * cpad,
     GstVideoFrame * in_frame, GstBuffer * out_buffer)
@@ -1740,11 +1881,15 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
 {
   GstCompositor *compositor = GST_COMPOSITOR (vagg);
   GList *l;
-  GstVideoFrame out_frame, intermediate_frame, *outframe;
+  GstVideoFrame out_frame, intermediate_frame, damage_frame, *outframe;
+  GstVideoFrame *copy_frame = NULL;
   gboolean draw_background;
   guint drawn_a_pad = FALSE;
   struct CompositePadInfo *pads_info;
-  guint i, n_pads = 0;
+  guint i, n_pads = 0, n_sinkpads = 0;
+  gboolean damage, full_redraw = TRUE;
+  guint line_align = 1;
+  guint64 n_dirty_lines;
 
   if (!gst_video_frame_map (&out_frame, &vagg->info, outbuf,
           GST_MAP_WRITE | GST_VIDEO_FRAME_MAP_FLAG_NO_REF)) {
@@ -1780,6 +1925,7 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
 
     if (prepared_frame)
       n_pads++;
+    n_sinkpads++;
   }
 
   /* If no prepared frame, we should draw background unconditionally in order
@@ -1787,10 +1933,48 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
   if (n_pads == 0)
     draw_background = TRUE;
 
+  /* lines are composited in groups of the vertical subsampling */
+  for (i = 0; i < GST_VIDEO_FRAME_N_COMPONENTS (outframe); i++) {
+    line_align = MAX (line_align,
+        1 << GST_VIDEO_FORMAT_INFO_H_SUB (outframe->info.finfo, i));
+  }
+
+  damage = compositor->damage_tracking;
+
+  /* Without intermediate frame the output is composited into a frame of our
+   * own and copied into the output buffer afterwards. The unchanged lines
+   * are then still there for the next output, without keeping the output
+   * buffer from going back to its pool. */
+  if (damage && !compositor->intermediate_frame) {
+    if (!compositor->damage_frame) {
+      compositor->damage_frame = gst_buffer_new_and_alloc (vagg->info.size);
+      compositor->damage_reset = TRUE;
+    }
+
+    if (gst_video_frame_map (&damage_frame, &vagg->info,
+            compositor->damage_frame,
+            GST_MAP_READWRITE | GST_VIDEO_FRAME_MAP_FLAG_NO_REF)) {
+      outframe = &damage_frame;
+    } else {
+      GST_WARNING_OBJECT (vagg, "Could not map damage frame");
+      damage = FALSE;
+      compositor->damage_reset = TRUE;
+    }
+  } else {
+    gst_clear_buffer (&compositor->damage_frame);
+  }
+
+  if (damage) {
+    full_redraw = compositor->damage_reset
+        || compositor->damage_n_pads != n_sinkpads
+        || compositor->damage_draw_background != draw_background;
+    memset (compositor->damage_lines, 0, compositor->damage_n_lines);
+  }
+
   pads_info = g_newa (struct CompositePadInfo, n_pads);
   n_pads = 0;
 
-  for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next) {
+  for (l = GST_ELEMENT (vagg)->sinkpads, i = 0; l; l = l->next, i++) {
     GstVideoAggregatorPad *pad = l->data;
     GstCompositorPad *compo_pad = GST_COMPOSITOR_PAD (pad);
     GstVideoFrame *prepared_frame =
@@ -1812,6 +1996,10 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
         break;
     }
 
+    if (damage && !update_pad_damage (compositor, pad, prepared_frame, i,
+            line_align))
+      full_redraw = TRUE;
+
     if (prepared_frame != NULL) {
       /* If this is the first pad we're drawing, and we didn't draw the
        * background, and @prepared_frame has the same format, height, and width
@@ -1819,7 +2007,7 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
        * will be composited on top of it. */
       if (!drawn_a_pad && !draw_background &&
           frames_can_copy (prepared_frame, outframe)) {
-        gst_video_frame_copy (outframe, prepared_frame);
+        copy_frame = prepared_frame;
         copy_metas (compositor, compo_pad, prepared_frame, outbuf);
       } else {
         pads_info[n_pads].pad = compo_pad;
@@ -1831,19 +2019,60 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
     }
   }
 
+  if (damage) {
+    if (full_redraw)
+      memset (compositor->damage_lines, 1, compositor->damage_n_lines);
+
+    compositor->damage_reset = FALSE;
+    compositor->damage_n_pads = n_sinkpads;
+    compositor->damage_draw_background = draw_background;
+
+    n_dirty_lines = 0;
+    for (i = 0; i < compositor->damage_n_lines; i++)
+      n_dirty_lines += compositor->damage_lines[i];
+  } else {
+    n_dirty_lines = GST_VIDEO_FRAME_HEIGHT (outframe);
+  }
+
+  compositor->stats_frames++;
+  if (full_redraw)
+    compositor->stats_full_frames++;
+  compositor->stats_blended_pixels +=
+      n_dirty_lines * GST_VIDEO_FRAME_WIDTH (outframe);
+  compositor->stats_skipped_pixels +=
+      (GST_VIDEO_FRAME_HEIGHT (outframe) - n_dirty_lines) *
+      GST_VIDEO_FRAME_WIDTH (outframe);
+
+  GST_LOG_OBJECT (vagg, "compositing %" G_GUINT64_FORMAT " of %u lines",
+      n_dirty_lines, GST_VIDEO_FRAME_HEIGHT (outframe));
+
   {
     guint n_threads, lines_per_thread;
-    guint out_height;
+    guint out_height, tile_height = 0, n_tiles = 0;
+    gint next_tile = 0;
     struct CompositeTask *tasks;
     struct CompositeTask **tasks_p;
 
-    n_threads = compositor->blend_runner->n_threads;
+    n_threads =
+        gst_video_parallel_runner_get_n_threads (compositor->blend_runner);
 
     tasks = g_newa (struct CompositeTask, n_threads);
     tasks_p = g_newa (struct CompositeTask *, n_threads);
 
     out_height = GST_VIDEO_FRAME_HEIGHT (outframe);
     lines_per_thread = (out_height + n_threads - 1) / n_threads;
+    lines_per_thread = GST_ROUND_UP_N (lines_per_thread, line_align);
+
+    /* With many pads the output would be read and written once per pad, go
+     * over it in tiles instead */
+    if (n_pads > compositor->tile_threshold) {
+      tile_height = get_tile_height (outframe, line_align);
+      n_tiles = (out_height + tile_height - 1) / tile_height;
+      compositor->stats_tiled_frames++;
+
+      GST_LOG_OBJECT (vagg, "compositing %u pads in %u tiles of %u lines",
+          n_pads, n_tiles, tile_height);
+    }
 
     for (i = 0; i < n_threads; i++) {
       tasks[i].compositor = compositor;
@@ -1851,18 +2080,28 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
       tasks[i].pads_info = pads_info;
       tasks[i].out_frame = outframe;
       tasks[i].draw_background = draw_background;
+      tasks[i].copy_frame = copy_frame;
+      tasks[i].dirty_lines = damage ? compositor->damage_lines : NULL;
+      tasks[i].tile_height = tile_height;
+      tasks[i].n_tiles = n_tiles;
+      tasks[i].next_tile = &next_tile;
       /* This is a dumb split of the work by number of output lines.
        * If there is a section of the output that reads from a lot of source
        * pads, then that thread will consume more time. Maybe tracking and
        * splitting on the source fill rate would produce better results. */
-      tasks[i].dst_line_start = i * lines_per_thread;
+      tasks[i].dst_line_start = MIN (i * lines_per_thread, out_height);
       tasks[i].dst_line_end = MIN ((i + 1) * lines_per_thread, out_height);
 
       tasks_p[i] = &tasks[i];
     }
 
-    gst_parallelized_task_runner_run (compositor->blend_runner,
-        (GstParallelizedTaskFunc) blend_pads, (gpointer *) tasks_p);
+    gst_video_parallel_runner_run (compositor->blend_runner,
+        (GstVideoParallelFunc) blend_pads, (gpointer *) tasks_p);
+  }
+
+  if (outframe == &damage_frame) {
+    gst_video_frame_copy (&out_frame, &damage_frame);
+    gst_video_frame_unmap (&damage_frame);
   }
 
   GST_OBJECT_UNLOCK (vagg);
@@ -2065,10 +2304,20 @@ gst_compositor_finalize (GObject * object)
 {
   GstCompositor *compositor = GST_COMPOSITOR (object);
 
-  if (compositor->blend_runner)
-    gst_parallelized_task_runner_free (compositor->blend_runner);
+  if (compositor->blend_runner) {
+    GstStructure *stats =
+        gst_video_parallel_runner_get_stats (compositor->blend_runner);
+
+    /* how evenly the line based split spread the blending work */
+    GST_DEBUG_OBJECT (compositor, "blend stats: %" GST_PTR_FORMAT, stats);
+    gst_structure_free (stats);
+    gst_video_parallel_runner_free (compositor->blend_runner);
+  }
   compositor->blend_runner = NULL;
 
+  gst_clear_buffer (&compositor->damage_frame);
+  g_free (compositor->damage_lines);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -2164,6 +2413,70 @@ gst_compositor_class_init (GstCompositorClass * klass)
           "Avoid timing out waiting for inactive pads", FALSE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * compositor:damage-tracking:
+   *
+   * Only composite the lines of the output again that are touched by a pad
+   * whose input buffer, position, size, alpha or operator changed since the
+   * last output, and keep all other lines from the last output. An input
+   * buffer is considered unchanged if it is the same buffer or wraps the same
+   * memory as the last one, as for example when a source repeats its last
+   * frame or with imagefreeze.
+   *
+   * Unless an intermediate frame is needed for the output format, the output
+   * is composited into a frame of the compositor and copied into every output
+   * buffer, so that no reference to an output buffer is kept. This keeps a
+   * reference to the last buffer of each pad. Adding, removing or reordering
+   * pads, renegotiation and changing the background redraw the whole output.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_DAMAGE_TRACKING,
+      g_param_spec_boolean ("damage-tracking", "Damage tracking",
+          "Only composite the parts of the output that changed",
+          DEFAULT_DAMAGE_TRACKING,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * compositor:stats:
+   *
+   * Various #GstCompositor statistics. This property returns a #GstStructure
+   * with name `application/x-compositor-stats` with the following fields:
+   *
+   * - "frames" G_TYPE_UINT64: number of composited output frames
+   * - "full-frames" G_TYPE_UINT64: output frames that were composited
+   *   completely
+   * - "tiled-frames" G_TYPE_UINT64: output frames that were composited in
+   *   tiles, see #GstCompositor:tile-threshold
+   * - "blended-pixels" G_TYPE_UINT64: output pixels that were composited
+   * - "skipped-pixels" G_TYPE_UINT64: output pixels that were kept from the
+   *   last output because of #GstCompositor:damage-tracking
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Compositor Statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * compositor:tile-threshold:
+   *
+   * Number of blended pads above which the output is composited in tiles of
+   * a few lines that fit into the cache. All pads are blended into one tile
+   * before moving on to the next one, instead of going over the whole output
+   * once per pad, and the worker threads take the tiles in turn.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_TILE_THRESHOLD,
+      g_param_spec_uint ("tile-threshold", "Tile threshold",
+          "Composite in tiles when more than this number of pads are blended",
+          0, G_MAXUINT, DEFAULT_TILE_THRESHOLD,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
   gst_type_mark_as_plugin_api (GST_TYPE_COMPOSITOR_PAD, 0);
   gst_type_mark_as_plugin_api (GST_TYPE_COMPOSITOR_OPERATOR, 0);
   gst_type_mark_as_plugin_api (GST_TYPE_COMPOSITOR_BACKGROUND, 0);
@@ -2178,6 +2491,9 @@ gst_compositor_init (GstCompositor * self)
   self->background = DEFAULT_BACKGROUND;
   self->zero_size_is_unscaled = DEFAULT_ZERO_SIZE_IS_UNSCALED;
   self->max_threads = DEFAULT_MAX_THREADS;
+  self->damage_tracking = DEFAULT_DAMAGE_TRACKING;
+  self->damage_reset = TRUE;
+  self->tile_threshold = DEFAULT_TILE_THRESHOLD;
 }
 
 /* GstChildProxy implementation */
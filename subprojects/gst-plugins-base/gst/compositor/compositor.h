@@ -94,28 +94,6 @@ typedef enum
   COMPOSITOR_SIZING_POLICY_KEEP_ASPECT_RATIO,
 } GstCompositorSizingPolicy;
 
-/* copied from video-converter.c */
-typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
-
-typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
-
-struct _GstParallelizedTaskRunner
-{
-  GstTaskPool *pool;
-  gboolean own_pool;
-  guint n_threads;
-
-  GstVecDeque *tasks;
-
-  GstParallelizedTaskFunc func;
-  gpointer *task_data;
-
-  GMutex lock;
-  gint n_todo;
-
-  gboolean async_tasks;
-};
-
 /**
  * GstCompositor:
  *
@@ -153,7 +131,25 @@ struct _GstCompositor
   GstVideoInfo intermediate_info;
   GstVideoConverter *intermediate_convert;
 
-  GstParallelizedTaskRunner *blend_runner;
+  GstVideoParallelRunner *blend_runner;
+  /* composite in tiles with more blended pads than this */
+  guint tile_threshold;
+
+  /* damage tracking: the frame the output is composited into when there is
+   * no intermediate frame, which lines need to be composited again and how
+   * many pixels could be kept from the last output */
+  gboolean damage_tracking;
+  gboolean damage_reset;
+  gboolean damage_draw_background;
+  guint damage_n_pads;
+  GstBuffer *damage_frame;
+  guint8 *damage_lines;
+  guint damage_n_lines;
+  guint64 stats_frames;
+  guint64 stats_full_frames;
+  guint64 stats_tiled_frames;
+  guint64 stats_blended_pixels;
+  guint64 stats_skipped_pixels;
 };
 
 /**
@@ -177,6 +173,13 @@ struct _GstCompositorPad
    * keep-aspect-ratio */
   gint x_offset;
   gint y_offset;
+
+  /* what was composited for this pad into the last output */
+  GstBuffer *damage_buffer;
+  GstVideoRectangle damage_rect;
+  gdouble damage_alpha;
+  GstCompositorOperator damage_op;
+  guint damage_index;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (compositor);
@@ -873,10 +873,9 @@ gst_video_convert_scale_create_converter (GstVideoConvertScale * self,
   if (priv->task_pool) {
     pool = gst_object_ref (priv->task_pool);
 
-    if (GST_IS_SHARED_TASK_POOL (pool)
+    if (gst_video_parallel_get_max_threads (pool) > 0
         && (!priv->n_threads_set || priv->n_threads == 0)) {
-      gint n_threads =
-          gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool));
+      gint n_threads = gst_video_parallel_get_max_threads (pool);
       gst_structure_set (config, GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT,
           n_threads, NULL);
 
@@ -2253,6 +2253,83 @@ GST_START_TEST (test_qos_message_live)
 
 GST_END_TEST;
 
+static guint64
+get_aggregate_calls (GstElement * element)
+{
+  GstStructure *stats;
+  guint64 calls = 0;
+
+  g_object_get (element, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "aggregate-calls", &calls));
+  gst_structure_free (stats);
+
+  return calls;
+}
+
+/* pushes 40ms of data and EOS and returns the number of aggregate calls
+ * needed for the four output buffers and the EOS */
+static guint64
+run_batch (gboolean live)
+{
+  static const char *caps_str =
+      "audio/x-raw, format=(string)" GST_AUDIO_NE (S16) ", "
+      "rate=(int)1000, channels=(int)1, layout=(string)interleaved";
+  GstHarness *h;
+  GstBuffer *b;
+  GstEvent *e;
+  guint64 calls;
+  gboolean eos = FALSE;
+  gint i;
+
+  h = gst_harness_new_with_padnames ("audiomixer", "sink_0", "src");
+  /* the latency keeps the live mixer from timing out before the data is
+   * there, the test clock does not move */
+  g_object_set (h->element, "output-buffer-duration", 10 * GST_MSECOND,
+      "batch-size", 4, "latency", live ? GST_SECOND : 0, NULL);
+  gst_harness_set_live (h, live);
+  gst_harness_set_caps_str (h, caps_str, caps_str);
+
+  fail_unless_equals_int (gst_harness_push (h, new_buffer (80, 0, 0,
+              40 * GST_MSECOND, 0)), GST_FLOW_OK);
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  for (i = 0; i < 4; i++) {
+    b = gst_harness_pull (h);
+    fail_unless_equals_int64 (GST_BUFFER_PTS (b), i * 10 * GST_MSECOND);
+    fail_unless_equals_int64 (GST_BUFFER_DURATION (b), 10 * GST_MSECOND);
+    gst_buffer_unref (b);
+  }
+
+  /* the stats are updated after the aggregate call, wait for the last one */
+  while (!eos) {
+    e = gst_harness_pull_event (h);
+    fail_unless (e != NULL);
+    eos = GST_EVENT_TYPE (e) == GST_EVENT_EOS;
+    gst_event_unref (e);
+  }
+
+  calls = get_aggregate_calls (h->element);
+  gst_harness_teardown (h);
+
+  return calls;
+}
+
+GST_START_TEST (test_batch_size)
+{
+  /* all output buffers from one call and one for EOS */
+  fail_unless_equals_uint64 (run_batch (FALSE), 2);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_batch_size_live)
+{
+  /* live and not behind the clock, one output buffer per call */
+  fail_unless_equals_uint64 (run_batch (TRUE), 5);
+}
+
+GST_END_TEST;
+
 static Suite *
 audiomixer_suite (void)
 {
@@ -2282,6 +2359,8 @@ audiomixer_suite (void)
   tcase_add_test (tc_chain, test_segment_base_handling);
   tcase_add_test (tc_chain, test_sinkpad_property_controller);
   tcase_add_test (tc_chain, test_qos_message_live);
+  tcase_add_test (tc_chain, test_batch_size);
+  tcase_add_test (tc_chain, test_batch_size_live);
   tcase_add_checked_fixture (tc_chain, test_setup, test_teardown);
   tcase_add_test (tc_chain, test_change_output_caps);
   tcase_add_test (tc_chain, test_change_output_caps_mid_output_buffer);
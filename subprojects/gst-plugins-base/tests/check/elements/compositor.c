@@ -2431,6 +2431,235 @@ GST_START_TEST (test_gap_events)
 
 GST_END_TEST;
 
+static GstBuffer *
+create_damage_buffer (guint8 value, GstClockTime pts, GstClockTime duration)
+{
+  GstBuffer *buf = gst_buffer_new_allocate (NULL, 4 * 4 * 4, NULL);
+  GstMapInfo info;
+  guint i;
+
+  gst_buffer_map (buf, &info, GST_MAP_WRITE);
+  for (i = 0; i < info.size; i += 4) {
+    memset (info.data + i, value, 3);
+    info.data[i + 3] = 255;
+  }
+  gst_buffer_unmap (buf, &info);
+
+  GST_BUFFER_PTS (buf) = pts;
+  GST_BUFFER_DURATION (buf) = duration;
+
+  return buf;
+}
+
+static void
+check_damage_output (GstHarness * h, guint8 value)
+{
+  GstBuffer *buf;
+  GstMapInfo info;
+
+  buf = gst_harness_pull (h);
+  fail_unless (buf != NULL);
+  /* compositor keeps no reference to its output */
+  fail_unless (gst_buffer_is_writable (buf));
+  gst_buffer_map (buf, &info, GST_MAP_READ);
+  /* black background, the pad at 4x4 */
+  fail_unless_equals_int (info.data[0], 0);
+  fail_unless_equals_int (info.data[(4 * 8 + 4) * 4], value);
+  fail_unless_equals_int (info.data[(7 * 8 + 7) * 4], value);
+  gst_buffer_unmap (buf, &info);
+  gst_buffer_unref (buf);
+}
+
+GST_START_TEST (test_damage_tracking)
+{
+  GstElement *comp = gst_element_factory_make ("compositor", NULL);
+  GstHarness *h = gst_harness_new_with_element (comp, "sink_%u", "src");
+  GstBuffer *buf, *repeat;
+  GstStructure *stats;
+  GstPad *pad;
+  guint64 val;
+
+  g_object_set (comp, "background", 1, "damage-tracking", TRUE, NULL);
+
+  pad = gst_element_get_static_pad (comp, "sink_0");
+  g_object_set (pad, "xpos", 4, "ypos", 4, NULL);
+  gst_object_unref (pad);
+
+  gst_harness_set_sink_caps_str (h,
+      "video/x-raw, format=RGBA, width=8, height=8, framerate=25/1");
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw, format=RGBA, width=4, height=4, framerate=25/1");
+
+  gst_harness_play (h);
+
+  /* a repeated frame wrapping the same memory is not composited again */
+  buf = create_damage_buffer (42, 0, 40 * GST_MSECOND);
+  repeat = gst_buffer_copy (buf);
+  GST_BUFFER_PTS (repeat) = 40 * GST_MSECOND;
+  gst_harness_push (h, buf);
+  check_damage_output (h, 42);
+  gst_harness_push (h, repeat);
+  check_damage_output (h, 42);
+
+  /* only the lines of the pad change */
+  gst_harness_push (h, create_damage_buffer (84, 80 * GST_MSECOND,
+          40 * GST_MSECOND));
+  check_damage_output (h, 84);
+
+  g_object_get (comp, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "frames", &val));
+  fail_unless_equals_uint64 (val, 3);
+  fail_unless (gst_structure_get_uint64 (stats, "full-frames", &val));
+  fail_unless_equals_uint64 (val, 1);
+  fail_unless (gst_structure_get_uint64 (stats, "blended-pixels", &val));
+  fail_unless_equals_uint64 (val, 8 * 8 + 4 * 8);
+  fail_unless (gst_structure_get_uint64 (stats, "skipped-pixels", &val));
+  fail_unless_equals_uint64 (val, 8 * 8 + 4 * 8);
+  gst_structure_free (stats);
+
+  gst_harness_teardown (h);
+  gst_object_unref (comp);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_tiled_compositing)
+{
+  GstElement *comp = gst_element_factory_make ("compositor", NULL);
+  GstHarness *h = gst_harness_new_with_element (comp, "sink_%u", "src");
+  GstStructure *stats;
+  GstPad *pad;
+  guint64 val;
+
+  /* tile with any number of pads */
+  g_object_set (comp, "background", 1, "tile-threshold", 0, NULL);
+
+  pad = gst_element_get_static_pad (comp, "sink_0");
+  g_object_set (pad, "xpos", 4, "ypos", 4, NULL);
+  gst_object_unref (pad);
+
+  gst_harness_set_sink_caps_str (h,
+      "video/x-raw, format=RGBA, width=8, height=8, framerate=25/1");
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw, format=RGBA, width=4, height=4, framerate=25/1");
+
+  gst_harness_play (h);
+
+  gst_harness_push (h, create_damage_buffer (42, 0, 40 * GST_MSECOND));
+  check_damage_output (h, 42);
+
+  g_object_get (comp, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "tiled-frames", &val));
+  fail_unless_equals_uint64 (val, 1);
+  gst_structure_free (stats);
+
+  gst_harness_teardown (h);
+  gst_object_unref (comp);
+}
+
+GST_END_TEST;
+
+static void
+handoff_keep_buffer_cb (GstElement * fakesink, GstBuffer * buffer,
+    GstPad * pad, GstBuffer ** out)
+{
+  gst_buffer_replace (out, buffer);
+}
+
+/* Composites one frame of 16 overlapping translucent pads into a 1080p I420
+ * output with several threads and returns it. Sizes and positions are odd
+ * so that the tiles cut through the pads and their chroma. */
+static GstBuffer *
+composite_many_pads (guint tile_threshold, guint64 * tiled_frames)
+{
+  static const gchar *patterns[] = {
+    "smpte", "checkers-1", "checkers-8", "circular", "zone-plate", "gamut",
+    "colors", "smpte100", "bar", "pinwheel", "spokes", "gradient", "red",
+    "checkers-4", "smpte75", "blue"
+  };
+  GstElement *bin, *comp, *sink;
+  GstBuffer *buf = NULL;
+  GstStructure *stats;
+  GString *desc;
+  GstMessage *msg;
+  GstBus *bus;
+  GError *err = NULL;
+  guint i;
+
+  desc = g_string_new (NULL);
+  g_string_append_printf (desc, "compositor name=c background=black "
+      "max-threads=4 tile-threshold=%u", tile_threshold);
+  for (i = 0; i < G_N_ELEMENTS (patterns); i++) {
+    g_string_append_printf (desc, " sink_%u::xpos=%d sink_%u::ypos=%d "
+        "sink_%u::alpha=0.6", i, (gint) (i % 4) * 431 - 41, i,
+        (gint) (i / 4) * 253 - 17, i);
+  }
+  g_string_append (desc, " ! video/x-raw,format=I420,width=1920,height=1080"
+      " ! fakesink name=sink signal-handoffs=true");
+  for (i = 0; i < G_N_ELEMENTS (patterns); i++) {
+    g_string_append_printf (desc, " videotestsrc num-buffers=1 pattern=%s"
+        " ! video/x-raw,format=I420,width=%u,height=%u ! c.sink_%u",
+        patterns[i], 517 + 2 * i, 301 + 3 * i, i);
+  }
+
+  bin = gst_parse_launch (desc->str, &err);
+  fail_unless (bin != NULL, "Error parsing pipeline: %s",
+      err ? err->message : "(invalid error)");
+  g_string_free (desc, TRUE);
+
+  sink = gst_bin_get_by_name (GST_BIN (bin), "sink");
+  g_signal_connect (sink, "handoff", (GCallback) handoff_keep_buffer_cb, &buf);
+  gst_object_unref (sink);
+
+  bus = gst_element_get_bus (bin);
+  fail_if (gst_element_set_state (bin,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  comp = gst_bin_get_by_name (GST_BIN (bin), "c");
+  g_object_get (comp, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "tiled-frames",
+          tiled_frames));
+  gst_structure_free (stats);
+  gst_object_unref (comp);
+
+  gst_element_set_state (bin, GST_STATE_NULL);
+  gst_object_unref (bin);
+
+  fail_unless (buf != NULL);
+
+  return buf;
+}
+
+/* tiles must give exactly the same output as compositing pad by pad */
+GST_START_TEST (test_tiled_compositing_many_pads)
+{
+  GstBuffer *tiled, *untiled;
+  guint64 tiled_frames;
+  GstMapInfo map1, map2;
+
+  tiled = composite_many_pads (0, &tiled_frames);
+  fail_unless_equals_uint64 (tiled_frames, 1);
+  untiled = composite_many_pads (G_MAXUINT, &tiled_frames);
+  fail_unless_equals_uint64 (tiled_frames, 0);
+
+  gst_buffer_map (tiled, &map1, GST_MAP_READ);
+  gst_buffer_map (untiled, &map2, GST_MAP_READ);
+  fail_unless_equals_int (map1.size, map2.size);
+  fail_unless (memcmp (map1.data, map2.data, map1.size) == 0);
+  gst_buffer_unmap (untiled, &map2);
+  gst_buffer_unmap (tiled, &map1);
+
+  gst_buffer_unref (untiled);
+  gst_buffer_unref (tiled);
+}
+
+GST_END_TEST;
+
 static GstBuffer *expected_selected_buffer = NULL;
 
 static void
@@ -2969,6 +3198,9 @@ compositor_suite (void)
   tcase_add_test (tc_chain, test_start_time_first_live_drop_3);
   tcase_add_test (tc_chain, test_start_time_first_live_drop_3_unlinked_1);
   tcase_add_test (tc_chain, test_gap_events);
+  tcase_add_test (tc_chain, test_damage_tracking);
+  tcase_add_test (tc_chain, test_tiled_compositing);
+  tcase_add_test (tc_chain, test_tiled_compositing_many_pads);
   tcase_add_test (tc_chain, test_signals);
   tcase_add_test (tc_chain, test_reverse);
   tcase_add_test (tc_chain, test_stream_start_after_eos);
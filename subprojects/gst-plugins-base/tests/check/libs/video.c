@@ -34,6 +34,7 @@
 #include <gst/video/video.h>
 #include <gst/video/gstvideometa.h>
 #include <gst/video/video-overlay-composition.h>
+#include <gst/video/video-converter-fused-private.h>
 #include <string.h>
 
 /* These are from the current/old videotestsrc; we check our new public API
@@ -3037,6 +3038,418 @@ GST_END_TEST;
 #undef WIDTH
 #undef HEIGHT
 
+static void
+video_frame_comp_fill (GstVideoFrame * frame, gint comp, guint8 val)
+{
+  guint8 *data = GST_VIDEO_FRAME_COMP_DATA (frame, comp);
+  gint stride = GST_VIDEO_FRAME_COMP_STRIDE (frame, comp);
+  gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, comp);
+  gint x, y;
+
+  for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (frame, comp); y++)
+    for (x = 0; x < GST_VIDEO_FRAME_COMP_WIDTH (frame, comp); x++)
+      data[y * stride + x * pstride] = val;
+}
+
+static gboolean
+video_frame_comp_check (GstVideoFrame * frame, gint comp, guint8 val)
+{
+  guint8 *data = GST_VIDEO_FRAME_COMP_DATA (frame, comp);
+  gint stride = GST_VIDEO_FRAME_COMP_STRIDE (frame, comp);
+  gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, comp);
+  gint x, y;
+
+  for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (frame, comp); y++)
+    for (x = 0; x < GST_VIDEO_FRAME_COMP_WIDTH (frame, comp); x++)
+      if (data[y * stride + x * pstride] != val)
+        return FALSE;
+
+  return TRUE;
+}
+
+#undef WIDTH_IN
+#undef HEIGHT_IN
+#undef WIDTH_OUT
+#undef HEIGHT_OUT
+#undef TIME
+#define WIDTH_IN 1920
+#define HEIGHT_IN 1080
+#define WIDTH_OUT 1280
+#define HEIGHT_OUT 720
+#define TIME 0.01
+
+/* the format pairs of the fused convert and scale fastpath, set TIME to
+ * something larger to benchmark them */
+GST_START_TEST (test_video_convert_fused_scale)
+{
+  static const struct
+  {
+    GstVideoFormat infmt, outfmt;
+  } pairs[] = {
+    {GST_VIDEO_FORMAT_YUY2, GST_VIDEO_FORMAT_I420},
+    {GST_VIDEO_FORMAT_YUY2, GST_VIDEO_FORMAT_NV12},
+    {GST_VIDEO_FORMAT_UYVY, GST_VIDEO_FORMAT_I420},
+    {GST_VIDEO_FORMAT_UYVY, GST_VIDEO_FORMAT_NV12},
+    {GST_VIDEO_FORMAT_YVYU, GST_VIDEO_FORMAT_I420},
+    {GST_VIDEO_FORMAT_YVYU, GST_VIDEO_FORMAT_NV12},
+    {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420},
+    {GST_VIDEO_FORMAT_NV21, GST_VIDEO_FORMAT_I420},
+    {GST_VIDEO_FORMAT_NV21, GST_VIDEO_FORMAT_NV12},
+    {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12},
+    {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV12},
+  };
+  static const guint8 values[] = { 0x40, 0x60, 0xa0 };
+  GTimer *timer;
+  gint i, comp, method;
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < G_N_ELEMENTS (pairs); i++) {
+    GstVideoInfo ininfo, outinfo;
+    GstVideoFrame inframe, outframe;
+    GstBuffer *inbuffer, *outbuffer;
+    GstVideoConverter *convert;
+    gdouble elapsed;
+    gint count;
+
+    fail_unless (gst_video_info_set_format (&ininfo, pairs[i].infmt,
+            WIDTH_IN, HEIGHT_IN));
+    inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+    gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_WRITE);
+    for (comp = 0; comp < 3; comp++)
+      video_frame_comp_fill (&inframe, comp, values[comp]);
+
+    fail_unless (gst_video_info_set_format (&outinfo, pairs[i].outfmt,
+            WIDTH_OUT, HEIGHT_OUT));
+    outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+    gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+    for (method = GST_VIDEO_RESAMPLER_METHOD_LINEAR;
+        method <= GST_VIDEO_RESAMPLER_METHOD_CUBIC; method++) {
+      convert = gst_video_converter_new (&ininfo, &outinfo,
+          gst_structure_new ("options",
+              GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+              GST_TYPE_VIDEO_RESAMPLER_METHOD, method, NULL));
+      fail_unless (gst_video_converter_uses_fused_scale (convert),
+          "%s -> %s not fused",
+          gst_video_format_to_string (pairs[i].infmt),
+          gst_video_format_to_string (pairs[i].outfmt));
+
+      /* a flat input gives the same flat output */
+      gst_buffer_memset (outbuffer, 0, 0, -1);
+      gst_video_converter_frame (convert, &inframe, &outframe);
+      for (comp = 0; comp < 3; comp++)
+        fail_unless (video_frame_comp_check (&outframe, comp, values[comp]));
+
+      count = 0;
+      g_timer_start (timer);
+      while (TRUE) {
+        gst_video_converter_frame (convert, &inframe, &outframe);
+
+        count++;
+        elapsed = g_timer_elapsed (timer, NULL);
+        if (elapsed >= TIME)
+          break;
+      }
+
+      GST_DEBUG ("%f Mpixels/sec %s->%s, %d, %d/%f",
+          count * WIDTH_OUT * HEIGHT_OUT / elapsed / 1000000.0,
+          gst_video_format_to_string (pairs[i].infmt),
+          gst_video_format_to_string (pairs[i].outfmt), method, count,
+          elapsed);
+
+      gst_video_converter_free (convert);
+    }
+    gst_video_frame_unmap (&outframe);
+    gst_buffer_unref (outbuffer);
+    gst_video_frame_unmap (&inframe);
+    gst_buffer_unref (inbuffer);
+  }
+
+  g_timer_destroy (timer);
+}
+
+GST_END_TEST;
+#undef WIDTH_IN
+#undef HEIGHT_IN
+#undef WIDTH_OUT
+#undef HEIGHT_OUT
+#undef TIME
+
+static GstStructure *
+plan_cache_config (void)
+{
+  return gst_structure_new ("options",
+      GST_VIDEO_CONVERTER_OPT_GAMMA_MODE, GST_TYPE_VIDEO_GAMMA_MODE,
+      GST_VIDEO_GAMMA_MODE_REMAP, NULL);
+}
+
+static GstBuffer *
+plan_cache_convert (GstVideoConverter * convert, GstVideoFrame * inframe,
+    GstVideoInfo * outinfo)
+{
+  GstVideoFrame outframe;
+  GstBuffer *outbuffer;
+
+  outbuffer = gst_buffer_new_and_alloc (outinfo->size);
+  gst_buffer_memset (outbuffer, 0, 0, -1);
+  gst_video_frame_map (&outframe, outinfo, outbuffer, GST_MAP_WRITE);
+  gst_video_converter_frame (convert, inframe, &outframe);
+  gst_video_frame_unmap (&outframe);
+
+  return outbuffer;
+}
+
+static void
+plan_cache_compare (GstBuffer * ref, GstBuffer * buffer)
+{
+  GstMapInfo info;
+
+  gst_buffer_map (buffer, &info, GST_MAP_READ);
+  fail_unless (gst_buffer_memcmp (ref, 0, info.data, info.size) == 0);
+  gst_buffer_unmap (buffer, &info);
+  gst_buffer_unref (buffer);
+}
+
+/* converters with the same configuration share their tables, check that
+ * converters made from a shared plan convert exactly like the first one */
+GST_START_TEST (test_video_convert_plan_cache)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe;
+  GstBuffer *inbuffer, *ref;
+  GstVideoConverter *convert1, *convert2;
+  GstMapInfo info;
+  gsize i;
+
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_I420, 320,
+          240));
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_map (inbuffer, &info, GST_MAP_WRITE);
+  for (i = 0; i < info.size; i++)
+    info.data[i] = i * 7;
+  gst_buffer_unmap (inbuffer, &info);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  fail_unless (gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_ARGB, 400,
+          300));
+  outinfo.colorimetry.transfer = GST_VIDEO_TRANSFER_GAMMA22;
+
+  convert1 = gst_video_converter_new (&ininfo, &outinfo, plan_cache_config ());
+  ref = plan_cache_convert (convert1, &inframe, &outinfo);
+
+  /* shared while the first converter is alive */
+  convert2 = gst_video_converter_new (&ininfo, &outinfo, plan_cache_config ());
+  plan_cache_compare (ref, plan_cache_convert (convert2, &inframe, &outinfo));
+  gst_video_converter_free (convert1);
+  plan_cache_compare (ref, plan_cache_convert (convert2, &inframe, &outinfo));
+  gst_video_converter_free (convert2);
+
+  /* and after all converters of the plan are gone */
+  convert1 = gst_video_converter_new (&ininfo, &outinfo, plan_cache_config ());
+  plan_cache_compare (ref, plan_cache_convert (convert1, &inframe, &outinfo));
+  gst_video_converter_free (convert1);
+  gst_buffer_unref (ref);
+
+  /* the same for the fused convert and scale fastpath */
+  fail_unless (gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_NV12, 200,
+          150));
+  convert1 = gst_video_converter_new (&ininfo, &outinfo, NULL);
+  ref = plan_cache_convert (convert1, &inframe, &outinfo);
+  gst_video_converter_free (convert1);
+  convert1 = gst_video_converter_new (&ininfo, &outinfo, NULL);
+  plan_cache_compare (ref, plan_cache_convert (convert1, &inframe, &outinfo));
+  gst_video_converter_free (convert1);
+  gst_buffer_unref (ref);
+
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+/* a gradient over the whole frame, in the same direction for all
+ * subsamplings */
+static void
+video_frame_comp_fill_gradient (GstVideoFrame * frame, gint comp, gint base,
+    gint dx, gint dy)
+{
+  guint8 *data = GST_VIDEO_FRAME_COMP_DATA (frame, comp);
+  gint stride = GST_VIDEO_FRAME_COMP_STRIDE (frame, comp);
+  gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, comp);
+  gint width = GST_VIDEO_FRAME_COMP_WIDTH (frame, comp);
+  gint height = GST_VIDEO_FRAME_COMP_HEIGHT (frame, comp);
+  gint x, y;
+
+  for (y = 0; y < height; y++)
+    for (x = 0; x < width; x++)
+      data[y * stride + x * pstride] = base + dx * x / width + dy * y / height;
+}
+
+static gint
+video_frame_comp_max_diff (GstVideoFrame * frame1, GstVideoFrame * frame2,
+    gint comp)
+{
+  guint8 *data1 = GST_VIDEO_FRAME_COMP_DATA (frame1, comp);
+  guint8 *data2 = GST_VIDEO_FRAME_COMP_DATA (frame2, comp);
+  gint stride1 = GST_VIDEO_FRAME_COMP_STRIDE (frame1, comp);
+  gint stride2 = GST_VIDEO_FRAME_COMP_STRIDE (frame2, comp);
+  gint pstride1 = GST_VIDEO_FRAME_COMP_PSTRIDE (frame1, comp);
+  gint pstride2 = GST_VIDEO_FRAME_COMP_PSTRIDE (frame2, comp);
+  gint x, y, diff = 0;
+
+  fail_unless_equals_int (GST_VIDEO_FRAME_COMP_WIDTH (frame1, comp),
+      GST_VIDEO_FRAME_COMP_WIDTH (frame2, comp));
+  fail_unless_equals_int (GST_VIDEO_FRAME_COMP_HEIGHT (frame1, comp),
+      GST_VIDEO_FRAME_COMP_HEIGHT (frame2, comp));
+
+  for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (frame1, comp); y++)
+    for (x = 0; x < GST_VIDEO_FRAME_COMP_WIDTH (frame1, comp); x++)
+      diff = MAX (diff, ABS (data1[y * stride1 + x * pstride1] -
+              data2[y * stride2 + x * pstride2]));
+
+  return diff;
+}
+
+/* The fused fastpath is compared against the generic path, which is used
+ * for the same conversion to NV21, or to YV12 for NV21 input. These have
+ * the same subsampling and chroma siting. The fused path resamples the
+ * subsampled chroma directly instead of upsampling, scaling and
+ * downsampling it, and does not take the chroma siting into account, so the
+ * results differ slightly. A smooth gradient keeps that difference small. */
+#define FUSED_SCALE_TOLERANCE 3
+
+GST_START_TEST (test_video_convert_fused_scale_generic)
+{
+  static const struct
+  {
+    GstVideoFormat infmt, outfmt;
+  } pairs[] = {
+    {GST_VIDEO_FORMAT_YUY2, GST_VIDEO_FORMAT_I420},
+    {GST_VIDEO_FORMAT_YUY2, GST_VIDEO_FORMAT_NV12},
+    {GST_VIDEO_FORMAT_UYVY, GST_VIDEO_FORMAT_I420},
+    {GST_VIDEO_FORMAT_UYVY, GST_VIDEO_FORMAT_NV12},
+    {GST_VIDEO_FORMAT_YVYU, GST_VIDEO_FORMAT_I420},
+    {GST_VIDEO_FORMAT_YVYU, GST_VIDEO_FORMAT_NV12},
+    {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420},
+    {GST_VIDEO_FORMAT_NV21, GST_VIDEO_FORMAT_I420},
+    {GST_VIDEO_FORMAT_NV21, GST_VIDEO_FORMAT_NV12},
+    {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12},
+    {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV12},
+  };
+  /* input and output size, crop of the input and place in the output, a
+   * width of 0 means the whole frame */
+  static const struct
+  {
+    gint in_width, in_height, out_width, out_height;
+    gint src_x, src_y, src_width, src_height;
+    gint dest_x, dest_y, dest_width, dest_height;
+  } sizes[] = {
+    {320, 240, 212, 120, 0, 0, 0, 0, 0, 0, 0, 0},
+    {321, 243, 163, 97, 0, 0, 0, 0, 0, 0, 0, 0},
+    {160, 120, 333, 251, 0, 0, 0, 0, 0, 0, 0, 0},
+    {64, 48, 1000, 16, 0, 0, 0, 0, 0, 0, 0, 0},
+    {320, 240, 320, 240, 16, 8, 241, 181, 10, 6, 251, 151},
+    {99, 75, 202, 154, 2, 4, 95, 67, 4, 2, 195, 149},
+  };
+  static const gint gradients[3][3] = {
+    {32, 64, 48}, {64, 48, 32}, {128, 32, 48}
+  };
+  gint i, j, comp, method;
+
+  for (i = 0; i < G_N_ELEMENTS (pairs); i++) {
+    for (j = 0; j < G_N_ELEMENTS (sizes); j++) {
+      GstVideoInfo ininfo, outinfo, refinfo;
+      GstVideoFrame inframe, outframe, refframe;
+      GstBuffer *inbuffer, *outbuffer, *refbuffer;
+      GstVideoFormat reffmt;
+
+      fail_unless (gst_video_info_set_format (&ininfo, pairs[i].infmt,
+              sizes[j].in_width, sizes[j].in_height));
+      inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+      gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_WRITE);
+      for (comp = 0; comp < 3; comp++)
+        video_frame_comp_fill_gradient (&inframe, comp, gradients[comp][0],
+            gradients[comp][1], gradients[comp][2]);
+
+      fail_unless (gst_video_info_set_format (&outinfo, pairs[i].outfmt,
+              sizes[j].out_width, sizes[j].out_height));
+      outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+      gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+      if (pairs[i].infmt == GST_VIDEO_FORMAT_NV21)
+        reffmt = GST_VIDEO_FORMAT_YV12;
+      else
+        reffmt = GST_VIDEO_FORMAT_NV21;
+      fail_unless (gst_video_info_set_format (&refinfo, reffmt,
+              sizes[j].out_width, sizes[j].out_height));
+      refbuffer = gst_buffer_new_and_alloc (refinfo.size);
+      gst_video_frame_map (&refframe, &refinfo, refbuffer, GST_MAP_WRITE);
+
+      for (method = GST_VIDEO_RESAMPLER_METHOD_LINEAR;
+          method <= GST_VIDEO_RESAMPLER_METHOD_CUBIC; method++) {
+        GstVideoConverter *convert, *ref;
+        GstStructure *config;
+
+        config = gst_structure_new ("options",
+            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+            GST_TYPE_VIDEO_RESAMPLER_METHOD, method, NULL);
+        if (sizes[j].src_width)
+          gst_structure_set (config,
+              GST_VIDEO_CONVERTER_OPT_SRC_X, G_TYPE_INT, sizes[j].src_x,
+              GST_VIDEO_CONVERTER_OPT_SRC_Y, G_TYPE_INT, sizes[j].src_y,
+              GST_VIDEO_CONVERTER_OPT_SRC_WIDTH, G_TYPE_INT,
+              sizes[j].src_width, GST_VIDEO_CONVERTER_OPT_SRC_HEIGHT,
+              G_TYPE_INT, sizes[j].src_height, NULL);
+        if (sizes[j].dest_width)
+          gst_structure_set (config,
+              GST_VIDEO_CONVERTER_OPT_DEST_X, G_TYPE_INT, sizes[j].dest_x,
+              GST_VIDEO_CONVERTER_OPT_DEST_Y, G_TYPE_INT, sizes[j].dest_y,
+              GST_VIDEO_CONVERTER_OPT_DEST_WIDTH, G_TYPE_INT,
+              sizes[j].dest_width, GST_VIDEO_CONVERTER_OPT_DEST_HEIGHT,
+              G_TYPE_INT, sizes[j].dest_height, NULL);
+
+        ref = gst_video_converter_new (&ininfo, &refinfo,
+            gst_structure_copy (config));
+        fail_if (gst_video_converter_uses_fused_scale (ref));
+        convert = gst_video_converter_new (&ininfo, &outinfo, config);
+        fail_unless (gst_video_converter_uses_fused_scale (convert),
+            "%s -> %s not fused",
+            gst_video_format_to_string (pairs[i].infmt),
+            gst_video_format_to_string (pairs[i].outfmt));
+
+        gst_buffer_memset (outbuffer, 0, 0, -1);
+        gst_buffer_memset (refbuffer, 0, 0xff, -1);
+        gst_video_converter_frame (convert, &inframe, &outframe);
+        gst_video_converter_frame (ref, &inframe, &refframe);
+
+        for (comp = 0; comp < 3; comp++) {
+          gint diff = video_frame_comp_max_diff (&outframe, &refframe, comp);
+
+          fail_unless (diff <= FUSED_SCALE_TOLERANCE,
+              "%s %dx%d -> %s %dx%d, method %d: component %d differs by %d",
+              gst_video_format_to_string (pairs[i].infmt), sizes[j].in_width,
+              sizes[j].in_height, gst_video_format_to_string (pairs[i].outfmt),
+              sizes[j].out_width, sizes[j].out_height, method, comp, diff);
+        }
+
+        gst_video_converter_free (ref);
+        gst_video_converter_free (convert);
+      }
+
+      gst_video_frame_unmap (&refframe);
+      gst_buffer_unref (refbuffer);
+      gst_video_frame_unmap (&outframe);
+      gst_buffer_unref (outbuffer);
+      gst_video_frame_unmap (&inframe);
+      gst_buffer_unref (inbuffer);
+    }
+  }
+}
+
+GST_END_TEST;
+#undef FUSED_SCALE_TOLERANCE
+
 GST_START_TEST (test_video_convert)
 {
   GstVideoInfo ininfo, outinfo;
@@ -3290,6 +3703,73 @@ GST_START_TEST (test_video_convert_multithreading)
 
 GST_END_TEST;
 
+static void
+parallel_slice (gint * slice)
+{
+  g_atomic_int_inc (slice);
+}
+
+GST_START_TEST (test_video_parallel_runner)
+{
+  GstVideoParallelRunner *runner;
+  gint slices[4] = { 0, };
+  gpointer task_data[4];
+  GstStructure *stats;
+  guint64 runs, n_slices;
+  guint i, n_threads;
+
+  for (i = 0; i < 4; i++)
+    task_data[i] = &slices[i];
+
+  /* synchronous, on the default pool */
+  runner = gst_video_parallel_runner_new (4, NULL, FALSE);
+  n_threads = gst_video_parallel_runner_get_n_threads (runner);
+  fail_unless (n_threads >= 1 && n_threads <= 4);
+  for (i = 0; i < 10; i++) {
+    guint j;
+
+    gst_video_parallel_runner_run (runner,
+        (GstVideoParallelFunc) parallel_slice, task_data);
+    for (j = 0; j < n_threads; j++)
+      fail_unless_equals_int (g_atomic_int_get (&slices[j]), i + 1);
+  }
+
+  stats = gst_video_parallel_runner_get_stats (runner);
+  fail_unless (gst_structure_get_uint64 (stats, "runs", &runs));
+  fail_unless (gst_structure_get_uint64 (stats, "slices", &n_slices));
+  fail_unless_equals_uint64 (runs, 10);
+  fail_unless_equals_uint64 (n_slices, 10 * n_threads);
+  fail_unless (gst_structure_has_field_typed (stats, "imbalance",
+          G_TYPE_DOUBLE));
+  gst_structure_free (stats);
+  gst_video_parallel_runner_free (runner);
+
+  /* asynchronous, on a user-provided pool */
+  memset (slices, 0, sizeof (slices));
+  {
+    GstTaskPool *pool = gst_shared_task_pool_new ();
+
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (pool), 2);
+    gst_task_pool_prepare (pool, NULL);
+
+    runner = gst_video_parallel_runner_new (4, pool, TRUE);
+    fail_unless_equals_int (gst_video_parallel_runner_get_n_threads (runner),
+        2);
+    gst_video_parallel_runner_run (runner,
+        (GstVideoParallelFunc) parallel_slice, task_data);
+    gst_video_parallel_runner_finish (runner);
+    fail_unless_equals_int (g_atomic_int_get (&slices[0]), 1);
+    fail_unless_equals_int (g_atomic_int_get (&slices[1]), 1);
+    fail_unless_equals_int (g_atomic_int_get (&slices[2]), 0);
+    gst_video_parallel_runner_free (runner);
+
+    gst_task_pool_cleanup (pool);
+    gst_object_unref (pool);
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_transfer)
 {
   gint i, j;
@@ -5227,7 +5707,11 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_color_convert_other);
   tcase_add_test (tc_chain, test_video_size_convert);
   tcase_add_test (tc_chain, test_video_convert);
+  tcase_add_test (tc_chain, test_video_convert_fused_scale);
+  tcase_add_test (tc_chain, test_video_convert_fused_scale_generic);
+  tcase_add_test (tc_chain, test_video_convert_plan_cache);
   tcase_add_test (tc_chain, test_video_convert_multithreading);
+  tcase_add_test (tc_chain, test_video_parallel_runner);
   tcase_add_test (tc_chain, test_video_transfer);
   tcase_add_test (tc_chain, test_overlay_blend);
   tcase_add_test (tc_chain, test_video_center_rect);
@@ -0,0 +1,213 @@
+/* GStreamer
+ *
+ * unit test for the fused convert and scale kernels of the video converter
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video-converter-fused-private.h>
+
+#include <string.h>
+
+/* Returns @size random bytes at the end of @mem, so that valgrind notices
+ * reads after the end */
+static guint8 *
+alloc_random_at_end (gsize size, guint8 ** mem)
+{
+  guint i;
+
+  *mem = g_malloc (size + 1);
+  for (i = 0; i < size + 1; i++)
+    (*mem)[i] = g_random_int_range (0, 256);
+
+  return *mem + 1;
+}
+
+/* taps that add up to one, with some negative ones like the cubic and
+ * lanczos filters have */
+static void
+fill_random_taps (gint16 * taps, guint n_taps, guint stride)
+{
+  gint sum = 0;
+  guint k;
+
+  for (k = 0; k < n_taps; k++) {
+    taps[k * stride] = g_random_int_range (-1024, 2048);
+    sum += taps[k * stride];
+  }
+  taps[(n_taps / 2) * stride] += GST_VIDEO_FUSED_TAP_ONE - sum;
+}
+
+GST_START_TEST (test_fused_blend_lines)
+{
+  const GstVideoFusedImpl *impls;
+  guint n_impls, i, n_taps, end, start, k;
+
+  impls = gst_video_fused_get_implementations (&n_impls);
+  fail_unless (n_impls > 0);
+  fail_unless_equals_string (impls[n_impls - 1].name, "c");
+
+  for (i = 0; i < n_impls; i++) {
+    GST_INFO ("checking %s", impls[i].name);
+
+    for (n_taps = 1; n_taps <= GST_VIDEO_FUSED_MAX_TAPS; n_taps++) {
+      for (end = 0; end <= 70; end++) {
+        for (start = 0; start <= MIN (end, 3); start++) {
+          const guint8 *src[GST_VIDEO_FUSED_MAX_TAPS];
+          guint8 *mem[GST_VIDEO_FUSED_MAX_TAPS];
+          gint16 taps[GST_VIDEO_FUSED_MAX_TAPS];
+          guint8 expected[70], dest[70];
+
+          for (k = 0; k < n_taps; k++)
+            src[k] = alloc_random_at_end (end, &mem[k]);
+          fill_random_taps (taps, n_taps, 1);
+
+          memset (expected, 0xaa, sizeof (expected));
+          memset (dest, 0xaa, sizeof (dest));
+          gst_video_fused_blend_lines_c (expected, src, taps, n_taps, start,
+              end);
+          impls[i].blend_lines (dest, src, taps, n_taps, start, end);
+
+          fail_unless (memcmp (dest, expected, sizeof (dest)) == 0,
+              "%s differs with %u taps from %u to %u", impls[i].name, n_taps,
+              start, end);
+
+          for (k = 0; k < n_taps; k++)
+            g_free (mem[k]);
+        }
+      }
+    }
+  }
+}
+
+GST_END_TEST;
+
+/* Sets up @filter like the converter does, with the first input samples of
+ * the outputs spread evenly over the input line */
+static void
+setup_filter (GstVideoFusedFilter * filter, guint in_size, guint out_size,
+    guint n_taps, guint pstride, guint poffset)
+{
+  guint i;
+
+  filter->out_size = out_size;
+  filter->n_taps = n_taps;
+  filter->pstride = pstride;
+  filter->offset = g_new (guint32, out_size);
+  filter->taps = g_new (gint16, n_taps * out_size);
+  filter->safe_size = 0;
+
+  for (i = 0; i < out_size; i++) {
+    guint in_offset = 0;
+
+    if (out_size > 1)
+      in_offset = i * (in_size - n_taps) / (out_size - 1);
+
+    fill_random_taps (filter->taps + i, n_taps, out_size);
+
+    filter->offset[i] = in_offset * pstride + poffset;
+    if (filter->offset[i] + (n_taps - 1) * pstride + 4 <= in_size * pstride)
+      filter->safe_size = i + 1;
+  }
+}
+
+static void
+check_resample (const GstVideoFusedImpl * impl, const guint8 * src,
+    const GstVideoFusedFilter * filter, guint start, guint end)
+{
+  guint8 expected[64], dest[64];
+
+  memset (expected, 0xaa, sizeof (expected));
+  memset (dest, 0xaa, sizeof (dest));
+  gst_video_fused_resample_c (expected, src, filter, start, end);
+  impl->resample (dest, src, filter, start, end);
+
+  fail_unless (memcmp (dest, expected, sizeof (dest)) == 0,
+      "%s differs with %u taps, pixel stride %u from %u to %u of %u, "
+      "safe size %u", impl->name, filter->n_taps, filter->pstride, start, end,
+      filter->out_size, filter->safe_size);
+}
+
+/* Every range of outputs is checked around the safe size, after which
+ * vector versions have to fall back to the C version to not read past the
+ * end of the input line. The input ends right at the end of an allocation. */
+GST_START_TEST (test_fused_resample)
+{
+  static const guint n_taps_list[] = { 1, 2, 3, 4, 5, 8, 16 };
+  static const guint pstrides[] = { 1, 2, 4 };
+  const GstVideoFusedImpl *impls;
+  guint n_impls, i, t, p, poffset, in_size, out_size, start, end;
+
+  impls = gst_video_fused_get_implementations (&n_impls);
+
+  for (i = 0; i < n_impls; i++) {
+    GST_INFO ("checking %s", impls[i].name);
+
+    for (t = 0; t < G_N_ELEMENTS (n_taps_list); t++) {
+      guint n_taps = n_taps_list[t];
+
+      for (p = 0; p < G_N_ELEMENTS (pstrides); p++) {
+        guint pstride = pstrides[p];
+
+        for (poffset = 0; poffset < pstride; poffset++) {
+          for (in_size = n_taps; in_size <= n_taps + 40; in_size += 13) {
+            for (out_size = 1; out_size <= 40; out_size++) {
+              GstVideoFusedFilter filter;
+              guint8 *mem;
+              const guint8 *src;
+
+              src = alloc_random_at_end (in_size * pstride, &mem);
+              setup_filter (&filter, in_size, out_size, n_taps, pstride,
+                  poffset);
+
+              for (start = 0; start <= MIN (out_size, 9); start++)
+                check_resample (&impls[i], src, &filter, start, out_size);
+              for (end = MAX (filter.safe_size, 9) - 9; end <= out_size; end++)
+                check_resample (&impls[i], src, &filter, 0, end);
+
+              g_free (filter.offset);
+              g_free (filter.taps);
+              g_free (mem);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+GST_END_TEST;
+
+static Suite *
+video_fused_suite (void)
+{
+  Suite *s = suite_create ("GstVideoFused");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_fused_blend_lines);
+  tcase_add_test (tc_chain, test_fused_resample);
+
+  return s;
+}
+
+GST_CHECK_MAIN (video_fused);
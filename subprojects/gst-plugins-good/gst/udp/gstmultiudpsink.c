@@ -28,6 +28,13 @@
  * multiudpsink is a network sink that sends UDP packets to multiple
  * clients.
  * It can be combined with rtp payload encoders to implement RTP streaming.
+ *
+ * On Linux the #GstMultiUDPSink:gso property enables UDP segmentation
+ * offload: runs of equally sized packets for the same client, e.g. from an
+ * RTP payloader producing buffer lists, are then handed to the kernel as one
+ * big send and only split into individual datagrams further down the network
+ * stack. The #GstMultiUDPSink:packets-served and #GstMultiUDPSink:send-calls
+ * properties allow checking how many packets are sent per system call.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -44,6 +51,11 @@
 
 #include <gio/gnetworking.h>
 
+/* UDP_SEGMENT for segmentation offload */
+#ifdef __linux__
+#include <netinet/udp.h>
+#endif
+
 #include "gst/net/net.h"
 #include "gst/glib-compat-private.h"
 
@@ -52,6 +64,91 @@ GST_DEBUG_CATEGORY (multiudpsink_debug);
 
 #define UDP_MAX_SIZE 65507
 
+/* Maximum number of segments the kernel accepts in a single UDP_SEGMENT
+ * send (UDP_MAX_SEGMENTS, which is 64 on older kernels) */
+#define UDP_GSO_MAX_SEGMENTS 64
+/* Maximum number of vectors per message (UIO_MAXIOV) */
+#define UDP_GSO_MAX_VECTORS 1024
+
+#ifdef UDP_SEGMENT
+GType gst_udp_segment_message_get_type (void);
+
+#define GST_TYPE_UDP_SEGMENT_MESSAGE          (gst_udp_segment_message_get_type ())
+#define GST_UDP_SEGMENT_MESSAGE(o)            (G_TYPE_CHECK_INSTANCE_CAST ((o), GST_TYPE_UDP_SEGMENT_MESSAGE, GstUDPSegmentMessage))
+
+typedef struct _GstUDPSegmentMessage GstUDPSegmentMessage;
+typedef struct _GstUDPSegmentMessageClass GstUDPSegmentMessageClass;
+
+struct _GstUDPSegmentMessageClass
+{
+  GSocketControlMessageClass parent_class;
+};
+
+/* Tells the kernel to split the payload into datagrams of segment_size */
+struct _GstUDPSegmentMessage
+{
+  GSocketControlMessage parent;
+  guint16 segment_size;
+};
+
+G_DEFINE_TYPE (GstUDPSegmentMessage, gst_udp_segment_message,
+    G_TYPE_SOCKET_CONTROL_MESSAGE);
+
+static gsize
+gst_udp_segment_message_get_size (GSocketControlMessage * message)
+{
+  return sizeof (guint16);
+}
+
+static int
+gst_udp_segment_message_get_level (GSocketControlMessage * message)
+{
+  return IPPROTO_UDP;
+}
+
+static int
+gst_udp_segment_message_get_msg_type (GSocketControlMessage * message)
+{
+  return UDP_SEGMENT;
+}
+
+static void
+gst_udp_segment_message_serialize (GSocketControlMessage * message,
+    gpointer data)
+{
+  GstUDPSegmentMessage *msg = GST_UDP_SEGMENT_MESSAGE (message);
+
+  memcpy (data, &msg->segment_size, sizeof (guint16));
+}
+
+/* only used for sending, but GIO asks every control message type when
+ * deserializing received messages */
+static GSocketControlMessage *
+gst_udp_segment_message_deserialize (gint level,
+    gint type, gsize size, gpointer data)
+{
+  return NULL;
+}
+
+static void
+gst_udp_segment_message_init (GstUDPSegmentMessage * message)
+{
+}
+
+static void
+gst_udp_segment_message_class_init (GstUDPSegmentMessageClass * class)
+{
+  GSocketControlMessageClass *scm_class;
+
+  scm_class = G_SOCKET_CONTROL_MESSAGE_CLASS (class);
+  scm_class->get_size = gst_udp_segment_message_get_size;
+  scm_class->get_level = gst_udp_segment_message_get_level;
+  scm_class->get_type = gst_udp_segment_message_get_msg_type;
+  scm_class->serialize = gst_udp_segment_message_serialize;
+  scm_class->deserialize = gst_udp_segment_message_deserialize;
+}
+#endif
+
 static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -92,6 +189,7 @@ enum
 #define DEFAULT_BUFFER_SIZE        0
 #define DEFAULT_BIND_ADDRESS       NULL
 #define DEFAULT_BIND_PORT          0
+#define DEFAULT_GSO                FALSE
 
 enum
 {
@@ -114,7 +212,10 @@ enum
   PROP_SEND_DUPLICATES,
   PROP_BUFFER_SIZE,
   PROP_BIND_ADDRESS,
-  PROP_BIND_PORT
+  PROP_BIND_PORT,
+  PROP_GSO,
+  PROP_PACKETS_SERVED,
+  PROP_SEND_CALLS,
 };
 
 static void gst_multiudpsink_finalize (GObject * object);
@@ -351,6 +452,48 @@ gst_multiudpsink_class_init (GstMultiUDPSinkClass * klass)
           "Port to bind the socket to", 0, G_MAXUINT16,
           DEFAULT_BIND_PORT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiUDPSink:gso:
+   *
+   * Use UDP segmentation offload (UDP_SEGMENT) to send runs of equally sized
+   * packets for the same client with a single send. If the kernel does not
+   * support it or rejects a send, the sink falls back to sending every
+   * packet separately.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_GSO,
+      g_param_spec_boolean ("gso", "GSO",
+          "Coalesce equally sized packets for the same client into one send "
+          "using UDP segmentation offload if supported", DEFAULT_GSO,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstMultiUDPSink:packets-served:
+   *
+   * Total number of packets sent to all clients.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_PACKETS_SERVED,
+      g_param_spec_uint64 ("packets-served", "Packets served",
+          "Total number of packets sent to all clients", 0, G_MAXUINT64, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiUDPSink:send-calls:
+   *
+   * Number of send system calls used for sending the packets counted in
+   * #GstMultiUDPSink:packets-served.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_SEND_CALLS,
+      g_param_spec_uint64 ("send-calls", "Send calls",
+          "Number of send system calls made for sending to all clients", 0,
+          G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &sink_template);
 
   gst_element_class_set_static_metadata (gstelement_class, "UDP packet sender",
@@ -419,6 +562,7 @@ gst_multiudpsink_init (GstMultiUDPSink * sink)
   sink->qos_dscp = DEFAULT_QOS_DSCP;
   sink->send_duplicates = DEFAULT_SEND_DUPLICATES;
   sink->multi_iface = g_strdup (DEFAULT_MULTICAST_IFACE);
+  sink->gso = DEFAULT_GSO;
 
   gst_multiudpsink_create_cancellable (sink);
 
@@ -524,6 +668,7 @@ static void
 gst_multiudpsink_finalize (GObject * object)
 {
   GstMultiUDPSink *sink;
+  guint i;
 
   sink = GST_MULTIUDPSINK (object);
 
@@ -557,6 +702,14 @@ gst_multiudpsink_finalize (GObject * object)
   sink->maps = NULL;
   g_free (sink->messages);
   sink->messages = NULL;
+  g_free (sink->gso_messages);
+  sink->gso_messages = NULL;
+  g_free (sink->gso_groups);
+  sink->gso_groups = NULL;
+  for (i = 0; i < sink->n_gso_cmsgs; i++)
+    g_object_unref (sink->gso_cmsgs[i]);
+  g_free (sink->gso_cmsgs);
+  sink->gso_cmsgs = NULL;
 
   g_free (sink->bind_address);
   sink->bind_address = NULL;
@@ -648,6 +801,7 @@ gst_multiudpsink_send_messages (GstMultiUDPSink * sink, GSocket * socket,
     guint msg_size, skip, i;
     gint ret, err_idx;
 
+    sink->send_calls++;
     ret = g_socket_send_messages (socket, messages, num_messages, 0,
         sink->cancellable, &err);
 
@@ -714,11 +868,174 @@ gst_multiudpsink_send_messages (GstMultiUDPSink * sink, GSocket * socket,
   return GST_FLOW_OK;
 }
 
+/* Splits the first num_buffers messages into runs that can be sent as one
+ * UDP_SEGMENT message each: all packets of a run must have the same size
+ * except for the last one, which may be shorter. Returns the number of runs */
+static guint
+gst_multiudpsink_make_gso_groups (GstMultiUDPSink * sink,
+    GstOutputMessage * msgs, guint num_buffers)
+{
+  GstUDPGsoGroup *group = NULL;
+  guint i, n_groups = 0;
+
+  if (sink->n_gso_groups < num_buffers) {
+    sink->n_gso_groups = GST_ROUND_UP_16 (num_buffers);
+    g_free (sink->gso_groups);
+    sink->gso_groups = g_new (GstUDPGsoGroup, sink->n_gso_groups);
+  }
+
+  for (i = 0; i < num_buffers; ++i) {
+    gsize size = gst_udp_calc_message_size (&msgs[i]);
+
+    if (group != NULL && size > 0 && size <= group->segment_size
+        && group->size == group->n_buffers * group->segment_size
+        && group->n_buffers < UDP_GSO_MAX_SEGMENTS
+        && group->n_vectors + msgs[i].num_vectors <= UDP_GSO_MAX_VECTORS
+        && group->size + size <= UDP_MAX_SIZE) {
+      group->n_buffers++;
+      group->n_vectors += msgs[i].num_vectors;
+      group->size += size;
+      continue;
+    }
+
+    group = &sink->gso_groups[n_groups++];
+    group->first = i;
+    group->n_buffers = 1;
+    group->n_vectors = msgs[i].num_vectors;
+    group->segment_size = size;
+    group->size = size;
+  }
+
+  return n_groups;
+}
+
+/* Fills the first n_groups messages of the GSO message array from the
+ * per-buffer messages, one for each run of packets */
+static GstOutputMessage *
+gst_multiudpsink_prepare_gso_messages (GstMultiUDPSink * sink,
+    GstOutputMessage * msgs, guint n_groups, guint num_addr)
+{
+#ifdef UDP_SEGMENT
+  GstOutputMessage *gso_msgs;
+  guint i;
+
+  if (sink->n_gso_messages < n_groups * num_addr) {
+    sink->n_gso_messages = GST_ROUND_UP_16 (n_groups * num_addr);
+    g_free (sink->gso_messages);
+    sink->gso_messages = g_new (GstOutputMessage, sink->n_gso_messages);
+  }
+  gso_msgs = sink->gso_messages;
+
+  /* the control messages are only read during sending, so we keep them
+   * around and only update the segment size */
+  if (sink->n_gso_cmsgs < n_groups) {
+    sink->gso_cmsgs = g_renew (GSocketControlMessage *, sink->gso_cmsgs,
+        n_groups);
+    for (i = sink->n_gso_cmsgs; i < n_groups; ++i)
+      sink->gso_cmsgs[i] = g_object_new (GST_TYPE_UDP_SEGMENT_MESSAGE, NULL);
+    sink->n_gso_cmsgs = n_groups;
+  }
+
+  for (i = 0; i < n_groups; ++i) {
+    GstUDPGsoGroup *group = &sink->gso_groups[i];
+
+    gso_msgs[i] = msgs[group->first];
+    gso_msgs[i].num_vectors = group->n_vectors;
+
+    if (group->n_buffers > 1) {
+      GST_UDP_SEGMENT_MESSAGE (sink->gso_cmsgs[i])->segment_size =
+          group->segment_size;
+      gso_msgs[i].control_messages = &sink->gso_cmsgs[i];
+      gso_msgs[i].num_control_messages = 1;
+    }
+  }
+
+  return gso_msgs;
+#else
+  g_assert_not_reached ();
+  return NULL;
+#endif
+}
+
+/* Like gst_multiudpsink_send_messages() but sends runs of packets as single
+ * UDP_SEGMENT messages. gso_msgs contains n_groups messages per client, msgs
+ * the corresponding num_buffers per-buffer messages per client. If the kernel
+ * rejects a segmented send, the remaining packets are sent one by one. */
+static GstFlowReturn
+gst_multiudpsink_send_messages_gso (GstMultiUDPSink * sink, GSocket * socket,
+    GstOutputMessage * gso_msgs, guint num_gso_msgs, guint n_groups,
+    GstOutputMessage * msgs, guint num_buffers)
+{
+  GError *err = NULL;
+  guint sent = 0, i, j;
+
+  while (sent < num_gso_msgs) {
+    gint ret;
+
+    sink->send_calls++;
+    ret = g_socket_send_messages (socket, gso_msgs + sent,
+        num_gso_msgs - sent, 0, sink->cancellable, &err);
+
+    if (G_UNLIKELY (ret < 0)) {
+      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        GstFlowReturn flow_ret;
+
+        g_clear_error (&err);
+
+        flow_ret = gst_base_sink_wait_preroll (GST_BASE_SINK (sink));
+
+        if (flow_ret == GST_FLOW_OK)
+          continue;
+
+        return flow_ret;
+      }
+      break;
+    }
+
+    sent += ret;
+  }
+
+  /* per-buffer messages are used for the client statistics */
+  for (i = 0; i < sent; ++i) {
+    GstUDPGsoGroup *group = &sink->gso_groups[i % n_groups];
+    guint first = (i / n_groups) * num_buffers + group->first;
+
+    if (gso_msgs[i].bytes_sent == 0)
+      continue;
+
+    for (j = first; j < first + group->n_buffers; ++j)
+      msgs[j].bytes_sent = gst_udp_calc_message_size (&msgs[j]);
+  }
+
+  if (sent < num_gso_msgs) {
+    GstUDPGsoGroup *group = &sink->gso_groups[sent % n_groups];
+    guint first = (sent / n_groups) * num_buffers + group->first;
+    guint num_msgs = (num_gso_msgs / n_groups) * num_buffers;
+
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_FAILED)) {
+      GST_WARNING_OBJECT (sink, "UDP segmentation offload failed, disabling "
+          "it: %s", err->message);
+      sink->gso_active = FALSE;
+    } else {
+      GST_DEBUG_OBJECT (sink, "error sending segmented packets: %s",
+          err->message);
+    }
+    g_clear_error (&err);
+
+    return gst_multiudpsink_send_messages (sink, socket, msgs + first,
+        num_msgs - first);
+  }
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
     guint num_buffers, guint8 * mem_nums, guint total_mem_num)
 {
-  GstOutputMessage *msgs;
+  GstOutputMessage *msgs, *gso_msgs = NULL;
   gboolean send_duplicates;
   GstUDPClient **clients;
   GOutputVector *vecs;
@@ -726,7 +1043,7 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
   GstFlowReturn flow_ret;
   guint num_addr_v4, num_addr_v6;
   guint num_addr, num_msgs;
-  guint i, j, mem;
+  guint i, j, mem, n_groups = 0;
   gsize size = 0;
   GList *l;
 
@@ -799,6 +1116,16 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
   /* FIXME: how about some locking? (there wasn't any before either, but..) */
   sink->bytes_to_serve += size;
 
+  /* only worth it if at least two packets can be coalesced */
+  if (sink->gso_active && num_buffers > 1) {
+    n_groups = gst_multiudpsink_make_gso_groups (sink, msgs, num_buffers);
+    if (n_groups < num_buffers)
+      gso_msgs = gst_multiudpsink_prepare_gso_messages (sink, msgs, n_groups,
+          num_addr);
+    else
+      n_groups = 0;
+  }
+
   /* now copy the pre-filled num_buffer messages over to the next num_buffer
    * messages for the next client, where we also change the target address */
   for (i = 1; i < num_addr; ++i) {
@@ -806,12 +1133,38 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
       msgs[i * num_buffers + j] = msgs[j];
       msgs[i * num_buffers + j].address = clients[i]->addr;
     }
+    for (j = 0; j < n_groups; ++j) {
+      gso_msgs[i * n_groups + j] = gso_msgs[j];
+      gso_msgs[i * n_groups + j].address = clients[i]->addr;
+    }
   }
 
   /* now send it! */
 
-  /* no IPv4 socket? Send it all from the IPv6 socket then.. */
-  if (sink->used_socket == NULL) {
+  if (n_groups > 0) {
+    guint num_gso_msgs_v4 = n_groups * num_addr_v4;
+    guint num_gso_msgs_v6 = n_groups * num_addr_v6;
+    guint num_msgs_v4 = num_buffers * num_addr_v4;
+
+    /* same as below, IPv4 clients first, everything over IPv6 if we only
+     * have an IPv6 socket */
+    if (sink->used_socket == NULL) {
+      flow_ret = gst_multiudpsink_send_messages_gso (sink,
+          sink->used_socket_v6, gso_msgs, n_groups * num_addr, n_groups,
+          msgs, num_buffers);
+    } else {
+      flow_ret = gst_multiudpsink_send_messages_gso (sink, sink->used_socket,
+          gso_msgs, num_gso_msgs_v4, n_groups, msgs, num_buffers);
+
+      if (flow_ret != GST_FLOW_OK)
+        goto cancelled;
+
+      flow_ret = gst_multiudpsink_send_messages_gso (sink,
+          sink->used_socket_v6, gso_msgs + num_gso_msgs_v4, num_gso_msgs_v6,
+          n_groups, msgs + num_msgs_v4, num_buffers);
+    }
+  } else if (sink->used_socket == NULL) {
+    /* no IPv4 socket? Send it all from the IPv6 socket then.. */
     flow_ret = gst_multiudpsink_send_messages (sink, sink->used_socket_v6,
         msgs, num_msgs);
   } else {
@@ -846,6 +1199,7 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
       client->bytes_sent += bytes_sent;
       client->packets_sent++;
       sink->bytes_served += bytes_sent;
+      sink->packets_served++;
     }
     gst_udp_client_unref (client);
   }
@@ -1094,6 +1448,9 @@ gst_multiudpsink_set_property (GObject * object, guint prop_id,
     case PROP_BIND_PORT:
       udpsink->bind_port = g_value_get_int (value);
       break;
+    case PROP_GSO:
+      udpsink->gso = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1167,6 +1524,15 @@ gst_multiudpsink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_BIND_PORT:
       g_value_set_int (value, udpsink->bind_port);
       break;
+    case PROP_GSO:
+      g_value_set_boolean (value, udpsink->gso);
+      break;
+    case PROP_PACKETS_SERVED:
+      g_value_set_uint64 (value, udpsink->packets_served);
+      break;
+    case PROP_SEND_CALLS:
+      g_value_set_uint64 (value, udpsink->send_calls);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1231,6 +1597,31 @@ invalid_family:
   }
 }
 
+/* Checks whether the kernel knows about UDP_SEGMENT for this socket */
+static gboolean
+gst_multiudpsink_probe_gso (GstMultiUDPSink * sink, GSocket * socket)
+{
+#ifdef UDP_SEGMENT
+  GError *err = NULL;
+  gint val;
+
+  if (socket == NULL)
+    return TRUE;
+
+  if (!g_socket_get_option (socket, IPPROTO_UDP, UDP_SEGMENT, &val, &err)) {
+    GST_WARNING_OBJECT (sink, "UDP segmentation offload not supported: %s",
+        err->message);
+    g_clear_error (&err);
+    return FALSE;
+  }
+
+  return TRUE;
+#else
+  GST_WARNING_OBJECT (sink, "gso was requested but UDP_SEGMENT is not defined");
+  return FALSE;
+#endif
+}
+
 /* create a socket for sending to remote machine */
 static gboolean
 gst_multiudpsink_start (GstBaseSink * bsink)
@@ -1436,6 +1827,14 @@ gst_multiudpsink_start (GstBaseSink * bsink)
 
   sink->bytes_to_serve = 0;
   sink->bytes_served = 0;
+  sink->packets_served = 0;
+  sink->send_calls = 0;
+
+  sink->gso_active = sink->gso
+      && gst_multiudpsink_probe_gso (sink, sink->used_socket)
+      && gst_multiudpsink_probe_gso (sink, sink->used_socket_v6);
+  GST_DEBUG_OBJECT (sink, "UDP segmentation offload %s",
+      sink->gso_active ? "enabled" : "disabled");
 
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket);
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket_v6);
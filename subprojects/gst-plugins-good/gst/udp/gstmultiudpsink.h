@@ -55,6 +55,16 @@ typedef struct {
   guint64 disconnect_time;
 } GstUDPClient;
 
+/* A run of equally sized packets (the last one may be shorter) that is sent
+ * as a single message with UDP segmentation offload */
+typedef struct {
+  guint first;            /* index of the first buffer */
+  guint n_buffers;
+  guint n_vectors;
+  gsize segment_size;
+  gsize size;
+} GstUDPGsoGroup;
+
 /* sends udp packets to multiple host/port pairs.
  */
 struct _GstMultiUDPSink {
@@ -82,9 +92,20 @@ struct _GstMultiUDPSink {
   GstOutputMessage *messages;
   guint             n_messages;
 
+  /* UDP segmentation offload, only used if gso_active */
+  GstOutputMessage *gso_messages;
+  guint             n_gso_messages;
+  GstUDPGsoGroup   *gso_groups;
+  guint             n_gso_groups;
+  GSocketControlMessage **gso_cmsgs;
+  guint             n_gso_cmsgs;
+  gboolean          gso_active;
+
   /* properties */
   guint64        bytes_to_serve;
   guint64        bytes_served;
+  guint64        packets_served;
+  guint64        send_calls;
   GSocket       *socket, *socket_v6;
   gboolean       close_socket;
 
@@ -102,6 +123,7 @@ struct _GstMultiUDPSink {
   gint           buffer_size;
   gchar         *bind_address;
   gint           bind_port;
+  gboolean       gso;
 };
 
 struct _GstMultiUDPSinkClass {
@@ -82,6 +82,11 @@
  * with the #GstUDPSrc:close-socket property, in which case the
  * application is responsible for closing the file descriptor.
  *
+ * For high packet rates the #GstUDPSrc:batch-size property can be set to
+ * read multiple packets per system call. These are then pushed downstream
+ * together as a #GstBufferList. On Linux the #GstUDPSrc:gro property can
+ * additionally be used to let the kernel coalesce datagrams.
+ *
  * ## Examples
  * |[
  * gst-launch-1.0 -v udpsrc ! fakesink dump=1
@@ -127,6 +132,11 @@
 #include <netinet/ip.h>
 #endif
 
+/* UDP_GRO for coalesced receive in batch mode */
+#ifdef __linux__
+#include <netinet/udp.h>
+#endif
+
 /* Control messages for getting the destination address */
 #ifdef IP_PKTINFO
 GType gst_ip_pktinfo_message_get_type (void);
@@ -507,6 +517,94 @@ gst_socket_timestamp_message_class_init (GstSocketTimestampMessageClass * class)
 }
 #endif
 
+#ifdef UDP_GRO
+GType gst_udp_gro_message_get_type (void);
+
+#define GST_TYPE_UDP_GRO_MESSAGE          (gst_udp_gro_message_get_type ())
+#define GST_UDP_GRO_MESSAGE(o)            (G_TYPE_CHECK_INSTANCE_CAST ((o), GST_TYPE_UDP_GRO_MESSAGE, GstUDPGroMessage))
+#define GST_UDP_GRO_MESSAGE_CLASS(c)      (G_TYPE_CHECK_CLASS_CAST ((c), GST_TYPE_UDP_GRO_MESSAGE, GstUDPGroMessageClass))
+#define GST_IS_UDP_GRO_MESSAGE(o)         (G_TYPE_CHECK_INSTANCE_TYPE ((o), GST_TYPE_UDP_GRO_MESSAGE))
+#define GST_IS_UDP_GRO_MESSAGE_CLASS(c)   (G_TYPE_CHECK_CLASS_TYPE ((c), GST_TYPE_UDP_GRO_MESSAGE))
+#define GST_UDP_GRO_MESSAGE_GET_CLASS(o)  (G_TYPE_INSTANCE_GET_CLASS ((o), GST_TYPE_UDP_GRO_MESSAGE, GstUDPGroMessageClass))
+
+typedef struct _GstUDPGroMessage GstUDPGroMessage;
+typedef struct _GstUDPGroMessageClass GstUDPGroMessageClass;
+
+struct _GstUDPGroMessageClass
+{
+  GSocketControlMessageClass parent_class;
+};
+
+/* Size of the individual datagrams the kernel coalesced into one receive */
+struct _GstUDPGroMessage
+{
+  GSocketControlMessage parent;
+  gint segment_size;
+};
+
+G_DEFINE_TYPE (GstUDPGroMessage, gst_udp_gro_message,
+    G_TYPE_SOCKET_CONTROL_MESSAGE);
+
+static gsize
+gst_udp_gro_message_get_size (GSocketControlMessage * message)
+{
+  return sizeof (int);
+}
+
+static int
+gst_udp_gro_message_get_level (GSocketControlMessage * message)
+{
+  return IPPROTO_UDP;
+}
+
+static int
+gst_udp_gro_message_get_msg_type (GSocketControlMessage * message)
+{
+  return UDP_GRO;
+}
+
+static GSocketControlMessage *
+gst_udp_gro_message_deserialize (gint level,
+    gint type, gsize size, gpointer data)
+{
+  GstUDPGroMessage *message;
+  int segment_size;
+
+  if (level != IPPROTO_UDP || type != UDP_GRO)
+    return NULL;
+
+  if (size < sizeof (int))
+    return NULL;
+
+  memcpy (&segment_size, data, sizeof (int));
+
+  message = g_object_new (GST_TYPE_UDP_GRO_MESSAGE, NULL);
+  message->segment_size = segment_size;
+
+  return G_SOCKET_CONTROL_MESSAGE (message);
+}
+
+static void
+gst_udp_gro_message_init (GstUDPGroMessage * message)
+{
+}
+
+static void
+gst_udp_gro_message_class_init (GstUDPGroMessageClass * class)
+{
+  GSocketControlMessageClass *scm_class;
+
+  scm_class = G_SOCKET_CONTROL_MESSAGE_CLASS (class);
+  scm_class->get_size = gst_udp_gro_message_get_size;
+  scm_class->get_level = gst_udp_gro_message_get_level;
+  scm_class->get_type = gst_udp_gro_message_get_msg_type;
+  scm_class->deserialize = gst_udp_gro_message_deserialize;
+}
+#endif
+
+/* not 100% correct, but a good upper bound for memory allocation purposes */
+#define MAX_IPV4_UDP_PACKET_SIZE (65536 - 8)
+
 static gboolean
 gst_udpsrc_prepare_allocator (GstBaseSrc * bsrc, GstCaps * caps)
 {
@@ -514,12 +612,18 @@ gst_udpsrc_prepare_allocator (GstBaseSrc * bsrc, GstCaps * caps)
   GstUDPSrc *udpsrc;
   GstBufferPool *pool;
   GstStructure *config;
+  guint size;
 
   udpsrc = GST_UDPSRC (bsrc);
 
+  /* Coalesced GRO packets bigger than that go into extra memory like other
+   * big packets, see gst_udpsrc_batch_extra_size() */
+  size = udpsrc->mtu;
+
   pool = gst_buffer_pool_new ();
   config = gst_buffer_pool_get_config (pool);
-  gst_buffer_pool_config_set_params (config, caps, udpsrc->mtu, 0, 0);
+  gst_buffer_pool_config_set_params (config, caps, size,
+      MAX (udpsrc->batch_size, 1), 0);
   gst_buffer_pool_set_config (pool, config);
 
   ret = gst_base_src_set_allocator (bsrc, pool, NULL, NULL);
@@ -529,8 +633,6 @@ gst_udpsrc_prepare_allocator (GstBaseSrc * bsrc, GstCaps * caps)
   return ret;
 }
 
-/* not 100% correct, but a good upper bound for memory allocation purposes */
-#define MAX_IPV4_UDP_PACKET_SIZE (65536 - 8)
 
 GST_DEBUG_CATEGORY (udpsrc_debug);
 #define GST_CAT_DEFAULT (udpsrc_debug)
@@ -557,6 +659,10 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
 #define UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS TRUE
 #define UDP_DEFAULT_MTU                (1492)
 #define UDP_DEFAULT_MULTICAST_SOURCE   NULL
+#define UDP_DEFAULT_BATCH_SIZE         1
+#define UDP_DEFAULT_GRO                FALSE
+
+#define UDP_MAX_BATCH_SIZE             1024
 
 enum
 {
@@ -581,6 +687,8 @@ enum
   PROP_MTU,
   PROP_SOCKET_TIMESTAMP,
   PROP_MULTICAST_SOURCE,
+  PROP_BATCH_SIZE,
+  PROP_GRO,
 };
 
 static void gst_udpsrc_uri_handler_init (gpointer g_iface, gpointer iface_data);
@@ -589,7 +697,10 @@ static GstCaps *gst_udpsrc_getcaps (GstBaseSrc * src, GstCaps * filter);
 static gboolean gst_udpsrc_close (GstUDPSrc * src);
 static gboolean gst_udpsrc_unlock (GstBaseSrc * bsrc);
 static gboolean gst_udpsrc_unlock_stop (GstBaseSrc * bsrc);
+static GstFlowReturn gst_udpsrc_create (GstBaseSrc * bsrc, guint64 offset,
+    guint length, GstBuffer ** buf);
 static GstFlowReturn gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf);
+static void gst_udpsrc_free_batch_slots (GstUDPSrc * udpsrc);
 
 static void gst_udpsrc_finalize (GObject * object);
 
@@ -634,6 +745,9 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
 #ifdef SO_TIMESTAMPNS
   GST_TYPE_SOCKET_TIMESTAMP_MESSAGE;
 #endif
+#ifdef UDP_GRO
+  GST_TYPE_UDP_GRO_MESSAGE;
+#endif
 
   gobject_class->set_property = gst_udpsrc_set_property;
   gobject_class->get_property = gst_udpsrc_get_property;
@@ -783,6 +897,45 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
           UDP_DEFAULT_MULTICAST_SOURCE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstUDPSrc:batch-size:
+   *
+   * Maximum number of datagrams to read with a single receive call. If
+   * bigger than 1, packets are read with g_socket_receive_messages() (which
+   * maps to recvmmsg() where available) into buffers from the buffer pool
+   * and all packets read in one go are pushed downstream as a
+   * #GstBufferList.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch Size",
+          "Maximum number of packets to receive per system call. Packets "
+          "received together are pushed downstream as a buffer list "
+          "(1 = one packet per buffer)", 1, UDP_MAX_BATCH_SIZE,
+          UDP_DEFAULT_BATCH_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstUDPSrc:gro:
+   *
+   * Enable UDP generic receive offload (UDP_GRO) if the kernel supports it.
+   * The kernel then coalesces consecutive datagrams of the same size from
+   * the same sender into a single receive, which udpsrc splits again into
+   * one buffer per datagram without copying. Packets are then always
+   * received as described for #GstUDPSrc:batch-size and pushed downstream
+   * as buffer lists.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_GRO,
+      g_param_spec_boolean ("gro", "GRO",
+          "Let the kernel coalesce received datagrams (UDP_GRO) if supported",
+          UDP_DEFAULT_GRO,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gst_element_class_add_static_pad_template (gstelement_class, &src_template);
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -797,6 +950,7 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
   gstbasesrc_class->unlock_stop = gst_udpsrc_unlock_stop;
   gstbasesrc_class->get_caps = gst_udpsrc_getcaps;
   gstbasesrc_class->prepare_allocator = gst_udpsrc_prepare_allocator;
+  gstbasesrc_class->create = gst_udpsrc_create;
 
   gstpushsrc_class->fill = gst_udpsrc_fill;
 
@@ -825,6 +979,8 @@ gst_udpsrc_init (GstUDPSrc * udpsrc)
   udpsrc->loop = UDP_DEFAULT_LOOP;
   udpsrc->retrieve_sender_address = UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS;
   udpsrc->mtu = UDP_DEFAULT_MTU;
+  udpsrc->batch_size = UDP_DEFAULT_BATCH_SIZE;
+  udpsrc->gro = UDP_DEFAULT_GRO;
   udpsrc->source_list =
       g_ptr_array_new_with_free_func ((GDestroyNotify) g_free);
 
@@ -869,6 +1025,8 @@ gst_udpsrc_finalize (GObject * object)
     gst_memory_unref (udpsrc->extra_mem);
   udpsrc->extra_mem = NULL;
 
+  gst_udpsrc_free_batch_slots (udpsrc);
+
   g_ptr_array_unref (udpsrc->source_list);
   g_free (udpsrc->multicast_source);
 
@@ -920,6 +1078,586 @@ gst_udpsrc_free_cancellable (GstUDPSrc * src)
   g_clear_object (&src->cancellable);
 }
 
+/* Waits until the socket becomes readable, posting a timeout message every
+ * time the configured timeout expires. Returns FALSE with @err set when
+ * cancelled or on errors. */
+static gboolean
+gst_udpsrc_wait_readable (GstUDPSrc * udpsrc, GError ** err)
+{
+  gboolean try_again;
+
+  do {
+    gint64 timeout;
+
+    try_again = FALSE;
+
+    if (udpsrc->timeout)
+      timeout = udpsrc->timeout / 1000;
+    else
+      timeout = -1;
+
+    GST_LOG_OBJECT (udpsrc, "doing select, timeout %" G_GINT64_FORMAT, timeout);
+
+    if (!g_socket_condition_timed_wait (udpsrc->used_socket, G_IO_IN | G_IO_PRI,
+            timeout, udpsrc->cancellable, err)) {
+      if (g_error_matches (*err, G_IO_ERROR, G_IO_ERROR_TIMED_OUT)) {
+        g_clear_error (err);
+        /* timeout, post element message */
+        gst_element_post_message (GST_ELEMENT_CAST (udpsrc),
+            gst_message_new_element (GST_OBJECT_CAST (udpsrc),
+                gst_structure_new ("GstUDPSrcTimeout",
+                    "timeout", G_TYPE_UINT64, udpsrc->timeout, NULL)));
+      } else {
+        return FALSE;
+      }
+
+      try_again = TRUE;
+    }
+  } while (G_UNLIKELY (try_again));
+
+  return TRUE;
+}
+
+/* Handles the control messages received along with a packet: checks the
+ * destination address for multicast, applies socket timestamps to @outbuf
+ * and extracts the GRO segment size if any. Takes ownership of @msgs.
+ * Returns FALSE if the packet was not meant for us and should be dropped */
+static gboolean
+gst_udpsrc_handle_control_messages (GstUDPSrc * udpsrc,
+    GSocketControlMessage ** msgs, gint n_msgs, GstBuffer * outbuf,
+    gsize * segment_size)
+{
+  GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
+  gboolean skip_packet = FALSE;
+  gsize iaddr_size = g_inet_address_get_native_size (iaddr);
+  const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
+  gint i;
+
+  for (i = 0; i < n_msgs && !skip_packet; i++) {
+#ifdef IP_PKTINFO
+    if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef IPV6_PKTINFO
+    if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef IP_RECVDSTADDR
+    if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
+      GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef UDP_GRO
+    if (GST_IS_UDP_GRO_MESSAGE (msgs[i])) {
+      GstUDPGroMessage *msg = GST_UDP_GRO_MESSAGE (msgs[i]);
+
+      if (segment_size && msg->segment_size > 0)
+        *segment_size = msg->segment_size;
+    }
+#endif
+#ifdef SO_TIMESTAMPNS
+    if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
+      GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
+      GstClock *clock;
+      GstClockTime socket_ts;
+
+      socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
+      GST_TRACE_OBJECT (udpsrc,
+          "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
+          GST_TIME_ARGS (socket_ts));
+
+      clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+      if (clock != NULL) {
+        gint64 adjust_dts, cur_sys_time, delta;
+        GstClockTime base_time, cur_gst_clk_time, running_time;
+
+        /*
+         * We use g_get_real_time as the time reference for SCM timestamps
+         * is always CLOCK_REALTIME.
+         */
+        cur_sys_time = g_get_real_time () * GST_USECOND;
+        cur_gst_clk_time = gst_clock_get_time (clock);
+
+        delta = (gint64) cur_sys_time - (gint64) socket_ts;
+        if (delta < 0) {
+          /*
+           * The current system time will always be greater than the SCM
+           * timestamp as the packet would have been timestamped at least
+           * some clock cycles before. If it is not, then the system time
+           * was adjusted. Since we cannot rely on the delta calculation in
+           * such a case, set the DTS to current pipeline clock when this
+           * happens.
+           */
+          GST_LOG_OBJECT (udpsrc,
+              "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
+          GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
+        } else {
+          base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+          running_time = cur_gst_clk_time - base_time;
+          adjust_dts = (gint64) running_time - delta;
+          /*
+           * If the system time was adjusted much further ahead, we might
+           * end up with delta > cur_gst_clk_time. Set the DTS to current
+           * pipeline clock for this scenario as well.
+           */
+          if (adjust_dts < 0) {
+            GST_LOG_OBJECT (udpsrc,
+                "Current system time much ahead in time, setting DTS to pipeline clock");
+            GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
+          } else {
+            GST_BUFFER_DTS (outbuf) = adjust_dts;
+            GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
+                GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
+          }
+        }
+        g_object_unref (clock);
+      } else {
+        GST_ERROR_OBJECT (udpsrc,
+            "Failed to get element clock, not setting DTS");
+      }
+    }
+#endif
+  }
+
+  for (i = 0; i < n_msgs; i++) {
+    g_object_unref (msgs[i]);
+  }
+  g_free (msgs);
+
+  return !skip_packet;
+}
+
+/* optimization: use messages only in multicast mode and
+ * if we can't let the kernel do the filtering for us */
+static gboolean
+gst_udpsrc_needs_control_messages (GstUDPSrc * udpsrc)
+{
+  gboolean needs_msgs;
+
+  needs_msgs =
+      g_inet_address_get_is_multicast (g_inet_socket_address_get_address
+      (udpsrc->addr));
+#ifdef IP_MULTICAST_ALL
+  if (g_inet_address_get_family (g_inet_socket_address_get_address
+          (udpsrc->addr)) == G_SOCKET_FAMILY_IPV4)
+    needs_msgs = FALSE;
+#endif
+#ifdef SO_TIMESTAMPNS
+  if (udpsrc->socket_timestamp_mode == GST_SOCKET_TIMESTAMP_MODE_REALTIME)
+    needs_msgs = TRUE;
+#endif
+#ifdef UDP_GRO
+  if (udpsrc->gro_enabled)
+    needs_msgs = TRUE;
+#endif
+
+  return needs_msgs;
+}
+
+/* Linux coalesces at most this many datagrams into one with UDP_GRO */
+#define UDP_GRO_MAX_SEGMENTS 64
+
+/* Size of the extra memory every slot of a batch receives packets exceeding
+ * the mtu into. With GRO, coalesced packets can only get as big as the
+ * maximum number of segments once the segment size is known. */
+static gsize
+gst_udpsrc_batch_extra_size (GstUDPSrc * udpsrc)
+{
+  if (udpsrc->gro_enabled && udpsrc->gro_segment_size > 0)
+    return MIN (UDP_GRO_MAX_SEGMENTS * udpsrc->gro_segment_size,
+        MAX_IPV4_UDP_PACKET_SIZE);
+
+  return MAX_IPV4_UDP_PACKET_SIZE;
+}
+
+/* Per-packet state of batched receiving. A slot keeps its buffer from the
+ * pool until a packet was received into it */
+struct _GstUDPSrcBatchSlot
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+  GstMemory *extra_mem;
+  GstMapInfo extra_map;
+  GInputVector vecs[2];
+  GSocketAddress *saddr;
+  GSocketControlMessage **msgs;
+  guint n_msgs;
+};
+
+static void
+gst_udpsrc_free_batch_slots (GstUDPSrc * udpsrc)
+{
+  guint i;
+
+  for (i = 0; i < udpsrc->n_batch_slots; i++) {
+    GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[i];
+    guint j;
+
+    gst_clear_buffer (&slot->buffer);
+    g_clear_object (&slot->saddr);
+    for (j = 0; j < slot->n_msgs; j++)
+      g_object_unref (slot->msgs[j]);
+    g_clear_pointer (&slot->msgs, g_free);
+    if (slot->extra_mem)
+      gst_memory_unref (slot->extra_mem);
+    slot->extra_mem = NULL;
+  }
+
+  g_clear_pointer (&udpsrc->batch_slots, g_free);
+  g_clear_pointer (&udpsrc->batch_msgs, g_free);
+  udpsrc->n_batch_slots = 0;
+}
+
+/* Unmaps all slots that were prepared for receiving and drops the results
+ * of slots after @n_received, which will be reused by the next call */
+static void
+gst_udpsrc_unmap_batch_slots (GstUDPSrc * udpsrc, guint n_prepared,
+    guint n_received)
+{
+  guint i;
+
+  for (i = 0; i < n_prepared; i++) {
+    GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[i];
+
+    gst_buffer_unmap (slot->buffer, &slot->map);
+    if (slot->extra_mem)
+      gst_memory_unmap (slot->extra_mem, &slot->extra_map);
+
+    if (i >= n_received) {
+      guint j;
+
+      g_clear_object (&slot->saddr);
+      for (j = 0; j < slot->n_msgs; j++)
+        g_object_unref (slot->msgs[j]);
+      g_clear_pointer (&slot->msgs, g_free);
+      slot->n_msgs = 0;
+    }
+  }
+}
+
+/* Turns the packet received into @slot into one or more output buffers,
+ * splitting GRO coalesced packets, and adds them to @list. Returns FALSE if
+ * the packet was too small to skip the configured header */
+static gboolean
+gst_udpsrc_finish_batch_slot (GstUDPSrc * udpsrc, GstUDPSrcBatchSlot * slot,
+    gsize size, GstBufferList * list)
+{
+  GstBuffer *outbuf = slot->buffer;
+  gsize segment_size = 0;
+  gsize offset, skip;
+
+  slot->buffer = NULL;
+
+  if (slot->msgs || slot->n_msgs) {
+    gboolean keep;
+
+    keep = gst_udpsrc_handle_control_messages (udpsrc, slot->msgs,
+        slot->n_msgs, outbuf, &segment_size);
+    slot->msgs = NULL;
+    slot->n_msgs = 0;
+
+    if (!keep) {
+      GST_DEBUG_OBJECT (udpsrc,
+          "Dropping packet for a different multicast address");
+      g_clear_object (&slot->saddr);
+      /* put the buffer back so that the slot can be reused right away */
+      GST_BUFFER_DTS (outbuf) = GST_CLOCK_TIME_NONE;
+      slot->buffer = outbuf;
+      return TRUE;
+    }
+  }
+
+  /* Same as in fill(), the buffer will not go back to the pool */
+  if (size > udpsrc->mtu && slot->extra_mem) {
+    gst_buffer_append_memory (outbuf, slot->extra_mem);
+    slot->extra_mem = NULL;
+  }
+
+  if (slot->saddr) {
+    gst_buffer_add_net_address_meta (outbuf, slot->saddr);
+    g_clear_object (&slot->saddr);
+  }
+
+  skip = udpsrc->skip_first_bytes;
+
+  if (segment_size > udpsrc->gro_segment_size) {
+    GST_DEBUG_OBJECT (udpsrc, "GRO segment size %" G_GSIZE_FORMAT,
+        segment_size);
+    udpsrc->gro_segment_size = segment_size;
+  }
+
+  if (segment_size == 0 || segment_size >= size) {
+    if (G_UNLIKELY (skip > 0 && size < skip)) {
+      gst_buffer_unref (outbuf);
+      goto skip_error;
+    }
+
+    gst_buffer_resize (outbuf, skip, size - skip);
+    gst_buffer_list_add (list, outbuf);
+    return TRUE;
+  }
+
+  /* The kernel coalesced multiple datagrams of segment_size bytes (the last
+   * one possibly shorter), split them again into sub-buffers sharing the
+   * same memory */
+  GST_LOG_OBJECT (udpsrc, "splitting %" G_GSIZE_FORMAT " bytes into %"
+      G_GSIZE_FORMAT " byte segments", size, segment_size);
+
+  for (offset = 0; offset < size; offset += segment_size) {
+    gsize len = MIN (segment_size, size - offset);
+    GstBuffer *sub;
+
+    if (G_UNLIKELY (skip > 0 && len < skip)) {
+      gst_buffer_unref (outbuf);
+      goto skip_error;
+    }
+
+    sub = gst_buffer_copy_region (outbuf, GST_BUFFER_COPY_ALL,
+        offset + skip, len - skip);
+    gst_buffer_list_add (list, sub);
+  }
+  gst_buffer_unref (outbuf);
+
+  return TRUE;
+
+skip_error:
+  {
+    GST_ELEMENT_ERROR (udpsrc, STREAM, DECODE, (NULL),
+        ("UDP buffer to small to skip header"));
+    return FALSE;
+  }
+}
+
+static GstFlowReturn
+gst_udpsrc_create_batch (GstUDPSrc * udpsrc)
+{
+  GstBaseSrc *bsrc = GST_BASE_SRC_CAST (udpsrc);
+  GstBufferPool *pool;
+  GstAllocator *allocator = NULL;
+  GstAllocationParams params;
+  GstBufferList *list;
+  GstClock *clock;
+  GError *err = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstStructure *config;
+  gboolean needs_msgs;
+  gsize extra_size;
+  guint n_slots, n_prepared = 0, i;
+  gint n_received = 0;
+
+  gst_allocation_params_init (&params);
+
+  pool = gst_base_src_get_buffer_pool (bsrc);
+  if (G_UNLIKELY (pool == NULL))
+    goto no_pool;
+
+  if (udpsrc->n_batch_slots != MAX (udpsrc->batch_size, 1)) {
+    gst_udpsrc_free_batch_slots (udpsrc);
+    udpsrc->n_batch_slots = MAX (udpsrc->batch_size, 1);
+    udpsrc->batch_slots = g_new0 (GstUDPSrcBatchSlot, udpsrc->n_batch_slots);
+    udpsrc->batch_msgs = g_new0 (GInputMessage, udpsrc->n_batch_slots);
+  }
+  n_slots = udpsrc->n_batch_slots;
+
+  /* Memory for packets exceeding the mtu, only allocated for slots that
+   * don't have a matching one left from the previous batch */
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_get_allocator (config, &allocator, &params);
+  gst_structure_free (config);
+  extra_size = gst_udpsrc_batch_extra_size (udpsrc);
+
+  needs_msgs = gst_udpsrc_needs_control_messages (udpsrc);
+  list = gst_buffer_list_new_sized (n_slots);
+
+  do {
+    for (; n_prepared < n_slots; n_prepared++) {
+      GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[n_prepared];
+      GInputMessage *msg = &udpsrc->batch_msgs[n_prepared];
+
+      if (slot->buffer == NULL) {
+        ret = gst_buffer_pool_acquire_buffer (pool, &slot->buffer, NULL);
+        if (G_UNLIKELY (ret != GST_FLOW_OK))
+          goto acquire_error;
+      }
+
+      if (!gst_buffer_map (slot->buffer, &slot->map, GST_MAP_READWRITE))
+        goto map_error;
+
+      slot->vecs[0].buffer = slot->map.data;
+      slot->vecs[0].size = slot->map.size;
+
+      if (slot->extra_mem && slot->extra_mem->size != extra_size) {
+        gst_memory_unref (slot->extra_mem);
+        slot->extra_mem = NULL;
+      }
+      if (slot->extra_mem == NULL)
+        slot->extra_mem = gst_allocator_alloc (allocator, extra_size, &params);
+
+      if (!gst_memory_map (slot->extra_mem, &slot->extra_map,
+              GST_MAP_READWRITE)) {
+        gst_buffer_unmap (slot->buffer, &slot->map);
+        goto map_error;
+      }
+
+      slot->vecs[1].buffer = slot->extra_map.data;
+      slot->vecs[1].size = slot->extra_map.size;
+      msg->num_vectors = 2;
+
+      msg->address = udpsrc->retrieve_sender_address ? &slot->saddr : NULL;
+      msg->vectors = slot->vecs;
+      msg->bytes_received = 0;
+      msg->flags = G_SOCKET_MSG_NONE;
+      msg->control_messages = needs_msgs ? &slot->msgs : NULL;
+      msg->num_control_messages = needs_msgs ? &slot->n_msgs : NULL;
+    }
+
+    if (!gst_udpsrc_wait_readable (udpsrc, &err))
+      goto wait_error;
+
+    n_received =
+        g_socket_receive_messages (udpsrc->used_socket, udpsrc->batch_msgs,
+        n_slots, G_SOCKET_MSG_NONE, udpsrc->cancellable, &err);
+
+    if (G_UNLIKELY (n_received < 0)) {
+      /* See fill(), we ignore ICMP port unreachable responses */
+      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE) ||
+          g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED) ||
+          g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+        g_clear_error (&err);
+        continue;
+      }
+      goto receive_error;
+    }
+
+    GST_LOG_OBJECT (udpsrc, "received %d packets in one go", n_received);
+
+    gst_udpsrc_unmap_batch_slots (udpsrc, n_prepared, n_received);
+    n_prepared = 0;
+
+    for (i = 0; i < (guint) n_received; i++) {
+      if (!gst_udpsrc_finish_batch_slot (udpsrc, &udpsrc->batch_slots[i],
+              udpsrc->batch_msgs[i].bytes_received, list)) {
+        ret = GST_FLOW_ERROR;
+        goto done;
+      }
+    }
+  } while (gst_buffer_list_length (list) == 0);
+
+  /* basesrc only timestamps the first buffer of a list, give all packets
+   * received in one go the same capture time unless the socket timestamp
+   * provided a more accurate one */
+  clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+  if (clock) {
+    GstClockTime base_time, now;
+
+    now = gst_clock_get_time (clock);
+    base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+    gst_object_unref (clock);
+
+    if (now > base_time) {
+      guint len = gst_buffer_list_length (list);
+
+      for (i = 0; i < len; i++) {
+        GstBuffer *buf = gst_buffer_list_get (list, i);
+
+        if (!GST_BUFFER_DTS_IS_VALID (buf))
+          GST_BUFFER_DTS (buf) = now - base_time;
+      }
+    }
+  }
+
+  gst_base_src_submit_buffer_list (bsrc, list);
+  list = NULL;
+
+done:
+  gst_clear_buffer_list (&list);
+  if (allocator)
+    gst_object_unref (allocator);
+  gst_object_unref (pool);
+
+  return ret;
+
+  /* ERRORS */
+no_pool:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL), ("No buffer pool"));
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+acquire_error:
+  {
+    gst_udpsrc_unmap_batch_slots (udpsrc, n_prepared, 0);
+    GST_DEBUG_OBJECT (udpsrc, "failed to acquire buffer: %s",
+        gst_flow_get_name (ret));
+    goto done;
+  }
+map_error:
+  {
+    gst_udpsrc_unmap_batch_slots (udpsrc, n_prepared, 0);
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("Failed to map memory"));
+    ret = GST_FLOW_ERROR;
+    goto done;
+  }
+wait_error:
+  {
+    gst_udpsrc_unmap_batch_slots (udpsrc, n_prepared, 0);
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      GST_DEBUG ("stop called");
+      ret = GST_FLOW_FLUSHING;
+    } else {
+      GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+          ("select error: %s", err->message));
+      ret = GST_FLOW_ERROR;
+    }
+    g_clear_error (&err);
+    goto done;
+  }
+receive_error:
+  {
+    gst_udpsrc_unmap_batch_slots (udpsrc, n_prepared, 0);
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      ret = GST_FLOW_FLUSHING;
+    } else {
+      GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+          ("receive error: %s", err->message));
+      ret = GST_FLOW_ERROR;
+    }
+    g_clear_error (&err);
+    goto done;
+  }
+}
+
+static GstFlowReturn
+gst_udpsrc_create (GstBaseSrc * bsrc, guint64 offset, guint length,
+    GstBuffer ** buf)
+{
+  GstUDPSrc *udpsrc = GST_UDPSRC_CAST (bsrc);
+
+  /* GRO coalesced packets need to be split again, which is only done by the
+   * batched code path */
+  if ((udpsrc->batch_size <= 1 && !udpsrc->gro_enabled) || *buf != NULL)
+    return GST_BASE_SRC_CLASS (parent_class)->create (bsrc, offset, length,
+        buf);
+
+  return gst_udpsrc_create_batch (udpsrc);
+}
+
 static GstFlowReturn
 gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
 {
@@ -927,33 +1665,19 @@ gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
   GSocketAddress *saddr = NULL;
   GSocketAddress **p_saddr;
   gint flags = G_SOCKET_MSG_NONE;
-  gboolean try_again;
   GError *err = NULL;
   gssize res;
   gsize offset;
   GSocketControlMessage **msgs = NULL;
   GSocketControlMessage ***p_msgs;
-  gint n_msgs = 0, i;
+  gint n_msgs = 0;
   GstMapInfo info;
   GstMapInfo extra_info;
   GInputVector ivec[2];
 
   udpsrc = GST_UDPSRC_CAST (psrc);
 
-  /* optimization: use messages only in multicast mode and
-   * if we can't let the kernel do the filtering for us */
-  p_msgs =
-      (g_inet_address_get_is_multicast (g_inet_socket_address_get_address
-          (udpsrc->addr))) ? &msgs : NULL;
-#ifdef IP_MULTICAST_ALL
-  if (g_inet_address_get_family (g_inet_socket_address_get_address
-          (udpsrc->addr)) == G_SOCKET_FAMILY_IPV4)
-    p_msgs = NULL;
-#endif
-#ifdef SO_TIMESTAMPNS
-  if (udpsrc->socket_timestamp_mode == GST_SOCKET_TIMESTAMP_MODE_REALTIME)
-    p_msgs = &msgs;
-#endif
+  p_msgs = gst_udpsrc_needs_control_messages (udpsrc) ? &msgs : NULL;
 
   /* Retrieve sender address unless we've been configured not to do so */
   p_saddr = (udpsrc->retrieve_sender_address) ? &saddr : NULL;
@@ -996,37 +1720,12 @@ retry:
     saddr = NULL;
   }
 
-  do {
-    gint64 timeout;
-
-    try_again = FALSE;
-
-    if (udpsrc->timeout)
-      timeout = udpsrc->timeout / 1000;
-    else
-      timeout = -1;
-
-    GST_LOG_OBJECT (udpsrc, "doing select, timeout %" G_GINT64_FORMAT, timeout);
-
-    if (!g_socket_condition_timed_wait (udpsrc->used_socket, G_IO_IN | G_IO_PRI,
-            timeout, udpsrc->cancellable, &err)) {
-      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY)
-          || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
-        goto stopped;
-      } else if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_TIMED_OUT)) {
-        g_clear_error (&err);
-        /* timeout, post element message */
-        gst_element_post_message (GST_ELEMENT_CAST (udpsrc),
-            gst_message_new_element (GST_OBJECT_CAST (udpsrc),
-                gst_structure_new ("GstUDPSrcTimeout",
-                    "timeout", G_TYPE_UINT64, udpsrc->timeout, NULL)));
-      } else {
-        goto select_error;
-      }
-
-      try_again = TRUE;
-    }
-  } while (G_UNLIKELY (try_again));
+  if (!gst_udpsrc_wait_readable (udpsrc, &err)) {
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY)
+        || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+      goto stopped;
+    goto select_error;
+  }
 
   res =
       g_socket_receive_message (udpsrc->used_socket, p_saddr, ivec, 2,
@@ -1048,109 +1747,14 @@ retry:
   /* Retry if multicast and the destination address is not ours. We don't want
    * to receive arbitrary packets */
   if (p_msgs) {
-    GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
-    gboolean skip_packet = FALSE;
-    gsize iaddr_size = g_inet_address_get_native_size (iaddr);
-    const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
-
-    for (i = 0; i < n_msgs && !skip_packet; i++) {
-#ifdef IP_PKTINFO
-      if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef IPV6_PKTINFO
-      if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef IP_RECVDSTADDR
-      if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
-        GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef SO_TIMESTAMPNS
-      if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
-        GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
-        GstClock *clock;
-        GstClockTime socket_ts;
-
-        socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
-        GST_TRACE_OBJECT (udpsrc,
-            "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
-            GST_TIME_ARGS (socket_ts));
+    gboolean keep;
 
-        clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
-        if (clock != NULL) {
-          gint64 adjust_dts, cur_sys_time, delta;
-          GstClockTime base_time, cur_gst_clk_time, running_time;
+    keep = gst_udpsrc_handle_control_messages (udpsrc, msgs, n_msgs, outbuf,
+        NULL);
+    msgs = NULL;
+    n_msgs = 0;
 
-          /*
-           * We use g_get_real_time as the time reference for SCM timestamps
-           * is always CLOCK_REALTIME.
-           */
-          cur_sys_time = g_get_real_time () * GST_USECOND;
-          cur_gst_clk_time = gst_clock_get_time (clock);
-
-          delta = (gint64) cur_sys_time - (gint64) socket_ts;
-          if (delta < 0) {
-            /*
-             * The current system time will always be greater than the SCM
-             * timestamp as the packet would have been timestamped at least
-             * some clock cycles before. If it is not, then the system time
-             * was adjusted. Since we cannot rely on the delta calculation in
-             * such a case, set the DTS to current pipeline clock when this
-             * happens.
-             */
-            GST_LOG_OBJECT (udpsrc,
-                "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
-            GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-          } else {
-            base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
-            running_time = cur_gst_clk_time - base_time;
-            adjust_dts = (gint64) running_time - delta;
-            /*
-             * If the system time was adjusted much further ahead, we might
-             * end up with delta > cur_gst_clk_time. Set the DTS to current
-             * pipeline clock for this scenario as well.
-             */
-            if (adjust_dts < 0) {
-              GST_LOG_OBJECT (udpsrc,
-                  "Current system time much ahead in time, setting DTS to pipeline clock");
-              GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-            } else {
-              GST_BUFFER_DTS (outbuf) = adjust_dts;
-              GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
-                  GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
-            }
-          }
-          g_object_unref (clock);
-        } else {
-          GST_ERROR_OBJECT (udpsrc,
-              "Failed to get element clock, not setting DTS");
-        }
-      }
-#endif
-    }
-
-    for (i = 0; i < n_msgs; i++) {
-      g_object_unref (msgs[i]);
-    }
-    g_free (msgs);
-
-    if (skip_packet) {
+    if (!keep) {
       GST_DEBUG_OBJECT (udpsrc,
           "Dropping packet for a different multicast address");
       goto retry;
@@ -1425,6 +2029,12 @@ gst_udpsrc_set_property (GObject * object, guint prop_id, const GValue * value,
       }
       GST_OBJECT_UNLOCK (udpsrc);
       break;
+    case PROP_BATCH_SIZE:
+      udpsrc->batch_size = g_value_get_uint (value);
+      break;
+    case PROP_GRO:
+      udpsrc->gro = g_value_get_boolean (value);
+      break;
     default:
       break;
   }
@@ -1496,6 +2106,12 @@ gst_udpsrc_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_string (value, udpsrc->multicast_source);
       GST_OBJECT_UNLOCK (udpsrc);
       break;
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, udpsrc->batch_size);
+      break;
+    case PROP_GRO:
+      g_value_set_boolean (value, udpsrc->gro);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1866,6 +2482,23 @@ gst_udpsrc_open (GstUDPSrc * src)
   }
 #endif
 
+  src->gro_enabled = FALSE;
+  src->gro_segment_size = 0;
+  if (src->gro) {
+#ifdef UDP_GRO
+    if (!g_socket_set_option (src->used_socket, IPPROTO_UDP, UDP_GRO, TRUE,
+            &err)) {
+      GST_WARNING_OBJECT (src, "Failed to enable UDP_GRO: %s", err->message);
+      g_clear_error (&err);
+    } else {
+      GST_DEBUG_OBJECT (src, "UDP_GRO enabled");
+      src->gro_enabled = TRUE;
+    }
+#else
+    GST_WARNING_OBJECT (src, "gro was requested but UDP_GRO is not defined");
+#endif
+  }
+
   /* NOTE: sockaddr_in.sin_port works for ipv4 and ipv6 because sin_port
    * follows ss_family on both */
   {
@@ -2082,6 +2715,9 @@ gst_udpsrc_change_state (GstElement * element, GstStateChange transition)
     goto failure;
 
   switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_udpsrc_free_batch_slots (src);
+      break;
     case GST_STATE_CHANGE_READY_TO_NULL:
       gst_udpsrc_close (src);
       break;
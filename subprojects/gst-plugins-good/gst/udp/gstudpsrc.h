@@ -43,6 +43,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstUDPSrc GstUDPSrc;
 typedef struct _GstUDPSrcClass GstUDPSrcClass;
+typedef struct _GstUDPSrcBatchSlot GstUDPSrcBatchSlot;
 
 
 /**
@@ -100,6 +101,15 @@ struct _GstUDPSrc {
 
   gchar     *uri;
   GPtrArray *source_list;
+
+  /* batched receive, only used if batch_size > 1 */
+  guint      batch_size;
+  gboolean   gro;
+  gboolean   gro_enabled;
+  gsize      gro_segment_size;
+  GstUDPSrcBatchSlot *batch_slots;
+  GInputMessage *batch_msgs;
+  guint      n_batch_slots;
 };
 
 struct _GstUDPSrcClass {
@@ -244,6 +244,85 @@ GST_START_TEST (test_udpsink_dscp)
 
 GST_END_TEST;
 
+GST_START_TEST (test_udpsink_gso)
+{
+  GstSegment segment;
+  GstElement *udpsink;
+  GstPad *srcpad;
+  GstBufferList *list;
+  GSocket *socket;
+  GSocketAddress *addr;
+  GInetAddress *iaddr;
+  GError *error = NULL;
+  guint64 packets_served = 0, send_calls = 0;
+  gchar data[RTP_HEADER_SIZE + RTP_PAYLOAD_SIZE];
+  guint i, port;
+
+  /* receiving socket on a free local port */
+  socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM,
+      G_SOCKET_PROTOCOL_UDP, &error);
+  fail_unless (socket != NULL && error == NULL);
+  iaddr = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+  addr = g_inet_socket_address_new (iaddr, 0);
+  fail_unless (g_socket_bind (socket, addr, FALSE, NULL));
+  g_object_unref (addr);
+  g_object_unref (iaddr);
+  addr = g_socket_get_local_address (socket, NULL);
+  port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (addr));
+  g_object_unref (addr);
+  g_socket_set_timeout (socket, 5);
+
+  /* ten equally sized packets followed by a shorter one, which can all be
+   * sent with a single segmented send */
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 11; i++) {
+    gsize size = (i < 10) ? RTP_HEADER_SIZE + RTP_PAYLOAD_SIZE : 500;
+    GstBuffer *buf = gst_buffer_new_allocate (NULL, size, NULL);
+
+    gst_buffer_memset (buf, 0, i, size);
+    gst_buffer_list_add (list, buf);
+  }
+
+  udpsink = gst_check_setup_element ("udpsink");
+  g_object_set (udpsink, "host", "127.0.0.1", "port", port, "gso", TRUE, NULL);
+
+  srcpad = gst_check_setup_src_pad_by_name (udpsink, &srctemplate, "sink");
+
+  gst_element_set_state (udpsink, GST_STATE_PLAYING);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("hey there!"));
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  fail_unless_equals_int (gst_pad_push_list (srcpad, list), GST_FLOW_OK);
+
+  /* whether segmentation offload is available or not, the receiver has to
+   * see the individual datagrams */
+  for (i = 0; i < 11; i++) {
+    gssize received;
+
+    received = g_socket_receive (socket, data, sizeof (data), NULL, &error);
+    fail_unless (error == NULL);
+    fail_unless_equals_int (received,
+        (i < 10) ? RTP_HEADER_SIZE + RTP_PAYLOAD_SIZE : 500);
+    fail_unless_equals_int (data[0], i);
+  }
+
+  g_object_get (udpsink, "packets-served", &packets_served,
+      "send-calls", &send_calls, NULL);
+  fail_unless_equals_uint64 (packets_served, 11);
+  fail_unless (send_calls >= 1 && send_calls <= 11);
+
+  gst_check_teardown_pad_by_name (udpsink, "sink");
+  gst_check_teardown_element (udpsink);
+
+  g_object_unref (socket);
+}
+
+GST_END_TEST;
+
 static Suite *
 udpsink_suite (void)
 {
@@ -256,6 +335,7 @@ udpsink_suite (void)
   tcase_add_test (tc_chain, test_udpsink_bufferlist);
   tcase_add_test (tc_chain, test_udpsink_client_add_remove);
   tcase_add_test (tc_chain, test_udpsink_dscp);
+  tcase_add_test (tc_chain, test_udpsink_gso);
 
   return s;
 }
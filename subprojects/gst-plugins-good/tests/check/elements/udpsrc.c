@@ -17,6 +17,7 @@
  * Boston, MA 02110-1301, USA.
  */
 #include <gst/check/gstcheck.h>
+#include <gst/net/gstnetaddressmeta.h>
 #include <gio/gio.h>
 #include <stdlib.h>
 
@@ -25,24 +26,16 @@ static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS_ANY);
 
+/* creates a socket for sending to the port @udpsrc is bound to */
 static gboolean
-udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
-    GstPad ** sinkpad, GSocketAddress ** sa)
+udpsrc_socket_setup (GstElement * udpsrc, GSocket ** socket,
+    GSocketAddress ** sa)
 {
   GInetAddress *ia;
   int port = 0;
   gchar *s;
 
-  *udpsrc = gst_check_setup_element ("udpsrc");
-  fail_unless (*udpsrc != NULL);
-  g_object_set (*udpsrc, "port", 0, NULL);
-
-  *sinkpad = gst_check_setup_sink_pad_by_name (*udpsrc, &sinktemplate, "src");
-  fail_unless (*sinkpad != NULL);
-  gst_pad_set_active (*sinkpad, TRUE);
-
-  gst_element_set_state (*udpsrc, GST_STATE_PLAYING);
-  g_object_get (*udpsrc, "port", &port, NULL);
+  g_object_get (udpsrc, "port", &port, NULL);
   GST_INFO ("udpsrc port = %d", port);
 
   *socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM,
@@ -63,6 +56,23 @@ udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
   return TRUE;
 }
 
+static gboolean
+udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
+    GstPad ** sinkpad, GSocketAddress ** sa)
+{
+  *udpsrc = gst_check_setup_element ("udpsrc");
+  fail_unless (*udpsrc != NULL);
+  g_object_set (*udpsrc, "port", 0, NULL);
+
+  *sinkpad = gst_check_setup_sink_pad_by_name (*udpsrc, &sinktemplate, "src");
+  fail_unless (*sinkpad != NULL);
+  gst_pad_set_active (*sinkpad, TRUE);
+
+  gst_element_set_state (*udpsrc, GST_STATE_PLAYING);
+
+  return udpsrc_socket_setup (*udpsrc, socket, sa);
+}
+
 GST_START_TEST (test_udpsrc_empty_packet)
 {
   GSocketAddress *sa = NULL;
@@ -247,6 +257,85 @@ send_failure:
 
 GST_END_TEST;
 
+GST_START_TEST (test_udpsrc_batch)
+{
+  GSocketAddress *sa = NULL;
+  GstElement *udpsrc = NULL;
+  GSocket *socket = NULL;
+  GstPad *sinkpad = NULL;
+  GstBuffer *buf;
+  gchar data[3000];
+  int i, len = 0;
+  gssize sent;
+  GError *err = NULL;
+
+  for (i = 0; i < G_N_ELEMENTS (data); ++i)
+    data[i] = i & 0xff;
+
+  udpsrc = gst_check_setup_element ("udpsrc");
+  g_object_set (udpsrc, "port", 0, "batch-size", 4, NULL);
+
+  sinkpad = gst_check_setup_sink_pad_by_name (udpsrc, &sinktemplate, "src");
+  gst_pad_set_active (sinkpad, TRUE);
+
+  /* Packets are sent before going to PLAYING so that they are all queued
+   * in the socket and read in batches */
+  gst_element_set_state (udpsrc, GST_STATE_READY);
+
+  if (!udpsrc_socket_setup (udpsrc, &socket, &sa))
+    goto no_socket;
+
+  for (i = 0; i < 6; i++) {
+    gsize size = (i == 5) ? 3000 : 100 * (i + 1);
+
+    if ((sent = g_socket_send_to (socket, sa, data, size, NULL, &err)) == -1)
+      goto send_failure;
+    fail_unless_equals_int (sent, size);
+  }
+
+  gst_element_set_state (udpsrc, GST_STATE_PLAYING);
+
+  g_mutex_lock (&check_mutex);
+  len = g_list_length (buffers);
+  while (len < 6) {
+    g_cond_wait (&check_cond, &check_mutex);
+    len = g_list_length (buffers);
+    GST_INFO ("%u buffers", len);
+  }
+
+  for (i = 0; i < 5; i++) {
+    buf = GST_BUFFER (g_list_nth_data (buffers, i));
+    fail_unless_equals_int (gst_buffer_get_size (buf), 100 * (i + 1));
+    fail_unless (gst_buffer_get_net_address_meta (buf) != NULL);
+  }
+
+  /* bigger than the mtu, so made up of the pool buffer plus extra memory */
+  buf = GST_BUFFER (g_list_nth_data (buffers, 5));
+  fail_unless_equals_int (gst_buffer_get_size (buf), 3000);
+  fail_unless_equals_int (gst_buffer_n_memory (buf), 2);
+  fail_unless (gst_buffer_memcmp (buf, 0, data, 3000) == 0);
+
+  g_mutex_unlock (&check_mutex);
+
+no_socket:
+send_failure:
+  if (err) {
+    GST_WARNING ("Socket send error, skipping test: %s", err->message);
+    g_clear_error (&err);
+  }
+
+  gst_element_set_state (udpsrc, GST_STATE_NULL);
+
+  gst_check_drop_buffers ();
+  gst_check_teardown_pad_by_name (udpsrc, "src");
+  gst_check_teardown_element (udpsrc);
+
+  g_clear_object (&socket);
+  g_clear_object (&sa);
+}
+
+GST_END_TEST;
+
 static void
 on_multicast_source_updated (GObject * src, GParamSpec * pspec, guint * count)
 {
@@ -305,6 +394,7 @@ udpsrc_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_udpsrc_empty_packet);
   tcase_add_test (tc_chain, test_udpsrc);
+  tcase_add_test (tc_chain, test_udpsrc_batch);
   tcase_add_test (tc_chain, test_udpsrc_multicast_source);
 
   return s;
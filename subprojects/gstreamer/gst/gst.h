@@ -59,6 +59,7 @@
 #include <gst/gstiterator.h>
 #include <gst/gstmessage.h>
 #include <gst/gstmemory.h>
+#include <gst/gstmemorybudget.h>
 #include <gst/gstmeta.h>
 #include <gst/gstmetafactory.h>
 #include <gst/gstminiobject.h>
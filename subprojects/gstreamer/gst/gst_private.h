@@ -148,6 +148,20 @@ G_GNUC_INTERNAL  void  _priv_gst_caps_features_cleanup (void);
 G_GNUC_INTERNAL  void  _priv_gst_caps_cleanup (void);
 G_GNUC_INTERNAL  void  _priv_gst_debug_cleanup (void);
 G_GNUC_INTERNAL  void  _priv_gst_meta_cleanup (void);
+G_GNUC_INTERNAL  void  _priv_gst_freelists_cleanup (void);
+
+/* Per-thread caches of recently freed, equally sized allocations. Memory
+ * returned by _priv_gst_freelist_pop() is not cleared. */
+typedef enum {
+  GST_FREELIST_STRUCTURE,
+  GST_FREELIST_EVENT,
+  GST_FREELIST_QUERY,
+  GST_FREELIST_LAST
+} GstFreeListType;
+
+G_GNUC_INTERNAL  gpointer  _priv_gst_freelist_pop (GstFreeListType type);
+G_GNUC_INTERNAL  gboolean  _priv_gst_freelist_push (GstFreeListType type,
+                                                    gpointer mem);
 
 G_GNUC_INTERNAL  void  _priv_gst_object_call_async (GstObject * object,
                                                     GFunc func,
@@ -232,6 +246,13 @@ G_GNUC_INTERNAL
 void      __gst_element_factory_add_interface           (GstElementFactory    * elementfactory,
                                                          const gchar          * interfacename);
 
+G_GNUC_INTERNAL
+void      __gst_element_factory_ensure_details          (GstElementFactory    * elementfactory);
+
+G_GNUC_INTERNAL
+GBytes *  __gst_element_factory_get_cached_details      (GstElementFactory    * elementfactory,
+                                                         const gchar         ** details);
+
 /* used in gstvalue.c and gststructure.c */
 #define GST_ASCII_IS_STRING(c) (g_ascii_isalnum((c)) || ((c) == '_') || \
     ((c) == '-') || ((c) == '+') || ((c) == '/') || ((c) == ':') || \
@@ -490,6 +511,11 @@ struct _GstElementFactory {
 
   GList *               interfaces;             /* interface type names this element implements */
 
+  /* registry cache the fields above are loaded from on first use, or NULL
+   * once they are loaded */
+  GBytes *              cache;
+  const gchar *         cache_details;
+
   /*< private >*/
   gpointer _gst_reserved[GST_PADDING];
 };
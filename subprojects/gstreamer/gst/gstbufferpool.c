@@ -70,7 +70,7 @@
 #endif
 #include <sys/types.h>
 
-#include "gstvecdeque.h"
+#include "gstatomicqueue.h"
 #include "gstinfo.h"
 #include "gstvalue.h"
 
@@ -90,9 +90,12 @@ GST_DEBUG_CATEGORY_STATIC (gst_buffer_pool_debug);
 
 struct _GstBufferPoolPrivate
 {
+  /* free buffers, acquiring and releasing doesn't take a lock */
+  GstAtomicQueue *queue;
+  /* only used to wait for a free buffer */
   GMutex queue_lock;
   GCond queue_cond;
-  GstVecDeque *queue;
+  gint waiters;                 /* number of threads waiting on queue_cond */
 
   GRecMutex rec_lock;
 
@@ -159,7 +162,7 @@ gst_buffer_pool_init (GstBufferPool * pool)
 
   g_rec_mutex_init (&priv->rec_lock);
 
-  priv->queue = gst_vec_deque_new (16);
+  priv->queue = gst_atomic_queue_new (16);
   g_mutex_init (&priv->queue_lock);
   g_cond_init (&priv->queue_cond);
 
@@ -205,7 +208,7 @@ gst_buffer_pool_finalize (GObject * object)
 
   GST_DEBUG_OBJECT (pool, "%p finalize", pool);
 
-  gst_vec_deque_free (priv->queue);
+  gst_atomic_queue_unref (priv->queue);
   g_mutex_clear (&priv->queue_lock);
   g_cond_clear (&priv->queue_cond);
   gst_structure_free (priv->config);
@@ -392,6 +395,21 @@ do_start (GstBufferPool * pool)
   return TRUE;
 }
 
+/* wake up a thread waiting for a free buffer in acquire, if any */
+static inline void
+wake_waiter (GstBufferPool * pool)
+{
+  GstBufferPoolPrivate *priv = pool->priv;
+
+  /* waiters increment the counter with the lock held before checking the
+   * queue, so they either see our change or we see them waiting */
+  if (g_atomic_int_get (&priv->waiters) > 0) {
+    g_mutex_lock (&priv->queue_lock);
+    g_cond_signal (&priv->queue_cond);
+    g_mutex_unlock (&priv->queue_lock);
+  }
+}
+
 static void
 default_free_buffer (GstBufferPool * pool, GstBuffer * buffer)
 {
@@ -414,9 +432,7 @@ do_free_buffer (GstBufferPool * pool, GstBuffer * buffer)
   if (G_LIKELY (pclass->free_buffer))
     pclass->free_buffer (pool, buffer);
 
-  g_mutex_lock (&priv->queue_lock);
-  g_cond_signal (&priv->queue_cond);
-  g_mutex_unlock (&priv->queue_lock);
+  wake_waiter (pool);
 }
 
 /* must be called with the lock */
@@ -428,16 +444,12 @@ default_stop (GstBufferPool * pool)
   gboolean cleared;
 
   /* clear the pool */
-  g_mutex_lock (&priv->queue_lock);
-  while ((buffer = gst_vec_deque_pop_head (priv->queue))) {
-    g_mutex_unlock (&priv->queue_lock);
+  while ((buffer = gst_atomic_queue_pop (priv->queue))) {
     GST_TRACER_POOL_BUFFER_DEQUEUED (pool, buffer);
 
     do_free_buffer (pool, buffer);
-    g_mutex_lock (&priv->queue_lock);
   }
-  cleared = priv->cur_buffers == 0;
-  g_mutex_unlock (&priv->queue_lock);
+  cleared = g_atomic_int_get (&priv->cur_buffers) == 0;
 
   return cleared;
 }
@@ -1117,14 +1129,12 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
   GstFlowReturn result;
   GstBufferPoolPrivate *priv = pool->priv;
 
-  g_mutex_lock (&priv->queue_lock);
   while (TRUE) {
     if (G_UNLIKELY (GST_BUFFER_POOL_IS_FLUSHING (pool)))
       goto flushing;
 
     /* try to get a buffer from the queue */
-    *buffer = gst_vec_deque_pop_head (priv->queue);
-    g_mutex_unlock (&priv->queue_lock);
+    *buffer = gst_atomic_queue_pop (priv->queue);
 
     if (G_LIKELY (*buffer)) {
       GST_TRACER_POOL_BUFFER_DEQUEUED (pool, *buffer);
@@ -1152,13 +1162,16 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
 
     /* now we wait for a buffer release or flushing */
     g_mutex_lock (&priv->queue_lock);
-    while (gst_vec_deque_get_length (priv->queue) == 0
+    g_atomic_int_inc (&priv->waiters);
+    while (gst_atomic_queue_length (priv->queue) == 0
         && !GST_BUFFER_POOL_IS_FLUSHING (pool)
         && g_atomic_int_get (&priv->cur_buffers) >= priv->max_buffers) {
       GST_LOG_OBJECT (pool, "waiting for free buffers or flushing");
       g_cond_wait (&priv->queue_cond, &priv->queue_lock);
       GST_LOG_OBJECT (pool, "waited for free buffers or flushing");
     }
+    g_atomic_int_add (&priv->waiters, -1);
+    g_mutex_unlock (&priv->queue_lock);
   }
 
   return result;
@@ -1166,7 +1179,6 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
   /* ERRORS */
 flushing:
   {
-    g_mutex_unlock (&priv->queue_lock);
     GST_DEBUG_OBJECT (pool, "we are flushing");
     return GST_FLOW_FLUSHING;
   }
@@ -1310,10 +1322,8 @@ default_release_buffer (GstBufferPool * pool, GstBuffer * buffer)
     goto not_writable;
 
   /* keep it around in our queue */
-  g_mutex_lock (&pool->priv->queue_lock);
-  gst_vec_deque_push_tail (pool->priv->queue, buffer);
-  g_cond_signal (&pool->priv->queue_cond);
-  g_mutex_unlock (&pool->priv->queue_lock);
+  gst_atomic_queue_push (pool->priv->queue, buffer);
+  wake_waiter (pool);
 
   GST_TRACER_POOL_BUFFER_QUEUED (pool, buffer);
 
@@ -1340,11 +1350,8 @@ not_writable:
   }
 discard:
   {
+    /* this also wakes up a waiter */
     do_free_buffer (pool, buffer);
-
-    g_mutex_lock (&pool->priv->queue_lock);
-    g_cond_signal (&pool->priv->queue_cond);
-    g_mutex_unlock (&pool->priv->queue_lock);
     return;
   }
 }
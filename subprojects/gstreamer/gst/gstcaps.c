@@ -53,6 +53,12 @@
  * Various methods exist to work with the media types such as subtracting
  * or intersecting.
  *
+ * Caps that are used over and over again, such as the caps of pad templates,
+ * can be passed through gst_caps_intern(). Equal interned caps share a single
+ * immutable instance, and the results of gst_caps_is_subset(),
+ * gst_caps_can_intersect() and gst_caps_intersect_full() between interned
+ * caps are cached.
+ *
  * Be aware that until 1.20 the #GstCaps / #GstStructure serialization into string
  * had limited support for nested #GstCaps / #GstStructure fields. It could only
  * support one level of nesting. Using more levels would lead to unexpected
@@ -85,9 +91,15 @@ typedef struct _GstCapsImpl
   GstCaps caps;
 
   GArray *array;
+  /* non-zero for caps returned by gst_caps_intern() */
+  guint intern_id;
 } GstCapsImpl;
 
 #define GST_CAPS_ARRAY(c) (((GstCapsImpl *)(c))->array)
+#define GST_CAPS_INTERN_ID(c) (((GstCapsImpl *)(c))->intern_id)
+
+#define CAPS_ARE_INTERNED(c1,c2) \
+  (GST_CAPS_INTERN_ID (c1) != 0 && GST_CAPS_INTERN_ID (c2) != 0)
 
 #define GST_CAPS_LEN(c)   (GST_CAPS_ARRAY(c)->len)
 
@@ -126,6 +138,40 @@ typedef struct _GstCapsImpl
 /* lock to protect multiple invocations of static caps to caps conversion */
 G_LOCK_DEFINE_STATIC (static_caps_lock);
 
+/* interned caps, protected by intern_lock. Interned caps are never freed, so
+ * the table is bounded and further caps are not interned anymore once it is
+ * full */
+#define MAX_INTERNED_CAPS 4096
+
+G_LOCK_DEFINE_STATIC (intern_lock);
+static GHashTable *intern_table;
+static guint intern_id_counter;
+
+/* results of operations on interned caps. Interned caps are never freed
+ * before gst_deinit() and their ids are never reused, so the ids identify
+ * the caps. Entries are replaced on collision */
+#define CAPS_CACHE_SIZE 1024
+
+typedef enum
+{
+  CAPS_CACHE_OP_IS_SUBSET = 1,
+  CAPS_CACHE_OP_CAN_INTERSECT,
+  CAPS_CACHE_OP_INTERSECT_ZIG_ZAG,
+  CAPS_CACHE_OP_INTERSECT_FIRST,
+} GstCapsCacheOp;
+
+typedef struct
+{
+  GstCapsCacheOp op;
+  guint id1;
+  guint id2;
+  gboolean result;
+  GstCaps *caps;
+} GstCapsCacheEntry;
+
+G_LOCK_DEFINE_STATIC (caps_cache_lock);
+static GstCapsCacheEntry caps_cache[CAPS_CACHE_SIZE];
+
 static void gst_caps_transform_to_string (const GValue * src_value,
     GValue * dest_value);
 static gboolean gst_caps_from_string_inplace (GstCaps * caps,
@@ -153,6 +199,16 @@ _priv_gst_caps_initialize (void)
 void
 _priv_gst_caps_cleanup (void)
 {
+  guint i;
+
+  for (i = 0; i < CAPS_CACHE_SIZE; i++) {
+    if (caps_cache[i].caps)
+      gst_caps_unref (caps_cache[i].caps);
+  }
+  memset (caps_cache, 0, sizeof (caps_cache));
+
+  g_clear_pointer (&intern_table, g_hash_table_unref);
+
   gst_caps_unref (_gst_caps_any);
   _gst_caps_any = NULL;
   gst_caps_unref (_gst_caps_none);
@@ -241,6 +297,7 @@ gst_caps_init (GstCaps * caps)
    */
   GST_CAPS_ARRAY (caps) =
       g_array_new (FALSE, TRUE, sizeof (GstCapsArrayElement));
+  GST_CAPS_INTERN_ID (caps) = 0;
 }
 
 /**
@@ -1584,6 +1641,224 @@ gst_caps_set_simple_static_str (GstCaps * caps, const char *field, ...)
   va_end (var_args);
 }
 
+/* interning */
+
+/* Only hashes what gst_value_compare() can't consider equal for different
+ * representations, other values only contribute their type */
+static guint
+gst_caps_intern_value_hash (const GValue * value)
+{
+  GType type = G_VALUE_TYPE (value);
+  guint hash = g_direct_hash (GSIZE_TO_POINTER (type));
+
+  if (type == G_TYPE_STRING) {
+    const gchar *str = g_value_get_string (value);
+
+    hash ^= str ? g_str_hash (str) : 0;
+  } else if (type == G_TYPE_INT) {
+    hash ^= g_value_get_int (value) * 2654435761u;
+  } else if (type == G_TYPE_UINT) {
+    hash ^= g_value_get_uint (value) * 2654435761u;
+  } else if (type == G_TYPE_BOOLEAN) {
+    hash ^= g_value_get_boolean (value) ? 1 : 0;
+  }
+
+  return hash;
+}
+
+/* Must be the same for all caps that gst_caps_is_strictly_equal() considers
+ * equal. Structures are compared in order but their fields are not, so the
+ * field hashes are combined independently of their order */
+static guint
+gst_caps_intern_hash (gconstpointer key)
+{
+  const GstCaps *caps = key;
+  guint i, j, n, hash;
+
+  hash = CAPS_IS_ANY (caps) ? 1 : 0;
+  n = CAPS_IS_EMPTY_SIMPLE (caps) ? 0 : GST_CAPS_LEN (caps);
+
+  for (i = 0; i < n; i++) {
+    GstStructure *s = gst_caps_get_structure_unchecked (caps, i);
+    guint s_hash = g_str_hash (gst_structure_get_name (s));
+    guint n_fields = gst_structure_n_fields (s);
+
+    for (j = 0; j < n_fields; j++) {
+      const gchar *field = gst_structure_nth_field_name (s, j);
+
+      s_hash += g_str_hash (field) *
+          (gst_caps_intern_value_hash (gst_structure_get_value (s, field)) | 1);
+    }
+
+    hash = hash * 31 + s_hash;
+  }
+
+  return hash;
+}
+
+static gboolean
+gst_caps_intern_equal (gconstpointer a, gconstpointer b)
+{
+  return gst_caps_is_strictly_equal (a, b);
+}
+
+/**
+ * gst_caps_intern:
+ * @caps: (transfer full): a #GstCaps
+ *
+ * Returns the interned instance of @caps. All interned caps that are strictly
+ * equal are the same instance, which stays alive until gst_deinit() and can't
+ * be modified.
+ *
+ * The number of interned caps is limited. Once the limit is reached, new
+ * caps are returned as they are and gst_caps_is_interned() returns %FALSE
+ * for them.
+ *
+ * The results of gst_caps_is_subset(), gst_caps_can_intersect() and
+ * gst_caps_intersect_full() are cached when both caps are interned, which
+ * makes repeated negotiation against the same caps, like autoplugging against
+ * the pad templates of many element factories, a lot cheaper.
+ *
+ * Returns: (transfer full): the interned caps that are strictly equal to
+ *     @caps.
+ *
+ * Since: 1.30
+ */
+GstCaps *
+gst_caps_intern (GstCaps * caps)
+{
+  GstCaps *interned;
+
+  g_return_val_if_fail (GST_IS_CAPS (caps), NULL);
+
+  if (GST_CAPS_INTERN_ID (caps) != 0)
+    return caps;
+
+  G_LOCK (intern_lock);
+  if (G_UNLIKELY (intern_table == NULL)) {
+    intern_table = g_hash_table_new_full (gst_caps_intern_hash,
+        gst_caps_intern_equal, (GDestroyNotify) gst_caps_unref, NULL);
+  }
+
+  interned = g_hash_table_lookup (intern_table, caps);
+  if (interned == NULL
+      && g_hash_table_size (intern_table) >= MAX_INTERNED_CAPS) {
+    G_UNLOCK (intern_lock);
+
+    GST_CAT_DEBUG (GST_CAT_CAPS, "too many interned caps, not interning %"
+        GST_PTR_FORMAT, caps);
+
+    return caps;
+  }
+
+  if (interned == NULL) {
+    /* we can only take over the caps when nobody else can still change them,
+     * the table keeps a ref, so they are never writable again */
+    if (gst_caps_is_writable (caps))
+      interned = caps;
+    else
+      interned = _gst_caps_copy (caps);
+
+    GST_CAPS_INTERN_ID (interned) = ++intern_id_counter;
+    gst_caps_set_nested_may_be_leaked (interned);
+    g_hash_table_add (intern_table, interned);
+
+    GST_CAT_DEBUG (GST_CAT_CAPS, "interned caps %" GST_PTR_FORMAT " as %u",
+        interned, GST_CAPS_INTERN_ID (interned));
+
+    if (interned != caps)
+      gst_caps_ref (interned);
+  } else {
+    gst_caps_ref (interned);
+  }
+  G_UNLOCK (intern_lock);
+
+  if (interned != caps)
+    gst_caps_unref (caps);
+  else
+    gst_caps_ref (interned);
+
+  return interned;
+}
+
+/**
+ * gst_caps_is_interned:
+ * @caps: a #GstCaps
+ *
+ * Checks if @caps was returned by gst_caps_intern().
+ *
+ * Returns: %TRUE if @caps are interned.
+ *
+ * Since: 1.30
+ */
+gboolean
+gst_caps_is_interned (const GstCaps * caps)
+{
+  g_return_val_if_fail (GST_IS_CAPS (caps), FALSE);
+
+  return GST_CAPS_INTERN_ID (caps) != 0;
+}
+
+static inline GstCapsCacheEntry *
+caps_cache_entry (GstCapsCacheOp op, const GstCaps * caps1,
+    const GstCaps * caps2)
+{
+  guint hash;
+
+  hash = GST_CAPS_INTERN_ID (caps1) * 2654435761u;
+  hash ^= GST_CAPS_INTERN_ID (caps2) * 40503u;
+  hash ^= op * 97u;
+
+  return &caps_cache[hash & (CAPS_CACHE_SIZE - 1)];
+}
+
+/* caps1 and caps2 must be interned */
+static gboolean
+caps_cache_lookup (GstCapsCacheOp op, const GstCaps * caps1,
+    const GstCaps * caps2, gboolean * result, GstCaps ** caps)
+{
+  GstCapsCacheEntry *entry = caps_cache_entry (op, caps1, caps2);
+  gboolean found;
+
+  G_LOCK (caps_cache_lock);
+  found = entry->op == op && entry->id1 == GST_CAPS_INTERN_ID (caps1)
+      && entry->id2 == GST_CAPS_INTERN_ID (caps2);
+  if (found) {
+    if (result)
+      *result = entry->result;
+    if (caps)
+      *caps = gst_caps_ref (entry->caps);
+  }
+  G_UNLOCK (caps_cache_lock);
+
+  return found;
+}
+
+/* caps1 and caps2 must be interned */
+static void
+caps_cache_store (GstCapsCacheOp op, const GstCaps * caps1,
+    const GstCaps * caps2, gboolean result, GstCaps * caps)
+{
+  GstCapsCacheEntry *entry = caps_cache_entry (op, caps1, caps2);
+  GstCaps *old_caps;
+
+  /* kept alive by the cache until it is replaced or gst_deinit() */
+  if (caps)
+    gst_caps_set_nested_may_be_leaked (caps);
+
+  G_LOCK (caps_cache_lock);
+  old_caps = entry->caps;
+  entry->op = op;
+  entry->id1 = GST_CAPS_INTERN_ID (caps1);
+  entry->id2 = GST_CAPS_INTERN_ID (caps2);
+  entry->result = result;
+  entry->caps = caps ? gst_caps_ref (caps) : NULL;
+  G_UNLOCK (caps_cache_lock);
+
+  if (old_caps)
+    gst_caps_unref (old_caps);
+}
+
 /* tests */
 
 /**
@@ -1740,6 +2015,11 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
   if (CAPS_IS_ANY (subset) || CAPS_IS_EMPTY (superset))
     return FALSE;
 
+  if (CAPS_ARE_INTERNED (subset, superset) &&
+      caps_cache_lookup (CAPS_CACHE_OP_IS_SUBSET, subset, superset, &ret,
+          NULL))
+    return ret;
+
   for (i = GST_CAPS_LEN (subset) - 1; i >= 0; i--) {
     s1 = gst_caps_get_structure_unchecked (subset, i);
     f1 = gst_caps_get_features_unchecked (subset, i);
@@ -1768,6 +2048,9 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
     }
   }
 
+  if (CAPS_ARE_INTERNED (subset, superset))
+    caps_cache_store (CAPS_CACHE_OP_IS_SUBSET, subset, superset, ret, NULL);
+
   return ret;
 }
 
@@ -1931,18 +2214,8 @@ gst_caps_is_strictly_equal (const GstCaps * caps1, const GstCaps * caps2)
 
 /* intersect operation */
 
-/**
- * gst_caps_can_intersect:
- * @caps1: a #GstCaps to intersect
- * @caps2: a #GstCaps to intersect
- *
- * Tries intersecting @caps1 and @caps2 and reports whether the result would not
- * be empty
- *
- * Returns: %TRUE if intersection would be not empty
- */
-gboolean
-gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
+static gboolean
+gst_caps_can_intersect_zig_zag (const GstCaps * caps1, const GstCaps * caps2)
 {
   guint64 i;                    /* index can be up to 2 * G_MAX_UINT */
   guint j, k, len1, len2;
@@ -1951,21 +2224,6 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
   GstCapsFeatures *features1;
   GstCapsFeatures *features2;
 
-  g_return_val_if_fail (GST_IS_CAPS (caps1), FALSE);
-  g_return_val_if_fail (GST_IS_CAPS (caps2), FALSE);
-
-  /* caps are exactly the same pointers */
-  if (G_UNLIKELY (caps1 == caps2))
-    return TRUE;
-
-  /* empty caps on either side, return empty */
-  if (G_UNLIKELY (CAPS_IS_EMPTY (caps1) || CAPS_IS_EMPTY (caps2)))
-    return FALSE;
-
-  /* one of the caps is any */
-  if (G_UNLIKELY (CAPS_IS_ANY (caps1) || CAPS_IS_ANY (caps2)))
-    return TRUE;
-
   /* run zigzag on top line then right line, this preserves the caps order
    * much better than a simple loop.
    *
@@ -2017,6 +2275,48 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
   return FALSE;
 }
 
+/**
+ * gst_caps_can_intersect:
+ * @caps1: a #GstCaps to intersect
+ * @caps2: a #GstCaps to intersect
+ *
+ * Tries intersecting @caps1 and @caps2 and reports whether the result would not
+ * be empty
+ *
+ * Returns: %TRUE if intersection would be not empty
+ */
+gboolean
+gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
+{
+  gboolean ret;
+
+  g_return_val_if_fail (GST_IS_CAPS (caps1), FALSE);
+  g_return_val_if_fail (GST_IS_CAPS (caps2), FALSE);
+
+  /* caps are exactly the same pointers */
+  if (G_UNLIKELY (caps1 == caps2))
+    return TRUE;
+
+  /* empty caps on either side, return empty */
+  if (G_UNLIKELY (CAPS_IS_EMPTY (caps1) || CAPS_IS_EMPTY (caps2)))
+    return FALSE;
+
+  /* one of the caps is any */
+  if (G_UNLIKELY (CAPS_IS_ANY (caps1) || CAPS_IS_ANY (caps2)))
+    return TRUE;
+
+  if (!CAPS_ARE_INTERNED (caps1, caps2))
+    return gst_caps_can_intersect_zig_zag (caps1, caps2);
+
+  if (!caps_cache_lookup (CAPS_CACHE_OP_CAN_INTERSECT, caps1, caps2, &ret,
+          NULL)) {
+    ret = gst_caps_can_intersect_zig_zag (caps1, caps2);
+    caps_cache_store (CAPS_CACHE_OP_CAN_INTERSECT, caps1, caps2, ret, NULL);
+  }
+
+  return ret;
+}
+
 static GstCaps *
 gst_caps_intersect_zig_zag (GstCaps * caps1, GstCaps * caps2)
 {
@@ -2161,6 +2461,10 @@ GstCaps *
 gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
     GstCapsIntersectMode mode)
 {
+  GstCapsCacheOp op;
+  gboolean interned;
+  GstCaps *res;
+
   g_return_val_if_fail (GST_IS_CAPS (caps1), NULL);
   g_return_val_if_fail (GST_IS_CAPS (caps2), NULL);
 
@@ -2182,13 +2486,31 @@ gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
 
   switch (mode) {
     case GST_CAPS_INTERSECT_FIRST:
-      return gst_caps_intersect_first (caps1, caps2);
+      op = CAPS_CACHE_OP_INTERSECT_FIRST;
+      break;
     default:
       g_warning ("Unknown caps intersect mode: %d", mode);
       /* fallthrough */
     case GST_CAPS_INTERSECT_ZIG_ZAG:
-      return gst_caps_intersect_zig_zag (caps1, caps2);
+      op = CAPS_CACHE_OP_INTERSECT_ZIG_ZAG;
+      break;
   }
+
+  interned = CAPS_ARE_INTERNED (caps1, caps2);
+  if (interned && caps_cache_lookup (op, caps1, caps2, NULL, &res))
+    return res;
+
+  if (op == CAPS_CACHE_OP_INTERSECT_FIRST)
+    res = gst_caps_intersect_first (caps1, caps2);
+  else
+    res = gst_caps_intersect_zig_zag (caps1, caps2);
+
+  /* the cache shares the result, which makes it read-only just like the
+   * results of the fast paths above */
+  if (interned)
+    caps_cache_store (op, caps1, caps2, FALSE, res);
+
+  return res;
 }
 
 /**
@@ -537,6 +537,9 @@ GST_API
 gboolean          gst_caps_is_strictly_equal	   (const GstCaps *caps1,
 						    const GstCaps *caps2);
 
+GST_API
+gboolean          gst_caps_is_interned             (const GstCaps *caps);
+
 
 /* operations */
 
@@ -559,6 +562,9 @@ GstCaps *         gst_caps_simplify                (GstCaps *caps) G_GNUC_WARN_U
 GST_API
 GstCaps *         gst_caps_fixate                  (GstCaps *caps) G_GNUC_WARN_UNUSED_RESULT;
 
+GST_API
+GstCaps *         gst_caps_intern                  (GstCaps *caps) G_GNUC_WARN_UNUSED_RESULT;
+
 /* utility */
 
 GST_API
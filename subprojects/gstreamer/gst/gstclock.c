@@ -106,6 +106,7 @@
 
 #include "gstclock.h"
 #include "gstinfo.h"
+#include "gsttaskpool.h"
 #include "gstutils.h"
 #include "glib-compat-private.h"
 #include "gstsystemclock-private.h"
@@ -552,7 +553,10 @@ gst_clock_id_wait (GstClockID id, GstClockTimeDiff * jitter)
   if (G_UNLIKELY (cclass->wait == NULL))
     goto not_supported;
 
+  /* let a work stealing task pool run other tasks in the meantime */
+  gst_task_pool_blocking_begin ();
   res = cclass->wait (clock, entry, jitter);
+  gst_task_pool_blocking_end ();
 
   GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
       "done waiting entry %p, res: %d (%s)", id, res,
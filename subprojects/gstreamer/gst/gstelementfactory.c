@@ -61,6 +61,7 @@
 #include "gstinfo.h"
 #include "gsturi.h"
 #include "gstregistry.h"
+#include "gstregistrychunks.h"
 #include "gst.h"
 
 #include "glib-compat-private.h"
@@ -75,6 +76,9 @@ static void gst_element_factory_cleanup (GstElementFactory * factory);
 
 /* static guint gst_element_factory_signals[LAST_SIGNAL] = { 0 }; */
 
+/* protects loading the details of factories from the registry cache */
+static GMutex details_lock;
+
 /* this is defined in gstelement.c */
 extern GQuark __gst_elementclass_factory;
 extern GQuark __gst_elementclass_skip_doc;
@@ -151,6 +155,11 @@ gst_element_factory_cleanup (GstElementFactory * factory)
 {
   GList *item;
 
+  g_mutex_lock (&details_lock);
+  g_clear_pointer (&factory->cache, g_bytes_unref);
+  factory->cache_details = NULL;
+  g_mutex_unlock (&details_lock);
+
   if (factory->metadata) {
     gst_structure_free ((GstStructure *) factory->metadata);
     factory->metadata = NULL;
@@ -838,6 +847,65 @@ __gst_element_factory_add_static_pad_template (GstElementFactory * factory,
   factory->numpadtemplates++;
 }
 
+/*
+ * __gst_element_factory_ensure_details:
+ * @factory: a #GstElementFactory
+ *
+ * Deserializes the metadata, pad templates, URI handler details and
+ * interfaces of a factory that was loaded from the registry cache, if that
+ * didn't happen yet.
+ */
+void
+__gst_element_factory_ensure_details (GstElementFactory * factory)
+{
+  GBytes *cache;
+
+  if (G_LIKELY (g_atomic_pointer_get (&factory->cache) == NULL))
+    return;
+
+  g_mutex_lock (&details_lock);
+  cache = factory->cache;
+  if (cache) {
+    GST_LOG_OBJECT (factory, "loading details from the registry cache");
+    if (!_priv_gst_registry_chunks_load_element_details (factory, cache,
+            factory->cache_details)) {
+      GST_ERROR_OBJECT (factory, "Failed to load details from the registry "
+          "cache");
+    }
+    factory->cache_details = NULL;
+    g_atomic_pointer_set (&factory->cache, NULL);
+    g_bytes_unref (cache);
+  }
+  g_mutex_unlock (&details_lock);
+}
+
+/*
+ * __gst_element_factory_get_cached_details:
+ * @factory: a #GstElementFactory
+ * @details: (out): the position of the details in the cache
+ *
+ * Returns: (transfer full) (nullable): the registry cache the details of
+ * @factory still have to be loaded from, or %NULL if they are loaded.
+ */
+GBytes *
+__gst_element_factory_get_cached_details (GstElementFactory * factory,
+    const gchar ** details)
+{
+  GBytes *cache = NULL;
+
+  if (g_atomic_pointer_get (&factory->cache) == NULL)
+    return NULL;
+
+  g_mutex_lock (&details_lock);
+  if (factory->cache) {
+    cache = g_bytes_ref (factory->cache);
+    *details = factory->cache_details;
+  }
+  g_mutex_unlock (&details_lock);
+
+  return cache;
+}
+
 /**
  * gst_element_factory_get_element_type:
  * @factory: factory to get managed #GType from
@@ -873,6 +941,8 @@ gst_element_factory_get_metadata (GstElementFactory * factory,
 {
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
+  __gst_element_factory_ensure_details (factory);
+
   return gst_structure_get_string ((GstStructure *) factory->metadata, key);
 }
 
@@ -895,6 +965,8 @@ gst_element_factory_get_metadata_keys (GstElementFactory * factory)
 
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
+  __gst_element_factory_ensure_details (factory);
+
   metadata = (GstStructure *) factory->metadata;
   if (metadata == NULL)
     return NULL;
@@ -924,6 +996,8 @@ gst_element_factory_get_num_pad_templates (GstElementFactory * factory)
 {
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), 0);
 
+  __gst_element_factory_ensure_details (factory);
+
   return factory->numpadtemplates;
 }
 
@@ -962,6 +1036,8 @@ gst_element_factory_get_static_pad_templates (GstElementFactory * factory)
 {
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
+  __gst_element_factory_ensure_details (factory);
+
   return factory->staticpadtemplates;
 }
 
@@ -978,6 +1054,8 @@ gst_element_factory_get_uri_type (GstElementFactory * factory)
 {
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), GST_URI_UNKNOWN);
 
+  __gst_element_factory_ensure_details (factory);
+
   return factory->uri_type;
 }
 
@@ -998,6 +1076,8 @@ gst_element_factory_get_uri_protocols (GstElementFactory * factory)
 {
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
+  __gst_element_factory_ensure_details (factory);
+
   return (const gchar * const *) factory->uri_protocols;
 }
 
@@ -1018,6 +1098,8 @@ gst_element_factory_has_interface (GstElementFactory * factory,
 
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), FALSE);
 
+  __gst_element_factory_ensure_details (factory);
+
   for (walk = factory->interfaces; walk; walk = g_list_next (walk)) {
     gchar *iname = (gchar *) walk->data;
 
@@ -260,7 +260,24 @@ _gst_event_free (GstEvent * event)
   memset (event, 0xff, sizeof (GstEventImpl));
 #endif
 
-  g_free (event);
+  if (!_priv_gst_freelist_push (GST_FREELIST_EVENT, event))
+    g_free (event);
+}
+
+static GstEventImpl *
+gst_event_alloc (void)
+{
+  GstEventImpl *event;
+
+  /* high-rate serialized events are mostly created and freed again by the
+   * same streaming thread, reuse their memory */
+  event = _priv_gst_freelist_pop (GST_FREELIST_EVENT);
+  if (event)
+    memset (event, 0, sizeof (GstEventImpl));
+  else
+    event = g_new0 (GstEventImpl, 1);
+
+  return event;
 }
 
 static void gst_event_init (GstEventImpl * event, GstEventType type);
@@ -271,7 +288,7 @@ _gst_event_copy (GstEvent * event)
   GstEventImpl *copy;
   GstStructure *s;
 
-  copy = g_new0 (GstEventImpl, 1);
+  copy = gst_event_alloc ();
 
   gst_event_init (copy, GST_EVENT_TYPE (event));
 
@@ -331,7 +348,7 @@ gst_event_new_custom (GstEventType type, GstStructure * structure)
 {
   GstEventImpl *event;
 
-  event = g_new0 (GstEventImpl, 1);
+  event = gst_event_alloc ();
 
   GST_CAT_DEBUG (GST_CAT_EVENT, "creating new event %p %s %d", event,
       gst_event_type_get_name (type), type);
@@ -250,6 +250,8 @@ _gst_st_str (GstClockTimeDiff t, char *buf)
 #  define WIN32_LEAN_AND_MEAN   /* prevents from including too many things */
 #  include <windows.h>          /* GetStdHandle, windows console */
 #  include <processthreadsapi.h>        /* GetCurrentProcessId */
+#  include <io.h>               /* _write */
+#  define write(fd,buf,len) _write(fd,buf,(guint)(len))
 /* getpid() is not allowed in case of UWP, use GetCurrentProcessId() instead
  * which can be used on both desktop and UWP */
 #endif
@@ -4451,26 +4453,890 @@ gst_debug_print_stack_trace (void)
 }
 
 #ifndef GST_DISABLE_GST_DEBUG
+/* The ring buffer logger keeps a byte ring per thread that is only written by
+ * that thread, so logging does not take any locks. Records store a copy of
+ * the format string and the raw arguments, and the message is only formatted
+ * when the logs are fetched or a dump of them is decoded. */
+
+#define RING_BUFFER_DUMP_MAGIC "GSTRBLOG"
+#define RING_BUFFER_DUMP_VERSION 1
+
+/* block tags in a dump */
+#define RING_BUFFER_DUMP_THREAD 'T'
+#define RING_BUFFER_DUMP_RECORD 'R'
+#define RING_BUFFER_DUMP_END 'E'
+
+/* The owner of a log publishes a new tail before it overwrites the oldest
+ * records, and readers check the tail again after copying a record out, like
+ * a seqlock */
+#if defined(__GNUC__) || defined(__clang__)
+#define RING_BUFFER_RELEASE_FENCE() __atomic_thread_fence (__ATOMIC_RELEASE)
+#define RING_BUFFER_ACQUIRE_FENCE() __atomic_thread_fence (__ATOMIC_ACQUIRE)
+#elif defined(G_OS_WIN32)
+#define RING_BUFFER_RELEASE_FENCE() MemoryBarrier ()
+#define RING_BUFFER_ACQUIRE_FENCE() MemoryBarrier ()
+#else
+#error "No memory fences for this compiler"
+#endif
+
+/* argument tags in a record */
+#define RING_BUFFER_ARG_INT 'i'
+#define RING_BUFFER_ARG_DOUBLE 'd'
+#define RING_BUFFER_ARG_POINTER 'p'
+#define RING_BUFFER_ARG_STRING 's'
+#define RING_BUFFER_ARG_NULL_STRING 'n'
+
+#define RING_BUFFER_RECORD_HAS_ID (1 << 0)
+
+typedef struct
+{
+  /* size of the record including this header */
+  guint32 size;
+  guint32 line;
+  GstClockTime elapsed;
+  const gchar *category;
+  /* G_MAXUINT32 if the message was stored formatted already */
+  guint32 format_len;
+  guint16 file_len;
+  guint16 function_len;
+  guint16 object_id_len;
+  guint8 level;
+  guint8 flags;
+  /* followed by the file, the function and the object id, and then either
+   * the arguments and the format, or the message */
+} GstRingBufferRecord;
+
+typedef struct
+{
+  gchar magic[8];
+  guint32 version;
+  guint32 reserved;
+  guint64 pid;
+} GstRingBufferDumpHeader;
+
+typedef struct
+{
+  /* size of the data following this header */
+  guint32 size;
+  guint32 line;
+  guint64 elapsed;
+  guint32 category_len;
+  /* G_MAXUINT32 if there is no format */
+  guint32 format_len;
+  guint16 file_len;
+  guint16 function_len;
+  guint16 object_id_len;
+  guint8 level;
+  guint8 flags;
+  /* followed by the category name, the format and then the data following
+   * the header of the record */
+} GstRingBufferDumpRecord;
+
+typedef struct _GstRingBufferLog GstRingBufferLog;
+
+struct _GstRingBufferLog
+{
+  GstRingBufferLog *next;
+  GstTid thread;
+  GstClockTime last_use;
+  gint exited;
+
+  guint8 *data;
+  guint mask;
+
+  /* Positions of the oldest record and of the end of the newest record.
+   * They only grow and wrap around, and only the thread owning the log
+   * changes them. */
+  guint tail;
+  guint head;
+
+  /* used by the owning thread to put records together, and whether it is
+   * in use already because formatting an argument logged something */
+  GByteArray *scratch;
+  gboolean busy;
+};
+
 typedef struct
 {
   guint max_size_per_thread;
   guint thread_timeout;
-  GQueue threads;
-  GHashTable *thread_index;
+  guint generation;
+  GstRingBufferLog *logs;
+
+  /* records are copied in here by gst_debug_ring_buffer_logger_dump() */
+  guint8 *dump_buffer;
+  gint dumping;
 } GstRingBufferLogger;
 
 typedef struct
 {
-  GList *link;
-  gint64 last_use;
-  GstTid thread;
+  guint generation;
+  GstRingBufferLog *log;
+} GstRingBufferThread;
+
+typedef gboolean (*GstRingBufferWriteFunc) (gconstpointer data, gsize len,
+    gpointer user_data);
 
-  GstVecDeque *log;
-  gsize log_size;
-} GstRingBufferLog;
+static void gst_ring_buffer_thread_free (GstRingBufferThread * thread);
 
 G_LOCK_DEFINE_STATIC (ring_buffer_logger);
 static GstRingBufferLogger *ring_buffer_logger = NULL;
+static guint ring_buffer_logger_generation = 0;
+static GPrivate ring_buffer_thread =
+G_PRIVATE_INIT ((GDestroyNotify) gst_ring_buffer_thread_free);
+
+typedef enum
+{
+  RING_BUFFER_SIZE_DEFAULT,
+  RING_BUFFER_SIZE_CHAR,
+  RING_BUFFER_SIZE_SHORT,
+  RING_BUFFER_SIZE_LONG,
+  RING_BUFFER_SIZE_INT64,
+  RING_BUFFER_SIZE_INT32,
+  RING_BUFFER_SIZE_SIZE,
+  RING_BUFFER_SIZE_PTRDIFF,
+  RING_BUFFER_SIZE_LONG_DOUBLE,
+} GstRingBufferArgSize;
+
+typedef struct
+{
+  const gchar *flags;
+  gsize n_flags;
+  /* -1 if not given, RING_BUFFER_FROM_ARG if given as '*' */
+  gint width;
+  gint precision;
+  GstRingBufferArgSize size;
+  gchar conversion;
+  /* extension character of GStreamer's %p extensions */
+  gchar ext;
+} GstRingBufferConversion;
+
+#define RING_BUFFER_FROM_ARG (-2)
+
+/* Parses the conversion specification after a '%' at @p and returns the
+ * position after it, or %NULL for anything that can't be stored without
+ * formatting it, like positional or wide character arguments */
+static const gchar *
+ring_buffer_parse_conversion (const gchar * p, GstRingBufferConversion * conv)
+{
+  conv->flags = p;
+  while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0'
+      || *p == '\'')
+    p++;
+  conv->n_flags = p - conv->flags;
+
+  conv->width = -1;
+  if (*p == '*') {
+    conv->width = RING_BUFFER_FROM_ARG;
+    p++;
+  } else if (g_ascii_isdigit (*p)) {
+    conv->width = 0;
+    while (g_ascii_isdigit (*p) && conv->width < 100000)
+      conv->width = conv->width * 10 + (*p++ - '0');
+    if (*p == '$')
+      return NULL;
+  }
+
+  conv->precision = -1;
+  if (*p == '.') {
+    p++;
+    if (*p == '*') {
+      conv->precision = RING_BUFFER_FROM_ARG;
+      p++;
+    } else {
+      conv->precision = 0;
+      while (g_ascii_isdigit (*p) && conv->precision < 100000)
+        conv->precision = conv->precision * 10 + (*p++ - '0');
+    }
+  }
+
+  conv->size = RING_BUFFER_SIZE_DEFAULT;
+  switch (*p) {
+    case 'h':
+      p++;
+      if (*p == 'h') {
+        conv->size = RING_BUFFER_SIZE_CHAR;
+        p++;
+      } else {
+        conv->size = RING_BUFFER_SIZE_SHORT;
+      }
+      break;
+    case 'l':
+      p++;
+      if (*p == 'l') {
+        conv->size = RING_BUFFER_SIZE_INT64;
+        p++;
+      } else {
+        conv->size = RING_BUFFER_SIZE_LONG;
+      }
+      break;
+    case 'q':
+      conv->size = RING_BUFFER_SIZE_INT64;
+      p++;
+      break;
+    case 'L':
+      conv->size = RING_BUFFER_SIZE_LONG_DOUBLE;
+      p++;
+      break;
+    case 'z':
+      conv->size = RING_BUFFER_SIZE_SIZE;
+      p++;
+      break;
+    case 't':
+      conv->size = RING_BUFFER_SIZE_PTRDIFF;
+      p++;
+      break;
+    case 'I':
+      if (p[1] == '6' && p[2] == '4') {
+        conv->size = RING_BUFFER_SIZE_INT64;
+        p += 3;
+      } else if (p[1] == '3' && p[2] == '2') {
+        conv->size = RING_BUFFER_SIZE_INT32;
+        p += 3;
+      } else {
+        conv->size = RING_BUFFER_SIZE_SIZE;
+        p++;
+      }
+      break;
+    default:
+      break;
+  }
+
+  conv->conversion = *p;
+  conv->ext = '\0';
+  switch (*p) {
+    case 'd':
+    case 'i':
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'c':
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+    case 's':
+    case '%':
+      return p + 1;
+    case 'p':
+      if (p[1] == '\a' && p[2] != '\0') {
+        conv->ext = p[2];
+        return p + 3;
+      }
+      return p + 1;
+    case 'P':
+      /* old GST_PTR_FORMAT */
+      conv->conversion = 'p';
+      conv->ext = 'A';
+      return p + 1;
+    default:
+      return NULL;
+  }
+}
+
+static void
+ring_buffer_append_arg (GByteArray * out, guint8 type, gconstpointer value,
+    gsize len)
+{
+  g_byte_array_append (out, &type, 1);
+  if (len > 0)
+    g_byte_array_append (out, value, len);
+}
+
+static void
+ring_buffer_append_int (GByteArray * out, gint64 value)
+{
+  ring_buffer_append_arg (out, RING_BUFFER_ARG_INT, &value, sizeof (value));
+}
+
+static void
+ring_buffer_append_string (GByteArray * out, const gchar * str, gsize len)
+{
+  guint32 len32 = MIN (len, G_MAXUINT32);
+
+  if (str == NULL) {
+    ring_buffer_append_arg (out, RING_BUFFER_ARG_NULL_STRING, NULL, 0);
+    return;
+  }
+
+  ring_buffer_append_arg (out, RING_BUFFER_ARG_STRING, &len32, sizeof (len32));
+  g_byte_array_append (out, (const guint8 *) str, len32);
+}
+
+static gchar *
+ring_buffer_strdup_printf (const gchar * format, ...)
+{
+  va_list args;
+  gchar *str;
+
+  va_start (args, format);
+  GST_DISABLE_FORMAT_NONLITERAL_WARNING;
+  str = gst_info_strdup_vprintf (format, args);
+  GST_ENABLE_FORMAT_NONLITERAL_WARNING;
+  va_end (args);
+
+  return str;
+}
+
+/* Stores the arguments for @format in @out. Returns %FALSE if the format
+ * contains anything that has to be formatted right away. */
+static gboolean
+ring_buffer_capture_args (GByteArray * out, const gchar * format,
+    va_list * args)
+{
+  const gchar *p = format;
+
+  while ((p = strchr (p, '%'))) {
+    GstRingBufferConversion conv;
+    gint precision;
+
+    p = ring_buffer_parse_conversion (p + 1, &conv);
+    if (p == NULL)
+      return FALSE;
+
+    if (conv.width == RING_BUFFER_FROM_ARG)
+      ring_buffer_append_int (out, va_arg (*args, gint));
+    precision = conv.precision;
+    if (precision == RING_BUFFER_FROM_ARG) {
+      precision = va_arg (*args, gint);
+      ring_buffer_append_int (out, precision);
+    }
+
+    switch (conv.conversion) {
+      case '%':
+        break;
+      case 'd':
+      case 'i':{
+        gint64 v;
+
+        switch (conv.size) {
+          case RING_BUFFER_SIZE_DEFAULT:
+            v = va_arg (*args, gint);
+            break;
+          case RING_BUFFER_SIZE_CHAR:
+            v = (gint8) va_arg (*args, gint);
+            break;
+          case RING_BUFFER_SIZE_SHORT:
+            v = (gshort) va_arg (*args, gint);
+            break;
+          case RING_BUFFER_SIZE_LONG:
+            v = va_arg (*args, glong);
+            break;
+          case RING_BUFFER_SIZE_INT64:
+            v = va_arg (*args, gint64);
+            break;
+          case RING_BUFFER_SIZE_INT32:
+            v = va_arg (*args, gint32);
+            break;
+          case RING_BUFFER_SIZE_SIZE:
+            v = va_arg (*args, gssize);
+            break;
+          case RING_BUFFER_SIZE_PTRDIFF:
+            v = va_arg (*args, ptrdiff_t);
+            break;
+          default:
+            return FALSE;
+        }
+        ring_buffer_append_int (out, v);
+        break;
+      }
+      case 'o':
+      case 'u':
+      case 'x':
+      case 'X':{
+        guint64 v;
+
+        switch (conv.size) {
+          case RING_BUFFER_SIZE_DEFAULT:
+            v = va_arg (*args, guint);
+            break;
+          case RING_BUFFER_SIZE_CHAR:
+            v = (guint8) va_arg (*args, guint);
+            break;
+          case RING_BUFFER_SIZE_SHORT:
+            v = (gushort) va_arg (*args, guint);
+            break;
+          case RING_BUFFER_SIZE_LONG:
+            v = va_arg (*args, gulong);
+            break;
+          case RING_BUFFER_SIZE_INT64:
+            v = va_arg (*args, guint64);
+            break;
+          case RING_BUFFER_SIZE_INT32:
+            v = va_arg (*args, guint32);
+            break;
+          case RING_BUFFER_SIZE_SIZE:
+          case RING_BUFFER_SIZE_PTRDIFF:
+            v = va_arg (*args, gsize);
+            break;
+          default:
+            return FALSE;
+        }
+        ring_buffer_append_int (out, (gint64) v);
+        break;
+      }
+      case 'c':
+        if (conv.size != RING_BUFFER_SIZE_DEFAULT)
+          return FALSE;
+        ring_buffer_append_int (out, va_arg (*args, gint));
+        break;
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':{
+        gdouble v;
+
+        if (conv.size != RING_BUFFER_SIZE_DEFAULT
+            && conv.size != RING_BUFFER_SIZE_LONG)
+          return FALSE;
+        v = va_arg (*args, gdouble);
+        ring_buffer_append_arg (out, RING_BUFFER_ARG_DOUBLE, &v, sizeof (v));
+        break;
+      }
+      case 's':{
+        const gchar *str;
+        gsize len = 0;
+
+        if (conv.size != RING_BUFFER_SIZE_DEFAULT)
+          return FALSE;
+        str = va_arg (*args, const gchar *);
+        if (str && precision >= 0) {
+          /* the string does not have to be nul-terminated in this case */
+          while (len < (gsize) precision && str[len] != '\0')
+            len++;
+        } else if (str) {
+          len = strlen (str);
+        }
+        ring_buffer_append_string (out, str, len);
+        break;
+      }
+      case 'p':{
+        gpointer ptr;
+
+        if (conv.size != RING_BUFFER_SIZE_DEFAULT)
+          return FALSE;
+        ptr = va_arg (*args, gpointer);
+        if (conv.ext != '\0') {
+          gchar ext_format[] = { '%', 'p', '\a', conv.ext, '\0' };
+          gchar *str;
+
+          /* The objects might be gone by the time the logs are read, so the
+           * GStreamer specific formats are formatted now */
+          str = ring_buffer_strdup_printf (ext_format, ptr);
+          ring_buffer_append_string (out, str, str ? strlen (str) : 0);
+          g_free (str);
+        } else {
+          guint64 v = (guint64) (guintptr) ptr;
+
+          ring_buffer_append_arg (out, RING_BUFFER_ARG_POINTER, &v, sizeof (v));
+        }
+        break;
+      }
+      default:
+        return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+typedef struct
+{
+  const guint8 *data;
+  const guint8 *end;
+} GstRingBufferArgs;
+
+static gboolean
+ring_buffer_args_next (GstRingBufferArgs * args, guint8 type, guint64 * value)
+{
+  if (args->end - args->data < 1 + (gssize) sizeof (*value)
+      || args->data[0] != type)
+    return FALSE;
+
+  memcpy (value, args->data + 1, sizeof (*value));
+  args->data += 1 + sizeof (*value);
+  return TRUE;
+}
+
+static gboolean
+ring_buffer_args_next_string (GstRingBufferArgs * args, const gchar ** str,
+    guint32 * len)
+{
+  if (args->end - args->data < 1)
+    return FALSE;
+
+  if (args->data[0] == RING_BUFFER_ARG_NULL_STRING) {
+    *str = NULL;
+    *len = 0;
+    args->data++;
+    return TRUE;
+  }
+
+  if (args->data[0] != RING_BUFFER_ARG_STRING
+      || args->end - args->data < 1 + (gssize) sizeof (*len))
+    return FALSE;
+
+  memcpy (len, args->data + 1, sizeof (*len));
+  if ((gsize) (args->end - args->data) - 1 - sizeof (*len) < *len)
+    return FALSE;
+
+  *str = (const gchar *) args->data + 1 + sizeof (*len);
+  args->data += 1 + sizeof (*len) + *len;
+  return TRUE;
+}
+
+/* Uses GStreamer's printf implementation so that the output is the same as
+ * when formatting the message right away */
+static void
+ring_buffer_append_printf (GString * out, const gchar * format, ...)
+{
+  va_list args;
+  gchar *str;
+
+  va_start (args, format);
+  GST_DISABLE_FORMAT_NONLITERAL_WARNING;
+  str = gst_info_strdup_vprintf (format, args);
+  GST_ENABLE_FORMAT_NONLITERAL_WARNING;
+  va_end (args);
+
+  if (str)
+    g_string_append (out, str);
+  g_free (str);
+}
+
+/* Builds the specification for printing a single argument of @conv with the
+ * width and precision resolved, @modifier as length modifier and
+ * @conversion as conversion character */
+static void
+ring_buffer_build_spec (gchar * spec, gsize spec_size,
+    const GstRingBufferConversion * conv, gboolean has_width, gint width,
+    gint precision, const gchar * modifier, gchar conversion)
+{
+  gchar width_str[16] = "", precision_str[16] = "";
+
+  if (has_width)
+    g_snprintf (width_str, sizeof (width_str), "%d", width);
+  if (precision >= 0)
+    g_snprintf (precision_str, sizeof (precision_str), ".%d", precision);
+
+  g_snprintf (spec, spec_size, "%%%.*s%s%s%s%c", (gint) MIN (conv->n_flags,
+          8), conv->flags, width_str, precision_str, modifier, conversion);
+}
+
+/* Formats @format with the arguments stored by ring_buffer_capture_args() */
+static gboolean
+ring_buffer_render_message (GString * out, const gchar * format,
+    const guint8 * data, gsize len)
+{
+  GstRingBufferArgs args = { data, data + len };
+  const gchar *p = format, *next;
+
+  while ((next = strchr (p, '%'))) {
+    GstRingBufferConversion conv;
+    gchar spec[64];
+    gboolean has_width;
+    gint width, precision;
+    guint64 v;
+
+    g_string_append_len (out, p, next - p);
+
+    p = ring_buffer_parse_conversion (next + 1, &conv);
+    if (p == NULL)
+      return FALSE;
+
+    has_width = conv.width != -1;
+    width = conv.width;
+    if (width == RING_BUFFER_FROM_ARG) {
+      if (!ring_buffer_args_next (&args, RING_BUFFER_ARG_INT, &v))
+        return FALSE;
+      width = (gint) v;
+    }
+    precision = conv.precision;
+    if (precision == RING_BUFFER_FROM_ARG) {
+      if (!ring_buffer_args_next (&args, RING_BUFFER_ARG_INT, &v))
+        return FALSE;
+      precision = (gint) v;
+    }
+
+    switch (conv.conversion) {
+      case '%':
+        g_string_append_c (out, '%');
+        break;
+      case 'd':
+      case 'i':
+      case 'o':
+      case 'u':
+      case 'x':
+      case 'X':
+        if (!ring_buffer_args_next (&args, RING_BUFFER_ARG_INT, &v))
+          return FALSE;
+        ring_buffer_build_spec (spec, sizeof (spec), &conv, has_width, width,
+            precision, G_GINT64_MODIFIER, conv.conversion);
+        ring_buffer_append_printf (out, spec, v);
+        break;
+      case 'c':
+        if (!ring_buffer_args_next (&args, RING_BUFFER_ARG_INT, &v))
+          return FALSE;
+        ring_buffer_build_spec (spec, sizeof (spec), &conv, has_width, width,
+            -1, "", 'c');
+        ring_buffer_append_printf (out, spec, (gint) v);
+        break;
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':{
+        gdouble d;
+
+        if (!ring_buffer_args_next (&args, RING_BUFFER_ARG_DOUBLE, &v))
+          return FALSE;
+        memcpy (&d, &v, sizeof (d));
+        ring_buffer_build_spec (spec, sizeof (spec), &conv, has_width, width,
+            precision, "", conv.conversion);
+        ring_buffer_append_printf (out, spec, d);
+        break;
+      }
+      case 'p':
+        if (conv.ext == '\0') {
+          if (!ring_buffer_args_next (&args, RING_BUFFER_ARG_POINTER, &v))
+            return FALSE;
+          ring_buffer_build_spec (spec, sizeof (spec), &conv, has_width, width,
+              -1, "", 'p');
+          ring_buffer_append_printf (out, spec, (gpointer) (guintptr) v);
+          break;
+        }
+        /* GStreamer specific formats were stored as strings */
+        precision = -1;
+        /* fall through */
+      case 's':{
+        const gchar *str;
+        guint32 str_len;
+
+        if (!ring_buffer_args_next_string (&args, &str, &str_len))
+          return FALSE;
+        if (str == NULL) {
+          str = "(null)";
+          str_len = strlen (str);
+        }
+        /* the stored string is not nul-terminated */
+        if (precision < 0 || (guint32) precision > str_len)
+          precision = str_len;
+        ring_buffer_build_spec (spec, sizeof (spec), &conv, has_width, width,
+            precision, "", 's');
+        ring_buffer_append_printf (out, spec, str);
+        break;
+      }
+      default:
+        return FALSE;
+    }
+  }
+  g_string_append (out, p);
+
+  return TRUE;
+}
+
+static inline GstTid
+ring_buffer_thread_id (guint64 tid)
+{
+#if defined(G_OS_WIN32) || defined(__linux__) || defined(HAVE_GETTID)
+  return (GstTid) tid;
+#else
+  return (GstTid) (guintptr) tid;
+#endif
+}
+
+static gboolean
+ring_buffer_render_record (GString * out, guint64 pid, guint64 tid,
+    const GstRingBufferDumpRecord * record, const guint8 * data)
+{
+  gsize format_len, len;
+  gchar *category, *format = NULL, *file, *function, *object_id = NULL;
+  GString *message;
+
+  format_len = record->format_len == G_MAXUINT32 ? 0 : record->format_len;
+  len = (gsize) record->category_len + format_len + record->file_len +
+      record->function_len + record->object_id_len;
+  if (len > record->size)
+    return FALSE;
+
+  category = g_strndup ((const gchar *) data, record->category_len);
+  data += record->category_len;
+  if (record->format_len != G_MAXUINT32)
+    format = g_strndup ((const gchar *) data, format_len);
+  data += format_len;
+  file = g_strndup ((const gchar *) data, record->file_len);
+  data += record->file_len;
+  function = g_strndup ((const gchar *) data, record->function_len);
+  data += record->function_len;
+  if (record->flags & RING_BUFFER_RECORD_HAS_ID)
+    object_id = g_strndup ((const gchar *) data, record->object_id_len);
+  data += record->object_id_len;
+
+  message = g_string_new (NULL);
+  if (format) {
+    if (!ring_buffer_render_message (message, format, data, record->size - len))
+      g_string_append (message, " <invalid arguments>");
+  } else {
+    g_string_append_len (message, (const gchar *) data, record->size - len);
+  }
+
+  if (object_id) {
+    /* no color, all platforms */
+    g_string_append_printf (out, "%" GST_TIME_FORMAT NOCOLOR_PRINT_FMT_ID,
+        GST_TIME_ARGS (record->elapsed), (GstPid) pid,
+        ring_buffer_thread_id (tid), gst_debug_level_get_name (record->level),
+        category, file, record->line, function, object_id, message->str);
+  } else {
+    /* no color, all platforms */
+    g_string_append_printf (out, "%" GST_TIME_FORMAT NOCOLOR_PRINT_FMT,
+        GST_TIME_ARGS (record->elapsed), (GstPid) pid,
+        ring_buffer_thread_id (tid), gst_debug_level_get_name (record->level),
+        category, file, record->line, function, "", message->str);
+  }
+
+  g_string_free (message, TRUE);
+  g_free (object_id);
+  g_free (function);
+  g_free (file);
+  g_free (format);
+  g_free (category);
+
+  return TRUE;
+}
+
+static void
+ring_buffer_log_read (GstRingBufferLog * log, guint pos, gpointer dest,
+    gsize len)
+{
+  guint offset = pos & log->mask;
+  gsize first = MIN (len, (gsize) log->mask + 1 - offset);
+
+  memcpy (dest, log->data + offset, first);
+  memcpy ((guint8 *) dest + first, log->data, len - first);
+}
+
+static void
+ring_buffer_log_write (GstRingBufferLog * log, guint pos, gconstpointer src,
+    gsize len)
+{
+  guint offset = pos & log->mask;
+  gsize first = MIN (len, (gsize) log->mask + 1 - offset);
+
+  memcpy (log->data + offset, src, first);
+  memcpy (log->data, (const guint8 *) src + first, len - first);
+}
+
+static GstRingBufferLog *
+gst_ring_buffer_log_new (guint max_size)
+{
+  GstRingBufferLog *log = g_new0 (GstRingBufferLog, 1);
+  guint size = 1;
+
+  /* positions wrap around at G_MAXUINT, so the ring has to be a power of
+   * two while only max_size bytes of it are used */
+  while (size < max_size)
+    size <<= 1;
+
+  log->data = g_malloc (size);
+  log->mask = size - 1;
+  log->scratch = g_byte_array_new ();
+
+  return log;
+}
+
+static void
+gst_ring_buffer_log_free (GstRingBufferLog * log)
+{
+  g_byte_array_unref (log->scratch);
+  g_free (log->data);
+  g_free (log);
+}
+
+/* Returns the log of an exited thread with the same id as @tid, which then
+ * continues with its records, and removes the logs of other exited threads
+ * that saw no output since thread_timeout seconds. Must be called with the
+ * ring_buffer_logger lock. */
+static GstRingBufferLog *
+gst_ring_buffer_logger_reuse_exited_unlocked (GstRingBufferLogger * logger,
+    GstTid tid, GstClockTime now)
+{
+  GstRingBufferLog **link = &logger->logs;
+  GstRingBufferLog *reused = NULL;
+
+  while (*link) {
+    GstRingBufferLog *log = *link;
+
+    if (!g_atomic_int_get (&log->exited)) {
+      link = &log->next;
+    } else if (reused == NULL && log->thread == tid) {
+      g_atomic_int_set (&log->exited, 0);
+      reused = log;
+      link = &log->next;
+    } else if (logger->thread_timeout > 0
+        && log->last_use + logger->thread_timeout * GST_SECOND < now) {
+      g_atomic_pointer_set (link, log->next);
+      gst_ring_buffer_log_free (log);
+    } else {
+      link = &log->next;
+    }
+  }
+
+  return reused;
+}
+
+static GstRingBufferThread *
+gst_ring_buffer_logger_add_thread (GstRingBufferLogger * logger,
+    GstClockTime now)
+{
+  GstRingBufferThread *thread = g_private_get (&ring_buffer_thread);
+  GstTid tid = _get_thread_id ();
+  GstRingBufferLog *log;
+
+  if (thread == NULL) {
+    thread = g_new0 (GstRingBufferThread, 1);
+    g_private_set (&ring_buffer_thread, thread);
+  }
+
+  G_LOCK (ring_buffer_logger);
+  log = gst_ring_buffer_logger_reuse_exited_unlocked (logger, tid, now);
+  if (log == NULL) {
+    log = gst_ring_buffer_log_new (logger->max_size_per_thread);
+    log->thread = tid;
+    log->last_use = now;
+    log->next = logger->logs;
+    g_atomic_pointer_set (&logger->logs, log);
+  }
+  G_UNLOCK (ring_buffer_logger);
+
+  thread->generation = logger->generation;
+  thread->log = log;
+
+  return thread;
+}
+
+static void
+gst_ring_buffer_thread_free (GstRingBufferThread * thread)
+{
+  G_LOCK (ring_buffer_logger);
+  if (ring_buffer_logger
+      && ring_buffer_logger->generation == thread->generation)
+    g_atomic_int_set (&thread->log->exited, 1);
+  G_UNLOCK (ring_buffer_logger);
+
+  g_free (thread);
+}
 
 static void
 gst_ring_buffer_logger_log (GstDebugCategory * category,
@@ -4478,15 +5344,26 @@ gst_ring_buffer_logger_log (GstDebugCategory * category,
     gint line, GObject * object, GstDebugMessage * message, gpointer user_data)
 {
   GstRingBufferLogger *logger = user_data;
-  GstTid thread;
-  GstClockTime elapsed;
-  gchar c;
-  gchar *output;
-  gsize output_len;
+  GstRingBufferThread *thread;
+  GstRingBufferRecord record;
   GstRingBufferLog *log;
-  gint64 now = g_get_monotonic_time ();
-  const gchar *message_str = gst_debug_message_get (message);
-  const gchar *object_id = gst_debug_message_get_id (message);
+  GByteArray *scratch;
+  GstClockTime now;
+  const gchar *object_id;
+  gboolean expired;
+  guint head, tail;
+  gchar c;
+
+  now = gst_util_get_timestamp ();
+
+  thread = g_private_get (&ring_buffer_thread);
+  if (G_UNLIKELY (thread == NULL || thread->generation != logger->generation))
+    thread = gst_ring_buffer_logger_add_thread (logger, now);
+  log = thread->log;
+
+  expired = logger->thread_timeout > 0
+      && log->last_use + logger->thread_timeout * GST_SECOND < now;
+  log->last_use = now;
 
   /* __FILE__ might be a file name or an absolute path or a
    * relative path, irrespective of the exact compiler used,
@@ -4497,96 +5374,222 @@ gst_ring_buffer_logger_log (GstDebugCategory * category,
     file = gst_path_basename (file);
   }
 
-  elapsed = GST_CLOCK_DIFF (_priv_gst_start_time, gst_util_get_timestamp ());
-  thread = _get_thread_id ();
+  object_id = gst_debug_message_get_id (message);
+
+  record.line = line;
+  record.elapsed = GST_CLOCK_DIFF (_priv_gst_start_time, now);
+  record.category = gst_debug_category_get_name (category);
+  record.format_len = G_MAXUINT32;
+  record.file_len = MIN (strlen (file), G_MAXUINT16);
+  record.function_len = MIN (strlen (function), G_MAXUINT16);
+  record.object_id_len = object_id ? MIN (strlen (object_id), G_MAXUINT16) : 0;
+  record.level = level;
+  record.flags = object_id ? RING_BUFFER_RECORD_HAS_ID : 0;
+
+  scratch = log->busy ? g_byte_array_new () : log->scratch;
+  log->busy = TRUE;
+
+  g_byte_array_set_size (scratch, sizeof (record));
+  g_byte_array_append (scratch, (const guint8 *) file, record.file_len);
+  g_byte_array_append (scratch, (const guint8 *) function,
+      record.function_len);
+  if (object_id)
+    g_byte_array_append (scratch, (const guint8 *) object_id,
+        record.object_id_len);
 
-  if (object_id) {
-    /* no color, all platforms */
-    output =
-        g_strdup_printf ("%" GST_TIME_FORMAT NOCOLOR_PRINT_FMT_ID,
-        GST_TIME_ARGS (elapsed), _gst_getpid (), thread,
-        gst_debug_level_get_name (level),
-        gst_debug_category_get_name (category), file, line, function,
-        object_id, message_str);
-  } else {
-    /* no color, all platforms */
-    output =
-        g_strdup_printf ("%" GST_TIME_FORMAT NOCOLOR_PRINT_FMT,
-        GST_TIME_ARGS (elapsed), _gst_getpid (), thread,
-        gst_debug_level_get_name (level),
-        gst_debug_category_get_name (category), file, line, function, "",
-        message_str);
+  /* Only store the arguments if no other log function formatted the message
+   * already. The format is copied as callers can free it after logging. */
+  if (message->message == NULL) {
+    guint args_start = scratch->len;
+    gsize format_len = strlen (message->format);
+    va_list args;
+
+    G_VA_COPY (args, message->arguments);
+    if (format_len < G_MAXUINT32
+        && ring_buffer_capture_args (scratch, message->format, &args)) {
+      g_byte_array_append (scratch, (const guint8 *) message->format,
+          format_len);
+      record.format_len = format_len;
+    } else {
+      g_byte_array_set_size (scratch, args_start);
+    }
+    va_end (args);
   }
 
-  output_len = strlen (output);
+  if (record.format_len == G_MAXUINT32) {
+    const gchar *message_str = gst_debug_message_get (message);
 
+    if (message_str)
+      g_byte_array_append (scratch, (const guint8 *) message_str,
+          strlen (message_str));
+  }
 
-  G_LOCK (ring_buffer_logger);
+  record.size = scratch->len;
+  memcpy (scratch->data, &record, sizeof (record));
 
-  if (logger->thread_timeout > 0) {
-    gchar *buf;
+  head = log->head;
+  /* Drop everything logged before if the thread saw no output since
+   * thread_timeout seconds */
+  tail = expired ? head : log->tail;
 
-    /* Remove all threads that saw no output since thread_timeout seconds.
-     * By construction these are all at the tail of the queue, and the queue
-     * is ordered by last use, so we just need to look at the tail.
-     */
-    while (logger->threads.tail) {
-      log = logger->threads.tail->data;
-      if (log->last_use + logger->thread_timeout * G_USEC_PER_SEC >= now)
-        break;
+  if (record.size > logger->max_size_per_thread) {
+    /* Can't really write anything as the record is bigger than the maximum
+     * allowed log size already, so just remove everything */
+    g_atomic_int_set (&log->tail, head);
+    goto done;
+  }
 
-      g_hash_table_remove (logger->thread_index,
-          (gconstpointer) (gsize) log->thread);
-      while ((buf = gst_vec_deque_pop_head (log->log)))
-        g_free (buf);
-      gst_vec_deque_free (log->log);
-      g_free (log);
-      g_queue_pop_tail (&logger->threads);
-    }
+  /* Drop the oldest records to make space */
+  while (head - tail + record.size > logger->max_size_per_thread) {
+    guint32 size;
+
+    ring_buffer_log_read (log, tail, &size, sizeof (size));
+    tail += size;
   }
 
-  /* Get logger for this thread, and put it back at the
-   * head of the threads queue */
-  log =
-      g_hash_table_lookup (logger->thread_index,
-      (gconstpointer) (gsize) thread);
-  if (!log) {
-    log = g_new0 (GstRingBufferLog, 1);
-    log->log = gst_vec_deque_new (2048);
-    log->log_size = 0;
-    g_queue_push_head (&logger->threads, log);
-    log->link = logger->threads.head;
-    log->thread = thread;
-    g_hash_table_insert (logger->thread_index, (gpointer) (gsize) thread, log);
-  } else {
-    g_queue_unlink (&logger->threads, log->link);
-    g_queue_push_head_link (&logger->threads, log->link);
+  /* Publish the new tail before the dropped records are overwritten, so that
+   * readers copying them out at the same time notice */
+  if (tail != log->tail) {
+    g_atomic_int_set (&log->tail, tail);
+    RING_BUFFER_RELEASE_FENCE ();
   }
-  log->last_use = now;
 
-  if (output_len < logger->max_size_per_thread) {
-    gchar *buf;
+  ring_buffer_log_write (log, head, scratch->data, record.size);
+  g_atomic_int_set (&log->head, head + record.size);
+
+done:
+  if (scratch == log->scratch)
+    log->busy = FALSE;
+  else
+    g_byte_array_unref (scratch);
+}
+
+static gboolean
+ring_buffer_write_tag (guint8 tag, GstRingBufferWriteFunc func,
+    gpointer user_data)
+{
+  return func (&tag, 1, user_data);
+}
+
+/* Does not take any locks or allocate memory, so that it can be used from
+ * signal handlers. Records are copied into @buffer, which has space for
+ * max_size_per_thread bytes, before they are written out. */
+static gboolean
+gst_ring_buffer_logger_dump_full (GstRingBufferLogger * logger,
+    guint8 * buffer, GstRingBufferWriteFunc func, gpointer user_data)
+{
+  GstRingBufferDumpHeader header;
+  GstRingBufferLog *log;
+  GstClockTime now = gst_util_get_timestamp ();
+
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, RING_BUFFER_DUMP_MAGIC, sizeof (header.magic));
+  header.version = RING_BUFFER_DUMP_VERSION;
+  header.pid = _gst_getpid ();
+  if (!func (&header, sizeof (header), user_data))
+    return FALSE;
+
+  for (log = g_atomic_pointer_get (&logger->logs); log; log = log->next) {
+    guint64 tid = (guint64) (guintptr) log->thread;
+    guint pos, head;
+
+    if (logger->thread_timeout > 0
+        && log->last_use + logger->thread_timeout * GST_SECOND < now)
+      continue;
+
+    if (!ring_buffer_write_tag (RING_BUFFER_DUMP_THREAD, func, user_data)
+        || !func (&tid, sizeof (tid), user_data))
+      return FALSE;
+
+    pos = g_atomic_int_get (&log->tail);
+    head = g_atomic_int_get (&log->head);
+
+    while ((gint) (head - pos) > 0) {
+      GstRingBufferRecord record;
+      GstRingBufferDumpRecord dump;
+      guint tail, len, data_len, format_len;
+
+      /* The size might be garbage if the record is overwritten already,
+       * which is noticed below */
+      ring_buffer_log_read (log, pos, &record, sizeof (record));
+      len = record.size;
+      if (len < sizeof (record) || len > head - pos)
+        len = MIN (sizeof (record), head - pos);
+      ring_buffer_log_read (log, pos, buffer, len);
+
+      /* The owner publishes a new tail before overwriting records, so the
+       * copy is intact if the tail is not past it yet */
+      RING_BUFFER_ACQUIRE_FENCE ();
+      tail = g_atomic_int_get (&log->tail);
+      if ((gint) (pos - tail) < 0) {
+        pos = tail;
+        continue;
+      }
 
-    while (log->log_size + output_len > logger->max_size_per_thread) {
-      buf = gst_vec_deque_pop_head (log->log);
-      log->log_size -= strlen (buf);
-      g_free (buf);
+      memcpy (&record, buffer, MIN (sizeof (record), len));
+      if (len < sizeof (record) || record.size != len)
+        break;
+      data_len = record.size - sizeof (record);
+      format_len = record.format_len == G_MAXUINT32 ? 0 : record.format_len;
+      if ((guint64) record.file_len + record.function_len +
+          record.object_id_len + format_len > data_len)
+        break;
+      /* the format is at the end of the record but goes first in the dump */
+      data_len -= format_len;
+
+      dump.line = record.line;
+      dump.elapsed = record.elapsed;
+      dump.category_len = strlen (record.category);
+      dump.format_len = record.format_len;
+      dump.file_len = record.file_len;
+      dump.function_len = record.function_len;
+      dump.object_id_len = record.object_id_len;
+      dump.level = record.level;
+      dump.flags = record.flags;
+      dump.size = dump.category_len + format_len + data_len;
+
+      if (!ring_buffer_write_tag (RING_BUFFER_DUMP_RECORD, func, user_data)
+          || !func (&dump, sizeof (dump), user_data)
+          || !func (record.category, dump.category_len, user_data)
+          || !func (buffer + sizeof (record) + data_len, format_len,
+              user_data)
+          || !func (buffer + sizeof (record), data_len, user_data))
+        return FALSE;
+
+      pos += record.size;
     }
-    gst_vec_deque_push_tail (log->log, output);
-    log->log_size += output_len;
-  } else {
-    gchar *buf;
+  }
 
-    /* Can't really write anything as the line is bigger than the maximum
-     * allowed log size already, so just remove everything */
+  return ring_buffer_write_tag (RING_BUFFER_DUMP_END, func, user_data);
+}
+
+static gboolean
+ring_buffer_write_bytes (gconstpointer data, gsize len, gpointer user_data)
+{
+  g_byte_array_append (user_data, data, len);
 
-    while ((buf = gst_vec_deque_pop_head (log->log)))
-      g_free (buf);
-    g_free (output);
-    log->log_size = 0;
+  return TRUE;
+}
+
+static gboolean
+ring_buffer_write_fd (gconstpointer data, gsize len, gpointer user_data)
+{
+  gint fd = GPOINTER_TO_INT (user_data);
+  const guint8 *p = data;
+
+  while (len > 0) {
+    gssize written = write (fd, p, len);
+
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return FALSE;
+    }
+    p += written;
+    len -= written;
   }
 
-  G_UNLOCK (ring_buffer_logger);
+  return TRUE;
 }
 
 /**
@@ -4603,35 +5606,138 @@ gst_ring_buffer_logger_log (GstDebugCategory * category,
 gchar **
 gst_debug_ring_buffer_logger_get_logs (void)
 {
-  gchar **logs, **tmp;
-  GList *l;
+  GByteArray *dump;
+  guint8 *buffer;
+  gchar **logs;
 
   g_return_val_if_fail (ring_buffer_logger != NULL, NULL);
 
+  dump = g_byte_array_new ();
+
   G_LOCK (ring_buffer_logger);
+  buffer = g_malloc (ring_buffer_logger->max_size_per_thread);
+  gst_ring_buffer_logger_dump_full (ring_buffer_logger, buffer,
+      ring_buffer_write_bytes, dump);
+  G_UNLOCK (ring_buffer_logger);
+  g_free (buffer);
 
-  tmp = logs = g_new0 (gchar *, ring_buffer_logger->threads.length + 1);
-  for (l = ring_buffer_logger->threads.head; l; l = l->next) {
-    GstRingBufferLog *log = l->data;
-    gchar *p;
-    gsize n_lines, line_len;
+  logs = gst_debug_ring_buffer_logger_decode (dump->data, dump->len);
+  g_byte_array_unref (dump);
 
-    *tmp = p = g_new0 (gchar, log->log_size + 1);
+  return logs;
+}
 
-    n_lines = gst_vec_deque_get_length (log->log);
-    for (gsize i = 0; i < n_lines; i++) {
-      const gchar *line = gst_vec_deque_peek_nth (log->log, i);
-      line_len = strlen (line);
-      memcpy (p, line, line_len);
-      p += line_len;
-    }
+/**
+ * gst_debug_ring_buffer_logger_dump:
+ * @fd: the file descriptor to write to
+ *
+ * Writes the current logs of the ring buffer logger to @fd in a binary
+ * format. The messages are not formatted for this, so the dump is quick to
+ * write, and gst_debug_ring_buffer_logger_decode() or the
+ * gst-debug-decode-1.0 tool turn it into the usual text output.
+ *
+ * This does not take any locks or allocate memory, so it can be called from
+ * a signal handler, for example to write out the logs when the application
+ * crashes. It must not be called while the ring buffer logger is removed,
+ * and only one dump can be written at a time.
+ *
+ * Returns: %TRUE if the logs were written, %FALSE if there is no ring buffer
+ * logger, another dump is being written or writing to @fd failed
+ *
+ * Since: 1.30
+ */
+gboolean
+gst_debug_ring_buffer_logger_dump (gint fd)
+{
+  GstRingBufferLogger *logger = g_atomic_pointer_get (&ring_buffer_logger);
+  gboolean ret;
+
+  if (logger == NULL || !g_atomic_int_compare_and_exchange (&logger->dumping,
+          0, 1))
+    return FALSE;
+
+  ret = gst_ring_buffer_logger_dump_full (logger, logger->dump_buffer,
+      ring_buffer_write_fd, GINT_TO_POINTER (fd));
+  g_atomic_int_set (&logger->dumping, 0);
+
+  return ret;
+}
+
+/**
+ * gst_debug_ring_buffer_logger_decode:
+ * @data: (array length=size): a dump written by
+ *     gst_debug_ring_buffer_logger_dump()
+ * @size: the size of @data
+ *
+ * Formats the messages of a dump of the ring buffer logger. The result is the
+ * same as what gst_debug_ring_buffer_logger_get_logs() returned at the time
+ * of the dump. Dumps can only be decoded on machines with the same byte order
+ * and a truncated dump is decoded up to the last complete message.
+ *
+ * Returns: (transfer full) (array zero-terminated=1) (nullable):
+ * NULL-terminated array of strings with the debug output per thread, or
+ * %NULL if @data is not a dump of the ring buffer logger
+ *
+ * Since: 1.30
+ */
+gchar **
+gst_debug_ring_buffer_logger_decode (const guint8 * data, gsize size)
+{
+  GstRingBufferDumpHeader header;
+  GPtrArray *logs;
+  GString *log = NULL;
+  gsize pos;
+  guint64 tid = 0;
+
+  g_return_val_if_fail (data != NULL || size == 0, NULL);
+
+  if (size < sizeof (header))
+    return NULL;
+  memcpy (&header, data, sizeof (header));
+  if (memcmp (header.magic, RING_BUFFER_DUMP_MAGIC, sizeof (header.magic)) != 0
+      || header.version != RING_BUFFER_DUMP_VERSION)
+    return NULL;
+
+  logs = g_ptr_array_new ();
+
+  pos = sizeof (header);
+  while (pos < size) {
+    guint8 tag = data[pos++];
+
+    if (tag == RING_BUFFER_DUMP_THREAD) {
+      if (size - pos < sizeof (tid))
+        break;
+      memcpy (&tid, data + pos, sizeof (tid));
+      pos += sizeof (tid);
+
+      if (log)
+        g_ptr_array_add (logs, g_string_free (log, FALSE));
+      log = g_string_new (NULL);
+    } else if (tag == RING_BUFFER_DUMP_RECORD && log) {
+      GstRingBufferDumpRecord record;
 
-    tmp++;
+      if (size - pos < sizeof (record))
+        break;
+      memcpy (&record, data + pos, sizeof (record));
+      pos += sizeof (record);
+      if (size - pos < record.size)
+        break;
+
+      if (!ring_buffer_render_record (log, header.pid, tid, &record,
+              data + pos))
+        break;
+      pos += record.size;
+    } else {
+      /* end of the dump, or garbage */
+      break;
+    }
   }
 
-  G_UNLOCK (ring_buffer_logger);
+  if (log)
+    g_ptr_array_add (logs, g_string_free (log, FALSE));
+  g_ptr_array_add (logs, NULL);
 
-  return logs;
+  return (gchar **) g_ptr_array_free (logs, FALSE);
 }
 
 static void
@@ -4641,17 +5747,14 @@ gst_ring_buffer_logger_free (GstRingBufferLogger * logger)
   if (ring_buffer_logger == logger) {
     GstRingBufferLog *log;
 
-    while ((log = g_queue_pop_head (&logger->threads))) {
-      gchar *buf;
-      while ((buf = gst_vec_deque_pop_head (log->log)))
-        g_free (buf);
-      g_free (log);
+    while ((log = logger->logs)) {
+      logger->logs = log->next;
+      gst_ring_buffer_log_free (log);
     }
 
-    g_hash_table_unref (logger->thread_index);
-
+    g_free (logger->dump_buffer);
     g_free (logger);
-    ring_buffer_logger = NULL;
+    g_atomic_pointer_set (&ring_buffer_logger, NULL);
   }
   G_UNLOCK (ring_buffer_logger);
 }
@@ -4669,6 +5772,13 @@ gst_ring_buffer_logger_free (GstRingBufferLogger * logger)
  * logger can be removed again with gst_debug_remove_ring_buffer_logger().
  * Only one logger at a time is possible.
  *
+ * Since 1.30 each thread logs into its own ring without taking any locks, and
+ * messages are stored as their format string and arguments and are only
+ * formatted when the logs are fetched. @max_size_per_thread is the size of
+ * this binary representation. The logs can also be written out with
+ * gst_debug_ring_buffer_logger_dump(), which is safe to use from a signal
+ * handler.
+ *
  * Since: 1.14
  */
 void
@@ -4685,16 +5795,20 @@ gst_debug_add_ring_buffer_logger (guint max_size_per_thread,
     return;
   }
 
-  logger = ring_buffer_logger = g_new0 (GstRingBufferLogger, 1);
+  logger = g_new0 (GstRingBufferLogger, 1);
 
-  logger->max_size_per_thread = max_size_per_thread;
+  /* positions in the ring wrap around at G_MAXUINT */
+  logger->max_size_per_thread = MIN (max_size_per_thread, G_MAXINT / 2);
   logger->thread_timeout = thread_timeout;
-  logger->thread_index = g_hash_table_new (g_direct_hash, g_direct_equal);
-  g_queue_init (&logger->threads);
+  logger->generation = ++ring_buffer_logger_generation;
+  logger->dump_buffer = g_malloc (logger->max_size_per_thread);
+  g_atomic_pointer_set (&ring_buffer_logger, logger);
+  G_UNLOCK (ring_buffer_logger);
 
+  /* not under the lock as this logs itself, and the first message of a
+   * thread takes the lock */
   gst_debug_add_log_function (gst_ring_buffer_logger_log, logger,
       (GDestroyNotify) gst_ring_buffer_logger_free);
-  G_UNLOCK (ring_buffer_logger);
 }
 
 /**
@@ -4731,5 +5845,17 @@ gst_debug_remove_ring_buffer_logger (void)
 {
 }
 
+gboolean
+gst_debug_ring_buffer_logger_dump (gint fd)
+{
+  return FALSE;
+}
+
+gchar **
+gst_debug_ring_buffer_logger_decode (const guint8 * data, gsize size)
+{
+  return NULL;
+}
+
 #endif /* GST_REMOVE_DISABLED */
 #endif /* GST_DISABLE_GST_DEBUG */
@@ -1724,6 +1724,10 @@ GST_API
 void                  gst_debug_remove_ring_buffer_logger   (void);
 GST_API
 gchar **              gst_debug_ring_buffer_logger_get_logs (void);
+GST_API
+gboolean              gst_debug_ring_buffer_logger_dump     (gint fd);
+GST_API
+gchar **              gst_debug_ring_buffer_logger_decode   (const guint8 * data, gsize size);
 
 /**
  * GstLogContextHashFlags:
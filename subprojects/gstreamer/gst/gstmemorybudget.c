@@ -0,0 +1,719 @@
+/* GStreamer
+ *
+ * gstmemorybudget.c: Memory budget shared between queues
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * MT safe.
+ */
+
+/**
+ * SECTION:gstmemorybudget
+ * @title: GstMemoryBudget
+ * @short_description: Limit the memory held by a group of queues
+ * @see_also: #GstContext
+ *
+ * A #GstMemoryBudget limits the total number of bytes that a group of
+ * elements, typically the queue, queue2 and multiqueue elements of one or
+ * more pipelines, keep queued.
+ *
+ * Each element registers a #GstMemoryBudgetClient with a priority and keeps
+ * it updated with the number of bytes it holds. Every client is entitled to
+ * a share of the limit proportional to its priority. Clients can use more
+ * than their share while the budget is not exhausted. Once it is, clients
+ * that use more than their share block in gst_memory_budget_client_wait()
+ * until memory is released again. A client that holds nothing never blocks,
+ * so that streams that just started can always make progress.
+ *
+ * When a client has to wait, an element message with a
+ * `GstMemoryBudgetExhausted` structure is posted from its owner, containing
+ * the same fields as gst_memory_budget_get_stats() and the `client-used` and
+ * `client-share` of the blocked client.
+ *
+ * A budget can be set on elements directly or on a whole pipeline with a
+ * #GstContext of type #GST_MEMORY_BUDGET_CONTEXT_TYPE:
+ *
+ * |[<!-- language="C" -->
+ *   GstMemoryBudget *budget = gst_memory_budget_new (256 * 1024 * 1024);
+ *   GstContext *context;
+ *
+ *   context = gst_context_new (GST_MEMORY_BUDGET_CONTEXT_TYPE, TRUE);
+ *   gst_context_set_memory_budget (context, budget);
+ *   gst_element_set_context (pipeline, context);
+ *   gst_context_unref (context);
+ *   gst_object_unref (budget);
+ * ]|
+ *
+ * Since: 1.30
+ */
+
+#include "gst_private.h"
+
+#include "gstmemorybudget.h"
+#include "gstelement.h"
+#include "gstmessage.h"
+#include "gsttaskpool.h"
+#include "gstutils.h"
+
+GST_DEBUG_CATEGORY_STATIC (memory_budget_debug);
+#define GST_CAT_DEFAULT memory_budget_debug
+
+struct _GstMemoryBudgetClient
+{
+  GstMemoryBudget *budget;
+  GstObject *owner;
+
+  guint priority;
+  guint64 used;
+  gboolean flushing;
+};
+
+struct _GstMemoryBudgetPrivate
+{
+  GCond cond;
+
+  guint64 limit;
+  guint64 used;
+  guint64 peak;
+
+  GList *clients;
+  guint64 total_priority;
+  guint waiting;
+  guint64 blocked;
+};
+
+enum
+{
+  PROP_0,
+  PROP_LIMIT,
+  PROP_USED,
+  PROP_STATS,
+  PROP_LAST
+};
+
+static GParamSpec *properties[PROP_LAST];
+
+static void gst_memory_budget_finalize (GObject * object);
+static void gst_memory_budget_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_memory_budget_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
+#define _do_init \
+  GST_DEBUG_CATEGORY_INIT (memory_budget_debug, "memorybudget", 0, \
+      "memory budget");
+
+#define gst_memory_budget_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstMemoryBudget, gst_memory_budget, GST_TYPE_OBJECT,
+    G_ADD_PRIVATE (GstMemoryBudget) _do_init);
+
+static void
+gst_memory_budget_class_init (GstMemoryBudgetClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->finalize = gst_memory_budget_finalize;
+  gobject_class->set_property = gst_memory_budget_set_property;
+  gobject_class->get_property = gst_memory_budget_get_property;
+
+  /**
+   * GstMemoryBudget:limit:
+   *
+   * The number of bytes all clients together can hold before the clients
+   * that use more than their share are blocked, 0 for no limit.
+   *
+   * Since: 1.30
+   */
+  properties[PROP_LIMIT] =
+      g_param_spec_uint64 ("limit", "Limit",
+      "Number of bytes all clients can hold together (0=unlimited)",
+      0, G_MAXUINT64, 0, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GstMemoryBudget:used:
+   *
+   * The number of bytes all clients together currently hold.
+   *
+   * Since: 1.30
+   */
+  properties[PROP_USED] =
+      g_param_spec_uint64 ("used", "Used",
+      "Number of bytes all clients currently hold",
+      0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GstMemoryBudget:stats:
+   *
+   * Statistics about the budget, see gst_memory_budget_get_stats().
+   *
+   * Since: 1.30
+   */
+  properties[PROP_STATS] =
+      g_param_spec_boxed ("stats", "Stats", "Memory budget statistics",
+      GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (gobject_class, PROP_LAST, properties);
+}
+
+static void
+gst_memory_budget_init (GstMemoryBudget * budget)
+{
+  budget->priv = gst_memory_budget_get_instance_private (budget);
+
+  g_cond_init (&budget->priv->cond);
+}
+
+static void
+gst_memory_budget_finalize (GObject * object)
+{
+  GstMemoryBudget *budget = GST_MEMORY_BUDGET_CAST (object);
+
+  /* clients keep a reference to the budget */
+  g_assert (budget->priv->clients == NULL);
+
+  g_cond_clear (&budget->priv->cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_memory_budget_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstMemoryBudget *budget = GST_MEMORY_BUDGET_CAST (object);
+
+  switch (prop_id) {
+    case PROP_LIMIT:
+      gst_memory_budget_set_limit (budget, g_value_get_uint64 (value));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_memory_budget_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstMemoryBudget *budget = GST_MEMORY_BUDGET_CAST (object);
+
+  switch (prop_id) {
+    case PROP_LIMIT:
+      g_value_set_uint64 (value, gst_memory_budget_get_limit (budget));
+      break;
+    case PROP_USED:
+      g_value_set_uint64 (value, gst_memory_budget_get_used (budget));
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_memory_budget_get_stats (budget));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/* with the object lock */
+static guint64
+gst_memory_budget_get_share_unlocked (GstMemoryBudget * budget,
+    GstMemoryBudgetClient * client)
+{
+  GstMemoryBudgetPrivate *priv = budget->priv;
+
+  if (priv->limit == 0)
+    return G_MAXUINT64;
+
+  return gst_util_uint64_scale (priv->limit, client->priority,
+      priv->total_priority);
+}
+
+/* with the object lock */
+static gboolean
+gst_memory_budget_is_exhausted_unlocked (GstMemoryBudget * budget,
+    GstMemoryBudgetClient * client)
+{
+  GstMemoryBudgetPrivate *priv = budget->priv;
+
+  if (priv->limit == 0 || priv->used < priv->limit || client->used == 0)
+    return FALSE;
+
+  return client->used >= gst_memory_budget_get_share_unlocked (budget, client);
+}
+
+/* with the object lock */
+static void
+gst_memory_budget_wake_unlocked (GstMemoryBudget * budget)
+{
+  if (budget->priv->waiting > 0)
+    g_cond_broadcast (&budget->priv->cond);
+}
+
+/**
+ * gst_memory_budget_new:
+ * @limit: the number of bytes all clients can hold, 0 for no limit
+ *
+ * Creates a new memory budget.
+ *
+ * Returns: (transfer full): a new #GstMemoryBudget
+ *
+ * Since: 1.30
+ */
+GstMemoryBudget *
+gst_memory_budget_new (guint64 limit)
+{
+  GstMemoryBudget *budget;
+
+  budget = g_object_new (GST_TYPE_MEMORY_BUDGET, "limit", limit, NULL);
+  gst_object_ref_sink (budget);
+
+  return budget;
+}
+
+/**
+ * gst_memory_budget_set_limit:
+ * @budget: a #GstMemoryBudget
+ * @limit: the number of bytes all clients can hold, 0 for no limit
+ *
+ * Changes the limit of @budget. Clients that are waiting are woken up when
+ * the limit is raised.
+ *
+ * Since: 1.30
+ */
+void
+gst_memory_budget_set_limit (GstMemoryBudget * budget, guint64 limit)
+{
+  g_return_if_fail (GST_IS_MEMORY_BUDGET (budget));
+
+  GST_OBJECT_LOCK (budget);
+  GST_DEBUG_OBJECT (budget, "limit %" G_GUINT64_FORMAT, limit);
+  budget->priv->limit = limit;
+  gst_memory_budget_wake_unlocked (budget);
+  GST_OBJECT_UNLOCK (budget);
+}
+
+/**
+ * gst_memory_budget_get_limit:
+ * @budget: a #GstMemoryBudget
+ *
+ * Returns: the limit of @budget in bytes, 0 for no limit
+ *
+ * Since: 1.30
+ */
+guint64
+gst_memory_budget_get_limit (GstMemoryBudget * budget)
+{
+  guint64 limit;
+
+  g_return_val_if_fail (GST_IS_MEMORY_BUDGET (budget), 0);
+
+  GST_OBJECT_LOCK (budget);
+  limit = budget->priv->limit;
+  GST_OBJECT_UNLOCK (budget);
+
+  return limit;
+}
+
+/**
+ * gst_memory_budget_get_used:
+ * @budget: a #GstMemoryBudget
+ *
+ * Returns: the number of bytes all clients of @budget currently hold
+ *
+ * Since: 1.30
+ */
+guint64
+gst_memory_budget_get_used (GstMemoryBudget * budget)
+{
+  guint64 used;
+
+  g_return_val_if_fail (GST_IS_MEMORY_BUDGET (budget), 0);
+
+  GST_OBJECT_LOCK (budget);
+  used = budget->priv->used;
+  GST_OBJECT_UNLOCK (budget);
+
+  return used;
+}
+
+/* with the object lock */
+static GstStructure *
+gst_memory_budget_get_stats_unlocked (GstMemoryBudget * budget,
+    const gchar * name)
+{
+  GstMemoryBudgetPrivate *priv = budget->priv;
+
+  return gst_structure_new (name,
+      "limit", G_TYPE_UINT64, priv->limit,
+      "used", G_TYPE_UINT64, priv->used,
+      "peak", G_TYPE_UINT64, priv->peak,
+      "clients", G_TYPE_UINT, g_list_length (priv->clients),
+      "waiting", G_TYPE_UINT, priv->waiting,
+      "blocked", G_TYPE_UINT64, priv->blocked, NULL);
+}
+
+/**
+ * gst_memory_budget_get_stats:
+ * @budget: a #GstMemoryBudget
+ *
+ * Gets statistics about @budget in a `GstMemoryBudgetStats` structure with
+ * these fields:
+ *
+ * - `limit` (#G_TYPE_UINT64): the limit in bytes
+ * - `used` (#G_TYPE_UINT64): the bytes all clients hold
+ * - `peak` (#G_TYPE_UINT64): the highest value `used` had
+ * - `clients` (#G_TYPE_UINT): the number of clients
+ * - `waiting` (#G_TYPE_UINT): the number of clients that are waiting
+ * - `blocked` (#G_TYPE_UINT64): how many times a client had to wait
+ *
+ * Returns: (transfer full): the statistics of @budget
+ *
+ * Since: 1.30
+ */
+GstStructure *
+gst_memory_budget_get_stats (GstMemoryBudget * budget)
+{
+  GstStructure *s;
+
+  g_return_val_if_fail (GST_IS_MEMORY_BUDGET (budget), NULL);
+
+  GST_OBJECT_LOCK (budget);
+  s = gst_memory_budget_get_stats_unlocked (budget, "GstMemoryBudgetStats");
+  GST_OBJECT_UNLOCK (budget);
+
+  return s;
+}
+
+/**
+ * gst_memory_budget_client_new:
+ * @budget: a #GstMemoryBudget
+ * @owner: (transfer none) (nullable): the object holding the memory
+ * @priority: the relative share of @budget the client is entitled to
+ *
+ * Registers a new client with @budget. @owner is used for debugging and for
+ * posting messages when it is a #GstElement, it has to stay alive for as long
+ * as the client exists.
+ *
+ * Returns: (transfer full): a new #GstMemoryBudgetClient, free with
+ *     gst_memory_budget_client_free()
+ *
+ * Since: 1.30
+ */
+GstMemoryBudgetClient *
+gst_memory_budget_client_new (GstMemoryBudget * budget, GstObject * owner,
+    guint priority)
+{
+  GstMemoryBudgetClient *client;
+
+  g_return_val_if_fail (GST_IS_MEMORY_BUDGET (budget), NULL);
+
+  client = g_new0 (GstMemoryBudgetClient, 1);
+  client->budget = gst_object_ref (budget);
+  client->owner = owner;
+  client->priority = MAX (priority, 1);
+
+  GST_OBJECT_LOCK (budget);
+  budget->priv->clients = g_list_prepend (budget->priv->clients, client);
+  budget->priv->total_priority += client->priority;
+  GST_DEBUG_OBJECT (budget, "added client for %" GST_PTR_FORMAT
+      " with priority %u", owner, client->priority);
+  gst_memory_budget_wake_unlocked (budget);
+  GST_OBJECT_UNLOCK (budget);
+
+  return client;
+}
+
+/**
+ * gst_memory_budget_client_free:
+ * @client: (transfer full): a #GstMemoryBudgetClient
+ *
+ * Unregisters @client and releases the memory it accounted for. No other
+ * thread may be waiting on @client.
+ *
+ * Since: 1.30
+ */
+void
+gst_memory_budget_client_free (GstMemoryBudgetClient * client)
+{
+  GstMemoryBudget *budget;
+
+  g_return_if_fail (client != NULL);
+
+  budget = client->budget;
+
+  GST_OBJECT_LOCK (budget);
+  budget->priv->clients = g_list_remove (budget->priv->clients, client);
+  budget->priv->total_priority -= client->priority;
+  budget->priv->used -= client->used;
+  GST_DEBUG_OBJECT (budget, "removed client for %" GST_PTR_FORMAT,
+      client->owner);
+  gst_memory_budget_wake_unlocked (budget);
+  GST_OBJECT_UNLOCK (budget);
+
+  gst_object_unref (budget);
+  g_free (client);
+}
+
+/**
+ * gst_memory_budget_client_set_priority:
+ * @client: a #GstMemoryBudgetClient
+ * @priority: the relative share of the budget the client is entitled to
+ *
+ * Changes the priority of @client. A @priority of 0 is handled like 1.
+ *
+ * Since: 1.30
+ */
+void
+gst_memory_budget_client_set_priority (GstMemoryBudgetClient * client,
+    guint priority)
+{
+  GstMemoryBudget *budget;
+
+  g_return_if_fail (client != NULL);
+
+  budget = client->budget;
+  priority = MAX (priority, 1);
+
+  GST_OBJECT_LOCK (budget);
+  budget->priv->total_priority -= client->priority;
+  budget->priv->total_priority += priority;
+  client->priority = priority;
+  gst_memory_budget_wake_unlocked (budget);
+  GST_OBJECT_UNLOCK (budget);
+}
+
+/**
+ * gst_memory_budget_client_set_used:
+ * @client: a #GstMemoryBudgetClient
+ * @used: the number of bytes the client holds
+ *
+ * Updates the number of bytes @client holds. This never blocks and can be
+ * called with the locks of the owner held.
+ *
+ * Since: 1.30
+ */
+void
+gst_memory_budget_client_set_used (GstMemoryBudgetClient * client,
+    guint64 used)
+{
+  GstMemoryBudget *budget;
+  GstMemoryBudgetPrivate *priv;
+
+  g_return_if_fail (client != NULL);
+
+  budget = client->budget;
+  priv = budget->priv;
+
+  GST_OBJECT_LOCK (budget);
+  if (used != client->used) {
+    priv->used -= client->used;
+    priv->used += used;
+    if (priv->used > priv->peak)
+      priv->peak = priv->used;
+
+    if (used < client->used)
+      gst_memory_budget_wake_unlocked (budget);
+    client->used = used;
+  }
+  GST_OBJECT_UNLOCK (budget);
+}
+
+/**
+ * gst_memory_budget_client_is_exhausted:
+ * @client: a #GstMemoryBudgetClient
+ *
+ * Checks if @client has to wait before it can hold more memory.
+ *
+ * Returns: %TRUE if the budget is exhausted and @client holds at least its
+ *     share of it
+ *
+ * Since: 1.30
+ */
+gboolean
+gst_memory_budget_client_is_exhausted (GstMemoryBudgetClient * client)
+{
+  gboolean res;
+
+  g_return_val_if_fail (client != NULL, FALSE);
+
+  GST_OBJECT_LOCK (client->budget);
+  res = gst_memory_budget_is_exhausted_unlocked (client->budget, client);
+  GST_OBJECT_UNLOCK (client->budget);
+
+  return res;
+}
+
+/**
+ * gst_memory_budget_client_wait:
+ * @client: a #GstMemoryBudgetClient
+ *
+ * Blocks until @client is allowed to hold more memory, see
+ * gst_memory_budget_client_is_exhausted(), or until @client is set to
+ * flushing. A message is posted from the owner of @client when it has to
+ * wait. This must not be called with any locks held that are needed to
+ * release memory.
+ *
+ * Returns: %FALSE if @client is flushing
+ *
+ * Since: 1.30
+ */
+gboolean
+gst_memory_budget_client_wait (GstMemoryBudgetClient * client)
+{
+  GstMemoryBudget *budget;
+  GstMemoryBudgetPrivate *priv;
+  GstStructure *s;
+  gboolean res;
+
+  g_return_val_if_fail (client != NULL, FALSE);
+
+  budget = client->budget;
+  priv = budget->priv;
+
+  GST_OBJECT_LOCK (budget);
+  if (client->flushing)
+    goto flushing;
+  if (!gst_memory_budget_is_exhausted_unlocked (budget, client))
+    goto done;
+
+  GST_DEBUG_OBJECT (budget, "%" GST_PTR_FORMAT " holds %" G_GUINT64_FORMAT
+      " bytes and has to wait", client->owner, client->used);
+
+  s = gst_memory_budget_get_stats_unlocked (budget,
+      "GstMemoryBudgetExhausted");
+  gst_structure_set (s, "client-used", G_TYPE_UINT64, client->used,
+      "client-share", G_TYPE_UINT64,
+      gst_memory_budget_get_share_unlocked (budget, client), NULL);
+  priv->blocked++;
+  GST_OBJECT_UNLOCK (budget);
+
+  if (client->owner != NULL && GST_IS_ELEMENT (client->owner)) {
+    gst_element_post_message (GST_ELEMENT_CAST (client->owner),
+        gst_message_new_element (client->owner, s));
+  } else {
+    gst_structure_free (s);
+  }
+
+  GST_OBJECT_LOCK (budget);
+  priv->waiting++;
+  while (!client->flushing
+      && gst_memory_budget_is_exhausted_unlocked (budget, client)) {
+    gst_task_pool_blocking_begin ();
+    g_cond_wait (&priv->cond, GST_OBJECT_GET_LOCK (budget));
+    gst_task_pool_blocking_end ();
+  }
+  priv->waiting--;
+
+  if (client->flushing)
+    goto flushing;
+
+done:
+  res = TRUE;
+  GST_OBJECT_UNLOCK (budget);
+  return res;
+
+flushing:
+  {
+    GST_DEBUG_OBJECT (budget, "%" GST_PTR_FORMAT " is flushing",
+        client->owner);
+    res = FALSE;
+    GST_OBJECT_UNLOCK (budget);
+    return res;
+  }
+}
+
+/**
+ * gst_memory_budget_client_set_flushing:
+ * @client: a #GstMemoryBudgetClient
+ * @flushing: whether @client is flushing
+ *
+ * While @client is flushing, gst_memory_budget_client_wait() returns %FALSE
+ * immediately. Setting @client to flushing wakes up a thread waiting on it.
+ *
+ * Since: 1.30
+ */
+void
+gst_memory_budget_client_set_flushing (GstMemoryBudgetClient * client,
+    gboolean flushing)
+{
+  g_return_if_fail (client != NULL);
+
+  GST_OBJECT_LOCK (client->budget);
+  client->flushing = flushing;
+  if (flushing)
+    gst_memory_budget_wake_unlocked (client->budget);
+  GST_OBJECT_UNLOCK (client->budget);
+}
+
+/**
+ * gst_context_set_memory_budget:
+ * @context: a writable #GstContext of type #GST_MEMORY_BUDGET_CONTEXT_TYPE
+ * @budget: (transfer none) (nullable): a #GstMemoryBudget
+ *
+ * Stores @budget in @context.
+ *
+ * Since: 1.30
+ */
+void
+gst_context_set_memory_budget (GstContext * context, GstMemoryBudget * budget)
+{
+  GstStructure *s;
+
+  g_return_if_fail (GST_IS_CONTEXT (context));
+  g_return_if_fail (gst_context_is_writable (context));
+  g_return_if_fail (budget == NULL || GST_IS_MEMORY_BUDGET (budget));
+
+  s = gst_context_writable_structure (context);
+  gst_structure_set (s, "budget", GST_TYPE_MEMORY_BUDGET, budget, NULL);
+}
+
+/**
+ * gst_context_get_memory_budget:
+ * @context: a #GstContext
+ * @budget: (out) (transfer full) (optional) (nullable): the #GstMemoryBudget
+ *
+ * Gets the #GstMemoryBudget stored in @context with
+ * gst_context_set_memory_budget().
+ *
+ * Returns: %TRUE if @context contains a #GstMemoryBudget
+ *
+ * Since: 1.30
+ */
+gboolean
+gst_context_get_memory_budget (const GstContext * context,
+    GstMemoryBudget ** budget)
+{
+  const GstStructure *s;
+  GstMemoryBudget *tmp = NULL;
+
+  g_return_val_if_fail (GST_IS_CONTEXT (context), FALSE);
+
+  if (g_strcmp0 (gst_context_get_context_type (context),
+          GST_MEMORY_BUDGET_CONTEXT_TYPE) != 0)
+    return FALSE;
+
+  s = gst_context_get_structure (context);
+  if (!gst_structure_get (s, "budget", GST_TYPE_MEMORY_BUDGET, &tmp, NULL)
+      || tmp == NULL)
+    return FALSE;
+
+  if (budget)
+    *budget = tmp;
+  else
+    gst_object_unref (tmp);
+
+  return TRUE;
+}
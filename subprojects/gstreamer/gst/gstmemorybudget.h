@@ -0,0 +1,148 @@
+/* GStreamer
+ *
+ * gstmemorybudget.h: Memory budget shared between queues
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_MEMORY_BUDGET_H__
+#define __GST_MEMORY_BUDGET_H__
+
+#include <gst/gstobject.h>
+#include <gst/gstcontext.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_MEMORY_BUDGET                 (gst_memory_budget_get_type ())
+#define GST_MEMORY_BUDGET(obj)                 (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_MEMORY_BUDGET, GstMemoryBudget))
+#define GST_IS_MEMORY_BUDGET(obj)              (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_MEMORY_BUDGET))
+#define GST_MEMORY_BUDGET_CLASS(klass)         (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_MEMORY_BUDGET, GstMemoryBudgetClass))
+#define GST_IS_MEMORY_BUDGET_CLASS(klass)      (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_MEMORY_BUDGET))
+#define GST_MEMORY_BUDGET_GET_CLASS(obj)       (G_TYPE_INSTANCE_GET_CLASS ((obj), GST_TYPE_MEMORY_BUDGET, GstMemoryBudgetClass))
+#define GST_MEMORY_BUDGET_CAST(obj)            ((GstMemoryBudget *)(obj))
+
+typedef struct _GstMemoryBudget GstMemoryBudget;
+typedef struct _GstMemoryBudgetClass GstMemoryBudgetClass;
+typedef struct _GstMemoryBudgetPrivate GstMemoryBudgetPrivate;
+
+/**
+ * GstMemoryBudgetClient:
+ *
+ * Opaque handle an element uses to account the memory it holds in a
+ * #GstMemoryBudget.
+ *
+ * Since: 1.30
+ */
+typedef struct _GstMemoryBudgetClient GstMemoryBudgetClient;
+
+/**
+ * GST_MEMORY_BUDGET_CONTEXT_TYPE:
+ *
+ * The #GstContext type used to share a #GstMemoryBudget with all elements of
+ * a pipeline.
+ *
+ * Since: 1.30
+ */
+#define GST_MEMORY_BUDGET_CONTEXT_TYPE "gst.memory-budget"
+
+/**
+ * GstMemoryBudget:
+ *
+ * The opaque #GstMemoryBudget data structure.
+ *
+ * Since: 1.30
+ */
+struct _GstMemoryBudget {
+  GstObject              object;
+
+  /*< private >*/
+  GstMemoryBudgetPrivate *priv;
+
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+/**
+ * GstMemoryBudgetClass:
+ * @parent_class: the parent class structure
+ *
+ * The #GstMemoryBudgetClass structure.
+ *
+ * Since: 1.30
+ */
+struct _GstMemoryBudgetClass {
+  GstObjectClass parent_class;
+
+  /*< private >*/
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+GST_API
+GType                   gst_memory_budget_get_type            (void);
+
+GST_API
+GstMemoryBudget *       gst_memory_budget_new                 (guint64 limit);
+
+GST_API
+void                    gst_memory_budget_set_limit           (GstMemoryBudget * budget,
+                                                               guint64 limit);
+GST_API
+guint64                 gst_memory_budget_get_limit           (GstMemoryBudget * budget);
+
+GST_API
+guint64                 gst_memory_budget_get_used            (GstMemoryBudget * budget);
+
+GST_API
+GstStructure *          gst_memory_budget_get_stats           (GstMemoryBudget * budget) G_GNUC_WARN_UNUSED_RESULT;
+
+/* clients */
+
+GST_API
+GstMemoryBudgetClient * gst_memory_budget_client_new          (GstMemoryBudget * budget,
+                                                               GstObject * owner,
+                                                               guint priority);
+GST_API
+void                    gst_memory_budget_client_free         (GstMemoryBudgetClient * client);
+
+GST_API
+void                    gst_memory_budget_client_set_priority (GstMemoryBudgetClient * client,
+                                                               guint priority);
+GST_API
+void                    gst_memory_budget_client_set_used     (GstMemoryBudgetClient * client,
+                                                               guint64 used);
+GST_API
+gboolean                gst_memory_budget_client_is_exhausted (GstMemoryBudgetClient * client);
+
+GST_API
+gboolean                gst_memory_budget_client_wait         (GstMemoryBudgetClient * client);
+
+GST_API
+void                    gst_memory_budget_client_set_flushing (GstMemoryBudgetClient * client,
+                                                               gboolean flushing);
+
+/* sharing through a GstContext */
+
+GST_API
+void                    gst_context_set_memory_budget         (GstContext * context,
+                                                               GstMemoryBudget * budget);
+GST_API
+gboolean                gst_context_get_memory_budget         (const GstContext * context,
+                                                               GstMemoryBudget ** budget);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstMemoryBudget, gst_object_unref)
+
+G_END_DECLS
+
+#endif /* __GST_MEMORY_BUDGET_H__ */
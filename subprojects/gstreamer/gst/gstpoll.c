@@ -44,6 +44,14 @@
  * in time. The wait can be controlled by calling gst_poll_restart() and
  * gst_poll_set_flushing().
  *
+ * On Linux, setting the `GST_POLL_MODE` environment variable to `epoll`
+ * makes non-timer sets created with gst_poll_new() register their file
+ * descriptors with an epoll instance instead of passing the whole set to
+ * ppoll() on every wait. This keeps the cost of a wakeup independent of the
+ * number of file descriptors in the set, which matters for elements that
+ * serve thousands of clients. Sets fall back to ppoll() when a file
+ * descriptor can't be watched with epoll, such as a regular file.
+ *
  * Once the file descriptor set has been waited for, one can use
  * gst_poll_fd_has_closed() to see if the file descriptor has been closed,
  * gst_poll_fd_has_error() to see if it has generated an error,
@@ -83,6 +91,9 @@
 #endif
 #include <sys/time.h>
 #include <sys/socket.h>
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 #endif
 
 #ifdef G_OS_WIN32
@@ -124,7 +135,8 @@ typedef enum
   GST_POLL_MODE_PSELECT,
   GST_POLL_MODE_POLL,
   GST_POLL_MODE_PPOLL,
-  GST_POLL_MODE_WINDOWS
+  GST_POLL_MODE_WINDOWS,
+  GST_POLL_MODE_EPOLL
 } GstPollMode;
 
 struct _GstPoll
@@ -142,6 +154,19 @@ struct _GstPoll
 #ifndef G_OS_WIN32
   GstPollFD control_read_fd;
   GstPollFD control_write_fd;
+#ifdef HAVE_SYS_EPOLL_H
+  /* epoll instance mirroring fds, -1 when not using epoll */
+  gint epoll_fd;
+  /* set when an fd could not be registered, we use ppoll from then on */
+  gint epoll_disabled;
+  /* fd number to (index + 1) in fds, 0 when unused. Protected by lock */
+  GArray *epoll_fd_map;
+  /* only used from the waiting thread */
+  GArray *epoll_events;
+  /* indices in active_fds with revents set by the last wait, only used from
+   * the waiting thread */
+  GArray *epoll_ready;
+#endif
 #else
   GArray *active_fds_ignored;
   GArray *events;
@@ -392,6 +417,215 @@ find_index (GArray * array, GstPollFD * fd)
   return fd->idx;
 }
 
+#ifdef HAVE_SYS_EPOLL_H
+static gboolean
+epoll_requested (void)
+{
+  static gsize requested = 0;
+
+  if (g_once_init_enter (&requested)) {
+    const gchar *env = g_getenv ("GST_POLL_MODE");
+    gsize val = 1;
+
+    if (env != NULL && g_ascii_strcasecmp (env, "epoll") == 0)
+      val = 2;
+
+    g_once_init_leave (&requested, val);
+  }
+
+  return requested == 2;
+}
+
+static guint32
+pollfd_events_to_epoll (gshort events)
+{
+  guint32 res = 0;
+
+  /* EPOLLERR and EPOLLHUP are always reported */
+  if (events & POLLIN)
+    res |= EPOLLIN;
+  if (events & POLLOUT)
+    res |= EPOLLOUT;
+  if (events & POLLPRI)
+    res |= EPOLLPRI;
+
+  return res;
+}
+
+static gshort
+epoll_events_to_pollfd (guint32 events)
+{
+  gshort res = 0;
+
+  if (events & EPOLLIN)
+    res |= POLLIN;
+  if (events & EPOLLOUT)
+    res |= POLLOUT;
+  if (events & EPOLLPRI)
+    res |= POLLPRI;
+  if (events & EPOLLERR)
+    res |= POLLERR;
+  if (events & EPOLLHUP)
+    res |= POLLHUP;
+
+  return res;
+}
+
+static inline gboolean
+epoll_active (GstPoll * set)
+{
+  return set->epoll_fd >= 0 && !g_atomic_int_get (&set->epoll_disabled);
+}
+
+/* call with the lock */
+static void
+epoll_map_fd_unlocked (GstPoll * set, gint fd, gint idx)
+{
+  if ((guint) fd >= set->epoll_fd_map->len)
+    g_array_set_size (set->epoll_fd_map, fd + 1);
+
+  g_array_index (set->epoll_fd_map, gint, fd) = idx + 1;
+}
+
+/* call with the lock */
+static void
+epoll_ctl_unlocked (GstPoll * set, gint op, struct pollfd *pfd)
+{
+  struct epoll_event ev;
+
+  if (!epoll_active (set))
+    return;
+
+  ev.events = pollfd_events_to_epoll (pfd->events);
+  ev.data.u64 = 0;
+  ev.data.fd = pfd->fd;
+
+  if (epoll_ctl (set->epoll_fd, op, pfd->fd, &ev) == 0)
+    return;
+
+  /* the registration of an fd that was closed without being removed from the
+   * set survives when its file description is still open elsewhere */
+  if (op == EPOLL_CTL_ADD && errno == EEXIST &&
+      epoll_ctl (set->epoll_fd, EPOLL_CTL_MOD, pfd->fd, &ev) == 0)
+    return;
+
+  /* the fd was closed already and the kernel dropped it */
+  if (op != EPOLL_CTL_ADD && (errno == ENOENT || errno == EBADF))
+    return;
+
+  /* EPERM for regular files and other fds epoll can't watch */
+  GST_WARNING ("%p: can't watch fd %d with epoll, using ppoll: %s", set,
+      pfd->fd, g_strerror (errno));
+  g_atomic_int_set (&set->epoll_disabled, 1);
+  MARK_REBUILD (set);
+}
+
+/* call with the lock, before removing the fd at @idx from fds */
+static void
+epoll_remove_unlocked (GstPoll * set, gint idx)
+{
+  struct pollfd *pfd = &g_array_index (set->fds, struct pollfd, idx);
+  guint last = set->fds->len - 1;
+
+  epoll_ctl_unlocked (set, EPOLL_CTL_DEL, pfd);
+  epoll_map_fd_unlocked (set, pfd->fd, -1);
+
+  /* the last fd will be moved to idx */
+  if (idx != last) {
+    epoll_map_fd_unlocked (set,
+        g_array_index (set->fds, struct pollfd, last).fd, idx);
+  }
+}
+
+/* call with the lock */
+static struct pollfd *
+epoll_find_active_unlocked (GstPoll * set, gint fd, guint * idx)
+{
+  struct pollfd *pfd;
+  gint i = -1;
+  guint j;
+
+  if ((guint) fd < set->epoll_fd_map->len)
+    i = g_array_index (set->epoll_fd_map, gint, fd) - 1;
+
+  if (i >= 0 && i < set->active_fds->len) {
+    pfd = &g_array_index (set->active_fds, struct pollfd, i);
+    if (pfd->fd == fd) {
+      *idx = i;
+      return pfd;
+    }
+  }
+
+  /* fds changed since active_fds was built, search the slow way. An fd that
+   * was added since is not part of this wait. */
+  for (j = 0; j < set->active_fds->len; j++) {
+    pfd = &g_array_index (set->active_fds, struct pollfd, j);
+    if (pfd->fd == fd) {
+      *idx = j;
+      return pfd;
+    }
+  }
+
+  return NULL;
+}
+
+static gint
+epoll_wait_fds (GstPoll * set, GstClockTime timeout)
+{
+  struct epoll_event *events;
+  guint max_events, i;
+  gint n, res, t;
+
+  /* clear the result of the previous wait, a rebuild of active_fds has
+   * already done this */
+  g_mutex_lock (&set->lock);
+  for (i = 0; i < set->epoll_ready->len; i++) {
+    guint idx = g_array_index (set->epoll_ready, guint, i);
+
+    if (idx < set->active_fds->len)
+      g_array_index (set->active_fds, struct pollfd, idx).revents = 0;
+  }
+  g_array_set_size (set->epoll_ready, 0);
+  max_events = MAX (set->active_fds->len, 1);
+  g_mutex_unlock (&set->lock);
+
+  if (set->epoll_events->len < max_events)
+    g_array_set_size (set->epoll_events, max_events);
+  events = (struct epoll_event *) set->epoll_events->data;
+
+  if (timeout == GST_CLOCK_TIME_NONE) {
+    t = -1;
+  } else {
+    /* round up, we don't want to wake up before the timeout */
+    guint64 ms = timeout / GST_MSECOND + (timeout % GST_MSECOND != 0);
+
+    t = MIN (ms, G_MAXINT);
+  }
+
+  n = epoll_wait (set->epoll_fd, events, max_events, t);
+  if (n <= 0)
+    return n;
+
+  res = 0;
+  g_mutex_lock (&set->lock);
+  for (i = 0; i < (guint) n; i++) {
+    struct pollfd *pfd;
+    guint idx;
+
+    pfd = epoll_find_active_unlocked (set, events[i].data.fd, &idx);
+    if (pfd == NULL)
+      continue;
+
+    pfd->revents = epoll_events_to_pollfd (events[i].events);
+    g_array_append_val (set->epoll_ready, idx);
+    res++;
+  }
+  g_mutex_unlock (&set->lock);
+
+  return res;
+}
+#endif
+
 #if !defined(HAVE_PPOLL) && defined(HAVE_POLL)
 /* check if all file descriptors will fit in an fd_set */
 static gboolean
@@ -439,6 +673,11 @@ choose_mode (GstPoll * set, GstClockTime timeout)
 {
   GstPollMode mode;
 
+#ifdef HAVE_SYS_EPOLL_H
+  if (epoll_active (set))
+    return GST_POLL_MODE_EPOLL;
+#endif
+
   if (set->mode == GST_POLL_MODE_AUTO) {
 #ifdef HAVE_PPOLL
     mode = GST_POLL_MODE_PPOLL;
@@ -686,6 +925,20 @@ gst_poll_new (gboolean controllable)
   nset->active_fds = g_array_new (FALSE, FALSE, sizeof (struct pollfd));
   nset->control_read_fd.fd = -1;
   nset->control_write_fd.fd = -1;
+#ifdef HAVE_SYS_EPOLL_H
+  nset->epoll_fd = -1;
+  nset->epoll_fd_map = g_array_new (FALSE, TRUE, sizeof (gint));
+  nset->epoll_events = g_array_new (FALSE, FALSE, sizeof (struct epoll_event));
+  nset->epoll_ready = g_array_new (FALSE, FALSE, sizeof (guint));
+  if (epoll_requested ()) {
+    nset->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+    if (nset->epoll_fd < 0)
+      GST_WARNING ("%p: can't create epoll instance: %s", nset,
+          g_strerror (errno));
+    else
+      GST_DEBUG ("%p: using epoll", nset);
+  }
+#endif
   {
     gint control_sock[2];
 
@@ -754,6 +1007,15 @@ gst_poll_new_timer (void)
   /* we are a timer */
   poll->timer = TRUE;
 
+#ifdef HAVE_SYS_EPOLL_H
+  /* timers can be waited on from multiple threads, which the epoll backend
+   * doesn't support, and they only contain the control socket anyway */
+  if (poll->epoll_fd >= 0) {
+    close (poll->epoll_fd);
+    poll->epoll_fd = -1;
+  }
+#endif
+
 done:
   return poll;
 }
@@ -776,6 +1038,13 @@ gst_poll_free (GstPoll * set)
     close (set->control_write_fd.fd);
   if (set->control_read_fd.fd >= 0)
     close (set->control_read_fd.fd);
+#ifdef HAVE_SYS_EPOLL_H
+  if (set->epoll_fd >= 0)
+    close (set->epoll_fd);
+  g_array_free (set->epoll_ready, TRUE);
+  g_array_free (set->epoll_events, TRUE);
+  g_array_free (set->epoll_fd_map, TRUE);
+#endif
 #else
   CloseHandle (set->wakeup_event);
 
@@ -859,6 +1128,13 @@ gst_poll_add_fd_unlocked (GstPoll * set, GstPollFD * fd)
     g_array_append_val (set->fds, nfd);
 
     fd->idx = set->fds->len - 1;
+#ifdef HAVE_SYS_EPOLL_H
+    if (set->epoll_fd >= 0) {
+      epoll_map_fd_unlocked (set, fd->fd, fd->idx);
+      epoll_ctl_unlocked (set, EPOLL_CTL_ADD,
+          &g_array_index (set->fds, struct pollfd, fd->idx));
+    }
+#endif
 #else
     WinsockFd wfd;
     HANDLE event;
@@ -938,6 +1214,9 @@ gst_poll_remove_fd (GstPoll * set, GstPollFD * fd)
 #ifdef G_OS_WIN32
     gst_poll_free_winsock_event (set, idx);
     g_array_remove_index_fast (set->events, idx);
+#elif defined (HAVE_SYS_EPOLL_H)
+    if (set->epoll_fd >= 0)
+      epoll_remove_unlocked (set, idx);
 #endif
 
     /* remove the fd at index, we use _remove_index_fast, which copies the last
@@ -990,6 +1269,9 @@ gst_poll_fd_ctl_write (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events |= POLLOUT;
     else
       pfd->events &= ~POLLOUT;
+#ifdef HAVE_SYS_EPOLL_H
+    epoll_ctl_unlocked (set, EPOLL_CTL_MOD, pfd);
+#endif
 
     GST_LOG ("%p: pfd->events now %d (POLLOUT:%d)", set, pfd->events, POLLOUT);
 #else
@@ -1024,6 +1306,9 @@ gst_poll_fd_ctl_read_unlocked (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events |= POLLIN;
     else
       pfd->events &= ~POLLIN;
+#ifdef HAVE_SYS_EPOLL_H
+    epoll_ctl_unlocked (set, EPOLL_CTL_MOD, pfd);
+#endif
 #else
     gst_poll_update_winsock_event_mask (set, idx, FD_READ | FD_ACCEPT, active);
 #endif
@@ -1104,6 +1389,9 @@ gst_poll_fd_ctl_pri (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events |= POLLPRI;
     else
       pfd->events &= ~POLLPRI;
+#ifdef HAVE_SYS_EPOLL_H
+    epoll_ctl_unlocked (set, EPOLL_CTL_MOD, pfd);
+#endif
 
     GST_LOG ("%p: pfd->events now %d (POLLPRI:%d)", set, pfd->events, POLLOUT);
     MARK_REBUILD (set);
@@ -1440,6 +1728,9 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
       g_array_set_size (set->active_fds, set->fds->len);
       memcpy (set->active_fds->data, set->fds->data,
           set->fds->len * sizeof (struct pollfd));
+#ifdef HAVE_SYS_EPOLL_H
+      g_array_set_size (set->epoll_ready, 0);
+#endif
 #else
       if (!gst_poll_prepare_winsock_active_sets (set))
         goto winsock_error;
@@ -1550,6 +1841,16 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
 #else /* G_OS_WIN32 */
         g_assert_not_reached ();
         errno = ENOSYS;
+#endif
+        break;
+      }
+      case GST_POLL_MODE_EPOLL:
+      {
+#ifdef HAVE_SYS_EPOLL_H
+        res = epoll_wait_fds (set, timeout);
+#else
+        g_assert_not_reached ();
+        errno = ENOSYS;
 #endif
         break;
       }
@@ -198,7 +198,8 @@ _gst_query_free (GstQuery * query)
   memset (query, 0xff, sizeof (GstQueryImpl));
 #endif
 
-  g_free (query);
+  if (!_priv_gst_freelist_push (GST_FREELIST_QUERY, query))
+    g_free (query);
 }
 
 static GstQuery *
@@ -667,7 +668,13 @@ gst_query_new_custom (GstQueryType type, GstStructure * structure)
 {
   GstQueryImpl *query;
 
-  query = g_new0 (GstQueryImpl, 1);
+  /* position, duration and latency queries are typically created and freed
+   * again by the same thread, reuse their memory */
+  query = _priv_gst_freelist_pop (GST_FREELIST_QUERY);
+  if (query)
+    memset (query, 0, sizeof (GstQueryImpl));
+  else
+    query = g_new0 (GstQueryImpl, 1);
 
   GST_DEBUG ("creating new query %p %s", query, gst_query_type_get_name (type));
 
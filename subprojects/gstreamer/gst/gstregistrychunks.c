@@ -109,6 +109,13 @@ _strnlen (const gchar * str, gint maxlen)
   inptr += _len + 1; \
 }G_STMT_END
 
+#define skip_string(inptr, endptr, error_label)  G_STMT_START{\
+  gint _len = _strnlen (inptr, (endptr-inptr)); \
+  if (_len == -1) \
+    goto error_label; \
+  inptr += _len + 1; \
+}G_STMT_END
+
 #define ALIGNMENT            (sizeof (void *))
 #define alignment(_address)  (gsize)_address%ALIGNMENT
 #define align(_ptr)          _ptr += (( alignment(_ptr) == 0) ? 0 : ALIGNMENT-alignment(_ptr))
@@ -221,6 +228,48 @@ gst_registry_chunks_save_pad_template (GList ** list,
   return TRUE;
 }
 
+static gboolean gst_registry_chunks_load_element_details (GstElementFactory *
+    factory, const GstRegistryChunkElementFactory * ef, gchar ** in,
+    gchar * end);
+
+/*
+ * gst_registry_chunks_save_element_details:
+ *
+ * Store the details of an element factory that were not loaded from the
+ * registry cache yet by copying them from the cache as they are. The chunk
+ * follows the aligned GstRegistryChunkElementFactory chunk directly, so the
+ * alignment inside of it stays the same.
+ *
+ * Returns: %TRUE for success
+ */
+static gboolean
+gst_registry_chunks_save_element_details (GList ** list,
+    GstRegistryChunkElementFactory * ef, GBytes * cache, const gchar * details)
+{
+  const GstRegistryChunkElementFactory *cached;
+  GstRegistryChunk *chunk;
+  gchar *start, *in, *end;
+  gsize size;
+
+  cached = (const GstRegistryChunkElementFactory *) details;
+  start = in = (gchar *) details + sizeof (GstRegistryChunkElementFactory);
+  end = (gchar *) g_bytes_get_data (cache, &size) + size;
+
+  if (!gst_registry_chunks_load_element_details (NULL, cached, &in, end))
+    return FALSE;
+
+  ef->npadtemplates = cached->npadtemplates;
+  ef->ninterfaces = cached->ninterfaces;
+  ef->nuriprotocols = cached->nuriprotocols;
+
+  chunk = gst_registry_chunks_make_data (g_memdup2 (start, in - start),
+      in - start);
+  chunk->align = FALSE;
+  *list = g_list_prepend (*list, chunk);
+
+  return TRUE;
+}
+
 /*
  * gst_registry_chunks_save_feature:
  *
@@ -245,6 +294,8 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
   if (GST_IS_ELEMENT_FACTORY (feature)) {
     GstRegistryChunkElementFactory *ef;
     GstElementFactory *factory = GST_ELEMENT_FACTORY (feature);
+    const gchar *details = NULL;
+    GBytes *cache;
 
     /* Initialize with zeroes because of struct padding and
      * valgrind complaining about copying uninitialized memory
@@ -255,6 +306,22 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
     ef->npadtemplates = ef->ninterfaces = ef->nuriprotocols = 0;
     pf = (GstRegistryChunkPluginFeature *) ef;
 
+    /* details that were not needed since loading the registry cache don't
+     * have to be deserialized just to serialize them again */
+    cache = __gst_element_factory_get_cached_details (factory, &details);
+    if (cache) {
+      gboolean res;
+
+      res = gst_registry_chunks_save_element_details (list, ef, cache,
+          details);
+      g_bytes_unref (cache);
+      if (res)
+        goto done;
+
+      GST_WARNING_OBJECT (feature, "Can't copy cached details, loading them");
+      __gst_element_factory_ensure_details (factory);
+    }
+
     /* save interfaces */
     for (walk = factory->interfaces; walk;
         walk = g_list_next (walk), ef->ninterfaces++) {
@@ -377,6 +444,7 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
     GST_WARNING_OBJECT (feature, "unhandled feature type '%s'", type_name);
   }
 
+done:
   if (pf) {
     pf->rank = feature->rank;
     *list = g_list_prepend (*list, chk);
@@ -524,7 +592,7 @@ fail:
  * gst_registry_chunks_load_pad_template:
  *
  * Make a new GstStaticPadTemplate from current GstRegistryChunkPadTemplate
- * structure.
+ * structure, or only skip it when @factory is %NULL.
  *
  * Returns: new GstStaticPadTemplate
  */
@@ -540,6 +608,12 @@ gst_registry_chunks_load_pad_template (GstElementFactory * factory, gchar ** in,
       *in);
   unpack_element (*in, pt, GstRegistryChunkPadTemplate, end, fail);
 
+  if (factory == NULL) {
+    skip_string (*in, end, fail);
+    skip_string (*in, end, fail);
+    return TRUE;
+  }
+
   template = g_new (GstStaticPadTemplate, 1);
   template->presence = pt->presence;
   template->direction = (GstPadDirection) pt->direction;
@@ -560,6 +634,109 @@ fail:
   return FALSE;
 }
 
+/*
+ * gst_registry_chunks_load_element_details:
+ *
+ * Read the metadata, pad templates, URI handler details and interfaces
+ * following a GstRegistryChunkElementFactory structure into @factory, or only
+ * skip them when @factory is %NULL.
+ *
+ * Returns: %TRUE for success
+ */
+static gboolean
+gst_registry_chunks_load_element_details (GstElementFactory * factory,
+    const GstRegistryChunkElementFactory * ef, gchar ** in, gchar * end)
+{
+  const gchar *const_str, *meta_data_str;
+  gchar *str;
+  guint i, n;
+
+  /* unpack element factory strings */
+  unpack_string_nocopy (*in, meta_data_str, end, fail);
+  if (factory && meta_data_str && *meta_data_str) {
+    factory->metadata = gst_structure_from_string (meta_data_str, NULL);
+    if (!factory->metadata) {
+      GST_ERROR
+          ("Error when trying to deserialize structure for metadata '%s'",
+          meta_data_str);
+      goto fail;
+    }
+  }
+  n = ef->npadtemplates;
+  GST_DEBUG ("Element factory : npadtemplates=%d", n);
+
+  /* load pad templates */
+  for (i = 0; i < n; i++) {
+    if (G_UNLIKELY (!gst_registry_chunks_load_pad_template (factory, in,
+                end))) {
+      GST_ERROR ("Error while loading binary pad template");
+      goto fail;
+    }
+  }
+
+  /* load uritypes */
+  if (G_UNLIKELY ((n = ef->nuriprotocols))) {
+    GST_DEBUG ("Reading %d UriTypes at address %p", n, *in);
+
+    align (*in);
+    if (*in + sizeof (guint) > end)
+      goto fail;
+    if (factory) {
+      factory->uri_type = *((guint *) * in);
+      factory->uri_protocols = g_new0 (gchar *, n + 1);
+    }
+    *in += sizeof (guint);
+
+    for (i = 0; i < n; i++) {
+      if (factory) {
+        unpack_string (*in, str, end, fail);
+        factory->uri_protocols[i] = str;
+      } else {
+        skip_string (*in, end, fail);
+      }
+    }
+  }
+  /* load interfaces */
+  if (G_UNLIKELY ((n = ef->ninterfaces))) {
+    GST_DEBUG ("Reading %d Interfaces at address %p", n, *in);
+    for (i = 0; i < n; i++) {
+      unpack_string_nocopy (*in, const_str, end, fail);
+      if (factory)
+        __gst_element_factory_add_interface (factory, const_str);
+    }
+  }
+
+  return TRUE;
+
+fail:
+  return FALSE;
+}
+
+/*
+ * _priv_gst_registry_chunks_load_element_details:
+ * @factory: a #GstElementFactory
+ * @cache: the registry cache @factory was loaded from
+ * @details: the GstRegistryChunkElementFactory of @factory in @cache
+ *
+ * Load the details of an element factory that were skipped when loading the
+ * factory from the registry cache.
+ *
+ * Returns: %TRUE for success
+ */
+gboolean
+_priv_gst_registry_chunks_load_element_details (GstElementFactory * factory,
+    GBytes * cache, const gchar * details)
+{
+  gchar *in, *end;
+  gsize size;
+
+  in = (gchar *) details + sizeof (GstRegistryChunkElementFactory);
+  end = (gchar *) g_bytes_get_data (cache, &size) + size;
+
+  return gst_registry_chunks_load_element_details (factory,
+      (const GstRegistryChunkElementFactory *) details, &in, end);
+}
+
 /*
  * gst_registry_chunks_load_feature:
  *
@@ -569,7 +746,7 @@ fail:
  */
 static gboolean
 gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin * plugin)
+    gchar * end, GstPlugin * plugin, GBytes * cache)
 {
   GstRegistryChunkPluginFeature *pf = NULL;
   GstPluginFeature *feature = NULL;
@@ -601,8 +778,7 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
         plugin_name);
     return FALSE;
   }
-  if (G_UNLIKELY ((feature =
-              g_object_new (type, "name", feature_name, NULL)) == NULL)) {
+  if (G_UNLIKELY ((feature = g_object_new (type, NULL)) == NULL)) {
     GST_ERROR ("Can't create feature from type");
     return FALSE;
   }
@@ -611,13 +787,11 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
     GST_ERROR ("typename : '%s' is not a plugin feature", type_name);
     goto fail;
   }
+  gst_plugin_feature_set_name (feature, feature_name);
 
   if (GST_IS_ELEMENT_FACTORY (feature)) {
     GstRegistryChunkElementFactory *ef;
-    guint n;
     GstElementFactory *factory = GST_ELEMENT_FACTORY_CAST (feature);
-    gchar *str;
-    const gchar *meta_data_str;
 
     align (*in);
     GST_LOG ("Reading/casting for GstRegistryChunkElementFactory at address %p",
@@ -625,51 +799,16 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
     unpack_element (*in, ef, GstRegistryChunkElementFactory, end, fail);
     pf = (GstRegistryChunkPluginFeature *) ef;
 
-    /* unpack element factory strings */
-    unpack_string_nocopy (*in, meta_data_str, end, fail);
-    if (meta_data_str && *meta_data_str) {
-      factory->metadata = gst_structure_from_string (meta_data_str, NULL);
-      if (!factory->metadata) {
-        GST_ERROR
-            ("Error when trying to deserialize structure for metadata '%s'",
-            meta_data_str);
-        goto fail;
-      }
-    }
-    n = ef->npadtemplates;
-    GST_DEBUG ("Element factory : npadtemplates=%d", n);
-
-    /* load pad templates */
-    for (i = 0; i < n; i++) {
-      if (G_UNLIKELY (!gst_registry_chunks_load_pad_template (factory, in,
-                  end))) {
-        GST_ERROR ("Error while loading binary pad template");
+    if (cache) {
+      /* most factories are only ever looked up by name, so only check the
+       * details now and deserialize them from the cache when needed */
+      if (!gst_registry_chunks_load_element_details (NULL, ef, in, end))
         goto fail;
-      }
-    }
-
-    /* load uritypes */
-    if (G_UNLIKELY ((n = ef->nuriprotocols))) {
-      GST_DEBUG ("Reading %d UriTypes at address %p", n, *in);
-
-      align (*in);
-      factory->uri_type = *((guint *) * in);
-      *in += sizeof (factory->uri_type);
-      /*unpack_element(*in, &factory->uri_type, factory->uri_type, end, fail); */
-
-      factory->uri_protocols = g_new0 (gchar *, n + 1);
-      for (i = 0; i < n; i++) {
-        unpack_string (*in, str, end, fail);
-        factory->uri_protocols[i] = str;
-      }
-    }
-    /* load interfaces */
-    if (G_UNLIKELY ((n = ef->ninterfaces))) {
-      GST_DEBUG ("Reading %d Interfaces at address %p", n, *in);
-      for (i = 0; i < n; i++) {
-        unpack_string_nocopy (*in, const_str, end, fail);
-        __gst_element_factory_add_interface (factory, const_str);
-      }
+      factory->cache = g_bytes_ref (cache);
+      factory->cache_details = (const gchar *) ef;
+    } else if (!gst_registry_chunks_load_element_details (factory, ef, in,
+            end)) {
+      goto fail;
     }
   } else if (GST_IS_TYPE_FIND_FACTORY (feature)) {
     GstRegistryChunkTypeFindFactory *tff;
@@ -839,7 +978,7 @@ fail:
  */
 gboolean
 _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin ** out_plugin)
+    gchar * end, GBytes * cache, GstPlugin ** out_plugin)
 {
 #ifndef GST_DISABLE_GST_DEBUG
   gchar *start = *in;
@@ -912,7 +1051,7 @@ _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
   /* Load plugin features */
   for (i = 0; i < n; i++) {
     if (G_UNLIKELY (!gst_registry_chunks_load_feature (registry, in, end,
-                plugin))) {
+                plugin, cache))) {
       GST_ERROR ("Error while loading binary feature for plugin '%s'",
           GST_STR_NULL (plugin->desc.name));
       gst_registry_remove_plugin (registry, plugin);
@@ -25,6 +25,7 @@
 
 #include <gst/gstpad.h>
 #include <gst/gstregistry.h>
+#include <gst/gstelementfactory.h>
 
 /*
  * we reference strings directly from the plugins and in this case set CONST to
@@ -175,7 +176,11 @@ _priv_gst_registry_chunks_save_plugin (GList ** list, GstRegistry * registry,
 
 gboolean
 _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
-    gchar *end, GstPlugin **out_plugin);
+    gchar *end, GBytes * cache, GstPlugin **out_plugin);
+
+gboolean
+_priv_gst_registry_chunks_load_element_details (GstElementFactory * factory,
+    GBytes * cache, const gchar * details);
 
 void
 _priv_gst_registry_chunks_save_global_header (GList ** list,
@@ -190,6 +190,12 @@ typedef struct
 #define GST_STRUCTURE_FIELD(structure, index) \
   (&((GstStructureImpl*)(structure))->fields[(index)])
 
+/* Structures with up to this many fields all have the same size and are
+ * recycled through a per-thread freelist */
+#define STRUCTURE_RECYCLE_ALLOC 8
+#define STRUCTURE_RECYCLE_SIZE (sizeof (GstStructureImpl) + \
+    (STRUCTURE_RECYCLE_ALLOC - 1) * sizeof (GstStructureField))
+
 #define IS_MUTABLE(structure) \
     (!GST_STRUCTURE_REFCOUNT(structure) || \
      g_atomic_int_get (GST_STRUCTURE_REFCOUNT(structure)) == 1)
@@ -286,9 +292,14 @@ gst_structure_new_take_id_str_empty_with_size (GstIdStr * name, guint prealloc)
     prealloc = 1;
 
   n_alloc = GST_ROUND_UP_8 (prealloc);
-  structure =
-      g_malloc0 (sizeof (GstStructureImpl) + (n_alloc -
-          1) * sizeof (GstStructureField));
+  if (n_alloc == STRUCTURE_RECYCLE_ALLOC
+      && (structure = _priv_gst_freelist_pop (GST_FREELIST_STRUCTURE))) {
+    memset (structure, 0, STRUCTURE_RECYCLE_SIZE);
+  } else {
+    structure =
+        g_malloc0 (sizeof (GstStructureImpl) + (n_alloc -
+            1) * sizeof (GstStructureField));
+  }
 
   ((GstStructure *) structure)->type = _gst_structure_type;
   ((GstStructure *) structure)->name = 0;
@@ -747,6 +758,7 @@ gst_structure_free (GstStructure * structure)
 {
   GstStructureField *field;
   guint i, len;
+  gboolean recycle;
 
   g_return_if_fail (structure != NULL);
   g_return_if_fail (GST_STRUCTURE_REFCOUNT (structure) == NULL);
@@ -760,8 +772,14 @@ gst_structure_free (GstStructure * structure)
     }
     gst_id_str_clear (&field->name);
   }
-  if (GST_STRUCTURE_IS_USING_DYNAMIC_ARRAY (structure))
+  if (GST_STRUCTURE_IS_USING_DYNAMIC_ARRAY (structure)) {
     g_free (((GstStructureImpl *) structure)->fields);
+    recycle = FALSE;
+  } else {
+    recycle =
+        ((GstStructureImpl *) structure)->fields_alloc ==
+        STRUCTURE_RECYCLE_ALLOC;
+  }
 
   gst_id_str_clear (GST_STRUCTURE_NAME (structure));
 
@@ -770,6 +788,9 @@ gst_structure_free (GstStructure * structure)
 #endif
   GST_TRACE ("free structure %p", structure);
 
+  if (recycle && _priv_gst_freelist_push (GST_FREELIST_STRUCTURE, structure))
+    return;
+
   g_free (structure);
 }
 
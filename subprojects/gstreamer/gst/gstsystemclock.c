@@ -228,6 +228,10 @@ struct _GstClockEntryFutex
 
   gboolean initialized;
 
+  /* position + 1 in the heap of async entries, 0 when not queued */
+  guint heap_pos;
+  guint64 seqnum;
+
   GMutex lock;
   guint cond_val;
 };
@@ -402,6 +406,10 @@ struct _GstClockEntryPThread
 
   gboolean initialized;
 
+  /* position + 1 in the heap of async entries, 0 when not queued */
+  guint heap_pos;
+  guint64 seqnum;
+
   pthread_cond_t cond;
   pthread_mutex_t lock;
 };
@@ -534,6 +542,10 @@ struct _GstClockEntryGLib
 
   gboolean initialized;
 
+  /* position + 1 in the heap of async entries, 0 when not queued */
+  guint heap_pos;
+  guint64 seqnum;
+
   GMutex lock;
   GCond cond;
 };
@@ -575,7 +587,10 @@ struct _GstSystemClockPrivate
   gboolean starting;
   gboolean stopping;
 
-  GList *entries;
+  /* binary min-heap of GstClockEntryImpl, ordered by time and then by
+   * seqnum so that entries with the same time fire in insertion order */
+  GPtrArray *entries;
+  guint64 entries_seqnum;
   GCond entries_changed;
 
   GstClockType clock_type;
@@ -624,6 +639,120 @@ static gboolean gst_system_clock_start_async (GstSystemClock * clock);
 
 static GMutex _gst_sysclock_mutex;
 
+/* heap of pending async entries, all must be called with the clock lock */
+static inline gboolean
+entry_heap_less (GstClockEntryImpl * a, GstClockEntryImpl * b)
+{
+  GstClockTime time_a = GST_CLOCK_ENTRY_TIME ((GstClockEntry *) a);
+  GstClockTime time_b = GST_CLOCK_ENTRY_TIME ((GstClockEntry *) b);
+
+  if (time_a != time_b)
+    return time_a < time_b;
+
+  return a->seqnum < b->seqnum;
+}
+
+static inline void
+entry_heap_set (GPtrArray * heap, guint i, GstClockEntryImpl * entry)
+{
+  g_ptr_array_index (heap, i) = entry;
+  entry->heap_pos = i + 1;
+}
+
+static void
+entry_heap_sift_up (GPtrArray * heap, guint i)
+{
+  GstClockEntryImpl *entry = g_ptr_array_index (heap, i);
+
+  while (i > 0) {
+    guint parent = (i - 1) / 2;
+    GstClockEntryImpl *p = g_ptr_array_index (heap, parent);
+
+    if (!entry_heap_less (entry, p))
+      break;
+
+    entry_heap_set (heap, i, p);
+    i = parent;
+  }
+  entry_heap_set (heap, i, entry);
+}
+
+static void
+entry_heap_sift_down (GPtrArray * heap, guint i)
+{
+  GstClockEntryImpl *entry = g_ptr_array_index (heap, i);
+
+  while (TRUE) {
+    guint child = 2 * i + 1;
+    GstClockEntryImpl *c;
+
+    if (child >= heap->len)
+      break;
+
+    c = g_ptr_array_index (heap, child);
+    if (child + 1 < heap->len
+        && entry_heap_less (g_ptr_array_index (heap, child + 1), c)) {
+      child++;
+      c = g_ptr_array_index (heap, child);
+    }
+
+    if (!entry_heap_less (c, entry))
+      break;
+
+    entry_heap_set (heap, i, c);
+    i = child;
+  }
+  entry_heap_set (heap, i, entry);
+}
+
+static GstClockEntryImpl *
+entry_heap_peek (GstSystemClockPrivate * priv)
+{
+  if (priv->entries->len == 0)
+    return NULL;
+
+  return g_ptr_array_index (priv->entries, 0);
+}
+
+/* restores the heap order after the time of a queued entry changed */
+static void
+entry_heap_update (GstSystemClockPrivate * priv, GstClockEntryImpl * entry)
+{
+  entry_heap_sift_down (priv->entries, entry->heap_pos - 1);
+  entry_heap_sift_up (priv->entries, entry->heap_pos - 1);
+}
+
+static void
+entry_heap_push (GstSystemClockPrivate * priv, GstClockEntryImpl * entry)
+{
+  entry->seqnum = priv->entries_seqnum++;
+  g_ptr_array_add (priv->entries, entry);
+  entry_heap_sift_up (priv->entries, priv->entries->len - 1);
+}
+
+/* returns FALSE if the entry was not queued */
+static gboolean
+entry_heap_remove (GstSystemClockPrivate * priv, GstClockEntryImpl * entry)
+{
+  GPtrArray *heap = priv->entries;
+  GstClockEntryImpl *last;
+  guint i;
+
+  if (entry->heap_pos == 0)
+    return FALSE;
+
+  i = entry->heap_pos - 1;
+  entry->heap_pos = 0;
+
+  last = g_ptr_array_remove_index (heap, heap->len - 1);
+  if (last != entry) {
+    entry_heap_set (heap, i, last);
+    entry_heap_update (priv, last);
+  }
+
+  return TRUE;
+}
+
 /* static guint gst_system_clock_signals[LAST_SIGNAL] = { 0 }; */
 
 #define gst_system_clock_parent_class parent_class
@@ -670,7 +799,7 @@ gst_system_clock_init (GstSystemClock * clock)
 
   priv->clock_type = DEFAULT_CLOCK_TYPE;
 
-  priv->entries = NULL;
+  priv->entries = g_ptr_array_new ();
   g_cond_init (&priv->entries_changed);
 
 #if 0
@@ -687,14 +816,14 @@ gst_system_clock_dispose (GObject * object)
   GstClock *clock = (GstClock *) object;
   GstSystemClock *sysclock = GST_SYSTEM_CLOCK_CAST (clock);
   GstSystemClockPrivate *priv = sysclock->priv;
-  GList *entries;
+  guint i;
 
   /* else we have to stop the thread */
   GST_SYSTEM_CLOCK_LOCK (clock);
   priv->stopping = TRUE;
   /* unschedule all entries */
-  for (entries = priv->entries; entries; entries = g_list_next (entries)) {
-    GstClockEntryImpl *entry = (GstClockEntryImpl *) entries->data;
+  for (i = 0; priv->entries && i < priv->entries->len; i++) {
+    GstClockEntryImpl *entry = g_ptr_array_index (priv->entries, i);
 
     /* We don't need to take the entry lock here because the async thread
      * would only ever look at the head entry, which is locked below and only
@@ -705,11 +834,10 @@ gst_system_clock_dispose (GObject * object)
     /* Wake up only the head entry: the async thread would only be waiting for
      * this one, not all of them. Once the head entry is unscheduled it tries
      * to get the system clock lock (which we hold here) and then look for the
-     * next entry. Once it gets the lock it will notice that all further
-     * entries are unscheduled, would remove them one by one from the list and
-     * then shut down. */
-    if (!entries->prev) {
-      /* it was initialized before adding to the list */
+     * next entry. Once it gets the lock it will notice that the clock is
+     * stopping and shut down. */
+    if (i == 0) {
+      /* it was initialized before adding to the heap */
       g_assert (entry->initialized);
 
       GST_SYSTEM_CLOCK_ENTRY_LOCK (entry);
@@ -727,9 +855,16 @@ gst_system_clock_dispose (GObject * object)
   priv->thread = NULL;
   GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "joined thread");
 
-  g_list_foreach (priv->entries, (GFunc) gst_clock_id_unref, NULL);
-  g_list_free (priv->entries);
-  priv->entries = NULL;
+  if (priv->entries) {
+    for (i = 0; i < priv->entries->len; i++) {
+      GstClockEntryImpl *entry = g_ptr_array_index (priv->entries, i);
+
+      entry->heap_pos = 0;
+      gst_clock_id_unref ((GstClockID) entry);
+    }
+    g_ptr_array_free (priv->entries, TRUE);
+    priv->entries = NULL;
+  }
 
   g_cond_clear (&priv->entries_changed);
 
@@ -872,9 +1007,11 @@ gst_system_clock_obtain (void)
   return clock;
 }
 
-/* this thread reads the sorted clock entries from the queue.
+/* this thread takes the earliest clock entry from the heap.
  *
  * It waits on each of them and fires the callback when the timeout occurs.
+ * Entries that are already due when the previous callback returns are fired
+ * right after each other without sleeping.
  *
  * When an entry in the queue was canceled before we wait for it, it is
  * simply skipped.
@@ -903,7 +1040,7 @@ gst_system_clock_async_thread (GstClock * clock)
     GstClockReturn res;
 
     /* check if something to be done */
-    while (priv->entries == NULL) {
+    while (priv->entries->len == 0) {
       GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
           "no clock entries, waiting..");
       /* wait for work to do */
@@ -914,10 +1051,13 @@ gst_system_clock_async_thread (GstClock * clock)
         goto exit;
     }
 
-    /* pick the next entry */
-    entry = priv->entries->data;
+    /* pick the next entry, it can be removed from the heap by
+     * gst_system_clock_id_unschedule() while we work on it so keep our own
+     * ref */
+    entry = (GstClockEntry *) entry_heap_peek (priv);
+    gst_clock_id_ref ((GstClockID) entry);
 
-    /* it was initialized before adding to the list */
+    /* it was initialized before adding to the heap */
     g_assert (((GstClockEntryImpl *) entry)->initialized);
 
     /* unlocked before the next loop iteration at latest */
@@ -984,9 +1124,11 @@ gst_system_clock_async_thread (GstClock * clock)
           GST_SYSTEM_CLOCK_LOCK (clock);
           /* adjust time now */
           entry->time = requested + entry->interval;
-          /* and resort the list now */
-          priv->entries =
-              g_list_sort (priv->entries, gst_clock_id_compare_func);
+          /* and move it to its new place, unless it was unscheduled from the
+           * callback */
+          if (((GstClockEntryImpl *) entry)->heap_pos != 0)
+            entry_heap_update (priv, (GstClockEntryImpl *) entry);
+          gst_clock_id_unref ((GstClockID) entry);
           /* and restart */
           continue;
         } else {
@@ -1007,6 +1149,7 @@ gst_system_clock_async_thread (GstClock * clock)
         GST_CLOCK_ENTRY_STATUS (entry) = GST_CLOCK_OK;
         GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
         GST_SYSTEM_CLOCK_LOCK (clock);
+        gst_clock_id_unref ((GstClockID) entry);
         continue;
       default:
         GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
@@ -1020,8 +1163,10 @@ gst_system_clock_async_thread (GstClock * clock)
   next_entry:
     GST_SYSTEM_CLOCK_LOCK (clock);
 
-    /* we remove the current entry and unref it */
-    priv->entries = g_list_remove (priv->entries, entry);
+    /* we remove the current entry and unref it, unless it was already
+     * removed when it got unscheduled */
+    if (entry_heap_remove (priv, (GstClockEntryImpl *) entry))
+      gst_clock_id_unref ((GstClockID) entry);
     gst_clock_id_unref ((GstClockID) entry);
   }
 exit:
@@ -1378,10 +1523,9 @@ no_thread:
   return FALSE;
 }
 
-/* Add an entry to the list of pending async waits. The entry is inserted
- * in sorted order. If we inserted the entry at the head of the list, we
- * need to signal the thread as it might either be waiting on it or waiting
- * for a new entry.
+/* Add an entry to the heap of pending async waits. If the entry became the
+ * head of the heap, we need to signal the thread as it might either be
+ * waiting on the previous head or waiting for a new entry.
  *
  * MT safe.
  */
@@ -1391,6 +1535,7 @@ gst_system_clock_id_wait_async (GstClock * clock, GstClockEntry * entry)
   GstSystemClock *sysclock;
   GstSystemClockPrivate *priv;
   GstClockEntry *head;
+  GstClockEntryImpl *entry_impl = (GstClockEntryImpl *) entry;
 
   sysclock = GST_SYSTEM_CLOCK_CAST (clock);
   priv = sysclock->priv;
@@ -1408,22 +1553,21 @@ gst_system_clock_id_wait_async (GstClock * clock, GstClockEntry * entry)
     goto was_unscheduled;
   GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
 
-  if (priv->entries)
-    head = priv->entries->data;
-  else
-    head = NULL;
+  head = (GstClockEntry *) entry_heap_peek (priv);
 
-  /* need to take a ref */
-  gst_clock_id_ref ((GstClockID) entry);
-
-  /* insert the entry in sorted order */
-  priv->entries = g_list_insert_sorted (priv->entries, entry,
-      gst_clock_id_compare_func);
+  if (entry_impl->heap_pos == 0) {
+    /* need to take a ref */
+    gst_clock_id_ref ((GstClockID) entry);
+    entry_heap_push (priv, entry_impl);
+  } else {
+    /* reinitialized while still queued, only move it to its new place */
+    entry_heap_update (priv, entry_impl);
+  }
 
   /* only need to send the signal if the entry was added to the
    * front, else the thread is just waiting for another entry and
    * will get to this entry automatically. */
-  if (priv->entries->data == entry) {
+  if ((GstClockEntry *) entry_heap_peek (priv) == entry) {
     GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
         "async entry added to head %p", head);
     if (head == NULL) {
@@ -1435,7 +1579,7 @@ gst_system_clock_id_wait_async (GstClock * clock, GstClockEntry * entry)
     } else {
       GstClockReturn status;
 
-      /* it was initialized before adding to the list */
+      /* it was initialized before adding to the heap */
       g_assert (((GstClockEntryImpl *) head)->initialized);
 
       GST_SYSTEM_CLOCK_ENTRY_LOCK ((GstClockEntryImpl *) head);
@@ -1475,14 +1619,17 @@ was_unscheduled:
 /* unschedule an entry. This will set the state of the entry to GST_CLOCK_UNSCHEDULED
  * and will signal any thread waiting for entries to recheck their entry.
  * We cannot really decide if the signal is needed or not because the entry
- * could be waited on in async or sync mode.
+ * could be waited on in async or sync mode. Async entries are removed from
+ * the heap right away so that they don't slow down later insertions.
  *
  * MT safe.
  */
 static void
 gst_system_clock_id_unschedule (GstClock * clock, GstClockEntry * entry)
 {
+  GstSystemClockPrivate *priv = GST_SYSTEM_CLOCK_CAST (clock)->priv;
   GstClockReturn status;
+  gboolean removed;
 
   GST_SYSTEM_CLOCK_LOCK (clock);
 
@@ -1502,7 +1649,14 @@ gst_system_clock_id_unschedule (GstClock * clock, GstClockEntry * entry)
     GST_SYSTEM_CLOCK_ENTRY_BROADCAST ((GstClockEntryImpl *) entry);
   }
   GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
+
+  /* the async thread keeps its own ref to the entry it is working on */
+  removed = entry_heap_remove (priv, (GstClockEntryImpl *) entry);
   GST_SYSTEM_CLOCK_UNLOCK (clock);
+
+  /* the caller still has a ref */
+  if (removed)
+    gst_clock_id_unref ((GstClockID) entry);
 }
 
 gboolean
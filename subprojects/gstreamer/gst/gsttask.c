@@ -57,6 +57,11 @@
  * After creating a #GstTask, use gst_object_unref() to free its resources. This can
  * only be done when the task is not running anymore.
  *
+ * When the pool of the task is a #GstWorkStealingTaskPool, the task does not
+ * get a thread of its own. Every call of the #GstTaskFunction is then run as
+ * a separate job on the pool, the lock is released between the calls and a
+ * paused task doesn't occupy a thread at all.
+ *
  * Task functions can send a #GstMessage to send out-of-band data to the
  * application. The application can receive messages from the #GstBus in its
  * mainloop.
@@ -124,6 +129,13 @@ struct _GstTaskPrivate
 
   /* we're currently inside gst_task_join() */
   gboolean joining;
+
+  /* running one iteration per job on a work stealing pool */
+  gboolean iterating;
+  /* an iteration is queued or running */
+  gboolean scheduled;
+  /* the enter_func was called */
+  gboolean entered;
 };
 
 #ifdef _MSC_VER
@@ -216,6 +228,7 @@ gst_task_win32_set_thread_name (const gchar * name)
 static void gst_task_finalize (GObject * object);
 
 static void gst_task_func (GstTask * task);
+static void gst_task_iterate (GstTask * task);
 
 static GMutex pool_lock;
 
@@ -443,6 +456,128 @@ no_lock:
   }
 }
 
+/* Must be called with the task LOCK. */
+static gboolean
+schedule_iteration (GstTask * task)
+{
+  GstTaskPrivate *priv = task->priv;
+  GError *error = NULL;
+  gpointer id;
+
+  priv->scheduled = TRUE;
+  id = gst_task_pool_push (priv->pool_id, (GstTaskPoolFunction)
+      gst_task_iterate, task, &error);
+
+  if (error != NULL) {
+    g_warning ("failed to schedule task: %s", error->message);
+    g_error_free (error);
+    priv->scheduled = FALSE;
+    return FALSE;
+  }
+
+  /* only the last iteration needs to be joined */
+  if (priv->id)
+    gst_task_pool_dispose_handle (priv->pool_id, priv->id);
+  priv->id = id;
+
+  return TRUE;
+}
+
+/* Runs a single iteration of the task function and schedules the next one.
+ * This is used instead of gst_task_func() for work stealing pools. */
+static void
+gst_task_iterate (GstTask * task)
+{
+  GRecMutex *lock;
+  GThread *tself;
+  GstTaskPrivate *priv;
+  gboolean enter, leave, joining;
+
+  priv = task->priv;
+
+  tself = g_thread_self ();
+
+  GST_OBJECT_LOCK (task);
+  if (GET_TASK_STATE (task) == GST_TASK_STOPPED)
+    goto exit;
+  lock = GST_TASK_GET_LOCK (task);
+  if (G_UNLIKELY (lock == NULL))
+    goto no_lock;
+  enter = !priv->entered;
+  priv->entered = TRUE;
+  GST_OBJECT_UNLOCK (task);
+
+  if (enter && priv->enter_func)
+    priv->enter_func (task, tself, priv->enter_user_data);
+
+  /* locking order is TASK_LOCK, LOCK */
+  g_rec_mutex_lock (lock);
+  GST_OBJECT_LOCK (task);
+  if (G_LIKELY (GET_TASK_STATE (task) == GST_TASK_STARTED)) {
+    task->thread = tself;
+    GST_OBJECT_UNLOCK (task);
+
+    task->func (task->user_data);
+
+    GST_OBJECT_LOCK (task);
+    task->thread = NULL;
+  }
+  GST_OBJECT_UNLOCK (task);
+  g_rec_mutex_unlock (lock);
+
+  GST_OBJECT_LOCK (task);
+  switch (GET_TASK_STATE (task)) {
+    case GST_TASK_STARTED:
+      if (G_LIKELY (schedule_iteration (task))) {
+        GST_OBJECT_UNLOCK (task);
+        return;
+      }
+      break;
+    case GST_TASK_PAUSED:
+      /* give the worker back, gst_task_set_state() schedules us again */
+      GST_INFO_OBJECT (task, "Task going to paused");
+      priv->scheduled = FALSE;
+      GST_TASK_SIGNAL (task);
+      GST_OBJECT_UNLOCK (task);
+      return;
+    case GST_TASK_STOPPED:
+      break;
+  }
+
+exit:
+  priv->scheduled = FALSE;
+  /* only leave when we entered, the task might have been stopped before the
+   * first iteration */
+  leave = priv->entered;
+  priv->entered = FALSE;
+  if (leave && priv->leave_func) {
+    /* fire the leave_func callback when we need to. We need to do this before
+     * we signal the task and with the task lock released. */
+    GST_OBJECT_UNLOCK (task);
+    priv->leave_func (task, tself, priv->leave_user_data);
+    GST_OBJECT_LOCK (task);
+  }
+  /* see gst_task_func() */
+  task->running = FALSE;
+  GST_TASK_SIGNAL (task);
+  joining = task->priv->joining;
+  if (joining)
+    gst_object_unref (task);
+  GST_DEBUG ("Exit task %p, thread %p", task, tself);
+  GST_OBJECT_UNLOCK (task);
+
+  if (!joining)
+    gst_object_unref (task);
+
+  return;
+
+no_lock:
+  {
+    g_warning ("starting task without a lock");
+    goto exit;
+  }
+}
+
 /**
  * gst_task_cleanup_all:
  *
@@ -732,6 +867,13 @@ start_task (GstTask * task)
   /* push on the thread pool, we remember the original pool because the user
    * could change it later on and then we join to the wrong pool. */
   priv->pool_id = gst_object_ref (priv->pool);
+
+  priv->iterating = GST_IS_WORK_STEALING_TASK_POOL (priv->pool_id);
+  if (priv->iterating) {
+    priv->entered = FALSE;
+    return schedule_iteration (task);
+  }
+
   priv->id =
       gst_task_pool_push (priv->pool_id, (GstTaskPoolFunction) gst_task_func,
       task, &error);
@@ -769,8 +911,12 @@ gst_task_set_state_unlocked (GstTask * task, GstTaskState state)
           res = start_task (task);
         break;
       case GST_TASK_PAUSED:
-        /* when we are paused, signal to go to the new state */
-        GST_TASK_SIGNAL (task);
+        /* when we are paused, signal to go to the new state, or schedule
+         * the next iteration if we gave back the worker */
+        if (task->priv->iterating && !task->priv->scheduled)
+          res = schedule_iteration (task);
+        else
+          GST_TASK_SIGNAL (task);
         break;
       case GST_TASK_STARTED:
         /* if we were started, we'll go to the new state after the next
@@ -944,6 +1090,9 @@ gst_task_join (GstTask * task)
   SET_TASK_STATE (task, GST_TASK_STOPPED);
   /* signal the state change for when it was blocked in PAUSED. */
   GST_TASK_SIGNAL (task);
+  /* a paused task on a work stealing pool needs to run once more to exit */
+  if (task->running && priv->iterating && !priv->scheduled)
+    schedule_iteration (task);
   /* we set the running flag when pushing the task on the thread pool.
    * This means that the task function might not be called when we try
    * to join it here. */
@@ -29,6 +29,11 @@
  * implementation uses a regular GThreadPool to start tasks.
  *
  * Subclasses can be made to create custom threads.
+ *
+ * A #GstWorkStealingTaskPool runs the tasks of many elements on a fixed
+ * number of worker threads. Applications opt in per task by setting the pool
+ * with gst_task_set_pool() from the %GST_STREAM_STATUS_TYPE_CREATE stream
+ * status message of the task.
  */
 
 #include "gst_private.h"
@@ -36,6 +41,7 @@
 #include "gstinfo.h"
 #include "gsttaskpool.h"
 #include "gsterror.h"
+#include "gstvecdeque.h"
 
 GST_DEBUG_CATEGORY_STATIC (taskpool_debug);
 #define GST_CAT_DEFAULT (taskpool_debug)
@@ -436,6 +442,23 @@ shared_func (SharedTaskData * tdata, GstTaskPool * pool)
   shared_task_data_unref (tdata);
 }
 
+static SharedTaskData *
+shared_task_data_new (GstTaskPoolFunction func, gpointer user_data)
+{
+  SharedTaskData *ret;
+
+  ret = g_new (SharedTaskData, 1);
+
+  ret->done = FALSE;
+  ret->func = func;
+  ret->user_data = user_data;
+  g_atomic_int_set (&ret->refcount, 1);
+  g_cond_init (&ret->done_cond);
+  g_mutex_init (&ret->done_lock);
+
+  return ret;
+}
+
 static gpointer
 shared_push (GstTaskPool * pool, GstTaskPoolFunction func,
     gpointer user_data, GError ** error)
@@ -449,14 +472,7 @@ shared_push (GstTaskPool * pool, GstTaskPoolFunction func,
     goto done;
   }
 
-  ret = g_new (SharedTaskData, 1);
-
-  ret->done = FALSE;
-  ret->func = func;
-  ret->user_data = user_data;
-  g_atomic_int_set (&ret->refcount, 1);
-  g_cond_init (&ret->done_cond);
-  g_mutex_init (&ret->done_lock);
+  ret = shared_task_data_new (func, user_data);
 
   g_thread_pool_push (pool->pool, shared_task_data_ref (ret), error);
 
@@ -607,3 +623,453 @@ gst_shared_task_pool_new (void)
 
   return pool;
 }
+
+/* Work stealing task pool.
+ *
+ * Every worker has its own queue of jobs. Jobs pushed from a worker go to
+ * its own queue, jobs pushed from other threads go to a shared injection
+ * queue. Workers run their own jobs in FIFO order so that tasks that are
+ * rescheduled after every iteration take turns, and workers that run out of
+ * jobs steal from the other end of the queues of other workers.
+ *
+ * Tasks are not coroutines, a worker that blocks can't run anything else.
+ * Code that is about to block calls gst_task_pool_blocking_begin() and an
+ * additional worker is started if needed, so that there are always
+ * n_workers threads available for the queued jobs. Surplus workers exit
+ * again when they become idle.
+ */
+
+/* check the injection queue every this many jobs so that new jobs don't
+ * starve behind rescheduled ones */
+#define WS_INJECTOR_INTERVAL 61
+
+typedef struct
+{
+  GstWorkStealingTaskPool *pool;
+  GMutex lock;
+  GstVecDeque *jobs;
+  guint tick;
+  guint blocking;
+} WSWorker;
+
+struct _GstWorkStealingTaskPoolPrivate
+{
+  guint n_workers;
+
+  /* protects the workers array and the counters below, idle workers wait on
+   * cond */
+  GMutex lock;
+  GCond cond;
+  GCond exit_cond;
+  GPtrArray *workers;
+  guint n_threads;
+  guint n_blocked;
+  gboolean started;
+  gboolean shutdown;
+
+  GMutex injector_lock;
+  GstVecDeque *injector;
+
+  /* atomic */
+  gint n_queued;
+  gint n_idle;
+};
+
+static GPrivate current_worker;
+
+#define GST_WORK_STEALING_TASK_POOL_CAST(pool) ((GstWorkStealingTaskPool*)(pool))
+
+G_DEFINE_TYPE_WITH_PRIVATE (GstWorkStealingTaskPool,
+    gst_work_stealing_task_pool, GST_TYPE_TASK_POOL);
+
+static SharedTaskData *
+ws_pop_injector (GstWorkStealingTaskPoolPrivate * priv)
+{
+  SharedTaskData *tdata;
+
+  g_mutex_lock (&priv->injector_lock);
+  tdata = gst_vec_deque_pop_head (priv->injector);
+  g_mutex_unlock (&priv->injector_lock);
+
+  return tdata;
+}
+
+static SharedTaskData *
+ws_steal (WSWorker * worker)
+{
+  GstWorkStealingTaskPoolPrivate *priv = worker->pool->priv;
+  SharedTaskData *tdata = NULL;
+  guint i, n;
+
+  g_mutex_lock (&priv->lock);
+  n = priv->workers->len;
+  for (i = 0; i < n && tdata == NULL; i++) {
+    WSWorker *victim =
+        g_ptr_array_index (priv->workers, (worker->tick + i) % n);
+
+    if (victim == worker)
+      continue;
+
+    g_mutex_lock (&victim->lock);
+    tdata = gst_vec_deque_pop_tail (victim->jobs);
+    g_mutex_unlock (&victim->lock);
+  }
+  g_mutex_unlock (&priv->lock);
+
+  return tdata;
+}
+
+static SharedTaskData *
+ws_next_job (WSWorker * worker)
+{
+  GstWorkStealingTaskPoolPrivate *priv = worker->pool->priv;
+  SharedTaskData *tdata;
+
+  if (++worker->tick % WS_INJECTOR_INTERVAL == 0
+      && (tdata = ws_pop_injector (priv)))
+    return tdata;
+
+  g_mutex_lock (&worker->lock);
+  tdata = gst_vec_deque_pop_head (worker->jobs);
+  g_mutex_unlock (&worker->lock);
+  if (tdata)
+    return tdata;
+
+  if (g_atomic_int_get (&priv->n_queued) == 0)
+    return NULL;
+
+  if ((tdata = ws_pop_injector (priv)))
+    return tdata;
+
+  return ws_steal (worker);
+}
+
+static gpointer
+ws_worker_func (WSWorker * worker)
+{
+  GstWorkStealingTaskPool *pool = worker->pool;
+  GstWorkStealingTaskPoolPrivate *priv = pool->priv;
+  SharedTaskData *tdata;
+
+  g_private_set (&current_worker, worker);
+
+  while (TRUE) {
+    if ((tdata = ws_next_job (worker))) {
+      g_atomic_int_add (&priv->n_queued, -1);
+      shared_func (tdata, GST_TASK_POOL_CAST (pool));
+      continue;
+    }
+
+    g_mutex_lock (&priv->lock);
+    /* exit when shutting down, or when we were started to replace a blocked
+     * worker that is running again */
+    if ((priv->shutdown && g_atomic_int_get (&priv->n_queued) == 0)
+        || priv->n_threads - priv->n_blocked > priv->n_workers)
+      break;
+
+    /* pairs with the check of n_idle in ws_push() */
+    g_atomic_int_inc (&priv->n_idle);
+    if (g_atomic_int_get (&priv->n_queued) == 0 && !priv->shutdown)
+      g_cond_wait (&priv->cond, &priv->lock);
+    g_atomic_int_add (&priv->n_idle, -1);
+    g_mutex_unlock (&priv->lock);
+  }
+
+  g_ptr_array_remove_fast (priv->workers, worker);
+  priv->n_threads--;
+  GST_DEBUG_OBJECT (pool, "worker exiting, %u threads left", priv->n_threads);
+  g_cond_broadcast (&priv->exit_cond);
+  g_mutex_unlock (&priv->lock);
+
+  g_private_set (&current_worker, NULL);
+  gst_vec_deque_free (worker->jobs);
+  g_mutex_clear (&worker->lock);
+  g_free (worker);
+
+  return NULL;
+}
+
+/* called with the pool lock */
+static gboolean
+ws_start_worker_unlocked (GstWorkStealingTaskPool * pool, GError ** error)
+{
+  GstWorkStealingTaskPoolPrivate *priv = pool->priv;
+  WSWorker *worker;
+  GThread *thread;
+
+  worker = g_new0 (WSWorker, 1);
+  worker->pool = pool;
+  g_mutex_init (&worker->lock);
+  worker->jobs = gst_vec_deque_new (16);
+
+  thread = g_thread_try_new ("GstWorker", (GThreadFunc) ws_worker_func, worker,
+      error);
+  if (thread == NULL) {
+    gst_vec_deque_free (worker->jobs);
+    g_mutex_clear (&worker->lock);
+    g_free (worker);
+    return FALSE;
+  }
+  g_thread_unref (thread);
+
+  g_ptr_array_add (priv->workers, worker);
+  priv->n_threads++;
+
+  return TRUE;
+}
+
+static void
+ws_prepare (GstTaskPool * pool, GError ** error)
+{
+  GstWorkStealingTaskPool *ws_pool = GST_WORK_STEALING_TASK_POOL_CAST (pool);
+  GstWorkStealingTaskPoolPrivate *priv = ws_pool->priv;
+  guint i;
+
+  g_mutex_lock (&priv->lock);
+  if (!priv->started) {
+    priv->started = TRUE;
+    priv->shutdown = FALSE;
+    for (i = 0; i < priv->n_workers; i++) {
+      if (!ws_start_worker_unlocked (ws_pool, i == 0 ? error : NULL))
+        break;
+    }
+    GST_DEBUG_OBJECT (pool, "started %u workers", priv->n_threads);
+  }
+  g_mutex_unlock (&priv->lock);
+}
+
+static void
+ws_cleanup (GstTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv =
+      GST_WORK_STEALING_TASK_POOL_CAST (pool)->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->shutdown = TRUE;
+  g_cond_broadcast (&priv->cond);
+  /* the workers run all queued jobs before exiting */
+  while (priv->n_threads > 0)
+    g_cond_wait (&priv->exit_cond, &priv->lock);
+  priv->started = FALSE;
+  g_mutex_unlock (&priv->lock);
+}
+
+static gpointer
+ws_push (GstTaskPool * pool, GstTaskPoolFunction func,
+    gpointer user_data, GError ** error)
+{
+  GstWorkStealingTaskPool *ws_pool = GST_WORK_STEALING_TASK_POOL_CAST (pool);
+  GstWorkStealingTaskPoolPrivate *priv = ws_pool->priv;
+  WSWorker *worker = g_private_get (&current_worker);
+  SharedTaskData *tdata;
+
+  g_mutex_lock (&priv->lock);
+  if (!priv->started || priv->shutdown)
+    goto not_started;
+  g_mutex_unlock (&priv->lock);
+
+  tdata = shared_task_data_new (func, user_data);
+
+  g_atomic_int_inc (&priv->n_queued);
+  if (worker != NULL && worker->pool == ws_pool) {
+    g_mutex_lock (&worker->lock);
+    gst_vec_deque_push_tail (worker->jobs, shared_task_data_ref (tdata));
+    g_mutex_unlock (&worker->lock);
+  } else {
+    g_mutex_lock (&priv->injector_lock);
+    gst_vec_deque_push_tail (priv->injector, shared_task_data_ref (tdata));
+    g_mutex_unlock (&priv->injector_lock);
+  }
+
+  /* pairs with the check of n_queued before an idle worker waits */
+  if (g_atomic_int_get (&priv->n_idle) > 0) {
+    g_mutex_lock (&priv->lock);
+    g_cond_signal (&priv->cond);
+    g_mutex_unlock (&priv->lock);
+  }
+
+  return tdata;
+
+  /* ERRORS */
+not_started:
+  {
+    g_mutex_unlock (&priv->lock);
+    g_set_error_literal (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "Task pool is not prepared");
+    return NULL;
+  }
+}
+
+static void
+gst_work_stealing_task_pool_finalize (GObject * object)
+{
+  GstWorkStealingTaskPoolPrivate *priv =
+      GST_WORK_STEALING_TASK_POOL_CAST (object)->priv;
+
+  /* a prepared pool keeps running until it is cleaned up */
+  g_warn_if_fail (priv->n_threads == 0);
+
+  g_ptr_array_free (priv->workers, TRUE);
+  gst_vec_deque_free (priv->injector);
+  g_mutex_clear (&priv->injector_lock);
+  g_cond_clear (&priv->exit_cond);
+  g_cond_clear (&priv->cond);
+  g_mutex_clear (&priv->lock);
+
+  G_OBJECT_CLASS (gst_work_stealing_task_pool_parent_class)->finalize (object);
+}
+
+static void
+gst_work_stealing_task_pool_class_init (GstWorkStealingTaskPoolClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstTaskPoolClass *taskpoolclass = GST_TASK_POOL_CLASS (klass);
+
+  gobject_class->finalize = gst_work_stealing_task_pool_finalize;
+
+  taskpoolclass->prepare = ws_prepare;
+  taskpoolclass->cleanup = ws_cleanup;
+  taskpoolclass->push = ws_push;
+  taskpoolclass->join = shared_join;
+  taskpoolclass->dispose_handle = shared_dispose_handle;
+}
+
+static void
+gst_work_stealing_task_pool_init (GstWorkStealingTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv;
+
+  priv = pool->priv = gst_work_stealing_task_pool_get_instance_private (pool);
+
+  g_mutex_init (&priv->lock);
+  g_cond_init (&priv->cond);
+  g_cond_init (&priv->exit_cond);
+  priv->workers = g_ptr_array_new ();
+  g_mutex_init (&priv->injector_lock);
+  priv->injector = gst_vec_deque_new (16);
+  priv->n_workers = g_get_num_processors ();
+}
+
+/**
+ * gst_work_stealing_task_pool_new:
+ * @n_workers: the number of worker threads, or 0 for one per CPU core
+ *
+ * Create a new work stealing task pool. The pool runs the pushed functions
+ * on @n_workers threads. When it is used for #GstTask, every iteration of
+ * the task function is run as a separate job and paused tasks don't occupy
+ * a thread, so that many tasks can share a few threads.
+ *
+ * Code that runs on a worker and is about to block for an unbounded time,
+ * for example waiting for space in a full queue, should be wrapped with
+ * gst_task_pool_blocking_begin() and gst_task_pool_blocking_end() so that
+ * another worker can take over in the meantime. #GstClock waits, #GstQueue
+ * and #GstBaseSink already do this.
+ *
+ * The pool must be prepared with gst_task_pool_prepare() before use and
+ * cleaned up with gst_task_pool_cleanup() before it is released.
+ *
+ * Returns: (transfer full): a new #GstWorkStealingTaskPool.
+ *     gst_object_unref() after usage.
+ *
+ * Since: 1.30
+ */
+GstTaskPool *
+gst_work_stealing_task_pool_new (guint n_workers)
+{
+  GstWorkStealingTaskPool *pool;
+
+  pool = g_object_new (GST_TYPE_WORK_STEALING_TASK_POOL, NULL);
+  if (n_workers > 0)
+    pool->priv->n_workers = n_workers;
+
+  /* clear floating flag */
+  gst_object_ref_sink (pool);
+
+  return GST_TASK_POOL_CAST (pool);
+}
+
+/**
+ * gst_work_stealing_task_pool_get_n_workers:
+ * @pool: a #GstWorkStealingTaskPool
+ *
+ * Returns: the number of workers that @pool keeps available for running
+ *     jobs.
+ *
+ * Since: 1.30
+ */
+guint
+gst_work_stealing_task_pool_get_n_workers (GstWorkStealingTaskPool * pool)
+{
+  g_return_val_if_fail (GST_IS_WORK_STEALING_TASK_POOL (pool), 0);
+
+  return pool->priv->n_workers;
+}
+
+/**
+ * gst_task_pool_blocking_begin:
+ *
+ * Notifies the #GstWorkStealingTaskPool that runs the calling thread that
+ * it is about to block, so that another worker can run the queued jobs in the
+ * meantime. Calls can be nested and must be balanced with
+ * gst_task_pool_blocking_end().
+ *
+ * This is meant to be called right before waiting on a condition variable,
+ * with the mutex of the wait still held, and the matching
+ * gst_task_pool_blocking_end() right after the wait returns. The pool only
+ * takes its own lock here, and never calls out while holding it, so this is
+ * safe with any other locks held.
+ *
+ * This does nothing when called from a thread that is not a worker of a
+ * #GstWorkStealingTaskPool.
+ *
+ * Since: 1.30
+ */
+void
+gst_task_pool_blocking_begin (void)
+{
+  WSWorker *worker = g_private_get (&current_worker);
+  GstWorkStealingTaskPoolPrivate *priv;
+
+  if (G_LIKELY (worker == NULL) || worker->blocking++ > 0)
+    return;
+
+  priv = worker->pool->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->n_blocked++;
+  /* keep n_workers threads available for the queued jobs */
+  if (priv->n_threads - priv->n_blocked < priv->n_workers && !priv->shutdown) {
+    GST_LOG_OBJECT (worker->pool, "worker blocking, starting another one");
+    ws_start_worker_unlocked (worker->pool, NULL);
+  }
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_task_pool_blocking_end:
+ *
+ * Ends a section started with gst_task_pool_blocking_begin(). Like that, it
+ * can be called with any other locks held.
+ *
+ * Since: 1.30
+ */
+void
+gst_task_pool_blocking_end (void)
+{
+  WSWorker *worker = g_private_get (&current_worker);
+  GstWorkStealingTaskPoolPrivate *priv;
+
+  if (G_LIKELY (worker == NULL))
+    return;
+
+  g_return_if_fail (worker->blocking > 0);
+
+  if (--worker->blocking > 0)
+    return;
+
+  priv = worker->pool->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->n_blocked--;
+  g_mutex_unlock (&priv->lock);
+}
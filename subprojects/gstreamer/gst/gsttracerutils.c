@@ -73,6 +73,7 @@ GQuark _priv_gst_tracer_quark_table[GST_TRACER_QUARK_MAX + 1];
 
 gboolean _priv_tracer_enabled = FALSE;
 GHashTable *_priv_tracers = NULL;
+gboolean _priv_tracer_hook_enabled[GST_TRACER_QUARK_MAX + 1] = { FALSE, };
 
 GST_DEBUG_CATEGORY_EXTERN (tracer_debug);
 
@@ -487,6 +488,7 @@ _priv_gst_tracing_deinit (void)
   }
 
   _priv_tracer_enabled = FALSE;
+  memset (_priv_tracer_hook_enabled, 0, sizeof (_priv_tracer_hook_enabled));
 
   G_LOCK (span_formats);
   g_clear_pointer (&_priv_span_formats, g_ptr_array_unref);
@@ -499,6 +501,8 @@ gst_tracing_register_hook_id (GstTracer * tracer, GQuark detail, GCallback func)
   gpointer key = GINT_TO_POINTER (detail);
   GList *list = g_hash_table_lookup (_priv_tracers, key);
   GstTracerHook *hook = g_new0 (GstTracerHook, 1);
+  guint i;
+
   hook->tracer = gst_object_ref (tracer);
   hook->func = func;
 
@@ -506,6 +510,11 @@ gst_tracing_register_hook_id (GstTracer * tracer, GQuark detail, GCallback func)
   g_hash_table_replace (_priv_tracers, key, list);
   GST_DEBUG ("registering tracer for '%s', list.len=%d",
       (detail ? g_quark_to_string (detail) : "*"), g_list_length (list));
+
+  for (i = 0; i <= GST_TRACER_QUARK_MAX; i++) {
+    if (detail == 0 || _priv_gst_tracer_quark_table[i] == detail)
+      _priv_tracer_hook_enabled[i] = TRUE;
+  }
   _priv_tracer_enabled = TRUE;
 }
 
@@ -1092,7 +1101,7 @@ gst_trace_span_begin (GstTraceFormat * format, const GstTraceValue * values)
 
   span_id = (GstTraceSpanId)
       (g_atomic_int_add (&_priv_span_id_counter, 1) + 1);
-  GST_TRACER_DISPATCH (GST_TRACER_QUARK (HOOK_SPAN_BEGIN),
+  GST_TRACER_DISPATCH (GST_TRACER_QUARK_HOOK_SPAN_BEGIN,
       GstTracerHookSpanBegin, (GST_TRACER_ARGS, span_id, format, values));
 
   return span_id;
@@ -1113,7 +1122,7 @@ gst_trace_span_end (GstTraceSpanId span_id)
   if (G_LIKELY (span_id == GST_TRACE_SPAN_ID_NONE))
     return;
 
-  GST_TRACER_DISPATCH (GST_TRACER_QUARK (HOOK_SPAN_END),
+  GST_TRACER_DISPATCH (GST_TRACER_QUARK_HOOK_SPAN_END,
       GstTracerHookSpanEnd, (GST_TRACER_ARGS, span_id));
 }
 
@@ -1160,7 +1169,7 @@ gst_trace_event (GstTraceFormat * format, const GstTraceValue * values)
   if (G_UNLIKELY (!format))
     return;
 
-  GST_TRACER_DISPATCH (GST_TRACER_QUARK (HOOK_EVENT),
+  GST_TRACER_DISPATCH (GST_TRACER_QUARK_HOOK_EVENT,
       GstTracerHookEvent, (GST_TRACER_ARGS, format, values));
 }
 
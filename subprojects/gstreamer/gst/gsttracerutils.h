@@ -180,6 +180,9 @@ typedef struct {
 extern gboolean _priv_tracer_enabled;
 /* key are hook-id quarks, values are GstTracerHook */
 extern GHashTable *_priv_tracers;
+/* TRUE for each GstTracerQuarkId that has hooks registered, so that hooks
+ * nobody listens to don't need to look up anything */
+extern gboolean _priv_tracer_hook_enabled[GST_TRACER_QUARK_MAX + 1];
 
 #define GST_TRACER_IS_ENABLED (_priv_tracer_enabled)
 
@@ -189,12 +192,13 @@ extern GHashTable *_priv_tracers;
 /* tracing hooks */
 
 #define GST_TRACER_ARGS h->tracer, ts
-#define GST_TRACER_DISPATCH(key,type,args) G_STMT_START{ \
-  if (GST_TRACER_IS_ENABLED) {                                         \
+#define GST_TRACER_DISPATCH(id,type,args) G_STMT_START{ \
+  if (GST_TRACER_IS_ENABLED && _priv_tracer_hook_enabled[id]) {        \
     GstClockTime ts = GST_TRACER_TS;                                   \
     GList *__l, *__n;                                                  \
     GstTracerHook *h;                                                  \
-    __l = g_hash_table_lookup (_priv_tracers, GINT_TO_POINTER (key));  \
+    __l = g_hash_table_lookup (_priv_tracers,                          \
+        GINT_TO_POINTER (_priv_gst_tracer_quark_table[id]));           \
     for (__n = __l; __n; __n = g_list_next (__n)) {                    \
       h = (GstTracerHook *) __n->data;                                 \
       ((type)(h->func)) args;                                          \
@@ -219,7 +223,7 @@ extern GHashTable *_priv_tracers;
 typedef void (*GstTracerHookPadPushPre) (GObject *self, GstClockTime ts,
     GstPad *pad, GstBuffer *buffer);
 #define GST_TRACER_PAD_PUSH_PRE(pad, buffer) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_PUSH_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_PUSH_PRE, \
     GstTracerHookPadPushPre, (GST_TRACER_ARGS, pad, buffer)); \
 }G_STMT_END
 
@@ -235,7 +239,7 @@ typedef void (*GstTracerHookPadPushPre) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookPadPushPost) (GObject * self, GstClockTime ts,
     GstPad *pad, GstFlowReturn res);
 #define GST_TRACER_PAD_PUSH_POST(pad, res) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_PUSH_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_PUSH_POST, \
     GstTracerHookPadPushPost, (GST_TRACER_ARGS, pad, res)); \
 }G_STMT_END
 
@@ -251,7 +255,7 @@ typedef void (*GstTracerHookPadPushPost) (GObject * self, GstClockTime ts,
 typedef void (*GstTracerHookPadPushListPre) (GObject *self, GstClockTime ts,
     GstPad *pad, GstBufferList *list);
 #define GST_TRACER_PAD_PUSH_LIST_PRE(pad, list) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_PUSH_LIST_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_PUSH_LIST_PRE, \
     GstTracerHookPadPushListPre, (GST_TRACER_ARGS, pad, list)); \
 }G_STMT_END
 
@@ -268,7 +272,7 @@ typedef void (*GstTracerHookPadPushListPost) (GObject *self, GstClockTime ts,
     GstPad *pad,
     GstFlowReturn res);
 #define GST_TRACER_PAD_PUSH_LIST_POST(pad, res) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_PUSH_LIST_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_PUSH_LIST_POST, \
     GstTracerHookPadPushListPost, (GST_TRACER_ARGS, pad, res)); \
 }G_STMT_END
 
@@ -285,7 +289,7 @@ typedef void (*GstTracerHookPadPushListPost) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookPadPullRangePre) (GObject *self, GstClockTime ts,
     GstPad *pad, guint64 offset, guint size);
 #define GST_TRACER_PAD_PULL_RANGE_PRE(pad, offset, size) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_PULL_RANGE_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_PULL_RANGE_PRE, \
     GstTracerHookPadPullRangePre, (GST_TRACER_ARGS, pad, offset, size)); \
 }G_STMT_END
 
@@ -302,7 +306,7 @@ typedef void (*GstTracerHookPadPullRangePre) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookPadPullRangePost) (GObject *self, GstClockTime ts,
     GstPad *pad, GstBuffer *buffer, GstFlowReturn res);
 #define GST_TRACER_PAD_PULL_RANGE_POST(pad, buffer, res) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_PULL_RANGE_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_PULL_RANGE_POST, \
     GstTracerHookPadPullRangePost, (GST_TRACER_ARGS, pad, buffer, res)); \
 }G_STMT_END
 
@@ -323,7 +327,7 @@ typedef void (*GstTracerHookPadPullRangePost) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookPadPushEventPre) (GObject *self, GstClockTime ts,
     GstPad *pad, GstEvent *event);
 #define GST_TRACER_PAD_PUSH_EVENT_PRE(pad, event) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_PUSH_EVENT_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_PUSH_EVENT_PRE, \
     GstTracerHookPadPushEventPre, (GST_TRACER_ARGS, pad, event)); \
 }G_STMT_END
 
@@ -344,7 +348,7 @@ typedef void (*GstTracerHookPadPushEventPre) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookPadPushEventPost) (GObject *self, GstClockTime ts,
     GstPad *pad, gboolean res);
 #define GST_TRACER_PAD_PUSH_EVENT_POST(pad, res) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_PUSH_EVENT_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_PUSH_EVENT_POST, \
     GstTracerHookPadPushEventPost, (GST_TRACER_ARGS, pad, res)); \
 }G_STMT_END
 
@@ -360,7 +364,7 @@ typedef void (*GstTracerHookPadPushEventPost) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookPadSendEventPre) (GObject *self, GstClockTime ts,
     GstPad *pad, GstEvent *event);
 #define GST_TRACER_PAD_SEND_EVENT_PRE(pad, event) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_SEND_EVENT_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_SEND_EVENT_PRE, \
     GstTracerHookPadSendEventPre, (GST_TRACER_ARGS, pad, event)); \
 }G_STMT_END
 
@@ -376,7 +380,7 @@ typedef void (*GstTracerHookPadSendEventPre) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookPadSendEventPost) (GObject *self, GstClockTime ts,
     GstPad *pad, GstFlowReturn res);
 #define GST_TRACER_PAD_SEND_EVENT_POST(pad, res) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_SEND_EVENT_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_SEND_EVENT_POST, \
     GstTracerHookPadSendEventPost, (GST_TRACER_ARGS, pad, res)); \
 }G_STMT_END
 
@@ -392,7 +396,7 @@ typedef void (*GstTracerHookPadSendEventPost) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookPadQueryPre) (GObject *self, GstClockTime ts,
     GstPad *pad, GstQuery *query);
 #define GST_TRACER_PAD_QUERY_PRE(pad, query) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_QUERY_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_QUERY_PRE, \
     GstTracerHookPadQueryPre, (GST_TRACER_ARGS, pad, query)); \
 }G_STMT_END
 
@@ -409,7 +413,7 @@ typedef void (*GstTracerHookPadQueryPre) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookPadQueryPost) (GObject *self, GstClockTime ts,
     GstPad *pad, GstQuery *query, gboolean res);
 #define GST_TRACER_PAD_QUERY_POST(pad, query, res) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_QUERY_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_QUERY_POST, \
     GstTracerHookPadQueryPost, (GST_TRACER_ARGS, pad, query, res)); \
 }G_STMT_END
 
@@ -425,7 +429,7 @@ typedef void (*GstTracerHookPadQueryPost) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookElementPostMessagePre) (GObject *self,
     GstClockTime ts, GstElement *element, GstMessage *message);
 #define GST_TRACER_ELEMENT_POST_MESSAGE_PRE(element, message) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_ELEMENT_POST_MESSAGE_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_ELEMENT_POST_MESSAGE_PRE, \
     GstTracerHookElementPostMessagePre, (GST_TRACER_ARGS, element, message)); \
 }G_STMT_END
 
@@ -441,7 +445,7 @@ typedef void (*GstTracerHookElementPostMessagePre) (GObject *self,
 typedef void (*GstTracerHookElementPostMessagePost) (GObject *self,
     GstClockTime ts, GstElement *element, gboolean res);
 #define GST_TRACER_ELEMENT_POST_MESSAGE_POST(element, res) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_ELEMENT_POST_MESSAGE_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_ELEMENT_POST_MESSAGE_POST, \
     GstTracerHookElementPostMessagePost, (GST_TRACER_ARGS, element, res)); \
 }G_STMT_END
 
@@ -457,7 +461,7 @@ typedef void (*GstTracerHookElementPostMessagePost) (GObject *self,
 typedef void (*GstTracerHookElementQueryPre) (GObject *self, GstClockTime ts,
     GstElement *element, GstQuery *query);
 #define GST_TRACER_ELEMENT_QUERY_PRE(element, query) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_ELEMENT_QUERY_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_ELEMENT_QUERY_PRE, \
     GstTracerHookElementQueryPre, (GST_TRACER_ARGS, element, query)); \
 }G_STMT_END
 
@@ -474,7 +478,7 @@ typedef void (*GstTracerHookElementQueryPre) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookElementQueryPost) (GObject *self, GstClockTime ts,
     GstElement *element, GstQuery *query, gboolean res);
 #define GST_TRACER_ELEMENT_QUERY_POST(element, query, res) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_ELEMENT_QUERY_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_ELEMENT_QUERY_POST, \
     GstTracerHookElementQueryPost, (GST_TRACER_ARGS, element, query, res)); \
 }G_STMT_END
 
@@ -489,7 +493,7 @@ typedef void (*GstTracerHookElementQueryPost) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookElementNew) (GObject *self, GstClockTime ts,
     GstElement *element);
 #define GST_TRACER_ELEMENT_NEW(element) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_ELEMENT_NEW), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_ELEMENT_NEW, \
     GstTracerHookElementNew, (GST_TRACER_ARGS, element)); \
 }G_STMT_END
 
@@ -505,7 +509,7 @@ typedef void (*GstTracerHookElementNew) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookElementAddPad) (GObject *self, GstClockTime ts,
     GstElement *element, GstPad *pad);
 #define GST_TRACER_ELEMENT_ADD_PAD(element, pad) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_ELEMENT_ADD_PAD), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_ELEMENT_ADD_PAD, \
     GstTracerHookElementAddPad, (GST_TRACER_ARGS, element, pad)); \
 }G_STMT_END
 
@@ -521,7 +525,7 @@ typedef void (*GstTracerHookElementAddPad) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookElementRemovePad) (GObject *self, GstClockTime ts,
     GstElement *element, GstPad *pad);
 #define GST_TRACER_ELEMENT_REMOVE_PAD(element, pad) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_ELEMENT_REMOVE_PAD), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_ELEMENT_REMOVE_PAD, \
     GstTracerHookElementRemovePad, (GST_TRACER_ARGS, element, pad)); \
 }G_STMT_END
 
@@ -537,7 +541,7 @@ typedef void (*GstTracerHookElementRemovePad) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookElementChangeStatePre) (GObject *self,
     GstClockTime ts, GstElement *element, GstStateChange transition);
 #define GST_TRACER_ELEMENT_CHANGE_STATE_PRE(element, transition) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_ELEMENT_CHANGE_STATE_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_ELEMENT_CHANGE_STATE_PRE, \
     GstTracerHookElementChangeStatePre, (GST_TRACER_ARGS, element, transition)); \
 }G_STMT_END
 
@@ -555,7 +559,7 @@ typedef void (*GstTracerHookElementChangeStatePost) (GObject *self,
     GstClockTime ts, GstElement *element, GstStateChange transition,
     GstStateChangeReturn result);
 #define GST_TRACER_ELEMENT_CHANGE_STATE_POST(element, transition, result) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_ELEMENT_CHANGE_STATE_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_ELEMENT_CHANGE_STATE_POST, \
     GstTracerHookElementChangeStatePost, (GST_TRACER_ARGS, element, transition, result)); \
 }G_STMT_END
 
@@ -571,7 +575,7 @@ typedef void (*GstTracerHookElementChangeStatePost) (GObject *self,
 typedef void (*GstTracerHookBinAddPre) (GObject *self, GstClockTime ts,
     GstBin *bin, GstElement *element);
 #define GST_TRACER_BIN_ADD_PRE(bin, element) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_BIN_ADD_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_BIN_ADD_PRE, \
     GstTracerHookBinAddPre, (GST_TRACER_ARGS, bin, element)); \
 }G_STMT_END
 
@@ -588,7 +592,7 @@ typedef void (*GstTracerHookBinAddPre) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookBinAddPost) (GObject *self, GstClockTime ts,
     GstBin *bin, GstElement *element, gboolean result);
 #define GST_TRACER_BIN_ADD_POST(bin, element, result) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_BIN_ADD_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_BIN_ADD_POST, \
     GstTracerHookBinAddPost, (GST_TRACER_ARGS, bin, element, result)); \
 }G_STMT_END
 
@@ -604,7 +608,7 @@ typedef void (*GstTracerHookBinAddPost) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookBinRemovePre) (GObject *self, GstClockTime ts,
     GstBin *bin, GstElement *element);
 #define GST_TRACER_BIN_REMOVE_PRE(bin, element) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_BIN_REMOVE_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_BIN_REMOVE_PRE, \
     GstTracerHookBinRemovePre, (GST_TRACER_ARGS, bin, element)); \
 }G_STMT_END
 
@@ -620,7 +624,7 @@ typedef void (*GstTracerHookBinRemovePre) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookBinRemovePost) (GObject *self, GstClockTime ts,
     GstBin *bin, gboolean result);
 #define GST_TRACER_BIN_REMOVE_POST(bin, result) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_BIN_REMOVE_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_BIN_REMOVE_POST, \
     GstTracerHookBinRemovePost, (GST_TRACER_ARGS, bin, result)); \
 }G_STMT_END
 
@@ -636,7 +640,7 @@ typedef void (*GstTracerHookBinRemovePost) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookPadLinkPre) (GObject *self, GstClockTime ts,
     GstPad *srcpad, GstPad *sinkpad);
 #define GST_TRACER_PAD_LINK_PRE(srcpad, sinkpad) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_LINK_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_LINK_PRE, \
     GstTracerHookPadLinkPre, (GST_TRACER_ARGS, srcpad, sinkpad)); \
 }G_STMT_END
 
@@ -653,7 +657,7 @@ typedef void (*GstTracerHookPadLinkPre) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookPadLinkPost) (GObject *self, GstClockTime ts,
     GstPad *srcpad, GstPad *sinkpad, GstPadLinkReturn result);
 #define GST_TRACER_PAD_LINK_POST(srcpad, sinkpad, result) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_LINK_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_LINK_POST, \
     GstTracerHookPadLinkPost, (GST_TRACER_ARGS, srcpad, sinkpad, result)); \
 }G_STMT_END
 
@@ -669,7 +673,7 @@ typedef void (*GstTracerHookPadLinkPost) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookPadUnlinkPre) (GObject *self, GstClockTime ts,
     GstPad *srcpad, GstPad *sinkpad);
 #define GST_TRACER_PAD_UNLINK_PRE(srcpad, sinkpad) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_UNLINK_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_UNLINK_PRE, \
     GstTracerHookPadUnlinkPre, (GST_TRACER_ARGS, srcpad, sinkpad)); \
 }G_STMT_END
 
@@ -686,7 +690,7 @@ typedef void (*GstTracerHookPadUnlinkPre) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookPadUnlinkPost) (GObject *self, GstClockTime ts,
     GstPad *srcpad, GstPad *sinkpad, gboolean result);
 #define GST_TRACER_PAD_UNLINK_POST(srcpad, sinkpad, result) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_UNLINK_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_UNLINK_POST, \
     GstTracerHookPadUnlinkPost, (GST_TRACER_ARGS, srcpad, sinkpad, result)); \
 }G_STMT_END
 
@@ -701,7 +705,7 @@ typedef void (*GstTracerHookPadUnlinkPost) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookMiniObjectCreated) (GObject *self, GstClockTime ts,
     GstMiniObject *object);
 #define GST_TRACER_MINI_OBJECT_CREATED(object) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_MINI_OBJECT_CREATED), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_MINI_OBJECT_CREATED, \
     GstTracerHookMiniObjectCreated, (GST_TRACER_ARGS, object)); \
 }G_STMT_END
 
@@ -717,7 +721,7 @@ typedef void (*GstTracerHookMiniObjectCreated) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookMiniObjectDestroyed) (GObject *self, GstClockTime ts,
     GstMiniObject *object);
 #define GST_TRACER_MINI_OBJECT_DESTROYED(object) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_MINI_OBJECT_DESTROYED), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_MINI_OBJECT_DESTROYED, \
     GstTracerHookMiniObjectDestroyed, (GST_TRACER_ARGS, object)); \
 }G_STMT_END
 
@@ -734,7 +738,7 @@ typedef void (*GstTracerHookMiniObjectDestroyed) (GObject *self, GstClockTime ts
 typedef void (*GstTracerHookObjectUnreffed) (GObject *self, GstClockTime ts,
     GstObject *object, gint new_refcount);
 #define GST_TRACER_OBJECT_UNREFFED(object, new_refcount) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_OBJECT_UNREFFED), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_OBJECT_UNREFFED, \
     GstTracerHookObjectUnreffed, (GST_TRACER_ARGS, object, new_refcount)); \
 }G_STMT_END
 
@@ -751,7 +755,7 @@ typedef void (*GstTracerHookObjectUnreffed) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookObjectReffed) (GObject *self, GstClockTime ts,
     GstObject *object, gint new_refcount);
 #define GST_TRACER_OBJECT_REFFED(object, new_refcount) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_OBJECT_REFFED), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_OBJECT_REFFED, \
     GstTracerHookObjectReffed, (GST_TRACER_ARGS, object, new_refcount)); \
 }G_STMT_END
 
@@ -769,7 +773,7 @@ typedef void (*GstTracerHookObjectReffed) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookObjectParentSet) (GObject *self, GstClockTime ts,
     GstObject *object, GstObject *parent);
 #define GST_TRACER_OBJECT_PARENT_SET(object, parent) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_OBJECT_PARENT_SET), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_OBJECT_PARENT_SET, \
     GstTracerHookObjectParentSet, (GST_TRACER_ARGS, object, parent)); \
 }G_STMT_END
 
@@ -832,7 +836,7 @@ typedef void (*GstTracerHookEvent) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookMiniObjectUnreffed) (GObject *self, GstClockTime ts,
     GstMiniObject *object, gint new_refcount);
 #define GST_TRACER_MINI_OBJECT_UNREFFED(object, new_refcount) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_MINI_OBJECT_UNREFFED), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_MINI_OBJECT_UNREFFED, \
     GstTracerHookMiniObjectUnreffed, (GST_TRACER_ARGS, object, new_refcount)); \
 }G_STMT_END
 
@@ -849,7 +853,7 @@ typedef void (*GstTracerHookMiniObjectUnreffed) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookMiniObjectReffed) (GObject *self, GstClockTime ts,
     GstMiniObject *object, gint new_refcount);
 #define GST_TRACER_MINI_OBJECT_REFFED(object, new_refcount) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_MINI_OBJECT_REFFED), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_MINI_OBJECT_REFFED, \
     GstTracerHookMiniObjectReffed, (GST_TRACER_ARGS, object, new_refcount)); \
 }G_STMT_END
 
@@ -864,7 +868,7 @@ typedef void (*GstTracerHookMiniObjectReffed) (GObject *self, GstClockTime ts,
 typedef void (*GstTracerHookObjectCreated) (GObject *self, GstClockTime ts,
     GstObject *object);
 #define GST_TRACER_OBJECT_CREATED(object) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_OBJECT_CREATED), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_OBJECT_CREATED, \
     GstTracerHookObjectCreated, (GST_TRACER_ARGS, object)); \
 }G_STMT_END
 
@@ -881,7 +885,7 @@ typedef void (*GstTracerHookObjectDestroyed) (GObject *self, GstClockTime ts,
     GstObject *object);
 
 #define GST_TRACER_OBJECT_DESTROYED(object) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_OBJECT_DESTROYED), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_OBJECT_DESTROYED, \
     GstTracerHookObjectDestroyed, (GST_TRACER_ARGS, object)); \
 }G_STMT_END
 
@@ -907,7 +911,7 @@ typedef void (*GstTracerHookPluginFeatureLoaded) (GObject *self, GstClockTime ts
  * Since: 1.20
  */
 #define GST_TRACER_PLUGIN_FEATURE_LOADED(feature) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PLUGIN_FEATURE_LOADED), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PLUGIN_FEATURE_LOADED, \
     GstTracerHookPluginFeatureLoaded, (GST_TRACER_ARGS, feature)); \
 }G_STMT_END
 
@@ -935,7 +939,7 @@ typedef void (*GstTracerHookPadChainPre) (GObject *self, GstClockTime ts,
  * Since: 1.22
  */
 #define GST_TRACER_PAD_CHAIN_PRE(pad, buffer) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_CHAIN_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_CHAIN_PRE, \
     GstTracerHookPadChainPre, (GST_TRACER_ARGS, pad, buffer)); \
 }G_STMT_END
 
@@ -963,7 +967,7 @@ typedef void (*GstTracerHookPadChainPost) (GObject * self, GstClockTime ts,
  * Since: 1.22
  */
 #define GST_TRACER_PAD_CHAIN_POST(pad, res) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_CHAIN_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_CHAIN_POST, \
     GstTracerHookPadChainPost, (GST_TRACER_ARGS, pad, res)); \
 }G_STMT_END
 
@@ -991,7 +995,7 @@ typedef void (*GstTracerHookPadChainListPre) (GObject *self, GstClockTime ts,
  * Since: 1.22
  */
 #define GST_TRACER_PAD_CHAIN_LIST_PRE(pad, list) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_CHAIN_LIST_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_CHAIN_LIST_PRE, \
     GstTracerHookPadChainListPre, (GST_TRACER_ARGS, pad, list)); \
 }G_STMT_END
 
@@ -1020,7 +1024,7 @@ typedef void (*GstTracerHookPadChainListPost) (GObject *self, GstClockTime ts,
  * Since: 1.22
  */
 #define GST_TRACER_PAD_CHAIN_LIST_POST(pad, res) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PAD_CHAIN_LIST_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_PAD_CHAIN_LIST_POST, \
     GstTracerHookPadChainListPost, (GST_TRACER_ARGS, pad, res)); \
 }G_STMT_END
 
@@ -1045,7 +1049,7 @@ typedef void (*GstTracerHookMemoryInit) (GObject *self, GstClockTime ts,
  * Since: 1.26
  */
 #define GST_TRACER_MEMORY_INIT(mem) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_MEMORY_INIT), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_MEMORY_INIT, \
     GstTracerHookMemoryInit, (GST_TRACER_ARGS, mem)); \
 }G_STMT_END
 
@@ -1069,7 +1073,7 @@ typedef void (*GstTracerHookMemoryFreePre) (GObject *self, GstClockTime ts, GstM
  * Since: 1.26
  */
 #define GST_TRACER_MEMORY_FREE_PRE(mem) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_MEMORY_FREE_PRE), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_MEMORY_FREE_PRE, \
     GstTracerHookMemoryFreePre, (GST_TRACER_ARGS, mem)); \
 }G_STMT_END
 
@@ -1093,7 +1097,7 @@ typedef void (*GstTracerHookMemoryFreePost) (GObject *self, GstClockTime ts, Gst
  * Since: 1.26
  */
 #define GST_TRACER_MEMORY_FREE_POST(mem) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_MEMORY_FREE_POST), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_MEMORY_FREE_POST, \
     GstTracerHookMemoryFreePost, (GST_TRACER_ARGS, mem)); \
 }G_STMT_END
 
@@ -1120,7 +1124,7 @@ typedef void (*GstTracerHookPoolBufferQueued) (GObject *self, GstClockTime ts, G
  * Since: 1.28
  */
 #define GST_TRACER_POOL_BUFFER_QUEUED(pool, buf) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_POOL_BUFFER_QUEUED), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_POOL_BUFFER_QUEUED, \
     GstTracerHookPoolBufferQueued, (GST_TRACER_ARGS, pool, buf)); \
 }G_STMT_END
 
@@ -1146,7 +1150,7 @@ typedef void (*GstTracerHookPoolBufferDequeued) (GObject *self, GstClockTime ts,
  * Since: 1.28
  */
 #define GST_TRACER_POOL_BUFFER_DEQUEUED(pool, buffer) G_STMT_START{ \
-  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_POOL_BUFFER_DEQUEUED), \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK_HOOK_POOL_BUFFER_DEQUEUED, \
     GstTracerHookPoolBufferDequeued, (GST_TRACER_ARGS, pool, buffer)); \
 }G_STMT_END
 
@@ -542,7 +542,7 @@ search_by_entry (GstPluginFeature * feature, gpointer search_entry)
     return FALSE;
   factory = GST_ELEMENT_FACTORY_CAST (feature);
 
-  if (factory->uri_type != entry->type)
+  if (gst_element_factory_get_uri_type (factory) != entry->type)
     return FALSE;
 
   protocols = gst_element_factory_get_uri_protocols (factory);
@@ -1417,7 +1417,7 @@ gst_element_factory_can_accept_all_caps_in_direction (GstElementFactory *
   g_return_val_if_fail (factory != NULL, FALSE);
   g_return_val_if_fail (caps != NULL, FALSE);
 
-  templates = factory->staticpadtemplates;
+  templates = (GList *) gst_element_factory_get_static_pad_templates (factory);
 
   while (templates) {
     GstStaticPadTemplate *template = (GstStaticPadTemplate *) templates->data;
@@ -1446,7 +1446,7 @@ gst_element_factory_can_accept_any_caps_in_direction (GstElementFactory *
   g_return_val_if_fail (factory != NULL, FALSE);
   g_return_val_if_fail (caps != NULL, FALSE);
 
-  templates = factory->staticpadtemplates;
+  templates = (GList *) gst_element_factory_get_static_pad_templates (factory);
 
   while (templates) {
     GstStaticPadTemplate *template = (GstStaticPadTemplate *) templates->data;
@@ -5134,3 +5134,70 @@ _priv_gst_thread_pool_cleanup (void)
   }
   G_UNLOCK (thread_pool_lock);
 }
+
+/* Small per-thread caches for the fixed size allocations behind events,
+ * queries and their structures. Serialized events and queries are usually
+ * created and freed again by the same streaming thread, so a few entries are
+ * enough to avoid most of the malloc/free pairs without any locking. */
+#define GST_FREELIST_SIZE 16
+
+typedef struct
+{
+  guint n_items;
+  gpointer items[GST_FREELIST_SIZE];
+} GstFreeList;
+
+static void
+gst_freelists_free (gpointer data)
+{
+  GstFreeList *lists = data;
+  guint i;
+
+  for (i = 0; i < GST_FREELIST_LAST; i++) {
+    while (lists[i].n_items > 0)
+      g_free (lists[i].items[--lists[i].n_items]);
+  }
+  g_free (lists);
+}
+
+static GPrivate freelists = G_PRIVATE_INIT (gst_freelists_free);
+
+gpointer
+_priv_gst_freelist_pop (GstFreeListType type)
+{
+  GstFreeList *lists = g_private_get (&freelists);
+
+  if (lists == NULL || lists[type].n_items == 0)
+    return NULL;
+
+  return lists[type].items[--lists[type].n_items];
+}
+
+gboolean
+_priv_gst_freelist_push (GstFreeListType type, gpointer mem)
+{
+#ifdef USE_POISONING
+  /* keep use-after-free detectable */
+  return FALSE;
+#else
+  GstFreeList *lists = g_private_get (&freelists);
+
+  if (G_UNLIKELY (lists == NULL)) {
+    lists = g_new0 (GstFreeList, GST_FREELIST_LAST);
+    g_private_set (&freelists, lists);
+  }
+
+  if (lists[type].n_items == GST_FREELIST_SIZE)
+    return FALSE;
+
+  lists[type].items[lists[type].n_items++] = mem;
+  return TRUE;
+#endif
+}
+
+/* other threads release their caches when they exit */
+void
+_priv_gst_freelists_cleanup (void)
+{
+  g_private_replace (&freelists, NULL);
+}
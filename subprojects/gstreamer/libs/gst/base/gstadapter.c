@@ -126,6 +126,7 @@
 
 #include <gst/gst_private.h>
 #include "gstadapter.h"
+#include "gstbytescan-private.h"
 #include <string.h>
 #include <gst/base/gstqueuearray.h>
 
@@ -1674,11 +1675,15 @@ gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
   guint8 *bdata;
   GstBuffer *buf;
   guint idx;
+  gboolean start_code;
 
   g_return_val_if_fail (size > 0, -1);
   g_return_val_if_fail (offset + size <= adapter->size, -1);
   g_return_val_if_fail (((~mask) & pattern) == 0, -1);
 
+  /* special case for the start codes of MPEG and H.264/H.265 */
+  start_code = (pattern == 0x00000100 && mask == 0xffffff00);
+
   /* we can't find the pattern with less than 4 bytes */
   if (G_UNLIKELY (size < 4))
     return -1;
@@ -1718,16 +1723,33 @@ gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
   /* now find data */
   do {
     bsize = MIN (bsize, size);
-    for (i = 0; i < bsize; i++) {
-      state = ((state << 8) | bdata[i]);
-      if (G_UNLIKELY ((state & mask) == pattern)) {
-        /* we have a match but we need to have skipped at
-         * least 4 bytes to fill the state. */
-        if (G_LIKELY (skip + i >= 3)) {
-          if (G_LIKELY (value))
-            *value = state;
-          gst_buffer_unmap (buf, &info);
-          return offset + skip + i - 3;
+    if (start_code) {
+      gssize ret;
+
+      /* first complete a start code that began in the previous buffer */
+      for (i = 0; i < MIN (bsize, 3); i++) {
+        state = ((state << 8) | bdata[i]);
+        if (G_UNLIKELY ((state & mask) == pattern) && skip + i >= 3)
+          goto found;
+      }
+
+      /* then look for one within this buffer */
+      ret = gst_byte_scan_start_code (bdata, bsize);
+      if (ret >= 0) {
+        state = GST_READ_UINT32_BE (bdata + ret);
+        i = ret + 3;
+        goto found;
+      }
+      if (bsize >= 4)
+        state = GST_READ_UINT32_BE (bdata + bsize - 4);
+    } else {
+      for (i = 0; i < bsize; i++) {
+        state = ((state << 8) | bdata[i]);
+        if (G_UNLIKELY ((state & mask) == pattern)) {
+          /* we have a match but we need to have skipped at
+           * least 4 bytes to fill the state. */
+          if (G_LIKELY (skip + i >= 3))
+            goto found;
         }
       }
     }
@@ -1753,6 +1775,14 @@ gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
 
   /* nothing found */
   return -1;
+
+found:
+  {
+    if (G_LIKELY (value))
+      *value = state;
+    gst_buffer_unmap (buf, &info);
+    return offset + skip + i - 3;
+  }
 }
 
 /**
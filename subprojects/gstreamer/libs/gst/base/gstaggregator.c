@@ -82,6 +82,11 @@
  *    In addition, if the gap event was flagged with GST_GAP_FLAG_MISSING_DATA,
  *    a custom meta is added to the resulting gap buffer (GstAggregatorMissingDataMeta).
  *
+ *  * When #GstAggregator:batch-size is set, subclasses may produce several
+ *    output intervals from one aggregate call if enough input is queued,
+ *    up to the value returned by gst_aggregator_get_batch_limit(). This
+ *    reduces the per-call overhead for small output intervals or many pads.
+ *
  *  * Subclasses must use (a subclass of) #GstAggregatorPad for both their
  *    sink and source pads.
  *    See gst_element_class_add_static_pad_template_with_gtype().
@@ -289,6 +294,12 @@ struct _GstAggregatorPadPrivate
    */
   GMutex flush_lock;
 
+  /* statistics, protected by the PAD_LOCK */
+  gboolean starved;             /* no data when the aggregator last checked */
+  guint64 consumed;
+  GstClockTime wait_time;
+  GstClockTime blocked_time;
+
   /* properties */
   gboolean emit_signals;
 };
@@ -412,11 +423,21 @@ struct _GstAggregatorPrivate
   GstBufferPool *pool;
   GstAllocationParams allocation_params;
 
+  /* maximum number of output intervals for the current aggregate call, only
+   * accessed from the aggregate thread */
+  guint current_batch;
+
+  /* statistics */
+  guint64 aggregate_calls;
+  GstClockTime aggregate_time;
+  GstClockTime wait_time;
+
   /* properties */
   gint64 latency;               /* protected by both src_lock and all pad locks */
   gboolean emit_signals;        /* protected by src_lock */
   gboolean ignore_inactive_pads;        /* protected by object lock */
   gboolean force_live;          /* Construct only, doesn't need any locking */
+  guint batch_size;
 };
 
 /* With SRC_LOCK */
@@ -445,6 +466,7 @@ typedef struct
 #define DEFAULT_START_TIME           (-1)
 #define DEFAULT_EMIT_SIGNALS         FALSE
 #define DEFAULT_FORCE_LIVE           FALSE
+#define DEFAULT_BATCH_SIZE           1
 
 enum
 {
@@ -454,6 +476,8 @@ enum
   PROP_START_TIME_SELECTION,
   PROP_START_TIME,
   PROP_EMIT_SIGNALS,
+  PROP_BATCH_SIZE,
+  PROP_STATS,
   PROP_LAST
 };
 
@@ -506,6 +530,8 @@ gst_aggregator_check_pads_ready (GstAggregator * self,
 
     PAD_LOCK (pad);
 
+    pad->priv->starved = FALSE;
+
     /* If there's an event or query at the top of the queue and we don't yet
      * have taken the top buffer out and stored it as clip_buffer, remember
      * that and exit the loop. We first have to handle all events/queries
@@ -539,6 +565,7 @@ gst_aggregator_check_pads_ready (GstAggregator * self,
        * There's no point in waiting for buffers on EOS pads */
       if (!pad->priv->eos) {
         GST_LOG_OBJECT (pad, "Have no buffer and not EOS yet");
+        pad->priv->starved = TRUE;
         have_buffer = FALSE;
       } else {
         GST_LOG_OBJECT (pad, "Have no buffer and already EOS");
@@ -855,11 +882,34 @@ gst_aggregator_get_next_time (GstAggregator * self)
   return GST_CLOCK_TIME_NONE;
 }
 
+/* With SRC_LOCK. Accounts the time since @wait_start to the aggregator and
+ * to all pads that had no data when we started waiting */
+static void
+gst_aggregator_update_wait_stats (GstAggregator * self,
+    GstClockTime wait_start)
+{
+  GstClockTime waited = gst_util_get_timestamp () - wait_start;
+  GList *l;
+
+  GST_OBJECT_LOCK (self);
+  self->priv->wait_time += waited;
+  for (l = GST_ELEMENT_CAST (self)->sinkpads; l != NULL; l = l->next) {
+    GstAggregatorPad *pad = GST_AGGREGATOR_PAD (l->data);
+
+    PAD_LOCK (pad);
+    if (pad->priv->starved)
+      pad->priv->wait_time += waited;
+    PAD_UNLOCK (pad);
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
 static gboolean
 gst_aggregator_wait_and_check (GstAggregator * self, gboolean * timeout)
 {
   GstClockTime latency;
   GstClockTime start;
+  GstClockTime wait_start;
   gboolean res;
   gboolean have_event_or_query = FALSE;
 
@@ -943,7 +993,9 @@ gst_aggregator_wait_and_check (GstAggregator * self, gboolean * timeout)
      * we will be directly called again.
      */
     GST_OBJECT_UNLOCK (self);
+    wait_start = gst_util_get_timestamp ();
     SRC_WAIT (self);
+    gst_aggregator_update_wait_stats (self, wait_start);
 
     /* After waiting, check if we're actually still running */
     if (!self->priv->running || !self->priv->send_eos) {
@@ -980,9 +1032,11 @@ gst_aggregator_wait_and_check (GstAggregator * self, gboolean * timeout)
     SRC_UNLOCK (self);
 
     jitter = 0;
+    wait_start = gst_util_get_timestamp ();
     status = gst_clock_id_wait (self->priv->aggregate_id, &jitter);
 
     SRC_LOCK (self);
+    gst_aggregator_update_wait_stats (self, wait_start);
     if (self->priv->aggregate_id) {
       gst_clock_id_unref (self->priv->aggregate_id);
       self->priv->aggregate_id = NULL;
@@ -1496,6 +1550,46 @@ gst_aggregator_check_pending_new_stream (GstElement * self, GstPad * pad,
   return TRUE;
 }
 
+/* Number of output intervals the subclass may produce from the next
+ * aggregate call. Without a live source everything that is queued can be
+ * processed right away, in live mode only if we fell behind the clock */
+static guint
+gst_aggregator_compute_batch_limit (GstAggregator * self)
+{
+  GstClockTime latency, next_time, now;
+  guint batch_size;
+  gboolean live;
+
+  GST_OBJECT_LOCK (self);
+  batch_size = self->priv->batch_size;
+  GST_OBJECT_UNLOCK (self);
+
+  if (batch_size <= 1)
+    return 1;
+
+  SRC_LOCK (self);
+  live = is_live_unlocked (self);
+  latency = gst_aggregator_get_latency_unlocked (self);
+  next_time = gst_aggregator_get_next_time (self);
+  SRC_UNLOCK (self);
+
+  if (!live || !GST_CLOCK_TIME_IS_VALID (latency))
+    return batch_size;
+
+  if (!GST_CLOCK_TIME_IS_VALID (next_time))
+    return 1;
+
+  now = gst_element_get_current_running_time (GST_ELEMENT_CAST (self));
+  if (!GST_CLOCK_TIME_IS_VALID (now) || now <= next_time + latency)
+    return 1;
+
+  GST_LOG_OBJECT (self, "Behind the clock by %" GST_TIME_FORMAT
+      ", allowing batches of %u", GST_TIME_ARGS (now - next_time - latency),
+      batch_size);
+
+  return batch_size;
+}
+
 static GstFlowReturn
 gst_aggregator_loop (GstAggregator * self)
 {
@@ -1560,8 +1654,20 @@ gst_aggregator_loop (GstAggregator * self)
     }
 
     if (timeout || flow_return >= GST_FLOW_OK) {
-      GST_LOG_OBJECT (self, "Actually aggregating, timeout: %d", timeout);
+      GstClockTime aggregate_start;
+
+      priv->current_batch = gst_aggregator_compute_batch_limit (self);
+
+      GST_LOG_OBJECT (self, "Actually aggregating, timeout: %d, batch: %u",
+          timeout, priv->current_batch);
+      aggregate_start = gst_util_get_timestamp ();
       flow_return = klass->aggregate (self, timeout);
+
+      GST_OBJECT_LOCK (self);
+      priv->aggregate_calls++;
+      priv->aggregate_time += gst_util_get_timestamp () - aggregate_start;
+      GST_OBJECT_UNLOCK (self);
+      priv->current_batch = 1;
     }
 
     gst_element_foreach_sink_pad (GST_ELEMENT_CAST (self),
@@ -3089,6 +3195,11 @@ gst_aggregator_set_property (GObject * object, guint prop_id,
       agg->priv->emit_signals = g_value_get_boolean (value);
       SRC_UNLOCK (agg);
       break;
+    case PROP_BATCH_SIZE:
+      GST_OBJECT_LOCK (agg);
+      agg->priv->batch_size = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (agg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3125,6 +3236,14 @@ gst_aggregator_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, agg->priv->emit_signals);
       SRC_UNLOCK (agg);
       break;
+    case PROP_BATCH_SIZE:
+      GST_OBJECT_LOCK (agg);
+      g_value_set_uint (value, agg->priv->batch_size);
+      GST_OBJECT_UNLOCK (agg);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_aggregator_get_stats (agg));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3233,6 +3352,39 @@ gst_aggregator_class_init (GstAggregatorClass * klass)
           "Send signals", DEFAULT_EMIT_SIGNALS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAggregator:batch-size:
+   *
+   * Maximum number of output intervals a subclass may produce from a single
+   * call to #GstAggregatorClass::aggregate, see
+   * gst_aggregator_get_batch_limit(). Batches are only allowed when not live
+   * or when the aggregator fell behind the clock in live mode.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch size",
+          "Maximum number of output intervals to produce per aggregate call "
+          "when enough input is queued", 1, G_MAXUINT, DEFAULT_BATCH_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAggregator:stats:
+   *
+   * Various #GstAggregator statistics. This property returns a #GstStructure
+   * with name `application/x-gst-aggregator-stats` with the following fields:
+   *
+   * - "aggregate-calls" G_TYPE_UINT64   Number of aggregate calls
+   * - "aggregate-time" G_TYPE_UINT64   Time spent in aggregate calls (ns)
+   * - "wait-time" G_TYPE_UINT64   Time spent waiting for data or the clock (ns)
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Aggregator Statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstAggregator::samples-selected:
    * @aggregator: The #GstAggregator that emitted the signal
@@ -3314,6 +3466,8 @@ gst_aggregator_init (GstAggregator * self, GstAggregatorClass * klass)
   self->priv->start_time_selection = DEFAULT_START_TIME_SELECTION;
   self->priv->start_time = DEFAULT_START_TIME;
   self->priv->force_live = DEFAULT_FORCE_LIVE;
+  self->priv->batch_size = DEFAULT_BATCH_SIZE;
+  self->priv->current_batch = 1;
 
   g_mutex_init (&self->priv->src_lock);
   g_cond_init (&self->priv->src_cond);
@@ -3434,6 +3588,7 @@ gst_aggregator_pad_chain_internal (GstAggregator * self,
   GstFlowReturn flow_return;
   GstClockTime buf_pts;
   GstClockTime buf_duration;
+  GstClockTime blocked_start;
 
   GST_TRACE_OBJECT (aggpad,
       "entering chain internal with %" GST_PTR_FORMAT, buffer);
@@ -3485,7 +3640,9 @@ gst_aggregator_pad_chain_internal (GstAggregator * self,
         GST_PTR_FORMAT, buffer);
     GST_OBJECT_UNLOCK (self);
     SRC_UNLOCK (self);
+    blocked_start = gst_util_get_timestamp ();
     PAD_WAIT_EVENT (aggpad);
+    aggpad->priv->blocked_time += gst_util_get_timestamp () - blocked_start;
 
     PAD_UNLOCK (aggpad);
   }
@@ -3644,6 +3801,7 @@ enum
   PAD_PROP_CURRENT_LEVEL_TIME,
   PAD_PROP_CURRENT_LEVEL_BUFFERS,
   PAD_PROP_CURRENT_LEVEL_BYTES,
+  PAD_PROP_STATS,
 };
 
 enum
@@ -3743,6 +3901,15 @@ gst_aggregator_pad_get_property (GObject * object, guint prop_id,
       GST_OBJECT_UNLOCK (pad);
       PAD_UNLOCK (pad);
       break;
+    case PAD_PROP_STATS:
+      PAD_LOCK (pad);
+      g_value_take_boxed (value,
+          gst_structure_new ("application/x-gst-aggregator-pad-stats",
+              "buffers", G_TYPE_UINT64, pad->priv->consumed,
+              "wait-time", G_TYPE_UINT64, pad->priv->wait_time,
+              "blocked-time", G_TYPE_UINT64, pad->priv->blocked_time, NULL));
+      PAD_UNLOCK (pad);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3827,6 +3994,26 @@ gst_aggregator_pad_class_init (GstAggregatorPadClass * klass)
           "The number of currently queued bytes", 0, G_MAXUINT64,
           DEFAULT_PAD_CURRENT_LEVEL_BYTES,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAggregatorPad:stats:
+   *
+   * Various #GstAggregatorPad statistics. This property returns a
+   * #GstStructure with name `application/x-gst-aggregator-pad-stats` with
+   * the following fields:
+   *
+   * - "buffers" G_TYPE_UINT64   Number of buffers consumed from this pad
+   * - "wait-time" G_TYPE_UINT64   Time the aggregator spent waiting for data
+   *   on this pad (ns)
+   * - "blocked-time" G_TYPE_UINT64   Time upstream spent waiting for space in
+   *   the queue of this pad (ns)
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PAD_PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Pad Statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -3853,6 +4040,7 @@ gst_aggregator_pad_buffer_consumed (GstAggregatorPad * pad, GstBuffer * buffer,
   if (dequeued) {
     pad->priv->num_buffers--;
     pad->priv->num_bytes -= gst_buffer_get_size (buffer);
+    pad->priv->consumed++;
   }
 
   if (buffer && pad->priv->emit_signals) {
@@ -4402,3 +4590,64 @@ gst_aggregator_set_force_live (GstAggregator * self, gboolean force_live)
 {
   self->priv->force_live = force_live;
 }
+
+/**
+ * gst_aggregator_get_batch_limit:
+ * @self: A #GstAggregator
+ *
+ * Subclasses can call this from their #GstAggregatorClass::aggregate
+ * implementation to find out how many output intervals they may produce in
+ * this call, if enough input is already queued on the sink pads. This is
+ * always 1 unless #GstAggregator:batch-size was set, and in live mode it is
+ * only larger than 1 while the aggregator is behind the clock.
+ *
+ * The output of a batch can be pushed with
+ * gst_aggregator_finish_buffer_list().
+ *
+ * Returns: the maximum number of output intervals for the current aggregate
+ *   call.
+ *
+ * Since: 1.30
+ */
+guint
+gst_aggregator_get_batch_limit (GstAggregator * self)
+{
+  g_return_val_if_fail (GST_IS_AGGREGATOR (self), 1);
+
+  return self->priv->current_batch;
+}
+
+/**
+ * gst_aggregator_get_stats:
+ * @self: A #GstAggregator
+ *
+ * Return various #GstAggregator statistics. This function returns a
+ * #GstStructure with name `application/x-gst-aggregator-stats` with the
+ * following fields:
+ *
+ * - "aggregate-calls" G_TYPE_UINT64   Number of aggregate calls
+ * - "aggregate-time" G_TYPE_UINT64   Time spent in aggregate calls (ns)
+ * - "wait-time" G_TYPE_UINT64   Time spent waiting for data or the clock (ns)
+ *
+ * Per pad statistics are available from the #GstAggregatorPad:stats property.
+ *
+ * Returns: (transfer full): pointer to #GstStructure
+ *
+ * Since: 1.30
+ */
+GstStructure *
+gst_aggregator_get_stats (GstAggregator * self)
+{
+  GstStructure *s;
+
+  g_return_val_if_fail (GST_IS_AGGREGATOR (self), NULL);
+
+  GST_OBJECT_LOCK (self);
+  s = gst_structure_new ("application/x-gst-aggregator-stats",
+      "aggregate-calls", G_TYPE_UINT64, self->priv->aggregate_calls,
+      "aggregate-time", G_TYPE_UINT64, self->priv->aggregate_time,
+      "wait-time", G_TYPE_UINT64, self->priv->wait_time, NULL);
+  GST_OBJECT_UNLOCK (self);
+
+  return s;
+}
@@ -547,6 +547,12 @@ GST_BASE_API
 void            gst_aggregator_set_force_live       (GstAggregator *self,
                                                      gboolean force_live);
 
+GST_BASE_API
+guint           gst_aggregator_get_batch_limit      (GstAggregator *self);
+
+GST_BASE_API
+GstStructure  * gst_aggregator_get_stats            (GstAggregator *self);
+
 /**
  * GstAggregatorStartTimeSelection:
  * @GST_AGGREGATOR_START_TIME_SELECTION_ZERO: Start at running time 0.
@@ -2507,7 +2507,9 @@ gst_base_sink_wait_preroll (GstBaseSink * sink)
   sink->have_preroll = TRUE;
   GST_DEBUG_OBJECT (sink, "waiting in preroll for flush or PLAYING");
   /* block until the state changes, or we get a flush, or something */
+  gst_task_pool_blocking_begin ();
   GST_BASE_SINK_PREROLL_WAIT (sink);
+  gst_task_pool_blocking_end ();
   sink->have_preroll = FALSE;
   if (G_UNLIKELY (sink->flushing))
     goto stopping;
@@ -188,6 +188,7 @@ struct _GstBaseTransformPrivate
 
   gboolean gap_aware;
   gboolean prefer_passthrough;
+  gboolean buffer_list_aware;
 
   /* QoS stats */
   guint64 processed;
@@ -278,6 +279,8 @@ static GstFlowReturn gst_base_transform_getrange (GstPad * pad,
     GstObject * parent, guint64 offset, guint length, GstBuffer ** buffer);
 static GstFlowReturn gst_base_transform_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buffer);
+static GstFlowReturn gst_base_transform_chain_list (GstPad * pad,
+    GstObject * parent, GstBufferList * list);
 static GstCaps *gst_base_transform_default_transform_caps (GstBaseTransform *
     trans, GstPadDirection direction, GstCaps * caps, GstCaps * filter);
 static GstCaps *gst_base_transform_default_fixate_caps (GstBaseTransform *
@@ -395,6 +398,11 @@ gst_base_transform_init (GstBaseTransform * trans,
       GST_DEBUG_FUNCPTR (gst_base_transform_sink_event));
   gst_pad_set_chain_function (trans->sinkpad,
       GST_DEBUG_FUNCPTR (gst_base_transform_chain));
+  /* without list virtual methods the default chain list function of the
+   * pad splits lists */
+  if (bclass->transform_list != NULL || bclass->transform_list_ip != NULL)
+    gst_pad_set_chain_list_function (trans->sinkpad,
+        GST_DEBUG_FUNCPTR (gst_base_transform_chain_list));
   gst_pad_set_activatemode_function (trans->sinkpad,
       GST_DEBUG_FUNCPTR (gst_base_transform_sink_activate_mode));
   gst_pad_set_query_function (trans->sinkpad,
@@ -421,6 +429,7 @@ gst_base_transform_init (GstBaseTransform * trans,
   priv->pad_mode = GST_PAD_MODE_NONE;
   priv->gap_aware = FALSE;
   priv->prefer_passthrough = TRUE;
+  priv->buffer_list_aware = FALSE;
 
   priv->passthrough = FALSE;
   if (bclass->transform == NULL) {
@@ -1664,6 +1673,20 @@ gst_base_transform_query (GstPad * pad, GstObject * parent, GstQuery * query)
   return ret;
 }
 
+static void
+gst_base_transform_copy_metadata (GstBaseTransform * trans,
+    GstBuffer * inbuf, GstBuffer * outbuf)
+{
+  GstBaseTransformClass *bclass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+
+  if (bclass->copy_metadata)
+    if (!bclass->copy_metadata (trans, inbuf, outbuf)) {
+      /* something failed, post a warning */
+      GST_ELEMENT_WARNING (trans, STREAM, NOT_IMPLEMENTED,
+          ("could not copy metadata"), (NULL));
+    }
+}
+
 /* this function either returns the input buffer without incrementing the
  * refcount or it allocates a new (writable) buffer */
 static GstFlowReturn
@@ -1748,12 +1771,7 @@ default_prepare_output_buffer (GstBaseTransform * trans,
 
 copy_meta:
   /* copy the metadata */
-  if (bclass->copy_metadata)
-    if (!bclass->copy_metadata (trans, inbuf, *outbuf)) {
-      /* something failed, post a warning */
-      GST_ELEMENT_WARNING (trans, STREAM, NOT_IMPLEMENTED,
-          ("could not copy metadata"), (NULL));
-    }
+  gst_base_transform_copy_metadata (trans, inbuf, *outbuf);
 
 done:
   return GST_FLOW_OK;
@@ -2060,6 +2078,72 @@ gst_base_transform_src_eventfunc (GstBaseTransform * trans, GstEvent * event)
   return ret;
 }
 
+/* Checks whether @inbuf is too late according to the last QoS event and
+ * posts a QoS message if so. Returns %TRUE if @inbuf should be dropped */
+static gboolean
+gst_base_transform_qos_drop (GstBaseTransform * trans, GstBuffer * inbuf)
+{
+  GstBaseTransformPrivate *priv = trans->priv;
+  GstClockTime running_time;
+  GstClockTime timestamp;
+  GstClockTime earliest_time;
+  GstClockTime duration;
+  GstMessage *qos_msg;
+  gdouble proportion;
+  gboolean need_skip;
+  guint64 stream_time;
+  gint64 jitter;
+
+  /* can only do QoS if the segment is in TIME */
+  if (trans->segment.format != GST_FORMAT_TIME)
+    return FALSE;
+
+  /* QOS is done on the running time of the buffer, get it now */
+  timestamp = GST_BUFFER_TIMESTAMP (inbuf);
+  running_time = gst_segment_to_running_time (&trans->segment, GST_FORMAT_TIME,
+      timestamp);
+
+  if (running_time == -1)
+    return FALSE;
+
+  /* lock for getting the QoS parameters that are set (in a different thread)
+   * with the QOS events */
+  GST_OBJECT_LOCK (trans);
+  earliest_time = priv->earliest_time;
+  proportion = priv->proportion;
+  /* check for QoS, don't perform conversion for buffers
+   * that are known to be late. */
+  need_skip = earliest_time != -1 && running_time <= earliest_time;
+  GST_OBJECT_UNLOCK (trans);
+
+  if (!need_skip)
+    return FALSE;
+
+  GST_CAT_DEBUG_OBJECT (GST_CAT_QOS, trans, "skipping transform: qostime %"
+      GST_TIME_FORMAT " <= %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (running_time), GST_TIME_ARGS (earliest_time));
+
+  priv->dropped++;
+
+  duration = GST_BUFFER_DURATION (inbuf);
+  stream_time =
+      gst_segment_to_stream_time (&trans->segment, GST_FORMAT_TIME, timestamp);
+  jitter = GST_CLOCK_DIFF (running_time, earliest_time);
+
+  qos_msg =
+      gst_message_new_qos (GST_OBJECT_CAST (trans), FALSE, running_time,
+      stream_time, timestamp, duration);
+  gst_message_set_qos_values (qos_msg, jitter, proportion, 1000000);
+  gst_message_set_qos_stats (qos_msg, GST_FORMAT_BUFFERS,
+      priv->processed, priv->dropped);
+  gst_element_post_message (GST_ELEMENT_CAST (trans), qos_msg);
+
+  /* mark discont for next buffer */
+  priv->discont = TRUE;
+
+  return TRUE;
+}
+
 /* Takes the input buffer */
 static GstFlowReturn
 default_submit_input_buffer (GstBaseTransform * trans, gboolean is_discont,
@@ -2068,8 +2152,6 @@ default_submit_input_buffer (GstBaseTransform * trans, gboolean is_discont,
   GstBaseTransformClass *bclass = GST_BASE_TRANSFORM_GET_CLASS (trans);
   GstBaseTransformPrivate *priv = trans->priv;
   GstFlowReturn ret = GST_FLOW_OK;
-  GstClockTime running_time;
-  GstClockTime timestamp;
   gboolean qos_enabled;
 
   if (G_UNLIKELY (!gst_base_transform_reconfigure_unlocked (trans)))
@@ -2098,67 +2180,11 @@ default_submit_input_buffer (GstBaseTransform * trans, gboolean is_discont,
   GST_OBJECT_UNLOCK (trans);
 
   /* Skip all qos handling if disabled */
-  if (!qos_enabled)
-    goto no_qos;
-
-  /* can only do QoS if the segment is in TIME */
-  if (trans->segment.format != GST_FORMAT_TIME)
-    goto no_qos;
-
-  /* QOS is done on the running time of the buffer, get it now */
-  timestamp = GST_BUFFER_TIMESTAMP (inbuf);
-  running_time = gst_segment_to_running_time (&trans->segment, GST_FORMAT_TIME,
-      timestamp);
-
-  if (running_time != -1) {
-    gboolean need_skip;
-    GstClockTime earliest_time;
-    gdouble proportion;
-
-    /* lock for getting the QoS parameters that are set (in a different thread)
-     * with the QOS events */
-    GST_OBJECT_LOCK (trans);
-    earliest_time = priv->earliest_time;
-    proportion = priv->proportion;
-    /* check for QoS, don't perform conversion for buffers
-     * that are known to be late. */
-    need_skip = earliest_time != -1 && running_time <= earliest_time;
-    GST_OBJECT_UNLOCK (trans);
-
-    if (need_skip) {
-      GstMessage *qos_msg;
-      GstClockTime duration;
-      guint64 stream_time;
-      gint64 jitter;
-
-      GST_CAT_DEBUG_OBJECT (GST_CAT_QOS, trans, "skipping transform: qostime %"
-          GST_TIME_FORMAT " <= %" GST_TIME_FORMAT,
-          GST_TIME_ARGS (running_time), GST_TIME_ARGS (earliest_time));
-
-      priv->dropped++;
-
-      duration = GST_BUFFER_DURATION (inbuf);
-      stream_time =
-          gst_segment_to_stream_time (&trans->segment, GST_FORMAT_TIME,
-          timestamp);
-      jitter = GST_CLOCK_DIFF (running_time, earliest_time);
-
-      qos_msg =
-          gst_message_new_qos (GST_OBJECT_CAST (trans), FALSE, running_time,
-          stream_time, timestamp, duration);
-      gst_message_set_qos_values (qos_msg, jitter, proportion, 1000000);
-      gst_message_set_qos_stats (qos_msg, GST_FORMAT_BUFFERS,
-          priv->processed, priv->dropped);
-      gst_element_post_message (GST_ELEMENT_CAST (trans), qos_msg);
-
-      /* mark discont for next buffer */
-      priv->discont = TRUE;
-      ret = GST_BASE_TRANSFORM_FLOW_DROPPED;
-      goto skip;
-    }
+  if (qos_enabled && gst_base_transform_qos_drop (trans, inbuf)) {
+    ret = GST_BASE_TRANSFORM_FLOW_DROPPED;
+    goto skip;
   }
 
-no_qos:
   /* Stash input buffer where the default generate_output
    * function can find it */
   if (trans->queued_buf)
@@ -2441,6 +2467,365 @@ done:
   return ret;
 }
 
+/* Whether @list can be handled as a whole instead of being split into its
+ * buffers, with the object lock */
+static gboolean
+gst_base_transform_can_chain_list (GstBaseTransform * trans)
+{
+  GstBaseTransformClass *bclass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+  GstBaseTransformPrivate *priv = trans->priv;
+
+  if (!priv->buffer_list_aware)
+    return FALSE;
+
+  /* subclasses doing their own scheduling get the buffers one by one */
+  if (bclass->submit_input_buffer != default_submit_input_buffer ||
+      bclass->generate_output != default_generate_output)
+    return FALSE;
+
+  if (priv->passthrough) {
+    if (bclass->transform_ip_on_passthrough && bclass->transform_ip)
+      return bclass->transform_list_ip != NULL;
+    return TRUE;
+  }
+
+  if (bclass->transform_ip != NULL && priv->always_in_place)
+    return bclass->transform_list_ip != NULL;
+
+  return bclass->transform_list != NULL;
+}
+
+/* Prepares the output buffers for all buffers of the writable @list. When
+ * @in_place the buffers of @list are replaced by their output buffers and
+ * @outlist is set to @list, otherwise a new list is returned in @outlist.
+ *
+ * With the default prepare_output_buffer the pool is activated and the
+ * caps and output size are looked up only once for the whole list instead
+ * of for every buffer. */
+static GstFlowReturn
+gst_base_transform_prepare_output_list (GstBaseTransform * trans,
+    GstBufferList * list, gboolean in_place, GstBufferList ** outlist)
+{
+  GstBaseTransformClass *bclass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+  GstBaseTransformPrivate *priv = trans->priv;
+  GstCaps *incaps = NULL, *outcaps = NULL;
+  gsize insize, last_insize = G_MAXSIZE, outsize = 0;
+  GstFlowReturn ret = GST_FLOW_OK;
+  gboolean use_default;
+  guint i;
+
+  use_default = bclass->prepare_output_buffer == default_prepare_output_buffer;
+
+  if (in_place) {
+    *outlist = list;
+    /* passthrough buffers are pushed as they are */
+    if (use_default && priv->passthrough)
+      return GST_FLOW_OK;
+  } else {
+    *outlist = gst_buffer_list_new_sized (gst_buffer_list_length (list));
+  }
+
+  if (use_default && priv->pool && !priv->pool_active) {
+    GST_DEBUG_OBJECT (trans, "setting pool %p active", priv->pool);
+    if (!gst_buffer_pool_set_active (priv->pool, TRUE))
+      goto activate_failed;
+    priv->pool_active = TRUE;
+  }
+
+  for (i = 0; i < gst_buffer_list_length (list); i++) {
+    GstBuffer *inbuf = gst_buffer_list_get (list, i);
+    GstBuffer *outbuf = NULL;
+
+    if (!use_default) {
+      ret = bclass->prepare_output_buffer (trans, inbuf, &outbuf);
+      if (ret != GST_FLOW_OK)
+        goto no_buffer;
+    } else if (priv->pool) {
+      ret = gst_buffer_pool_acquire_buffer (priv->pool, &outbuf, NULL);
+      if (ret != GST_FLOW_OK)
+        goto no_buffer;
+      gst_base_transform_copy_metadata (trans, inbuf, outbuf);
+    } else if (in_place) {
+      gst_buffer_list_get_writable (list, i);
+      continue;
+    } else {
+      insize = gst_buffer_get_size (inbuf);
+      if (insize != last_insize) {
+        if (incaps == NULL) {
+          incaps = gst_pad_get_current_caps (trans->sinkpad);
+          outcaps = gst_pad_get_current_caps (trans->srcpad);
+          /* srcpad might be flushing already if we're being shut down */
+          if (outcaps == NULL)
+            goto no_outcaps;
+        }
+        if (!gst_base_transform_transform_size (trans, GST_PAD_SINK, incaps,
+                insize, outcaps, &outsize))
+          goto unknown_size;
+        last_insize = insize;
+      }
+
+      outbuf = gst_buffer_new_allocate (priv->allocator, outsize,
+          &priv->params);
+      if (!outbuf) {
+        ret = GST_FLOW_ERROR;
+        goto no_buffer;
+      }
+      gst_base_transform_copy_metadata (trans, inbuf, outbuf);
+    }
+
+    /* like for single buffers, no output buffer drops the input buffer */
+    if (outbuf == NULL) {
+      gst_buffer_list_remove (list, i, 1);
+      i--;
+      continue;
+    }
+
+    if (in_place) {
+      if (outbuf != inbuf) {
+        gst_buffer_list_insert (list, i, outbuf);
+        gst_buffer_list_remove (list, i + 1, 1);
+      }
+    } else {
+      if (outbuf == inbuf)
+        gst_buffer_ref (outbuf);
+      gst_buffer_list_add (*outlist, outbuf);
+    }
+  }
+
+done:
+  gst_clear_caps (&incaps);
+  gst_clear_caps (&outcaps);
+
+  return ret;
+
+  /* ERRORS */
+activate_failed:
+  {
+    GST_ELEMENT_ERROR (trans, RESOURCE, SETTINGS,
+        ("failed to activate bufferpool"), ("failed to activate bufferpool"));
+    ret = GST_FLOW_ERROR;
+    goto error;
+  }
+no_outcaps:
+  {
+    GST_DEBUG_OBJECT (trans, "no output caps, source pad has been deactivated");
+    ret = GST_FLOW_FLUSHING;
+    goto error;
+  }
+unknown_size:
+  {
+    GST_ERROR_OBJECT (trans, "unknown output size");
+    ret = GST_FLOW_ERROR;
+    goto error;
+  }
+no_buffer:
+  {
+    GST_WARNING_OBJECT (trans, "could not get output buffer: %s",
+        gst_flow_get_name (ret));
+    goto error;
+  }
+error:
+  {
+    if (!in_place)
+      gst_buffer_list_unref (*outlist);
+    *outlist = NULL;
+    goto done;
+  }
+}
+
+typedef struct
+{
+  GstPad *pad;
+  GstFlowReturn ret;
+} ChainListData;
+
+static gboolean
+chain_list_buffer_writable (GstBuffer ** buffer, guint idx, gpointer user_data)
+{
+  ChainListData *data = user_data;
+
+  data->ret = gst_pad_chain (data->pad, *buffer);
+  *buffer = NULL;
+
+  return data->ret == GST_FLOW_OK;
+}
+
+/* Handles buffer lists as a whole when the subclass enabled this with
+ * gst_base_transform_set_buffer_list_aware(), otherwise every buffer of the
+ * list goes through the chain function */
+static GstFlowReturn
+gst_base_transform_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (parent);
+  GstBaseTransformClass *klass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+  GstBaseTransformPrivate *priv = trans->priv;
+  GstBufferList *outlist = NULL;
+  GstClockTime position = GST_CLOCK_TIME_NONE;
+  GstClockTime timestamp, duration;
+  GstFlowReturn ret;
+  GstBuffer *buffer;
+  gboolean can_chain_list;
+  gboolean qos_enabled;
+  gboolean in_place;
+  guint i, len;
+
+  len = gst_buffer_list_length (list);
+  if (len == 0)
+    goto empty;
+
+  if (G_UNLIKELY (!gst_base_transform_reconfigure_unlocked (trans)))
+    goto not_negotiated;
+
+  /* reconfiguration might have changed the passthrough mode */
+  GST_OBJECT_LOCK (trans);
+  can_chain_list = gst_base_transform_can_chain_list (trans);
+  qos_enabled = priv->qos_enabled;
+  GST_OBJECT_UNLOCK (trans);
+
+  if (!can_chain_list)
+    goto split;
+
+  if (!priv->negotiated && !priv->passthrough && (klass->set_caps != NULL))
+    goto not_negotiated;
+
+  GST_LOG_OBJECT (trans, "handling buffer list %p of length %u", list, len);
+
+  /* calculate end position of the incoming list */
+  buffer = gst_buffer_list_get (list, len - 1);
+  timestamp = GST_BUFFER_TIMESTAMP (buffer);
+  duration = GST_BUFFER_DURATION (buffer);
+  if (timestamp != GST_CLOCK_TIME_NONE) {
+    if (duration != GST_CLOCK_TIME_NONE)
+      position = timestamp + duration;
+    else
+      position = timestamp;
+  }
+
+  list = gst_buffer_list_make_writable (list);
+
+  /* drop late buffers and apply pending DISCONT flags */
+  for (i = 0; i < gst_buffer_list_length (list); i++) {
+    buffer = gst_buffer_list_get (list, i);
+
+    if (klass->before_transform)
+      klass->before_transform (trans, buffer);
+
+    if (qos_enabled && gst_base_transform_qos_drop (trans, buffer)) {
+      gst_buffer_list_remove (list, i, 1);
+      i--;
+      continue;
+    }
+
+    if (priv->discont && !GST_BUFFER_IS_DISCONT (buffer)) {
+      GST_DEBUG_OBJECT (trans, "marking DISCONT on buffer %u", i);
+      buffer = gst_buffer_list_get_writable (list, i);
+      GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DISCONT);
+    }
+    priv->discont = FALSE;
+  }
+
+  if (gst_buffer_list_length (list) == 0)
+    goto empty;
+
+  in_place = priv->passthrough || (klass->transform_ip != NULL
+      && priv->always_in_place);
+
+  ret = gst_base_transform_prepare_output_list (trans, list, in_place,
+      &outlist);
+  if (ret != GST_FLOW_OK) {
+    gst_buffer_list_unref (list);
+    goto done;
+  }
+
+  if (!in_place) {
+    GST_DEBUG_OBJECT (trans, "doing non-inplace list transform");
+    ret = klass->transform_list (trans, list, outlist);
+    gst_buffer_list_unref (list);
+  } else if (!priv->passthrough) {
+    GST_DEBUG_OBJECT (trans, "doing inplace list transform");
+    ret = klass->transform_list_ip (trans, outlist);
+  } else if (klass->transform_ip_on_passthrough && klass->transform_ip) {
+    GST_DEBUG_OBJECT (trans, "doing passthrough list transform_ip");
+    ret = klass->transform_list_ip (trans, outlist);
+  }
+
+  /* the output is only pushed when everything was transformed */
+  if (ret != GST_FLOW_OK) {
+    gst_buffer_list_unref (outlist);
+    goto done;
+  }
+
+  len = gst_buffer_list_length (outlist);
+  if (len == 0) {
+    gst_buffer_list_unref (outlist);
+    goto done;
+  }
+
+  /* Remember last stop position */
+  if (position != GST_CLOCK_TIME_NONE &&
+      trans->segment.format == GST_FORMAT_TIME) {
+    GstClockTime position_out = position;
+
+    trans->segment.position = position;
+
+    buffer = gst_buffer_list_get (outlist, len - 1);
+    if (GST_BUFFER_TIMESTAMP_IS_VALID (buffer)) {
+      position_out = GST_BUFFER_TIMESTAMP (buffer);
+      if (GST_BUFFER_DURATION_IS_VALID (buffer))
+        position_out += GST_BUFFER_DURATION (buffer);
+    }
+    priv->position_out = position_out;
+  }
+  priv->processed += len;
+
+  ret = gst_pad_push_list (trans->srcpad, outlist);
+
+done:
+  /* convert internal flow to OK and mark discont for the next buffer. */
+  if (ret == GST_BASE_TRANSFORM_FLOW_DROPPED) {
+    GST_DEBUG_OBJECT (trans, "dropped a buffer list, marking DISCONT");
+    priv->discont = TRUE;
+    ret = GST_FLOW_OK;
+  }
+
+  return ret;
+
+empty:
+  {
+    gst_buffer_list_unref (list);
+    return GST_FLOW_OK;
+  }
+split:
+  {
+    /* Like the default chain list function of pads, so that probes and
+     * tracers see every buffer. The buffers of a writable list are passed on
+     * without another reference so that they stay writable. */
+    GST_LOG_OBJECT (trans, "chaining each buffer in list individually");
+    if (gst_buffer_list_is_writable (list)) {
+      ChainListData data = { pad, GST_FLOW_OK };
+
+      gst_buffer_list_foreach (list, chain_list_buffer_writable, &data);
+      ret = data.ret;
+    } else {
+      ret = GST_FLOW_OK;
+      for (i = 0; i < len && ret == GST_FLOW_OK; i++) {
+        buffer = gst_buffer_ref (gst_buffer_list_get (list, i));
+        ret = gst_pad_chain (pad, buffer);
+      }
+    }
+    gst_buffer_list_unref (list);
+    return ret;
+  }
+not_negotiated:
+  {
+    gst_buffer_list_unref (list);
+    if (GST_PAD_IS_FLUSHING (trans->srcpad))
+      return GST_FLOW_FLUSHING;
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+}
+
 static void
 gst_base_transform_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -2857,6 +3242,38 @@ gst_base_transform_set_prefer_passthrough (GstBaseTransform * trans,
   GST_OBJECT_UNLOCK (trans);
 }
 
+/**
+ * gst_base_transform_set_buffer_list_aware:
+ * @trans: a #GstBaseTransform
+ * @list_aware: New state
+ *
+ * If @list_aware is %FALSE (the default), buffer lists are split and every
+ * buffer is transformed on its own.
+ *
+ * If set to %TRUE, buffer lists are transformed as a whole with the
+ * #GstBaseTransformClass::transform_list or
+ * #GstBaseTransformClass::transform_list_ip virtual methods and pushed
+ * downstream as a list. Output buffers for the whole list are allocated in
+ * one go. #GstBaseTransformClass::before_transform is called for every
+ * buffer of a list before the list is transformed. Lists are still split if
+ * the element has no list implementation for the current mode.
+ *
+ * MT safe.
+ *
+ * Since: 1.30
+ */
+void
+gst_base_transform_set_buffer_list_aware (GstBaseTransform * trans,
+    gboolean list_aware)
+{
+  g_return_if_fail (GST_IS_BASE_TRANSFORM (trans));
+
+  GST_OBJECT_LOCK (trans);
+  trans->priv->buffer_list_aware = list_aware;
+  GST_DEBUG_OBJECT (trans, "set buffer list aware %d", list_aware);
+  GST_OBJECT_UNLOCK (trans);
+}
+
 /**
  * gst_base_transform_reconfigure_sink:
  * @trans: a #GstBaseTransform
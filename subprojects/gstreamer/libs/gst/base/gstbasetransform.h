@@ -325,8 +325,55 @@ struct _GstBaseTransformClass {
   gboolean          (*prepare_allocator) (GstBaseTransform *trans,
                                           GstCaps *caps);
 
+  /**
+   * GstBaseTransformClass::transform_list:
+   * @trans: the #GstBaseTransform
+   * @inlist: the input #GstBufferList
+   * @outlist: a #GstBufferList with one prepared output buffer for each
+   *     buffer in @inlist
+   *
+   * Transforms all buffers of @inlist into the buffers at the same index in
+   * @outlist. Only called when gst_base_transform_set_buffer_list_aware()
+   * was enabled and the element does not operate in-place. Buffer lists are
+   * only handled by the base class if this or
+   * #GstBaseTransformClass::transform_list_ip is set in the class.
+   *
+   * Output buffers can be dropped by removing them from @outlist. The
+   * buffers left in @outlist are only pushed downstream when %GST_FLOW_OK is
+   * returned, any other flow return drops all of them.
+   *
+   * Returns: a #GstFlowReturn
+   *
+   * Since: 1.30
+   */
+  GstFlowReturn (*transform_list)    (GstBaseTransform *trans,
+                                      GstBufferList *inlist,
+                                      GstBufferList *outlist);
+
+  /**
+   * GstBaseTransformClass::transform_list_ip:
+   * @trans: the #GstBaseTransform
+   * @list: the #GstBufferList to transform
+   *
+   * Transforms all buffers of @list in-place. Only called when
+   * gst_base_transform_set_buffer_list_aware() was enabled and the element
+   * operates in-place, or in passthrough mode when
+   * #GstBaseTransformClass.transform_ip_on_passthrough is set. @list is
+   * always writable, its buffers are only writable when not in passthrough
+   * mode.
+   *
+   * The same rules as for #GstBaseTransformClass::transform_list apply for
+   * dropping buffers and for flow returns other than %GST_FLOW_OK.
+   *
+   * Returns: a #GstFlowReturn
+   *
+   * Since: 1.30
+   */
+  GstFlowReturn (*transform_list_ip) (GstBaseTransform *trans,
+                                      GstBufferList *list);
+
   /*< private >*/
-  gpointer       _gst_reserved[GST_PADDING_LARGE - 3];
+  gpointer       _gst_reserved[GST_PADDING_LARGE - 5];
 };
 
 GST_BASE_API
@@ -361,6 +408,10 @@ void            gst_base_transform_set_gap_aware    (GstBaseTransform *trans,
 GST_BASE_API
 void            gst_base_transform_set_prefer_passthrough (GstBaseTransform *trans,
                                                            gboolean prefer_passthrough);
+
+GST_BASE_API
+void            gst_base_transform_set_buffer_list_aware (GstBaseTransform *trans,
+                                                          gboolean list_aware);
 GST_BASE_API
 GstBufferPool * gst_base_transform_get_buffer_pool  (GstBaseTransform *trans) G_GNUC_WARN_UNUSED_RESULT;
 
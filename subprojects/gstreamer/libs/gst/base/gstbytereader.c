@@ -25,6 +25,7 @@
 
 #define GST_BYTE_READER_DISABLE_INLINES
 #include "gstbytereader.h"
+#include "gstbytescan-private.h"
 
 #include "gst/glib-compat-private.h"
 #include <string.h>
@@ -862,29 +863,6 @@ gst_byte_reader_dup_data (GstByteReader * reader, guint size, guint8 ** val)
   return _gst_byte_reader_dup_data_inline (reader, size, val);
 }
 
-/* Special optimized scan for mask 0xffffff00 and pattern 0x00000100 */
-static inline gint
-_scan_for_start_code (const guint8 * data, guint size)
-{
-  guint8 *pdata = (guint8 *) data;
-  guint8 *pend = (guint8 *) (data + size - 4);
-
-  while (pdata <= pend) {
-    if (pdata[2] > 1) {
-      pdata += 3;
-    } else if (pdata[1]) {
-      pdata += 2;
-    } else if (pdata[0] || pdata[2] != 1) {
-      pdata++;
-    } else {
-      return (pdata - data);
-    }
-  }
-
-  /* nothing found */
-  return -1;
-}
-
 static inline guint
 _masked_scan_uint32_peek (const GstByteReader * reader,
     guint32 mask, guint32 pattern, guint offset, guint size, guint32 * value)
@@ -905,7 +883,7 @@ _masked_scan_uint32_peek (const GstByteReader * reader,
 
   /* Handle special case found in MPEG and H264 */
   if ((pattern == 0x00000100) && (mask == 0xffffff00)) {
-    gint ret = _scan_for_start_code (data, size);
+    gssize ret = gst_byte_scan_start_code (data, size);
 
     if (ret == -1)
       return ret;
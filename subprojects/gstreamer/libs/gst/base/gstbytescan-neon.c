@@ -0,0 +1,55 @@
+/* GStreamer
+ *
+ * gstbytescan-neon.c: NEON scanning for start codes
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstbytescan-private.h"
+
+#include <arm_neon.h>
+
+/* Like the SSE2 version. NEON has no movemask, so the first match in a block
+ * with a match is located with the C version. */
+gssize
+gst_byte_scan_start_code_neon (const guint8 * data, gsize size)
+{
+  const uint8x16_t one = vdupq_n_u8 (1);
+  gsize i;
+  gssize ret;
+
+  for (i = 0; i + 19 <= size; i += 16) {
+    uint8x16_t v0, v1, v2, m;
+
+    v0 = vld1q_u8 (data + i);
+    v1 = vld1q_u8 (data + i + 1);
+    v2 = vld1q_u8 (data + i + 2);
+
+    m = vandq_u8 (vceqzq_u8 (v0), vceqzq_u8 (v1));
+    m = vandq_u8 (m, vceqq_u8 (v2, one));
+
+    if (G_UNLIKELY (vmaxvq_u8 (m)))
+      return i + gst_byte_scan_start_code_c (data + i, 19);
+  }
+
+  ret = gst_byte_scan_start_code_c (data + i, size - i);
+
+  return ret < 0 ? -1 : (gssize) i + ret;
+}
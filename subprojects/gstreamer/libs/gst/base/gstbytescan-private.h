@@ -0,0 +1,59 @@
+/* GStreamer
+ *
+ * gstbytescan-private.h: vectorized scanning for start codes
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_BYTE_SCAN_PRIVATE_H__
+#define __GST_BYTE_SCAN_PRIVATE_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef gssize (*GstByteScanFunc) (const guint8 * data, gsize size);
+
+typedef struct
+{
+  const gchar *name;
+  GstByteScanFunc scan_start_code;
+} GstByteScanImpl;
+
+/* Returns the offset of the first 0x00 0x00 0x01 start code in @data that is
+ * followed by at least one more byte, or -1 when there is none. */
+G_GNUC_INTERNAL
+gssize gst_byte_scan_start_code       (const guint8 * data, gsize size);
+
+/* implementations, selected at runtime */
+G_GNUC_INTERNAL
+gssize gst_byte_scan_start_code_c     (const guint8 * data, gsize size);
+
+G_GNUC_INTERNAL
+gssize gst_byte_scan_start_code_sse2  (const guint8 * data, gsize size);
+
+G_GNUC_INTERNAL
+gssize gst_byte_scan_start_code_avx2  (const guint8 * data, gsize size);
+
+G_GNUC_INTERNAL
+gssize gst_byte_scan_start_code_neon  (const guint8 * data, gsize size);
+
+G_GNUC_INTERNAL
+const GstByteScanImpl * gst_byte_scan_get_implementations (guint * n_impls);
+
+G_END_DECLS
+
+#endif /* __GST_BYTE_SCAN_PRIVATE_H__ */
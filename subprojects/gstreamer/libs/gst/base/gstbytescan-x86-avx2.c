@@ -0,0 +1,58 @@
+/* GStreamer
+ *
+ * gstbytescan-x86-avx2.c: AVX2 scanning for start codes
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstbytescan-private.h"
+
+#include <immintrin.h>
+
+/* Like the SSE2 version, with 32 positions per block */
+gssize
+gst_byte_scan_start_code_avx2 (const guint8 * data, gsize size)
+{
+  const __m256i zero = _mm256_setzero_si256 ();
+  const __m256i one = _mm256_set1_epi8 (1);
+  gsize i;
+  gssize ret;
+
+  for (i = 0; i + 35 <= size; i += 32) {
+    __m256i v0, v1, v2, m;
+    guint32 bits;
+
+    v0 = _mm256_loadu_si256 ((const __m256i *) (data + i));
+    v1 = _mm256_loadu_si256 ((const __m256i *) (data + i + 1));
+    v2 = _mm256_loadu_si256 ((const __m256i *) (data + i + 2));
+
+    m = _mm256_and_si256 (_mm256_cmpeq_epi8 (v0, zero),
+        _mm256_cmpeq_epi8 (v1, zero));
+    m = _mm256_and_si256 (m, _mm256_cmpeq_epi8 (v2, one));
+
+    bits = (guint32) _mm256_movemask_epi8 (m);
+    if (G_UNLIKELY (bits))
+      return i + g_bit_nth_lsf (bits, -1);
+  }
+
+  ret = gst_byte_scan_start_code_c (data + i, size - i);
+
+  return ret < 0 ? -1 : (gssize) i + ret;
+}
@@ -0,0 +1,59 @@
+/* GStreamer
+ *
+ * gstbytescan-x86-sse2.c: SSE2 scanning for start codes
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstbytescan-private.h"
+
+#include <emmintrin.h>
+
+/* Compares 16 positions at once against the three bytes of the start code,
+ * reading 18 bytes. A start code at the last position also needs the byte
+ * after it, so a block is only scanned when 19 bytes are left. */
+gssize
+gst_byte_scan_start_code_sse2 (const guint8 * data, gsize size)
+{
+  const __m128i zero = _mm_setzero_si128 ();
+  const __m128i one = _mm_set1_epi8 (1);
+  gsize i;
+  gssize ret;
+
+  for (i = 0; i + 19 <= size; i += 16) {
+    __m128i v0, v1, v2, m;
+    guint bits;
+
+    v0 = _mm_loadu_si128 ((const __m128i *) (data + i));
+    v1 = _mm_loadu_si128 ((const __m128i *) (data + i + 1));
+    v2 = _mm_loadu_si128 ((const __m128i *) (data + i + 2));
+
+    m = _mm_and_si128 (_mm_cmpeq_epi8 (v0, zero), _mm_cmpeq_epi8 (v1, zero));
+    m = _mm_and_si128 (m, _mm_cmpeq_epi8 (v2, one));
+
+    bits = (guint) _mm_movemask_epi8 (m);
+    if (G_UNLIKELY (bits))
+      return i + g_bit_nth_lsf (bits, -1);
+  }
+
+  ret = gst_byte_scan_start_code_c (data + i, size - i);
+
+  return ret < 0 ? -1 : (gssize) i + ret;
+}
@@ -0,0 +1,143 @@
+/* GStreamer
+ *
+ * gstbytescan.c: vectorized scanning for start codes
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstbytescan-private.h"
+
+/* in order of preference, the first one the CPU supports is used */
+static const GstByteScanImpl implementations[] = {
+#ifdef HAVE_AVX2
+  {"avx2", gst_byte_scan_start_code_avx2},
+#endif
+#ifdef HAVE_SSE2
+  {"sse2", gst_byte_scan_start_code_sse2},
+#endif
+#ifdef HAVE_NEON
+  {"neon", gst_byte_scan_start_code_neon},
+#endif
+  {"c", gst_byte_scan_start_code_c},
+};
+
+static GstByteScanFunc scan_start_code = gst_byte_scan_start_code_c;
+
+static gboolean
+gst_byte_scan_impl_supported (const GstByteScanImpl * impl)
+{
+#ifdef HAVE_AVX2
+  if (impl->scan_start_code == gst_byte_scan_start_code_avx2)
+    return gst_cpuid_supports_x86_avx2 ();
+#endif
+#ifdef HAVE_SSE2
+  if (impl->scan_start_code == gst_byte_scan_start_code_sse2)
+    return gst_cpuid_supports_x86_sse2 ();
+#endif
+#ifdef HAVE_NEON
+  if (impl->scan_start_code == gst_byte_scan_start_code_neon)
+    return gst_cpuid_supports_arm_neon64 ();
+#endif
+  return TRUE;
+}
+
+static void
+gst_byte_scan_init (void)
+{
+  static gsize init = 0;
+
+  if (g_once_init_enter (&init)) {
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (implementations); i++) {
+      if (gst_byte_scan_impl_supported (&implementations[i]))
+        break;
+    }
+
+    scan_start_code = implementations[i].scan_start_code;
+    GST_CAT_INFO (GST_CAT_PERFORMANCE, "scanning for start codes with %s",
+        implementations[i].name);
+
+    g_once_init_leave (&init, 1);
+  }
+}
+
+/* Returns the implementations that were compiled in and that the CPU
+ * supports, in order of preference. Used by the unit tests. */
+const GstByteScanImpl *
+gst_byte_scan_get_implementations (guint * n_impls)
+{
+  static GstByteScanImpl supported[G_N_ELEMENTS (implementations)];
+  static gsize init = 0;
+  static guint n_supported = 0;
+
+  if (g_once_init_enter (&init)) {
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (implementations); i++) {
+      if (gst_byte_scan_impl_supported (&implementations[i]))
+        supported[n_supported++] = implementations[i];
+    }
+
+    g_once_init_leave (&init, 1);
+  }
+
+  *n_impls = n_supported;
+
+  return supported;
+}
+
+/* Skips ahead as far as the bytes allow: a byte > 1 at position 2 can't be
+ * part of a start code at positions 0 to 2, a non-zero byte at position 1
+ * rules out positions 0 and 1. */
+gssize
+gst_byte_scan_start_code_c (const guint8 * data, gsize size)
+{
+  const guint8 *pdata = data;
+  const guint8 *pend;
+
+  if (G_UNLIKELY (size < 4))
+    return -1;
+
+  pend = data + size - 4;
+
+  while (pdata <= pend) {
+    if (pdata[2] > 1) {
+      pdata += 3;
+    } else if (pdata[1]) {
+      pdata += 2;
+    } else if (pdata[0] || pdata[2] != 1) {
+      pdata++;
+    } else {
+      return (pdata - data);
+    }
+  }
+
+  /* nothing found */
+  return -1;
+}
+
+gssize
+gst_byte_scan_start_code (const guint8 * data, gsize size)
+{
+  gst_byte_scan_init ();
+
+  return scan_start_code (data, size);
+}
@@ -0,0 +1,472 @@
+/* GStreamer
+ *
+ * gstblockstore.c: refcounted blocks of stored data for zero-copy reads
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Data is stored in fixed size blocks that are each wrapped in a #GstMemory,
+ * either in memory or as a shared mapping of a region of a file. Reads return
+ * memory shared from the blocks so that the data is not copied again.
+ *
+ * When the same offset is written again with different data, as in a ring
+ * buffer, the store must be created with copy_on_write. A block that is still
+ * referenced by a buffer is then replaced by a copy before it is written to
+ * and its file region is only reused after the last reference is gone. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#include "gstblockstore.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_block_store_debug);
+#define GST_CAT_DEFAULT gst_block_store_debug
+
+typedef struct
+{
+  GstMemory *mem;
+  guint8 *data;
+} GstBlock;
+
+struct _GstBlockStore
+{
+  /* the store and every mapped block hold a reference */
+  gint refcount;
+
+  gint fd;
+  gsize block_size;
+  gboolean copy_on_write;
+
+  /* GstBlock, indexed by offset / block_size */
+  GArray *blocks;
+  guint64 copies;
+
+  /* size of the file and end of the written data */
+  guint64 file_size;
+  guint64 data_end;
+
+  /* protects the file regions, released blocks are unmapped from any thread */
+  GMutex lock;
+  GArray *free_regions;
+  guint64 n_regions;
+};
+
+typedef struct
+{
+  GstBlockStore *store;
+  guint8 *data;
+  guint64 position;
+} GstBlockMapping;
+
+static void
+gst_block_store_unref (GstBlockStore * store)
+{
+  if (!g_atomic_int_dec_and_test (&store->refcount))
+    return;
+
+  g_mutex_clear (&store->lock);
+  g_array_free (store->free_regions, TRUE);
+  g_free (store);
+}
+
+static void
+gst_block_clear (GstBlock * block)
+{
+  if (block->mem)
+    gst_memory_unref (block->mem);
+  block->mem = NULL;
+  block->data = NULL;
+}
+
+/**
+ * gst_block_store_new:
+ * @fd: file to store the data in, or -1 to keep it in memory
+ * @block_size: size of the blocks, rounded up to the page size
+ * @copy_on_write: whether offsets can be written again with other data
+ * @error: location for a #GError
+ *
+ * Without @copy_on_write, the data is stored at its offset in @fd so that the
+ * file can be kept. @fd stays owned by the caller and must stay open until
+ * the store is freed.
+ *
+ * Returns: a new #GstBlockStore, or %NULL if @fd can't be mapped.
+ */
+GstBlockStore *
+gst_block_store_new (gint fd, gsize block_size, gboolean copy_on_write,
+    GError ** error)
+{
+  GstBlockStore *store;
+  gsize page_size = 4096;
+
+  g_return_val_if_fail (block_size > 0, NULL);
+
+  GST_DEBUG_CATEGORY_INIT (gst_block_store_debug, "blockstore", 0,
+      "block store");
+
+#ifndef HAVE_SYS_MMAN_H
+  if (fd != -1) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_NOT_IMPLEMENTED,
+        "Memory mapping files is not supported");
+    return NULL;
+  }
+#endif
+
+#ifdef HAVE_GETPAGESIZE
+  page_size = getpagesize ();
+#endif
+
+  store = g_new0 (GstBlockStore, 1);
+  store->refcount = 1;
+  store->fd = fd;
+  store->block_size = (block_size + page_size - 1) / page_size * page_size;
+  store->copy_on_write = copy_on_write;
+  store->blocks = g_array_new (FALSE, TRUE, sizeof (GstBlock));
+  g_array_set_clear_func (store->blocks, (GDestroyNotify) gst_block_clear);
+  g_mutex_init (&store->lock);
+  store->free_regions = g_array_new (FALSE, FALSE, sizeof (guint64));
+
+  GST_DEBUG ("new store %p on fd %d, blocks of %" G_GSIZE_FORMAT " bytes",
+      store, fd, store->block_size);
+
+  return store;
+}
+
+/**
+ * gst_block_store_free:
+ * @store: a #GstBlockStore
+ *
+ * Release the blocks of @store. Blocks that are still used by buffers stay
+ * valid until these are freed.
+ */
+void
+gst_block_store_free (GstBlockStore * store)
+{
+  g_return_if_fail (store != NULL);
+
+  g_array_free (store->blocks, TRUE);
+  store->blocks = NULL;
+
+#ifdef HAVE_SYS_MMAN_H
+  /* don't leave the padding of the last block in a file that is kept */
+  if (store->fd != -1 && !store->copy_on_write &&
+      store->file_size > store->data_end) {
+    if (ftruncate (store->fd, store->data_end) < 0)
+      GST_WARNING ("failed to truncate: %s", g_strerror (errno));
+  }
+#endif
+
+  gst_block_store_unref (store);
+}
+
+/**
+ * gst_block_store_get_block_size:
+ * @store: a #GstBlockStore
+ *
+ * Returns: the size of the blocks in @store
+ */
+gsize
+gst_block_store_get_block_size (GstBlockStore * store)
+{
+  g_return_val_if_fail (store != NULL, 0);
+
+  return store->block_size;
+}
+
+/**
+ * gst_block_store_get_copies:
+ * @store: a #GstBlockStore
+ *
+ * Returns: the number of blocks that were copied because they were still
+ * used when written to.
+ */
+guint64
+gst_block_store_get_copies (GstBlockStore * store)
+{
+  g_return_val_if_fail (store != NULL, 0);
+
+  return store->copies;
+}
+
+#ifdef HAVE_SYS_MMAN_H
+static void
+gst_block_mapping_free (GstBlockMapping * mapping)
+{
+  GstBlockStore *store = mapping->store;
+
+  munmap (mapping->data, store->block_size);
+
+  if (store->copy_on_write) {
+    g_mutex_lock (&store->lock);
+    g_array_append_val (store->free_regions, mapping->position);
+    g_mutex_unlock (&store->lock);
+  }
+
+  gst_block_store_unref (store);
+  g_free (mapping);
+}
+
+static gboolean
+gst_block_store_map_block (GstBlockStore * store, guint64 index,
+    GstBlock * block)
+{
+  GstBlockMapping *mapping;
+  guint64 position;
+  gint err;
+  gpointer data;
+
+  g_mutex_lock (&store->lock);
+  if (!store->copy_on_write) {
+    position = index * store->block_size;
+  } else if (store->free_regions->len > 0) {
+    position = g_array_index (store->free_regions, guint64,
+        store->free_regions->len - 1);
+    g_array_set_size (store->free_regions, store->free_regions->len - 1);
+  } else {
+    position = store->n_regions++ * store->block_size;
+  }
+  g_mutex_unlock (&store->lock);
+
+  if (position + store->block_size > store->file_size) {
+    if (ftruncate (store->fd, position + store->block_size) < 0)
+      goto failed;
+    store->file_size = position + store->block_size;
+  }
+
+  data = mmap (NULL, store->block_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+      store->fd, position);
+  if (data == MAP_FAILED)
+    goto failed;
+
+  mapping = g_new (GstBlockMapping, 1);
+  g_atomic_int_inc (&store->refcount);
+  mapping->store = store;
+  mapping->data = data;
+  mapping->position = position;
+
+  block->data = data;
+  block->mem = gst_memory_new_wrapped (0, data, store->block_size, 0,
+      store->block_size, mapping, (GDestroyNotify) gst_block_mapping_free);
+
+  return TRUE;
+
+  /* ERRORS */
+failed:
+  {
+    err = errno;
+    GST_WARNING ("failed to map region %" G_GUINT64_FORMAT ": %s", position,
+        g_strerror (err));
+    if (store->copy_on_write) {
+      g_mutex_lock (&store->lock);
+      g_array_append_val (store->free_regions, position);
+      g_mutex_unlock (&store->lock);
+    }
+    errno = err;
+    return FALSE;
+  }
+}
+#endif
+
+static gboolean
+gst_block_store_alloc_block (GstBlockStore * store, guint64 index,
+    GstBlock * block)
+{
+#ifdef HAVE_SYS_MMAN_H
+  if (store->fd != -1)
+    return gst_block_store_map_block (store, index, block);
+#endif
+
+  block->data = g_malloc (store->block_size);
+  block->mem = gst_memory_new_wrapped (0, block->data, store->block_size, 0,
+      store->block_size, block->data, g_free);
+
+  return TRUE;
+}
+
+/* get block @index to write to, replacing it when buffers still use it */
+static GstBlock *
+gst_block_store_get_writable (GstBlockStore * store, guint64 index)
+{
+  GstBlock *block, copy;
+
+  if (index >= store->blocks->len)
+    g_array_set_size (store->blocks, index + 1);
+
+  block = &g_array_index (store->blocks, GstBlock, index);
+
+  if (block->mem == NULL) {
+    if (!gst_block_store_alloc_block (store, index, block))
+      return NULL;
+  } else if (store->copy_on_write &&
+      GST_MINI_OBJECT_REFCOUNT_VALUE (block->mem) > 1) {
+    GST_LOG ("block %" G_GUINT64_FORMAT " is still used, copying", index);
+
+    if (!gst_block_store_alloc_block (store, index, &copy))
+      return NULL;
+
+    memcpy (copy.data, block->data, store->block_size);
+    gst_block_clear (block);
+    *block = copy;
+    store->copies++;
+  }
+
+  return block;
+}
+
+/**
+ * gst_block_store_write:
+ * @store: a #GstBlockStore
+ * @offset: offset to write to
+ * @data: (array length=size): data to write
+ * @size: size of @data
+ *
+ * Store @data at @offset.
+ *
+ * Returns: %TRUE on success, %FALSE with errno set otherwise.
+ */
+gboolean
+gst_block_store_write (GstBlockStore * store, guint64 offset,
+    const guint8 * data, gsize size)
+{
+  g_return_val_if_fail (store != NULL, FALSE);
+
+  store->data_end = MAX (store->data_end, offset + size);
+
+  while (size > 0) {
+    guint64 index = offset / store->block_size;
+    gsize block_offset = offset % store->block_size;
+    gsize to_write = MIN (size, store->block_size - block_offset);
+    GstBlock *block;
+
+    if (!(block = gst_block_store_get_writable (store, index)))
+      return FALSE;
+
+    memcpy (block->data + block_offset, data, to_write);
+
+    offset += to_write;
+    data += to_write;
+    size -= to_write;
+  }
+
+  return TRUE;
+}
+
+/**
+ * gst_block_store_read:
+ * @store: a #GstBlockStore
+ * @offset: offset to read from
+ * @size: number of bytes to read
+ * @buffer: buffer to append the data to
+ *
+ * Append the data at @offset to @buffer as readonly memory that is shared
+ * with the store.
+ *
+ * Returns: the number of bytes appended, which is less than @size at the end
+ * of the written data.
+ */
+gsize
+gst_block_store_read (GstBlockStore * store, guint64 offset, gsize size,
+    GstBuffer * buffer)
+{
+  gsize done = 0;
+
+  g_return_val_if_fail (store != NULL, 0);
+
+  if (offset >= store->data_end)
+    return 0;
+  size = MIN (size, store->data_end - offset);
+
+  while (size > 0) {
+    guint64 index = offset / store->block_size;
+    gsize block_offset = offset % store->block_size;
+    gsize to_read = MIN (size, store->block_size - block_offset);
+    GstMemory *mem;
+    GstBlock *block;
+
+    if (index >= store->blocks->len)
+      break;
+    block = &g_array_index (store->blocks, GstBlock, index);
+    if (block->mem == NULL)
+      break;
+
+    if (!(mem = gst_memory_share (block->mem, block_offset, to_read)))
+      break;
+    gst_buffer_append_memory (buffer, mem);
+
+    offset += to_read;
+    size -= to_read;
+    done += to_read;
+  }
+
+  return done;
+}
+
+/**
+ * gst_block_store_fill:
+ * @store: a #GstBlockStore
+ * @offset: offset to read from
+ * @dest: (array length=size): destination
+ * @size: number of bytes to read
+ *
+ * Copy the data at @offset to @dest.
+ *
+ * Returns: the number of bytes copied, which is less than @size at the end
+ * of the written data.
+ */
+gsize
+gst_block_store_fill (GstBlockStore * store, guint64 offset, guint8 * dest,
+    gsize size)
+{
+  gsize done = 0;
+
+  g_return_val_if_fail (store != NULL, 0);
+
+  if (offset >= store->data_end)
+    return 0;
+  size = MIN (size, store->data_end - offset);
+
+  while (size > 0) {
+    guint64 index = offset / store->block_size;
+    gsize block_offset = offset % store->block_size;
+    gsize to_read = MIN (size, store->block_size - block_offset);
+    GstBlock *block;
+
+    if (index >= store->blocks->len)
+      break;
+    block = &g_array_index (store->blocks, GstBlock, index);
+    if (block->mem == NULL)
+      break;
+
+    memcpy (dest, block->data + block_offset, to_read);
+
+    offset += to_read;
+    dest += to_read;
+    size -= to_read;
+    done += to_read;
+  }
+
+  return done;
+}
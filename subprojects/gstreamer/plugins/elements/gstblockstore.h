@@ -0,0 +1,62 @@
+/* GStreamer
+ *
+ * gstblockstore.h: refcounted blocks of stored data for zero-copy reads
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_BLOCK_STORE_H__
+#define __GST_BLOCK_STORE_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstBlockStore GstBlockStore;
+
+G_GNUC_INTERNAL
+GstBlockStore * gst_block_store_new            (gint fd, gsize block_size,
+                                                gboolean copy_on_write,
+                                                GError ** error);
+
+G_GNUC_INTERNAL
+void            gst_block_store_free           (GstBlockStore * store);
+
+G_GNUC_INTERNAL
+gsize           gst_block_store_get_block_size (GstBlockStore * store);
+
+G_GNUC_INTERNAL
+guint64         gst_block_store_get_copies     (GstBlockStore * store);
+
+G_GNUC_INTERNAL
+gboolean        gst_block_store_write          (GstBlockStore * store,
+                                                guint64 offset,
+                                                const guint8 * data,
+                                                gsize size);
+
+G_GNUC_INTERNAL
+gsize           gst_block_store_read           (GstBlockStore * store,
+                                                guint64 offset, gsize size,
+                                                GstBuffer * buffer);
+
+G_GNUC_INTERNAL
+gsize           gst_block_store_fill           (GstBlockStore * store,
+                                                guint64 offset, guint8 * dest,
+                                                gsize size);
+
+G_END_DECLS
+
+#endif /* __GST_BLOCK_STORE_H__ */
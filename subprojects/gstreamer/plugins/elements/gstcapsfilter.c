@@ -109,6 +109,8 @@ static gboolean gst_capsfilter_accept_caps (GstBaseTransform * base,
     GstPadDirection direction, GstCaps * caps);
 static GstFlowReturn gst_capsfilter_transform_ip (GstBaseTransform * base,
     GstBuffer * buf);
+static GstFlowReturn gst_capsfilter_transform_list_ip (GstBaseTransform *
+    base, GstBufferList * list);
 static GstFlowReturn gst_capsfilter_prepare_buf (GstBaseTransform * trans,
     GstBuffer * input, GstBuffer ** buf);
 static gboolean gst_capsfilter_sink_event (GstBaseTransform * trans,
@@ -155,6 +157,8 @@ gst_capsfilter_class_init (GstCapsFilterClass * klass)
   trans_class->transform_caps =
       GST_DEBUG_FUNCPTR (gst_capsfilter_transform_caps);
   trans_class->transform_ip = GST_DEBUG_FUNCPTR (gst_capsfilter_transform_ip);
+  trans_class->transform_list_ip =
+      GST_DEBUG_FUNCPTR (gst_capsfilter_transform_list_ip);
   trans_class->accept_caps = GST_DEBUG_FUNCPTR (gst_capsfilter_accept_caps);
   trans_class->prepare_output_buffer =
       GST_DEBUG_FUNCPTR (gst_capsfilter_prepare_buf);
@@ -170,6 +174,7 @@ gst_capsfilter_init (GstCapsFilter * filter)
   GstBaseTransform *trans = GST_BASE_TRANSFORM (filter);
   gst_base_transform_set_gap_aware (trans, TRUE);
   gst_base_transform_set_prefer_passthrough (trans, FALSE);
+  gst_base_transform_set_buffer_list_aware (trans, TRUE);
   filter->filter_caps = gst_caps_new_any ();
   filter->filter_caps_used = FALSE;
   filter->got_sink_caps = FALSE;
@@ -376,6 +381,14 @@ gst_capsfilter_transform_ip (GstBaseTransform * base, GstBuffer * buf)
   return GST_FLOW_OK;
 }
 
+static GstFlowReturn
+gst_capsfilter_transform_list_ip (GstBaseTransform * base,
+    GstBufferList * list)
+{
+  /* Same as for single buffers, lists are pushed as they are */
+  return GST_FLOW_OK;
+}
+
 static void
 gst_capsfilter_push_pending_events (GstCapsFilter * filter, GList * events)
 {
@@ -32,12 +32,35 @@
  * gst-launch-1.0 v4l2src num-buffers=1 ! jpegenc ! filesink location=capture1.jpeg
  * ]| Capture one frame from a v4l2 camera and save as jpeg image.
  *
+ * ## io_uring mode
+ *
+ * On Linux, when #GstFileSink:io-uring is enabled, incoming data is collected
+ * in chunks of #GstFileSink:buffer-size bytes that are written behind with
+ * up to #GstFileSink:io-uring-depth requests in flight on an io_uring, so
+ * that the streaming thread does not wait for the disk. Buffers that are
+ * larger than a chunk are written without copying. All pending writes are
+ * completed on seeks, on EOS and before buffers with the
+ * %GST_BUFFER_FLAG_SYNC_AFTER flag are synced. With #GstFileSink:direct full
+ * chunks bypass the page cache with O_DIRECT. #GstFileSink:preallocate
+ * reserves disk space ahead of the writes in any mode, and the
+ * #GstFileSink:stats property reports throughput and latency of the
+ * requests.
+ *
+ * |[
+ * gst-launch-1.0 videotestsrc ! x264enc ! matroskamux ! filesink location=out.mkv io-uring=true buffer-size=1048576 preallocate=67108864
+ * ]| Write with up to 8 MB in flight, reserving disk space in 64 MB steps.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
 #  include "config.h"
 #endif
 
+#if defined (HAVE_LIBURING) || defined (HAVE_FALLOCATE)
+/* for O_DIRECT and fallocate() */
+#define _GNU_SOURCE 1
+#endif
+
 #include <glib/gi18n-lib.h>
 
 #include <gst/gst.h>
@@ -161,6 +184,10 @@ GST_DEBUG_CATEGORY_STATIC (gst_file_sink_debug);
 #define DEFAULT_MAX_TRANSIENT_ERROR_TIMEOUT	0
 #define DEFAULT_FILE_MODE      GST_FILE_SINK_FILE_MODE_TRUNC
 #define DEFAULT_DENY_MODE      GST_FILE_SINK_SHARE_DENYNO
+#define DEFAULT_IO_URING       FALSE
+#define DEFAULT_IO_URING_DEPTH 8
+#define DEFAULT_DIRECT         FALSE
+#define DEFAULT_PREALLOCATE    0
 
 enum
 {
@@ -173,6 +200,11 @@ enum
   PROP_MAX_TRANSIENT_ERROR_TIMEOUT,
   PROP_FILE_MODE,
   PROP_SHARE_DENY_MODE,
+  PROP_IO_URING,
+  PROP_IO_URING_DEPTH,
+  PROP_DIRECT,
+  PROP_PREALLOCATE,
+  PROP_STATS,
   PROP_LAST
 };
 
@@ -332,6 +364,80 @@ gst_file_sink_class_init (GstFileSinkClass * klass)
           GST_TYPE_FILE_SINK_SHARE_DENY_MODE,
           DEFAULT_DENY_MODE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstFileSink:io-uring:
+   *
+   * Write behind with io_uring. Falls back to blocking writes with a warning
+   * when io_uring is not available, the file is not seekable or is opened in
+   * append mode. #GstFileSink:buffer-mode is ignored in io_uring mode.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_IO_URING,
+      g_param_spec_boolean ("io-uring", "io_uring",
+          "Write behind with io_uring", DEFAULT_IO_URING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstFileSink:io-uring-depth:
+   *
+   * The number of write requests kept in flight in io_uring mode.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_IO_URING_DEPTH,
+      g_param_spec_uint ("io-uring-depth", "io_uring depth",
+          "Number of write requests in flight in io_uring mode", 1, 256,
+          DEFAULT_IO_URING_DEPTH, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstFileSink:direct:
+   *
+   * Bypass the page cache with O_DIRECT for full chunks in io_uring mode. The
+   * #GstFileSink:buffer-size is rounded up to a multiple of 4096 bytes.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_DIRECT,
+      g_param_spec_boolean ("direct", "Direct I/O",
+          "Bypass the page cache with O_DIRECT in io_uring mode",
+          DEFAULT_DIRECT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstFileSink:preallocate:
+   *
+   * Reserve disk space with fallocate() in steps of this many bytes before
+   * writing past the reserved space, to reduce fragmentation and metadata
+   * updates. The file size only reflects the written data.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_PREALLOCATE,
+      g_param_spec_uint64 ("preallocate", "Preallocate",
+          "Reserve disk space in steps of this many bytes (0 = disabled)", 0,
+          G_MAXUINT64, DEFAULT_PREALLOCATE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstFileSink:stats:
+   *
+   * Statistics about the io_uring write-behind in a structure named
+   * "application/x-gst-file-sink-stats" with these fields:
+   *
+   * - "requests" G_TYPE_UINT64: the number of completed requests
+   * - "bytes" G_TYPE_UINT64: the number of bytes written
+   * - "pending" G_TYPE_UINT: the number of requests in flight
+   * - "average-latency" G_TYPE_UINT64: the average request latency in ns
+   * - "max-latency" G_TYPE_UINT64: the highest request latency in ns
+   * - "throughput" G_TYPE_DOUBLE: the bytes written per second
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "io_uring statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "File Sink",
       "Sink/File", "Write stream to a file",
@@ -370,6 +476,11 @@ gst_file_sink_init (GstFileSink * filesink)
   filesink->append = FALSE;
   filesink->file_mode = DEFAULT_FILE_MODE;
   filesink->deny_mode = DEFAULT_DENY_MODE;
+  filesink->io_uring = DEFAULT_IO_URING;
+  filesink->io_uring_depth = DEFAULT_IO_URING_DEPTH;
+  filesink->direct = DEFAULT_DIRECT;
+  filesink->preallocate = DEFAULT_PREALLOCATE;
+  filesink->direct_fd = -1;
 
   gst_base_sink_set_sync (GST_BASE_SINK (filesink), FALSE);
 }
@@ -453,6 +564,18 @@ gst_file_sink_set_property (GObject * object, guint prop_id,
     case PROP_SHARE_DENY_MODE:
       sink->deny_mode = g_value_get_enum (value);
       break;
+    case PROP_IO_URING:
+      sink->io_uring = g_value_get_boolean (value);
+      break;
+    case PROP_IO_URING_DEPTH:
+      sink->io_uring_depth = g_value_get_uint (value);
+      break;
+    case PROP_DIRECT:
+      sink->direct = g_value_get_boolean (value);
+      break;
+    case PROP_PREALLOCATE:
+      sink->preallocate = g_value_get_uint64 (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -490,12 +613,138 @@ gst_file_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_SHARE_DENY_MODE:
       g_value_set_enum (value, sink->deny_mode);
       break;
+    case PROP_IO_URING:
+      g_value_set_boolean (value, sink->io_uring);
+      break;
+    case PROP_IO_URING_DEPTH:
+      g_value_set_uint (value, sink->io_uring_depth);
+      break;
+    case PROP_DIRECT:
+      g_value_set_boolean (value, sink->direct);
+      break;
+    case PROP_PREALLOCATE:
+      g_value_set_uint64 (value, sink->preallocate);
+      break;
+    case PROP_STATS:
+      GST_OBJECT_LOCK (sink);
+      g_value_take_boxed (value, gst_file_uring_get_stats (sink->uring,
+              "application/x-gst-file-sink-stats"));
+      GST_OBJECT_UNLOCK (sink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
 
+static void
+gst_file_sink_uring_open (GstFileSink * sink)
+{
+  GstFileUring *uring;
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstAllocationParams params;
+  GError *err = NULL;
+
+  if (!sink->seekable || sink->append
+      || sink->file_mode == GST_FILE_SINK_FILE_MODE_APPEND) {
+    GST_ELEMENT_WARNING (sink, RESOURCE, SETTINGS, (NULL),
+        ("io_uring mode needs a seekable file that is not opened for "
+            "appending, using blocking writes"));
+    return;
+  }
+
+  uring = gst_file_uring_new (GST_OBJECT_CAST (sink), sink->io_uring_depth,
+      &err);
+  if (uring == NULL) {
+    GST_ELEMENT_WARNING (sink, RESOURCE, SETTINGS, (NULL),
+        ("%s, using blocking writes", err->message));
+    g_clear_error (&err);
+    return;
+  }
+
+  sink->uring_chunk_size = sink->buffer_size ? sink->buffer_size :
+      DEFAULT_BUFFER_SIZE;
+
+#ifdef O_DIRECT
+  if (sink->direct) {
+    sink->direct_fd = open (sink->filename,
+        O_WRONLY | O_DIRECT | (sink->o_sync ? O_SYNC : 0));
+    if (sink->direct_fd < 0)
+      GST_ELEMENT_WARNING (sink, RESOURCE, SETTINGS, (NULL),
+          ("Could not open \"%s\" with O_DIRECT: %s", sink->filename,
+              g_strerror (errno)));
+    else
+      sink->uring_chunk_size = GST_ROUND_UP_N (sink->uring_chunk_size,
+          GST_FILE_URING_DIRECT_ALIGN);
+  }
+#else
+  if (sink->direct)
+    GST_ELEMENT_WARNING (sink, RESOURCE, SETTINGS, (NULL),
+        ("O_DIRECT is not supported on this platform"));
+#endif
+
+  /* one chunk is being filled while the others are in flight */
+  pool = gst_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, NULL, sink->uring_chunk_size,
+      0, sink->io_uring_depth + 1);
+  gst_allocation_params_init (&params);
+  if (sink->direct_fd >= 0)
+    params.align = GST_FILE_URING_DIRECT_ALIGN - 1;
+  gst_buffer_pool_config_set_allocator (config, NULL, &params);
+
+  if (!gst_buffer_pool_set_config (pool, config)
+      || !gst_buffer_pool_set_active (pool, TRUE)) {
+    GST_ELEMENT_WARNING (sink, RESOURCE, SETTINGS, (NULL),
+        ("Could not create a buffer pool, using blocking writes"));
+    gst_object_unref (pool);
+    gst_file_uring_free (uring);
+    if (sink->direct_fd >= 0) {
+      close (sink->direct_fd);
+      sink->direct_fd = -1;
+    }
+    return;
+  }
+
+  sink->uring_pool = pool;
+
+  GST_OBJECT_LOCK (sink);
+  sink->uring = uring;
+  GST_OBJECT_UNLOCK (sink);
+}
+
+static void
+gst_file_sink_uring_close (GstFileSink * sink)
+{
+  GstFileUring *uring;
+
+  GST_OBJECT_LOCK (sink);
+  uring = sink->uring;
+  sink->uring = NULL;
+  GST_OBJECT_UNLOCK (sink);
+
+  if (uring != NULL)
+    gst_file_uring_free (uring);
+
+  if (sink->uring_chunk != NULL) {
+    gst_buffer_unmap (sink->uring_chunk, &sink->uring_map);
+    gst_buffer_unref (sink->uring_chunk);
+    sink->uring_chunk = NULL;
+  }
+
+  if (sink->uring_pool != NULL) {
+    gst_buffer_pool_set_active (sink->uring_pool, FALSE);
+    gst_object_unref (sink->uring_pool);
+    sink->uring_pool = NULL;
+  }
+
+  if (sink->direct_fd >= 0) {
+    close (sink->direct_fd);
+    sink->direct_fd = -1;
+  }
+}
+
 static gboolean
 gst_file_sink_open_file (GstFileSink * sink)
 {
@@ -524,6 +773,7 @@ gst_file_sink_open_file (GstFileSink * sink)
     goto open_failed;
 
   sink->current_pos = 0;
+  sink->allocated_size = 0;
   /* try to seek in the file to figure out if it is seekable */
   sink->seekable = gst_file_sink_do_seek (sink, 0);
 
@@ -534,7 +784,12 @@ gst_file_sink_open_file (GstFileSink * sink)
     gst_buffer_list_unref (sink->buffer_list);
   sink->buffer_list = NULL;
 
-  if (sink->buffer_mode != GST_FILE_SINK_BUFFER_MODE_UNBUFFERED) {
+  if (sink->io_uring)
+    gst_file_sink_uring_open (sink);
+
+  /* in io_uring mode the data is collected in chunks instead */
+  if (sink->uring == NULL
+      && sink->buffer_mode != GST_FILE_SINK_BUFFER_MODE_UNBUFFERED) {
     if (sink->buffer_size == 0) {
       sink->buffer_size = DEFAULT_BUFFER_SIZE;
       g_object_notify (G_OBJECT (sink), "buffer-size");
@@ -549,8 +804,8 @@ gst_file_sink_open_file (GstFileSink * sink)
     sink->current_buffer_size = 0;
   }
 
-  GST_DEBUG_OBJECT (sink, "opened file %s, seekable %d",
-      sink->filename, sink->seekable);
+  GST_DEBUG_OBJECT (sink, "opened file %s, seekable %d, io_uring %d",
+      sink->filename, sink->seekable, sink->uring != NULL);
 
   return TRUE;
 
@@ -578,6 +833,8 @@ gst_file_sink_close_file (GstFileSink * sink)
       GST_ELEMENT_ERROR (sink, RESOURCE, CLOSE,
           (_("Error closing file \"%s\"."), sink->filename), NULL);
 
+    gst_file_sink_uring_close (sink);
+
     if (fclose (sink->file) != 0)
       GST_ELEMENT_ERROR (sink, RESOURCE, CLOSE,
           (_("Error closing file \"%s\"."), sink->filename), GST_ERROR_SYSTEM);
@@ -744,6 +1001,7 @@ gst_file_sink_event (GstBaseSink * sink, GstEvent * event)
         gst_file_sink_do_seek (filesink, 0);
         if (ftruncate (fileno (filesink->file), 0))
           goto truncate_failed;
+        filesink->allocated_size = 0;
       }
       if (filesink->buffer_list) {
         gst_buffer_list_unref (filesink->buffer_list);
@@ -811,6 +1069,217 @@ gst_file_sink_get_current_offset (GstFileSink * filesink, guint64 * p_pos)
   return (ret != (off_t) - 1);
 }
 
+/* reserve disk space up to at least @end */
+static void
+gst_file_sink_preallocate (GstFileSink * sink, guint64 end)
+{
+#if defined (HAVE_FALLOCATE) && defined (FALLOC_FL_KEEP_SIZE)
+  guint64 new_size;
+
+  if (sink->preallocate == 0 || end <= sink->allocated_size)
+    return;
+
+  new_size = (end + sink->preallocate - 1) / sink->preallocate;
+  new_size *= sink->preallocate;
+
+  GST_LOG_OBJECT (sink, "preallocating up to %" G_GUINT64_FORMAT, new_size);
+
+  if (fallocate (fileno (sink->file), FALLOC_FL_KEEP_SIZE,
+          (off_t) sink->allocated_size,
+          (off_t) (new_size - sink->allocated_size)) < 0) {
+    GST_WARNING_OBJECT (sink, "preallocation failed, disabling: %s",
+        g_strerror (errno));
+    new_size = G_MAXUINT64;
+  }
+
+  sink->allocated_size = new_size;
+#endif
+}
+
+static GstFlowReturn
+gst_file_sink_uring_pop (GstFileSink * sink)
+{
+  GstBuffer *buf;
+  gssize res;
+  gsize size;
+
+  res = gst_file_uring_pop (sink->uring, &buf);
+  size = buf ? gst_buffer_get_size (buf) : 0;
+  gst_clear_buffer (&buf);
+
+  /* short writes are only returned when nothing more could be written */
+  if (res >= 0 && (gsize) res < size)
+    res = -ENOSPC;
+
+  if (res < 0)
+    goto write_error;
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+write_error:
+  {
+    switch (-res) {
+      case ENOSPC:
+        GST_ELEMENT_ERROR (sink, RESOURCE, NO_SPACE_LEFT, (NULL), (NULL));
+        break;
+      default:
+        GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
+            (_("Error while writing to file \"%s\"."), sink->filename),
+            ("%s", g_strerror (-res)));
+        break;
+    }
+    return GST_FLOW_ERROR;
+  }
+}
+
+/* submits @buffer to be written at the current position */
+static GstFlowReturn
+gst_file_sink_uring_write (GstFileSink * sink, GstBuffer * buffer)
+{
+  GstFlowReturn flow;
+  gsize size;
+  gint fd, res;
+
+  if (gst_file_uring_is_full (sink->uring)) {
+    flow = gst_file_sink_uring_pop (sink);
+    if (flow != GST_FLOW_OK) {
+      gst_buffer_unref (buffer);
+      return flow;
+    }
+  }
+
+  size = gst_buffer_get_size (buffer);
+  gst_file_sink_preallocate (sink, sink->current_pos + size);
+
+  /* only chunks are written to the O_DIRECT fd, they are aligned in memory
+   * but can start at any offset after seeking and the last one can be
+   * shorter */
+  fd = fileno (sink->file);
+  if (sink->direct_fd >= 0
+      && sink->current_pos % GST_FILE_URING_DIRECT_ALIGN == 0
+      && size % GST_FILE_URING_DIRECT_ALIGN == 0)
+    fd = sink->direct_fd;
+
+  res = gst_file_uring_push_write (sink->uring, fd, sink->current_pos,
+      buffer);
+  if (res < 0)
+    goto submit_failed;
+
+  sink->current_pos += size;
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+submit_failed:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
+        (_("Error while writing to file \"%s\"."), sink->filename),
+        ("Could not submit write request: %s", g_strerror (-res)));
+    return GST_FLOW_ERROR;
+  }
+}
+
+static GstFlowReturn
+gst_file_sink_uring_submit_chunk (GstFileSink * sink)
+{
+  GstBuffer *chunk;
+
+  if (sink->uring_chunk == NULL)
+    return GST_FLOW_OK;
+
+  chunk = sink->uring_chunk;
+  sink->uring_chunk = NULL;
+  gst_buffer_unmap (chunk, &sink->uring_map);
+
+  if (sink->current_buffer_size == 0) {
+    gst_buffer_unref (chunk);
+    return GST_FLOW_OK;
+  }
+
+  gst_buffer_resize (chunk, 0, sink->current_buffer_size);
+  sink->current_buffer_size = 0;
+
+  return gst_file_sink_uring_write (sink, chunk);
+}
+
+/* writes out the partially filled chunk and waits for all writes */
+static GstFlowReturn
+gst_file_sink_uring_flush (GstFileSink * sink)
+{
+  GstFlowReturn flow, ret;
+
+  ret = gst_file_sink_uring_submit_chunk (sink);
+
+  while (gst_file_uring_get_pending (sink->uring) > 0) {
+    flow = gst_file_sink_uring_pop (sink);
+    if (ret == GST_FLOW_OK)
+      ret = flow;
+  }
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_file_sink_uring_render (GstFileSink * sink, GstBuffer * buffer)
+{
+  GstFlowReturn flow;
+  gsize size, offset, len;
+
+  size = gst_buffer_get_size (buffer);
+
+  GST_LOG_OBJECT (sink, "writing %" G_GSIZE_FORMAT " bytes at offset %"
+      G_GUINT64_FORMAT, size, sink->current_pos + sink->current_buffer_size);
+
+  /* buffers of at least a chunk are written without copying, unless they
+   * would have to be aligned for O_DIRECT */
+  if (sink->direct_fd < 0 && size >= sink->uring_chunk_size) {
+    flow = gst_file_sink_uring_submit_chunk (sink);
+    if (flow != GST_FLOW_OK)
+      return flow;
+
+    return gst_file_sink_uring_write (sink, gst_buffer_ref (buffer));
+  }
+
+  for (offset = 0; offset < size; offset += len) {
+    if (sink->uring_chunk == NULL) {
+      flow = gst_buffer_pool_acquire_buffer (sink->uring_pool,
+          &sink->uring_chunk, NULL);
+      if (flow != GST_FLOW_OK)
+        return flow;
+
+      if (!gst_buffer_map (sink->uring_chunk, &sink->uring_map,
+              GST_MAP_WRITE)) {
+        gst_buffer_unref (sink->uring_chunk);
+        sink->uring_chunk = NULL;
+        goto map_failed;
+      }
+    }
+
+    len = MIN (size - offset,
+        sink->uring_chunk_size - sink->current_buffer_size);
+    gst_buffer_extract (buffer, offset,
+        sink->uring_map.data + sink->current_buffer_size, len);
+    sink->current_buffer_size += len;
+
+    if (sink->current_buffer_size == sink->uring_chunk_size) {
+      flow = gst_file_sink_uring_submit_chunk (sink);
+      if (flow != GST_FLOW_OK)
+        return flow;
+    }
+  }
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+map_failed:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, (NULL),
+        ("Could not map chunk"));
+    return GST_FLOW_ERROR;
+  }
+}
+
 static GstFlowReturn
 gst_file_sink_render_list_internal (GstFileSink * sink,
     GstBufferList * buffer_list)
@@ -827,6 +1296,9 @@ gst_file_sink_render_list_internal (GstFileSink * sink,
       "writing %u buffers at position %" G_GUINT64_FORMAT, num_buffers,
       sink->current_pos);
 
+  gst_file_sink_preallocate (sink, sink->current_pos +
+      gst_buffer_list_calculate_size (buffer_list));
+
   for (;;) {
     guint64 bytes_written = 0;
 
@@ -864,9 +1336,14 @@ gst_file_sink_flush_buffer (GstFileSink * filesink)
   GST_DEBUG_OBJECT (filesink, "Flushing out buffer of size %" G_GSIZE_FORMAT,
       filesink->current_buffer_size);
 
-  if (filesink->buffer && filesink->current_buffer_size) {
+  if (filesink->uring) {
+    flow_ret = gst_file_sink_uring_flush (filesink);
+  } else if (filesink->buffer && filesink->current_buffer_size) {
     guint64 skip = 0;
 
+    gst_file_sink_preallocate (filesink, filesink->current_pos +
+        filesink->current_buffer_size);
+
     for (;;) {
       guint64 bytes_written = 0;
 
@@ -935,6 +1412,9 @@ render_buffer (GstFileSink * filesink, GstBuffer * buffer)
   guint64 bytes_written = 0;
   guint64 skip = 0;
 
+  gst_file_sink_preallocate (filesink, filesink->current_pos +
+      gst_buffer_get_size (buffer));
+
   for (;;) {
     flow =
         gst_writev_buffer (GST_OBJECT_CAST (filesink),
@@ -974,7 +1454,14 @@ gst_file_sink_render_list (GstBaseSink * bsink, GstBufferList * buffer_list)
 
   gst_buffer_list_foreach (buffer_list, has_sync_after_buffer, &sync_after);
 
-  if (sync_after || (!sink->buffer && !sink->buffer_list)) {
+  if (sink->uring) {
+    flow = GST_FLOW_OK;
+    for (i = 0; i < num_buffers && flow == GST_FLOW_OK; i++)
+      flow = gst_file_sink_uring_render (sink,
+          gst_buffer_list_get (buffer_list, i));
+    if (flow == GST_FLOW_OK && sync_after)
+      flow = gst_file_sink_flush_buffer (sink);
+  } else if (sync_after || (!sink->buffer && !sink->buffer_list)) {
     flow = gst_file_sink_flush_buffer (sink);
     if (flow == GST_FLOW_OK)
       flow = gst_file_sink_render_list_internal (sink, buffer_list);
@@ -1063,7 +1550,11 @@ gst_file_sink_render (GstBaseSink * sink, GstBuffer * buffer)
 
   n_mem = gst_buffer_n_memory (buffer);
 
-  if (n_mem > 0 && (sync_after || (!filesink->buffer
+  if (filesink->uring) {
+    flow = gst_file_sink_uring_render (filesink, buffer);
+    if (flow == GST_FLOW_OK && sync_after)
+      flow = gst_file_sink_flush_buffer (filesink);
+  } else if (n_mem > 0 && (sync_after || (!filesink->buffer
               && !filesink->buffer_list))) {
     flow = gst_file_sink_flush_buffer (filesink);
     if (flow == GST_FLOW_OK) {
@@ -29,6 +29,8 @@
 #include <gst/gst.h>
 #include <gst/base/gstbasesink.h>
 
+#include "gstfileuring.h"
+
 G_BEGIN_DECLS
 #define GST_TYPE_FILE_SINK \
   (gst_file_sink_get_type())
@@ -132,6 +134,22 @@ struct _GstFileSink {
   GstFileSinkShareDenyMode deny_mode;
 
   gboolean flushing;
+
+  /* io_uring write-behind */
+  gboolean io_uring;
+  guint io_uring_depth;
+  gboolean direct;
+  guint64 preallocate;
+
+  GstFileUring *uring;
+  gint direct_fd;                       /* fd opened with O_DIRECT or -1 */
+  GstBufferPool *uring_pool;
+  gsize uring_chunk_size;
+  GstBuffer *uring_chunk;               /* chunk being filled, of which
+                                           current_buffer_size is used */
+  GstMapInfo uring_map;
+
+  guint64 allocated_size;               /* end of the preallocated space */
 };
 
 struct _GstFileSinkClass {
@@ -31,12 +31,32 @@
  * gst-launch-1.0 filesrc location=song.ogg ! decodebin ! audioconvert ! audioresample ! autoaudiosink
  * ]| Play song.ogg audio file which must be in the current working directory.
  *
+ * ## io_uring mode
+ *
+ * On Linux, when #GstFileSrc:io-uring is enabled, sequential reads are served
+ * from up to #GstFileSrc:io-uring-depth read-ahead requests that are kept in
+ * flight on an io_uring, reading into buffers from an internal buffer pool.
+ * Reads at other offsets, as done while a demuxer looks for headers, are
+ * still done directly. With #GstFileSrc:direct the read-ahead bypasses the
+ * page cache with O_DIRECT, which requires the blocksize to be a multiple
+ * of 4096 bytes. The #GstFileSrc:stats property reports throughput and
+ * latency of the requests.
+ *
+ * |[
+ * gst-launch-1.0 filesrc location=movie.mkv io-uring=true blocksize=1048576 ! matroskademux ! fakesink
+ * ]| Read a file with up to 8 MB of read-ahead in flight.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
 #  include "config.h"
 #endif
 
+#ifdef HAVE_LIBURING
+/* for O_DIRECT */
+#define _GNU_SOURCE 1
+#endif
+
 #include <gst/gst.h>
 #include <glib/gstdio.h>
 #include "gstfilesrc.h"
@@ -113,11 +133,18 @@ enum
 };
 
 #define DEFAULT_BLOCKSIZE       4*1024
+#define DEFAULT_IO_URING        FALSE
+#define DEFAULT_IO_URING_DEPTH  8
+#define DEFAULT_DIRECT          FALSE
 
 enum
 {
   PROP_0,
-  PROP_LOCATION
+  PROP_LOCATION,
+  PROP_IO_URING,
+  PROP_IO_URING_DEPTH,
+  PROP_DIRECT,
+  PROP_STATS
 };
 
 static void gst_file_src_finalize (GObject * object);
@@ -132,6 +159,8 @@ static gboolean gst_file_src_stop (GstBaseSrc * basesrc);
 
 static gboolean gst_file_src_is_seekable (GstBaseSrc * src);
 static gboolean gst_file_src_get_size (GstBaseSrc * src, guint64 * size);
+static GstFlowReturn gst_file_src_create (GstBaseSrc * src, guint64 offset,
+    guint length, GstBuffer ** buf);
 static GstFlowReturn gst_file_src_fill (GstBaseSrc * src, guint64 offset,
     guint length, GstBuffer * buf);
 
@@ -166,6 +195,69 @@ gst_file_src_class_init (GstFileSrcClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
 
+  /**
+   * GstFileSrc:io-uring:
+   *
+   * Read ahead with io_uring. Falls back to blocking reads with a warning
+   * when io_uring is not available or the file is not a regular file.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_IO_URING,
+      g_param_spec_boolean ("io-uring", "io_uring",
+          "Read ahead with io_uring", DEFAULT_IO_URING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstFileSrc:io-uring-depth:
+   *
+   * The number of blocksize read-ahead requests kept in flight in io_uring
+   * mode.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_IO_URING_DEPTH,
+      g_param_spec_uint ("io-uring-depth", "io_uring depth",
+          "Number of read-ahead requests in flight in io_uring mode", 1, 256,
+          DEFAULT_IO_URING_DEPTH, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstFileSrc:direct:
+   *
+   * Bypass the page cache with O_DIRECT for the read-ahead in io_uring mode.
+   * Only requests with a blocksize that is a multiple of 4096 bytes use
+   * O_DIRECT.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_DIRECT,
+      g_param_spec_boolean ("direct", "Direct I/O",
+          "Bypass the page cache with O_DIRECT in io_uring mode",
+          DEFAULT_DIRECT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstFileSrc:stats:
+   *
+   * Statistics about the io_uring read-ahead in a structure named
+   * "application/x-gst-file-src-stats" with these fields:
+   *
+   * - "requests" G_TYPE_UINT64: the number of completed requests
+   * - "bytes" G_TYPE_UINT64: the number of bytes read
+   * - "pending" G_TYPE_UINT: the number of requests in flight
+   * - "average-latency" G_TYPE_UINT64: the average request latency in ns
+   * - "max-latency" G_TYPE_UINT64: the highest request latency in ns
+   * - "throughput" G_TYPE_DOUBLE: the bytes read per second
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "io_uring statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_file_src_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -179,6 +271,7 @@ gst_file_src_class_init (GstFileSrcClass * klass)
   gstbasesrc_class->stop = GST_DEBUG_FUNCPTR (gst_file_src_stop);
   gstbasesrc_class->is_seekable = GST_DEBUG_FUNCPTR (gst_file_src_is_seekable);
   gstbasesrc_class->get_size = GST_DEBUG_FUNCPTR (gst_file_src_get_size);
+  gstbasesrc_class->create = GST_DEBUG_FUNCPTR (gst_file_src_create);
   gstbasesrc_class->fill = GST_DEBUG_FUNCPTR (gst_file_src_fill);
 
   if (sizeof (off_t) < 8) {
@@ -196,6 +289,11 @@ gst_file_src_init (GstFileSrc * src)
 
   src->is_regular = FALSE;
 
+  src->io_uring = DEFAULT_IO_URING;
+  src->io_uring_depth = DEFAULT_IO_URING_DEPTH;
+  src->direct = DEFAULT_DIRECT;
+  src->direct_fd = -1;
+
   gst_base_src_set_blocksize (GST_BASE_SRC (src), DEFAULT_BLOCKSIZE);
 }
 
@@ -273,6 +371,15 @@ gst_file_src_set_property (GObject * object, guint prop_id,
     case PROP_LOCATION:
       gst_file_src_set_location (src, g_value_get_string (value), NULL);
       break;
+    case PROP_IO_URING:
+      src->io_uring = g_value_get_boolean (value);
+      break;
+    case PROP_IO_URING_DEPTH:
+      src->io_uring_depth = g_value_get_uint (value);
+      break;
+    case PROP_DIRECT:
+      src->direct = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -293,6 +400,21 @@ gst_file_src_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_LOCATION:
       g_value_set_string (value, src->filename);
       break;
+    case PROP_IO_URING:
+      g_value_set_boolean (value, src->io_uring);
+      break;
+    case PROP_IO_URING_DEPTH:
+      g_value_set_uint (value, src->io_uring_depth);
+      break;
+    case PROP_DIRECT:
+      g_value_set_boolean (value, src->direct);
+      break;
+    case PROP_STATS:
+      GST_OBJECT_LOCK (src);
+      g_value_take_boxed (value, gst_file_uring_get_stats (src->uring,
+              "application/x-gst-file-src-stats"));
+      GST_OBJECT_UNLOCK (src);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -398,6 +520,194 @@ buffer_write_fail:
   }
 }
 
+/* discards the read-ahead */
+static void
+gst_file_src_uring_reset (GstFileSrc * src)
+{
+  GST_DEBUG_OBJECT (src, "discarding %u read-ahead requests",
+      gst_file_uring_get_pending (src->uring));
+  gst_file_uring_drain (src->uring);
+}
+
+static gboolean
+gst_file_src_uring_configure (GstFileSrc * src, guint length)
+{
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstAllocationParams params;
+
+  if (src->uring_pool != NULL && src->uring_block_size == length)
+    return TRUE;
+
+  if (src->uring_pool != NULL) {
+    gst_buffer_pool_set_active (src->uring_pool, FALSE);
+    gst_object_unref (src->uring_pool);
+    src->uring_pool = NULL;
+  }
+
+  GST_DEBUG_OBJECT (src, "reading ahead in blocks of %u bytes", length);
+
+  pool = gst_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, NULL, length,
+      src->io_uring_depth, 0);
+  gst_allocation_params_init (&params);
+  if (src->direct_fd >= 0)
+    params.align = GST_FILE_URING_DIRECT_ALIGN - 1;
+  gst_buffer_pool_config_set_allocator (config, NULL, &params);
+
+  if (!gst_buffer_pool_set_config (pool, config)
+      || !gst_buffer_pool_set_active (pool, TRUE)) {
+    gst_object_unref (pool);
+    return FALSE;
+  }
+
+  src->uring_pool = pool;
+  src->uring_block_size = length;
+
+  return TRUE;
+}
+
+/* keep the maximum number of read-ahead requests in flight, up to the end of
+ * the file */
+static GstFlowReturn
+gst_file_src_uring_fill (GstFileSrc * src)
+{
+  GstBuffer *buf;
+  GstFlowReturn ret;
+  gint fd, res;
+
+  while (!gst_file_uring_is_full (src->uring)) {
+    if (src->uring_next_offset >= src->uring_size) {
+      /* the file might have grown */
+      if (!gst_file_src_get_size (GST_BASE_SRC_CAST (src), &src->uring_size)
+          || src->uring_next_offset >= src->uring_size)
+        break;
+    }
+
+    ret = gst_buffer_pool_acquire_buffer (src->uring_pool, &buf, NULL);
+    if (ret != GST_FLOW_OK)
+      return ret;
+
+    fd = src->fd;
+    if (src->direct_fd >= 0
+        && src->uring_next_offset % GST_FILE_URING_DIRECT_ALIGN == 0
+        && src->uring_block_size % GST_FILE_URING_DIRECT_ALIGN == 0)
+      fd = src->direct_fd;
+
+    res = gst_file_uring_push_read (src->uring, fd, src->uring_next_offset,
+        buf);
+    if (res < 0)
+      goto submit_failed;
+
+    src->uring_next_offset += src->uring_block_size;
+  }
+
+  return GST_FLOW_OK;
+
+  /* ERROR */
+submit_failed:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+        ("Could not submit read request: %s", g_strerror (-res)));
+    return GST_FLOW_ERROR;
+  }
+}
+
+static GstFlowReturn
+gst_file_src_create_uring (GstFileSrc * src, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+  GstBuffer *buf;
+  GstFlowReturn ret;
+  guint64 req_offset;
+  gsize req_size;
+  gssize res;
+
+  /* the oldest read-ahead request has to cover this one, otherwise the
+   * reads are not sequential anymore */
+  if (gst_file_uring_peek (src->uring, &req_offset, &req_size)
+      && (req_offset != offset || req_size < length))
+    gst_file_src_uring_reset (src);
+
+  if (gst_file_uring_get_pending (src->uring) == 0) {
+    /* only start reading ahead when continuing where the last read ended,
+     * anything else is read directly */
+    if (offset != src->uring_position || length == 0) {
+      src->uring_position = offset + length;
+      return GST_BASE_SRC_CLASS (parent_class)->create (GST_BASE_SRC_CAST
+          (src), offset, length, buffer);
+    }
+
+    if (!gst_file_src_uring_configure (src, length))
+      goto no_pool;
+    src->uring_next_offset = offset;
+  }
+
+  ret = gst_file_src_uring_fill (src);
+  if (ret != GST_FLOW_OK)
+    return ret;
+
+  if (gst_file_uring_get_pending (src->uring) == 0)
+    goto eos;
+
+  res = gst_file_uring_pop (src->uring, &buf);
+  if (res < 0)
+    goto could_not_read;
+
+  if (res == 0) {
+    gst_buffer_unref (buf);
+    goto eos;
+  }
+
+  if (res > (gssize) length)
+    res = length;
+  gst_buffer_resize (buf, 0, res);
+
+  GST_BUFFER_OFFSET (buf) = offset;
+  GST_BUFFER_OFFSET_END (buf) = offset + res;
+
+  src->uring_position = offset + res;
+  *buffer = buf;
+
+  return GST_FLOW_OK;
+
+  /* ERROR */
+no_pool:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, FAILED, (NULL),
+        ("Could not create a buffer pool for %u byte blocks", length));
+    return GST_FLOW_ERROR;
+  }
+could_not_read:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL), ("%s",
+            g_strerror (-res)));
+    gst_clear_buffer (&buf);
+    return GST_FLOW_ERROR;
+  }
+eos:
+  {
+    GST_DEBUG_OBJECT (src, "EOS");
+    return GST_FLOW_EOS;
+  }
+}
+
+static GstFlowReturn
+gst_file_src_create (GstBaseSrc * basesrc, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+  GstFileSrc *src = GST_FILE_SRC_CAST (basesrc);
+
+  /* buffers provided by downstream are always filled directly */
+  if (src->uring != NULL && *buffer == NULL)
+    return gst_file_src_create_uring (src, offset, length, buffer);
+
+  /* gst_file_src_fill() seeks when the fd is not at the requested offset */
+  return GST_BASE_SRC_CLASS (parent_class)->create (basesrc, offset, length,
+      buffer);
+}
+
 static gboolean
 gst_file_src_is_seekable (GstBaseSrc * basesrc)
 {
@@ -481,6 +791,75 @@ could_not_stat:
   }
 }
 
+static void
+gst_file_src_uring_open (GstFileSrc * src)
+{
+  GstFileUring *uring;
+  GError *err = NULL;
+
+  if (!src->seekable) {
+    GST_ELEMENT_WARNING (src, RESOURCE, SETTINGS, (NULL),
+        ("io_uring mode needs a regular file, using blocking reads"));
+    return;
+  }
+
+  uring = gst_file_uring_new (GST_OBJECT_CAST (src), src->io_uring_depth,
+      &err);
+  if (uring == NULL) {
+    GST_ELEMENT_WARNING (src, RESOURCE, SETTINGS, (NULL),
+        ("%s, using blocking reads", err->message));
+    g_clear_error (&err);
+    return;
+  }
+#ifdef O_DIRECT
+  if (src->direct) {
+    src->direct_fd = g_open (src->filename, O_RDONLY | O_BINARY | O_DIRECT,
+        0);
+    if (src->direct_fd < 0)
+      GST_ELEMENT_WARNING (src, RESOURCE, SETTINGS, (NULL),
+          ("Could not open \"%s\" with O_DIRECT: %s", src->filename,
+              g_strerror (errno)));
+  }
+#else
+  if (src->direct)
+    GST_ELEMENT_WARNING (src, RESOURCE, SETTINGS, (NULL),
+        ("O_DIRECT is not supported on this platform"));
+#endif
+
+  src->uring_block_size = 0;
+  src->uring_position = 0;
+  src->uring_size = 0;
+
+  GST_OBJECT_LOCK (src);
+  src->uring = uring;
+  GST_OBJECT_UNLOCK (src);
+}
+
+static void
+gst_file_src_uring_close (GstFileSrc * src)
+{
+  GstFileUring *uring;
+
+  GST_OBJECT_LOCK (src);
+  uring = src->uring;
+  src->uring = NULL;
+  GST_OBJECT_UNLOCK (src);
+
+  if (uring != NULL)
+    gst_file_uring_free (uring);
+
+  if (src->uring_pool != NULL) {
+    gst_buffer_pool_set_active (src->uring_pool, FALSE);
+    gst_object_unref (src->uring_pool);
+    src->uring_pool = NULL;
+  }
+
+  if (src->direct_fd >= 0) {
+    g_close (src->direct_fd, NULL);
+    src->direct_fd = -1;
+  }
+}
+
 /* open the file, necessary to go to READY state */
 static gboolean
 gst_file_src_start (GstBaseSrc * basesrc)
@@ -569,6 +948,9 @@ gst_file_src_start (GstBaseSrc * basesrc)
 
   gst_base_src_set_dynamic_size (basesrc, src->seekable);
 
+  if (src->io_uring)
+    gst_file_src_uring_open (src);
+
   return TRUE;
 
   /* ERROR */
@@ -632,6 +1014,8 @@ gst_file_src_stop (GstBaseSrc * basesrc)
 {
   GstFileSrc *src = GST_FILE_SRC (basesrc);
 
+  gst_file_src_uring_close (src);
+
   /* close the file */
   g_close (src->fd, NULL);
 
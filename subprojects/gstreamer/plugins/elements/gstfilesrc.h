@@ -29,6 +29,8 @@
 #include <gst/gst.h>
 #include <gst/base/gstbasesrc.h>
 
+#include "gstfileuring.h"
+
 G_BEGIN_DECLS
 
 #define GST_TYPE_FILE_SRC \
@@ -63,6 +65,19 @@ struct _GstFileSrc {
   gboolean seekable;                    /* whether the file is seekable */
   gboolean is_regular;                  /* whether it's a (symlink to a)
                                            regular file */
+
+  /* io_uring read-ahead */
+  gboolean io_uring;
+  guint io_uring_depth;
+  gboolean direct;
+
+  GstFileUring *uring;
+  gint direct_fd;                       /* fd opened with O_DIRECT or -1 */
+  GstBufferPool *uring_pool;
+  guint uring_block_size;               /* size of the read-ahead requests */
+  guint64 uring_next_offset;            /* offset of the next request */
+  guint64 uring_position;               /* end of the last returned data */
+  guint64 uring_size;                   /* last known size of the file */
 };
 
 struct _GstFileSrcClass {
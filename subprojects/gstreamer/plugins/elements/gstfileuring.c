@@ -0,0 +1,592 @@
+/* GStreamer
+ *
+ * gstfileuring.c: io_uring request queue for filesrc and filesink
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* A fixed number of read or write requests, each on a #GstBuffer, that are
+ * kept in flight on an io_uring and are completed in the order they were
+ * pushed. Short writes are resubmitted until all data is written, short
+ * reads are returned as they are. */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <errno.h>
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+#include "gstfileuring.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_file_uring_debug);
+#define GST_CAT_DEFAULT gst_file_uring_debug
+
+typedef struct
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+  gint fd;
+  gboolean write;
+  guint64 offset;
+  gsize size;
+
+  /* bytes transferred so far */
+  gsize done;
+  gboolean completed;
+  gboolean cancelled;
+  gssize result;
+
+  GstClockTime submitted;
+} GstFileUringRequest;
+
+typedef struct
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+} GstFileUringParked;
+
+struct _GstFileUring
+{
+  GstObject *parent;
+
+#ifdef HAVE_LIBURING
+  struct io_uring ring;
+#endif
+
+  /* in submission order, starting at head */
+  GstFileUringRequest *requests;
+  guint depth;
+  guint head;
+
+  /* set when it is not known anymore which requests are still in flight,
+   * their buffers are kept mapped in parked until the ring is torn down */
+  gboolean failed;
+  GSList *parked;
+
+  /* protects the stats and pending */
+  GMutex lock;
+  guint pending;
+  guint64 n_requests;
+  guint64 bytes;
+  GstClockTime total_latency;
+  GstClockTime max_latency;
+  GstClockTime first_submitted;
+  GstClockTime last_completed;
+};
+
+/**
+ * gst_file_uring_new:
+ * @parent: the element used for debugging
+ * @depth: the number of requests that can be in flight
+ * @error: return location for a #GError
+ *
+ * Returns: (nullable): a new #GstFileUring or %NULL if io_uring is not
+ *     available
+ */
+GstFileUring *
+gst_file_uring_new (GstObject * parent, guint depth, GError ** error)
+{
+#ifdef HAVE_LIBURING
+  GstFileUring *uring;
+  gint res;
+
+  g_return_val_if_fail (depth > 0, NULL);
+
+  GST_DEBUG_CATEGORY_INIT (gst_file_uring_debug, "fileuring", 0,
+      "file io_uring");
+
+  uring = g_new0 (GstFileUring, 1);
+
+  res = io_uring_queue_init (depth, &uring->ring, 0);
+  if (res < 0)
+    goto init_failed;
+
+  uring->parent = parent;
+  uring->depth = depth;
+  uring->requests = g_new0 (GstFileUringRequest, depth);
+  uring->first_submitted = GST_CLOCK_TIME_NONE;
+  g_mutex_init (&uring->lock);
+
+  GST_DEBUG_OBJECT (parent, "created io_uring with depth %u", depth);
+
+  return uring;
+
+  /* ERRORS */
+init_failed:
+  {
+    g_set_error (error, GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_FAILED,
+        "Could not create io_uring: %s", g_strerror (-res));
+    g_free (uring);
+    return NULL;
+  }
+#else
+  g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_NOT_IMPLEMENTED,
+      "io_uring support was not compiled in");
+  return NULL;
+#endif
+}
+
+/**
+ * gst_file_uring_free:
+ * @uring: a #GstFileUring
+ *
+ * Waits for all pending requests and frees @uring.
+ */
+void
+gst_file_uring_free (GstFileUring * uring)
+{
+  g_return_if_fail (uring != NULL);
+
+  gst_file_uring_drain (uring);
+
+#ifdef HAVE_LIBURING
+  io_uring_queue_exit (&uring->ring);
+#endif
+
+  /* the kernel is done with these now */
+  while (uring->parked) {
+    GstFileUringParked *parked = uring->parked->data;
+
+    gst_buffer_unmap (parked->buffer, &parked->map);
+    gst_buffer_unref (parked->buffer);
+    g_free (parked);
+    uring->parked = g_slist_delete_link (uring->parked, uring->parked);
+  }
+
+  g_mutex_clear (&uring->lock);
+  g_free (uring->requests);
+  g_free (uring);
+}
+
+guint
+gst_file_uring_get_pending (GstFileUring * uring)
+{
+  return uring->pending;
+}
+
+gboolean
+gst_file_uring_is_full (GstFileUring * uring)
+{
+  return uring->pending == uring->depth;
+}
+
+static gint
+gst_file_uring_submit (GstFileUring * uring, GstFileUringRequest * req)
+{
+#ifdef HAVE_LIBURING
+  struct io_uring_sqe *sqe;
+  guint8 *data;
+  gsize len;
+  gint res;
+
+  sqe = io_uring_get_sqe (&uring->ring);
+  if (sqe == NULL)
+    return -EBUSY;
+
+  data = req->map.data + req->done;
+  len = req->size - req->done;
+
+  if (req->write)
+    io_uring_prep_write (sqe, req->fd, data, len, req->offset + req->done);
+  else
+    io_uring_prep_read (sqe, req->fd, data, len, req->offset + req->done);
+  io_uring_sqe_set_data (sqe, req);
+
+  do {
+    res = io_uring_submit (&uring->ring);
+  } while (res == -EINTR);
+
+  return res < 0 ? res : 0;
+#else
+  return -ENOSYS;
+#endif
+}
+
+static void
+gst_file_uring_complete (GstFileUring * uring, GstFileUringRequest * req,
+    gssize result)
+{
+  GstClockTime now, latency;
+
+  req->result = result;
+  req->completed = TRUE;
+
+  now = gst_util_get_timestamp ();
+  latency = now - req->submitted;
+
+  g_mutex_lock (&uring->lock);
+  uring->n_requests++;
+  if (result > 0)
+    uring->bytes += result;
+  uring->total_latency += latency;
+  uring->max_latency = MAX (uring->max_latency, latency);
+  uring->last_completed = now;
+  g_mutex_unlock (&uring->lock);
+}
+
+/* Waits for the next completion, which is not necessarily the one of the
+ * oldest request */
+static gint
+gst_file_uring_wait_one (GstFileUring * uring)
+{
+#ifdef HAVE_LIBURING
+  struct io_uring_cqe *cqe;
+  GstFileUringRequest *req;
+  gint res;
+
+  do {
+    res = io_uring_wait_cqe (&uring->ring, &cqe);
+  } while (res == -EINTR);
+
+  if (res < 0)
+    return res;
+
+  req = io_uring_cqe_get_data (cqe);
+  res = cqe->res;
+  io_uring_cqe_seen (&uring->ring, cqe);
+
+  /* completion of a cancel request */
+  if (req == NULL)
+    return 0;
+
+  if ((res == -EINTR || res == -EAGAIN) && !req->cancelled)
+    goto resubmit;
+
+  if (res < 0) {
+    GST_DEBUG_OBJECT (uring->parent, "request at offset %" G_GUINT64_FORMAT
+        " failed: %s", req->offset, g_strerror (-res));
+    gst_file_uring_complete (uring, req, res);
+    return 0;
+  }
+
+  req->done += res;
+  if (req->write && res > 0 && req->done < req->size) {
+    GST_LOG_OBJECT (uring->parent, "short write of %d bytes at offset %"
+        G_GUINT64_FORMAT, res, req->offset);
+    goto resubmit;
+  }
+
+  gst_file_uring_complete (uring, req, req->done);
+  return 0;
+
+resubmit:
+  res = gst_file_uring_submit (uring, req);
+  if (res < 0)
+    gst_file_uring_complete (uring, req, res);
+  return 0;
+#else
+  return -ENOSYS;
+#endif
+}
+
+/* Cancels @req after waiting for its completion failed and waits until the
+ * kernel does not use its memory anymore. Returns %FALSE if that could not be
+ * found out. */
+static gboolean
+gst_file_uring_cancel (GstFileUring * uring, GstFileUringRequest * req)
+{
+#ifdef HAVE_LIBURING
+  struct io_uring_sqe *sqe;
+  gint res;
+
+  sqe = io_uring_get_sqe (&uring->ring);
+  if (sqe == NULL)
+    return FALSE;
+
+  io_uring_prep_cancel (sqe, req, 0);
+  io_uring_sqe_set_data (sqe, NULL);
+  req->cancelled = TRUE;
+
+  do {
+    res = io_uring_submit (&uring->ring);
+  } while (res == -EINTR);
+  if (res < 0)
+    return FALSE;
+
+  while (!req->completed) {
+    if (gst_file_uring_wait_one (uring) < 0)
+      return FALSE;
+  }
+
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+static gint
+gst_file_uring_push (GstFileUring * uring, gint fd, guint64 offset,
+    GstBuffer * buffer, gboolean write)
+{
+  GstFileUringRequest *req;
+  gint res;
+
+  g_return_val_if_fail (!gst_file_uring_is_full (uring), -EBUSY);
+
+  if (uring->failed) {
+    gst_buffer_unref (buffer);
+    return -EIO;
+  }
+
+  req = &uring->requests[(uring->head + uring->pending) % uring->depth];
+
+  if (!gst_buffer_map (buffer, &req->map,
+          write ? GST_MAP_READ : GST_MAP_WRITE))
+    goto map_failed;
+
+  req->buffer = buffer;
+  req->fd = fd;
+  req->write = write;
+  req->offset = offset;
+  req->size = req->map.size;
+  req->done = 0;
+  req->completed = FALSE;
+  req->cancelled = FALSE;
+  req->result = 0;
+  req->submitted = gst_util_get_timestamp ();
+
+  res = gst_file_uring_submit (uring, req);
+  if (res < 0)
+    goto submit_failed;
+
+  GST_LOG_OBJECT (uring->parent, "%s %" G_GSIZE_FORMAT " bytes at offset %"
+      G_GUINT64_FORMAT, write ? "write" : "read", req->size, offset);
+
+  g_mutex_lock (&uring->lock);
+  if (!GST_CLOCK_TIME_IS_VALID (uring->first_submitted))
+    uring->first_submitted = req->submitted;
+  uring->pending++;
+  g_mutex_unlock (&uring->lock);
+
+  return 0;
+
+  /* ERRORS */
+map_failed:
+  {
+    GST_WARNING_OBJECT (uring->parent, "could not map buffer");
+    gst_buffer_unref (buffer);
+    return -EINVAL;
+  }
+submit_failed:
+  {
+    GST_WARNING_OBJECT (uring->parent, "could not submit request: %s",
+        g_strerror (-res));
+    gst_buffer_unmap (buffer, &req->map);
+    gst_buffer_unref (buffer);
+    req->buffer = NULL;
+    return res;
+  }
+}
+
+/**
+ * gst_file_uring_push_read:
+ * @uring: a #GstFileUring that is not full
+ * @fd: the file descriptor to read from
+ * @offset: the offset to read at
+ * @buffer: (transfer full): the buffer to read into, its size is the number
+ *     of bytes to read
+ *
+ * Returns: 0 or a negative errno value if the request could not be submitted
+ */
+gint
+gst_file_uring_push_read (GstFileUring * uring, gint fd, guint64 offset,
+    GstBuffer * buffer)
+{
+  return gst_file_uring_push (uring, fd, offset, buffer, FALSE);
+}
+
+/**
+ * gst_file_uring_push_write:
+ * @uring: a #GstFileUring that is not full
+ * @fd: the file descriptor to write to
+ * @offset: the offset to write at
+ * @buffer: (transfer full): the data to write
+ *
+ * Returns: 0 or a negative errno value if the request could not be submitted
+ */
+gint
+gst_file_uring_push_write (GstFileUring * uring, gint fd, guint64 offset,
+    GstBuffer * buffer)
+{
+  return gst_file_uring_push (uring, fd, offset, buffer, TRUE);
+}
+
+/**
+ * gst_file_uring_peek:
+ * @uring: a #GstFileUring
+ * @offset: (out): the offset of the oldest request
+ * @size: (out): the size of the oldest request
+ *
+ * Returns: %FALSE if there are no pending requests
+ */
+gboolean
+gst_file_uring_peek (GstFileUring * uring, guint64 * offset, gsize * size)
+{
+  GstFileUringRequest *req;
+
+  if (uring->pending == 0)
+    return FALSE;
+
+  req = &uring->requests[uring->head];
+  *offset = req->offset;
+  *size = req->size;
+
+  return TRUE;
+}
+
+/**
+ * gst_file_uring_pop:
+ * @uring: a #GstFileUring with pending requests
+ * @buffer: (out) (optional) (transfer full) (nullable): the buffer of the
+ *     request, %NULL if the request could not be cancelled after waiting for
+ *     it failed
+ *
+ * Waits for the oldest request to complete and removes it. If waiting fails
+ * the request is cancelled, and if that fails too the buffer is kept until
+ * @uring is freed as the kernel might still access it.
+ *
+ * Returns: the number of bytes transferred or a negative errno value
+ */
+gssize
+gst_file_uring_pop (GstFileUring * uring, GstBuffer ** buffer)
+{
+  GstFileUringRequest *req;
+  gssize result;
+  gint res;
+
+  g_return_val_if_fail (uring->pending > 0, -EINVAL);
+
+  req = &uring->requests[uring->head];
+
+  while (!req->completed && !uring->failed) {
+    res = gst_file_uring_wait_one (uring);
+    if (res < 0) {
+      GST_ERROR_OBJECT (uring->parent, "waiting for completion failed: %s",
+          g_strerror (-res));
+      if (!gst_file_uring_cancel (uring, req))
+        uring->failed = TRUE;
+      req->result = res;
+      break;
+    }
+  }
+
+  if (!req->completed && uring->failed) {
+    GstFileUringParked *parked;
+
+    /* the request might still be in flight, so keep its memory around
+     * until the ring is torn down */
+    GST_WARNING_OBJECT (uring->parent, "keeping buffer of request at offset %"
+        G_GUINT64_FORMAT " until the ring is freed", req->offset);
+    parked = g_new (GstFileUringParked, 1);
+    parked->buffer = req->buffer;
+    parked->map = req->map;
+    uring->parked = g_slist_prepend (uring->parked, parked);
+    if (req->result >= 0)
+      req->result = -EIO;
+    if (buffer)
+      *buffer = NULL;
+  } else {
+    gst_buffer_unmap (req->buffer, &req->map);
+    if (buffer)
+      *buffer = req->buffer;
+    else
+      gst_buffer_unref (req->buffer);
+  }
+  result = req->result;
+  req->buffer = NULL;
+
+  uring->head = (uring->head + 1) % uring->depth;
+  g_mutex_lock (&uring->lock);
+  uring->pending--;
+  g_mutex_unlock (&uring->lock);
+
+  return result;
+}
+
+/**
+ * gst_file_uring_drain:
+ * @uring: a #GstFileUring
+ *
+ * Waits for all pending requests and discards them.
+ *
+ * Returns: 0 or the first negative errno value of a failed request
+ */
+gssize
+gst_file_uring_drain (GstFileUring * uring)
+{
+  gssize res, ret = 0;
+
+  while (uring->pending > 0) {
+    res = gst_file_uring_pop (uring, NULL);
+    if (res < 0 && ret == 0)
+      ret = res;
+  }
+
+  return ret;
+}
+
+/**
+ * gst_file_uring_get_stats:
+ * @uring: (nullable): a #GstFileUring
+ * @name: the name of the structure
+ *
+ * Gets the statistics of @uring in a structure with these fields:
+ *
+ * - "requests" G_TYPE_UINT64: the number of completed requests
+ * - "bytes" G_TYPE_UINT64: the number of bytes transferred
+ * - "pending" G_TYPE_UINT: the number of requests in flight
+ * - "average-latency" G_TYPE_UINT64: the average time a request took in ns
+ * - "max-latency" G_TYPE_UINT64: the longest time a request took in ns
+ * - "throughput" G_TYPE_DOUBLE: the bytes per second since the first request
+ *
+ * Returns: (transfer full): the statistics, all 0 if @uring is %NULL
+ */
+GstStructure *
+gst_file_uring_get_stats (GstFileUring * uring, const gchar * name)
+{
+  guint64 n_requests = 0, bytes = 0;
+  GstClockTime average = 0, max = 0, elapsed = 0;
+  guint pending = 0;
+  gdouble throughput = 0.0;
+
+  if (uring) {
+    g_mutex_lock (&uring->lock);
+    n_requests = uring->n_requests;
+    bytes = uring->bytes;
+    pending = uring->pending;
+    max = uring->max_latency;
+    if (n_requests > 0) {
+      average = uring->total_latency / n_requests;
+      elapsed = uring->last_completed - uring->first_submitted;
+    }
+    g_mutex_unlock (&uring->lock);
+  }
+
+  if (elapsed > 0)
+    throughput = (gdouble) bytes * GST_SECOND / elapsed;
+
+  return gst_structure_new (name,
+      "requests", G_TYPE_UINT64, n_requests,
+      "bytes", G_TYPE_UINT64, bytes,
+      "pending", G_TYPE_UINT, pending,
+      "average-latency", G_TYPE_UINT64, average,
+      "max-latency", G_TYPE_UINT64, max,
+      "throughput", G_TYPE_DOUBLE, throughput, NULL);
+}
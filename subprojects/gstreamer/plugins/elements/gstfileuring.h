@@ -0,0 +1,71 @@
+/* GStreamer
+ *
+ * gstfileuring.h: io_uring request queue for filesrc and filesink
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_FILE_URING_H__
+#define __GST_FILE_URING_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* Alignment of the offsets, sizes and memory of O_DIRECT requests */
+#define GST_FILE_URING_DIRECT_ALIGN 4096
+
+typedef struct _GstFileUring GstFileUring;
+
+G_GNUC_INTERNAL
+GstFileUring * gst_file_uring_new         (GstObject * parent, guint depth,
+                                           GError ** error);
+
+G_GNUC_INTERNAL
+void           gst_file_uring_free        (GstFileUring * uring);
+
+G_GNUC_INTERNAL
+guint          gst_file_uring_get_pending (GstFileUring * uring);
+
+G_GNUC_INTERNAL
+gboolean       gst_file_uring_is_full     (GstFileUring * uring);
+
+G_GNUC_INTERNAL
+gint           gst_file_uring_push_read   (GstFileUring * uring, gint fd,
+                                           guint64 offset, GstBuffer * buffer);
+
+G_GNUC_INTERNAL
+gint           gst_file_uring_push_write  (GstFileUring * uring, gint fd,
+                                           guint64 offset, GstBuffer * buffer);
+
+G_GNUC_INTERNAL
+gboolean       gst_file_uring_peek        (GstFileUring * uring,
+                                           guint64 * offset, gsize * size);
+
+G_GNUC_INTERNAL
+gssize         gst_file_uring_pop         (GstFileUring * uring,
+                                           GstBuffer ** buffer);
+
+G_GNUC_INTERNAL
+gssize         gst_file_uring_drain       (GstFileUring * uring);
+
+G_GNUC_INTERNAL
+GstStructure * gst_file_uring_get_stats   (GstFileUring * uring,
+                                           const gchar * name);
+
+G_END_DECLS
+
+#endif /* __GST_FILE_URING_H__ */
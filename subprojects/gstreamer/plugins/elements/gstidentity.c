@@ -121,6 +121,8 @@ static gboolean gst_identity_src_event (GstBaseTransform * trans,
     GstEvent * event);
 static GstFlowReturn gst_identity_transform_ip (GstBaseTransform * trans,
     GstBuffer * buf);
+static GstFlowReturn gst_identity_transform_list_ip (GstBaseTransform * trans,
+    GstBufferList * list);
 static gboolean gst_identity_start (GstBaseTransform * trans);
 static gboolean gst_identity_stop (GstBaseTransform * trans);
 static GstStateChangeReturn gst_identity_change_state (GstElement * element,
@@ -318,6 +320,8 @@ gst_identity_class_init (GstIdentityClass * klass)
   gstbasetrans_class->src_event = GST_DEBUG_FUNCPTR (gst_identity_src_event);
   gstbasetrans_class->transform_ip =
       GST_DEBUG_FUNCPTR (gst_identity_transform_ip);
+  gstbasetrans_class->transform_list_ip =
+      GST_DEBUG_FUNCPTR (gst_identity_transform_list_ip);
   gstbasetrans_class->start = GST_DEBUG_FUNCPTR (gst_identity_start);
   gstbasetrans_class->stop = GST_DEBUG_FUNCPTR (gst_identity_stop);
   gstbasetrans_class->accept_caps =
@@ -348,6 +352,8 @@ gst_identity_init (GstIdentity * identity)
   identity->eos_after_counter = DEFAULT_EOS_AFTER;
 
   gst_base_transform_set_gap_aware (GST_BASE_TRANSFORM_CAST (identity), TRUE);
+  gst_base_transform_set_buffer_list_aware (GST_BASE_TRANSFORM_CAST (identity),
+      TRUE);
 
   GST_OBJECT_FLAG_SET (identity, GST_ELEMENT_FLAG_REQUIRE_CLOCK);
 }
@@ -874,6 +880,22 @@ dropped:
   }
 }
 
+static GstFlowReturn
+gst_identity_transform_list_ip (GstBaseTransform * trans, GstBufferList * list)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i, len;
+
+  len = gst_buffer_list_length (list);
+  for (i = 0; i < len; i++) {
+    ret = gst_identity_transform_ip (trans, gst_buffer_list_get (list, i));
+    if (ret != GST_FLOW_OK)
+      break;
+  }
+
+  return ret;
+}
+
 static void
 gst_identity_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -958,6 +980,15 @@ gst_identity_set_property (GObject * object, guint prop_id,
     gst_base_transform_set_passthrough (GST_BASE_TRANSFORM (identity), FALSE);
   else
     gst_base_transform_set_passthrough (GST_BASE_TRANSFORM (identity), TRUE);
+
+  /* dropping buffers pushes gap events, which have to stay in order with the
+   * buffers around them, and errors must come after the preceding buffers.
+   * Waiting on the clock or sleeping would hold back the buffers before the
+   * last one of a list. */
+  gst_base_transform_set_buffer_list_aware (GST_BASE_TRANSFORM (identity),
+      identity->drop_probability == 0.0 && identity->drop_buffer_flags == 0
+      && identity->error_after < 0 && identity->eos_after < 0
+      && !identity->sync && identity->sleep_time == 0);
 }
 
 static GstStructure *
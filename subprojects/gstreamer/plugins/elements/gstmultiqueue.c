@@ -185,6 +185,10 @@ struct _GstSingleQueue
   /* For interleave calculation */
   GThread *thread;              /* Streaming thread of SingleQueue */
   GstClockTime interleave;      /* Calculated interleve within the thread */
+
+  /* Protected by global lock */
+  GstMemoryBudgetClient *budget_client;
+  guint budget_priority;
 };
 
 /* Extension of GstDataQueueItem structure for our usage */
@@ -218,6 +222,11 @@ static void gst_multi_queue_post_buffering (GstMultiQueue * mq);
 static void recheck_buffering_status (GstMultiQueue * mq);
 
 static void gst_single_queue_flush_queue (GstSingleQueue * sq, gboolean full);
+static void gst_single_queue_set_budget (GstMultiQueue * mq,
+    GstSingleQueue * sq, GstMemoryBudget * budget);
+static void gst_single_queue_update_budget (GstSingleQueue * sq);
+static gboolean gst_single_queue_wait_budget (GstMultiQueue * mq,
+    GstSingleQueue * sq);
 
 static void calculate_interleave (GstMultiQueue * mq, GstSingleQueue * sq);
 
@@ -288,6 +297,7 @@ enum
   PROP_UNLINKED_CACHE_TIME,
   PROP_MINIMUM_INTERLEAVE,
   PROP_STATS,
+  PROP_MEMORY_BUDGET,
   PROP_LAST
 };
 
@@ -320,6 +330,7 @@ enum
 /* GstMultiQueuePad */
 
 #define DEFAULT_PAD_GROUP_ID 0
+#define DEFAULT_PAD_MEMORY_BUDGET_PRIORITY 100
 
 enum
 {
@@ -328,6 +339,7 @@ enum
   PROP_CURRENT_LEVEL_BUFFERS,
   PROP_CURRENT_LEVEL_BYTES,
   PROP_CURRENT_LEVEL_TIME,
+  PROP_MEMORY_BUDGET_PRIORITY,
 };
 
 #define GST_TYPE_MULTIQUEUE_PAD            (gst_multiqueue_pad_get_type())
@@ -497,6 +509,10 @@ gst_multiqueue_pad_get_property (GObject * object, guint prop_id,
           gst_multiqueue_pad_get_current_level_time (pad));
       break;
     }
+    case PROP_MEMORY_BUDGET_PRIORITY:
+      g_value_set_uint (value, pad->sq ? pad->sq->budget_priority :
+          DEFAULT_PAD_MEMORY_BUDGET_PRIORITY);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -525,6 +541,25 @@ gst_multiqueue_pad_set_property (GObject * object, guint prop_id,
         }
       }
       break;
+    case PROP_MEMORY_BUDGET_PRIORITY:
+      if (pad->sq) {
+        GstMultiQueue *mqueue = g_weak_ref_get (&pad->sq->mqueue);
+
+        if (mqueue)
+          GST_MULTI_QUEUE_MUTEX_LOCK (mqueue);
+
+        pad->sq->budget_priority = g_value_get_uint (value);
+        if (pad->sq->budget_client) {
+          gst_memory_budget_client_set_priority (pad->sq->budget_client,
+              pad->sq->budget_priority);
+        }
+
+        if (mqueue) {
+          GST_MULTI_QUEUE_MUTEX_UNLOCK (mqueue);
+          gst_object_unref (mqueue);
+        }
+      }
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -598,6 +633,21 @@ gst_multiqueue_pad_class_init (GstMultiQueuePadClass * klass)
       g_param_spec_uint64 ("current-level-time", "Current level time",
           "Current level time", 0, G_MAXUINT64,
           0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiQueuePad:memory-budget-priority:
+   *
+   * The share of the #GstMultiQueue:memory-budget the corresponding queue is
+   * entitled to, relative to the priorities of the other queues using it.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_MEMORY_BUDGET_PRIORITY,
+      g_param_spec_uint ("memory-budget-priority", "Memory Budget Priority",
+          "Relative share of the memory budget", 1, G_MAXUINT,
+          DEFAULT_PAD_MEMORY_BUDGET_PRIORITY,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -637,6 +687,8 @@ static GstStateChangeReturn gst_multi_queue_change_state (GstElement *
     element, GstStateChange transition);
 
 static void gst_multi_queue_loop (GstPad * pad);
+static void gst_multi_queue_set_context (GstElement * element,
+    GstContext * context);
 
 #define _do_init \
   GST_DEBUG_CATEGORY_INIT (multi_queue_debug, "multiqueue", 0, "multiqueue element");
@@ -840,6 +892,26 @@ gst_multi_queue_class_init (GstMultiQueueClass * klass)
           "Multiqueue Statistics",
           GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiQueue:memory-budget:
+   *
+   * A #GstMemoryBudget shared with other elements that limits the bytes
+   * they keep queued together. Each queue is accounted separately, with the
+   * priority set on its pads. When the budget is exhausted, the upstream
+   * streaming thread of a queue holding more than its share is blocked until
+   * memory is released, unless another queue is empty.
+   *
+   * When not set, a budget from a #GstContext of type
+   * #GST_MEMORY_BUDGET_CONTEXT_TYPE set on the pipeline is used.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_MEMORY_BUDGET,
+      g_param_spec_object ("memory-budget", "Memory Budget",
+          "Memory budget shared with other elements", GST_TYPE_MEMORY_BUDGET,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_multi_queue_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -856,6 +928,8 @@ gst_multi_queue_class_init (GstMultiQueueClass * klass)
       GST_DEBUG_FUNCPTR (gst_multi_queue_release_pad);
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_multi_queue_change_state);
+  gstelement_class->set_context =
+      GST_DEBUG_FUNCPTR (gst_multi_queue_set_context);
 
   gst_type_mark_as_plugin_api (GST_TYPE_MULTIQUEUE_PAD, 0);
 }
@@ -892,11 +966,65 @@ gst_multi_queue_init (GstMultiQueue * mqueue)
   g_mutex_init (&mqueue->buffering_post_lock);
 }
 
+/* with MULTI_QUEUE_LOCK */
+static void
+gst_multi_queue_locked_set_budget (GstMultiQueue * mq,
+    GstMemoryBudget * budget)
+{
+  GList *tmp;
+
+  gst_object_replace ((GstObject **) & mq->budget, (GstObject *) budget);
+  for (tmp = mq->queues; tmp; tmp = g_list_next (tmp))
+    gst_single_queue_set_budget (mq, (GstSingleQueue *) tmp->data, budget);
+}
+
+/* with MULTI_QUEUE_LOCK */
+static gboolean
+gst_multi_queue_locked_is_active (GstMultiQueue * mq)
+{
+  gboolean active = FALSE;
+  GList *tmp;
+
+  for (tmp = mq->queues; tmp && !active; tmp = g_list_next (tmp)) {
+    GstSingleQueue *sq = (GstSingleQueue *) tmp->data;
+    GstPad *sinkpad = g_weak_ref_get (&sq->sinkpad);
+
+    if (sinkpad) {
+      active = gst_pad_is_active (sinkpad);
+      gst_object_unref (sinkpad);
+    }
+  }
+
+  return active;
+}
+
+static void
+gst_multi_queue_set_context (GstElement * element, GstContext * context)
+{
+  GstMultiQueue *mq = GST_MULTI_QUEUE (element);
+  GstMemoryBudget *budget;
+
+  if (gst_context_get_memory_budget (context, &budget)) {
+    /* an explicitly configured budget wins, and it can't be changed while
+     * streaming */
+    GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+    if (mq->budget == NULL && !gst_multi_queue_locked_is_active (mq)) {
+      GST_DEBUG_OBJECT (mq, "using %" GST_PTR_FORMAT " from context", budget);
+      gst_multi_queue_locked_set_budget (mq, budget);
+    }
+    GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+    gst_object_unref (budget);
+  }
+
+  GST_ELEMENT_CLASS (parent_class)->set_context (element, context);
+}
+
 static void
 gst_multi_queue_finalize (GObject * object)
 {
   GstMultiQueue *mqueue = GST_MULTI_QUEUE (object);
 
+  gst_multi_queue_locked_set_budget (mqueue, NULL);
   g_list_free_full (mqueue->queues, (GDestroyNotify) gst_single_queue_unref);
   mqueue->queues = NULL;
   mqueue->queues_cookie++;
@@ -1031,6 +1159,11 @@ gst_multi_queue_set_property (GObject * object, guint prop_id,
         calculate_interleave (mq, NULL);
       GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
       break;
+    case PROP_MEMORY_BUDGET:
+      GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+      gst_multi_queue_locked_set_budget (mq, g_value_get_object (value));
+      GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1134,6 +1267,9 @@ gst_multi_queue_get_property (GObject * object, guint prop_id,
     case PROP_STATS:
       g_value_take_boxed (value, gst_multi_queue_get_stats (mq));
       break;
+    case PROP_MEMORY_BUDGET:
+      g_value_set_object (value, mq->budget);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1262,6 +1398,12 @@ gst_multi_queue_release_pad (GstElement * element, GstPad * pad)
 
   gst_pad_set_active (srcpad, FALSE);
   gst_pad_set_active (sinkpad, FALSE);
+
+  /* nothing can wait on the memory budget anymore */
+  GST_MULTI_QUEUE_MUTEX_LOCK (mqueue);
+  gst_single_queue_set_budget (mqueue, sq, NULL);
+  GST_MULTI_QUEUE_MUTEX_UNLOCK (mqueue);
+
   gst_element_remove_pad (element, srcpad);
   gst_element_remove_pad (element, sinkpad);
   gst_object_unref (srcpad);
@@ -1386,6 +1528,8 @@ gst_single_queue_flush (GstMultiQueue * mq, GstSingleQueue * sq, gboolean flush,
     GST_MULTI_QUEUE_MUTEX_LOCK (mq);
     sq->srcresult = GST_FLOW_FLUSHING;
     gst_data_queue_set_flushing (sq->queue, TRUE);
+    if (sq->budget_client)
+      gst_memory_budget_client_set_flushing (sq->budget_client, TRUE);
 
     sq->flushing = TRUE;
 
@@ -1419,6 +1563,8 @@ gst_single_queue_flush (GstMultiQueue * mq, GstSingleQueue * sq, gboolean flush,
     sq->cached_sinktime = GST_CLOCK_STIME_NONE;
     sq->group_high_time = GST_CLOCK_STIME_NONE;
     gst_data_queue_set_flushing (sq->queue, FALSE);
+    if (sq->budget_client)
+      gst_memory_budget_client_set_flushing (sq->budget_client, FALSE);
 
     /* We will become active again on the next buffer/gap */
     sq->active = FALSE;
@@ -2200,6 +2346,12 @@ next:
 
   is_query = item->is_query;
 
+  if (sq->budget_client) {
+    GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+    gst_single_queue_update_budget (sq);
+    GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+  }
+
   /* steal the object and destroy the item */
   object = gst_multi_queue_item_steal_object (item);
   gst_multi_queue_item_destroy (item);
@@ -2540,6 +2692,9 @@ gst_multi_queue_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
     GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
   }
 
+  if (sq->budget_client && !gst_single_queue_wait_budget (mq, sq))
+    goto flushing;
+
   if (!(gst_data_queue_push (sq->queue, (GstDataQueueItem *) item)))
     goto flushing;
 
@@ -2547,6 +2702,12 @@ gst_multi_queue_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
    * that we never end up filling the queue first. */
   apply_buffer (mq, sq, timestamp, duration, &sq->sink_segment);
 
+  if (sq->budget_client) {
+    GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+    gst_single_queue_update_budget (sq);
+    GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+  }
+
 done:
   gst_clear_object (&mq);
   return sq->srcresult;
@@ -2592,11 +2753,15 @@ gst_multi_queue_sink_activate_mode (GstPad * pad, GstObject * parent,
         sq->srcresult = GST_FLOW_OK;
         sq->pushed = FALSE;
         gst_data_queue_set_flushing (sq->queue, FALSE);
+        if (sq->budget_client)
+          gst_memory_budget_client_set_flushing (sq->budget_client, FALSE);
       } else {
         sq->srcresult = GST_FLOW_FLUSHING;
         sq->last_query = FALSE;
         g_cond_signal (&sq->query_handled);
         gst_data_queue_set_flushing (sq->queue, TRUE);
+        if (sq->budget_client)
+          gst_memory_budget_client_set_flushing (sq->budget_client, TRUE);
 
         /* Wait until streaming thread has finished */
         if (mq)
@@ -2605,6 +2770,7 @@ gst_multi_queue_sink_activate_mode (GstPad * pad, GstObject * parent,
         if (mq)
           GST_MULTI_QUEUE_MUTEX_LOCK (mq);
         gst_data_queue_flush (sq->queue);
+        gst_single_queue_update_budget (sq);
         if (mq)
           GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
         GST_PAD_STREAM_UNLOCK (pad);
@@ -3454,12 +3620,81 @@ gst_single_queue_flush_queue (GstSingleQueue * sq, gboolean full)
   if (mq) {
     GST_MULTI_QUEUE_MUTEX_LOCK (mq);
     update_buffering (mq, sq);
+    gst_single_queue_update_budget (sq);
     GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
     gst_multi_queue_post_buffering (mq);
     gst_object_unref (mq);
   }
 }
 
+/* (re)register @sq with @budget, with MULTI_QUEUE_LOCK */
+static void
+gst_single_queue_set_budget (GstMultiQueue * mq, GstSingleQueue * sq,
+    GstMemoryBudget * budget)
+{
+  if (sq->budget_client) {
+    gst_memory_budget_client_free (sq->budget_client);
+    sq->budget_client = NULL;
+  }
+
+  if (budget) {
+    sq->budget_client = gst_memory_budget_client_new (budget,
+        GST_OBJECT_CAST (mq), sq->budget_priority);
+    gst_memory_budget_client_set_flushing (sq->budget_client,
+        sq->srcresult != GST_FLOW_OK);
+    gst_single_queue_update_budget (sq);
+  }
+}
+
+/* with MULTI_QUEUE_LOCK, reading the level with the lock held makes sure the
+ * last update wins when the sink and source threads race */
+static void
+gst_single_queue_update_budget (GstSingleQueue * sq)
+{
+  GstDataQueueSize level;
+
+  if (sq->budget_client == NULL)
+    return;
+
+  gst_data_queue_get_level (sq->queue, &level);
+  gst_memory_budget_client_set_used (sq->budget_client, level.bytes);
+}
+
+/* Blocks the sinkpad streaming thread of @sq while it holds more than its
+ * share of an exhausted memory budget. Like in single_queue_overrun_cb(), we
+ * don't wait when another queue is empty as that queue might need data from
+ * the same upstream thread. */
+static gboolean
+gst_single_queue_wait_budget (GstMultiQueue * mq, GstSingleQueue * sq)
+{
+  GList *tmp;
+  gboolean empty_found = FALSE;
+
+  if (!gst_memory_budget_client_is_exhausted (sq->budget_client))
+    return TRUE;
+
+  GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+  for (tmp = mq->queues; tmp; tmp = g_list_next (tmp)) {
+    GstSingleQueue *oq = (GstSingleQueue *) tmp->data;
+
+    if (oq == sq || oq->srcresult == GST_FLOW_NOT_LINKED)
+      continue;
+
+    if (gst_data_queue_is_empty (oq->queue) && !oq->is_sparse) {
+      GST_LOG_ID (oq->debug_id, "Queue is empty, not waiting on budget");
+      empty_found = TRUE;
+      break;
+    }
+  }
+  GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+
+  if (empty_found)
+    return TRUE;
+
+  GST_DEBUG_ID (sq->debug_id, "waiting for memory budget");
+  return gst_memory_budget_client_wait (sq->budget_client);
+}
+
 static void
 gst_single_queue_unref (GstSingleQueue * sq)
 {
@@ -3529,6 +3764,7 @@ gst_single_queue_new (GstMultiQueue * mqueue, guint id)
 #endif
   sq->groupid = DEFAULT_PAD_GROUP_ID;
   sq->group_high_time = GST_CLOCK_STIME_NONE;
+  sq->budget_priority = DEFAULT_PAD_MEMORY_BUDGET_PRIORITY;
 
   mqueue->queues = g_list_insert_before (mqueue->queues, tmp, sq);
   mqueue->queues_cookie++;
@@ -3558,6 +3794,8 @@ gst_single_queue_new (GstMultiQueue * mqueue, guint id)
   sq->active = FALSE;
   gst_segment_init (&sq->sink_segment, GST_FORMAT_TIME);
   gst_segment_init (&sq->src_segment, GST_FORMAT_TIME);
+  if (mqueue->budget)
+    gst_single_queue_set_budget (mqueue, sq, mqueue->budget);
 
   sq->nextid = 0;
   sq->oldid = 0;
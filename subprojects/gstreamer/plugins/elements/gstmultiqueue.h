@@ -90,6 +90,8 @@ struct _GstMultiQueue {
   gboolean interleave_incomplete; /* TRUE if not all streams were active */
 
   GstClockTime unlinked_cache_time;
+
+  GstMemoryBudget *budget;	/* protected by qlock */
 };
 
 struct _GstMultiQueueClass {
@@ -65,6 +65,10 @@
 #include <glib/gi18n-lib.h>
 #include "../../gst/glib-compat-private.h"
 
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>             /* _mm_pause */
+#endif
+
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -126,6 +130,9 @@ enum
   PROP_SILENT,
   PROP_FLUSH_ON_EOS,
   PROP_NOTIFY_LEVELS,
+  PROP_LOCK_FREE,
+  PROP_MEMORY_BUDGET,
+  PROP_MEMORY_BUDGET_PRIORITY,
   PROP_LAST
 };
 
@@ -135,6 +142,33 @@ GParamSpec *properties[PROP_LAST];
 #define DEFAULT_MAX_SIZE_BUFFERS  200   /* 200 buffers */
 #define DEFAULT_MAX_SIZE_BYTES    (10 * 1024 * 1024)    /* 10 MB       */
 #define DEFAULT_MAX_SIZE_TIME     GST_SECOND    /* 1 second    */
+#define DEFAULT_LOCK_FREE         FALSE
+#define DEFAULT_MEMORY_BUDGET_PRIORITY 100
+
+/* size of the lock-free ring when there is no max-size-buffers */
+#define DEFAULT_RING_SIZE         256
+#define RING_SIZE_MIN             16
+#define RING_SIZE_MAX             4096
+
+/* bounds for the number of times the srcpad streaming thread polls the ring
+ * before it goes to sleep, and for how long in microseconds. It yields the
+ * CPU to other threads every RING_SPIN_YIELD polls. */
+#define RING_SPIN_MIN             64
+#define RING_SPIN_MAX             4096
+#define RING_SPIN_MAX_TIME        50
+#define RING_SPIN_YIELD           64
+
+/* tells the CPU that this is a busy wait, which saves power and lets the
+ * other hardware thread of the core run */
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define RING_SPIN_PAUSE() __builtin_ia32_pause ()
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define RING_SPIN_PAUSE() __asm__ __volatile__ ("yield")
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define RING_SPIN_PAUSE() _mm_pause ()
+#else
+#define RING_SPIN_PAUSE() G_STMT_START { } G_STMT_END
+#endif
 
 #define GST_QUEUE_MUTEX_LOCK(q) G_STMT_START {                          \
   g_mutex_lock (&q->qlock);                                              \
@@ -159,7 +193,9 @@ GParamSpec *properties[PROP_LAST];
 #define GST_QUEUE_WAIT_DEL_CHECK(q, label) G_STMT_START {               \
   STATUS (q, q->sinkpad, "wait for DEL");                               \
   q->waiting_del = TRUE;                                                \
+  gst_task_pool_blocking_begin ();                                      \
   g_cond_wait (&q->item_del, &q->qlock);                                  \
+  gst_task_pool_blocking_end ();                                        \
   q->waiting_del = FALSE;                                               \
   if (q->srcresult != GST_FLOW_OK) {                                    \
     STATUS (q, q->srcpad, "received DEL wakeup");                       \
@@ -168,11 +204,17 @@ GParamSpec *properties[PROP_LAST];
   STATUS (q, q->sinkpad, "received DEL");                               \
 } G_STMT_END
 
+/* the ring is checked after setting waiting_add, the sinkpad streaming
+ * thread checks waiting_add after adding to the ring */
 #define GST_QUEUE_WAIT_ADD_CHECK(q, label) G_STMT_START {               \
   STATUS (q, q->srcpad, "wait for ADD");                                \
-  q->waiting_add = TRUE;                                                \
-  g_cond_wait (&q->item_add, &q->qlock);                                  \
-  q->waiting_add = FALSE;                                               \
+  g_atomic_int_set (&q->waiting_add, TRUE);                             \
+  if (!gst_queue_ring_ready (q)) {                                      \
+    gst_task_pool_blocking_begin ();                                    \
+    g_cond_wait (&q->item_add, &q->qlock);                                \
+    gst_task_pool_blocking_end ();                                      \
+  }                                                                     \
+  g_atomic_int_set (&q->waiting_add, FALSE);                            \
   if (q->srcresult != GST_FLOW_OK) {                                    \
     STATUS (q, q->srcpad, "received ADD wakeup");                       \
     goto label;                                                         \
@@ -232,8 +274,12 @@ static gboolean gst_queue_src_activate_mode (GstPad * pad, GstObject * parent,
 static gboolean gst_queue_sink_activate_mode (GstPad * pad, GstObject * parent,
     GstPadMode mode, gboolean active);
 
+static void gst_queue_set_context (GstElement * element, GstContext * context);
+
 static gboolean gst_queue_is_empty (GstQueue * queue);
 static gboolean gst_queue_is_filled (GstQueue * queue);
+static gboolean gst_queue_ring_ready (GstQueue * queue);
+static GstBuffer *gst_queue_locked_ring_pop (GstQueue * queue);
 
 
 typedef struct
@@ -428,9 +474,71 @@ gst_queue_class_init (GstQueueClass * klass)
       "Whether to emit `notify` signals on levels changes or not", FALSE,
       G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GstQueue:lock-free
+   *
+   * Let the upstream streaming thread add buffers to a lock-free ring while
+   * nothing else is queued, and let the source pad streaming thread busy wait
+   * for a short time before going to sleep when the queue runs empty. This
+   * lowers the per-buffer latency and the cost of the thread hand-over for
+   * streams of many small buffers, at the price of some CPU time spent
+   * polling.
+   *
+   * Events, queries and buffer lists, and buffers received while any of those
+   * are queued, are queued the usual way. The fast path is only used when the
+   * queue is not #GstQueue:leaky, has no minimum thresholds and
+   * #GstQueue:notify-levels is disabled. Buffers in the ring are not counted
+   * in #GstQueue:current-level-time, so #GstQueue:max-size-time is only
+   * enforced for buffers queued the usual way.
+   *
+   * Changes take effect the next time the queue goes from READY to PAUSED.
+   *
+   * Default: %FALSE
+   *
+   * Since: 1.30
+   */
+  properties[PROP_LOCK_FREE] =
+      g_param_spec_boolean ("lock-free", "Lock-free",
+      "Pass buffers through a lock-free ring when possible", DEFAULT_LOCK_FREE,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GstQueue:memory-budget
+   *
+   * A #GstMemoryBudget shared with other elements that limits the bytes
+   * they keep queued together. When the budget is exhausted and this queue
+   * holds more than its share, the upstream streaming thread is blocked
+   * until memory is released.
+   *
+   * When not set, a budget from a #GstContext of type
+   * #GST_MEMORY_BUDGET_CONTEXT_TYPE set on the pipeline is used.
+   *
+   * Since: 1.30
+   */
+  properties[PROP_MEMORY_BUDGET] =
+      g_param_spec_object ("memory-budget", "Memory Budget",
+      "Memory budget shared with other elements", GST_TYPE_MEMORY_BUDGET,
+      G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GstQueue:memory-budget-priority
+   *
+   * The share of the #GstQueue:memory-budget this queue is entitled to,
+   * relative to the priorities of the other elements using it.
+   *
+   * Since: 1.30
+   */
+  properties[PROP_MEMORY_BUDGET_PRIORITY] =
+      g_param_spec_uint ("memory-budget-priority", "Memory Budget Priority",
+      "Relative share of the memory budget", 1, G_MAXUINT,
+      DEFAULT_MEMORY_BUDGET_PRIORITY,
+      G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (gobject_class, PROP_LAST, properties);
   gobject_class->finalize = gst_queue_finalize;
 
+  gstelement_class->set_context = GST_DEBUG_FUNCPTR (gst_queue_set_context);
+
   gst_element_class_set_static_metadata (gstelement_class,
       "Queue",
       "Generic", "Simple data queue", "Erik Walthinsen <omega@cse.ogi.edu>");
@@ -484,6 +592,8 @@ gst_queue_init (GstQueue * queue)
 
   queue->leaky = GST_QUEUE_NO_LEAK;
   queue->srcresult = GST_FLOW_FLUSHING;
+  queue->lock_free = DEFAULT_LOCK_FREE;
+  queue->budget_priority = DEFAULT_MEMORY_BUDGET_PRIORITY;
 
   g_mutex_init (&queue->qlock);
   g_cond_init (&queue->item_add);
@@ -513,9 +623,18 @@ gst_queue_finalize (GObject * object)
 {
   GstQueue *queue = GST_QUEUE (object);
   GstQueueItem *qitem;
+  GstBuffer *buffer;
 
   GST_DEBUG_OBJECT (queue, "finalizing queue");
 
+  while ((buffer = gst_queue_locked_ring_pop (queue)))
+    gst_buffer_unref (buffer);
+  g_free (queue->ring);
+
+  if (queue->budget_client)
+    gst_memory_budget_client_free (queue->budget_client);
+  gst_clear_object (&queue->budget);
+
   while ((qitem = gst_vec_deque_pop_head_struct (queue->queue))) {
     /* FIXME: if it's a query, shouldn't we unref that too? */
     if (!qitem->is_query)
@@ -787,10 +906,269 @@ gst_queue_notify_levels (GstQueue * queue, GstQueueSize * prev_level,
         properties[PROP_CUR_LEVEL_TIME]);
 }
 
+/* number of buffers in the ring. Only the sinkpad streaming thread makes it
+ * grow and only a thread holding the lock makes it shrink. */
+static inline guint
+gst_queue_ring_length (GstQueue * queue)
+{
+  guint head, tail;
+
+  /* read the head first so that it can't get past the tail we read */
+  head = g_atomic_int_get (&queue->ring_head);
+  tail = g_atomic_int_get (&queue->ring_tail);
+
+  return tail - head;
+}
+
+/* TRUE when the ring has buffers that can be pushed before anything else */
+static gboolean
+gst_queue_ring_ready (GstQueue * queue)
+{
+  return gst_vec_deque_is_empty (queue->queue) &&
+      gst_queue_ring_length (queue) > 0;
+}
+
+/* called from the sinkpad streaming thread without the lock. Returns FALSE
+ * when the buffer has to be queued the usual way. */
+static gboolean
+gst_queue_ring_push (GstQueue * queue, GstBuffer * buffer)
+{
+  guint head, tail, len;
+  gsize size;
+
+  /* these are read without the lock, anything that is missed here is handled
+   * by the locked path for the next buffer or when draining the ring */
+  if (queue->srcresult != GST_FLOW_OK || queue->eos || queue->unexpected
+      || queue->tail_needs_discont || queue->leaky != GST_QUEUE_NO_LEAK
+      || queue->notify_levels || queue->budget_client != NULL
+      || queue->min_threshold.buffers > 0
+      || queue->min_threshold.bytes > 0 || queue->min_threshold.time > 0)
+    return FALSE;
+
+  /* buffers can't overtake items that are queued the usual way */
+  if (g_atomic_int_get (&queue->queue_used))
+    return FALSE;
+
+  head = g_atomic_int_get (&queue->ring_head);
+  tail = queue->ring_tail;
+  len = tail - head;
+  size = gst_buffer_get_size (buffer);
+
+  if (len > queue->ring_mask)
+    return FALSE;
+  if (queue->max_size.buffers > 0 && len >= queue->max_size.buffers)
+    return FALSE;
+  if (size > (gsize) (G_MAXINT - g_atomic_int_get (&queue->ring_bytes)))
+    return FALSE;
+  if (queue->max_size.bytes > 0 &&
+      (guint) g_atomic_int_get (&queue->ring_bytes) >= queue->max_size.bytes)
+    return FALSE;
+
+  GST_CAT_LOG_OBJECT (queue_dataflow, queue, "adding %" GST_PTR_FORMAT
+      " to ring", buffer);
+
+  queue->ring[tail & queue->ring_mask] = buffer;
+  g_atomic_int_add (&queue->ring_bytes, (gint) size);
+  g_atomic_int_set (&queue->ring_tail, tail + 1);
+
+  /* pairs with GST_QUEUE_WAIT_ADD_CHECK */
+  if (g_atomic_int_get (&queue->waiting_add)) {
+    GST_QUEUE_MUTEX_LOCK (queue);
+    GST_QUEUE_SIGNAL_ADD (queue);
+    GST_QUEUE_MUTEX_UNLOCK (queue);
+  }
+
+  return TRUE;
+}
+
+/* take the oldest buffer from the ring, with QUEUE_LOCK. Holding the lock
+ * keeps this side of the ring single threaded. */
+static GstBuffer *
+gst_queue_locked_ring_pop (GstQueue * queue)
+{
+  GstBuffer *buffer;
+  guint head;
+
+  if (queue->ring == NULL)
+    return NULL;
+
+  head = queue->ring_head;
+  if (head == (guint) g_atomic_int_get (&queue->ring_tail))
+    return NULL;
+
+  buffer = queue->ring[head & queue->ring_mask];
+
+  /* the buffer was added without the lock, update the sink side for it now
+   * unless that was done already */
+  if ((gint) (head - queue->ring_synced) >= 0) {
+    apply_buffer (queue, buffer, &queue->sink_segment, TRUE);
+    queue->ring_synced = head + 1;
+  }
+
+  g_atomic_int_add (&queue->ring_bytes, -(gint) gst_buffer_get_size (buffer));
+  g_atomic_int_set (&queue->ring_head, head + 1);
+
+  return buffer;
+}
+
+/* called with QUEUE_LOCK from the sinkpad streaming thread before it queues an
+ * item the usual way. Updates the sink side for the buffers in the ring and
+ * keeps new buffers out of the ring until everything queued is pushed, so
+ * that the order is kept. */
+static void
+gst_queue_locked_ring_stop (GstQueue * queue)
+{
+  guint i, tail;
+
+  if (queue->ring == NULL)
+    return;
+
+  g_atomic_int_set (&queue->queue_used, TRUE);
+
+  i = queue->ring_head;
+  if ((gint) (queue->ring_synced - i) > 0)
+    i = queue->ring_synced;
+  tail = queue->ring_tail;
+
+  for (; i != tail; i++) {
+    apply_buffer (queue, queue->ring[i & queue->ring_mask],
+        &queue->sink_segment, TRUE);
+  }
+  queue->ring_synced = tail;
+}
+
+/* called with QUEUE_LOCK by the srcpad streaming thread when there is nothing
+ * to push. Polls for new data for a while before the thread goes to sleep, for
+ * longer when that was worth it before. Returns TRUE when there might be new
+ * data. */
+static gboolean
+gst_queue_locked_ring_spin (GstQueue * queue)
+{
+  guint i, spin = queue->ring_spin;
+  gint64 deadline;
+  gboolean res = FALSE;
+
+  if (queue->ring == NULL || spin == 0
+      || !gst_vec_deque_is_empty (queue->queue))
+    return FALSE;
+
+  GST_QUEUE_MUTEX_UNLOCK (queue);
+  deadline = g_get_monotonic_time () + RING_SPIN_MAX_TIME;
+  for (i = 1; i <= spin; i++) {
+    if (gst_queue_ring_length (queue) > 0
+        || g_atomic_int_get (&queue->queue_used)) {
+      res = TRUE;
+      break;
+    }
+
+    if (i % RING_SPIN_YIELD == 0) {
+      if (g_get_monotonic_time () >= deadline)
+        break;
+      g_thread_yield ();
+    } else {
+      RING_SPIN_PAUSE ();
+    }
+  }
+  GST_QUEUE_MUTEX_LOCK (queue);
+
+  if (res)
+    queue->ring_spin = MIN (spin * 2, RING_SPIN_MAX);
+  else
+    queue->ring_spin = MAX (spin / 2, RING_SPIN_MIN);
+
+  return res;
+}
+
+/* (re)create the ring, with QUEUE_LOCK while the sinkpad is not streaming */
+static void
+gst_queue_locked_ring_setup (GstQueue * queue)
+{
+  GstBuffer *buffer;
+  guint size = 0;
+
+  if (queue->lock_free) {
+    if (queue->max_size.buffers > 0) {
+      size = RING_SIZE_MIN;
+      while (size < queue->max_size.buffers && size < RING_SIZE_MAX)
+        size <<= 1;
+    } else {
+      size = DEFAULT_RING_SIZE;
+    }
+  }
+
+  while ((buffer = gst_queue_locked_ring_pop (queue)))
+    gst_buffer_unref (buffer);
+
+  if (queue->ring == NULL ? size == 0 : size == queue->ring_mask + 1)
+    return;
+
+  GST_DEBUG_OBJECT (queue, "using a ring of %u buffers", size);
+
+  g_free (queue->ring);
+  queue->ring = size > 0 ? g_new0 (GstBuffer *, size) : NULL;
+  queue->ring_mask = size > 0 ? size - 1 : 0;
+  g_atomic_int_set (&queue->ring_head, 0);
+  g_atomic_int_set (&queue->ring_tail, 0);
+  g_atomic_int_set (&queue->ring_bytes, 0);
+  queue->ring_synced = 0;
+  queue->ring_spin =
+      size > 0 && g_get_num_processors () > 1 ? RING_SPIN_MIN : 0;
+}
+
+/* (re)register with @budget, with QUEUE_LOCK */
+static void
+gst_queue_locked_set_budget (GstQueue * queue, GstMemoryBudget * budget)
+{
+  if (queue->budget_client) {
+    gst_memory_budget_client_free (queue->budget_client);
+    queue->budget_client = NULL;
+  }
+  gst_object_replace ((GstObject **) & queue->budget, (GstObject *) budget);
+
+  if (budget) {
+    queue->budget_client = gst_memory_budget_client_new (budget,
+        GST_OBJECT_CAST (queue), queue->budget_priority);
+    gst_memory_budget_client_set_flushing (queue->budget_client,
+        queue->srcresult != GST_FLOW_OK);
+    gst_memory_budget_client_set_used (queue->budget_client,
+        queue->cur_level.bytes);
+  }
+}
+
+/* with QUEUE_LOCK */
+static inline void
+gst_queue_locked_update_budget (GstQueue * queue)
+{
+  if (queue->budget_client)
+    gst_memory_budget_client_set_used (queue->budget_client,
+        queue->cur_level.bytes);
+}
+
+static inline void
+gst_queue_budget_set_flushing (GstQueue * queue, gboolean flushing)
+{
+  if (queue->budget_client)
+    gst_memory_budget_client_set_flushing (queue->budget_client, flushing);
+}
+
+/* block the sinkpad streaming thread while this queue uses more than its share
+ * of an exhausted memory budget, without QUEUE_LOCK. Flushing is handled when
+ * the buffer is queued. */
+static inline void
+gst_queue_wait_budget (GstQueue * queue)
+{
+  if (queue->budget_client)
+    gst_memory_budget_client_wait (queue->budget_client);
+}
+
 static void
 gst_queue_locked_flush (GstQueue * queue, gboolean full)
 {
   GstQueueItem *qitem;
+  GstBuffer *buffer;
+
+  while ((buffer = gst_queue_locked_ring_pop (queue)))
+    gst_buffer_unref (buffer);
 
   while ((qitem = gst_vec_deque_pop_head_struct (queue->queue))) {
     /* Then lose another reference because we are supposed to destroy that
@@ -805,9 +1183,11 @@ gst_queue_locked_flush (GstQueue * queue, gboolean full)
       gst_mini_object_unref (qitem->item);
     memset (qitem, 0, sizeof (GstQueueItem));
   }
+  g_atomic_int_set (&queue->queue_used, FALSE);
   queue->last_query = FALSE;
   g_cond_signal (&queue->query_handled);
   GST_QUEUE_CLEAR_LEVEL (queue->cur_level);
+  gst_queue_locked_update_budget (queue);
   queue->min_threshold.buffers = queue->orig_min_threshold.buffers;
   queue->min_threshold.bytes = queue->orig_min_threshold.bytes;
   queue->min_threshold.time = queue->orig_min_threshold.time;
@@ -831,9 +1211,12 @@ gst_queue_locked_enqueue_buffer (GstQueue * queue, gpointer item)
   GstBuffer *buffer = GST_BUFFER_CAST (item);
   gsize bsize = gst_buffer_get_size (buffer);
 
+  gst_queue_locked_ring_stop (queue);
+
   /* add buffer to the statistics */
   queue->cur_level.buffers++;
   queue->cur_level.bytes += bsize;
+  gst_queue_locked_update_budget (queue);
   apply_buffer (queue, buffer, &queue->sink_segment, TRUE);
 
   qitem.item = item;
@@ -852,9 +1235,12 @@ gst_queue_locked_enqueue_buffer_list (GstQueue * queue, gpointer item)
 
   bsize = gst_buffer_list_calculate_size (buffer_list);
 
+  gst_queue_locked_ring_stop (queue);
+
   /* add buffer to the statistics */
   queue->cur_level.buffers += gst_buffer_list_length (buffer_list);
   queue->cur_level.bytes += bsize;
+  gst_queue_locked_update_budget (queue);
   apply_buffer_list (queue, buffer_list, &queue->sink_segment, TRUE);
 
   qitem.item = item;
@@ -870,6 +1256,8 @@ gst_queue_locked_enqueue_event (GstQueue * queue, gpointer item)
   GstQueueItem qitem;
   GstEvent *event = GST_EVENT_CAST (item);
 
+  gst_queue_locked_ring_stop (queue);
+
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_EOS:
       GST_CAT_LOG_OBJECT (queue_dataflow, queue, "got EOS from upstream");
@@ -885,7 +1273,8 @@ gst_queue_locked_enqueue_event (GstQueue * queue, gpointer item)
     case GST_EVENT_SEGMENT:
       apply_segment (queue, event, &queue->sink_segment, TRUE);
       /* if the queue is empty, apply sink segment on the source */
-      if (gst_vec_deque_is_empty (queue->queue)) {
+      if (gst_vec_deque_is_empty (queue->queue)
+          && gst_queue_ring_length (queue) == 0) {
         GST_CAT_LOG_OBJECT (queue_dataflow, queue, "Apply segment on srcpad");
         apply_segment (queue, event, &queue->src_segment, FALSE);
         queue->newseg_applied_to_src = TRUE;
@@ -914,8 +1303,26 @@ gst_queue_locked_dequeue (GstQueue * queue)
 {
   GstQueueItem *qitem;
   GstMiniObject *item;
+  GstBuffer *ring_buffer;
   gsize bufsize;
 
+  /* buffers in the ring are older than everything else */
+  ring_buffer = gst_queue_locked_ring_pop (queue);
+  if (ring_buffer != NULL) {
+    GST_CAT_LOG_OBJECT (queue_dataflow, queue,
+        "retrieved %" GST_PTR_FORMAT " from ring", ring_buffer);
+
+    apply_buffer (queue, ring_buffer, &queue->src_segment, FALSE);
+
+    /* if the queue is empty now, update the other side */
+    if (queue->cur_level.buffers == 0)
+      queue->cur_level.time = 0;
+
+    GST_QUEUE_SIGNAL_DEL (queue);
+
+    return GST_MINI_OBJECT_CAST (ring_buffer);
+  }
+
   qitem = gst_vec_deque_pop_head_struct (queue->queue);
   if (qitem == NULL)
     goto no_item;
@@ -923,6 +1330,10 @@ gst_queue_locked_dequeue (GstQueue * queue)
   item = qitem->item;
   bufsize = qitem->size;
 
+  /* let buffers use the ring again */
+  if (gst_vec_deque_is_empty (queue->queue))
+    g_atomic_int_set (&queue->queue_used, FALSE);
+
   if (GST_IS_BUFFER (item)) {
     GstBuffer *buffer = GST_BUFFER_CAST (item);
 
@@ -931,6 +1342,7 @@ gst_queue_locked_dequeue (GstQueue * queue)
 
     queue->cur_level.buffers--;
     queue->cur_level.bytes -= bufsize;
+    gst_queue_locked_update_budget (queue);
     apply_buffer (queue, buffer, &queue->src_segment, FALSE);
 
     /* if the queue is empty now, update the other side */
@@ -944,6 +1356,7 @@ gst_queue_locked_dequeue (GstQueue * queue)
 
     queue->cur_level.buffers -= gst_buffer_list_length (buffer_list);
     queue->cur_level.bytes -= bufsize;
+    gst_queue_locked_update_budget (queue);
     apply_buffer_list (queue, buffer_list, &queue->src_segment, FALSE);
 
     /* if the queue is empty now, update the other side */
@@ -959,6 +1372,7 @@ gst_queue_locked_dequeue (GstQueue * queue)
       case GST_EVENT_EOS:
         /* queue is empty now that we dequeued the EOS */
         GST_QUEUE_CLEAR_LEVEL (queue->cur_level);
+        gst_queue_locked_update_budget (queue);
         break;
       case GST_EVENT_SEGMENT:
         /* apply newsegment if it has not already been applied */
@@ -1016,6 +1430,7 @@ gst_queue_handle_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
       /* now unblock the chain function */
       GST_QUEUE_MUTEX_LOCK (queue);
       queue->srcresult = GST_FLOW_FLUSHING;
+      gst_queue_budget_set_flushing (queue, TRUE);
       /* unblock the loop and chain functions */
       GST_QUEUE_SIGNAL_ADD (queue);
       GST_QUEUE_SIGNAL_DEL (queue);
@@ -1041,6 +1456,7 @@ gst_queue_handle_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
       GST_QUEUE_MUTEX_LOCK (queue);
       gst_queue_locked_flush (queue, FALSE);
       queue->srcresult = GST_FLOW_OK;
+      gst_queue_budget_set_flushing (queue, FALSE);
       queue->eos = FALSE;
       queue->unexpected = FALSE;
       if (gst_pad_is_active (queue->srcpad)) {
@@ -1064,8 +1480,10 @@ gst_queue_handle_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
          * pad. Change the cached sinkpad flow result accordingly */
         if (queue->srcresult == GST_FLOW_EOS
             && (GST_EVENT_TYPE (event) == GST_EVENT_STREAM_START
-                || GST_EVENT_TYPE (event) == GST_EVENT_SEGMENT))
+                || GST_EVENT_TYPE (event) == GST_EVENT_SEGMENT)) {
           queue->srcresult = GST_FLOW_OK;
+          gst_queue_budget_set_flushing (queue, FALSE);
+        }
 
         if (queue->srcresult != GST_FLOW_OK) {
           /* Errors in sticky event pushing are no problem and ignored here
@@ -1096,6 +1514,7 @@ gst_queue_handle_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
               /* Restart the loop */
               if (GST_PAD_MODE (queue->srcpad) == GST_PAD_MODE_PUSH) {
                 queue->srcresult = GST_FLOW_OK;
+                gst_queue_budget_set_flushing (queue, FALSE);
                 queue->eos = FALSE;
                 queue->unexpected = FALSE;
                 gst_pad_start_task (queue->srcpad,
@@ -1157,6 +1576,7 @@ gst_queue_handle_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
 
         GST_QUEUE_MUTEX_LOCK_CHECK (queue, out_flushing);
         GST_LOG_OBJECT (queue, "queuing query %" GST_PTR_FORMAT, query);
+        gst_queue_locked_ring_stop (queue);
         qitem.item = GST_MINI_OBJECT_CAST (query);
         qitem.is_query = TRUE;
         qitem.size = 0;
@@ -1194,7 +1614,7 @@ gst_queue_is_empty (GstQueue * queue)
   tail = gst_vec_deque_peek_tail_struct (queue->queue);
 
   if (tail == NULL)
-    return TRUE;
+    return gst_queue_ring_length (queue) == 0;
 
   /* Only consider the queue empty if the minimum thresholds
    * are not reached and data is at the queue tail. Otherwise
@@ -1217,10 +1637,16 @@ gst_queue_is_empty (GstQueue * queue)
 static gboolean
 gst_queue_is_filled (GstQueue * queue)
 {
+  guint buffers, bytes;
+
+  /* include what is in the ring */
+  buffers = queue->cur_level.buffers + gst_queue_ring_length (queue);
+  bytes = queue->cur_level.bytes + g_atomic_int_get (&queue->ring_bytes);
+
   return (((queue->max_size.buffers > 0 &&
-              queue->cur_level.buffers >= queue->max_size.buffers) ||
+              buffers >= queue->max_size.buffers) ||
           (queue->max_size.bytes > 0 &&
-              queue->cur_level.bytes >= queue->max_size.bytes) ||
+              bytes >= queue->max_size.bytes) ||
           (queue->max_size.time > 0 &&
               queue->cur_level.time >= queue->max_size.time)));
 }
@@ -1425,6 +1851,8 @@ static GstFlowReturn
 gst_queue_chain_list (GstPad * pad, GstObject * parent,
     GstBufferList * buffer_list)
 {
+  gst_queue_wait_budget (GST_QUEUE_CAST (parent));
+
   return gst_queue_chain_buffer_or_list (pad, parent,
       GST_MINI_OBJECT_CAST (buffer_list), TRUE);
 }
@@ -1432,6 +1860,13 @@ gst_queue_chain_list (GstPad * pad, GstObject * parent,
 static GstFlowReturn
 gst_queue_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
 {
+  GstQueue *queue = GST_QUEUE_CAST (parent);
+
+  gst_queue_wait_budget (queue);
+
+  if (queue->ring != NULL && gst_queue_ring_push (queue, buffer))
+    return GST_FLOW_OK;
+
   return gst_queue_chain_buffer_or_list (pad, parent,
       GST_MINI_OBJECT_CAST (buffer), FALSE);
 }
@@ -1610,6 +2045,11 @@ gst_queue_loop (GstPad * pad)
 
     /* we recheck, the signal could have changed the thresholds */
     while (gst_queue_is_empty (queue)) {
+      if (gst_queue_locked_ring_spin (queue)) {
+        if (queue->srcresult != GST_FLOW_OK)
+          goto out_flushing;
+        continue;
+      }
       GST_QUEUE_WAIT_ADD_CHECK (queue, out_flushing);
     }
 
@@ -1640,6 +2080,7 @@ out_flushing:
     GstFlowReturn ret = queue->srcresult;
 
     gst_pad_pause_task (queue->srcpad);
+    gst_queue_budget_set_flushing (queue, TRUE);
     GST_CAT_LOG_OBJECT (queue_dataflow, queue,
         "pause task, reason:  %s", gst_flow_get_name (ret));
 
@@ -1732,6 +2173,7 @@ gst_queue_handle_src_query (GstPad * pad, GstObject * parent, GstQuery * query)
       switch (format) {
         case GST_FORMAT_BYTES:
           peer_pos -= queue->cur_level.bytes;
+          peer_pos -= g_atomic_int_get (&queue->ring_bytes);
           if (peer_pos < 0)     /* Clamp result to 0 */
             peer_pos = 0;
           break;
@@ -1800,11 +2242,14 @@ gst_queue_sink_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
         queue->srcresult = GST_FLOW_OK;
         queue->eos = FALSE;
         queue->unexpected = FALSE;
+        gst_queue_budget_set_flushing (queue, FALSE);
+        gst_queue_locked_ring_setup (queue);
         GST_QUEUE_MUTEX_UNLOCK (queue);
       } else {
         /* step 1, unblock chain function */
         GST_QUEUE_MUTEX_LOCK (queue);
         queue->srcresult = GST_FLOW_FLUSHING;
+        gst_queue_budget_set_flushing (queue, TRUE);
         /* the item del signal will unblock */
         GST_QUEUE_SIGNAL_DEL (queue);
         GST_QUEUE_MUTEX_UNLOCK (queue);
@@ -1841,6 +2286,7 @@ gst_queue_src_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
         queue->srcresult = GST_FLOW_OK;
         queue->eos = FALSE;
         queue->unexpected = FALSE;
+        gst_queue_budget_set_flushing (queue, FALSE);
         result =
             gst_pad_start_task (pad, (GstTaskFunction) gst_queue_loop,
             gst_object_ref (pad), gst_object_unref);
@@ -1938,6 +2384,19 @@ gst_queue_set_property (GObject * object,
     case PROP_NOTIFY_LEVELS:
       queue->notify_levels = g_value_get_boolean (value);
       break;
+    case PROP_LOCK_FREE:
+      queue->lock_free = g_value_get_boolean (value);
+      break;
+    case PROP_MEMORY_BUDGET:
+      gst_queue_locked_set_budget (queue, g_value_get_object (value));
+      break;
+    case PROP_MEMORY_BUDGET_PRIORITY:
+      queue->budget_priority = g_value_get_uint (value);
+      if (queue->budget_client) {
+        gst_memory_budget_client_set_priority (queue->budget_client,
+            queue->budget_priority);
+      }
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1956,10 +2415,12 @@ gst_queue_get_property (GObject * object,
 
   switch (prop_id) {
     case PROP_CUR_LEVEL_BYTES:
-      g_value_set_uint (value, queue->cur_level.bytes);
+      g_value_set_uint (value, queue->cur_level.bytes +
+          g_atomic_int_get (&queue->ring_bytes));
       break;
     case PROP_CUR_LEVEL_BUFFERS:
-      g_value_set_uint (value, queue->cur_level.buffers);
+      g_value_set_uint (value, queue->cur_level.buffers +
+          gst_queue_ring_length (queue));
       break;
     case PROP_CUR_LEVEL_TIME:
       g_value_set_uint64 (value, queue->cur_level.time);
@@ -1994,6 +2455,15 @@ gst_queue_get_property (GObject * object,
     case PROP_NOTIFY_LEVELS:
       g_value_set_boolean (value, queue->notify_levels);
       break;
+    case PROP_LOCK_FREE:
+      g_value_set_boolean (value, queue->lock_free);
+      break;
+    case PROP_MEMORY_BUDGET:
+      g_value_set_object (value, queue->budget);
+      break;
+    case PROP_MEMORY_BUDGET_PRIORITY:
+      g_value_set_uint (value, queue->budget_priority);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2001,3 +2471,27 @@ gst_queue_get_property (GObject * object,
 
   GST_QUEUE_MUTEX_UNLOCK (queue);
 }
+
+static void
+gst_queue_set_context (GstElement * element, GstContext * context)
+{
+  GstQueue *queue = GST_QUEUE (element);
+  GstMemoryBudget *budget;
+
+  if (gst_context_get_memory_budget (context, &budget)) {
+    gboolean active = gst_pad_is_active (queue->sinkpad);
+
+    /* an explicitly configured budget wins, and it can't be changed while
+     * streaming */
+    GST_QUEUE_MUTEX_LOCK (queue);
+    if (queue->budget == NULL && !active) {
+      GST_DEBUG_OBJECT (queue, "using %" GST_PTR_FORMAT " from context",
+          budget);
+      gst_queue_locked_set_budget (queue, budget);
+    }
+    GST_QUEUE_MUTEX_UNLOCK (queue);
+    gst_object_unref (budget);
+  }
+
+  GST_ELEMENT_CLASS (parent_class)->set_context (element, context);
+}
@@ -140,6 +140,24 @@ struct _GstQueue {
   GstQuery *last_handled_query;
 
   gboolean flush_on_eos; /* flush on EOS */
+
+  /* ring the sinkpad streaming thread adds buffers to without taking the
+   * lock while nothing else is queued. Buffers in it are older than all
+   * items in @queue and are dequeued with the lock like those. */
+  gboolean lock_free;
+  GstBuffer **ring;
+  guint ring_mask;
+  gint ring_head;        /* advanced with the lock held */
+  gint ring_tail;        /* advanced by the sinkpad streaming thread */
+  gint ring_bytes;
+  guint ring_synced;     /* first ring index not applied to sink_segment */
+  gint queue_used;       /* TRUE while @queue has items */
+  guint ring_spin;       /* how long to wait for the ring before sleeping */
+
+  /* shared memory limit, the client is accounted with the lock held */
+  GstMemoryBudget *budget;
+  GstMemoryBudgetClient *budget_client;
+  guint budget_priority;
 };
 
 struct _GstQueueClass {
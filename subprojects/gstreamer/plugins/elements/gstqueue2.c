@@ -110,7 +110,13 @@ enum
 #define QUEUE_IS_USING_RING_BUFFER(queue) ((queue)->ring_buffer_max_size != 0)  /* for consistency with the above macro */
 #define QUEUE_IS_USING_QUEUE(queue) (!QUEUE_IS_USING_TEMP_FILE(queue) && !QUEUE_IS_USING_RING_BUFFER (queue))
 
-#define QUEUE_MAX_BYTES(queue) MIN((queue)->max_level.bytes, (queue)->ring_buffer_max_size)
+#define QUEUE_IS_USING_STORE(queue) ((queue)->store != NULL)
+
+#define QUEUE_MAX_BYTES(queue) MIN((queue)->max_level.bytes, \
+    (queue)->ring_buffer_max_size - (queue)->ring_buffer_guard)
+
+/* size of the blocks of the zero-copy store */
+#define STORE_BLOCK_SIZE (1024 * 1024)
 
 /* default property values */
 #define DEFAULT_MAX_SIZE_BUFFERS   100  /* 100 buffers */
@@ -126,6 +132,8 @@ enum
 #define DEFAULT_TEMP_REMOVE        TRUE
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
 #define DEFAULT_USE_BITRATE_QUERY  TRUE
+#define DEFAULT_MEMORY_BUDGET_PRIORITY 100
+#define DEFAULT_ZERO_COPY          FALSE
 
 enum
 {
@@ -150,6 +158,9 @@ enum
   PROP_AVG_IN_RATE,
   PROP_USE_BITRATE_QUERY,
   PROP_BITRATE,
+  PROP_MEMORY_BUDGET,
+  PROP_MEMORY_BUDGET_PRIORITY,
+  PROP_ZERO_COPY,
   PROP_LAST
 };
 static GParamSpec *obj_props[PROP_LAST] = { NULL, };
@@ -313,6 +324,8 @@ static gboolean gst_queue2_sink_activate_mode (GstPad * pad, GstObject * parent,
     GstPadMode mode, gboolean active);
 static GstStateChangeReturn gst_queue2_change_state (GstElement * element,
     GstStateChange transition);
+static void gst_queue2_set_context (GstElement * element,
+    GstContext * context);
 
 static gboolean gst_queue2_is_empty (GstQueue2 * queue);
 static gboolean gst_queue2_is_filled (GstQueue2 * queue);
@@ -470,6 +483,54 @@ gst_queue2_class_init (GstQueue2Class * klass)
       "Conversion value between data size and time",
       0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GstQueue2:memory-budget
+   *
+   * A #GstMemoryBudget shared with other elements that limits the bytes
+   * they keep queued together. Only data kept in memory is accounted, not
+   * data in the temporary file or the ring buffer.
+   *
+   * When not set, a budget from a #GstContext of type
+   * #GST_MEMORY_BUDGET_CONTEXT_TYPE set on the pipeline is used.
+   *
+   * Since: 1.30
+   */
+  obj_props[PROP_MEMORY_BUDGET] =
+      g_param_spec_object ("memory-budget", "Memory Budget",
+      "Memory budget shared with other elements", GST_TYPE_MEMORY_BUDGET,
+      G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GstQueue2:memory-budget-priority
+   *
+   * The share of the #GstQueue2:memory-budget this queue is entitled to,
+   * relative to the priorities of the other elements using it.
+   *
+   * Since: 1.30
+   */
+  obj_props[PROP_MEMORY_BUDGET_PRIORITY] =
+      g_param_spec_uint ("memory-budget-priority", "Memory Budget Priority",
+      "Relative share of the memory budget", 1, G_MAXUINT,
+      DEFAULT_MEMORY_BUDGET_PRIORITY,
+      G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GstQueue2:zero-copy
+   *
+   * Push buffers that point into the ring buffer or the temp file instead of
+   * copies of the data. The temp file is mapped into memory for this.
+   *
+   * Data in a ring buffer that is still used downstream when it is about to
+   * be overwritten is copied first, and the ring buffer keeps a small part of
+   * #GstQueue2:ring-buffer-max-size free to make that rare.
+   *
+   * Since: 1.30
+   */
+  obj_props[PROP_ZERO_COPY] = g_param_spec_boolean ("zero-copy", "Zero copy",
+      "Push buffers that point into the ring buffer or temp file",
+      DEFAULT_ZERO_COPY,
+      G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
 
   /* set several parent class virtual functions */
@@ -486,6 +547,7 @@ gst_queue2_class_init (GstQueue2Class * klass)
 
   gstelement_class->change_state = GST_DEBUG_FUNCPTR (gst_queue2_change_state);
   gstelement_class->query = GST_DEBUG_FUNCPTR (gst_queue2_handle_query);
+  gstelement_class->set_context = GST_DEBUG_FUNCPTR (gst_queue2_set_context);
 }
 
 static void
@@ -568,6 +630,8 @@ gst_queue2_init (GstQueue2 * queue)
   queue->ring_buffer_max_size = DEFAULT_RING_BUFFER_MAX_SIZE;
 
   queue->use_bitrate_query = DEFAULT_USE_BITRATE_QUERY;
+  queue->budget_priority = DEFAULT_MEMORY_BUDGET_PRIORITY;
+  queue->zero_copy = DEFAULT_ZERO_COPY;
 
   GST_DEBUG_OBJECT (queue,
       "initialized queue's not_empty & not_full conditions");
@@ -601,6 +665,10 @@ gst_queue2_finalize (GObject * object)
   g_free (queue->temp_template);
   g_free (queue->temp_location);
 
+  if (queue->budget_client)
+    gst_memory_budget_client_free (queue->budget_client);
+  gst_clear_object (&queue->budget);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -1518,13 +1586,18 @@ gst_queue2_read_data_at_offset (GstQueue2 * queue, guint64 offset, guint length,
 
   ring_buffer = queue->ring_buffer;
 
-  if (QUEUE_IS_USING_TEMP_FILE (queue) && FSEEK_FILE (queue->temp_file, offset))
+  if (QUEUE_IS_USING_TEMP_FILE (queue) && !QUEUE_IS_USING_STORE (queue)
+      && FSEEK_FILE (queue->temp_file, offset))
     goto seek_failed;
 
   /* this should not block */
   GST_LOG_OBJECT (queue, "Reading %d bytes from offset %" G_GUINT64_FORMAT,
       length, offset);
-  if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+  if (QUEUE_IS_USING_STORE (queue)) {
+    res = gst_block_store_fill (queue->store, offset, dst, length);
+    if (res == 0 && length > 0)
+      goto eos;
+  } else if (QUEUE_IS_USING_TEMP_FILE (queue)) {
     res = fread (dst, 1, length, queue->temp_file);
   } else {
     memcpy (dst, ring_buffer + offset, length);
@@ -1569,24 +1642,35 @@ gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
     GstBuffer ** buffer)
 {
   GstBuffer *buf;
-  GstMapInfo info;
+  GstMapInfo info = GST_MAP_INFO_INIT;
   guint8 *data;
   guint64 file_offset;
   guint block_length, remaining, read_length;
   guint64 rb_size;
   guint64 max_size;
   guint64 rpos;
+  gboolean zero_copy;
   GstFlowReturn ret = GST_FLOW_OK;
 
+  /* in zero-copy mode the output buffer is made of memory shared with the
+   * store, unless downstream provided a buffer to fill */
+  zero_copy = QUEUE_IS_USING_STORE (queue) && *buffer == NULL;
+
   /* allocate the output buffer of the requested size */
-  if (*buffer == NULL)
+  if (zero_copy)
+    buf = gst_buffer_new ();
+  else if (*buffer == NULL)
     buf = gst_buffer_new_allocate (NULL, length, NULL);
   else
     buf = *buffer;
 
-  if (!gst_buffer_map (buf, &info, GST_MAP_WRITE))
-    goto buffer_write_fail;
-  data = info.data;
+  if (zero_copy) {
+    data = NULL;
+  } else {
+    if (!gst_buffer_map (buf, &info, GST_MAP_WRITE))
+      goto buffer_write_fail;
+    data = info.data;
+  }
 
   GST_DEBUG_OBJECT (queue, "Reading %u bytes from %" G_GUINT64_FORMAT, length,
       offset);
@@ -1679,17 +1763,26 @@ gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
     while (read_length > 0) {
       gint64 read_return;
 
-      ret =
-          gst_queue2_read_data_at_offset (queue, file_offset, block_length,
-          data, &read_return);
-      if (ret != GST_FLOW_OK)
-        goto read_error;
+      if (zero_copy) {
+        read_return = gst_block_store_read (queue->store, file_offset,
+            block_length, buf);
+        if (read_return == 0) {
+          ret = GST_FLOW_EOS;
+          goto read_error;
+        }
+      } else {
+        ret =
+            gst_queue2_read_data_at_offset (queue, file_offset, block_length,
+            data, &read_return);
+        if (ret != GST_FLOW_OK)
+          goto read_error;
+        data += read_return;
+      }
 
       file_offset += read_return;
       if (QUEUE_IS_USING_RING_BUFFER (queue))
         file_offset %= rb_size;
 
-      data += read_return;
       read_length -= read_return;
       block_length = read_length;
       remaining -= read_return;
@@ -1701,7 +1794,8 @@ gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
     GST_DEBUG_OBJECT (queue, "%u bytes left to read", remaining);
   }
 
-  gst_buffer_unmap (buf, &info);
+  if (!zero_copy)
+    gst_buffer_unmap (buf, &info);
   gst_buffer_resize (buf, 0, length);
 
   GST_BUFFER_OFFSET (buf) = offset;
@@ -1715,7 +1809,8 @@ gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
 hit_eos:
   {
     GST_DEBUG_OBJECT (queue, "EOS hit and we don't have any requested data");
-    gst_buffer_unmap (buf, &info);
+    if (!zero_copy)
+      gst_buffer_unmap (buf, &info);
     if (*buffer == NULL)
       gst_buffer_unref (buf);
     return GST_FLOW_EOS;
@@ -1723,7 +1818,8 @@ hit_eos:
 out_flushing:
   {
     GST_DEBUG_OBJECT (queue, "we are flushing");
-    gst_buffer_unmap (buf, &info);
+    if (!zero_copy)
+      gst_buffer_unmap (buf, &info);
     if (*buffer == NULL)
       gst_buffer_unref (buf);
     return GST_FLOW_FLUSHING;
@@ -1731,7 +1827,8 @@ out_flushing:
 read_error:
   {
     GST_DEBUG_OBJECT (queue, "we have a read error");
-    gst_buffer_unmap (buf, &info);
+    if (!zero_copy)
+      gst_buffer_unmap (buf, &info);
     if (*buffer == NULL)
       gst_buffer_unref (buf);
     return ret;
@@ -1784,6 +1881,90 @@ gst_queue2_read_item_from_file (GstQueue2 * queue)
   return item;
 }
 
+/* with QUEUE2_LOCK. Set up the block store of the zero-copy mode on @fd, or
+ * in memory when @fd is -1. The data is copied as before when the store can't
+ * be used. */
+static void
+gst_queue2_open_store (GstQueue2 * queue, gint fd)
+{
+  gboolean ring = QUEUE_IS_USING_RING_BUFFER (queue);
+  gsize block_size = STORE_BLOCK_SIZE;
+  GError *err = NULL;
+
+  queue->ring_buffer_guard = 0;
+
+  if (!queue->zero_copy)
+    return;
+
+  /* the writer stays a block behind the reader, keep that small */
+  if (ring)
+    block_size = MIN (block_size, queue->ring_buffer_max_size / 8);
+
+  queue->store = gst_block_store_new (fd, MAX (block_size, 1), ring, &err);
+  if (queue->store == NULL)
+    goto no_store;
+
+  if (ring) {
+    queue->ring_buffer_guard = gst_block_store_get_block_size (queue->store);
+    if (queue->ring_buffer_guard * 2 > queue->ring_buffer_max_size)
+      goto too_small;
+  }
+
+  GST_DEBUG_OBJECT (queue, "using zero-copy store with blocks of %"
+      G_GSIZE_FORMAT " bytes", gst_block_store_get_block_size (queue->store));
+  return;
+
+  /* ERRORS */
+no_store:
+  {
+    GST_WARNING_OBJECT (queue, "can't use zero-copy mode: %s", err->message);
+    g_clear_error (&err);
+    return;
+  }
+too_small:
+  {
+    GST_WARNING_OBJECT (queue, "ring buffer too small for zero-copy mode");
+    gst_block_store_free (queue->store);
+    queue->store = NULL;
+    queue->ring_buffer_guard = 0;
+    return;
+  }
+}
+
+static void
+gst_queue2_close_store (GstQueue2 * queue)
+{
+  if (queue->store == NULL)
+    return;
+
+  GST_DEBUG_OBJECT (queue, "closing store, %" G_GUINT64_FORMAT
+      " blocks were copied", gst_block_store_get_copies (queue->store));
+
+  gst_block_store_free (queue->store);
+  queue->store = NULL;
+  queue->ring_buffer_guard = 0;
+}
+
+/* with QUEUE2_LOCK, allocate the in-memory ring buffer */
+static gboolean
+gst_queue2_alloc_ring_buffer (GstQueue2 * queue)
+{
+  gst_queue2_open_store (queue, -1);
+  if (QUEUE_IS_USING_STORE (queue))
+    return TRUE;
+
+  queue->ring_buffer = g_malloc (queue->ring_buffer_max_size);
+  return !!queue->ring_buffer;
+}
+
+static void
+gst_queue2_free_ring_buffer (GstQueue2 * queue)
+{
+  gst_queue2_close_store (queue);
+  g_free (queue->ring_buffer);
+  queue->ring_buffer = NULL;
+}
+
 /* must be called with MUTEX_LOCK. Will briefly release the lock when notifying
  * the temp filename. */
 static gboolean
@@ -1824,6 +2005,8 @@ gst_queue2_open_temp_location_file (GstQueue2 * queue)
   g_free (queue->temp_location);
   queue->temp_location = name;
 
+  gst_queue2_open_store (queue, fd);
+
   GST_QUEUE2_MUTEX_UNLOCK (queue);
 
   /* we can't emit the notify with the lock */
@@ -1875,6 +2058,9 @@ gst_queue2_close_temp_location_file (GstQueue2 * queue)
 
   GST_DEBUG_OBJECT (queue, "closing temp file");
 
+  /* the store truncates the file to the written data */
+  gst_queue2_close_store (queue);
+
   fflush (queue->temp_file);
   fclose (queue->temp_file);
 
@@ -1897,7 +2083,67 @@ gst_queue2_flush_temp_file (GstQueue2 * queue)
 
   GST_DEBUG_OBJECT (queue, "flushing temp file");
 
+  /* buffers might still point into the old file, truncating it would make
+   * them invalid. Replace it by a new file instead. */
+  if (QUEUE_IS_USING_STORE (queue)) {
+    gst_queue2_close_store (queue);
+    if (g_remove (queue->temp_location) < 0) {
+      GST_WARNING_OBJECT (queue, "Failed to remove temporary file %s: %s",
+          queue->temp_location, g_strerror (errno));
+    }
+  }
+
   queue->temp_file = g_freopen (queue->temp_location, "wb+", queue->temp_file);
+
+  if (queue->temp_file)
+    gst_queue2_open_store (queue, fileno (queue->temp_file));
+}
+
+/* with QUEUE2_LOCK. Only the in-memory queue is accounted, the temp file and
+ * the ring buffer are already bounded by their own size. */
+static inline void
+gst_queue2_locked_update_budget (GstQueue2 * queue)
+{
+  if (queue->budget_client) {
+    gst_memory_budget_client_set_used (queue->budget_client,
+        QUEUE_IS_USING_QUEUE (queue) ? queue->cur_level.bytes : 0);
+  }
+}
+
+/* (re)register with @budget, with QUEUE2_LOCK */
+static void
+gst_queue2_locked_set_budget (GstQueue2 * queue, GstMemoryBudget * budget)
+{
+  if (queue->budget_client) {
+    gst_memory_budget_client_free (queue->budget_client);
+    queue->budget_client = NULL;
+  }
+  gst_object_replace ((GstObject **) & queue->budget, (GstObject *) budget);
+
+  if (budget) {
+    queue->budget_client = gst_memory_budget_client_new (budget,
+        GST_OBJECT_CAST (queue), queue->budget_priority);
+    gst_memory_budget_client_set_flushing (queue->budget_client,
+        queue->sinkresult != GST_FLOW_OK);
+    gst_queue2_locked_update_budget (queue);
+  }
+}
+
+static inline void
+gst_queue2_budget_set_flushing (GstQueue2 * queue, gboolean flushing)
+{
+  if (queue->budget_client)
+    gst_memory_budget_client_set_flushing (queue->budget_client, flushing);
+}
+
+/* block the sinkpad streaming thread while this queue uses more than its share
+ * of an exhausted memory budget, without QUEUE2_LOCK. Flushing is handled
+ * when the item is queued. */
+static inline void
+gst_queue2_wait_budget (GstQueue2 * queue)
+{
+  if (queue->budget_client)
+    gst_memory_budget_client_wait (queue->budget_client);
 }
 
 static void
@@ -1928,6 +2174,7 @@ gst_queue2_locked_flush (GstQueue2 * queue, gboolean full, gboolean clear_temp)
   queue->last_query = FALSE;
   g_cond_signal (&queue->query_handled);
   GST_QUEUE2_CLEAR_LEVEL (queue->cur_level);
+  gst_queue2_locked_update_budget (queue);
   gst_segment_init (&queue->sink_segment, GST_FORMAT_TIME);
   gst_segment_init (&queue->src_segment, GST_FORMAT_TIME);
   queue->sinktime = queue->srctime = GST_CLOCK_TIME_NONE;
@@ -2135,7 +2382,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
       new_writing_pos = writing_pos + to_write;
     }
 
-    if (QUEUE_IS_USING_TEMP_FILE (queue)
+    if (QUEUE_IS_USING_TEMP_FILE (queue) && !QUEUE_IS_USING_STORE (queue)
         && FSEEK_FILE (queue->temp_file, writing_pos))
       goto seek_failed;
 
@@ -2145,7 +2392,10 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
           "] (rb wpos %" G_GUINT64_FORMAT ")", to_write, queue->current->offset,
           queue->current->writing_pos, queue->current->rb_writing_pos);
       /* either not using ring buffer or no wrapping, just write */
-      if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+      if (QUEUE_IS_USING_STORE (queue)) {
+        if (!gst_block_store_write (queue->store, writing_pos, data, to_write))
+          goto handle_error;
+      } else if (QUEUE_IS_USING_TEMP_FILE (queue)) {
         if (fwrite (data, to_write, 1, queue->temp_file) != 1)
           goto handle_error;
       } else {
@@ -2190,7 +2440,11 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
       if (block_one > 0) {
         GST_INFO_OBJECT (queue, "writing %u bytes", block_one);
         /* write data to end of ring buffer */
-        if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+        if (QUEUE_IS_USING_STORE (queue)) {
+          if (!gst_block_store_write (queue->store, writing_pos, data,
+                  block_one))
+            goto handle_error;
+        } else if (QUEUE_IS_USING_TEMP_FILE (queue)) {
           if (fwrite (data, block_one, 1, queue->temp_file) != 1)
             goto handle_error;
         } else {
@@ -2198,12 +2452,17 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
         }
       }
 
-      if (QUEUE_IS_USING_TEMP_FILE (queue) && FSEEK_FILE (queue->temp_file, 0))
+      if (QUEUE_IS_USING_TEMP_FILE (queue) && !QUEUE_IS_USING_STORE (queue)
+          && FSEEK_FILE (queue->temp_file, 0))
         goto seek_failed;
 
       if (block_two > 0) {
         GST_INFO_OBJECT (queue, "writing %u bytes", block_two);
-        if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+        if (QUEUE_IS_USING_STORE (queue)) {
+          if (!gst_block_store_write (queue->store, 0, data + block_one,
+                  block_two))
+            goto handle_error;
+        } else if (QUEUE_IS_USING_TEMP_FILE (queue)) {
           if (fwrite (data + block_one, block_two, 1, queue->temp_file) != 1)
             goto handle_error;
         } else {
@@ -2319,6 +2578,7 @@ gst_queue2_locked_enqueue (GstQueue2 * queue, gpointer item,
     if (QUEUE_IS_USING_QUEUE (queue)) {
       queue->cur_level.buffers++;
       queue->cur_level.bytes += size;
+      gst_queue2_locked_update_budget (queue);
     }
     queue->bytes_in += size;
 
@@ -2344,6 +2604,7 @@ gst_queue2_locked_enqueue (GstQueue2 * queue, gpointer item,
     if (QUEUE_IS_USING_QUEUE (queue)) {
       queue->cur_level.buffers += gst_buffer_list_length (buffer_list);
       queue->cur_level.bytes += size;
+      gst_queue2_locked_update_budget (queue);
     }
     queue->bytes_in += size;
 
@@ -2494,6 +2755,7 @@ gst_queue2_locked_dequeue (GstQueue2 * queue, GstQueue2ItemType * item_type)
     if (QUEUE_IS_USING_QUEUE (queue)) {
       queue->cur_level.buffers--;
       queue->cur_level.bytes -= size;
+      gst_queue2_locked_update_budget (queue);
     }
     queue->bytes_out += size;
 
@@ -2516,6 +2778,7 @@ gst_queue2_locked_dequeue (GstQueue2 * queue, GstQueue2ItemType * item_type)
       case GST_EVENT_EOS:
         /* queue is empty now that we dequeued the EOS */
         GST_QUEUE2_CLEAR_LEVEL (queue->cur_level);
+        gst_queue2_locked_update_budget (queue);
         break;
       case GST_EVENT_SEGMENT:
         apply_segment (queue, event, &queue->src_segment, FALSE);
@@ -2540,6 +2803,7 @@ gst_queue2_locked_dequeue (GstQueue2 * queue, GstQueue2ItemType * item_type)
     if (QUEUE_IS_USING_QUEUE (queue)) {
       queue->cur_level.buffers -= gst_buffer_list_length (buffer_list);
       queue->cur_level.bytes -= size;
+      gst_queue2_locked_update_budget (queue);
     }
     queue->bytes_out += size;
 
@@ -2595,6 +2859,7 @@ gst_queue2_handle_sink_event (GstPad * pad, GstObject * parent,
         GST_QUEUE2_MUTEX_LOCK (queue);
         queue->srcresult = GST_FLOW_FLUSHING;
         queue->sinkresult = GST_FLOW_FLUSHING;
+        gst_queue2_budget_set_flushing (queue, TRUE);
         /* unblock the loop and chain functions */
         GST_QUEUE2_SIGNAL_ADD (queue);
         GST_QUEUE2_SIGNAL_DEL (queue);
@@ -2613,6 +2878,7 @@ gst_queue2_handle_sink_event (GstPad * pad, GstObject * parent,
         GST_QUEUE2_MUTEX_LOCK (queue);
         /* flush the sink pad */
         queue->sinkresult = GST_FLOW_FLUSHING;
+        gst_queue2_budget_set_flushing (queue, TRUE);
         GST_QUEUE2_SIGNAL_DEL (queue);
         queue->last_query = FALSE;
         g_cond_signal (&queue->query_handled);
@@ -2632,6 +2898,7 @@ gst_queue2_handle_sink_event (GstPad * pad, GstObject * parent,
         gst_queue2_locked_flush (queue, FALSE, TRUE);
         queue->srcresult = GST_FLOW_OK;
         queue->sinkresult = GST_FLOW_OK;
+        gst_queue2_budget_set_flushing (queue, FALSE);
         queue->is_eos = FALSE;
         queue->unexpected = FALSE;
         queue->seeking = FALSE;
@@ -2647,6 +2914,7 @@ gst_queue2_handle_sink_event (GstPad * pad, GstObject * parent,
         queue->is_eos = FALSE;
         queue->unexpected = FALSE;
         queue->sinkresult = GST_FLOW_OK;
+        gst_queue2_budget_set_flushing (queue, FALSE);
         queue->seeking = FALSE;
         queue->src_tags_bitrate = queue->sink_tags_bitrate = 0;
         GST_QUEUE2_MUTEX_UNLOCK (queue);
@@ -2683,9 +2951,10 @@ gst_queue2_handle_sink_event (GstPad * pad, GstObject * parent,
         GST_QUEUE2_MUTEX_LOCK (queue);
         if (queue->sinkresult == GST_FLOW_EOS
             && (GST_EVENT_TYPE (event) == GST_EVENT_STREAM_START
-                || GST_EVENT_TYPE (event) == GST_EVENT_SEGMENT))
+                || GST_EVENT_TYPE (event) == GST_EVENT_SEGMENT)) {
           queue->sinkresult = GST_FLOW_OK;
-        else if (queue->sinkresult != GST_FLOW_OK)
+          gst_queue2_budget_set_flushing (queue, FALSE);
+        } else if (queue->sinkresult != GST_FLOW_OK)
           goto out_flushing;
 
         if (queue->srcresult != GST_FLOW_OK) {
@@ -2991,6 +3260,8 @@ gst_queue2_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
       GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buffer)),
       GST_TIME_ARGS (GST_BUFFER_DURATION (buffer)));
 
+  gst_queue2_wait_budget (queue);
+
   return gst_queue2_chain_buffer_or_buffer_list (queue,
       GST_MINI_OBJECT_CAST (buffer), GST_QUEUE2_ITEM_TYPE_BUFFER);
 }
@@ -3006,6 +3277,8 @@ gst_queue2_chain_list (GstPad * pad, GstObject * parent,
   GST_CAT_LOG_OBJECT (queue_dataflow, queue,
       "received buffer list %p", buffer_list);
 
+  gst_queue2_wait_budget (queue);
+
   return gst_queue2_chain_buffer_or_buffer_list (queue,
       GST_MINI_OBJECT_CAST (buffer_list), GST_QUEUE2_ITEM_TYPE_BUFFER_LIST);
 }
@@ -3234,6 +3507,7 @@ out_flushing:
     GstFlowReturn ret = queue->srcresult;
 
     gst_pad_pause_task (queue->srcpad);
+    gst_queue2_budget_set_flushing (queue, TRUE);
 
     /* flush internal queue except for not-linked and eos
      * not-linked: reconfigure event will start srcpad task
@@ -3318,6 +3592,7 @@ gst_queue2_handle_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
         gst_pad_mark_reconfigure (pad);
         queue->srcresult = GST_FLOW_OK;
         queue->sinkresult = GST_FLOW_OK;
+        gst_queue2_budget_set_flushing (queue, FALSE);
         if (GST_PAD_MODE (pad) == GST_PAD_MODE_PUSH) {
           gst_pad_start_task (pad, (GstTaskFunction) gst_queue2_loop,
               gst_object_ref (pad), gst_object_unref);
@@ -3563,6 +3838,30 @@ gst_queue2_handle_query (GstElement * element, GstQuery * query)
       query);
 }
 
+static void
+gst_queue2_set_context (GstElement * element, GstContext * context)
+{
+  GstQueue2 *queue = GST_QUEUE2 (element);
+  GstMemoryBudget *budget;
+
+  if (gst_context_get_memory_budget (context, &budget)) {
+    gboolean active = gst_pad_is_active (queue->sinkpad);
+
+    /* an explicitly configured budget wins, and it can't be changed while
+     * streaming */
+    GST_QUEUE2_MUTEX_LOCK (queue);
+    if (queue->budget == NULL && !active) {
+      GST_DEBUG_OBJECT (queue, "using %" GST_PTR_FORMAT " from context",
+          budget);
+      gst_queue2_locked_set_budget (queue, budget);
+    }
+    GST_QUEUE2_MUTEX_UNLOCK (queue);
+    gst_object_unref (budget);
+  }
+
+  GST_ELEMENT_CLASS (parent_class)->set_context (element, context);
+}
+
 static void
 gst_queue2_update_upstream_size (GstQueue2 * queue)
 {
@@ -3657,6 +3956,7 @@ gst_queue2_sink_activate_mode (GstPad * pad, GstObject * parent,
         GST_DEBUG_OBJECT (queue, "activating push mode");
         queue->srcresult = GST_FLOW_OK;
         queue->sinkresult = GST_FLOW_OK;
+        gst_queue2_budget_set_flushing (queue, FALSE);
         queue->is_eos = FALSE;
         queue->unexpected = FALSE;
         reset_rate_timer (queue);
@@ -3667,6 +3967,7 @@ gst_queue2_sink_activate_mode (GstPad * pad, GstObject * parent,
         GST_DEBUG_OBJECT (queue, "deactivating push mode");
         queue->srcresult = GST_FLOW_FLUSHING;
         queue->sinkresult = GST_FLOW_FLUSHING;
+        gst_queue2_budget_set_flushing (queue, TRUE);
         GST_QUEUE2_SIGNAL_DEL (queue);
         GST_QUEUE2_MUTEX_UNLOCK (queue);
 
@@ -3701,6 +4002,7 @@ gst_queue2_src_activate_push (GstPad * pad, GstObject * parent, gboolean active)
     GST_DEBUG_OBJECT (queue, "activating push mode");
     queue->srcresult = GST_FLOW_OK;
     queue->sinkresult = GST_FLOW_OK;
+    gst_queue2_budget_set_flushing (queue, FALSE);
     queue->is_eos = FALSE;
     queue->unexpected = FALSE;
     result =
@@ -3713,6 +4015,7 @@ gst_queue2_src_activate_push (GstPad * pad, GstObject * parent, gboolean active)
     GST_DEBUG_OBJECT (queue, "deactivating push mode");
     queue->srcresult = GST_FLOW_FLUSHING;
     queue->sinkresult = GST_FLOW_FLUSHING;
+    gst_queue2_budget_set_flushing (queue, TRUE);
     /* the item add signal will unblock */
     GST_QUEUE2_SIGNAL_ADD (queue);
     GST_QUEUE2_MUTEX_UNLOCK (queue);
@@ -3743,9 +4046,8 @@ gst_queue2_src_activate_pull (GstPad * pad, GstObject * parent, gboolean active)
       if (QUEUE_IS_USING_TEMP_FILE (queue)) {
         /* open the temp file now */
         result = gst_queue2_open_temp_location_file (queue);
-      } else if (!queue->ring_buffer) {
-        queue->ring_buffer = g_malloc (queue->ring_buffer_max_size);
-        result = !!queue->ring_buffer;
+      } else if (!queue->ring_buffer && !QUEUE_IS_USING_STORE (queue)) {
+        result = gst_queue2_alloc_ring_buffer (queue);
       } else {
         result = TRUE;
       }
@@ -3754,6 +4056,7 @@ gst_queue2_src_activate_pull (GstPad * pad, GstObject * parent, gboolean active)
       init_ranges (queue);
       queue->srcresult = GST_FLOW_OK;
       queue->sinkresult = GST_FLOW_OK;
+      gst_queue2_budget_set_flushing (queue, FALSE);
       queue->is_eos = FALSE;
       queue->unexpected = FALSE;
       queue->upstream_size = 0;
@@ -3763,6 +4066,7 @@ gst_queue2_src_activate_pull (GstPad * pad, GstObject * parent, gboolean active)
        * file. */
       queue->srcresult = GST_FLOW_FLUSHING;
       queue->sinkresult = GST_FLOW_FLUSHING;
+      gst_queue2_budget_set_flushing (queue, TRUE);
       result = FALSE;
     }
     GST_QUEUE2_MUTEX_UNLOCK (queue);
@@ -3771,6 +4075,7 @@ gst_queue2_src_activate_pull (GstPad * pad, GstObject * parent, gboolean active)
     GST_DEBUG_OBJECT (queue, "deactivating pull mode");
     queue->srcresult = GST_FLOW_FLUSHING;
     queue->sinkresult = GST_FLOW_FLUSHING;
+    gst_queue2_budget_set_flushing (queue, TRUE);
     /* this will unlock getrange */
     GST_QUEUE2_SIGNAL_ADD (queue);
     result = TRUE;
@@ -3819,11 +4124,8 @@ gst_queue2_change_state (GstElement * element, GstStateChange transition)
           if (!gst_queue2_open_temp_location_file (queue))
             ret = GST_STATE_CHANGE_FAILURE;
         } else {
-          if (queue->ring_buffer) {
-            g_free (queue->ring_buffer);
-            queue->ring_buffer = NULL;
-          }
-          if (!(queue->ring_buffer = g_malloc (queue->ring_buffer_max_size)))
+          gst_queue2_free_ring_buffer (queue);
+          if (!gst_queue2_alloc_ring_buffer (queue))
             ret = GST_STATE_CHANGE_FAILURE;
         }
         init_ranges (queue);
@@ -3859,9 +4161,8 @@ gst_queue2_change_state (GstElement * element, GstStateChange transition)
       if (!QUEUE_IS_USING_QUEUE (queue)) {
         if (QUEUE_IS_USING_TEMP_FILE (queue)) {
           gst_queue2_close_temp_location_file (queue);
-        } else if (queue->ring_buffer) {
-          g_free (queue->ring_buffer);
-          queue->ring_buffer = NULL;
+        } else {
+          gst_queue2_free_ring_buffer (queue);
         }
         clean_ranges (queue);
       }
@@ -4001,6 +4302,19 @@ gst_queue2_set_property (GObject * object,
     case PROP_USE_BITRATE_QUERY:
       queue->use_bitrate_query = g_value_get_boolean (value);
       break;
+    case PROP_MEMORY_BUDGET:
+      gst_queue2_locked_set_budget (queue, g_value_get_object (value));
+      break;
+    case PROP_MEMORY_BUDGET_PRIORITY:
+      queue->budget_priority = g_value_get_uint (value);
+      if (queue->budget_client) {
+        gst_memory_budget_client_set_priority (queue->budget_client,
+            queue->budget_priority);
+      }
+      break;
+    case PROP_ZERO_COPY:
+      queue->zero_copy = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -4102,6 +4416,15 @@ gst_queue2_get_property (GObject * object,
       g_value_set_uint64 (value, (guint64) bitrate);
       break;
     }
+    case PROP_MEMORY_BUDGET:
+      g_value_set_object (value, queue->budget);
+      break;
+    case PROP_MEMORY_BUDGET_PRIORITY:
+      g_value_set_uint (value, queue->budget_priority);
+      break;
+    case PROP_ZERO_COPY:
+      g_value_set_boolean (value, queue->zero_copy);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
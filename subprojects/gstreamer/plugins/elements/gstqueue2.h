@@ -28,6 +28,8 @@
 #include <stdio.h>
 #include <gst/base/gstqueuearray.h>
 
+#include "gstblockstore.h"
+
 G_BEGIN_DECLS
 
 #define GST_TYPE_QUEUE2 \
@@ -165,6 +167,12 @@ struct _GstQueue2
   guint64 ring_buffer_max_size;
   guint8 * ring_buffer;
 
+  /* zero-copy mode, the ring buffer or temp file data is kept in the store
+   * and the writer stays ring_buffer_guard bytes behind the reader */
+  gboolean zero_copy;
+  GstBlockStore *store;
+  guint64 ring_buffer_guard;
+
   gint downstream_may_block;
 
   GstBufferingMode mode;
@@ -172,6 +180,11 @@ struct _GstQueue2
   gint avg_in;
   gint avg_out;
   GMutex buffering_post_lock; /* assures only one posted at a time */
+
+  /* shared memory limit, the client is accounted with the lock held */
+  GstMemoryBudget *budget;
+  GstMemoryBudgetClient *budget_client;
+  guint budget_priority;
 };
 
 struct _GstQueue2Class
@@ -35,6 +35,13 @@
  * provide separate threads for each branch. Otherwise a blocked dataflow in one
  * branch would stall the other branches.
  *
+ * Alternatively, with #GstTee:parallel set to %TRUE, tee queues the data for
+ * every branch itself and pushes it from the threads of a shared
+ * #GstTaskPool, so that the branches run concurrently without needing a
+ * dedicated thread each. The queue of every branch is limited by
+ * #GstTee:max-size-buffers and #GstTee:leaky configures what happens when a
+ * branch does not keep up.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 filesrc location=song.ogg ! decodebin ! tee name=t ! queue ! audioconvert ! audioresample ! autoaudiosink t. ! queue ! audioconvert ! goom ! videoconvert ! autovideosink
@@ -43,6 +50,13 @@
  * Play song.ogg audio file which must be in the current working directory
  * and render visualisations using the goom element (this can be easier done
  * using the playbin element, this is just an example pipeline).
+ *
+ * |[
+ * gst-launch-1.0 videotestsrc ! tee parallel=true leaky=downstream name=t ! x264enc ! fakesink t. ! autovideosink
+ * ]|
+ *
+ * Encode and display a test video without queues, the display branch does
+ * not wait for the encoder and the encoder drops frames it can't keep up with.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -82,12 +96,38 @@ gst_tee_pull_mode_get_type (void)
   return type;
 }
 
+#define GST_TYPE_TEE_LEAKY (gst_tee_leaky_get_type())
+static GType
+gst_tee_leaky_get_type (void)
+{
+  static GType type = 0;
+  static const GEnumValue data[] = {
+    {GST_TEE_NO_LEAK, "Not Leaky", "no"},
+    {GST_TEE_LEAK_UPSTREAM, "Leaky on upstream (new buffers)", "upstream"},
+    {GST_TEE_LEAK_DOWNSTREAM, "Leaky on downstream (old buffers)",
+        "downstream"},
+    {0, NULL, NULL},
+  };
+
+  if (!type) {
+    type = g_enum_register_static ("GstTeeLeaky", data);
+  }
+  return type;
+}
+
 #define DEFAULT_PROP_NUM_SRC_PADS	0
 #define DEFAULT_PROP_HAS_CHAIN		TRUE
 #define DEFAULT_PROP_SILENT		TRUE
 #define DEFAULT_PROP_LAST_MESSAGE	NULL
 #define DEFAULT_PULL_MODE		GST_TEE_PULL_MODE_NEVER
 #define DEFAULT_PROP_ALLOW_NOT_LINKED	FALSE
+#define DEFAULT_PROP_PARALLEL		FALSE
+#define DEFAULT_PROP_MAX_SIZE_BUFFERS	16
+#define DEFAULT_PROP_LEAKY		GST_TEE_NO_LEAK
+
+/* maximum number of items a branch pushes before giving the worker to the
+ * other branches in parallel mode */
+#define TEE_PAD_BATCH 16
 
 enum
 {
@@ -99,6 +139,10 @@ enum
   PROP_PULL_MODE,
   PROP_ALLOC_PAD,
   PROP_ALLOW_NOT_LINKED,
+  PROP_PARALLEL,
+  PROP_MAX_SIZE_BUFFERS,
+  PROP_LEAKY,
+  PROP_TASK_POOL,
 };
 
 static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src_%u",
@@ -141,6 +185,14 @@ struct _GstTeePad
   gboolean pushed;
   GstFlowReturn result;
   gboolean removed;
+
+  /* parallel mode, protected by the dispatch lock of the tee */
+  GstTee *tee;
+  GstVecDeque *queue;           /* buffers, buffer lists and events */
+  guint n_buffers;              /* buffers and lists in the queue */
+  gboolean scheduled;           /* a job is pushing the queue */
+  gboolean flushing;
+  GstFlowReturn last_result;
 };
 
 struct _GstTeePadClass
@@ -150,9 +202,25 @@ struct _GstTeePadClass
 
 G_DEFINE_TYPE (GstTeePad, gst_tee_pad, GST_TYPE_PAD);
 
+static void
+gst_tee_pad_finalize (GObject * object)
+{
+  GstTeePad *pad = GST_TEE_PAD_CAST (object);
+  GstMiniObject *item;
+
+  while ((item = gst_vec_deque_pop_head (pad->queue)))
+    gst_mini_object_unref (item);
+  gst_vec_deque_free (pad->queue);
+
+  G_OBJECT_CLASS (gst_tee_pad_parent_class)->finalize (object);
+}
+
 static void
 gst_tee_pad_class_init (GstTeePadClass * klass)
 {
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->finalize = gst_tee_pad_finalize;
 }
 
 static void
@@ -167,6 +235,9 @@ static void
 gst_tee_pad_init (GstTeePad * pad)
 {
   gst_tee_pad_reset (pad);
+
+  pad->queue = gst_vec_deque_new (TEE_PAD_BATCH);
+  pad->last_result = GST_FLOW_OK;
 }
 
 static GstPad *gst_tee_request_new_pad (GstElement * element,
@@ -225,6 +296,10 @@ gst_tee_finalize (GObject * object)
 
   g_free (tee->last_message);
 
+  gst_clear_object (&tee->task_pool);
+  g_mutex_clear (&tee->dispatch_lock);
+  g_cond_clear (&tee->dispatch_cond);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -288,6 +363,71 @@ gst_tee_class_init (GstTeeClass * klass)
           "all unlinked", DEFAULT_PROP_ALLOW_NOT_LINKED,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstTee:parallel
+   *
+   * Push to the branches concurrently from the threads of #GstTee:task-pool
+   * instead of one after the other from the upstream thread. Every branch
+   * gets its own queue, so that a slow branch does not delay the others and
+   * no queue element is needed after the tee.
+   *
+   * The flow return of tee is then combined from the results of the last
+   * pushes to the branches.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_PARALLEL,
+      g_param_spec_boolean ("parallel", "Parallel",
+          "Push to the branches concurrently from a pool of threads",
+          DEFAULT_PROP_PARALLEL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstTee:max-size-buffers
+   *
+   * The maximum number of buffers and buffer lists queued for each branch in
+   * parallel mode. Events are always queued.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_SIZE_BUFFERS,
+      g_param_spec_uint ("max-size-buffers", "Max. size (buffers)",
+          "Max. number of buffers queued for each branch in parallel mode "
+          "(0=disable)", 0, G_MAXUINT, DEFAULT_PROP_MAX_SIZE_BUFFERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
+
+  /**
+   * GstTee:leaky
+   *
+   * What to do when the queue of a branch is full in parallel mode.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_LEAKY,
+      g_param_spec_enum ("leaky", "Leaky",
+          "Where the queue of a branch leaks, if at all, in parallel mode",
+          GST_TYPE_TEE_LEAKY, DEFAULT_PROP_LEAKY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
+
+  /**
+   * GstTee:task-pool
+   *
+   * The #GstTaskPool used to push to the branches in parallel mode. The pool
+   * must be prepared by the application. When %NULL, a work-stealing pool
+   * shared by all tees is used.
+   *
+   * Since: 1.30
+   */
+  g_object_class_install_property (gobject_class, PROP_TASK_POOL,
+      g_param_spec_object ("task-pool", "Task Pool",
+          "The task pool used in parallel mode (NULL = shared default pool)",
+          GST_TYPE_TASK_POOL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "Tee pipe fitting",
       "Generic",
@@ -301,6 +441,7 @@ gst_tee_class_init (GstTeeClass * klass)
   gstelement_class->release_pad = GST_DEBUG_FUNCPTR (gst_tee_release_pad);
 
   gst_type_mark_as_plugin_api (GST_TYPE_TEE_PULL_MODE, 0);
+  gst_type_mark_as_plugin_api (GST_TYPE_TEE_LEAKY, 0);
 }
 
 static void
@@ -324,6 +465,11 @@ gst_tee_init (GstTee * tee)
   tee->pad_indexes = g_hash_table_new (NULL, NULL);
 
   tee->last_message = NULL;
+
+  tee->max_size_buffers = DEFAULT_PROP_MAX_SIZE_BUFFERS;
+  tee->leaky = DEFAULT_PROP_LEAKY;
+  g_mutex_init (&tee->dispatch_lock);
+  g_cond_init (&tee->dispatch_cond);
 }
 
 static void
@@ -390,6 +536,7 @@ gst_tee_request_new_pad (GstElement * element, GstPadTemplate * templ,
           "name", name, "direction", templ->direction, "template", templ,
           NULL));
   GST_TEE_PAD_CAST (srcpad)->index = index;
+  GST_TEE_PAD_CAST (srcpad)->tee = tee;
   g_free (name);
 
   mode = tee->sink_mode;
@@ -508,6 +655,25 @@ gst_tee_set_property (GObject * object, guint prop_id, const GValue * value,
     case PROP_ALLOW_NOT_LINKED:
       tee->allow_not_linked = g_value_get_boolean (value);
       break;
+    case PROP_PARALLEL:
+      tee->parallel = g_value_get_boolean (value);
+      break;
+    case PROP_MAX_SIZE_BUFFERS:
+      g_mutex_lock (&tee->dispatch_lock);
+      tee->max_size_buffers = g_value_get_uint (value);
+      g_cond_broadcast (&tee->dispatch_cond);
+      g_mutex_unlock (&tee->dispatch_lock);
+      break;
+    case PROP_LEAKY:
+      g_mutex_lock (&tee->dispatch_lock);
+      tee->leaky = (GstTeeLeaky) g_value_get_enum (value);
+      g_cond_broadcast (&tee->dispatch_cond);
+      g_mutex_unlock (&tee->dispatch_lock);
+      break;
+    case PROP_TASK_POOL:
+      gst_object_replace ((GstObject **) & tee->task_pool,
+          g_value_get_object (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -544,6 +710,18 @@ gst_tee_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_ALLOW_NOT_LINKED:
       g_value_set_boolean (value, tee->allow_not_linked);
       break;
+    case PROP_PARALLEL:
+      g_value_set_boolean (value, tee->parallel);
+      break;
+    case PROP_MAX_SIZE_BUFFERS:
+      g_value_set_uint (value, tee->max_size_buffers);
+      break;
+    case PROP_LEAKY:
+      g_value_set_enum (value, tee->leaky);
+      break;
+    case PROP_TASK_POOL:
+      g_value_set_object (value, tee->task_pool);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -551,15 +729,383 @@ gst_tee_get_property (GObject * object, guint prop_id, GValue * value,
   GST_OBJECT_UNLOCK (tee);
 }
 
+/* Parallel mode: every src pad queues the items for its branch and a job on
+ * the task pool pushes them, so that the branches don't wait for each other.
+ * Only one job per pad is scheduled at a time to keep the items in order. */
+
+static GstTaskPool *
+gst_tee_get_default_task_pool (void)
+{
+  static gsize initialized = 0;
+  static GstTaskPool *pool = NULL;
+
+  if (g_once_init_enter (&initialized)) {
+    GError *err = NULL;
+
+    pool = gst_work_stealing_task_pool_new (0);
+    gst_task_pool_prepare (pool, &err);
+    if (err) {
+      GST_WARNING ("failed to prepare the default task pool: %s",
+          err->message);
+      g_clear_error (&err);
+    }
+
+    /* Shared by all tees for the lifetime of the process */
+    GST_OBJECT_FLAG_SET (pool, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+    g_once_init_leave (&initialized, 1);
+  }
+
+  return pool;
+}
+
+static void gst_tee_pad_run (GstTeePad * pad);
+
+/* the caller marked @pad as scheduled */
+static void
+gst_tee_pad_start (GstTee * tee, GstTeePad * pad)
+{
+  GstTaskPool *pool;
+  GError *err = NULL;
+  gpointer id;
+
+  GST_OBJECT_LOCK (tee);
+  if (tee->task_pool)
+    pool = gst_object_ref (tee->task_pool);
+  else
+    pool = gst_object_ref (gst_tee_get_default_task_pool ());
+  GST_OBJECT_UNLOCK (tee);
+
+  /* released by the job */
+  gst_object_ref (tee);
+  gst_object_ref (pad);
+
+  id = gst_task_pool_push (pool, (GstTaskPoolFunction) gst_tee_pad_run, pad,
+      &err);
+  if (G_UNLIKELY (err)) {
+    GST_WARNING_OBJECT (pad, "failed to push job, pushing from this thread: "
+        "%s", err->message);
+    g_clear_error (&err);
+    gst_tee_pad_run (pad);
+  } else if (id) {
+    gst_task_pool_dispose_handle (pool, id);
+  }
+
+  gst_object_unref (pool);
+}
+
+static void
+gst_tee_pad_run (GstTeePad * pad)
+{
+  GstTee *tee = pad->tee;
+  GstMiniObject *item;
+  gboolean again;
+  guint n;
+
+  g_mutex_lock (&tee->dispatch_lock);
+  for (n = 0; n < TEE_PAD_BATCH; n++) {
+    GstFlowReturn ret = GST_FLOW_OK;
+    gboolean is_data;
+
+    item = gst_vec_deque_pop_head (pad->queue);
+    if (!item)
+      break;
+
+    is_data = !GST_IS_EVENT (item);
+    if (is_data)
+      pad->n_buffers--;
+    /* wake up upstream waiting for space */
+    g_cond_broadcast (&tee->dispatch_cond);
+    g_mutex_unlock (&tee->dispatch_lock);
+
+    GST_LOG_OBJECT (pad, "pushing %" GST_PTR_FORMAT, item);
+
+    if (GST_IS_BUFFER (item)) {
+      ret = gst_pad_push (GST_PAD_CAST (pad), GST_BUFFER_CAST (item));
+    } else if (GST_IS_BUFFER_LIST (item)) {
+      ret = gst_pad_push_list (GST_PAD_CAST (pad),
+          GST_BUFFER_LIST_CAST (item));
+    } else {
+      gst_pad_push_event (GST_PAD_CAST (pad), GST_EVENT_CAST (item));
+    }
+
+    g_mutex_lock (&tee->dispatch_lock);
+    if (is_data && !pad->flushing) {
+      GST_LOG_OBJECT (pad, "pushing yielded result %s",
+          gst_flow_get_name (ret));
+      pad->last_result = ret;
+    }
+  }
+
+  /* give the other branches a turn before pushing the rest */
+  again = !gst_vec_deque_is_empty (pad->queue);
+  if (!again) {
+    pad->scheduled = FALSE;
+    g_cond_broadcast (&tee->dispatch_cond);
+  }
+  g_mutex_unlock (&tee->dispatch_lock);
+
+  if (again)
+    gst_tee_pad_start (tee, pad);
+
+  gst_object_unref (pad);
+  gst_object_unref (tee);
+}
+
+/* with the dispatch lock */
+static void
+gst_tee_pad_drop_oldest (GstTeePad * pad)
+{
+  gsize i, len;
+
+  len = gst_vec_deque_get_length (pad->queue);
+  for (i = 0; i < len; i++) {
+    GstMiniObject *item = gst_vec_deque_peek_nth (pad->queue, i);
+
+    /* events are never dropped */
+    if (GST_IS_EVENT (item))
+      continue;
+
+    GST_LOG_OBJECT (pad, "queue is full, dropping old %" GST_PTR_FORMAT,
+        item);
+    gst_vec_deque_drop_element (pad->queue, i);
+    gst_mini_object_unref (item);
+    pad->n_buffers--;
+    return;
+  }
+}
+
+/* takes ownership of @item */
+static void
+gst_tee_pad_enqueue (GstTee * tee, GstTeePad * pad, GstMiniObject * item)
+{
+  gboolean start = FALSE;
+
+  g_mutex_lock (&tee->dispatch_lock);
+  if (G_UNLIKELY (pad->flushing))
+    goto flushing;
+
+  if (!GST_IS_EVENT (item)) {
+    while (tee->max_size_buffers > 0
+        && pad->n_buffers >= tee->max_size_buffers) {
+      if (tee->leaky == GST_TEE_LEAK_UPSTREAM) {
+        GST_LOG_OBJECT (pad, "queue is full, dropping new %" GST_PTR_FORMAT,
+            item);
+        goto dropped;
+      } else if (tee->leaky == GST_TEE_LEAK_DOWNSTREAM) {
+        gst_tee_pad_drop_oldest (pad);
+      } else {
+        GST_LOG_OBJECT (pad, "queue is full, waiting for space");
+        gst_task_pool_blocking_begin ();
+        g_cond_wait (&tee->dispatch_cond, &tee->dispatch_lock);
+        gst_task_pool_blocking_end ();
+        if (G_UNLIKELY (pad->flushing))
+          goto flushing;
+      }
+    }
+    pad->n_buffers++;
+  }
+
+  gst_vec_deque_push_tail (pad->queue, item);
+  if (!pad->scheduled) {
+    pad->scheduled = TRUE;
+    start = TRUE;
+  }
+  g_mutex_unlock (&tee->dispatch_lock);
+
+  if (start)
+    gst_tee_pad_start (tee, pad);
+
+  return;
+
+  /* ERRORS */
+flushing:
+  {
+    GST_LOG_OBJECT (pad, "pad is flushing, dropping %" GST_PTR_FORMAT, item);
+    goto dropped;
+  }
+dropped:
+  {
+    g_mutex_unlock (&tee->dispatch_lock);
+    gst_mini_object_unref (item);
+    return;
+  }
+}
+
+/* When flushing the queue of @pad is cleared. Unless @full, sticky events are
+ * stored on the pad like when they would have been pushed. */
+static void
+gst_tee_pad_set_flushing (GstTee * tee, GstTeePad * pad, gboolean flushing,
+    gboolean full)
+{
+  GstMiniObject *item;
+
+  g_mutex_lock (&tee->dispatch_lock);
+  pad->flushing = flushing;
+  if (flushing) {
+    while ((item = gst_vec_deque_pop_head (pad->queue))) {
+      if (!full && GST_IS_EVENT (item) && GST_EVENT_IS_STICKY (item)
+          && GST_EVENT_TYPE (item) != GST_EVENT_SEGMENT
+          && GST_EVENT_TYPE (item) != GST_EVENT_EOS) {
+        gst_pad_store_sticky_event (GST_PAD_CAST (pad), GST_EVENT_CAST (item));
+      }
+      gst_mini_object_unref (item);
+    }
+    pad->n_buffers = 0;
+    g_cond_broadcast (&tee->dispatch_cond);
+  } else {
+    pad->last_result = GST_FLOW_OK;
+  }
+  g_mutex_unlock (&tee->dispatch_lock);
+}
+
+/* returns the src pads with a ref, without the pad we are pulling from when
+ * @with_pull_pad is %FALSE */
+static GList *
+gst_tee_get_src_pads (GstTee * tee, gboolean with_pull_pad)
+{
+  GList *l, *pads = NULL;
+
+  GST_OBJECT_LOCK (tee);
+  for (l = GST_ELEMENT_CAST (tee)->srcpads; l; l = l->next) {
+    if (!with_pull_pad && l->data == tee->pull_pad)
+      continue;
+    pads = g_list_prepend (pads, gst_object_ref (l->data));
+  }
+  GST_OBJECT_UNLOCK (tee);
+
+  return g_list_reverse (pads);
+}
+
+static void
+gst_tee_set_flushing (GstTee * tee, gboolean flushing, gboolean full)
+{
+  GList *l, *pads;
+
+  pads = gst_tee_get_src_pads (tee, TRUE);
+  for (l = pads; l; l = l->next)
+    gst_tee_pad_set_flushing (tee, l->data, flushing, full);
+  g_list_free_full (pads, gst_object_unref);
+}
+
+/* wait until all branches pushed their queued items */
+static void
+gst_tee_wait_idle (GstTee * tee)
+{
+  GList *l, *pads;
+
+  pads = gst_tee_get_src_pads (tee, TRUE);
+
+  g_mutex_lock (&tee->dispatch_lock);
+  for (l = pads; l; l = l->next) {
+    GstTeePad *pad = l->data;
+
+    while (pad->scheduled) {
+      GST_LOG_OBJECT (pad, "waiting for the branch to be idle");
+      gst_task_pool_blocking_begin ();
+      g_cond_wait (&tee->dispatch_cond, &tee->dispatch_lock);
+      gst_task_pool_blocking_end ();
+    }
+  }
+  g_mutex_unlock (&tee->dispatch_lock);
+
+  g_list_free_full (pads, gst_object_unref);
+}
+
+static gboolean
+gst_tee_dispatch_event (GstTee * tee, GstEvent * event)
+{
+  GList *l, *pads;
+
+  pads = gst_tee_get_src_pads (tee, TRUE);
+  for (l = pads; l; l = l->next)
+    gst_tee_pad_enqueue (tee, l->data, (GstMiniObject *) gst_event_ref (event));
+  g_list_free_full (pads, gst_object_unref);
+
+  gst_event_unref (event);
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_tee_dispatch_data (GstTee * tee, gpointer data, gboolean is_list)
+{
+  GList *l, *pads;
+  GstFlowReturn ret, cret;
+
+  pads = gst_tee_get_src_pads (tee, FALSE);
+  if (G_UNLIKELY (!pads))
+    goto no_pads;
+
+  for (l = pads; l; l = l->next) {
+    GST_LOG_OBJECT (l->data, "queueing %s %p", is_list ? "list" : "buffer",
+        data);
+    gst_tee_pad_enqueue (tee, l->data,
+        gst_mini_object_ref (GST_MINI_OBJECT_CAST (data)));
+  }
+  gst_mini_object_unref (GST_MINI_OBJECT_CAST (data));
+
+  /* combine the results of the last pushes like in the sequential case */
+  cret = tee->allow_not_linked ? GST_FLOW_OK : GST_FLOW_NOT_LINKED;
+
+  g_mutex_lock (&tee->dispatch_lock);
+  for (l = pads; l; l = l->next) {
+    GstTeePad *pad = l->data;
+
+    ret = pad->flushing ? GST_FLOW_FLUSHING : pad->last_result;
+    if (G_UNLIKELY (ret != GST_FLOW_OK && ret != GST_FLOW_NOT_LINKED)) {
+      GST_DEBUG_OBJECT (pad, "branch returned %s", gst_flow_get_name (ret));
+      cret = ret;
+      break;
+    }
+    if (G_LIKELY (ret != GST_FLOW_NOT_LINKED))
+      cret = ret;
+  }
+  g_mutex_unlock (&tee->dispatch_lock);
+
+  g_list_free_full (pads, gst_object_unref);
+
+  return cret;
+
+  /* ERRORS */
+no_pads:
+  {
+    gst_mini_object_unref (GST_MINI_OBJECT_CAST (data));
+    if (tee->allow_not_linked) {
+      GST_DEBUG_OBJECT (tee, "there are no pads, dropping %s",
+          is_list ? "buffer-list" : "buffer");
+      return GST_FLOW_OK;
+    }
+    GST_DEBUG_OBJECT (tee, "there are no pads, return not-linked");
+    return GST_FLOW_NOT_LINKED;
+  }
+}
+
 static gboolean
 gst_tee_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
+  GstTee *tee = GST_TEE (parent);
   gboolean res;
 
   switch (GST_EVENT_TYPE (event)) {
-    default:
+    case GST_EVENT_FLUSH_START:
+      if (tee->parallel)
+        gst_tee_set_flushing (tee, TRUE, FALSE);
+      res = gst_pad_event_default (pad, parent, event);
+      break;
+    case GST_EVENT_FLUSH_STOP:
+      if (tee->parallel) {
+        gst_tee_wait_idle (tee);
+        gst_tee_set_flushing (tee, FALSE, FALSE);
+      }
       res = gst_pad_event_default (pad, parent, event);
       break;
+    default:
+      /* keep serialized events in order with the data of each branch */
+      if (tee->parallel && GST_EVENT_IS_SERIALIZED (event))
+        res = gst_tee_dispatch_event (tee, event);
+      else
+        res = gst_pad_event_default (pad, parent, event);
+      break;
   }
 
   return res;
@@ -750,6 +1296,10 @@ gst_tee_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
   GstTee *tee = GST_TEE (parent);
   gboolean res;
 
+  /* answer serialized queries after the queued items were pushed */
+  if (tee->parallel && GST_QUERY_IS_SERIALIZED (query))
+    gst_tee_wait_idle (tee);
+
   switch (GST_QUERY_TYPE (query)) {
     case GST_QUERY_ALLOCATION:
     {
@@ -886,6 +1436,9 @@ gst_tee_handle_data (GstTee * tee, gpointer data, gboolean is_list)
   if (G_UNLIKELY (!tee->silent))
     gst_tee_do_message (tee, tee->sinkpad, data, is_list);
 
+  if (tee->parallel)
+    return gst_tee_dispatch_data (tee, data, is_list);
+
   GST_OBJECT_LOCK (tee);
   pads = GST_ELEMENT_CAST (tee)->srcpads;
 
@@ -1076,6 +1629,10 @@ gst_tee_sink_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
       if (active && !tee->has_chain)
         goto no_chain;
       GST_OBJECT_UNLOCK (tee);
+
+      /* unblock upstream waiting for space in the queue of a branch */
+      if (tee->parallel)
+        gst_tee_set_flushing (tee, !active, TRUE);
       res = TRUE;
       break;
     }
@@ -1138,6 +1695,11 @@ gst_tee_src_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
       GST_OBJECT_UNLOCK (tee);
       break;
     }
+    case GST_PAD_MODE_PUSH:
+      if (tee->parallel)
+        gst_tee_pad_set_flushing (tee, GST_TEE_PAD_CAST (pad), !active, TRUE);
+      res = TRUE;
+      break;
     default:
       res = TRUE;
       break;
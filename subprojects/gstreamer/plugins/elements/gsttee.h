@@ -57,6 +57,24 @@ typedef enum {
   GST_TEE_PULL_MODE_SINGLE,
 } GstTeePullMode;
 
+/**
+ * GstTeeLeaky:
+ * @GST_TEE_NO_LEAK: Wait until there is space in the queue of the branch.
+ * @GST_TEE_LEAK_UPSTREAM: Drop new buffers when the queue of a branch is full.
+ * @GST_TEE_LEAK_DOWNSTREAM: Drop the oldest buffers when the queue of a
+ *   branch is full.
+ *
+ * What tee does with buffers for a branch that is not keeping up in parallel
+ * mode.
+ *
+ * Since: 1.30
+ */
+typedef enum {
+  GST_TEE_NO_LEAK,
+  GST_TEE_LEAK_UPSTREAM,
+  GST_TEE_LEAK_DOWNSTREAM,
+} GstTeeLeaky;
+
 /**
  * GstTee:
  *
@@ -81,6 +99,17 @@ struct _GstTee {
   GstPad         *pull_pad;
 
   gboolean        allow_not_linked;
+
+  /* parallel mode */
+  gboolean        parallel;
+  guint           max_size_buffers;
+  GstTeeLeaky     leaky;
+  GstTaskPool    *task_pool;
+
+  /* protects the queues of the src pads, signalled when an item was taken
+   * from a queue or a branch became idle */
+  GMutex          dispatch_lock;
+  GCond           dispatch_cond;
 };
 
 struct _GstTeeClass {
@@ -0,0 +1,1010 @@
+/* GStreamer
+ *
+ * gsthistogram.c: tracing module that keeps per-pad histograms
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:tracer-histogram
+ * @short_description: keep per-pad processing time and throughput histograms
+ *
+ * A tracing module that keeps log-linear histograms per pad in memory instead
+ * of logging a line per buffer like the `stats` and `latency` tracers do. The
+ * buckets have a relative precision of 12.5% and are updated with atomic
+ * increments only, which makes it cheap enough to stay enabled on live
+ * systems.
+ *
+ * The following distributions can be recorded, selected with the `flags`
+ * parameter:
+ *
+ * - `processing-time`: the time spent in the chain or getrange function
+ *   behind a pad, without the time spent pushing further downstream. It is
+ *   recorded on the pad receiving the data.
+ * - `gap`: the time between two buffers or buffer lists on a source pad.
+ * - `residency`: the time a buffer stayed in an element before the element
+ *   pushed it out again, e.g. the time spent in a queue. It is recorded on
+ *   the source pad of the element. This requires attaching data to every
+ *   buffer and is not enabled by default.
+ * - `size`: the buffer sizes in bytes on a source pad.
+ *
+ * When the `interval` parameter is set, a `pad-histogram` tracer event with
+ * the count, min, mean, median, p90, p99, p99.9 and max of every non-empty
+ * histogram is emitted every `interval` milliseconds and the histograms are
+ * reset afterwards. The events are rendered into the `GST_TRACER` debug
+ * category by the automatically enabled `log` tracer:
+ *
+ * ```
+ * GST_TRACERS="histogram(interval=1000)" GST_DEBUG=GST_TRACER:7 ./...
+ * ```
+ *
+ * Applications can instead fetch the current summaries at any time with the
+ * #GstHistogramTracer::get-histograms action signal. Use
+ * gst_tracing_get_active_tracers() to find the tracer.
+ *
+ * Since: 1.30
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gsthistogram.h"
+
+#include <string.h>
+
+GST_DEBUG_CATEGORY_STATIC (gst_histogram_debug);
+#define GST_CAT_DEFAULT gst_histogram_debug
+
+enum
+{
+  /* actions */
+  SIGNAL_GET_HISTOGRAMS,
+  SIGNAL_LOG_HISTOGRAMS,
+  SIGNAL_RESET_HISTOGRAMS,
+
+  LAST_SIGNAL
+};
+
+enum
+{
+  PROP_0,
+  PROP_FLAGS,
+  PROP_INTERVAL,
+  PROP_LAST
+};
+
+#define DEFAULT_FLAGS (GST_HISTOGRAM_TRACER_FLAG_PROCESSING_TIME | \
+    GST_HISTOGRAM_TRACER_FLAG_GAP | GST_HISTOGRAM_TRACER_FLAG_SIZE)
+#define DEFAULT_INTERVAL 0
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_histogram_debug, "histogram", 0, \
+        "histogram tracer");
+#define gst_histogram_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstHistogramTracer, gst_histogram_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+static guint gst_histogram_tracer_signals[LAST_SIGNAL] = { 0 };
+
+static GstTraceFormat *tr_histogram;
+
+/* protects the pads list of all instances and PadHistograms.tracer */
+G_LOCK_DEFINE_STATIC (histograms);
+
+/* the order matches the GstHistogramTracerFlags */
+typedef enum
+{
+  METRIC_PROCESSING_TIME,
+  METRIC_GAP,
+  METRIC_RESIDENCY,
+  METRIC_SIZE,
+  N_METRICS
+} Metric;
+
+static const gchar *metric_names[N_METRICS] = {
+  "processing-time", "gap", "residency", "size"
+};
+
+/* histograms */
+
+/* Values below 2 * HISTOGRAM_SUB_COUNT get a bucket each, above that every
+ * power of two is split into HISTOGRAM_SUB_COUNT linear sub-buckets. */
+#define HISTOGRAM_SUB_BITS 3
+#define HISTOGRAM_SUB_COUNT (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_N_BUCKETS \
+    ((64 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_COUNT)
+
+/* 64-bit counters, 32-bit ones wrap after a few hours of per-buffer
+ * recording at high packet rates */
+typedef struct
+{
+  guint64 buckets[HISTOGRAM_N_BUCKETS];
+} Histogram;
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+static inline void
+histogram_counter_inc (guint64 * counter)
+{
+  atomic_fetch_add_explicit ((_Atomic guint64 *) counter, 1,
+      memory_order_relaxed);
+}
+
+static inline guint64
+histogram_counter_get (guint64 * counter, gboolean reset)
+{
+  if (reset)
+    return atomic_exchange ((_Atomic guint64 *) counter, 0);
+  return atomic_load ((_Atomic guint64 *) counter);
+}
+#elif defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+static inline void
+histogram_counter_inc (guint64 * counter)
+{
+  __sync_fetch_and_add (counter, 1);
+}
+
+static inline guint64
+histogram_counter_get (guint64 * counter, gboolean reset)
+{
+  if (reset)
+    return __sync_fetch_and_and (counter, 0);
+  return __sync_fetch_and_add (counter, 0);
+}
+#elif defined (G_PLATFORM_WIN32)
+#include <windows.h>
+static inline void
+histogram_counter_inc (guint64 * counter)
+{
+  InterlockedIncrement64 ((LONGLONG *) counter);
+}
+
+static inline guint64
+histogram_counter_get (guint64 * counter, gboolean reset)
+{
+  if (reset)
+    return InterlockedExchange64 ((LONGLONG *) counter, 0);
+  return InterlockedCompareExchange64 ((LONGLONG *) counter, 0, 0);
+}
+#else
+G_LOCK_DEFINE_STATIC (histogram_counter);
+static inline void
+histogram_counter_inc (guint64 * counter)
+{
+  G_LOCK (histogram_counter);
+  (*counter)++;
+  G_UNLOCK (histogram_counter);
+}
+
+static inline guint64
+histogram_counter_get (guint64 * counter, gboolean reset)
+{
+  guint64 ret;
+
+  G_LOCK (histogram_counter);
+  ret = *counter;
+  if (reset)
+    *counter = 0;
+  G_UNLOCK (histogram_counter);
+
+  return ret;
+}
+#endif
+
+typedef struct
+{
+  guint64 count;
+  guint64 min;
+  guint64 mean;
+  guint64 p50;
+  guint64 p90;
+  guint64 p99;
+  guint64 p999;
+  guint64 max;
+} HistogramSummary;
+
+static inline guint
+histogram_bucket_index (guint64 value)
+{
+  guint msb, shift;
+
+  if (value < 2 * HISTOGRAM_SUB_COUNT)
+    return value;
+
+  if (value >> 32)
+    msb = 32 + g_bit_nth_msf ((gulong) (value >> 32), -1);
+  else
+    msb = g_bit_nth_msf ((gulong) value, -1);
+
+  shift = msb - HISTOGRAM_SUB_BITS;
+  return (shift + 1) * HISTOGRAM_SUB_COUNT +
+      ((value >> shift) & (HISTOGRAM_SUB_COUNT - 1));
+}
+
+static guint64
+histogram_bucket_lower (guint index)
+{
+  guint shift;
+
+  if (index < 2 * HISTOGRAM_SUB_COUNT)
+    return index;
+
+  shift = index / HISTOGRAM_SUB_COUNT - 1;
+  return ((guint64) (HISTOGRAM_SUB_COUNT + index % HISTOGRAM_SUB_COUNT)) <<
+      shift;
+}
+
+static guint64
+histogram_bucket_upper (guint index)
+{
+  guint shift;
+
+  if (index < 2 * HISTOGRAM_SUB_COUNT)
+    return index;
+
+  shift = index / HISTOGRAM_SUB_COUNT - 1;
+  return histogram_bucket_lower (index) + ((G_GUINT64_CONSTANT (1) << shift) -
+      1);
+}
+
+static inline void
+histogram_record (Histogram * hist, guint64 value)
+{
+  histogram_counter_inc (&hist->buckets[histogram_bucket_index (value)]);
+}
+
+/* Percentiles report the upper bound of the bucket they fall into, so they
+ * never under-estimate. */
+static gboolean
+histogram_summarize (Histogram * hist, gboolean reset, HistogramSummary * s)
+{
+  static const guint permille[] = { 500, 900, 990, 999 };
+  guint64 *percentiles[] = { &s->p50, &s->p90, &s->p99, &s->p999 };
+  guint64 counts[HISTOGRAM_N_BUCKETS];
+  guint64 ranks[G_N_ELEMENTS (permille)];
+  guint64 count = 0, seen = 0;
+  gdouble sum = 0.0;
+  guint i, p = 0;
+
+  /* take a consistent-enough copy first, new values may still come in */
+  for (i = 0; i < HISTOGRAM_N_BUCKETS; i++) {
+    counts[i] = histogram_counter_get (&hist->buckets[i], reset);
+
+    if (counts[i] == 0)
+      continue;
+
+    count += counts[i];
+    sum += counts[i] * (histogram_bucket_lower (i) / 2.0 +
+        histogram_bucket_upper (i) / 2.0);
+  }
+
+  if (count == 0)
+    return FALSE;
+
+  memset (s, 0, sizeof (HistogramSummary));
+  s->count = count;
+  s->mean = sum / count;
+  for (i = 0; i < G_N_ELEMENTS (permille); i++)
+    ranks[i] = MAX ((count * permille[i] + 999) / 1000, 1);
+
+  for (i = 0; i < HISTOGRAM_N_BUCKETS; i++) {
+    if (counts[i] == 0)
+      continue;
+
+    if (seen == 0)
+      s->min = histogram_bucket_lower (i);
+    seen += counts[i];
+    s->max = histogram_bucket_upper (i);
+
+    while (p < G_N_ELEMENTS (permille) && seen >= ranks[p])
+      *percentiles[p++] = s->max;
+  }
+
+  return TRUE;
+}
+
+static void
+histogram_reset (Histogram * hist)
+{
+  guint i;
+
+  for (i = 0; i < HISTOGRAM_N_BUCKETS; i++)
+    histogram_counter_get (&hist->buckets[i], TRUE);
+}
+
+/* data helpers */
+
+typedef struct
+{
+  /* NULL once the tracer is gone */
+  GstHistogramTracer *tracer;
+  /* copied when the pad is first seen, the pad might be finalizing while we
+   * produce summaries */
+  gchar *element_name;
+  gchar *pad_name;
+  /* only touched from the streaming thread */
+  GstClockTime last_ts;
+  Histogram metrics[N_METRICS];
+} PadHistograms;
+
+/* where and when a buffer arrived, attached to the buffer */
+typedef struct
+{
+  GstElement *element;
+  GstClockTime ts;
+} BufferArrival;
+
+/* a push or pull in progress on the current thread */
+typedef struct
+{
+  GstHistogramTracer *tracer;
+  PadHistograms *peer;
+  GstClockTime start;
+  /* time spent in nested pushes and pulls */
+  GstClockTime children;
+} PadCall;
+
+static GPrivate pad_calls = G_PRIVATE_INIT ((GDestroyNotify) g_array_unref);
+
+/*
+ * Get the element/bin owning the pad.
+ *
+ * in: a normal pad
+ * out: the element
+ *
+ * in: a proxy pad
+ * out: the element that contains the peer of the proxy
+ *
+ * in: a ghost pad
+ * out: the bin owning the ghostpad
+ */
+static GstElement *
+get_real_pad_parent (GstPad * pad)
+{
+  GstObject *parent;
+
+  if (!pad)
+    return NULL;
+
+  parent = GST_OBJECT_PARENT (pad);
+
+  /* if parent of pad is a ghost-pad, then pad is a proxy_pad */
+  if (parent && GST_IS_GHOST_PAD (parent)) {
+    pad = GST_PAD_CAST (parent);
+    parent = GST_OBJECT_PARENT (pad);
+  }
+  return GST_ELEMENT_CAST (parent);
+}
+
+static void
+pad_histograms_free (gpointer user_data)
+{
+  PadHistograms *data = user_data;
+
+  G_LOCK (histograms);
+  if (data->tracer)
+    data->tracer->pads = g_list_remove (data->tracer->pads, data);
+  G_UNLOCK (histograms);
+
+  g_free (data->element_name);
+  g_free (data->pad_name);
+  g_free (data);
+}
+
+static PadHistograms *
+get_pad_histograms (GstHistogramTracer * self, GstPad * pad)
+{
+  PadHistograms *data;
+
+  data = g_object_get_qdata ((GObject *) pad, self->quark);
+  if (G_LIKELY (data))
+    return data;
+
+  G_LOCK (histograms);
+  if (!(data = g_object_get_qdata ((GObject *) pad, self->quark))) {
+    GstElement *parent = get_real_pad_parent (pad);
+
+    data = g_new0 (PadHistograms, 1);
+    data->tracer = self;
+    data->element_name = g_strdup (parent ? GST_OBJECT_NAME (parent) : "");
+    data->pad_name = g_strdup (GST_OBJECT_NAME (pad));
+    data->last_ts = GST_CLOCK_TIME_NONE;
+    g_object_set_qdata_full ((GObject *) pad, self->quark, data,
+        pad_histograms_free);
+    self->pads = g_list_prepend (self->pads, data);
+  }
+  G_UNLOCK (histograms);
+
+  return data;
+}
+
+static void
+log_histograms (GstHistogramTracer * self, GstClockTime ts, gboolean reset)
+{
+  GList *l;
+  guint i;
+
+  G_LOCK (histograms);
+  for (l = self->pads; l; l = l->next) {
+    PadHistograms *data = l->data;
+
+    for (i = 0; i < N_METRICS; i++) {
+      HistogramSummary s;
+
+      if (!histogram_summarize (&data->metrics[i], reset, &s))
+        continue;
+
+      gst_trace_event (tr_histogram,
+          GST_TRACE_VALUES (STRING (data->element_name),
+              STRING (data->pad_name), STRING (metric_names[i]),
+              UINT64 (s.count), UINT64 (s.min), UINT64 (s.mean),
+              UINT64 (s.p50), UINT64 (s.p90), UINT64 (s.p99),
+              UINT64 (s.p999), UINT64 (s.max), UINT64 (ts)));
+    }
+  }
+  G_UNLOCK (histograms);
+}
+
+static inline void
+maybe_log_histograms (GstHistogramTracer * self, GstClockTime ts)
+{
+  /* unlocked read, re-checked below */
+  if (self->interval == 0 || ts < self->next_log)
+    return;
+
+  /* somebody else is already at it */
+  if (!g_mutex_trylock (&self->log_lock))
+    return;
+
+  if (ts >= self->next_log) {
+    self->next_log = ts + self->interval * GST_MSECOND;
+    log_histograms (self, ts, TRUE);
+  }
+  g_mutex_unlock (&self->log_lock);
+}
+
+static inline void
+record_gap (GstHistogramTracer * self, PadHistograms * data, GstClockTime ts)
+{
+  if (!(self->flags & GST_HISTOGRAM_TRACER_FLAG_GAP))
+    return;
+
+  if (GST_CLOCK_TIME_IS_VALID (data->last_ts) && ts >= data->last_ts)
+    histogram_record (&data->metrics[METRIC_GAP], ts - data->last_ts);
+  data->last_ts = ts;
+}
+
+/* remember that @buffer entered the element behind the peer of @pad */
+static void
+mark_arrival (GstHistogramTracer * self, GstPad * pad, GstBuffer * buffer,
+    GstClockTime ts)
+{
+  GstElement *element = get_real_pad_parent (GST_PAD_PEER (pad));
+  BufferArrival *arrival;
+
+  /* the buffer might be shared with other branches, e.g. after a tee */
+  if (!element || !gst_buffer_is_writable (buffer))
+    return;
+
+  arrival = gst_mini_object_get_qdata (GST_MINI_OBJECT_CAST (buffer),
+      self->quark);
+  if (!arrival) {
+    arrival = g_new (BufferArrival, 1);
+    gst_mini_object_set_qdata (GST_MINI_OBJECT_CAST (buffer), self->quark,
+        arrival, g_free);
+  }
+  arrival->element = element;
+  arrival->ts = ts;
+}
+
+static void
+record_buffer (GstHistogramTracer * self, GstPad * pad, PadHistograms * data,
+    GstBuffer * buffer, GstClockTime ts)
+{
+  if (self->flags & GST_HISTOGRAM_TRACER_FLAG_SIZE)
+    histogram_record (&data->metrics[METRIC_SIZE],
+        gst_buffer_get_size (buffer));
+
+  if (self->flags & GST_HISTOGRAM_TRACER_FLAG_RESIDENCY) {
+    BufferArrival *arrival;
+
+    arrival = gst_mini_object_get_qdata (GST_MINI_OBJECT_CAST (buffer),
+        self->quark);
+    if (arrival && arrival->element == get_real_pad_parent (pad)
+        && ts >= arrival->ts)
+      histogram_record (&data->metrics[METRIC_RESIDENCY], ts - arrival->ts);
+
+    mark_arrival (self, pad, buffer, ts);
+  }
+}
+
+static void
+begin_pad_call (GstHistogramTracer * self, GstPad * peer, GstClockTime ts)
+{
+  GArray *calls;
+  PadCall call;
+
+  if (!(self->flags & GST_HISTOGRAM_TRACER_FLAG_PROCESSING_TIME))
+    return;
+
+  if (G_UNLIKELY (!(calls = g_private_get (&pad_calls)))) {
+    calls = g_array_new (FALSE, FALSE, sizeof (PadCall));
+    g_private_set (&pad_calls, calls);
+  }
+
+  call.tracer = self;
+  call.peer = peer ? get_pad_histograms (self, peer) : NULL;
+  call.start = ts;
+  call.children = 0;
+  g_array_append_val (calls, call);
+}
+
+static void
+end_pad_call (GstHistogramTracer * self, GstClockTime ts)
+{
+  GArray *calls;
+  PadCall *call;
+  GstClockTime total;
+  guint i, j;
+
+  if (!(self->flags & GST_HISTOGRAM_TRACER_FLAG_PROCESSING_TIME))
+    return;
+
+  if (!(calls = g_private_get (&pad_calls)))
+    return;
+
+  /* other tracer instances keep their calls on the same stack */
+  for (i = calls->len; i > 0; i--) {
+    if (g_array_index (calls, PadCall, i - 1).tracer == self)
+      break;
+  }
+  if (i == 0)
+    return;
+  call = &g_array_index (calls, PadCall, i - 1);
+
+  total = ts > call->start ? ts - call->start : 0;
+  if (call->peer)
+    histogram_record (&call->peer->metrics[METRIC_PROCESSING_TIME],
+        total > call->children ? total - call->children : 0);
+
+  /* the caller spent all of that time downstream */
+  for (j = i - 1; j > 0; j--) {
+    PadCall *caller = &g_array_index (calls, PadCall, j - 1);
+
+    if (caller->tracer == self) {
+      caller->children += total;
+      break;
+    }
+  }
+
+  g_array_remove_index (calls, i - 1);
+}
+
+/* hooks */
+
+/* Ghost and proxy pads only forward to their target, the time spent there is
+ * accounted to the real pads around them. */
+
+static void
+do_push_buffer_pre (GstHistogramTracer * self, GstClockTime ts, GstPad * pad,
+    GstBuffer * buffer)
+{
+  PadHistograms *data;
+
+  if (GST_IS_PROXY_PAD (pad)) {
+    if (self->flags & GST_HISTOGRAM_TRACER_FLAG_RESIDENCY)
+      mark_arrival (self, pad, buffer, ts);
+    return;
+  }
+
+  data = get_pad_histograms (self, pad);
+  record_gap (self, data, ts);
+  record_buffer (self, pad, data, buffer, ts);
+  begin_pad_call (self, GST_PAD_PEER (pad), ts);
+
+  maybe_log_histograms (self, ts);
+}
+
+static void
+do_push_buffer_post (GstHistogramTracer * self, GstClockTime ts, GstPad * pad,
+    GstFlowReturn res)
+{
+  if (GST_IS_PROXY_PAD (pad))
+    return;
+
+  end_pad_call (self, ts);
+}
+
+static void
+do_push_buffer_list_pre (GstHistogramTracer * self, GstClockTime ts,
+    GstPad * pad, GstBufferList * list)
+{
+  PadHistograms *data;
+  guint i, len = gst_buffer_list_length (list);
+
+  if (GST_IS_PROXY_PAD (pad)) {
+    if (self->flags & GST_HISTOGRAM_TRACER_FLAG_RESIDENCY) {
+      for (i = 0; i < len; i++)
+        mark_arrival (self, pad, gst_buffer_list_get (list, i), ts);
+    }
+    return;
+  }
+
+  data = get_pad_histograms (self, pad);
+  record_gap (self, data, ts);
+  for (i = 0; i < len; i++)
+    record_buffer (self, pad, data, gst_buffer_list_get (list, i), ts);
+  begin_pad_call (self, GST_PAD_PEER (pad), ts);
+
+  maybe_log_histograms (self, ts);
+}
+
+static void
+do_pull_range_pre (GstHistogramTracer * self, GstClockTime ts, GstPad * pad,
+    guint64 offset, guint size)
+{
+  if (GST_IS_PROXY_PAD (pad))
+    return;
+
+  begin_pad_call (self, GST_PAD_PEER (pad), ts);
+}
+
+static void
+do_pull_range_post (GstHistogramTracer * self, GstClockTime ts, GstPad * pad,
+    GstBuffer * buffer, GstFlowReturn res)
+{
+  PadHistograms *data;
+
+  if (GST_IS_PROXY_PAD (pad))
+    return;
+
+  end_pad_call (self, ts);
+
+  if (buffer == NULL)
+    return;
+
+  data = get_pad_histograms (self, pad);
+  record_gap (self, data, ts);
+  if (self->flags & GST_HISTOGRAM_TRACER_FLAG_SIZE)
+    histogram_record (&data->metrics[METRIC_SIZE],
+        gst_buffer_get_size (buffer));
+
+  maybe_log_histograms (self, ts);
+}
+
+/* actions */
+
+static GstStructure *
+gst_histogram_tracer_get_histograms (GstHistogramTracer * self)
+{
+  GstStructure *info;
+  GValue pads = G_VALUE_INIT;
+  GList *l;
+  guint i;
+
+  g_value_init (&pads, GST_TYPE_LIST);
+
+  G_LOCK (histograms);
+  for (l = self->pads; l; l = l->next) {
+    PadHistograms *data = l->data;
+    GstStructure *s;
+    GValue s_value = G_VALUE_INIT;
+
+    s = gst_structure_new ("pad-histograms",
+        "element", G_TYPE_STRING, data->element_name,
+        "pad", G_TYPE_STRING, data->pad_name, NULL);
+
+    for (i = 0; i < N_METRICS; i++) {
+      HistogramSummary h;
+      GValue h_value = G_VALUE_INIT;
+
+      if (!histogram_summarize (&data->metrics[i], FALSE, &h))
+        continue;
+
+      g_value_init (&h_value, GST_TYPE_STRUCTURE);
+      g_value_take_boxed (&h_value, gst_structure_new ("histogram",
+              "count", G_TYPE_UINT64, h.count,
+              "min", G_TYPE_UINT64, h.min,
+              "mean", G_TYPE_UINT64, h.mean,
+              "p50", G_TYPE_UINT64, h.p50,
+              "p90", G_TYPE_UINT64, h.p90,
+              "p99", G_TYPE_UINT64, h.p99,
+              "p999", G_TYPE_UINT64, h.p999,
+              "max", G_TYPE_UINT64, h.max, NULL));
+      gst_structure_take_value (s, metric_names[i], &h_value);
+    }
+
+    g_value_init (&s_value, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&s_value, s);
+    gst_value_list_append_and_take_value (&pads, &s_value);
+  }
+  G_UNLOCK (histograms);
+
+  info = gst_structure_new_empty ("histograms");
+  gst_structure_take_value (info, "pads", &pads);
+
+  return info;
+}
+
+static void
+gst_histogram_tracer_log_histograms (GstHistogramTracer * self)
+{
+  log_histograms (self, gst_util_get_timestamp (), FALSE);
+}
+
+static void
+gst_histogram_tracer_reset_histograms (GstHistogramTracer * self)
+{
+  GList *l;
+  guint i;
+
+  G_LOCK (histograms);
+  for (l = self->pads; l; l = l->next) {
+    PadHistograms *data = l->data;
+
+    for (i = 0; i < N_METRICS; i++)
+      histogram_reset (&data->metrics[i]);
+  }
+  G_UNLOCK (histograms);
+}
+
+/* tracer class */
+
+static GType
+gst_histogram_tracer_flags_get_type (void)
+{
+  static GType type = 0;
+  static const GFlagsValue values[] = {
+    {GST_HISTOGRAM_TRACER_FLAG_PROCESSING_TIME, "Processing time histograms",
+        "processing-time"},
+    {GST_HISTOGRAM_TRACER_FLAG_GAP, "Inter-buffer gap histograms", "gap"},
+    {GST_HISTOGRAM_TRACER_FLAG_RESIDENCY, "Element residency histograms",
+        "residency"},
+    {GST_HISTOGRAM_TRACER_FLAG_SIZE, "Buffer size histograms", "size"},
+    {0, NULL, NULL}
+  };
+
+  if (!type) {
+    type = g_flags_register_static ("GstHistogramTracerFlags", values);
+  }
+  return type;
+}
+
+static void
+gst_histogram_tracer_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstHistogramTracer *self = GST_HISTOGRAM_TRACER (object);
+
+  switch (prop_id) {
+    case PROP_FLAGS:
+      g_value_set_flags (value, self->flags);
+      break;
+    case PROP_INTERVAL:
+      g_value_set_uint (value, self->interval);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_histogram_tracer_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstHistogramTracer *self = GST_HISTOGRAM_TRACER (object);
+
+  switch (prop_id) {
+    case PROP_FLAGS:
+      self->flags = g_value_get_flags (value);
+      break;
+    case PROP_INTERVAL:
+      self->interval = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_histogram_tracer_constructed (GObject * object)
+{
+  GstHistogramTracer *self = GST_HISTOGRAM_TRACER (object);
+
+  G_OBJECT_CLASS (parent_class)->constructed (object);
+
+  self->next_log = gst_util_get_timestamp () + self->interval * GST_MSECOND;
+}
+
+static void
+gst_histogram_tracer_finalize (GObject * object)
+{
+  GstHistogramTracer *self = GST_HISTOGRAM_TRACER (object);
+  GList *l;
+
+  /* pads that outlive us only free their histograms from now on */
+  G_LOCK (histograms);
+  for (l = self->pads; l; l = l->next)
+    ((PadHistograms *) l->data)->tracer = NULL;
+  g_list_free (self->pads);
+  self->pads = NULL;
+  G_UNLOCK (histograms);
+
+  g_mutex_clear (&self->log_lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+add_scoped_field (GstTraceFormatBuilder * builder, const gchar * name,
+    GstTracerValueScope scope)
+{
+  gst_trace_format_builder_add_field_full (builder,
+      gst_trace_field_set_scope (gst_trace_field_new (name,
+              GST_TRACER_FIELD_TYPE_STRING), scope));
+}
+
+static void
+add_described_field (GstTraceFormatBuilder * builder, const gchar * name,
+    GstTracerFieldType type, const gchar * description)
+{
+  gst_trace_format_builder_add_field_full (builder,
+      gst_trace_field_set_description (gst_trace_field_new (name, type),
+          description));
+}
+
+static void
+gst_histogram_tracer_class_init (GstHistogramTracerClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstTraceFormatBuilder *builder;
+
+  gst_tracer_class_set_use_structure_params (GST_TRACER_CLASS (klass), TRUE);
+
+  gobject_class->get_property = gst_histogram_tracer_get_property;
+  gobject_class->set_property = gst_histogram_tracer_set_property;
+  gobject_class->constructed = gst_histogram_tracer_constructed;
+  gobject_class->finalize = gst_histogram_tracer_finalize;
+
+  klass->get_histograms = gst_histogram_tracer_get_histograms;
+  klass->log_histograms = gst_histogram_tracer_log_histograms;
+  klass->reset_histograms = gst_histogram_tracer_reset_histograms;
+
+  g_object_class_install_property (gobject_class, PROP_FLAGS,
+      g_param_spec_flags ("flags", "Flags",
+          "Flags to control which histograms to keep",
+          gst_histogram_tracer_flags_get_type (), DEFAULT_FLAGS,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_INTERVAL,
+      g_param_spec_uint ("interval", "Interval",
+          "Interval in milliseconds between two summaries, after which the "
+          "histograms are reset (0 = never)", 0, G_MAXUINT, DEFAULT_INTERVAL,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS));
+
+  gst_type_mark_as_plugin_api (gst_histogram_tracer_flags_get_type (), 0);
+
+  /**
+   * GstHistogramTracer::get-histograms:
+   * @histogramtracer: the histogram tracer object to emit this signal on
+   *
+   * Returns a #GstStructure containing a `pads` field of type
+   * #GST_TYPE_LIST, which has a #GstStructure per pad seen by the tracer.
+   * Each of them has the following fields:
+   *
+   * `element`: the name of the element owning the pad
+   * `pad`: the name of the pad
+   *
+   * and, for each non-empty histogram, a #GstStructure named after the
+   * histogram (`processing-time`, `gap`, `residency` or `size`) with the
+   * #guint64 fields `count`, `min`, `mean`, `p50`, `p90`, `p99`, `p999` and
+   * `max`. Times are in nanoseconds, sizes in bytes.
+   *
+   * Returns: (transfer full): a newly-allocated #GstStructure
+   *
+   * Since: 1.30
+   */
+  gst_histogram_tracer_signals[SIGNAL_GET_HISTOGRAMS] =
+      g_signal_new ("get-histograms", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstHistogramTracerClass, get_histograms), NULL, NULL,
+      NULL, GST_TYPE_STRUCTURE, 0, G_TYPE_NONE);
+
+  /**
+   * GstHistogramTracer::log-histograms:
+   * @histogramtracer: the histogram tracer object to emit this signal on
+   *
+   * Emits a `pad-histogram` tracer event for each non-empty histogram,
+   * without resetting them.
+   *
+   * Since: 1.30
+   */
+  gst_histogram_tracer_signals[SIGNAL_LOG_HISTOGRAMS] =
+      g_signal_new ("log-histograms", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstHistogramTracerClass, log_histograms), NULL, NULL,
+      NULL, G_TYPE_NONE, 0, G_TYPE_NONE);
+
+  /**
+   * GstHistogramTracer::reset-histograms:
+   * @histogramtracer: the histogram tracer object to emit this signal on
+   *
+   * Clears all histograms.
+   *
+   * Since: 1.30
+   */
+  gst_histogram_tracer_signals[SIGNAL_RESET_HISTOGRAMS] =
+      g_signal_new ("reset-histograms", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstHistogramTracerClass, reset_histograms), NULL, NULL,
+      NULL, G_TYPE_NONE, 0, G_TYPE_NONE);
+
+  /* announce trace formats */
+  builder = gst_trace_format_builder_new ("pad-histogram");
+  add_scoped_field (builder, "element", GST_TRACER_VALUE_SCOPE_ELEMENT);
+  add_scoped_field (builder, "pad", GST_TRACER_VALUE_SCOPE_PAD);
+  add_described_field (builder, "histogram", GST_TRACER_FIELD_TYPE_STRING,
+      "name of the histogram");
+  add_described_field (builder, "count", GST_TRACER_FIELD_TYPE_UINT64,
+      "number of recorded values");
+  add_described_field (builder, "min", GST_TRACER_FIELD_TYPE_UINT64,
+      "minimum value");
+  add_described_field (builder, "mean", GST_TRACER_FIELD_TYPE_UINT64,
+      "mean value");
+  add_described_field (builder, "p50", GST_TRACER_FIELD_TYPE_UINT64,
+      "median value");
+  add_described_field (builder, "p90", GST_TRACER_FIELD_TYPE_UINT64,
+      "90th percentile");
+  add_described_field (builder, "p99", GST_TRACER_FIELD_TYPE_UINT64,
+      "99th percentile");
+  add_described_field (builder, "p999", GST_TRACER_FIELD_TYPE_UINT64,
+      "99.9th percentile");
+  add_described_field (builder, "max", GST_TRACER_FIELD_TYPE_UINT64,
+      "maximum value");
+  add_described_field (builder, "ts", GST_TRACER_FIELD_TYPE_UINT64,
+      "ts when the summary has been logged");
+  tr_histogram = gst_trace_format_builder_register (builder);
+}
+
+static void
+gst_histogram_tracer_init (GstHistogramTracer * self)
+{
+  GstTracer *tracer = GST_TRACER (self);
+  gchar *name;
+
+  self->flags = DEFAULT_FLAGS;
+  self->interval = DEFAULT_INTERVAL;
+  g_mutex_init (&self->log_lock);
+
+  name = g_strdup_printf ("gsthistogram:%p", self);
+  self->quark = g_quark_from_string (name);
+  g_free (name);
+
+  gst_tracing_register_hook (tracer, "pad-push-pre",
+      G_CALLBACK (do_push_buffer_pre));
+  gst_tracing_register_hook (tracer, "pad-push-post",
+      G_CALLBACK (do_push_buffer_post));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (do_push_buffer_list_pre));
+  gst_tracing_register_hook (tracer, "pad-push-list-post",
+      G_CALLBACK (do_push_buffer_post));
+  gst_tracing_register_hook (tracer, "pad-pull-range-pre",
+      G_CALLBACK (do_pull_range_pre));
+  gst_tracing_register_hook (tracer, "pad-pull-range-post",
+      G_CALLBACK (do_pull_range_post));
+}
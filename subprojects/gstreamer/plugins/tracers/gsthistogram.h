@@ -0,0 +1,100 @@
+/* GStreamer
+ *
+ * gsthistogram.h: tracing module that keeps per-pad histograms
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_HISTOGRAM_TRACER_H__
+#define __GST_HISTOGRAM_TRACER_H__
+
+#include <gst/gst.h>
+#include <gst/gsttracer.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_HISTOGRAM_TRACER \
+  (gst_histogram_tracer_get_type())
+#define GST_HISTOGRAM_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_HISTOGRAM_TRACER,GstHistogramTracer))
+#define GST_HISTOGRAM_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_HISTOGRAM_TRACER,GstHistogramTracerClass))
+#define GST_IS_HISTOGRAM_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_HISTOGRAM_TRACER))
+#define GST_IS_HISTOGRAM_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_HISTOGRAM_TRACER))
+#define GST_HISTOGRAM_TRACER_CAST(obj) ((GstHistogramTracer *)(obj))
+
+typedef struct _GstHistogramTracer GstHistogramTracer;
+typedef struct _GstHistogramTracerClass GstHistogramTracerClass;
+
+/**
+ * GstHistogramTracerFlags:
+ * @GST_HISTOGRAM_TRACER_FLAG_PROCESSING_TIME: time spent in the chain or
+ *   getrange function behind a pad, excluding the time spent downstream
+ * @GST_HISTOGRAM_TRACER_FLAG_GAP: time between two buffers on a pad
+ * @GST_HISTOGRAM_TRACER_FLAG_RESIDENCY: time a buffer stayed in an element
+ *   before it was pushed out again, e.g. in a queue
+ * @GST_HISTOGRAM_TRACER_FLAG_SIZE: buffer sizes in bytes
+ *
+ * Since: 1.30
+ */
+typedef enum
+{
+  GST_HISTOGRAM_TRACER_FLAG_PROCESSING_TIME = 1 << 0,
+  GST_HISTOGRAM_TRACER_FLAG_GAP = 1 << 1,
+  GST_HISTOGRAM_TRACER_FLAG_RESIDENCY = 1 << 2,
+  GST_HISTOGRAM_TRACER_FLAG_SIZE = 1 << 3,
+} GstHistogramTracerFlags;
+
+/**
+ * GstHistogramTracer:
+ *
+ * Opaque #GstHistogramTracer data structure
+ *
+ * Since: 1.30
+ */
+struct _GstHistogramTracer {
+  GstTracer 	 parent;
+
+  /*< private >*/
+  GstHistogramTracerFlags flags;
+  guint interval;
+
+  /* qdata key of the per-pad histograms of this instance */
+  GQuark quark;
+  /* all per-pad histograms, protected by the histograms lock */
+  GList *pads;
+
+  /* serializes the periodic summaries */
+  GMutex log_lock;
+  GstClockTime next_log;
+};
+
+struct _GstHistogramTracerClass {
+  GstTracerClass parent_class;
+
+  /* actions */
+  GstStructure * (*get_histograms)   (GstHistogramTracer *tracer);
+  void           (*log_histograms)   (GstHistogramTracer *tracer);
+  void           (*reset_histograms) (GstHistogramTracer *tracer);
+};
+
+G_GNUC_INTERNAL GType gst_histogram_tracer_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_HISTOGRAM_TRACER_H__ */
@@ -30,6 +30,7 @@
 #include "gststats.h"
 #include "gstleaks.h"
 #include "gstfactories.h"
+#include "gsthistogram.h"
 
 GType gst_dots_tracer_get_type (void);
 
@@ -58,6 +59,9 @@ plugin_init (GstPlugin * plugin)
   if (!gst_tracer_register (plugin, "factories",
           gst_factories_tracer_get_type ()))
     return FALSE;
+  if (!gst_tracer_register (plugin, "histogram",
+          gst_histogram_tracer_get_type ()))
+    return FALSE;
   return TRUE;
 }
 
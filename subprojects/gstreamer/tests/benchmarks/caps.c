@@ -1,7 +1,7 @@
 /* GStreamer
  * Copyright (C) 2005 Andy Wingo <wingo@pobox.com>
  *
- * caps.c: benchmark for caps creation and destruction
+ * caps.c: benchmark for caps creation, destruction and operations
  *
  * This library is free software; you can redistribute it and/or
  * modify it under the terms of the GNU Library General Public
@@ -40,12 +40,51 @@
   "rate = (int) [ 1, MAX ], " \
   "channels = (int) [ 1, MAX ]"
 
+#define GST_AUDIO_FIXED_CAPS \
+  "audio/x-raw, format = (string) F32LE, rate = (int) 48000, " \
+  "channels = (int) 2, layout = (string) interleaved"
+
+static void
+run_operations (GstCaps * fixed, GstCaps * tmpl, const gchar * what)
+{
+  GstClockTime start, end;
+  GstCaps *res;
+  gint i;
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_CAPS; i++) {
+    res = gst_caps_intersect (fixed, tmpl);
+    gst_caps_unref (res);
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - intersecting %d %s caps\n",
+      GST_TIME_ARGS (end - start), i, what);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_CAPS; i++) {
+    if (!gst_caps_can_intersect (fixed, tmpl))
+      g_assert_not_reached ();
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - checking %d %s caps for intersection\n",
+      GST_TIME_ARGS (end - start), i, what);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_CAPS; i++) {
+    if (!gst_caps_is_subset (fixed, tmpl))
+      g_assert_not_reached ();
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - checking %d %s caps for subset\n",
+      GST_TIME_ARGS (end - start), i, what);
+}
+
 
 gint
 main (gint argc, gchar * argv[])
 {
   GstCaps **capses;
-  GstCaps *protocaps;
+  GstCaps *protocaps, *fixed;
   GstClockTime start, end;
   gint i;
 
@@ -69,6 +108,15 @@ main (gint argc, gchar * argv[])
       GST_TIME_ARGS (end - start), i);
 
   g_free (capses);
+
+  fixed = gst_caps_from_string (GST_AUDIO_FIXED_CAPS);
+  run_operations (fixed, protocaps, "plain");
+
+  fixed = gst_caps_intern (fixed);
+  protocaps = gst_caps_intern (protocaps);
+  run_operations (fixed, protocaps, "interned");
+
+  gst_caps_unref (fixed);
   gst_caps_unref (protocaps);
 
   return 0;
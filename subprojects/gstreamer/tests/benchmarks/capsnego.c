@@ -28,6 +28,7 @@
  *  -c children: is the number of branches on each level
  *  -f <flavour>: can be "audio" or "video" and is controlling the kind of
  *                elements that are used.
+ *  -i: intern the pad template caps before checking the links against them
  */
 
 #include <gst/gst.h>
@@ -133,6 +134,69 @@ create_nodes (GstBin * bin, GstElement * sink, gint depth, gint children,
   return TRUE;
 }
 
+static gboolean
+collect_link_caps (GstElement * element, GstPad * pad, gpointer user_data)
+{
+  GPtrArray *link_caps = user_data;
+  GstPad *peer;
+
+  peer = gst_pad_get_peer (pad);
+  if (peer) {
+    g_ptr_array_add (link_caps, gst_pad_get_pad_template_caps (pad));
+    g_ptr_array_add (link_caps, gst_pad_get_pad_template_caps (peer));
+    gst_object_unref (peer);
+  }
+
+  return TRUE;
+}
+
+/* does the template caps checks of gst_pad_link() and autoplugging for all
+ * links in the bin */
+static void
+check_links (GstBin * bin, gint loops, gboolean interned)
+{
+  GPtrArray *link_caps;
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+  GstClockTime start, end;
+  GstCaps *caps1, *caps2, *res;
+  gint i;
+  guint j;
+
+  link_caps = g_ptr_array_new_with_free_func ((GDestroyNotify) gst_caps_unref);
+  it = gst_bin_iterate_elements (bin);
+  while (gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    gst_element_foreach_src_pad (g_value_get_object (&item), collect_link_caps,
+        link_caps);
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+
+  if (interned) {
+    for (j = 0; j < link_caps->len; j++)
+      link_caps->pdata[j] = gst_caps_intern (link_caps->pdata[j]);
+  }
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < loops; ++i) {
+    for (j = 0; j + 1 < link_caps->len; j += 2) {
+      caps1 = g_ptr_array_index (link_caps, j);
+      caps2 = g_ptr_array_index (link_caps, j + 1);
+      if (gst_caps_can_intersect (caps1, caps2)) {
+        res = gst_caps_intersect (caps1, caps2);
+        gst_caps_unref (res);
+      }
+    }
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " checked %u links against %s template caps "
+      "(%d loop iterations)\n", GST_TIME_ARGS (end - start),
+      link_caps->len / 2, interned ? "interned" : "plain", loops);
+
+  g_ptr_array_unref (link_caps);
+}
+
 static void
 event_loop (GstElement * bin)
 {
@@ -190,6 +254,7 @@ main (gint argc, gchar * argv[])
   gint children = 3;
   gint depth = 4;
   gint loops = 50;
+  gboolean interned = FALSE;
 
   GOptionContext *ctx;
   GOptionEntry options[] = {
@@ -206,6 +271,9 @@ main (gint argc, gchar * argv[])
     {"loops", 'l', 0, G_OPTION_ARG_INT, &loops,
         "How many loops to run (default: 50)", NULL}
     ,
+    {"interned", 'i', 0, G_OPTION_ARG_NONE, &interned,
+        "Intern the template caps for the link checks (default: no)", NULL}
+    ,
     {NULL}
   };
   GError *err = NULL;
@@ -265,6 +333,8 @@ main (gint argc, gchar * argv[])
   end = gst_util_get_timestamp ();
   g_print ("%" GST_TIME_FORMAT " reached PAUSED state (%d loop iterations)\n",
       GST_TIME_ARGS (end - start), loops);
+
+  check_links (bin, loops, interned);
   /* clean up */
 Error:
   gst_element_set_state (GST_ELEMENT (bin), GST_STATE_NULL);
@@ -23,6 +23,13 @@
 #include <gst/glib-compat-private.h>
 
 #define MAX_THREADS  100
+#define DEFAULT_NUM_IDS 100000
+
+/* async ids that are scheduled far in the future, to fill up the clock */
+#define IDLE_OFFSET (3600 * GST_SECOND)
+/* the ids that are fired are spread over this period */
+#define FIRE_OFFSET (100 * GST_MSECOND)
+#define FIRE_SPREAD (100 * GST_MSECOND)
 
 static gboolean running = TRUE;
 static gint count = 0;
@@ -43,6 +50,104 @@ run_test (void *user_data)
   return NULL;
 }
 
+static GMutex fired_lock;
+static GCond fired_cond;
+static guint fired = 0;
+static GstClockTime last_fired;
+
+static gboolean
+fire_cb (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  guint num_ids = GPOINTER_TO_UINT (user_data);
+
+  g_mutex_lock (&fired_lock);
+  if (++fired == num_ids) {
+    last_fired = gst_clock_get_time (clock);
+    g_cond_signal (&fired_cond);
+  }
+  g_mutex_unlock (&fired_lock);
+
+  return TRUE;
+}
+
+static void
+shuffle_ids (GstClockID * ids, guint num_ids)
+{
+  guint i;
+
+  for (i = num_ids - 1; i > 0; i--) {
+    guint j = g_random_int_range (0, i + 1);
+    GstClockID tmp = ids[i];
+
+    ids[i] = ids[j];
+    ids[j] = tmp;
+  }
+}
+
+/* measures scheduling, unscheduling and firing async ids while many other
+ * ids are pending on the clock */
+static void
+run_async (GstClock * sysclock, guint num_ids)
+{
+  GstClockID *idle_ids, *fire_ids;
+  GstClockTime start, end, base;
+  guint i;
+
+  idle_ids = g_new (GstClockID, num_ids);
+  fire_ids = g_new (GstClockID, num_ids);
+
+  base = gst_clock_get_time (sysclock) + IDLE_OFFSET;
+  for (i = 0; i < num_ids; i++) {
+    idle_ids[i] = gst_clock_new_single_shot_id (sysclock,
+        base + g_random_int_range (0, G_MAXINT) * GST_USECOND);
+  }
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < num_ids; i++)
+    gst_clock_id_wait_async (idle_ids[i], NULL, NULL, NULL);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - scheduling %u async ids, %.1lf ns per id\n",
+      GST_TIME_ARGS (end - start), num_ids,
+      (gdouble) (end - start) / num_ids);
+
+  /* the ids that fire are scheduled while all the idle ids are pending */
+  base = gst_clock_get_time (sysclock) + FIRE_OFFSET;
+  for (i = 0; i < num_ids; i++) {
+    fire_ids[i] = gst_clock_new_single_shot_id (sysclock,
+        base + (FIRE_SPREAD * i) / num_ids);
+  }
+  for (i = 0; i < num_ids; i++) {
+    gst_clock_id_wait_async (fire_ids[i], fire_cb, GUINT_TO_POINTER (num_ids),
+        NULL);
+  }
+
+  g_mutex_lock (&fired_lock);
+  while (fired < num_ids)
+    g_cond_wait (&fired_cond, &fired_lock);
+  g_mutex_unlock (&fired_lock);
+  g_print ("%" GST_TIME_FORMAT " - firing %u async ids, last one was %"
+      GST_TIME_FORMAT " late\n", GST_TIME_ARGS (FIRE_SPREAD), num_ids,
+      GST_TIME_ARGS (last_fired - (base + FIRE_SPREAD)));
+
+  shuffle_ids (idle_ids, num_ids);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < num_ids; i++)
+    gst_clock_id_unschedule (idle_ids[i]);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - unscheduling %u async ids in random order, "
+      "%.1lf ns per id\n", GST_TIME_ARGS (end - start), num_ids,
+      (gdouble) (end - start) / num_ids);
+
+  for (i = 0; i < num_ids; i++) {
+    gst_clock_id_unref (idle_ids[i]);
+    gst_clock_id_unref (fire_ids[i]);
+  }
+  g_free (idle_ids);
+  g_free (fire_ids);
+}
+
 gint
 main (gint argc, gchar * argv[])
 {
@@ -53,8 +158,26 @@ main (gint argc, gchar * argv[])
 
   gst_init (&argc, &argv);
 
+  if (argc >= 2 && g_str_equal (argv[1], "async")) {
+    guint num_ids = DEFAULT_NUM_IDS;
+
+    if (argc > 2)
+      num_ids = atoi (argv[2]);
+    if (num_ids == 0) {
+      g_print ("number of ids must be bigger than 0\n");
+      exit (-2);
+    }
+
+    sysclock = gst_system_clock_obtain ();
+    run_async (sysclock, num_ids);
+    gst_object_unref (sysclock);
+
+    return 0;
+  }
+
   if (argc != 2) {
     g_print ("usage: %s <num_threads>\n", argv[0]);
+    g_print ("       %s async [<num_ids>]\n", argv[0]);
     exit (-1);
   }
 
@@ -0,0 +1,186 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures how fast threads can create and free the events and queries that
+ * are typically sent per frame: custom downstream events and position,
+ * duration and latency queries.
+ *
+ * Each thread runs two passes. In the first one every object is freed right
+ * after it was created, which is the common case for serialized events and
+ * queries and is served from the per-thread freelists. In the second one
+ * BATCH_SIZE objects are kept alive at a time, which is more than the
+ * freelists hold, so most of them go through malloc and free again. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+
+#define MAX_THREADS  1000
+#define BATCH_SIZE   256
+
+/* one miniobject and one structure each */
+#define ALLOCS_PER_OBJECT 2
+
+static guint64 nbobjects;
+static GMutex mutex;
+
+static GstMiniObject *
+create_object (guint64 n)
+{
+  switch (n % 4) {
+    case 0:
+      return GST_MINI_OBJECT_CAST (gst_event_new_custom
+          (GST_EVENT_CUSTOM_DOWNSTREAM, gst_structure_new ("frame-info",
+                  "frame", G_TYPE_UINT64, n, NULL)));
+    case 1:
+      return GST_MINI_OBJECT_CAST (gst_query_new_position (GST_FORMAT_TIME));
+    case 2:
+      return GST_MINI_OBJECT_CAST (gst_query_new_duration (GST_FORMAT_TIME));
+    default:
+      return GST_MINI_OBJECT_CAST (gst_query_new_latency ());
+  }
+}
+
+static GstClockTime
+run_recycled (void)
+{
+  GstClockTime start;
+  guint64 nb;
+
+  start = gst_util_get_timestamp ();
+  for (nb = nbobjects; nb; nb--)
+    gst_mini_object_unref (create_object (nb));
+
+  return gst_util_get_timestamp () - start;
+}
+
+static GstClockTime
+run_batched (void)
+{
+  GstMiniObject *objects[BATCH_SIZE];
+  GstClockTime start;
+  guint64 nb;
+  guint i, n;
+
+  start = gst_util_get_timestamp ();
+  for (nb = nbobjects; nb; nb -= n) {
+    n = MIN (nb, BATCH_SIZE);
+    for (i = 0; i < n; i++)
+      objects[i] = create_object (nb - i);
+    for (i = 0; i < n; i++)
+      gst_mini_object_unref (objects[i]);
+  }
+
+  return gst_util_get_timestamp () - start;
+}
+
+static void *
+run_test (void *user_data)
+{
+  gint threadid = GPOINTER_TO_INT (user_data);
+  GstClockTime recycled, batched;
+  gdouble recycled_rate, batched_rate;
+
+  g_mutex_lock (&mutex);
+  g_mutex_unlock (&mutex);
+
+  g_assert_cmpuint (nbobjects, >, 0);
+
+  recycled = MAX (run_recycled (), 1);
+  batched = MAX (run_batched (), 1);
+
+  recycled_rate = (gdouble) nbobjects * GST_SECOND / recycled;
+  batched_rate = (gdouble) nbobjects * GST_SECOND / batched;
+
+  g_print ("recycled %" GST_TIME_FORMAT " (%.0f objects/s) - batched %"
+      GST_TIME_FORMAT " (%.0f objects/s) - Thread %d\n",
+      GST_TIME_ARGS (recycled), recycled_rate, GST_TIME_ARGS (batched),
+      batched_rate, threadid);
+  g_print ("  up to %.0f allocations/s saved - Thread %d\n",
+      recycled_rate * ALLOCS_PER_OBJECT, threadid);
+
+  g_thread_exit (NULL);
+  return NULL;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GThread *threads[MAX_THREADS];
+  gint num_threads;
+  gint t;
+  GstClockTime start, end;
+
+  gst_init (&argc, &argv);
+  g_mutex_init (&mutex);
+
+  if (argc != 3) {
+    g_print ("usage: %s <num_threads> <nbobjects>\n", argv[0]);
+    exit (-1);
+  }
+
+  num_threads = atoi (argv[1]);
+  nbobjects = atoi (argv[2]);
+
+  if (num_threads <= 0 || num_threads > MAX_THREADS) {
+    g_print ("number of threads must be between 0 and %d\n", MAX_THREADS);
+    exit (-2);
+  }
+
+  if (nbobjects <= 0) {
+    g_print ("number of objects must be greater than 0\n");
+    exit (-3);
+  }
+
+  g_mutex_lock (&mutex);
+  /* make sure the event and query types are registered */
+  gst_mini_object_unref (create_object (0));
+  gst_mini_object_unref (create_object (1));
+
+  printf ("main(): Creating %d threads.\n", num_threads);
+  for (t = 0; t < num_threads; t++) {
+    GError *error = NULL;
+
+    threads[t] = g_thread_try_new ("eventstresstest", run_test,
+        GINT_TO_POINTER (t), &error);
+
+    if (error) {
+      printf ("ERROR: g_thread_try_new() %s\n", error->message);
+      g_clear_error (&error);
+      exit (-1);
+    }
+  }
+
+  /* Signal all threads to start */
+  start = gst_util_get_timestamp ();
+  g_mutex_unlock (&mutex);
+
+  for (t = 0; t < num_threads; t++) {
+    if (threads[t])
+      g_thread_join (threads[t]);
+  }
+
+  end = gst_util_get_timestamp ();
+  g_print ("*** total %" GST_TIME_FORMAT " - average %" GST_TIME_FORMAT
+      "  - Done creating %" G_GUINT64_FORMAT " events and queries\n",
+      GST_TIME_ARGS (end - start),
+      GST_TIME_ARGS ((end - start) / (num_threads * nbobjects * 2)),
+      num_threads * nbobjects * 2);
+
+  return 0;
+}
@@ -20,9 +20,16 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <gst/gst.h>
 #include "gst/glib-compat-private.h"
 
+#ifndef G_OS_WIN32
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#endif
+
 static GstPoll *set;
 static GList *fds = NULL;
 static GMutex fdlock;
@@ -30,6 +37,9 @@ static GTimer *timer;
 
 #define MAX_THREADS  100
 
+#define LATENCY_ROUNDS  1000
+#define DEFAULT_MAX_FDS 10000
+
 static void
 mess_some_more (void)
 {
@@ -136,6 +146,148 @@ run_test (void *threadid)
   return NULL;
 }
 
+#ifndef G_OS_WIN32
+static GMutex latency_lock;
+static GCond latency_cond;
+static GstClockTime latency_sent;
+static GstClockTime latency_total;
+static gint latency_received;
+
+static void *
+wait_for_wakeups (void *data)
+{
+  GstPollFD *fd = data;
+  gint i;
+
+  for (i = 0; i < LATENCY_ROUNDS; i++) {
+    GstClockTime now;
+    gchar c;
+
+    if (gst_poll_wait (set, GST_CLOCK_TIME_NONE) < 0) {
+      g_print ("error %d %s\n", errno, g_strerror (errno));
+      exit (-1);
+    }
+    now = gst_util_get_timestamp ();
+
+    if (!gst_poll_fd_can_read (set, fd) || read (fd->fd, &c, 1) != 1) {
+      g_print ("woke up without data\n");
+      exit (-1);
+    }
+
+    g_mutex_lock (&latency_lock);
+    latency_total += now - latency_sent;
+    latency_received++;
+    g_cond_signal (&latency_cond);
+    g_mutex_unlock (&latency_lock);
+  }
+
+  return NULL;
+}
+
+/* measure how long it takes for a wait on a set with @num_fds idle fds to
+ * return after one other fd became readable */
+static gboolean
+measure_wakeup_latency (guint num_fds)
+{
+  GstPollFD active = GST_POLL_FD_INIT;
+  GstPollFD *idle;
+  GThread *thread;
+  gint active_sock[2], idle_sock[2];
+  guint added, i;
+
+  if (socketpair (PF_UNIX, SOCK_STREAM, 0, active_sock) < 0 ||
+      socketpair (PF_UNIX, SOCK_STREAM, 0, idle_sock) < 0) {
+    g_print ("can't create socket pair: %s\n", g_strerror (errno));
+    exit (-1);
+  }
+
+  set = gst_poll_new (TRUE);
+
+  active.fd = active_sock[0];
+  gst_poll_add_fd (set, &active);
+  gst_poll_fd_ctl_read (set, &active, TRUE);
+
+  /* the idle fds all refer to a socket nobody ever writes to */
+  idle = g_new (GstPollFD, num_fds);
+  for (added = 0; added < num_fds; added++) {
+    gst_poll_fd_init (&idle[added]);
+    if ((idle[added].fd = dup (idle_sock[0])) < 0)
+      break;
+    gst_poll_add_fd (set, &idle[added]);
+    gst_poll_fd_ctl_read (set, &idle[added], TRUE);
+  }
+
+  if (added == num_fds) {
+    latency_total = 0;
+    latency_received = 0;
+
+    thread = g_thread_new ("pollwaiter", wait_for_wakeups, &active);
+
+    for (i = 0; i < LATENCY_ROUNDS; i++) {
+      /* give the waiter time to block again */
+      g_usleep (100);
+
+      g_mutex_lock (&latency_lock);
+      latency_sent = gst_util_get_timestamp ();
+      g_mutex_unlock (&latency_lock);
+
+      if (write (active_sock[1], "W", 1) != 1) {
+        g_print ("can't write: %s\n", g_strerror (errno));
+        exit (-1);
+      }
+
+      g_mutex_lock (&latency_lock);
+      while (latency_received <= (gint) i)
+        g_cond_wait (&latency_cond, &latency_lock);
+      g_mutex_unlock (&latency_lock);
+    }
+    g_thread_join (thread);
+
+    g_print ("%8u fds: %8" G_GUINT64_FORMAT " ns average wakeup latency\n",
+        num_fds, latency_total / LATENCY_ROUNDS);
+  } else {
+    g_print ("%8u fds: can't create more than %u fds\n", num_fds, added);
+  }
+
+  for (i = 0; i < added; i++) {
+    gst_poll_remove_fd (set, &idle[i]);
+    close (idle[i].fd);
+  }
+  g_free (idle);
+
+  gst_poll_free (set);
+  set = NULL;
+
+  close (active_sock[0]);
+  close (active_sock[1]);
+  close (idle_sock[0]);
+  close (idle_sock[1]);
+
+  return added == num_fds;
+}
+
+static void
+run_latency_test (guint max_fds)
+{
+  struct rlimit limit;
+  guint num_fds;
+
+  /* we need a lot of fds */
+  if (getrlimit (RLIMIT_NOFILE, &limit) == 0) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit (RLIMIT_NOFILE, &limit);
+  }
+
+  g_print ("GST_POLL_MODE=%s\n", GST_STR_NULL (g_getenv ("GST_POLL_MODE")));
+
+  for (num_fds = 1; num_fds < max_fds; num_fds *= 10) {
+    if (!measure_wakeup_latency (num_fds))
+      return;
+  }
+  measure_wakeup_latency (max_fds);
+}
+#endif
+
 gint
 main (gint argc, gchar * argv[])
 {
@@ -148,8 +300,18 @@ main (gint argc, gchar * argv[])
   g_mutex_init (&fdlock);
   timer = g_timer_new ();
 
+#ifndef G_OS_WIN32
+  if (argc >= 2 && g_str_equal (argv[1], "latency")) {
+    run_latency_test (argc > 2 ? atoi (argv[2]) : DEFAULT_MAX_FDS);
+    return 0;
+  }
+#endif
+
   if (argc != 2) {
     g_print ("usage: %s <num_threads>\n", argv[0]);
+#ifndef G_OS_WIN32
+    g_print ("       %s latency [<max_fds>]\n", argv[0]);
+#endif
     exit (-1);
   }
 
@@ -24,9 +24,62 @@
 
 #define BUFFER_SIZE (1400)
 
+typedef struct
+{
+  GstBufferPool *pool;
+  guint64 nbuffers;
+} ThreadData;
+
+static gpointer
+acquire_release (gpointer user_data)
+{
+  ThreadData *data = user_data;
+  GstBuffer *tmp;
+  guint64 i;
+
+  for (i = 0; i < data->nbuffers; i++) {
+    gst_buffer_pool_acquire_buffer (data->pool, &tmp, NULL);
+    gst_buffer_unref (tmp);
+  }
+
+  return NULL;
+}
+
+/* acquire and release @nbuffers in total from @pool, spread over @nthreads
+ * threads */
+static void
+run_threads (GstBufferPool * pool, guint64 nbuffers, guint nthreads)
+{
+  GThread **threads;
+  ThreadData data;
+  GstClockTime start, end;
+  GstClockTimeDiff dur;
+  guint i;
+
+  data.pool = pool;
+  data.nbuffers = nbuffers / nthreads;
+
+  threads = g_new (GThread *, nthreads);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < nthreads; i++)
+    threads[i] = g_thread_new ("poolstress", acquire_release, &data);
+  for (i = 0; i < nthreads; i++)
+    g_thread_join (threads[i]);
+  end = gst_util_get_timestamp ();
+
+  g_free (threads);
+
+  dur = GST_CLOCK_DIFF (start, end);
+  g_print ("*** total %" GST_TIME_FORMAT " - %u threads - %.0lf "
+      "acquire/release per second\n", GST_TIME_ARGS (dur), nthreads,
+      (gdouble) (data.nbuffers * nthreads) * GST_SECOND / MAX (dur, 1));
+}
+
 gint
 main (gint argc, gchar * argv[])
 {
+  guint nthreads = 1, t;
   gint i;
   GstBuffer *tmp;
   GstBufferPool *pool;
@@ -37,18 +90,25 @@ main (gint argc, gchar * argv[])
 
   gst_init (&argc, &argv);
 
-  if (argc != 2) {
-    g_print ("usage: %s <nbuffers>\n", argv[0]);
+  if (argc != 2 && argc != 3) {
+    g_print ("usage: %s <nbuffers> [<nthreads>]\n", argv[0]);
     exit (-1);
   }
 
   nbuffers = atoi (argv[1]);
+  if (argc == 3)
+    nthreads = atoi (argv[2]);
 
   if (nbuffers <= 0) {
     g_print ("number of buffers must be greater than 0\n");
     exit (-3);
   }
 
+  if (nthreads == 0) {
+    g_print ("number of threads must be greater than 0\n");
+    exit (-3);
+  }
+
   /* Let's just make sure the GstBufferClass is loaded ... */
   tmp = gst_buffer_new ();
   gst_buffer_unref (tmp);
@@ -87,6 +147,12 @@ main (gint argc, gchar * argv[])
 
   g_print ("*** speedup %6.4lf\n", ((gdouble) dur1 / (gdouble) dur2));
 
+  /* contended acquire/release from the pool, from 1 up to nthreads threads */
+  for (t = 1; t <= nthreads; t *= 2)
+    run_threads (pool, nbuffers, t);
+  if (nthreads & (nthreads - 1))
+    run_threads (pool, nbuffers, nthreads);
+
   gst_buffer_pool_set_active (pool, FALSE);
   gst_object_unref (pool);
 
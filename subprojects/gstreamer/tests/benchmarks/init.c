@@ -20,12 +20,126 @@
  */
 
 
+/* Runs itself in child processes that each initialize GStreamer with the same
+ * registry cache file. The first run has no cache yet and has to scan all
+ * plugins (cold), the following ones load the cache (warm). Every run also
+ * measures looking up the metadata of all element factories, which is when
+ * the details of the factories are loaded from the cache. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib/gstdio.h>
 #include <gst/gst.h>
 
+#define RUN_COUNT (10)
+
+static gint
+run_child (void)
+{
+  GList *factories, *l;
+  gint64 start, init, details;
+  guint n = 0;
+
+  start = g_get_monotonic_time ();
+  gst_init (NULL, NULL);
+  init = g_get_monotonic_time ();
+
+  factories = gst_element_factory_list_get_elements
+      (GST_ELEMENT_FACTORY_TYPE_ANY, GST_RANK_NONE);
+  for (l = factories; l; l = l->next) {
+    if (gst_element_factory_get_metadata (l->data,
+            GST_ELEMENT_METADATA_LONGNAME))
+      n++;
+  }
+  details = g_get_monotonic_time ();
+  gst_plugin_feature_list_free (factories);
+
+  g_print ("%" G_GINT64_FORMAT " %" G_GINT64_FORMAT " %u\n", init - start,
+      details - init, n);
+
+  return 0;
+}
+
+static gboolean
+run (gchar ** argv, gchar ** envp, gint64 * init, gint64 * details,
+    guint * n_factories)
+{
+  gchar *out = NULL;
+  gboolean res = FALSE;
+  GError *err = NULL;
+
+  if (!g_spawn_sync (NULL, argv, envp, G_SPAWN_DEFAULT, NULL, NULL, &out,
+          NULL, NULL, &err)) {
+    g_printerr ("failed to run %s: %s\n", argv[0], err->message);
+    g_clear_error (&err);
+    return FALSE;
+  }
+
+  /* the child only prints its timings if it didn't fail */
+  if (sscanf (out, "%" G_GINT64_FORMAT " %" G_GINT64_FORMAT " %u", init,
+          details, n_factories) == 3)
+    res = TRUE;
+  else
+    g_printerr ("child failed\n");
+
+  g_free (out);
+  return res;
+}
+
 gint
 main (gint argc, gchar * argv[])
 {
-  gst_init (&argc, &argv);
+  gchar *child_argv[] = { argv[0], (gchar *) "child", NULL };
+  gchar *dir, *registry;
+  gchar **envp;
+  gint64 init, details, warm_init = 0, warm_details = 0;
+  guint i, runs = RUN_COUNT, n_factories;
+  gint res = 1;
 
-  return 0;
+  if (argc > 1 && strcmp (argv[1], "child") == 0)
+    return run_child ();
+
+  if (argc > 1)
+    runs = atoi (argv[1]);
+  if (runs == 0) {
+    g_print ("usage: %s [<warm runs>]\n", argv[0]);
+    return 1;
+  }
+
+  dir = g_dir_make_tmp ("gst-init-XXXXXX", NULL);
+  g_assert (dir != NULL);
+  registry = g_build_filename (dir, "registry.bin", NULL);
+
+  envp = g_get_environ ();
+  envp = g_environ_setenv (envp, "GST_REGISTRY", registry, TRUE);
+
+  if (!run (child_argv, envp, &init, &details, &n_factories))
+    goto done;
+  g_print ("%" GST_TIME_FORMAT " - cold init, %" GST_TIME_FORMAT
+      " - metadata of %u element factories\n",
+      GST_TIME_ARGS (init * GST_USECOND),
+      GST_TIME_ARGS (details * GST_USECOND), n_factories);
+
+  for (i = 0; i < runs; i++) {
+    if (!run (child_argv, envp, &init, &details, &n_factories))
+      goto done;
+    warm_init += init;
+    warm_details += details;
+  }
+  g_print ("%" GST_TIME_FORMAT " - warm init, %" GST_TIME_FORMAT
+      " - metadata of %u element factories (average of %u runs)\n",
+      GST_TIME_ARGS (warm_init * GST_USECOND / runs),
+      GST_TIME_ARGS (warm_details * GST_USECOND / runs), n_factories, runs);
+
+  res = 0;
+
+done:
+  g_strfreev (envp);
+  g_unlink (registry);
+  g_rmdir (dir);
+  g_free (registry);
+  g_free (dir);
+
+  return res;
 }
@@ -0,0 +1,147 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures the cost of a single gst_pad_push() hop. A chain of linked pads
+ * is built where the chain function of each sink pad pushes the buffer on to
+ * the next source pad, without any element in between. Run with GST_TRACERS
+ * set to see the cost of the tracer hooks. */
+
+#include <stdlib.h>
+#include <gst/gst.h>
+
+#define HOP_COUNT (100)
+#define BUFFER_COUNT (100000)
+
+static GstFlowReturn
+chain_next (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  GstPad *next = gst_pad_get_element_private (pad);
+
+  if (next == NULL) {
+    gst_buffer_unref (buffer);
+    return GST_FLOW_OK;
+  }
+
+  return gst_pad_push (next, buffer);
+}
+
+static gboolean
+event_next (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  GstPad *next = gst_pad_get_element_private (pad);
+
+  if (next == NULL) {
+    gst_event_unref (event);
+    return TRUE;
+  }
+
+  return gst_pad_push_event (next, event);
+}
+
+static GstPadProbeReturn
+buffer_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+push_buffers (GstPad * first, guint hops, guint buffers, const gchar * what)
+{
+  GstClockTime start, end;
+  GstBuffer *buf;
+  guint i;
+
+  buf = gst_buffer_new ();
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < buffers; i++) {
+    if (gst_pad_push (first, gst_buffer_ref (buf)) != GST_FLOW_OK)
+      g_assert_not_reached ();
+  }
+  end = gst_util_get_timestamp ();
+
+  gst_buffer_unref (buf);
+
+  g_print ("%" GST_TIME_FORMAT " - pushing %u buffers through %u hops, "
+      "%.1lf ns per hop %s\n", GST_TIME_ARGS (end - start), buffers, hops,
+      (gdouble) (end - start) / ((gdouble) buffers * hops), what);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstPad **srcpads, **sinkpads;
+  GstSegment segment;
+  guint i, hops = HOP_COUNT, buffers = BUFFER_COUNT;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 1)
+    hops = atoi (argv[1]);
+  if (argc > 2)
+    buffers = atoi (argv[2]);
+
+  if (hops == 0 || buffers == 0) {
+    g_print ("usage: %s [<hops> [<buffers>]]\n", argv[0]);
+    return 1;
+  }
+
+  srcpads = g_new (GstPad *, hops);
+  sinkpads = g_new (GstPad *, hops);
+
+  for (i = 0; i < hops; i++) {
+    srcpads[i] = gst_pad_new ("src", GST_PAD_SRC);
+    sinkpads[i] = gst_pad_new ("sink", GST_PAD_SINK);
+    gst_pad_set_chain_function (sinkpads[i], chain_next);
+    gst_pad_set_event_function (sinkpads[i], event_next);
+
+    if (gst_pad_link (srcpads[i], sinkpads[i]) != GST_PAD_LINK_OK)
+      g_assert_not_reached ();
+
+    gst_pad_set_active (srcpads[i], TRUE);
+    gst_pad_set_active (sinkpads[i], TRUE);
+  }
+  for (i = 0; i + 1 < hops; i++)
+    gst_pad_set_element_private (sinkpads[i], srcpads[i + 1]);
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (srcpads[0], gst_event_new_stream_start ("padpush"));
+  gst_pad_push_event (srcpads[0], gst_event_new_segment (&segment));
+
+  /* warm up */
+  push_buffers (srcpads[0], hops, MIN (buffers, 1000), "(warm up)");
+
+  push_buffers (srcpads[0], hops, buffers, "without probes");
+
+  for (i = 0; i < hops; i++) {
+    gst_pad_add_probe (srcpads[i], GST_PAD_PROBE_TYPE_BUFFER, buffer_probe,
+        NULL, NULL);
+  }
+  push_buffers (srcpads[0], hops, buffers, "with a buffer probe per pad");
+
+  for (i = 0; i < hops; i++) {
+    gst_pad_set_active (srcpads[i], FALSE);
+    gst_pad_set_active (sinkpads[i], FALSE);
+    gst_object_unref (srcpads[i]);
+    gst_object_unref (sinkpads[i]);
+  }
+  g_free (srcpads);
+  g_free (sinkpads);
+
+  return 0;
+}
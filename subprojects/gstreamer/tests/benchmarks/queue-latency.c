@@ -0,0 +1,169 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures how long it takes for a buffer to get through a queue, with and
+ * without the lock-free mode. Buffers are pushed back to back, or with a
+ * fixed interval to emulate a stream of small packets, and the time between
+ * pushing a buffer and it arriving on the other side of the queue is
+ * averaged. */
+
+#include <stdlib.h>
+#include <gst/gst.h>
+
+#ifdef G_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#define BUFFER_COUNT (100000)
+
+static GMutex lock;
+static GCond cond;
+static guint received;
+static GstClockTime total_latency;
+static GstClockTime max_latency;
+
+static GstFlowReturn
+chain_func (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  GstClockTime latency;
+
+  latency = gst_util_get_timestamp () - GST_BUFFER_PTS (buffer);
+  gst_buffer_unref (buffer);
+
+  g_mutex_lock (&lock);
+  total_latency += latency;
+  max_latency = MAX (max_latency, latency);
+  received++;
+  g_cond_signal (&cond);
+  g_mutex_unlock (&lock);
+
+  return GST_FLOW_OK;
+}
+
+static GstClockTime
+get_cpu_time (void)
+{
+#ifdef G_OS_UNIX
+  struct rusage usage;
+
+  if (getrusage (RUSAGE_SELF, &usage) == 0) {
+    return GST_TIMEVAL_TO_TIME (usage.ru_utime) +
+        GST_TIMEVAL_TO_TIME (usage.ru_stime);
+  }
+#endif
+  return GST_CLOCK_TIME_NONE;
+}
+
+static void
+run (gboolean lock_free, guint buffers, guint interval)
+{
+  GstElement *queue;
+  GstPad *srcpad, *sinkpad, *pad;
+  GstSegment segment;
+  GstClockTime start, end, cpu_start, cpu_end;
+  guint i;
+
+  queue = gst_element_factory_make ("queue", NULL);
+  g_assert (queue != NULL);
+  g_object_set (queue, "lock-free", lock_free, "silent", TRUE, NULL);
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  pad = gst_element_get_static_pad (queue, "sink");
+  if (gst_pad_link (srcpad, pad) != GST_PAD_LINK_OK)
+    g_assert_not_reached ();
+  gst_object_unref (pad);
+
+  sinkpad = gst_pad_new ("sink", GST_PAD_SINK);
+  gst_pad_set_chain_function (sinkpad, chain_func);
+  pad = gst_element_get_static_pad (queue, "src");
+  if (gst_pad_link (pad, sinkpad) != GST_PAD_LINK_OK)
+    g_assert_not_reached ();
+  gst_object_unref (pad);
+
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_element_set_state (queue, GST_STATE_PLAYING);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("queue-latency"));
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  received = 0;
+  total_latency = max_latency = 0;
+
+  start = gst_util_get_timestamp ();
+  cpu_start = get_cpu_time ();
+  for (i = 0; i < buffers; i++) {
+    GstBuffer *buf = gst_buffer_new ();
+
+    GST_BUFFER_PTS (buf) = gst_util_get_timestamp ();
+    if (gst_pad_push (srcpad, buf) != GST_FLOW_OK)
+      g_assert_not_reached ();
+    if (interval > 0)
+      g_usleep (interval);
+  }
+
+  g_mutex_lock (&lock);
+  while (received < buffers)
+    g_cond_wait (&cond, &lock);
+  g_mutex_unlock (&lock);
+  end = gst_util_get_timestamp ();
+  cpu_end = get_cpu_time ();
+
+  g_print ("%" GST_TIME_FORMAT " - %u buffers, lock-free=%d: "
+      "%.1lf ns average latency, %" GST_TIME_FORMAT " max latency",
+      GST_TIME_ARGS (end - start), buffers, lock_free,
+      (gdouble) total_latency / buffers, GST_TIME_ARGS (max_latency));
+  if (GST_CLOCK_TIME_IS_VALID (cpu_start) && GST_CLOCK_TIME_IS_VALID (cpu_end))
+    g_print (", %" GST_TIME_FORMAT " CPU time", GST_TIME_ARGS (cpu_end -
+            cpu_start));
+  g_print ("\n");
+
+  gst_element_set_state (queue, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (queue);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint buffers = BUFFER_COUNT, interval = 0;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 1)
+    buffers = atoi (argv[1]);
+  if (argc > 2)
+    interval = atoi (argv[2]);
+
+  if (buffers == 0) {
+    g_print ("usage: %s [<buffers> [<interval in us>]]\n", argv[0]);
+    return 1;
+  }
+
+  /* warm up */
+  run (FALSE, MIN (buffers, 1000), 0);
+
+  run (FALSE, buffers, interval);
+  run (TRUE, buffers, interval);
+
+  return 0;
+}
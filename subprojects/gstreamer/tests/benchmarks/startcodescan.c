@@ -0,0 +1,197 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures how fast parsers can find the start codes in an elementary stream,
+ * like h264parse and mpegvideoparse do with an adapter and a byte reader.
+ * The 0x000001 start code scan, which is vectorized, is compared with
+ * scanning for the same bytes with a different mask, which goes through the
+ * generic byte by byte loop.
+ *
+ * Without arguments an H.264-like stream is generated, with NAL units of
+ * typical sizes and emulation prevention bytes. An Annex B stream can be
+ * passed as the first argument instead. */
+
+#include <stdlib.h>
+#include <gst/gst.h>
+#include <gst/base/gstadapter.h>
+#include <gst/base/gstbytereader.h>
+
+#define STREAM_SIZE (16 * 1024 * 1024)
+#define CHUNK_SIZE (4096)
+#define RUNS (10)
+
+static guint8 *
+generate_stream (gsize size)
+{
+  GRand *rand = g_rand_new_with_seed (0);
+  guint8 *data = g_malloc (size);
+  gsize pos = 0;
+
+  while (pos < size) {
+    gsize nal_size, sc_end, end, zeros = 0;
+
+    /* mostly small slices and parameter sets with the odd big I slice */
+    if (g_rand_int_range (rand, 0, 30) == 0)
+      nal_size = g_rand_int_range (rand, 20000, 200000);
+    else
+      nal_size = g_rand_int_range (rand, 8, 6000);
+
+    sc_end = pos + 4;
+    end = MIN (sc_end + nal_size, size);
+    for (; pos < end; pos++) {
+      guint8 b;
+
+      if (pos < sc_end) {
+        /* 0x00000001 start code */
+        data[pos] = pos + 1 == sc_end ? 0x01 : 0x00;
+        continue;
+      }
+
+      /* entropy coded payload has lots of zeros */
+      b = g_rand_int_range (rand, 0, 4) == 0 ? 0 : g_rand_int (rand);
+      if (zeros >= 2 && b <= 0x03) {
+        /* emulation prevention */
+        data[pos] = 0x03;
+        zeros = 0;
+        continue;
+      }
+      data[pos] = b;
+      zeros = b == 0 ? zeros + 1 : 0;
+    }
+  }
+  g_rand_free (rand);
+
+  return data;
+}
+
+static GstAdapter *
+fill_adapter (const guint8 * data, gsize size)
+{
+  GstAdapter *adapter = gst_adapter_new ();
+  gsize i;
+
+  for (i = 0; i < size; i += CHUNK_SIZE) {
+    gst_adapter_push (adapter, gst_buffer_new_memdup (data + i,
+            MIN (CHUNK_SIZE, size - i)));
+  }
+
+  return adapter;
+}
+
+/* 0xffffff00/0x00000100 and 0x00ffffff/0x00000001 both find 00 00 01, but
+ * only the former takes the vectorized path. The latter matches one byte
+ * earlier. */
+static guint
+scan_adapter (GstAdapter * adapter, gboolean vectorized)
+{
+  guint32 mask = vectorized ? 0xffffff00 : 0x00ffffff;
+  guint32 pattern = vectorized ? 0x00000100 : 0x00000001;
+  gsize size = gst_adapter_available (adapter);
+  gssize offset = 0, found;
+  guint count = 0;
+
+  while (offset + 4 <= size) {
+    found = gst_adapter_masked_scan_uint32 (adapter, mask, pattern, offset,
+        size - offset);
+    if (found < 0)
+      break;
+    count++;
+    offset = found + 4;
+  }
+
+  return count;
+}
+
+static guint
+scan_reader (const guint8 * data, gsize size, gboolean vectorized)
+{
+  guint32 mask = vectorized ? 0xffffff00 : 0x00ffffff;
+  guint32 pattern = vectorized ? 0x00000100 : 0x00000001;
+  GstByteReader reader = GST_BYTE_READER_INIT (data, size);
+  guint found, count = 0;
+
+  while (gst_byte_reader_get_remaining (&reader) >= 4) {
+    found = gst_byte_reader_masked_scan_uint32 (&reader, mask, pattern, 0,
+        gst_byte_reader_get_remaining (&reader));
+    if (found == -1)
+      break;
+    count++;
+    gst_byte_reader_skip_unchecked (&reader, found + 4);
+  }
+
+  return count;
+}
+
+static void
+report (const gchar * what, gboolean vectorized, gsize size, guint count,
+    GstClockTime time)
+{
+  g_print ("%-8s %-10s: %u start codes, %" GST_TIME_FORMAT ", %.1lf MB/s\n",
+      what, vectorized ? "vectorized" : "bytewise", count,
+      GST_TIME_ARGS (time), (gdouble) size * GST_SECOND / time / 1e6);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstAdapter *adapter;
+  GstClockTime start, end;
+  guint8 *data;
+  gsize size;
+  guint count, i, v;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 1) {
+    GError *err = NULL;
+
+    if (!g_file_get_contents (argv[1], (gchar **) & data, &size, &err)) {
+      g_print ("usage: %s [<Annex B stream>]\n%s\n", argv[0], err->message);
+      g_clear_error (&err);
+      return 1;
+    }
+  } else {
+    size = STREAM_SIZE;
+    data = generate_stream (size);
+  }
+
+  adapter = fill_adapter (data, size);
+
+  for (v = 0; v < 2; v++) {
+    count = 0;
+    start = gst_util_get_timestamp ();
+    for (i = 0; i < RUNS; i++)
+      count += scan_adapter (adapter, v);
+    end = gst_util_get_timestamp ();
+    report ("adapter", v, size * RUNS, count / RUNS, end - start);
+  }
+
+  for (v = 0; v < 2; v++) {
+    count = 0;
+    start = gst_util_get_timestamp ();
+    for (i = 0; i < RUNS; i++)
+      count += scan_reader (data, size, v);
+    end = gst_util_get_timestamp ();
+    report ("reader", v, size * RUNS, count / RUNS, end - start);
+  }
+
+  g_object_unref (adapter);
+  g_free (data);
+
+  return 0;
+}
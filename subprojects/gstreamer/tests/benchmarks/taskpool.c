@@ -0,0 +1,167 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Runs many small pipelines at the same time, either with a thread per task
+ * or with all tasks on a shared work stealing task pool, and measures how
+ * long it takes until all of them are EOS. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <gst/gst.h>
+
+#define PIPELINE_COUNT (500)
+#define BUFFER_COUNT (1000)
+
+static GstTaskPool *pool = NULL;
+
+static GstBusSyncReply
+stream_status_cb (GstBus * bus, GstMessage * message, gpointer user_data)
+{
+  GstStreamStatusType type;
+  GstElement *owner;
+  const GValue *val;
+
+  if (GST_MESSAGE_TYPE (message) != GST_MESSAGE_STREAM_STATUS)
+    return GST_BUS_PASS;
+
+  gst_message_parse_stream_status (message, &type, &owner);
+  if (type != GST_STREAM_STATUS_TYPE_CREATE)
+    return GST_BUS_PASS;
+
+  val = gst_message_get_stream_status_object (message);
+  if (G_VALUE_HOLDS_OBJECT (val) && GST_IS_TASK (g_value_get_object (val)))
+    gst_task_set_pool (GST_TASK (g_value_get_object (val)), pool);
+
+  return GST_BUS_PASS;
+}
+
+static guint
+count_threads (void)
+{
+  guint threads = 0;
+#ifdef __linux__
+  gchar line[256];
+  FILE *f;
+
+  f = fopen ("/proc/self/status", "r");
+  if (f == NULL)
+    return 0;
+  while (fgets (line, sizeof (line), f)) {
+    if (sscanf (line, "Threads: %u", &threads) == 1)
+      break;
+  }
+  fclose (f);
+#endif
+  return threads;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstElement **pipelines;
+  GstClockTime start, end;
+  guint i, n_pipelines = PIPELINE_COUNT, buffers = BUFFER_COUNT;
+  guint threads, n_workers = 0;
+  gboolean pooled = FALSE;
+  gchar *desc;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 1) {
+    if (strcmp (argv[1], "pool") == 0)
+      pooled = TRUE;
+    else if (strcmp (argv[1], "thread") != 0)
+      goto usage;
+  }
+  if (argc > 2)
+    n_pipelines = atoi (argv[2]);
+  if (argc > 3)
+    buffers = atoi (argv[3]);
+  if (argc > 4)
+    n_workers = atoi (argv[4]);
+
+  if (n_pipelines == 0)
+    goto usage;
+
+  if (pooled) {
+    pool = gst_work_stealing_task_pool_new (n_workers);
+    gst_task_pool_prepare (pool, NULL);
+    g_print ("running %u pipelines on a pool with %u workers\n", n_pipelines,
+        gst_work_stealing_task_pool_get_n_workers (GST_WORK_STEALING_TASK_POOL
+            (pool)));
+  } else {
+    g_print ("running %u pipelines with a thread per task\n", n_pipelines);
+  }
+
+  desc = g_strdup_printf ("fakesrc num-buffers=%u sizetype=fixed sizemax=1024 "
+      "! queue ! fakesink", buffers);
+
+  pipelines = g_new (GstElement *, n_pipelines);
+  for (i = 0; i < n_pipelines; i++) {
+    GstBus *bus;
+
+    pipelines[i] = gst_parse_launch (desc, NULL);
+    g_assert (pipelines[i] != NULL);
+
+    if (pooled) {
+      bus = gst_element_get_bus (pipelines[i]);
+      gst_bus_set_sync_handler (bus, stream_status_cb, NULL, NULL);
+      gst_object_unref (bus);
+    }
+  }
+  g_free (desc);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_pipelines; i++)
+    gst_element_set_state (pipelines[i], GST_STATE_PLAYING);
+  threads = count_threads ();
+
+  for (i = 0; i < n_pipelines; i++) {
+    GstMessage *msg;
+
+    msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipelines[i]),
+        GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+    if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+      g_print ("pipeline %u failed\n", i);
+    gst_message_unref (msg);
+  }
+  end = gst_util_get_timestamp ();
+
+  g_print ("%" GST_TIME_FORMAT " - %u pipelines with %u buffers each, "
+      "%u threads\n", GST_TIME_ARGS (end - start), n_pipelines, buffers,
+      threads);
+
+  for (i = 0; i < n_pipelines; i++) {
+    gst_element_set_state (pipelines[i], GST_STATE_NULL);
+    gst_object_unref (pipelines[i]);
+  }
+  g_free (pipelines);
+
+  if (pool) {
+    gst_task_pool_cleanup (pool);
+    gst_object_unref (pool);
+  }
+
+  return 0;
+
+usage:
+  g_print ("usage: %s [thread|pool] [<pipelines> [<buffers> [<workers>]]]\n",
+      argv[0]);
+  return 1;
+}
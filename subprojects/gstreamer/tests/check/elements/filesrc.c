@@ -303,6 +303,80 @@ GST_START_TEST (test_pull)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pull_io_uring)
+{
+  GstElement *src;
+  GstPad *pad;
+  GstFlowReturn ret;
+  GstBuffer *buffer1, *buffer2;
+  GstMapInfo info1, info2;
+  GstStructure *stats = NULL;
+  guint i;
+
+  src = setup_filesrc ();
+
+  /* falls back to blocking reads if io_uring is not available */
+  g_object_set (G_OBJECT (src), "location", TESTFILE, "io-uring", TRUE,
+      "io-uring-depth", 2, NULL);
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to ready");
+
+  pad = gst_element_get_static_pad (src, "src");
+  fail_unless (pad != NULL);
+  fail_unless (gst_pad_activate_mode (pad, GST_PAD_MODE_PULL, TRUE));
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  buffer1 = NULL;
+  ret = gst_pad_get_range (pad, 0, 400, &buffer1);
+  fail_unless_equals_int (ret, GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_get_size (buffer1), 400);
+  fail_unless (gst_buffer_map (buffer1, &info1, GST_MAP_READ));
+
+  /* going back reads directly, the blocks after that are read ahead */
+  for (i = 0; i < 4; i++) {
+    buffer2 = NULL;
+    ret = gst_pad_get_range (pad, i * 100, 100, &buffer2);
+    fail_unless_equals_int (ret, GST_FLOW_OK);
+    fail_unless_equals_int (gst_buffer_get_size (buffer2), 100);
+    fail_unless_equals_int (GST_BUFFER_OFFSET (buffer2), i * 100);
+
+    fail_unless (gst_buffer_map (buffer2, &info2, GST_MAP_READ));
+    fail_unless (memcmp ((guint8 *) info1.data + i * 100, info2.data,
+            100) == 0);
+    gst_buffer_unmap (buffer2, &info2);
+    gst_buffer_unref (buffer2);
+  }
+
+  /* a shorter read at the position of a read-ahead block */
+  buffer2 = NULL;
+  ret = gst_pad_get_range (pad, 400, 10, &buffer2);
+  fail_unless_equals_int (ret, GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_get_size (buffer2), 10);
+  gst_buffer_unref (buffer2);
+
+  gst_buffer_unmap (buffer1, &info1);
+  gst_buffer_unref (buffer1);
+
+  g_object_get (src, "stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_has_name (stats,
+          "application/x-gst-file-src-stats"));
+  fail_unless (gst_structure_has_field_typed (stats, "throughput",
+          G_TYPE_DOUBLE));
+  gst_structure_free (stats);
+
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  gst_object_unref (pad);
+  cleanup_filesrc (src);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_coverage)
 {
   GstElement *src;
@@ -554,6 +628,7 @@ filesrc_suite (void)
   tcase_add_test (tc_chain, test_seeking);
   tcase_add_test (tc_chain, test_reverse);
   tcase_add_test (tc_chain, test_pull);
+  tcase_add_test (tc_chain, test_pull_io_uring);
   tcase_add_test (tc_chain, test_coverage);
   tcase_add_test (tc_chain, test_uri_interface);
   tcase_add_test (tc_chain, test_uri_query);
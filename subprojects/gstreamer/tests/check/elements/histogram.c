@@ -0,0 +1,213 @@
+/* GStreamer
+ *
+ * Unit test for the histogram tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+#define NUM_BUFFERS 10
+#define BUFFER_SIZE 1000
+
+static GstTracer *
+get_tracer_by_name (const gchar * name)
+{
+  GList *tracers, *l;
+  GstTracer *tracer = NULL;
+
+  tracers = gst_tracing_get_active_tracers ();
+  for (l = tracers; l; l = l->next)
+    if (g_strcmp0 (GST_OBJECT_NAME (l->data), name) == 0)
+      tracer = l->data;
+
+  g_list_free (tracers);
+  return tracer;
+}
+
+static GstElement *
+run_pipeline (void)
+{
+  GstElement *pipe;
+  GstMessage *m;
+
+  pipe = gst_parse_launch ("fakesrc name=src num-buffers=10 sizetype=fixed "
+      "sizemax=1000 ! queue name=q ! fakesink name=sink", NULL);
+  fail_unless (pipe);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+  m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), -1, GST_MESSAGE_EOS);
+  gst_message_unref (m);
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  return pipe;
+}
+
+static const GstStructure *
+find_pad (const GstStructure * info, const gchar * element, const gchar * pad)
+{
+  const GValue *pads = gst_structure_get_value (info, "pads");
+  guint i;
+
+  fail_unless (G_VALUE_HOLDS (pads, GST_TYPE_LIST));
+  for (i = 0; i < gst_value_list_get_size (pads); i++) {
+    const GstStructure *s =
+        gst_value_get_structure (gst_value_list_get_value (pads, i));
+
+    if (!g_strcmp0 (gst_structure_get_string (s, "element"), element) &&
+        !g_strcmp0 (gst_structure_get_string (s, "pad"), pad))
+      return s;
+  }
+
+  return NULL;
+}
+
+static const GstStructure *
+get_histogram (const GstStructure * info, const gchar * element,
+    const gchar * pad, const gchar * name)
+{
+  const GstStructure *s = find_pad (info, element, pad);
+  const GValue *v;
+
+  fail_unless (s != NULL, "no histograms for %s:%s", element, pad);
+  if (!(v = gst_structure_get_value (s, name)))
+    return NULL;
+
+  return gst_value_get_structure (v);
+}
+
+static guint64
+get_field (const GstStructure * histogram, const gchar * name)
+{
+  guint64 val;
+
+  fail_unless (gst_structure_get_uint64 (histogram, name, &val));
+  return val;
+}
+
+GST_START_TEST (test_get_histograms)
+{
+  GstTracer *tracer = get_tracer_by_name ("hist");
+  const GstStructure *h;
+  GstStructure *info;
+  GstElement *pipe;
+
+  fail_unless (tracer);
+  pipe = run_pipeline ();
+
+  g_signal_emit_by_name (tracer, "get-histograms", &info);
+  fail_unless (info);
+
+  h = get_histogram (info, "src", "src", "size");
+  fail_unless (h);
+  fail_unless_equals_uint64 (get_field (h, "count"), NUM_BUFFERS);
+  fail_unless (get_field (h, "min") <= BUFFER_SIZE);
+  fail_unless (get_field (h, "max") >= BUFFER_SIZE);
+  fail_unless (get_field (h, "p50") >= BUFFER_SIZE);
+  fail_unless (get_field (h, "p50") <= get_field (h, "p99"));
+  /* log-linear buckets are within 12.5% */
+  fail_unless (get_field (h, "max") - get_field (h, "min") <= BUFFER_SIZE / 8);
+
+  h = get_histogram (info, "src", "src", "gap");
+  fail_unless (h);
+  fail_unless_equals_uint64 (get_field (h, "count"), NUM_BUFFERS - 1);
+
+  /* the time spent in the chain function of the receiving pads */
+  h = get_histogram (info, "q", "sink", "processing-time");
+  fail_unless (h);
+  fail_unless_equals_uint64 (get_field (h, "count"), NUM_BUFFERS);
+  h = get_histogram (info, "sink", "sink", "processing-time");
+  fail_unless (h);
+  fail_unless_equals_uint64 (get_field (h, "count"), NUM_BUFFERS);
+
+  /* the queue pushes out the buffers it received */
+  h = get_histogram (info, "q", "src", "residency");
+  fail_unless (h);
+  fail_unless_equals_uint64 (get_field (h, "count"), NUM_BUFFERS);
+  fail_unless (get_field (h, "min") <= get_field (h, "max"));
+
+  /* not pushed out by the source itself */
+  fail_if (get_histogram (info, "src", "src", "residency"));
+
+  gst_structure_free (info);
+
+  g_signal_emit_by_name (tracer, "log-histograms");
+
+  gst_object_unref (pipe);
+  gst_object_unref (tracer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_reset_histograms)
+{
+  GstTracer *tracer = get_tracer_by_name ("hist");
+  GstStructure *info;
+  GstElement *pipe;
+
+  fail_unless (tracer);
+  pipe = run_pipeline ();
+
+  g_signal_emit_by_name (tracer, "reset-histograms");
+  g_signal_emit_by_name (tracer, "get-histograms", &info);
+
+  fail_if (get_histogram (info, "src", "src", "size"));
+  fail_if (get_histogram (info, "sink", "sink", "processing-time"));
+  gst_structure_free (info);
+
+  /* the histograms go away with the pads */
+  gst_object_unref (pipe);
+  g_signal_emit_by_name (tracer, "get-histograms", &info);
+  fail_if (find_pad (info, "src", "src"));
+  gst_structure_free (info);
+
+  gst_object_unref (tracer);
+}
+
+GST_END_TEST;
+
+static Suite *
+histogramtracer_suite (void)
+{
+  Suite *s = suite_create ("histogramtracer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_get_histograms);
+  tcase_add_test (tc_chain, test_reset_histograms);
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (histogramtracer); because we need to set
+ * the env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  g_setenv ("GST_TRACERS",
+      "histogram(name=hist,flags=processing-time+gap+residency+size)", TRUE);
+  gst_check_init (&argc, &argv);
+  s = histogramtracer_suite ();
+  return gst_check_run_suite (s, "histogramtracer", __FILE__);
+}
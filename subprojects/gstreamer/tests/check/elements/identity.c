@@ -102,6 +102,60 @@ GST_START_TEST (test_signal_handoffs)
 
 GST_END_TEST;
 
+static void
+handoff_count_func (GstElement * identity, GstBuffer * buf, guint * count)
+{
+  (void) identity;
+  (*count)++;
+}
+
+GST_START_TEST (test_buffer_list)
+{
+  GstHarness *h = gst_harness_new ("identity");
+  GstElement *identity;
+  GstBufferList *list;
+  guint count = 0;
+  guint i;
+
+  gst_harness_set_src_caps_str (h, "mycaps");
+  g_object_set (h->element, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (h->element, "handoff",
+      G_CALLBACK (handoff_count_func), &count);
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 3; i++)
+    gst_buffer_list_add (list, gst_buffer_new_and_alloc (4));
+
+  fail_unless_equals_int (GST_FLOW_OK, gst_pad_push_list (h->srcpad, list));
+  fail_unless_equals_int (count, 3);
+  fail_unless_equals_int (gst_harness_buffers_received (h), 3);
+
+  gst_harness_teardown (h);
+
+  /* eos-after needs the buffers one by one, the list is split and only the
+   * buffer before the EOS one is pushed */
+  identity = gst_element_factory_make ("identity", NULL);
+  g_object_set (identity, "eos-after", 2, "signal-handoffs", TRUE, NULL);
+  h = gst_harness_new_with_element (identity, "sink", "src");
+  gst_object_unref (identity);
+  gst_harness_set_src_caps_str (h, "mycaps");
+  count = 0;
+  g_signal_connect (h->element, "handoff",
+      G_CALLBACK (handoff_count_func), &count);
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 3; i++)
+    gst_buffer_list_add (list, gst_buffer_new_and_alloc (4));
+
+  fail_unless_equals_int (GST_FLOW_EOS, gst_pad_push_list (h->srcpad, list));
+  fail_unless_equals_int (count, 1);
+  fail_unless_equals_int (gst_harness_buffers_received (h), 1);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_sync_on_timestamp)
 {
   /* the reason to use the queue in front of the identity element
@@ -192,6 +246,7 @@ identity_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_one_buffer);
   tcase_add_test (tc_chain, test_signal_handoffs);
+  tcase_add_test (tc_chain, test_buffer_list);
   tcase_add_test (tc_chain, test_sync_on_timestamp);
   tcase_add_test (tc_chain, test_stopping_element_unschedules_sync);
 
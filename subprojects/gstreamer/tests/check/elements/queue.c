@@ -1383,6 +1383,154 @@ GST_START_TEST (test_time_level_before_output)
 
 GST_END_TEST;
 
+static GList *lock_free_items;
+
+static GstPadProbeReturn
+record_item_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  lock_free_items = g_list_append (lock_free_items, info->data);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* push buffers while nothing else is queued, then an event and another buffer
+ * and check that they come out in order */
+GST_START_TEST (test_lock_free)
+{
+  GstBuffer *buffer[4];
+  GstEvent *event;
+  GstSegment segment;
+  guint i, level;
+
+  g_object_set (queue, "lock-free", TRUE, NULL);
+
+  mysinkpad = gst_check_setup_sink_pad (queue, &sinktemplate);
+  gst_pad_set_event_function (mysinkpad, event_func);
+  gst_pad_add_probe (mysinkpad, GST_PAD_PROBE_TYPE_DATA_DOWNSTREAM,
+      record_item_probe, NULL, NULL);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+  gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment));
+
+  /* wait until the queue is empty again */
+  g_mutex_lock (&events_lock);
+  while (events_count < 2)
+    g_cond_wait (&events_cond, &events_lock);
+  g_mutex_unlock (&events_lock);
+
+  qsrcpad = gst_element_get_static_pad (queue, "src");
+  probe_id = gst_pad_add_probe (qsrcpad,
+      GST_PAD_PROBE_TYPE_BLOCK | GST_PAD_PROBE_TYPE_BUFFER, NULL, NULL, NULL);
+
+  for (i = 0; i < 3; i++) {
+    buffer[i] = gst_buffer_new_and_alloc (4);
+    fail_unless (gst_pad_push (mysrcpad, buffer[i]) == GST_FLOW_OK);
+  }
+
+  event = gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM,
+      gst_structure_new_empty ("test"));
+  fail_unless (gst_pad_push_event (mysrcpad, event));
+
+  buffer[3] = gst_buffer_new_and_alloc (4);
+  fail_unless (gst_pad_push (mysrcpad, buffer[3]) == GST_FLOW_OK);
+
+  /* the first buffer might be blocked in the probe already */
+  g_object_get (queue, "current-level-buffers", &level, NULL);
+  fail_unless (level >= 3);
+
+  unblock_src ();
+  gst_pad_push_event (mysrcpad, gst_event_new_eos ());
+
+  g_mutex_lock (&events_lock);
+  while (events_count < 4)
+    g_cond_wait (&events_cond, &events_lock);
+  g_mutex_unlock (&events_lock);
+
+  fail_unless_equals_int (g_list_length (lock_free_items), 8);
+  fail_unless (g_list_nth_data (lock_free_items, 2) == buffer[0]);
+  fail_unless (g_list_nth_data (lock_free_items, 3) == buffer[1]);
+  fail_unless (g_list_nth_data (lock_free_items, 4) == buffer[2]);
+  fail_unless (g_list_nth_data (lock_free_items, 5) == event);
+  fail_unless (g_list_nth_data (lock_free_items, 6) == buffer[3]);
+
+  g_object_get (queue, "current-level-buffers", &level, NULL);
+  fail_unless_equals_int (level, 0);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  g_list_free (lock_free_items);
+  lock_free_items = NULL;
+}
+
+GST_END_TEST;
+
+/* the queue picks up the budget from a context and accounts what it holds */
+GST_START_TEST (test_memory_budget)
+{
+  GstMemoryBudget *budget, *tmp = NULL;
+  GstContext *context;
+  GstSegment segment;
+  guint i, priority;
+
+  budget = gst_memory_budget_new (1000);
+  context = gst_context_new (GST_MEMORY_BUDGET_CONTEXT_TYPE, TRUE);
+  gst_context_set_memory_budget (context, budget);
+  gst_element_set_context (queue, context);
+  gst_context_unref (context);
+
+  g_object_set (queue, "memory-budget-priority", 2, NULL);
+  g_object_get (queue, "memory-budget", &tmp, "memory-budget-priority",
+      &priority, NULL);
+  fail_unless (tmp == budget);
+  fail_unless_equals_int (priority, 2);
+  gst_object_unref (tmp);
+
+  mysinkpad = gst_check_setup_sink_pad (queue, &sinktemplate);
+  gst_pad_set_event_function (mysinkpad, event_func);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+  gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment));
+
+  block_src ();
+
+  for (i = 0; i < 3; i++)
+    fail_unless (gst_pad_push (mysrcpad,
+            gst_buffer_new_and_alloc (100)) == GST_FLOW_OK);
+
+  /* the first buffer might be blocked in the probe already */
+  fail_unless (gst_memory_budget_get_used (budget) >= 200);
+
+  unblock_src ();
+  gst_pad_push_event (mysrcpad, gst_event_new_eos ());
+
+  g_mutex_lock (&events_lock);
+  while (events_count < 3)
+    g_cond_wait (&events_cond, &events_lock);
+  g_mutex_unlock (&events_lock);
+
+  fail_unless_equals_uint64 (gst_memory_budget_get_used (budget), 0);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  gst_object_unref (budget);
+}
+
+GST_END_TEST;
+
 static Suite *
 queue_suite (void)
 {
@@ -1408,6 +1556,8 @@ queue_suite (void)
   tcase_add_test (tc_chain, test_initial_events_nodelay);
   tcase_add_test (tc_chain, test_flush_on_error);
   tcase_add_test (tc_chain, test_time_level_before_output);
+  tcase_add_test (tc_chain, test_lock_free);
+  tcase_add_test (tc_chain, test_memory_budget);
 
   return s;
 }
@@ -922,6 +922,137 @@ GST_START_TEST (test_time_level_before_output)
 
 GST_END_TEST;
 
+#define PATTERN_BUFFERS 128
+
+static gpointer
+push_pattern (GstPad * sinkpad)
+{
+  GstBuffer *buffer;
+  guint i;
+
+  /* every KiB holds its index */
+  for (i = 0; i < PATTERN_BUFFERS; i++) {
+    buffer = gst_buffer_new_and_alloc (1024);
+    gst_buffer_memset (buffer, 0, i & 0xff, 1024);
+    if (gst_pad_chain (sinkpad, buffer) != GST_FLOW_OK)
+      break;
+  }
+
+  return NULL;
+}
+
+static void
+check_pattern (GstBuffer * buffer, guint64 offset)
+{
+  GstMapInfo map;
+  gsize i;
+
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+  for (i = 0; i < map.size; i++)
+    fail_unless_equals_int (map.data[i], ((offset + i) / 1024) & 0xff);
+  gst_buffer_unmap (buffer, &map);
+}
+
+/* reads everything back from a ring buffer in memory or in a temp file, or
+ * from a plain temp file if @ring_buffer_max_size is 0 */
+static void
+do_test_zero_copy (const gchar * temp_template, guint64 ring_buffer_max_size)
+{
+  GstElement *queue2;
+  GstBuffer *first, *buffer;
+  GstPad *sinkpad, *srcpad;
+  GThread *thread;
+  GstSegment segment;
+  GstMemory *mem;
+  guint64 offset;
+
+  queue2 = gst_element_factory_make ("queue2", NULL);
+  sinkpad = gst_element_get_static_pad (queue2, "sink");
+  srcpad = gst_element_get_static_pad (queue2, "src");
+
+  g_object_set (queue2, "ring-buffer-max-size", ring_buffer_max_size,
+      "temp-template", temp_template, "zero-copy", TRUE,
+      "use-buffering", FALSE, "max-size-buffers", (guint) 0,
+      "max-size-time", (guint64) 0, "max-size-bytes", (guint) 64 * 1024,
+      NULL);
+
+  gst_pad_activate_mode (srcpad, GST_PAD_MODE_PULL, TRUE);
+  gst_element_set_state (queue2, GST_STATE_PLAYING);
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_send_event (sinkpad, gst_event_new_stream_start ("test"));
+  gst_pad_send_event (sinkpad, gst_event_new_segment (&segment));
+
+  thread =
+      g_thread_try_new ("gst-check", (GThreadFunc) push_pattern, sinkpad,
+      NULL);
+  fail_unless (thread != NULL);
+
+  /* the data is not copied into the output buffer */
+  first = NULL;
+  fail_unless (gst_pad_get_range (srcpad, 0, 4096, &first) == GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_get_size (first), 4096);
+  fail_unless_equals_int (gst_buffer_n_memory (first), 1);
+  mem = gst_buffer_peek_memory (first, 0);
+  fail_unless (mem->parent != NULL);
+  fail_unless (GST_MEMORY_IS_READONLY (mem));
+  check_pattern (first, 0);
+
+  /* read everything, a ring buffer wraps around while the first buffer is
+   * still used */
+  for (offset = 4096; offset < PATTERN_BUFFERS * 1024; offset += 4096) {
+    buffer = NULL;
+    fail_unless (gst_pad_get_range (srcpad, offset, 4096,
+            &buffer) == GST_FLOW_OK);
+    fail_unless_equals_int (gst_buffer_get_size (buffer), 4096);
+    check_pattern (buffer, offset);
+    gst_buffer_unref (buffer);
+  }
+
+  /* and it was not overwritten */
+  check_pattern (first, 0);
+
+  gst_element_set_state (queue2, GST_STATE_NULL);
+  g_thread_join (thread);
+
+  /* still valid after the queue released its ring buffer */
+  check_pattern (first, 0);
+  gst_buffer_unref (first);
+
+  gst_object_unref (sinkpad);
+  gst_object_unref (srcpad);
+  gst_object_unref (queue2);
+}
+
+GST_START_TEST (test_zero_copy_ring_buffer)
+{
+  do_test_zero_copy (NULL, 64 * 1024);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_zero_copy_temp_file)
+{
+  gchar *template;
+
+  template = g_build_filename (g_get_tmp_dir (), "queue2-test-XXXXXX", NULL);
+  do_test_zero_copy (template, 64 * 1024);
+  g_free (template);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_zero_copy_temp_file_no_ring_buffer)
+{
+  gchar *template;
+
+  template = g_build_filename (g_get_tmp_dir (), "queue2-test-XXXXXX", NULL);
+  do_test_zero_copy (template, 0);
+  g_free (template);
+}
+
+GST_END_TEST;
+
 static Suite *
 queue2_suite (void)
 {
@@ -942,6 +1073,9 @@ queue2_suite (void)
   tcase_add_test (tc_chain, test_ready_paused_buffering_message);
   tcase_add_test (tc_chain, test_flush_on_error);
   tcase_add_test (tc_chain, test_time_level_before_output);
+  tcase_add_test (tc_chain, test_zero_copy_ring_buffer);
+  tcase_add_test (tc_chain, test_zero_copy_temp_file);
+  tcase_add_test (tc_chain, test_zero_copy_temp_file_no_ring_buffer);
 
   return s;
 }
@@ -940,6 +940,201 @@ GST_START_TEST (test_allocation_query_empty)
 
 GST_END_TEST;
 
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  gboolean blocked;
+  guint count;
+  guint64 last_offset;
+  gboolean eos;
+} BranchData;
+
+static GstFlowReturn
+_branch_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  BranchData *branch = gst_pad_get_element_private (pad);
+
+  g_mutex_lock (&branch->lock);
+  while (branch->blocked)
+    g_cond_wait (&branch->cond, &branch->lock);
+  branch->count++;
+  branch->last_offset = GST_BUFFER_OFFSET (buffer);
+  g_cond_broadcast (&branch->cond);
+  g_mutex_unlock (&branch->lock);
+
+  gst_buffer_unref (buffer);
+  return GST_FLOW_OK;
+}
+
+static gboolean
+_branch_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  BranchData *branch = gst_pad_get_element_private (pad);
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_EOS) {
+    g_mutex_lock (&branch->lock);
+    branch->eos = TRUE;
+    g_cond_broadcast (&branch->cond);
+    g_mutex_unlock (&branch->lock);
+  }
+
+  gst_event_unref (event);
+  return TRUE;
+}
+
+static void
+branch_set_blocked (BranchData * branch, gboolean blocked)
+{
+  g_mutex_lock (&branch->lock);
+  branch->blocked = blocked;
+  g_cond_broadcast (&branch->cond);
+  g_mutex_unlock (&branch->lock);
+}
+
+static void
+branch_wait_count (BranchData * branch, guint count)
+{
+  g_mutex_lock (&branch->lock);
+  while (branch->count < count)
+    g_cond_wait (&branch->cond, &branch->lock);
+  g_mutex_unlock (&branch->lock);
+}
+
+static void
+branch_wait_eos (BranchData * branch)
+{
+  g_mutex_lock (&branch->lock);
+  while (!branch->eos)
+    g_cond_wait (&branch->cond, &branch->lock);
+  g_mutex_unlock (&branch->lock);
+}
+
+/* Pushes @num_buffers buffers into a parallel tee with two branches while the
+ * first branch is blocked, the second branch must not wait for it. */
+static void
+do_test_parallel (const gchar * leaky, guint max_size_buffers,
+    guint num_buffers, BranchData * branches)
+{
+  GstElement *tee;
+  GstTaskPool *pool;
+  GstPad *mysrc, *mysinks[2], *teesink, *teesrcs[2];
+  GstSegment segment;
+  GstCaps *caps;
+  guint i;
+
+  tee = gst_element_factory_make ("tee", NULL);
+  fail_unless (tee != NULL);
+  /* two workers, so that the second branch does not depend on the blocked
+   * first branch releasing its worker */
+  pool = gst_work_stealing_task_pool_new (2);
+  gst_task_pool_prepare (pool, NULL);
+  g_object_set (tee, "parallel", TRUE, "max-size-buffers", max_size_buffers,
+      "task-pool", pool, NULL);
+  gst_util_set_object_arg (G_OBJECT (tee), "leaky", leaky);
+
+  teesink = gst_element_get_static_pad (tee, "sink");
+  mysrc = gst_pad_new ("mysrc", GST_PAD_SRC);
+  gst_pad_set_active (mysrc, TRUE);
+  fail_unless (gst_pad_link (mysrc, teesink) == GST_PAD_LINK_OK);
+
+  for (i = 0; i < 2; i++) {
+    g_mutex_init (&branches[i].lock);
+    g_cond_init (&branches[i].cond);
+
+    teesrcs[i] = gst_element_request_pad_simple (tee, "src_%u");
+    fail_unless (teesrcs[i] != NULL);
+    mysinks[i] = gst_pad_new (NULL, GST_PAD_SINK);
+    gst_pad_set_element_private (mysinks[i], &branches[i]);
+    gst_pad_set_chain_function (mysinks[i], _branch_chain);
+    gst_pad_set_event_function (mysinks[i], _branch_event);
+    gst_pad_set_active (mysinks[i], TRUE);
+    fail_unless (gst_pad_link (teesrcs[i], mysinks[i]) == GST_PAD_LINK_OK);
+  }
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+
+  caps = gst_caps_new_empty_simple ("test/test");
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (mysrc, gst_event_new_stream_start ("test"));
+  gst_pad_set_caps (mysrc, caps);
+  gst_pad_push_event (mysrc, gst_event_new_segment (&segment));
+  gst_caps_unref (caps);
+
+  branch_set_blocked (&branches[0], TRUE);
+  for (i = 0; i < num_buffers; i++) {
+    GstBuffer *buffer = gst_buffer_new ();
+
+    GST_BUFFER_OFFSET (buffer) = i;
+    fail_unless_equals_int (gst_pad_push (mysrc, buffer), GST_FLOW_OK);
+  }
+  branch_wait_count (&branches[1], num_buffers);
+  fail_unless_equals_int (branches[0].count, 0);
+
+  branch_set_blocked (&branches[0], FALSE);
+  fail_unless (gst_pad_push_event (mysrc, gst_event_new_eos ()));
+  branch_wait_eos (&branches[0]);
+  branch_wait_eos (&branches[1]);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+
+  for (i = 0; i < 2; i++) {
+    gst_element_release_request_pad (tee, teesrcs[i]);
+    gst_object_unref (teesrcs[i]);
+    gst_object_unref (mysinks[i]);
+    g_mutex_clear (&branches[i].lock);
+    g_cond_clear (&branches[i].cond);
+  }
+  gst_object_unref (teesink);
+  gst_object_unref (mysrc);
+  gst_object_unref (tee);
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+}
+
+GST_START_TEST (test_parallel)
+{
+  BranchData branches[2] = { {{0,},}, };
+
+  do_test_parallel ("no", 10, 10, branches);
+
+  fail_unless_equals_int (branches[0].count, 10);
+  fail_unless_equals_int (branches[1].count, 10);
+  fail_unless_equals_int (branches[0].last_offset, 9);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_parallel_leaky_upstream)
+{
+  BranchData branches[2] = { {{0,},}, };
+
+  do_test_parallel ("upstream", 2, 10, branches);
+
+  /* the buffer the branch was blocked on and the first ones queued */
+  fail_unless (branches[0].count >= 1 && branches[0].count <= 3);
+  fail_unless (branches[0].last_offset <= 2);
+  fail_unless_equals_int (branches[1].count, 10);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_parallel_leaky_downstream)
+{
+  BranchData branches[2] = { {{0,},}, };
+
+  do_test_parallel ("downstream", 2, 10, branches);
+
+  /* the buffer the branch was blocked on and the last ones queued */
+  fail_unless (branches[0].count >= 1 && branches[0].count <= 3);
+  fail_unless_equals_int (branches[0].last_offset, 9);
+  fail_unless_equals_int (branches[1].count, 10);
+}
+
+GST_END_TEST;
+
 
 static Suite *
 tee_suite (void)
@@ -963,6 +1158,9 @@ tee_suite (void)
   tcase_add_test (tc_chain, test_allocation_query_allow_not_linked);
   tcase_add_test (tc_chain, test_allocation_query_failure);
   tcase_add_test (tc_chain, test_allocation_query_empty);
+  tcase_add_test (tc_chain, test_parallel);
+  tcase_add_test (tc_chain, test_parallel_leaky_upstream);
+  tcase_add_test (tc_chain, test_parallel_leaky_downstream);
 
   return s;
 }
@@ -2639,6 +2639,82 @@ GST_START_TEST (test_caps_in_set_in_caps_subset)
 
 GST_END_TEST;
 
+GST_START_TEST (test_intern)
+{
+  GstCaps *caps1, *caps2, *tmpl, *res, *res2;
+
+  caps1 = gst_caps_from_string ("audio/x-raw, rate = (int) 48000, "
+      "channels = (int) 2");
+  fail_if (gst_caps_is_interned (caps1));
+  caps1 = gst_caps_intern (caps1);
+  fail_unless (gst_caps_is_interned (caps1));
+  fail_if (gst_caps_is_writable (caps1));
+
+  /* equal caps are interned to the same instance */
+  caps2 = gst_caps_from_string ("audio/x-raw, rate = (int) 48000, "
+      "channels = (int) 2");
+  caps2 = gst_caps_intern (caps2);
+  fail_unless (caps1 == caps2);
+  gst_caps_unref (caps2);
+
+  /* also with a different field order */
+  caps2 = gst_caps_from_string ("audio/x-raw, channels = (int) 2, "
+      "rate = (int) 48000");
+  caps2 = gst_caps_intern (caps2);
+  fail_unless (caps1 == caps2);
+  gst_caps_unref (caps2);
+
+  /* non-writable caps are copied */
+  caps2 = gst_caps_from_string ("audio/x-raw, rate = (int) 44100");
+  res = gst_caps_ref (caps2);
+  caps2 = gst_caps_intern (caps2);
+  fail_unless (caps2 != res);
+  fail_if (gst_caps_is_interned (res));
+  fail_unless (gst_caps_is_strictly_equal (caps2, res));
+  gst_caps_unref (res);
+
+  /* copies are not interned */
+  res = gst_caps_copy (caps1);
+  fail_if (gst_caps_is_interned (res));
+  gst_caps_unref (res);
+
+  tmpl = gst_caps_intern (gst_caps_from_string ("audio/x-raw, "
+          "rate = (int) [ 1, 48000 ], channels = (int) [ 1, 2 ]"));
+
+  /* the cached results are the same as the computed ones */
+  fail_unless (gst_caps_is_subset (caps1, tmpl));
+  fail_unless (gst_caps_is_subset (caps1, tmpl));
+  fail_if (gst_caps_is_subset (tmpl, caps1));
+  fail_if (gst_caps_is_subset (tmpl, caps1));
+  fail_unless (gst_caps_can_intersect (caps1, tmpl));
+  fail_unless (gst_caps_can_intersect (caps1, tmpl));
+  fail_unless (gst_caps_can_intersect (caps2, tmpl));
+  fail_if (gst_caps_can_intersect (caps1, caps2));
+  fail_if (gst_caps_can_intersect (caps1, caps2));
+
+  res = gst_caps_intersect (caps1, tmpl);
+  fail_unless (gst_caps_is_strictly_equal (res, caps1));
+  res2 = gst_caps_intersect (caps1, tmpl);
+  fail_unless (res == res2);
+  gst_caps_unref (res2);
+  res2 = gst_caps_intersect_full (caps1, tmpl, GST_CAPS_INTERSECT_FIRST);
+  fail_unless (gst_caps_is_strictly_equal (res2, caps1));
+  gst_caps_unref (res2);
+  gst_caps_unref (res);
+
+  res = gst_caps_intersect (caps1, caps2);
+  fail_unless (gst_caps_is_empty (res));
+  gst_caps_unref (res);
+  res = gst_caps_intersect (caps1, caps2);
+  fail_unless (gst_caps_is_empty (res));
+  gst_caps_unref (res);
+
+  gst_caps_unref (tmpl);
+  gst_caps_unref (caps2);
+  gst_caps_unref (caps1);
+}
+
+GST_END_TEST;
 
 static Suite *
 gst_caps_suite (void)
@@ -2684,6 +2760,7 @@ gst_caps_suite (void)
   tcase_add_test (tc_chain, test_nested);
   tcase_add_test (tc_chain, test_array_subset);
   tcase_add_test (tc_chain, test_caps_in_set_in_caps_subset);
+  tcase_add_test (tc_chain, test_intern);
 
   return s;
 }
@@ -28,6 +28,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 
 #include <string.h>
 
@@ -569,6 +570,126 @@ GST_START_TEST (info_set_and_reset_string)
 
 GST_END_TEST;
 
+GST_START_TEST (info_ring_buffer_logger)
+{
+  GstElement *bin;
+  GstCaps *caps;
+  gchar **logs, **decoded, *expected, *tmp_file, *contents;
+  gsize size;
+  gint fd, i;
+
+  gst_debug_remove_log_function (gst_debug_log_default);
+  gst_debug_add_ring_buffer_logger (64 * 1024, 0);
+  gst_debug_set_threshold_from_string ("LOG", TRUE);
+
+  bin = gst_bin_new ("testbin");
+  caps = gst_caps_new_simple ("video/x-raw", "width", G_TYPE_INT, 320, NULL);
+
+  /* the arguments are stored unformatted and formatted when fetched */
+  GST_DEBUG_OBJECT (bin, "int %d uint %03u i64 %" G_GINT64_FORMAT " str %s "
+      "%.3s double %.2f caps %" GST_PTR_FORMAT " width %*d char %c %%", -5, 7,
+      G_GINT64_CONSTANT (-1234567890123), "hello", "abcdef", 1.5, caps, 4, 42,
+      'x');
+  GST_DEBUG ("literal %s", "message");
+  gst_debug_log_literal (GST_CAT_DEFAULT, GST_LEVEL_INFO, __FILE__,
+      GST_FUNCTION, __LINE__, NULL, "pre-formatted %d");
+
+  logs = gst_debug_ring_buffer_logger_get_logs ();
+  fail_unless (logs != NULL);
+  fail_unless_equals_int (g_strv_length (logs), 1);
+
+  expected = gst_info_strdup_printf ("int %d uint %03u i64 %" G_GINT64_FORMAT
+      " str %s %.3s double %.2f caps %" GST_PTR_FORMAT " width %*d char %c %%",
+      -5, 7, G_GINT64_CONSTANT (-1234567890123), "hello", "abcdef", 1.5, caps,
+      4, 42, 'x');
+  fail_unless (strstr (logs[0], expected) != NULL, "'%s' not in '%s'",
+      expected, logs[0]);
+  fail_unless (strstr (logs[0], "width=(int)320") != NULL);
+  fail_unless (strstr (logs[0], "<testbin> int -5") != NULL);
+  fail_unless (strstr (logs[0], ":info_ring_buffer_logger: literal message\n")
+      != NULL);
+  fail_unless (strstr (logs[0], "INFO") != NULL);
+  fail_unless (strstr (logs[0], " pre-formatted %d\n") != NULL);
+  g_free (expected);
+
+  /* a dump decodes to the same logs */
+  fd = g_file_open_tmp (NULL, &tmp_file, NULL);
+  fail_unless (fd >= 0);
+  fail_unless (gst_debug_ring_buffer_logger_dump (fd));
+  g_close (fd, NULL);
+  fail_unless (g_file_get_contents (tmp_file, &contents, &size, NULL));
+  g_unlink (tmp_file);
+  g_free (tmp_file);
+
+  decoded = gst_debug_ring_buffer_logger_decode ((const guint8 *) contents,
+      size);
+  fail_unless (decoded != NULL);
+  fail_unless_equals_int (g_strv_length (decoded), 1);
+  fail_unless_equals_string (decoded[0], logs[0]);
+
+  /* truncated dumps decode up to the last complete message */
+  g_strfreev (decoded);
+  decoded = gst_debug_ring_buffer_logger_decode ((const guint8 *) contents,
+      size - 10);
+  fail_unless (decoded != NULL);
+  fail_unless (g_str_has_prefix (logs[0], decoded[0]));
+  fail_unless (strlen (decoded[0]) < strlen (logs[0]));
+  g_strfreev (decoded);
+
+  fail_unless (gst_debug_ring_buffer_logger_decode ((const guint8 *)
+          "garbage", 7) == NULL);
+  g_free (contents);
+  g_strfreev (logs);
+
+  /* the format can be freed right after logging */
+  gst_debug_remove_ring_buffer_logger ();
+  gst_debug_add_ring_buffer_logger (64 * 1024, 0);
+  expected = g_strdup ("heap format %d %s");
+  call_GST_INFO (expected, 42, "arg");
+  memset (expected, 'x', strlen (expected));
+  g_free (expected);
+
+  fd = g_file_open_tmp (NULL, &tmp_file, NULL);
+  fail_unless (fd >= 0);
+  fail_unless (gst_debug_ring_buffer_logger_dump (fd));
+  g_close (fd, NULL);
+  fail_unless (g_file_get_contents (tmp_file, &contents, &size, NULL));
+  g_unlink (tmp_file);
+  g_free (tmp_file);
+
+  decoded = gst_debug_ring_buffer_logger_decode ((const guint8 *) contents,
+      size);
+  fail_unless (decoded != NULL);
+  fail_unless_equals_int (g_strv_length (decoded), 1);
+  fail_unless (strstr (decoded[0], " heap format 42 arg\n") != NULL);
+  g_strfreev (decoded);
+  g_free (contents);
+
+  logs = gst_debug_ring_buffer_logger_get_logs ();
+  fail_unless (strstr (logs[0], " heap format 42 arg\n") != NULL);
+  g_strfreev (logs);
+
+  /* old messages are dropped when the ring is full */
+  gst_debug_remove_ring_buffer_logger ();
+  gst_debug_add_ring_buffer_logger (1024, 0);
+  for (i = 0; i < 100; i++)
+    GST_DEBUG ("message %03d", i);
+
+  logs = gst_debug_ring_buffer_logger_get_logs ();
+  fail_unless_equals_int (g_strv_length (logs), 1);
+  fail_unless (strstr (logs[0], "message 099\n") != NULL);
+  fail_unless (strstr (logs[0], "message 000\n") == NULL);
+  g_strfreev (logs);
+
+  gst_caps_unref (caps);
+  gst_object_unref (bin);
+  gst_debug_remove_ring_buffer_logger ();
+  gst_debug_set_default_threshold (GST_LEVEL_NONE);
+  gst_debug_add_log_function (gst_debug_log_default, NULL, NULL);
+}
+
+GST_END_TEST;
+
 static gint context_log_count = 0;
 
 static void
@@ -827,6 +948,7 @@ gst_info_suite (void)
   tcase_add_test (tc_chain, info_set_and_unset_multiple);
   tcase_add_test (tc_chain, info_post_gst_init_category_registration);
   tcase_add_test (tc_chain, info_set_and_reset_string);
+  tcase_add_test (tc_chain, info_ring_buffer_logger);
 
   tcase_add_test (tc_chain, info_context_log);
   tcase_add_test (tc_chain, info_context_log_once);
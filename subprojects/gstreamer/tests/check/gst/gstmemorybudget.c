@@ -0,0 +1,202 @@
+/* GStreamer
+ *
+ * unit test for GstMemoryBudget
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+GST_START_TEST (test_accounting)
+{
+  GstMemoryBudget *budget;
+  GstMemoryBudgetClient *c1, *c2;
+  GstStructure *stats;
+  guint64 peak;
+  guint clients;
+
+  budget = gst_memory_budget_new (1000);
+  fail_unless_equals_uint64 (gst_memory_budget_get_limit (budget), 1000);
+
+  c1 = gst_memory_budget_client_new (budget, NULL, 1);
+  c2 = gst_memory_budget_client_new (budget, NULL, 1);
+
+  gst_memory_budget_client_set_used (c1, 300);
+  gst_memory_budget_client_set_used (c2, 200);
+  fail_unless_equals_uint64 (gst_memory_budget_get_used (budget), 500);
+
+  gst_memory_budget_client_set_used (c1, 100);
+  fail_unless_equals_uint64 (gst_memory_budget_get_used (budget), 300);
+
+  stats = gst_memory_budget_get_stats (budget);
+  fail_unless (gst_structure_has_name (stats, "GstMemoryBudgetStats"));
+  fail_unless (gst_structure_get (stats, "peak", G_TYPE_UINT64, &peak,
+          "clients", G_TYPE_UINT, &clients, NULL));
+  fail_unless_equals_uint64 (peak, 500);
+  fail_unless_equals_int (clients, 2);
+  gst_structure_free (stats);
+
+  /* removing a client releases what it held */
+  gst_memory_budget_client_free (c1);
+  fail_unless_equals_uint64 (gst_memory_budget_get_used (budget), 200);
+  gst_memory_budget_client_free (c2);
+  fail_unless_equals_uint64 (gst_memory_budget_get_used (budget), 0);
+
+  ASSERT_OBJECT_REFCOUNT (budget, "budget", 1);
+  gst_object_unref (budget);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_priority_share)
+{
+  GstMemoryBudget *budget;
+  GstMemoryBudgetClient *low, *high, *idle;
+
+  budget = gst_memory_budget_new (1000);
+  low = gst_memory_budget_client_new (budget, NULL, 1);
+  high = gst_memory_budget_client_new (budget, NULL, 3);
+  idle = gst_memory_budget_client_new (budget, NULL, 1);
+
+  /* the shares are 200, 600 and 200 bytes, but clients can use more than
+   * their share while the budget is not exhausted */
+  gst_memory_budget_client_set_used (low, 500);
+  fail_if (gst_memory_budget_client_is_exhausted (low));
+
+  gst_memory_budget_client_set_used (high, 500);
+  fail_unless (gst_memory_budget_client_is_exhausted (low));
+  fail_if (gst_memory_budget_client_is_exhausted (high));
+
+  /* clients that hold nothing are never blocked */
+  fail_if (gst_memory_budget_client_is_exhausted (idle));
+  fail_unless (gst_memory_budget_client_wait (idle));
+
+  gst_memory_budget_client_set_priority (low, 10);
+  fail_if (gst_memory_budget_client_is_exhausted (low));
+  gst_memory_budget_client_set_priority (low, 1);
+  fail_unless (gst_memory_budget_client_is_exhausted (low));
+
+  gst_memory_budget_set_limit (budget, 0);
+  fail_if (gst_memory_budget_client_is_exhausted (low));
+
+  gst_memory_budget_client_free (low);
+  gst_memory_budget_client_free (high);
+  gst_memory_budget_client_free (idle);
+  gst_object_unref (budget);
+}
+
+GST_END_TEST;
+
+static gpointer
+wait_thread (GstMemoryBudgetClient * client)
+{
+  return GINT_TO_POINTER (gst_memory_budget_client_wait (client));
+}
+
+static void
+wait_until_waiting (GstMemoryBudget * budget)
+{
+  GstStructure *stats;
+  guint waiting;
+
+  do {
+    g_usleep (1000);
+    stats = gst_memory_budget_get_stats (budget);
+    fail_unless (gst_structure_get_uint (stats, "waiting", &waiting));
+    gst_structure_free (stats);
+  } while (waiting == 0);
+}
+
+GST_START_TEST (test_wait)
+{
+  GstMemoryBudget *budget;
+  GstMemoryBudgetClient *c1, *c2;
+  GThread *thread;
+
+  budget = gst_memory_budget_new (1000);
+  c1 = gst_memory_budget_client_new (budget, NULL, 1);
+  c2 = gst_memory_budget_client_new (budget, NULL, 1);
+
+  gst_memory_budget_client_set_used (c1, 800);
+  gst_memory_budget_client_set_used (c2, 200);
+
+  /* released by another client */
+  thread = g_thread_new ("wait", (GThreadFunc) wait_thread, c1);
+  wait_until_waiting (budget);
+  gst_memory_budget_client_set_used (c2, 0);
+  fail_unless (GPOINTER_TO_INT (g_thread_join (thread)));
+
+  /* woken up by flushing */
+  gst_memory_budget_client_set_used (c2, 200);
+  thread = g_thread_new ("wait", (GThreadFunc) wait_thread, c1);
+  wait_until_waiting (budget);
+  gst_memory_budget_client_set_flushing (c1, TRUE);
+  fail_if (GPOINTER_TO_INT (g_thread_join (thread)));
+
+  fail_if (gst_memory_budget_client_wait (c1));
+  gst_memory_budget_client_set_flushing (c1, FALSE);
+
+  gst_memory_budget_client_free (c1);
+  gst_memory_budget_client_free (c2);
+  gst_object_unref (budget);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_context)
+{
+  GstMemoryBudget *budget, *tmp = NULL;
+  GstContext *context;
+
+  budget = gst_memory_budget_new (1000);
+
+  context = gst_context_new (GST_MEMORY_BUDGET_CONTEXT_TYPE, TRUE);
+  fail_if (gst_context_get_memory_budget (context, &tmp));
+  gst_context_set_memory_budget (context, budget);
+  fail_unless (gst_context_get_memory_budget (context, &tmp));
+  fail_unless (tmp == budget);
+  gst_object_unref (tmp);
+  gst_context_unref (context);
+
+  context = gst_context_new ("other", TRUE);
+  fail_if (gst_context_get_memory_budget (context, NULL));
+  gst_context_unref (context);
+
+  ASSERT_OBJECT_REFCOUNT (budget, "budget", 1);
+  gst_object_unref (budget);
+}
+
+GST_END_TEST;
+
+static Suite *
+gst_memory_budget_suite (void)
+{
+  Suite *s = suite_create ("GstMemoryBudget");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_accounting);
+  tcase_add_test (tc_chain, test_priority_share);
+  tcase_add_test (tc_chain, test_wait);
+  tcase_add_test (tc_chain, test_context);
+
+  return s;
+}
+
+GST_CHECK_MAIN (gst_memory_budget);
@@ -1496,6 +1496,92 @@ GST_START_TEST (test_pad_blocking_with_probe_type_idle)
 
 GST_END_TEST;
 
+#define IDLE_STRESS_N_THREADS 4
+#define IDLE_STRESS_N_PROBES 1000
+
+static gint idle_stress_in_chain;
+static gint idle_stress_stop;
+
+static GstFlowReturn
+idle_stress_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
+{
+  g_atomic_int_inc (&idle_stress_in_chain);
+  g_thread_yield ();
+  g_atomic_int_add (&idle_stress_in_chain, -1);
+  gst_buffer_unref (buf);
+  return GST_FLOW_OK;
+}
+
+static GstPadProbeReturn
+idle_stress_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  gint *called = user_data;
+
+  /* never while a buffer is being pushed */
+  fail_unless_equals_int (g_atomic_int_get (&idle_stress_in_chain), 0);
+  g_atomic_int_inc (called);
+
+  return GST_PAD_PROBE_REMOVE;
+}
+
+static gpointer
+idle_stress_push (GstPad * pad)
+{
+  while (!g_atomic_int_get (&idle_stress_stop))
+    gst_pad_push (pad, gst_buffer_new ());
+
+  return NULL;
+}
+
+GST_START_TEST (test_pad_idle_probe_stress)
+{
+  GstPad *srcpad, *sinkpad;
+  GThread *threads[IDLE_STRESS_N_THREADS];
+  gint called[IDLE_STRESS_N_PROBES] = { 0, };
+  gint i;
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  sinkpad = gst_pad_new ("sink", GST_PAD_SINK);
+  gst_pad_set_chain_function (sinkpad, idle_stress_chain);
+  fail_unless (gst_pad_link (srcpad, sinkpad) == GST_PAD_LINK_OK);
+
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_pad_set_active (srcpad, TRUE);
+
+  fail_unless (gst_pad_push_event (srcpad,
+          gst_event_new_stream_start ("test")) == TRUE);
+  fail_unless (gst_pad_push_event (srcpad,
+          gst_event_new_segment (&dummy_segment)) == TRUE);
+
+  idle_stress_in_chain = 0;
+  idle_stress_stop = 0;
+  for (i = 0; i < IDLE_STRESS_N_THREADS; i++) {
+    threads[i] = g_thread_new ("idle-stress-push",
+        (GThreadFunc) idle_stress_push, srcpad);
+  }
+
+  /* each probe is called exactly once, either right away or by the last
+   * pushing thread leaving the pad */
+  for (i = 0; i < IDLE_STRESS_N_PROBES; i++) {
+    gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_IDLE, idle_stress_probe,
+        &called[i], NULL);
+    if (i % 16 == 0)
+      g_thread_yield ();
+  }
+
+  g_atomic_int_set (&idle_stress_stop, 1);
+  for (i = 0; i < IDLE_STRESS_N_THREADS; i++)
+    g_thread_join (threads[i]);
+
+  for (i = 0; i < IDLE_STRESS_N_PROBES; i++)
+    fail_unless_equals_int (called[i], 1);
+
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+}
+
+GST_END_TEST;
+
 static gboolean pull_probe_called;
 static gboolean pull_probe_called_with_bad_type;
 static gboolean pull_probe_called_with_bad_data;
@@ -3622,6 +3708,7 @@ gst_pad_suite (void)
   tcase_add_test (tc_chain, test_pad_blocking_with_probe_type_block);
   tcase_add_test (tc_chain, test_pad_blocking_with_probe_type_blocking);
   tcase_add_test (tc_chain, test_pad_blocking_with_probe_type_idle);
+  tcase_add_test (tc_chain, test_pad_idle_probe_stress);
   tcase_add_test (tc_chain, test_pad_probe_pull);
   tcase_add_test (tc_chain, test_pad_probe_pull_idle);
   tcase_add_test (tc_chain, test_pad_probe_pull_buffer);
@@ -203,6 +203,60 @@ GST_START_TEST (test_registry_update)
 
 GST_END_TEST;
 
+/* details of factories loaded from the registry cache are only deserialized
+ * when they are first needed, check that they are complete */
+GST_START_TEST (test_registry_factory_details)
+{
+  GstElementFactory *factory;
+  const GList *templates;
+  const gchar *const *protocols;
+  gchar **keys;
+
+  factory = gst_element_factory_find ("queue");
+  fail_unless (factory != NULL);
+
+  fail_unless_equals_string (gst_element_factory_get_metadata (factory,
+          GST_ELEMENT_METADATA_LONGNAME), "Queue");
+  keys = gst_element_factory_get_metadata_keys (factory);
+  fail_unless (keys != NULL);
+  fail_unless (g_strv_contains ((const gchar * const *) keys,
+          GST_ELEMENT_METADATA_KLASS));
+  g_strfreev (keys);
+
+  fail_unless_equals_int (gst_element_factory_get_num_pad_templates (factory),
+      2);
+  templates = gst_element_factory_get_static_pad_templates (factory);
+  fail_unless_equals_int (g_list_length ((GList *) templates), 2);
+  for (; templates; templates = templates->next) {
+    GstStaticPadTemplate *templ = templates->data;
+
+    fail_unless_equals_int (templ->presence, GST_PAD_ALWAYS);
+    if (templ->direction == GST_PAD_SRC)
+      fail_unless_equals_string (templ->name_template, "src");
+    else
+      fail_unless_equals_string (templ->name_template, "sink");
+    fail_unless_equals_string (templ->static_caps.string, "ANY");
+  }
+  fail_unless_equals_int (gst_element_factory_get_uri_type (factory),
+      GST_URI_UNKNOWN);
+  fail_unless (gst_element_factory_get_uri_protocols (factory) == NULL);
+  gst_object_unref (factory);
+
+  factory = gst_element_factory_find ("filesrc");
+  fail_unless (factory != NULL);
+
+  fail_unless_equals_int (gst_element_factory_get_uri_type (factory),
+      GST_URI_SRC);
+  protocols = gst_element_factory_get_uri_protocols (factory);
+  fail_unless (protocols != NULL);
+  fail_unless (g_strv_contains (protocols, "file"));
+  fail_unless (gst_element_factory_has_interface (factory, "GstURIHandler"));
+  fail_unless (gst_element_factory_can_src_any_caps (factory, GST_CAPS_ANY));
+  gst_object_unref (factory);
+}
+
+GST_END_TEST;
+
 static Suite *
 registry_suite (void)
 {
@@ -212,6 +266,7 @@ registry_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_registry_update);
+  tcase_add_test (tc_chain, test_registry_factory_details);
 
   return s;
 }
@@ -384,6 +384,104 @@ GST_START_TEST (test_stress_reschedule)
 
 GST_END_TEST;
 
+#define ORDER_NUM_IDS 100
+
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  guint num_fired;
+  gint fired[ORDER_NUM_IDS];
+} AsyncOrderData;
+
+static gboolean
+test_async_order_callback (GstClock * clock, GstClockTime time,
+    GstClockID id, gpointer user_data)
+{
+  AsyncOrderData *data = g_object_get_data (G_OBJECT (clock), "order-data");
+
+  g_mutex_lock (&data->lock);
+  data->fired[data->num_fired++] = GPOINTER_TO_INT (user_data);
+  g_cond_signal (&data->cond);
+  g_mutex_unlock (&data->lock);
+
+  return TRUE;
+}
+
+GST_START_TEST (test_async_order)
+{
+  AsyncOrderData data = { 0, };
+  GstClockID ids[ORDER_NUM_IDS];
+  GstClock *clock;
+  GstClockTime base;
+  gint order[ORDER_NUM_IDS];
+  guint i, expected = 0;
+
+  clock = g_object_new (GST_TYPE_SYSTEM_CLOCK, "name", "TestClock", NULL);
+  gst_object_ref_sink (clock);
+  g_object_set_data (G_OBJECT (clock), "order-data", &data);
+  g_mutex_init (&data.lock);
+  g_cond_init (&data.cond);
+
+  /* every two ids share the same time and must fire in the order in which
+   * they were scheduled */
+  base = gst_clock_get_time (clock) + 50 * GST_MSECOND;
+  for (i = 0; i < ORDER_NUM_IDS; i++) {
+    ids[i] = gst_clock_new_single_shot_id (clock,
+        base + (i / 2) * 100 * GST_USECOND);
+    order[i] = i;
+  }
+
+  /* schedule in random order, but keep the ids with the same time in order */
+  for (i = 0; i < ORDER_NUM_IDS / 2; i++) {
+    guint j = g_random_int_range (0, ORDER_NUM_IDS / 2);
+    gint tmp0 = order[2 * i], tmp1 = order[2 * i + 1];
+
+    order[2 * i] = order[2 * j];
+    order[2 * i + 1] = order[2 * j + 1];
+    order[2 * j] = tmp0;
+    order[2 * j + 1] = tmp1;
+  }
+  for (i = 0; i < ORDER_NUM_IDS; i++) {
+    fail_unless (gst_clock_id_wait_async (ids[order[i]],
+            test_async_order_callback, GINT_TO_POINTER (order[i]),
+            NULL) == GST_CLOCK_OK);
+  }
+
+  /* unscheduled ids must not fire */
+  for (i = 0; i < ORDER_NUM_IDS; i++) {
+    if (i % 3 == 0)
+      gst_clock_id_unschedule (ids[i]);
+    else
+      expected++;
+  }
+
+  g_mutex_lock (&data.lock);
+  while (data.num_fired < expected)
+    g_cond_wait (&data.cond, &data.lock);
+  g_mutex_unlock (&data.lock);
+
+  /* give unscheduled ids a chance to fire wrongly */
+  g_usleep (20 * 1000);
+
+  g_mutex_lock (&data.lock);
+  fail_unless_equals_int (data.num_fired, expected);
+  for (i = 0; i < data.num_fired; i++) {
+    fail_unless (data.fired[i] % 3 != 0);
+    if (i > 0)
+      fail_unless (data.fired[i - 1] < data.fired[i]);
+  }
+  g_mutex_unlock (&data.lock);
+
+  for (i = 0; i < ORDER_NUM_IDS; i++)
+    gst_clock_id_unref (ids[i]);
+
+  gst_object_unref (clock);
+  g_cond_clear (&data.cond);
+  g_mutex_clear (&data.lock);
+}
+
+GST_END_TEST;
 
 static Suite *
 gst_systemclock_suite (void)
@@ -396,6 +494,7 @@ gst_systemclock_suite (void)
   tcase_add_test (tc_chain, test_signedness);
   tcase_add_test (tc_chain, test_diff);
   tcase_add_test (tc_chain, test_async_full);
+  tcase_add_test (tc_chain, test_async_order);
   tcase_add_test (tc_chain, test_set_default);
   tcase_add_test (tc_chain, test_resolution);
   tcase_add_test (tc_chain, test_stress_cleanup_unschedule);
@@ -464,6 +464,135 @@ GST_START_TEST (test_shared_task_pool_two_threads)
 
 GST_END_TEST;
 
+#define WS_NUM_TASKS 4
+
+static void
+count_iterations_func (gint * count)
+{
+  g_atomic_int_inc (count);
+  g_thread_yield ();
+}
+
+/* In this test, we run more tasks than the work stealing pool has workers
+ * and verify that all of them make progress */
+GST_START_TEST (test_work_stealing_task_pool_tasks)
+{
+  GstTaskPool *pool;
+  GstTask *tasks[WS_NUM_TASKS];
+  GRecMutex locks[WS_NUM_TASKS];
+  gint counts[WS_NUM_TASKS] = { 0, };
+  GError *err = NULL;
+  gint i, paused_count;
+
+  pool = gst_work_stealing_task_pool_new (1);
+  fail_unless_equals_int (gst_work_stealing_task_pool_get_n_workers
+      (GST_WORK_STEALING_TASK_POOL (pool)), 1);
+  gst_task_pool_prepare (pool, &err);
+  fail_unless (err == NULL);
+
+  for (i = 0; i < WS_NUM_TASKS; i++) {
+    tasks[i] = gst_task_new ((GstTaskFunction) count_iterations_func,
+        &counts[i], NULL);
+    g_rec_mutex_init (&locks[i]);
+    gst_task_set_lock (tasks[i], &locks[i]);
+    gst_task_set_pool (tasks[i], pool);
+    fail_unless (gst_task_start (tasks[i]));
+  }
+
+  for (i = 0; i < WS_NUM_TASKS; i++) {
+    while (g_atomic_int_get (&counts[i]) < 100)
+      g_usleep (1000);
+  }
+
+  /* paused tasks stop iterating and don't occupy the worker */
+  fail_unless (gst_task_pause (tasks[0]));
+  g_rec_mutex_lock (&locks[0]);
+  paused_count = g_atomic_int_get (&counts[0]);
+  g_rec_mutex_unlock (&locks[0]);
+  i = g_atomic_int_get (&counts[1]);
+  while (g_atomic_int_get (&counts[1]) < i + 100)
+    g_usleep (1000);
+  fail_unless_equals_int (g_atomic_int_get (&counts[0]), paused_count);
+
+  fail_unless (gst_task_resume (tasks[0]));
+  while (g_atomic_int_get (&counts[0]) < paused_count + 100)
+    g_usleep (1000);
+
+  for (i = 0; i < WS_NUM_TASKS; i++) {
+    fail_unless (gst_task_join (tasks[i]));
+    fail_unless (gst_task_get_state (tasks[i]) == GST_TASK_STOPPED);
+    gst_object_unref (tasks[i]);
+    g_rec_mutex_clear (&locks[i]);
+  }
+
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
+static void
+blocking_task_cb (TaskData * tdata)
+{
+  gst_task_pool_blocking_begin ();
+  task_cb (tdata);
+  gst_task_pool_blocking_end ();
+}
+
+static void
+unblocking_task_cb (TaskData * tdata)
+{
+  tdata->called = TRUE;
+
+  g_mutex_lock (&tdata->unblock_lock);
+  tdata->unblock = TRUE;
+  g_cond_signal (&tdata->unblock_cond);
+  g_mutex_unlock (&tdata->unblock_lock);
+}
+
+/* In this test, a job on a work stealing pool with a single worker blocks
+ * until a second job runs, which needs another worker to take over */
+GST_START_TEST (test_work_stealing_task_pool_blocking)
+{
+  GstTaskPool *pool;
+  gpointer handle, handle2;
+  GError *err = NULL;
+  TaskData tdata;
+
+  init_task_data (&tdata);
+
+  pool = gst_work_stealing_task_pool_new (1);
+  gst_task_pool_prepare (pool, &err);
+  fail_unless (err == NULL);
+
+  handle = gst_task_pool_push (pool, (GstTaskPoolFunction) blocking_task_cb,
+      &tdata, &err);
+  fail_unless (err == NULL);
+
+  g_mutex_lock (&tdata.blocked_lock);
+  while (!tdata.blocked)
+    g_cond_wait (&tdata.blocked_cond, &tdata.blocked_lock);
+  g_mutex_unlock (&tdata.blocked_lock);
+
+  /* the unblocking data is shared with the first job */
+  handle2 = gst_task_pool_push (pool, (GstTaskPoolFunction) unblocking_task_cb,
+      &tdata, &err);
+  fail_unless (err == NULL);
+
+  gst_task_pool_join (pool, handle);
+  gst_task_pool_join (pool, handle2);
+
+  fail_unless (tdata.called == TRUE);
+  fail_unless (tdata.unblock == TRUE);
+
+  cleanup_task_data (&tdata);
+
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_task_suite (void)
 {
@@ -480,6 +609,8 @@ gst_task_suite (void)
   tcase_add_test (tc_chain, test_resume);
   tcase_add_test (tc_chain, test_shared_task_pool_shared_thread);
   tcase_add_test (tc_chain, test_shared_task_pool_two_threads);
+  tcase_add_test (tc_chain, test_work_stealing_task_pool_tasks);
+  tcase_add_test (tc_chain, test_work_stealing_task_pool_blocking);
 
   return s;
 }
@@ -26,6 +26,7 @@
 #include <gst/check/gstcheck.h>
 
 #include <gst/base/gstadapter.h>
+#include "startcodes.h"
 
 /* does some implementation dependent checking that should 
  * also be optimal 
@@ -1168,6 +1169,49 @@ GST_START_TEST (test_scan)
 
 GST_END_TEST;
 
+GST_START_TEST (test_scan_start_code)
+{
+  GstAdapter *adapter;
+  guint8 data[300];
+  guint chunk, i, offset;
+
+  fill_start_code_data (data, sizeof (data));
+
+  adapter = gst_adapter_new ();
+
+  /* start codes that span buffers of all sizes */
+  for (chunk = 1; chunk <= 40; chunk++) {
+    for (i = 0; i < sizeof (data); i += chunk) {
+      gst_adapter_push (adapter, gst_buffer_new_memdup (data + i,
+              MIN (chunk, sizeof (data) - i)));
+    }
+
+    for (offset = 0; offset < sizeof (data); offset++) {
+      guint sizes[] = { sizeof (data) - offset,
+        MIN (19, sizeof (data) - offset)
+      };
+
+      for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+        gint expected = find_start_code (data, offset, sizes[i]);
+        guint32 value = 0;
+        gint found;
+
+        found = gst_adapter_masked_scan_uint32_peek (adapter, 0xffffff00,
+            0x00000100, offset, sizes[i], &value);
+        fail_unless_equals_int (found, expected);
+        if (found >= 0)
+          fail_unless_equals_int (value, GST_READ_UINT32_BE (data + found));
+      }
+    }
+
+    gst_adapter_clear (adapter);
+  }
+
+  g_object_unref (adapter);
+}
+
+GST_END_TEST;
+
 /* Fill a buffer with a sequence of 32 bit ints and read them back out
  * using take_buffer, checking that they're still in the right order */
 GST_START_TEST (test_take_list)
@@ -1465,6 +1509,7 @@ gst_adapter_suite (void)
   tcase_add_test (tc_chain, test_take_buf_order);
   tcase_add_test (tc_chain, test_timestamp);
   tcase_add_test (tc_chain, test_scan);
+  tcase_add_test (tc_chain, test_scan_start_code);
   tcase_add_test (tc_chain, test_take_list);
   tcase_add_test (tc_chain, test_get_list);
   tcase_add_test (tc_chain, test_take_buffer_list);
@@ -62,6 +62,7 @@ struct _GstTestAggregator
   gboolean gap_expected;
   gboolean do_flush_on_aggregate;
   gboolean do_remove_pad_on_aggregate;
+  guint batch_limit;
 };
 
 struct _GstTestAggregatorClass
@@ -80,6 +81,7 @@ gst_test_aggregator_aggregate (GstAggregator * aggregator, gboolean timeout)
   gboolean done_iterating = FALSE;
 
   testagg = GST_TEST_AGGREGATOR (aggregator);
+  testagg->batch_limit = gst_aggregator_get_batch_limit (aggregator);
 
   iter = gst_element_iterate_sink_pads (GST_ELEMENT (testagg));
   while (!done_iterating) {
@@ -1456,6 +1458,53 @@ GST_START_TEST (test_force_live)
 
 GST_END_TEST;
 
+GST_START_TEST (test_batch_limit_and_stats)
+{
+  GstElement *agg;
+  GstHarness *h;
+  GstBuffer *buf;
+  GstPad *sinkpad;
+  GstStructure *stats;
+  guint64 calls, buffers;
+
+  agg = gst_check_setup_element ("testaggregator");
+  g_object_set (agg, "batch-size", 4, NULL);
+  h = gst_harness_new_with_element (agg, "sink_%u", "src");
+  gst_harness_set_live (h, FALSE);
+  gst_harness_set_src_caps_str (h, "foo/bar");
+
+  buf = gst_buffer_new ();
+  GST_BUFFER_PTS (buf) = 0;
+  GST_BUFFER_DURATION (buf) = BUFFER_DURATION;
+  fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  gst_buffer_unref (gst_harness_pull (h));
+
+  /* not live, everything queued may be aggregated at once */
+  fail_unless_equals_int (GST_TEST_AGGREGATOR (agg)->batch_limit, 4);
+
+  g_object_get (agg, "stats", &stats, NULL);
+  fail_unless (gst_structure_has_name (stats,
+          "application/x-gst-aggregator-stats"));
+  fail_unless (gst_structure_get_uint64 (stats, "aggregate-calls", &calls));
+  fail_unless (calls >= 1);
+  fail_unless (gst_structure_has_field (stats, "aggregate-time"));
+  fail_unless (gst_structure_has_field (stats, "wait-time"));
+  gst_structure_free (stats);
+
+  sinkpad = GST_PAD_PEER (h->srcpad);
+  g_object_get (sinkpad, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "buffers", &buffers));
+  fail_unless_equals_uint64 (buffers, 1);
+  fail_unless (gst_structure_has_field (stats, "wait-time"));
+  fail_unless (gst_structure_has_field (stats, "blocked-time"));
+  gst_structure_free (stats);
+
+  gst_harness_teardown (h);
+  gst_object_unref (agg);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_aggregator_suite (void)
 {
@@ -1487,6 +1536,7 @@ gst_aggregator_suite (void)
   tcase_add_test (general, test_flush_on_aggregate);
   tcase_add_test (general, test_remove_pad_on_aggregate);
   tcase_add_test (general, test_force_live);
+  tcase_add_test (general, test_batch_limit_and_stats);
 
   return suite;
 }
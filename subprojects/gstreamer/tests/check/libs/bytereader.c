@@ -28,6 +28,7 @@
 #include <gst/check/gstcheck.h>
 #include <gst/base/gstbytereader.h>
 #include "gst/glib-compat-private.h"
+#include "startcodes.h"
 
 #ifndef fail_unless_equals_int64
 #define fail_unless_equals_int64(a, b)					\
@@ -608,6 +609,37 @@ GST_START_TEST (test_scan)
 
 GST_END_TEST;
 
+GST_START_TEST (test_scan_start_code)
+{
+  GstByteReader reader;
+  guint8 *data;
+  guint i, offset, size = 300;
+
+  /* allocate so valgrind can detect out of bounds access more easily */
+  data = g_malloc (size);
+  fill_start_code_data (data, size);
+
+  for (offset = 0; offset < size; offset++) {
+    for (i = 1; offset + i <= size; i++) {
+      gint expected = find_start_code (data, offset, i);
+      guint32 value = 0;
+      gint found;
+
+      /* the scanned range ends at the end of the data */
+      gst_byte_reader_init (&reader, data, offset + i);
+      found = gst_byte_reader_masked_scan_uint32_peek (&reader, 0xffffff00,
+          0x00000100, offset, i, &value);
+      fail_unless_equals_int (found, expected);
+      if (found >= 0)
+        fail_unless_equals_int (value, GST_READ_UINT32_BE (data + found));
+    }
+  }
+
+  g_free (data);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_string_funcs)
 {
   GstByteReader reader, backup;
@@ -836,6 +868,7 @@ gst_byte_reader_suite (void)
   tcase_add_test (tc_chain, test_get_float_be);
   tcase_add_test (tc_chain, test_position_tracking);
   tcase_add_test (tc_chain, test_scan);
+  tcase_add_test (tc_chain, test_scan_start_code);
   tcase_add_test (tc_chain, test_string_funcs);
   tcase_add_test (tc_chain, test_dup_string);
   tcase_add_test (tc_chain, test_sub_reader);
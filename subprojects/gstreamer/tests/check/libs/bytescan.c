@@ -0,0 +1,137 @@
+/* GStreamer
+ *
+ * unit test for the vectorized start code scanners
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/base/gstbytescan-private.h>
+#include "startcodes.h"
+
+/* Copies @size bytes of @src to the end of a new allocation at @align bytes
+ * after its start, so that valgrind notices reads after the end */
+static guint8 *
+copy_unaligned (const guint8 * src, guint size, guint align, guint8 ** mem)
+{
+  *mem = g_malloc (size + align);
+  memcpy (*mem + align, src, size);
+
+  return *mem + align;
+}
+
+/* checks @impl against the C version and the reference with @data at
+ * @n_aligns alignments */
+static void
+check_impl (const GstByteScanImpl * impl, const guint8 * data, guint size,
+    guint n_aligns)
+{
+  guint align;
+
+  for (align = 0; align < n_aligns; align++) {
+    guint8 *mem, *copy;
+    gssize expected, found;
+
+    copy = copy_unaligned (data, size, align, &mem);
+    expected = find_start_code (copy, 0, size);
+    fail_unless_equals_int (gst_byte_scan_start_code_c (copy, size),
+        expected);
+    found = impl->scan_start_code (copy, size);
+    fail_unless (found == expected, "%s found %" G_GSSIZE_FORMAT
+        " instead of %" G_GSSIZE_FORMAT " in %u bytes at alignment %u",
+        impl->name, found, expected, size, align);
+    g_free (mem);
+  }
+}
+
+GST_START_TEST (test_scan_start_code_random)
+{
+  const GstByteScanImpl *impls;
+  guint n_impls, i, size;
+  guint8 *data;
+
+  data = g_malloc (4200);
+  fill_start_code_data (data, 4200);
+
+  impls = gst_byte_scan_get_implementations (&n_impls);
+  fail_unless (n_impls > 0);
+  fail_unless_equals_string (impls[n_impls - 1].name, "c");
+
+  for (i = 0; i < n_impls; i++) {
+    GST_INFO ("checking %s", impls[i].name);
+
+    /* all small sizes and the tails of a few bigger ones */
+    for (size = 0; size <= 200; size++)
+      check_impl (&impls[i], data, size, 64);
+    for (size = 4096 - 40; size <= 4200; size++)
+      check_impl (&impls[i], data, size, 64);
+  }
+
+  g_free (data);
+}
+
+GST_END_TEST;
+
+/* start codes in otherwise empty data at all positions, so that they are at
+ * every place in a vector block and in the tail that is handled by the C
+ * version */
+GST_START_TEST (test_scan_start_code_positions)
+{
+  const GstByteScanImpl *impls;
+  guint n_impls, i, size, pos;
+  guint8 data[100];
+
+  impls = gst_byte_scan_get_implementations (&n_impls);
+
+  for (i = 0; i < n_impls; i++) {
+    for (size = 0; size <= sizeof (data); size++) {
+      for (pos = 0; pos + 3 <= size; pos++) {
+        memset (data, 0xff, size);
+        data[pos] = 0x00;
+        data[pos + 1] = 0x00;
+        data[pos + 2] = 0x01;
+        /* a start code that is not followed by another byte is not found */
+        check_impl (&impls[i], data, size, 8);
+
+        /* runs of zeros before it */
+        memset (data, 0x00, pos);
+        check_impl (&impls[i], data, size, 8);
+      }
+    }
+  }
+}
+
+GST_END_TEST;
+
+static Suite *
+gst_byte_scan_suite (void)
+{
+  Suite *s = suite_create ("GstByteScan");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_scan_start_code_random);
+  tcase_add_test (tc_chain, test_scan_start_code_positions);
+
+  return s;
+}
+
+GST_CHECK_MAIN (gst_byte_scan);
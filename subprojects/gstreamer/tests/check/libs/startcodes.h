@@ -0,0 +1,62 @@
+/* GStreamer
+ *
+ * helpers for the start code scanning unit tests
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib.h>
+
+/* fills @data with zeros, ones and other bytes so that there are start codes
+ * at all positions relative to the blocks of the vectorized scanners, and
+ * many near misses */
+static void
+fill_start_code_data (guint8 * data, guint size)
+{
+  GRand *rand = g_rand_new_with_seed (42);
+  guint i;
+
+  for (i = 0; i < size; i++) {
+    switch (g_rand_int_range (rand, 0, 6)) {
+      case 0:
+      case 1:
+      case 2:
+        data[i] = 0x00;
+        break;
+      case 3:
+        data[i] = 0x01;
+        break;
+      default:
+        data[i] = g_rand_int_range (rand, 2, 256);
+        break;
+    }
+  }
+  g_rand_free (rand);
+}
+
+/* the reference: the first 0x00 0x00 0x01 between @offset and
+ * @offset + @size that is followed by one more byte */
+static gint
+find_start_code (const guint8 * data, guint offset, guint size)
+{
+  guint i;
+
+  for (i = offset; i + 3 < offset + size; i++) {
+    if (data[i] == 0x00 && data[i + 1] == 0x00 && data[i + 2] == 0x01)
+      return i;
+  }
+  return -1;
+}
@@ -31,6 +31,7 @@ typedef struct
   GstPad *sinkpad;
   GList *events;
   GList *buffers;
+  guint lists;
   GstElement *trans;
   GstBaseTransformClass *klass;
 } TestTransData;
@@ -79,7 +80,14 @@ static GstCaps *(*klass_transform_caps) (GstBaseTransform * trans,
 static gboolean (*klass_transform_size) (GstBaseTransform * trans,
     GstPadDirection direction, GstCaps * caps, gsize size, GstCaps * othercaps,
     gsize * othersize) = NULL;
+static GstFlowReturn (*klass_transform_list) (GstBaseTransform * trans,
+    GstBufferList * inlist, GstBufferList * outlist) = NULL;
+static GstFlowReturn (*klass_transform_list_ip) (GstBaseTransform * trans,
+    GstBufferList * list) = NULL;
+static void (*klass_before_transform) (GstBaseTransform * trans,
+    GstBuffer * buffer) = NULL;
 static gboolean klass_passthrough_on_same_caps = FALSE;
+static gboolean buffer_list_aware = FALSE;
 GstFlowReturn (*klass_submit_input_buffer) (GstBaseTransform * trans,
     gboolean is_discont, GstBuffer * input) = NULL;
 GstFlowReturn (*klass_generate_output) (GstBaseTransform * trans,
@@ -122,11 +130,19 @@ gst_test_trans_class_init (GstTestTransClass * klass)
     trans_class->submit_input_buffer = klass_submit_input_buffer;
   if (klass_generate_output)
     trans_class->generate_output = klass_generate_output;
+  if (klass_transform_list != NULL)
+    trans_class->transform_list = klass_transform_list;
+  if (klass_transform_list_ip != NULL)
+    trans_class->transform_list_ip = klass_transform_list_ip;
+  if (klass_before_transform != NULL)
+    trans_class->before_transform = klass_before_transform;
 }
 
 static void
 gst_test_trans_init (GstTestTrans * this)
 {
+  gst_base_transform_set_buffer_list_aware (GST_BASE_TRANSFORM (this),
+      buffer_list_aware);
 }
 
 static void
@@ -147,6 +163,23 @@ result_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   return GST_FLOW_OK;
 }
 
+static GstFlowReturn
+result_sink_chain_list (GstPad * pad, GstObject * parent, GstBufferList * list)
+{
+  TestTransData *data;
+  guint i;
+
+  data = gst_pad_get_element_private (pad);
+
+  data->lists++;
+  for (i = 0; i < gst_buffer_list_length (list); i++)
+    data->buffers = g_list_append (data->buffers,
+        gst_buffer_ref (gst_buffer_list_get (list, i)));
+  gst_buffer_list_unref (list);
+
+  return GST_FLOW_OK;
+}
+
 #if 0
 static GstFlowReturn
 result_buffer_alloc (GstPad * pad, guint64 offset, guint size, GstCaps * caps,
@@ -206,6 +239,7 @@ gst_test_trans_new (void)
   gst_pad_set_element_private (res->sinkpad, res);
 
   gst_pad_set_chain_function (res->sinkpad, result_sink_chain);
+  gst_pad_set_chain_list_function (res->sinkpad, result_sink_chain_list);
 
   tmp = gst_element_get_static_pad (res->trans, "sink");
   gst_pad_link (res->srcpad, tmp);
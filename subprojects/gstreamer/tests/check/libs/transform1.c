@@ -941,6 +941,274 @@ GST_START_TEST (basetransform_invalid_fixatecaps_impl)
 
 GST_END_TEST;
 
+static gint transform_list_ip_calls;
+static gint transform_ip_list_calls;
+
+static GstFlowReturn
+transform_ip_list (GstBaseTransform * trans, GstBuffer * buf)
+{
+  transform_ip_list_calls++;
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+transform_list_ip_1 (GstBaseTransform * trans, GstBufferList * list)
+{
+  guint i;
+
+  transform_list_ip_calls++;
+
+  for (i = 0; i < gst_buffer_list_length (list); i++)
+    fail_unless (gst_buffer_is_writable (gst_buffer_list_get (list, i)));
+
+  /* drop the last buffer */
+  gst_buffer_list_remove (list, gst_buffer_list_length (list) - 1, 1);
+
+  return GST_FLOW_OK;
+}
+
+static GstBufferList *
+create_buffer_list (guint n, gsize size)
+{
+  GstBufferList *list;
+  guint i;
+
+  list = gst_buffer_list_new_sized (n);
+  for (i = 0; i < n; i++)
+    gst_buffer_list_add (list, gst_buffer_new_and_alloc (size));
+
+  return list;
+}
+
+/* in-place list transform, the list should be handled as a whole and the
+ * buffers should be writable */
+GST_START_TEST (basetransform_chain_list_ip)
+{
+  TestTransData *trans;
+  GstBufferList *list;
+  GstBuffer *buffer;
+  GstFlowReturn res;
+  guint i;
+
+  klass_transform_ip = transform_ip_list;
+  klass_transform_list_ip = transform_list_ip_1;
+  buffer_list_aware = TRUE;
+  trans = gst_test_trans_new ();
+
+  gst_test_trans_push_segment (trans);
+
+  list = create_buffer_list (4, 20);
+  /* take additional ref on one buffer to make it non-writable */
+  buffer = gst_buffer_ref (gst_buffer_list_get (list, 1));
+
+  transform_list_ip_calls = 0;
+  transform_ip_list_calls = 0;
+  res = gst_pad_push_list (trans->srcpad, list);
+  fail_unless (res == GST_FLOW_OK);
+  fail_unless_equals_int (transform_list_ip_calls, 1);
+  fail_unless_equals_int (transform_ip_list_calls, 0);
+  fail_unless_equals_int (trans->lists, 1);
+  gst_buffer_unref (buffer);
+
+  for (i = 0; i < 3; i++) {
+    buffer = gst_test_trans_pop (trans);
+    fail_unless (buffer != NULL);
+    fail_unless (gst_buffer_get_size (buffer) == 20);
+    gst_buffer_unref (buffer);
+  }
+  fail_unless (gst_test_trans_pop (trans) == NULL);
+
+  /* without list support lists are split */
+  gst_base_transform_set_buffer_list_aware (GST_BASE_TRANSFORM (trans->trans),
+      FALSE);
+
+  res = gst_pad_push_list (trans->srcpad, create_buffer_list (4, 20));
+  fail_unless (res == GST_FLOW_OK);
+  fail_unless_equals_int (transform_list_ip_calls, 1);
+  fail_unless_equals_int (transform_ip_list_calls, 4);
+  fail_unless_equals_int (trans->lists, 1);
+
+  for (i = 0; i < 4; i++) {
+    buffer = gst_test_trans_pop (trans);
+    fail_unless (buffer != NULL);
+    gst_buffer_unref (buffer);
+  }
+
+  gst_test_trans_free (trans);
+}
+
+GST_END_TEST;
+
+static gint before_transform_split_calls;
+static gint probe_split_calls;
+
+static void
+before_transform_split (GstBaseTransform * trans, GstBuffer * buffer)
+{
+  before_transform_split_calls++;
+}
+
+static GstPadProbeReturn
+probe_split (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  fail_unless (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER);
+  /* buffers of a writable list are chained without an extra ref */
+  fail_unless (gst_buffer_is_writable (GST_PAD_PROBE_INFO_BUFFER (info)));
+  probe_split_calls++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* lists that are not handled as a whole are split like by the default chain
+ * list function of pads */
+GST_START_TEST (basetransform_chain_list_split)
+{
+  TestTransData *trans;
+  GstBuffer *buffer;
+  GstFlowReturn res;
+  GstPad *sinkpad;
+  guint i;
+
+  klass_transform_ip = transform_ip_list;
+  klass_transform_list_ip = transform_list_ip_1;
+  klass_before_transform = before_transform_split;
+  trans = gst_test_trans_new ();
+
+  sinkpad = gst_element_get_static_pad (trans->trans, "sink");
+  gst_pad_add_probe (sinkpad, GST_PAD_PROBE_TYPE_BUFFER, probe_split,
+      NULL, NULL);
+  gst_object_unref (sinkpad);
+
+  gst_test_trans_push_segment (trans);
+
+  transform_list_ip_calls = 0;
+  transform_ip_list_calls = 0;
+  before_transform_split_calls = 0;
+  probe_split_calls = 0;
+  res = gst_pad_push_list (trans->srcpad, create_buffer_list (4, 20));
+  fail_unless (res == GST_FLOW_OK);
+  fail_unless_equals_int (transform_list_ip_calls, 0);
+  fail_unless_equals_int (transform_ip_list_calls, 4);
+  fail_unless_equals_int (before_transform_split_calls, 4);
+  fail_unless_equals_int (probe_split_calls, 4);
+
+  for (i = 0; i < 4; i++) {
+    buffer = gst_test_trans_pop (trans);
+    fail_unless (buffer != NULL);
+    gst_buffer_unref (buffer);
+  }
+  fail_unless (gst_test_trans_pop (trans) == NULL);
+
+  /* list aware, before_transform is still called for every buffer */
+  gst_base_transform_set_buffer_list_aware (GST_BASE_TRANSFORM (trans->trans),
+      TRUE);
+
+  res = gst_pad_push_list (trans->srcpad, create_buffer_list (4, 20));
+  fail_unless (res == GST_FLOW_OK);
+  fail_unless_equals_int (transform_list_ip_calls, 1);
+  fail_unless_equals_int (transform_ip_list_calls, 4);
+  fail_unless_equals_int (before_transform_split_calls, 8);
+
+  for (i = 0; i < 3; i++) {
+    buffer = gst_test_trans_pop (trans);
+    fail_unless (buffer != NULL);
+    gst_buffer_unref (buffer);
+  }
+  fail_unless (gst_test_trans_pop (trans) == NULL);
+
+  gst_test_trans_free (trans);
+}
+
+GST_END_TEST;
+
+static gint transform_list_ct_calls;
+static GstFlowReturn transform_list_ct_ret;
+
+static GstFlowReturn
+transform_list_ct (GstBaseTransform * trans, GstBufferList * inlist,
+    GstBufferList * outlist)
+{
+  guint i;
+
+  transform_list_ct_calls++;
+
+  fail_unless_equals_int (gst_buffer_list_length (inlist),
+      gst_buffer_list_length (outlist));
+
+  for (i = 0; i < gst_buffer_list_length (outlist); i++) {
+    GstBuffer *in = gst_buffer_list_get (inlist, i);
+    GstBuffer *out = gst_buffer_list_get (outlist, i);
+
+    fail_unless (gst_buffer_is_writable (out));
+    fail_unless_equals_int (gst_buffer_get_size (out),
+        2 * gst_buffer_get_size (in));
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (out), GST_BUFFER_PTS (in));
+  }
+
+  return transform_list_ct_ret;
+}
+
+/* copy list transform, output buffers are allocated for the whole list */
+GST_START_TEST (basetransform_chain_list_ct)
+{
+  TestTransData *trans;
+  GstBufferList *list;
+  GstBuffer *buffer;
+  GstFlowReturn res;
+  GstCaps *incaps;
+  guint i;
+
+  sink_template = &sink_template_ct1;
+  klass_transform = transform_ct1;
+  klass_transform_list = transform_list_ct;
+  klass_set_caps = set_caps_ct1;
+  klass_transform_caps = transform_caps_ct1;
+  klass_transform_size = transform_size_ct1;
+  buffer_list_aware = TRUE;
+
+  trans = gst_test_trans_new ();
+
+  incaps = gst_caps_new_empty_simple ("baz/x-foo");
+  gst_test_trans_setcaps (trans, incaps);
+  gst_test_trans_push_segment (trans);
+
+  list = create_buffer_list (3, 20);
+  for (i = 0; i < 3; i++)
+    GST_BUFFER_PTS (gst_buffer_list_get (list, i)) = i * GST_SECOND;
+  /* different sizes in one list */
+  gst_buffer_list_add (list, gst_buffer_new_and_alloc (10));
+
+  transform_list_ct_calls = 0;
+  transform_list_ct_ret = GST_FLOW_OK;
+  transform_ct1_called = FALSE;
+  res = gst_pad_push_list (trans->srcpad, list);
+  fail_unless (res == GST_FLOW_OK);
+  fail_unless_equals_int (transform_list_ct_calls, 1);
+  fail_unless (transform_ct1_called == FALSE);
+  fail_unless_equals_int (trans->lists, 1);
+
+  for (i = 0; i < 4; i++) {
+    buffer = gst_test_trans_pop (trans);
+    fail_unless (buffer != NULL);
+    fail_unless_equals_int (gst_buffer_get_size (buffer), i < 3 ? 40 : 20);
+    gst_buffer_unref (buffer);
+  }
+  fail_unless (gst_test_trans_pop (trans) == NULL);
+
+  /* nothing is pushed when the transform fails */
+  transform_list_ct_ret = GST_FLOW_ERROR;
+  res = gst_pad_push_list (trans->srcpad, create_buffer_list (2, 20));
+  fail_unless (res == GST_FLOW_ERROR);
+  fail_unless_equals_int (transform_list_ct_calls, 2);
+  fail_unless (gst_test_trans_pop (trans) == NULL);
+
+  gst_caps_unref (incaps);
+  gst_test_trans_free (trans);
+}
+
+GST_END_TEST;
+
 static void
 transform1_setup (void)
 {
@@ -954,6 +1222,10 @@ transform1_teardown (void)
   /* reset global state */
   klass_transform_ip = NULL;
   klass_transform = NULL;
+  klass_transform_list = NULL;
+  klass_transform_list_ip = NULL;
+  buffer_list_aware = FALSE;
+  klass_before_transform = NULL;
   klass_transform_caps = NULL;
   klass_transform_size = NULL;
   klass_set_caps = NULL;
@@ -983,6 +1255,10 @@ gst_basetransform_suite (void)
   tcase_add_test (tc, basetransform_chain_ct3);
 
   tcase_add_test (tc, basetransform_invalid_fixatecaps_impl);
+  /* buffer lists */
+  tcase_add_test (tc, basetransform_chain_list_ip);
+  tcase_add_test (tc, basetransform_chain_list_split);
+  tcase_add_test (tc, basetransform_chain_list_ct);
 
   return s;
 }
@@ -0,0 +1,141 @@
+/* GStreamer
+ *
+ * gst-debug-decode.c: Formats dumps of the ring buffer debug logger
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <locale.h>
+
+#ifdef __APPLE__
+#include <TargetConditionals.h>
+#endif
+
+#include "tools.h"
+
+static gboolean
+decode_file (const gchar * filename)
+{
+  GError *err = NULL;
+  gchar *contents, **logs, **log;
+  gsize size;
+
+  if (!g_file_get_contents (filename, &contents, &size, &err)) {
+    g_printerr ("Could not read %s: %s\n", filename, err->message);
+    g_clear_error (&err);
+    return FALSE;
+  }
+
+  logs = gst_debug_ring_buffer_logger_decode ((const guint8 *) contents, size);
+  g_free (contents);
+
+  if (logs == NULL) {
+    g_printerr ("%s is not a dump of the ring buffer logger\n", filename);
+    return FALSE;
+  }
+
+  for (log = logs; *log; log++)
+    g_print ("%s", *log);
+
+  g_strfreev (logs);
+
+  return TRUE;
+}
+
+static int
+real_main (int argc, char *argv[])
+{
+  gchar **filenames = NULL;
+  guint i;
+  int ret = 0;
+  GError *err = NULL;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    GST_TOOLS_GOPTION_VERSION,
+    {G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &filenames, NULL},
+    {NULL}
+  };
+
+  setlocale (LC_ALL, "");
+
+#ifdef ENABLE_NLS
+  bindtextdomain (GETTEXT_PACKAGE, LOCALEDIR);
+  bind_textdomain_codeset (GETTEXT_PACKAGE, "UTF-8");
+  textdomain (GETTEXT_PACKAGE);
+#endif
+
+  g_set_prgname ("gst-debug-decode-" GST_API_VERSION);
+
+  ctx = g_option_context_new ("FILES");
+  g_option_context_set_summary (ctx,
+      "Formats dumps written by gst_debug_ring_buffer_logger_dump()");
+  g_option_context_add_main_entries (ctx, options, GETTEXT_PACKAGE);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+#ifdef G_OS_WIN32
+  if (!g_option_context_parse_strv (ctx, &argv, &err))
+#else
+  if (!g_option_context_parse (ctx, &argc, &argv, &err))
+#endif
+  {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_clear_error (&err);
+    g_option_context_free (ctx);
+    exit (1);
+  }
+  g_option_context_free (ctx);
+
+  gst_tools_print_version ();
+
+  if (filenames == NULL || *filenames == NULL) {
+    g_print ("Please give one or more filenames to %s\n\n", g_get_prgname ());
+    return 1;
+  }
+
+  for (i = 0; filenames[i]; i++) {
+    if (!decode_file (filenames[i]))
+      ret = 1;
+  }
+
+  g_strfreev (filenames);
+
+  return ret;
+}
+
+int
+main (int argc, char *argv[])
+{
+  int ret;
+
+#ifdef G_OS_WIN32
+  argv = g_win32_get_command_line ();
+#endif
+
+#if defined(__APPLE__) && TARGET_OS_MAC && !TARGET_OS_IPHONE
+  ret = gst_macos_main ((GstMainFunc) real_main, argc, argv, NULL);
+#else
+  ret = real_main (argc, argv);
+#endif
+
+#ifdef G_OS_WIN32
+  g_strfreev (argv);
+#endif
+
+  return ret;
+}